@@ -51,6 +51,18 @@ namespace System.Transactions.Oletx
         EnlistmentTmDownNotify        = 9,
         ResourceManagerTmDownNotify   = 10
     }
+
+    // Matches the native ShimNotification filled in by IDtcProxyShimFactory.GetNotifications.
+    [StructLayout(LayoutKind.Sequential)]
+    internal struct ShimNotification
+    {
+        internal IntPtr managedIdentifier;
+        [MarshalAs(UnmanagedType.I4)] internal ShimNotificationType shimNotificationType;
+        [MarshalAs(UnmanagedType.Bool)] internal bool isSinglePhase;
+        [MarshalAs(UnmanagedType.Bool)] internal bool abortingHint;
+        [MarshalAs(UnmanagedType.U4)] internal UInt32 prepareInfoSize;
+        internal IntPtr prepareInfo;
+    }
     
     internal enum OletxPrepareVoteType : int
     {
@@ -336,6 +348,15 @@ namespace System.Transactions.Oletx
             out OletxTransactionIsolationLevel isolationLevel,
             [MarshalAs(UnmanagedType.Interface)] out ITransactionShim transactionShim
             );
+
+        // Must stay last to match the native vtable.  Any non-zero prepareInfo returned is a
+        // CoTaskMem buffer now owned by the caller.
+        void GetNotifications(
+            [MarshalAs(UnmanagedType.U4)] UInt32 maxNotifications,
+            [Out, MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 0)] ShimNotification[] notifications,
+            [MarshalAs(UnmanagedType.U4)] out UInt32 notificationCount,
+            [MarshalAs(UnmanagedType.Bool)] out bool releaseRequired
+            );
     }
 
     // We need to leave this here because if we are given an ITransactionNative and need to
@@ -101,6 +101,11 @@ HRESULT __stdcall EnlistmentNotifyShim::PrepareRequest(
     // This buffer will be freed by Managed code through the CoTaskMemHandle object that is
     // created when the pointer to this buffer is returned from GetNotification.
     prepareInfoBuffer = (BYTE*) CoTaskMemAlloc( prepareInfoLength );
+    if ( NULL == prepareInfoBuffer )
+    {
+        hr = E_OUTOFMEMORY;
+        goto ErrorExit;
+    }
 
     hr = pPrepareInfo->GetPrepareInfo( prepareInfoBuffer );
     if ( FAILED( hr ) )
@@ -6,7 +6,7 @@
 
 EXTERN_C const GUID IID_IEnlistmentShim;
 
-class EnlistmentNotifyShim : public ITransactionResourceAsync, public NotificationShimBase
+class EnlistmentNotifyShim : public ITransactionResourceAsync, public NotificationShimBase, public ShimAllocationCache<EnlistmentNotifyShim>
 {
 public:
     EnlistmentNotifyShim( NotificationShimFactory* shimFactory, void* enlistmentIdentifier ) : NotificationShimBase( shimFactory, enlistmentIdentifier )
@@ -100,7 +100,7 @@ private:
 
 };
 
-class EnlistmentShim : public IEnlistmentShim
+class EnlistmentShim : public IEnlistmentShim, public ShimAllocationCache<EnlistmentShim>
 {
 public:
     EnlistmentShim( NotificationShimFactory* shimFactory, EnlistmentNotifyShim* notifyShim )
@@ -23,6 +23,7 @@ NotificationShimFactory::NotificationShimFactory()
 {
     this->refCount = 0;
     this->eventHandle = INVALID_HANDLE_VALUE;
+    this->pPendingNotifications = NULL;
     this->listOfNotifications.Init();
     this->pMarshaler = NULL;
     this->csxInited = FALSE;
@@ -41,6 +42,10 @@ NotificationShimFactory::NotificationShimFactory()
     this->listOfReceivers.Init();
     this->csxReceiverInited = FALSE;
 
+    this->listOfExports.Init();
+    this->csxExportInited = FALSE;
+    this->exportWaits = 0;
+    this->retryBackoffs = 0;
 }
 
 NotificationShimFactory::~NotificationShimFactory(void)
@@ -69,7 +74,7 @@ NotificationShimFactory::~NotificationShimFactory(void)
     UTLink <CachedInterfaceBase *>   *pTransmitterLink;
     entryRemoved = FALSE;
     EnterCriticalSection( &this->csxTransmitter );
-    while ( entryRemoved = this->listOfOptions.RemoveFirst (&pTransmitterLink) )
+    while ( entryRemoved = this->listOfTransmitters.RemoveFirst (&pTransmitterLink) )
     {
         delete (CachedTransmitter*) pTransmitterLink->m_Value;
     }
@@ -79,12 +84,25 @@ NotificationShimFactory::~NotificationShimFactory(void)
     UTLink <CachedInterfaceBase *>   *pReceiverLink;
     entryRemoved = FALSE;
     EnterCriticalSection( &this->csxReceiver );
-    while ( entryRemoved = this->listOfOptions.RemoveFirst (&pReceiverLink) )
+    while ( entryRemoved = this->listOfReceivers.RemoveFirst (&pReceiverLink) )
     {
         delete (CachedReceiver*) pReceiverLink->m_Value;
     }
     LeaveCriticalSection( &this->csxReceiver );
 
+    // Clean up the cached ITransactionExport objects.
+    if ( this->csxExportInited )
+    {
+        UTLink <CachedInterfaceBase *>   *pExportLink;
+        entryRemoved = FALSE;
+        EnterCriticalSection( &this->csxExport );
+        while ( entryRemoved = this->listOfExports.RemoveFirst (&pExportLink) )
+        {
+            delete (CachedExport*) pExportLink->m_Value;
+        }
+        LeaveCriticalSection( &this->csxExport );
+    }
+
     if ( this->csxOptionsInited )
     {
         DeleteCriticalSection( &this->csxOptions );
@@ -100,6 +118,11 @@ NotificationShimFactory::~NotificationShimFactory(void)
         DeleteCriticalSection( &this->csxReceiver );
     }
 
+    if ( this->csxExportInited )
+    {
+        DeleteCriticalSection( &this->csxExport );
+    }
+
     // Release any interface pointers we already have.
     SafeReleaseInterface( (IUnknown**) &this->transactionDispenser );
     SafeReleaseInterface( (IUnknown**) &this->pMarshaler );
@@ -156,6 +179,14 @@ HRESULT NotificationShimFactory::Initialize( HANDLE hEvent )
     }
     this->csxReceiverInited = true;
 
+    success = ::InitializeCriticalSectionAndSpinCount( &this->csxExport, 500 );
+    if ( !success )
+    {
+        hr = HRESULT_FROM_WIN32( GetLastError() );
+        goto ErrorExit;
+    }
+    this->csxExportInited = true;
+
     if ( NULL == s_pcsxProxyInit )
     {
         CRITICAL_SECTION *pcsxNew = new CRITICAL_SECTION();
@@ -192,13 +223,228 @@ void NotificationShimFactory::NewNotification(
     NotificationShimBase* notification
     )
 {
+    NotificationShimBase* pHead = NULL;
+
     assert( ! notification->link.IsLinked() );
-    EnterCriticalSection( &this->csx );
     notification->BaseAddRef();
-    this->listOfNotifications.InsertLast( &notification->link );
-    LeaveCriticalSection( &this->csx );
 
-    SetEvent( this->eventHandle );
+    do
+    {
+        pHead = this->pPendingNotifications;
+        notification->pNextPending = pHead;
+    }
+    while ( pHead != ::InterlockedCompareExchangePointer(
+        (volatile PVOID*)&this->pPendingNotifications, notification, pHead ) );
+
+    // Only the push that makes the stack non-empty needs to signal.  The managed
+    // callback keeps calling GetNotification until it returns None, so anything pushed
+    // on top of a non-empty stack is picked up by the wake-up that is already pending.
+    if ( NULL == pHead )
+    {
+        SetEvent( this->eventHandle );
+    }
+}
+
+// Must be called with csx held.
+NotificationShimBase* NotificationShimFactory::RemoveFirstNotification()
+{
+    UTLink <NotificationShimBase *>   *plink;
+    NotificationShimBase* pPending = NULL;
+    NotificationShimBase* pReversed = NULL;
+    NotificationShimBase* pNext = NULL;
+
+    if ( this->listOfNotifications.RemoveFirst( &plink ) )
+    {
+        return plink->m_Value;
+    }
+
+    pPending = (NotificationShimBase*) ::InterlockedExchangePointer(
+        (volatile PVOID*)&this->pPendingNotifications, NULL );
+
+    // The stack is newest first; reverse it so notifications are delivered in
+    // the order they were queued.
+    while ( NULL != pPending )
+    {
+        pNext = pPending->pNextPending;
+        pPending->pNextPending = pReversed;
+        pReversed = pPending;
+        pPending = pNext;
+    }
+
+    while ( NULL != pReversed )
+    {
+        pNext = pReversed->pNextPending;
+        pReversed->pNextPending = NULL;
+        this->listOfNotifications.InsertLast( &pReversed->link );
+        pReversed = pNext;
+    }
+
+    if ( ! this->listOfNotifications.RemoveFirst( &plink ) )
+    {
+        return NULL;
+    }
+
+    return plink->m_Value;
+}
+
+void NotificationShimFactory::CopyNotification(
+    NotificationShimBase* notification,
+    ShimNotification* pNotification
+    )
+{
+    pNotification->managedIdentifier = notification->enlistmentIdentifier;
+    pNotification->notificationType = notification->notificationType;
+    pNotification->isSinglePhase = notification->isSinglePhase;
+    pNotification->abortingHint = notification->abortingHint;
+    pNotification->prepareInfoSize = 0;
+    pNotification->pPrepareInfo = NULL;
+    // only include the prepare info if it is a prepare.  Otherwise the buffer
+    // will get freed multiple times.
+    if ( PrepareRequestNotify == notification->notificationType )
+    {
+        pNotification->prepareInfoSize = notification->prepareInfoSize;
+        pNotification->pPrepareInfo = notification->pPrepareInfo;
+        // The prepareinfo buffer is now owned by the managed code.  We are no longer responsible for freeing it.
+        notification->pPrepareInfo = NULL;
+    }
+}
+
+// Must be called with the export lock held.  Returns the ITransactionExport already connected to the
+// TM identified by pWhereabouts, or creates one, so repeated exports of transactions to the same
+// remote node don't go through ITransactionExportFactory::Create every time.
+HRESULT NotificationShimFactory::GetCachedExport(
+    ULONG whereaboutsSize,
+    BYTE* pWhereabouts,
+    CachedExport** ppCachedExport
+    )
+{
+    HRESULT hr = S_OK;
+    UTLink <CachedInterfaceBase *>   *plink;
+    ULONG count = this->listOfExports.m_ulCount;
+    CachedExport* localCachedExport = NULL;
+    CachedExport* candidate = NULL;
+    ITransactionExportFactory* pExportFactory = NULL;
+    ITransactionExport* pExport = NULL;
+    BYTE* whereaboutsCopy = NULL;
+
+    *ppCachedExport = NULL;
+
+    // The list is short (at most maxCachedInterfaces entries), so just rotate through it.
+    while ( ( 0 < count-- ) && this->listOfExports.RemoveFirst( &plink ) )
+    {
+        candidate = (CachedExport*) plink->m_Value;
+        if ( ( NULL == localCachedExport ) &&
+             ( candidate->whereaboutsSize == whereaboutsSize ) &&
+             ( 0 == memcmp( candidate->pWhereabouts, pWhereabouts, whereaboutsSize ) )
+           )
+        {
+            localCachedExport = candidate;
+        }
+        else
+        {
+            this->listOfExports.InsertLast( &candidate->link );
+        }
+    }
+
+    if ( NULL == localCachedExport )
+    {
+        hr = this->GetExportFactory( &pExportFactory );
+        if ( FAILED( hr ) )
+        {
+            goto ErrorExit;
+        }
+
+        hr = pExportFactory->Create(
+            whereaboutsSize,
+            pWhereabouts,
+            &pExport
+            );
+        if ( FAILED( hr ) )
+        {
+            goto ErrorExit;
+        }
+
+        whereaboutsCopy = new BYTE[whereaboutsSize];
+        if ( NULL == whereaboutsCopy )
+        {
+            hr = E_OUTOFMEMORY;
+            goto ErrorExit;
+        }
+        memcpy( whereaboutsCopy, pWhereabouts, whereaboutsSize );
+
+        localCachedExport = new CachedExport( this, pExport, whereaboutsSize, whereaboutsCopy );
+        if ( NULL == localCachedExport )
+        {
+            hr = E_OUTOFMEMORY;
+            goto ErrorExit;
+        }
+        // Now owned by localCachedExport.
+        pExport = NULL;
+        whereaboutsCopy = NULL;
+    }
+
+    *ppCachedExport = localCachedExport;
+
+ErrorExit:
+
+    delete [] whereaboutsCopy;
+    SafeReleaseInterface( (IUnknown**) &pExport );
+    SafeReleaseInterface( (IUnknown**) &pExportFactory );
+
+    return hr;
+}
+
+// Must be called with the export lock held.
+void NotificationShimFactory::ReturnCachedExport(
+    CachedExport* pCachedExport
+    )
+{
+    UTLink <CachedInterfaceBase *>   *plink;
+
+    // Make room by dropping the least recently used entry.
+    if ( this->listOfExports.m_ulCount >= this->maxCachedInterfaces )
+    {
+        if ( this->listOfExports.RemoveFirst( &plink ) )
+        {
+            delete (CachedExport*) plink->m_Value;
+        }
+    }
+    this->listOfExports.InsertLast( &pCachedExport->link );
+}
+
+void NotificationShimFactory::EnterExportLock()
+{
+    if ( ! TryEnterCriticalSection( &this->csxExport ) )
+    {
+        InterlockedIncrement( &this->exportWaits );
+        EnterCriticalSection( &this->csxExport );
+    }
+}
+
+void NotificationShimFactory::LeaveExportLock()
+{
+    LeaveCriticalSection( &this->csxExport );
+}
+
+// Waits before retrying a call that failed with XACT_E_ALREADYINPROGRESS.  The wait doubles with
+// each attempt, up to MaxRetryBackoff, and is randomized so that callers which collided once do
+// not keep waking up in lockstep.
+void NotificationShimFactory::RetryBackoff(
+    int attempt
+    )
+{
+    DWORD backoff = MaxRetryBackoff;
+    DWORD seed = 0;
+
+    InterlockedIncrement( &this->retryBackoffs );
+
+    if ( attempt < 8 )
+    {
+        backoff = min( (DWORD) ( 1 << attempt ), (DWORD) MaxRetryBackoff );
+    }
+
+    seed = ( GetTickCount() ^ GetCurrentThreadId() ) * 1103515245 + 12345;
+    Sleep( ( backoff / 2 ) + ( ( seed >> 16 ) % ( ( backoff / 2 ) + 1 ) ) );
 }
 
 HRESULT __stdcall NotificationShimFactory::QueryInterface(
@@ -665,9 +911,9 @@ HRESULT __stdcall NotificationShimFactory::GetNotification(
     )
 {
     HRESULT hr = S_OK;
-    UTLink <NotificationShimBase *>   *plink;
     BOOL entryRemoved = FALSE;
     NotificationShimBase* notification = NULL;
+    ShimNotification shimNotification;
 
     if ( ( NULL == ppManagedIdentifier ) ||
          ( NULL == pShimNotificationType ) ||
@@ -691,28 +937,18 @@ HRESULT __stdcall NotificationShimFactory::GetNotification(
     
 
     EnterCriticalSection( &this->csx );
-    entryRemoved = this->listOfNotifications.RemoveFirst (&plink);
+    notification = this->RemoveFirstNotification();
+    entryRemoved = ( NULL != notification );
 
     if ( entryRemoved )
     {
-        notification = plink->m_Value;
-        *ppManagedIdentifier = notification->enlistmentIdentifier;
-        *pShimNotificationType = notification->notificationType;
-        *pIsSinglePhase = notification->isSinglePhase;
-        *pAbortingHint = notification->abortingHint;
-        // only include the prepare info if it is a prepare.  Otherwise the buffer
-        // will get freed multiple times.
-        if ( PrepareRequestNotify == *pShimNotificationType )
-        {
-            *pPrepareInfoSize = notification->prepareInfoSize;
-            *ppPrepareInfo = notification->pPrepareInfo;
-            // The prepareinfo buffer is now owned by the managed code.  We are no longer responsible for freeing it.
-            notification->pPrepareInfo = NULL;
-        }
-    }
-
-    if ( NULL != notification )
-    {
+        this->CopyNotification( notification, &shimNotification );
+        *ppManagedIdentifier = shimNotification.managedIdentifier;
+        *pShimNotificationType = shimNotification.notificationType;
+        *pIsSinglePhase = shimNotification.isSinglePhase;
+        *pAbortingHint = shimNotification.abortingHint;
+        *pPrepareInfoSize = shimNotification.prepareInfoSize;
+        *ppPrepareInfo = shimNotification.pPrepareInfo;
         notification->BaseRelease();
     }
 
@@ -740,6 +976,67 @@ HRESULT __stdcall NotificationShimFactory::ReleaseNotificationLock()
     return S_OK;
 }
 
+// Batched form of GetNotification.  Fills up to maxNotifications entries in arrival
+// order.  A ResourceManagerTMDownNotify is always the last entry returned; when one is
+// returned *pReleaseLock is TRUE and the caller must call ReleaseNotificationLock after
+// processing it, exactly as with GetNotification.  A count of 0 means the queue is empty.
+HRESULT __stdcall NotificationShimFactory::GetNotifications(
+    ULONG maxNotifications,
+    ShimNotification* pNotifications,
+    ULONG* pNotificationCount,
+    BOOL* pReleaseLock
+    )
+{
+    HRESULT hr = S_OK;
+    NotificationShimBase* notification = NULL;
+    ULONG count = 0;
+    BOOL holdLock = FALSE;
+
+    if ( ( 0 == maxNotifications ) ||
+         ( NULL == pNotifications ) ||
+         ( NULL == pNotificationCount ) ||
+         ( NULL == pReleaseLock )
+       )
+    {
+        return E_INVALIDARG;
+    }
+
+    *pNotificationCount = 0;
+    *pReleaseLock = FALSE;
+
+    EnterCriticalSection( &this->csx );
+    while ( count < maxNotifications )
+    {
+        notification = this->RemoveFirstNotification();
+        if ( NULL == notification )
+        {
+            break;
+        }
+
+        this->CopyNotification( notification, &pNotifications[count] );
+        count++;
+        notification->BaseRelease();
+
+        if ( ResourceManagerTMDownNotify == pNotifications[count - 1].notificationType )
+        {
+            holdLock = TRUE;
+            break;
+        }
+    }
+
+    if ( holdLock )
+    {
+        *pReleaseLock = TRUE;
+    }
+    else
+    {
+        LeaveCriticalSection( &this->csx );
+    }
+
+    *pNotificationCount = count;
+    return hr;
+}
+
 HRESULT NotificationShimFactory::SetupTransaction(
     ITransaction* pTx,
     void* managedIdentifier,
@@ -1296,7 +1593,7 @@ void NotificationShimFactory::ReturnCachedOptions(
     )
 {
     EnterCriticalSection( &this->csxOptions );
-    if ( this->maxCachedInterfaces >= this->listOfOptions.m_ulCount )
+    if ( this->listOfOptions.m_ulCount >= this->maxCachedInterfaces )
     {
         delete pCachedOptions;
     }
@@ -1399,7 +1696,7 @@ void NotificationShimFactory::ReturnCachedTransmitter(
     )
 {
     EnterCriticalSection( &this->csxTransmitter );
-    if ( this->maxCachedInterfaces >= this->listOfTransmitters.m_ulCount )
+    if ( this->listOfTransmitters.m_ulCount >= this->maxCachedInterfaces )
     {
         delete pCachedTransmitter;
     }
@@ -1483,7 +1780,7 @@ void NotificationShimFactory::ReturnCachedReceiver(
     )
 {
     EnterCriticalSection( &this->csxReceiver );
-    if ( this->maxCachedInterfaces >= this->listOfReceivers.m_ulCount )
+    if ( this->listOfReceivers.m_ulCount >= this->maxCachedInterfaces )
     {
         delete pCachedReceiver;
     }
@@ -12,6 +12,9 @@
 #define RetryInterval  50  // in milli seconds.
 #define MaxRetryCount  100
 
+// Upper bound of a single randomized backoff wait taken by NotificationShimFactory::RetryBackoff.
+#define MaxRetryBackoff  (RetryInterval * 2)  // in milli seconds.
+
 typedef 
 enum ShimNotificationType{
     None                        = 0,
@@ -27,6 +30,18 @@ enum ShimNotificationType{
     ResourceManagerTMDownNotify = 10
     };
 
+// One entry of the array filled in by IDtcProxyShimFactory::GetNotifications.  The
+// fields have the same meaning as the out parameters of GetNotification.
+typedef
+struct ShimNotification{
+    void* managedIdentifier;
+    ShimNotificationType notificationType;
+    BOOL isSinglePhase;
+    BOOL abortingHint;
+    ULONG prepareInfoSize;
+    void* pPrepareInfo;
+    } ShimNotification;
+
 typedef
 enum PrepareVoteType{
     ReadOnly                    = 0,
@@ -59,6 +74,7 @@ class CachedInterfaceBase;
 class CachedOptions;
 class CachedTransmitter;
 class CachedReceiver;
+class CachedExport;
 
 //MIDL_INTERFACE("A5FAB903-21CB-49eb-93AE-EF72CD45169E")
 interface IVoterBallotShim : public IUnknown
@@ -216,6 +232,13 @@ public:
         ITransactionShim** ppTransactionShim
         ) = 0;
 
+    // Added last so the slots of the methods above are unchanged.
+    virtual HRESULT STDMETHODCALLTYPE GetNotifications(
+        ULONG maxNotifications,
+        ShimNotification* pNotifications,
+        ULONG* pNotificationCount,
+        BOOL* pReleaseLock
+        ) = 0;
 };
 
 class NotificationShimFactory : public IDtcProxyShimFactory
@@ -270,6 +293,24 @@ public:
         CachedReceiver* pCachedReceiver
         );
 
+    HRESULT GetCachedExport(
+        ULONG whereaboutsSize,
+        BYTE* pWhereabouts,
+        CachedExport** ppCachedExport
+        );
+
+    void ReturnCachedExport(
+        CachedExport* pCachedExport
+        );
+
+    void EnterExportLock();
+
+    void LeaveExportLock();
+
+    void RetryBackoff(
+        int attempt
+        );
+
     HRESULT SetupTransaction(
         ITransaction* pTx,
         void* managedIdentifier,
@@ -353,6 +394,21 @@ public:
         ITransactionShim** ppTransactionShim
         );
 
+    HRESULT __stdcall GetNotifications(
+        ULONG maxNotifications,
+        ShimNotification* pNotifications,
+        ULONG* pNotificationCount,
+        BOOL* pReleaseLock
+        );
+
+private:
+    NotificationShimBase* RemoveFirstNotification();
+
+    void CopyNotification(
+        NotificationShimBase* notification,
+        ShimNotification* pNotification
+        );
+
 private:
     // Used to synchronize access to the proxy.  This is necessary in
     // initialization because the proxy doesn't like multiple simultaneous callers
@@ -362,11 +418,17 @@ private:
     static volatile LPCRITICAL_SECTION s_pcsxProxyInit;
 
     LONG refCount;
-    // Critical section to protect access to listOfNotifications.
+    // Critical section to protect access to listOfNotifications.  Only the consumers
+    // (GetNotification/GetNotifications) take it; producers never block on it.
     CRITICAL_SECTION csx;
     BOOL csxInited;
 
-    // This is the list of queued NotificationShimBase objects.
+    // Notifications pushed by NewNotification, newest first, linked through
+    // NotificationShimBase::pNextPending.  Producers push with a compare exchange; the
+    // consumer detaches the whole stack at once and moves it to listOfNotifications.
+    NotificationShimBase* volatile pPendingNotifications;
+
+    // This is the list of queued NotificationShimBase objects, in arrival order.
     UTStaticList <NotificationShimBase *> listOfNotifications;
     
     // This is the list of cached ITransactionOptions interfaces.
@@ -386,6 +448,21 @@ private:
     CRITICAL_SECTION csxReceiver;
     BOOL csxReceiverInited;
     UTStaticList <CachedInterfaceBase *> listOfReceivers;
+
+    // Serializes the Export/GetTransactionCookie pairs issued by TransactionShim::Export.  MSDTC
+    // only allows one of these at a time and fails other callers with XACT_E_ALREADYINPROGRESS,
+    // so queueing here replaces the retry loop for exports coming from this factory.
+    CRITICAL_SECTION csxExport;
+    BOOL csxExportInited;
+
+    // This is the list of cached ITransactionExport interfaces, one per remote TM whereabouts
+    // we have exported to.  Protected by csxExport.
+    UTStaticList <CachedInterfaceBase *> listOfExports;
+
+    // Number of exports that had to wait for csxExport, and number of XACT_E_ALREADYINPROGRESS
+    // retries (from other shims or processes) that still went through RetryBackoff.
+    volatile LONG exportWaits;
+    volatile LONG retryBackoffs;
     
     HANDLE eventHandle;
 
@@ -411,6 +488,59 @@ private:
     ITransactionDispenser* transactionDispenser;
 };
 
+// The maximum number of freed objects of a given ShimAllocationCache type we keep for reuse.
+#define MaxCachedShimAllocations  64
+
+// Mixed into the notification and enlistment shim classes, which are created and destroyed
+// for every enlistment.  Freed objects are kept on a lock-free list, up to
+// MaxCachedShimAllocations of them, and handed back out by the next new of the same class,
+// so the commit path doesn't go to the heap for them.  Objects of classes derived from T have
+// a different size and always use the heap.
+template <class T> class ShimAllocationCache
+{
+public:
+    static void* operator new(
+        size_t size
+        )
+    {
+        void* p = NULL;
+
+        if ( sizeof( T ) == size )
+        {
+            p = ::InterlockedPopEntrySList( &s_freeList );
+        }
+
+        if ( NULL == p )
+        {
+            p = ::operator new( size );
+        }
+        return p;
+    }
+
+    static void operator delete(
+        void* p,
+        size_t size
+        )
+    {
+        if ( NULL == p )
+        {
+            return;
+        }
+
+        if ( ( sizeof( T ) == size ) && ( MaxCachedShimAllocations > ::QueryDepthSList( &s_freeList ) ) )
+        {
+            ::InterlockedPushEntrySList( &s_freeList, (PSLIST_ENTRY) p );
+            return;
+        }
+        ::operator delete( p );
+    }
+
+private:
+    static SLIST_HEADER s_freeList;
+};
+
+template <class T> SLIST_HEADER ShimAllocationCache<T>::s_freeList;
+
 class NotificationShimBase
 {
 public:
@@ -428,6 +558,7 @@ public:
         this->isSinglePhase = FALSE;
         this->prepareInfoSize = 0;
         this->pPrepareInfo = NULL;
+        this->pNextPending = NULL;
 
 // do this in the derived constructors to get offsets right.
 //#pragma warning(4 : 4355)
@@ -449,6 +580,8 @@ public:
     BOOL isSinglePhase;
     int prepareInfoSize;
     void* pPrepareInfo;
+    // Link in NotificationShimFactory::pPendingNotifications.
+    NotificationShimBase* pNextPending;
 
 protected:
     LONG refCount;
@@ -551,6 +684,31 @@ public:
     ITransactionReceiver* pTxReceiver;
 };
 
+class CachedExport : public CachedInterfaceBase
+{
+public:
+    // Takes ownership of pWhereabouts, which must have been allocated with new BYTE[].
+    CachedExport( NotificationShimFactory* shimFactory, ITransactionExport* pExport, ULONG whereaboutsSize, BYTE* pWhereabouts ) : CachedInterfaceBase( shimFactory )
+    {
+#pragma warning(4 : 4355)
+        link.Init( this );
+#pragma warning(default : 4355)
+        this->pTxExport = pExport;
+        this->whereaboutsSize = whereaboutsSize;
+        this->pWhereabouts = pWhereabouts;
+    }
+    ~CachedExport(void)
+    {
+        SafeReleaseInterface( (IUnknown**) &this->pTxExport );
+        delete [] this->pWhereabouts;
+        this->pWhereabouts = NULL;
+    }
+
+    ITransactionExport* pTxExport;
+    ULONG whereaboutsSize;
+    BYTE* pWhereabouts;
+};
+
 
 
 
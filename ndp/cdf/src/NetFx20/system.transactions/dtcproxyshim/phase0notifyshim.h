@@ -6,7 +6,7 @@
 
 EXTERN_C const GUID IID_IPhase0EnlistmentShim;
 
-class Phase0NotifyShim : public ITransactionPhase0NotifyAsync, public NotificationShimBase
+class Phase0NotifyShim : public ITransactionPhase0NotifyAsync, public NotificationShimBase, public ShimAllocationCache<Phase0NotifyShim>
 {
 public:
     Phase0NotifyShim( NotificationShimFactory* shimFactory, void* enlistmentIdentifier ) : NotificationShimBase( shimFactory, enlistmentIdentifier )
@@ -37,7 +37,7 @@ public:
         );
 };
 
-class Phase0Shim : public IPhase0EnlistmentShim
+class Phase0Shim : public IPhase0EnlistmentShim, public ShimAllocationCache<Phase0Shim>
 {
 public:
     Phase0Shim( NotificationShimFactory* shimFactory, Phase0NotifyShim* notifyShim )
@@ -6,7 +6,7 @@
 
 EXTERN_C const GUID IID_IResourceManagerShim;
 
-class ResourceManagerNotifyShim : public IResourceManagerSink, public NotificationShimBase
+class ResourceManagerNotifyShim : public IResourceManagerSink, public NotificationShimBase, public ShimAllocationCache<ResourceManagerNotifyShim>
 {
 public:
     ResourceManagerNotifyShim( NotificationShimFactory* shimFactory, void* enlistmentIdentifier ) : NotificationShimBase( shimFactory, enlistmentIdentifier )
@@ -121,6 +121,12 @@ TransactionShim::~TransactionShim(void)
     SafeReleaseInterface( (IUnknown**) &this->transactionNotifyShim );
     SafeReleaseInterface( (IUnknown**) &this->shimFactory );
     SafeReleaseInterface( (IUnknown**) &this->pMarshaler );
+
+    if ( NULL != this->pCachedPropagationToken )
+    {
+        delete [] (BYTE*) this->pCachedPropagationToken;
+        this->pCachedPropagationToken = NULL;
+    }
 }
 
 HRESULT __stdcall TransactionShim::QueryInterface(
@@ -247,33 +253,36 @@ HRESULT __stdcall TransactionShim::Export(
     )
 {
     HRESULT hr = S_OK;
-    ITransactionExportFactory* pExportFactory = NULL;
+    CachedExport* cachedExport = NULL;
     ITransactionExport* pExport = NULL;
     BYTE* cookieBuffer = NULL;
     ULONG cookieSize = 0;
     ULONG cookieSizeUsed = 0;
     int nRetries = MaxRetryCount;
+    BOOL exportLocked = FALSE;
 
-    hr = this->shimFactory->GetExportFactory(
-        &pExportFactory );
-    if ( FAILED( hr ) )
-    {
-        goto ErrorExit;
-    }
+    // MSDTC's Export/GetTransactionCookie API is single threaded, so exports from this
+    // factory take turns here instead of colliding and retrying.
+    this->shimFactory->EnterExportLock();
+    exportLocked = TRUE;
 
-    hr = pExportFactory->Create(
+    // The export object for a given remote TM is reused across exports, which saves
+    // connecting to that TM again for every transaction flowed to it.
+    hr = this->shimFactory->GetCachedExport(
         whereaboutsSize,
         pWhereabouts,
-        &pExport
+        &cachedExport
         );
     if ( FAILED( hr ) )
     {
         goto ErrorExit;
     }
+    pExport = cachedExport->pTxExport;
 
     // 
     // Adding retry logic as a work around for MSDTC's Export/GetTransactionCookie API 
     // which is single threaded and will return XACT_E_ALREADYINPROGRESS if another thread invokes the API.
+    // With the export lock held this only happens for callers outside of this factory.
     //
     nRetries = MaxRetryCount;
     while (nRetries > 0)
@@ -288,8 +297,8 @@ HRESULT __stdcall TransactionShim::Export(
         }
         else if (hr == XACT_E_ALREADYINPROGRESS)
         {
-            Sleep(RetryInterval);
             nRetries--;
+            this->shimFactory->RetryBackoff( MaxRetryCount - nRetries );
             continue;
         }
         else
@@ -325,8 +334,8 @@ HRESULT __stdcall TransactionShim::Export(
         }
         else if (hr == XACT_E_ALREADYINPROGRESS)
         {
-            Sleep(RetryInterval);
             nRetries--;
+            this->shimFactory->RetryBackoff( MaxRetryCount - nRetries );
             continue;
         }
         else
@@ -341,6 +350,26 @@ HRESULT __stdcall TransactionShim::Export(
 
 ErrorExit:
 
+    if ( NULL != cachedExport )
+    {
+        if ( FAILED( hr ) )
+        {
+            // The connection to the remote TM may be what failed, so don't reuse it.
+            delete cachedExport;
+        }
+        else
+        {
+            this->shimFactory->ReturnCachedExport( cachedExport );
+        }
+        cachedExport = NULL;
+        pExport = NULL;
+    }
+
+    if ( exportLocked )
+    {
+        this->shimFactory->LeaveExportLock();
+    }
+
     if ( FAILED( hr ))
     {
         // This buffer gets freed from managed code if we are successful.  But since we failed, we need to free it.
@@ -353,9 +382,6 @@ ErrorExit:
         }
     }
 
-    SafeReleaseInterface( (IUnknown**) &pExport );
-    SafeReleaseInterface( (IUnknown**) &pExportFactory );
-
     return hr;
 }
 
@@ -472,7 +498,30 @@ HRESULT __stdcall TransactionShim::GetPropagationToken(
     ULONG propTokenSize = 0;
     BYTE* propToken = NULL;
     ULONG propTokenSizeUsed = 0;
+    CachedPropagationToken* cachedToken = NULL;
+
+    // Once the outcome is known the transaction can't be flowed any more, so let the
+    // transmitter report that instead of handing out the cached token.
+    if ( None == this->transactionNotifyShim->notificationType )
+    {
+        cachedToken = this->pCachedPropagationToken;
+    }
 
+    if ( NULL != cachedToken )
+    {
+        // This buffer gets freed by managed code.
+        propToken = (BYTE*) CoTaskMemAlloc( cachedToken->size );
+        if ( NULL == propToken )
+        {
+            hr = E_OUTOFMEMORY;
+            goto ErrorExit;
+        }
+        memcpy( propToken, cachedToken->token, cachedToken->size );
+
+        *pPropagationTokenSize = cachedToken->size;
+        *ppPropagationToken = propToken;
+        goto ErrorExit;
+    }
 
     hr = this->shimFactory->GetCachedTransmitter( this->pTransaction, &cachedTransmitter );
     if ( FAILED( hr ) )
@@ -508,6 +557,24 @@ HRESULT __stdcall TransactionShim::GetPropagationToken(
     *pPropagationTokenSize = propTokenSize;
     *ppPropagationToken = propToken;
 
+    if ( ( None == this->transactionNotifyShim->notificationType ) &&
+         ( NULL == this->pCachedPropagationToken ) )
+    {
+        // Failing to cache the token is not an error; the next caller just marshals it again.
+        cachedToken = (CachedPropagationToken*) new BYTE[ FIELD_OFFSET( CachedPropagationToken, token ) + propTokenSize ];
+        if ( NULL != cachedToken )
+        {
+            cachedToken->size = propTokenSize;
+            memcpy( cachedToken->token, propToken, propTokenSize );
+            if ( NULL != ::InterlockedCompareExchangePointer( (volatile PVOID*)&this->pCachedPropagationToken, cachedToken, NULL ) )
+            {
+                // Another thread cached it first.
+                delete [] (BYTE*) cachedToken;
+            }
+            cachedToken = NULL;
+        }
+    }
+
 ErrorExit:
 
     if ( FAILED( hr ) )
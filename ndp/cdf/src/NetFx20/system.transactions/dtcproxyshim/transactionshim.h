@@ -6,7 +6,7 @@
 
 EXTERN_C const GUID IID_ITransactionShim;
 
-class TransactionNotifyShim : public ITransactionOutcomeEvents, public NotificationShimBase
+class TransactionNotifyShim : public ITransactionOutcomeEvents, public NotificationShimBase, public ShimAllocationCache<TransactionNotifyShim>
 {
 public:
     TransactionNotifyShim( NotificationShimFactory* shimFactory, void* enlistmentIdentifier ) : NotificationShimBase( shimFactory, enlistmentIdentifier )
@@ -50,7 +50,7 @@ public:
     HRESULT __stdcall Indoubt();
 };
 
-class TransactionShim : public ITransactionShim
+class TransactionShim : public ITransactionShim, public ShimAllocationCache<TransactionShim>
 {
 public:
     TransactionShim( NotificationShimFactory* shimFactory, TransactionNotifyShim* notifyShim )
@@ -61,6 +61,7 @@ public:
         this->transactionNotifyShim->AddRef();
         this->refCount = 0;
         this->pTransaction = NULL;
+        this->pCachedPropagationToken = NULL;
     }
     
     ~TransactionShim(void);
@@ -134,5 +135,13 @@ private:
     ITransaction* pTransaction;
     TransactionNotifyShim* transactionNotifyShim;
 
+    // A copy of the propagation token, kept until the outcome of the transaction is known, so
+    // flowing the same transaction to several services only marshals the token once.
+    struct CachedPropagationToken
+    {
+        ULONG size;
+        BYTE token[1];
+    };
+    CachedPropagationToken* volatile pCachedPropagationToken;
 
 };
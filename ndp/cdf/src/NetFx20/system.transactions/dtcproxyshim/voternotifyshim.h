@@ -6,7 +6,7 @@
 
 EXTERN_C const GUID IID_IVoterBallotShim;
 
-class VoterNotifyShim : public ITransactionVoterNotifyAsync2, public NotificationShimBase
+class VoterNotifyShim : public ITransactionVoterNotifyAsync2, public NotificationShimBase, public ShimAllocationCache<VoterNotifyShim>
 {
 public:
     VoterNotifyShim( NotificationShimFactory* shimFactory, void* enlistmentIdentifier ) : NotificationShimBase( shimFactory, enlistmentIdentifier )
@@ -52,7 +52,7 @@ public:
     HRESULT __stdcall Indoubt();
 };
 
-class VoterShim : public IVoterBallotShim
+class VoterShim : public IVoterBallotShim, public ShimAllocationCache<VoterShim>
 {
 public:
     VoterShim( NotificationShimFactory* shimFactory, VoterNotifyShim* notifyShim )
@@ -27,6 +27,578 @@
 
 #include "BidApi_ldr.h"
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Binary trace recorder.
+//
+//  When "HKLM\SOFTWARE\Microsoft\BidInterface\Loader" has a DWORD value ":BinaryTrace", and an
+//  implementation DLL was loaded, BidTraceVA/BidTraceVW are routed through the recorder below.
+//  The value is the size of the per-thread buffer, in KB.
+//
+//  A traced call copies the format string pointer, the raw argument slots and any string
+//  arguments into a ring buffer owned by the calling thread. It takes no locks and does no
+//  formatting. A background thread replays the records through the implementation DLL's
+//  BidTraceV hooks, so all formatting happens there, off the traced thread.
+//
+//  Records from one thread are replayed in order, but the order between threads is not kept,
+//  and the implementation sees the drain thread as the caller. When a ring is full, new
+//  records are dropped and counted. Calls the recorder can't capture safely (%n, %Z, too many
+//  arguments) are passed straight through, as before.
+//
+#if defined( _M_IX86 ) || defined( _M_AMD64 )
+
+#define _BIDREC_REGKEY          BID_T("SOFTWARE\\Microsoft\\BidInterface\\Loader")
+#define _BIDREC_VALUE           BID_T(":BinaryTrace")
+
+#define _BIDREC_MIN_KB          4
+#define _BIDREC_MAX_KB          1024
+#define _BIDREC_MAX_SLOTS       32          // argument slots captured per record
+#define _BIDREC_MAX_STRLEN      256         // characters copied per string argument
+#define _BIDREC_MAX_RINGS       1024        // threads beyond this trace synchronously
+#define _BIDREC_DRAIN_MSEC      50
+#define _BIDREC_ALIGN(cb)       (((cb) + sizeof(UINT_PTR) - 1) & ~(sizeof(UINT_PTR) - 1))
+
+//
+//  A record is followed by cSlots argument slots and then by copies of the string arguments,
+//  which the slots are made to point at. A record with fmt == NULL pads the end of the ring.
+//
+typedef struct __bidRecord
+{
+    DWORD       cbRecord;
+    DWORD       bWide;
+    HANDLE      hID;
+    UINT_PTR    src;
+    UINT_PTR    info;
+    const void* fmt;
+    UINT_PTR    cSlots;
+
+} _bidRecord, * PBIDRECORD;
+
+typedef struct __bidRing
+{
+    struct __bidRing*   pNext;
+    BYTE*               pBuf;
+    LONG                cbBuf;
+    volatile LONG       iHead;      // written only by the owning thread
+    volatile LONG       iTail;      // written only by the drain thread
+    volatile LONG       bWakePending;
+    volatile LONG       cDropped;
+
+} _bidRing, * PBIDRING;
+
+static BidTraceVA_t         _bidRecNextVA       = NULL;
+static BidTraceVW_t         _bidRecNextVW       = NULL;
+static DWORD                _bidRecTlsIndex     = TLS_OUT_OF_INDEXES;
+static LONG                 _bidRecRingSize     = 0;
+static PBIDRING volatile    _bidRecRings        = NULL;
+static volatile LONG        _bidRecRingCount    = 0;
+static HANDLE               _bidRecWakeEvent    = NULL;
+static CRITICAL_SECTION     _bidRecDrainLock;
+
+
+//
+//  Describes one conversion of a printf-style format string.
+//
+typedef struct __bidRecConv
+{
+    int     cSlots;         // argument slots consumed, including '*' width/precision
+    int     bString;        // 1 = narrow string, 2 = wide string
+    int     bPrecision;     // a precision was given (numeric or '*')
+    int     precision;      // numeric precision, or -1 if it comes from a '*' slot
+    int     bUnsafe;        // can't be captured; trace this call synchronously
+
+} _bidRecConv;
+
+template <class CH>
+static const CH* _bidRecParseConv( const CH* p, BOOL bWideFmt, __out _bidRecConv* pConv )
+{
+    int     bLong   = 0;
+    int     bShort  = 0;
+    int     b64     = 0;
+
+    pConv->cSlots       = 0;
+    pConv->bString      = 0;
+    pConv->bPrecision   = 0;
+    pConv->precision    = 0;
+    pConv->bUnsafe      = 0;
+
+    while( *p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' ) p++;
+
+    if( *p == '*' ){ pConv->cSlots++; p++; }
+    while( *p >= '0' && *p <= '9' ) p++;
+
+    if( *p == '.' )
+    {
+        p++;
+        pConv->bPrecision = 1;
+        if( *p == '*' ){ pConv->cSlots++; pConv->precision = -1; p++; }
+        while( *p >= '0' && *p <= '9' ){ pConv->precision = pConv->precision * 10 + (*p - '0'); p++; }
+    }
+
+    for( ;; )
+    {
+        if( *p == 'h' ){ bShort = 1; p++; }
+        else if( *p == 'l' ){ if( bLong ) b64 = 1; bLong = 1; p++; }
+        else if( *p == 'w' ){ bLong = 1; p++; }
+        else if( *p == 'I' )
+        {
+            p++;
+            if( p[0] == '6' && p[1] == '4' ){ b64 = 1; p += 2; }
+            else if( p[0] == '3' && p[1] == '2' ){ p += 2; }
+            else { b64 = (sizeof(UINT_PTR) == 8); }
+        }
+        else break;
+    }
+
+    switch( *p )
+    {
+     case 'e': case 'E': case 'f': case 'g': case 'G': case 'a': case 'A':
+        pConv->cSlots += (int)(sizeof(double) / sizeof(UINT_PTR));
+        break;
+
+     case 's':
+        pConv->cSlots++;
+        pConv->bString = (bShort || (!bLong && !bWideFmt)) ? 1 : 2;
+        break;
+
+     case 'S':
+        pConv->cSlots++;
+        pConv->bString = (bLong || (!bShort && bWideFmt)) ? 2 : 1;
+        break;
+
+     case 'n': case 'Z': case '\0':
+        pConv->bUnsafe = 1;
+        break;
+
+     default:
+        pConv->cSlots += b64 ? (int)(sizeof(__int64) / sizeof(UINT_PTR)) : 1;
+        break;
+    }
+
+    return (*p != '\0') ? p + 1 : p;
+}
+
+//
+//  Returns the number of argument slots used by fmt and the number of bytes needed for copies
+//  of its string arguments, or FALSE if the call has to be traced synchronously.
+//
+template <class CH>
+static BOOL _bidRecMeasure( const CH* fmt, BOOL bWideFmt, va_list args,
+                            __out UINT_PTR* pcSlots, __out UINT_PTR* pcbStrings )
+{
+    const CH*   p       = fmt;
+    UINT_PTR*   pSlot   = (UINT_PTR*)args;
+    UINT_PTR    cSlots  = 0;
+    UINT_PTR    cbStr   = 0;
+    _bidRecConv conv;
+
+    while( *p != '\0' )
+    {
+        if( *p++ != '%' ) continue;
+        if( *p == '%' ){ p++; continue; }
+
+        p = _bidRecParseConv( p, bWideFmt, &conv );
+        if( conv.bUnsafe || cSlots + conv.cSlots > _BIDREC_MAX_SLOTS )
+        {
+            return FALSE;
+        }
+
+        if( conv.bString && pSlot[cSlots + conv.cSlots - 1] != 0 )
+        {
+            int     limit = _BIDREC_MAX_STRLEN;
+            int     len   = 0;
+
+            if( conv.bPrecision )
+            {
+                int prec = (conv.precision < 0) ? (int)pSlot[cSlots + conv.cSlots - 2] : conv.precision;
+                if( prec >= 0 && prec < limit ) limit = prec;
+            }
+
+            if( conv.bString == 1 )
+            {
+                PCSTR s = (PCSTR)pSlot[cSlots + conv.cSlots - 1];
+                while( len < limit && s[len] != '\0' ) len++;
+                cbStr += _BIDREC_ALIGN( (len + 1) * sizeof(CHAR) );
+            }
+            else
+            {
+                PCWSTR s = (PCWSTR)pSlot[cSlots + conv.cSlots - 1];
+                while( len < limit && s[len] != L'\0' ) len++;
+                cbStr += _BIDREC_ALIGN( (len + 1) * sizeof(WCHAR) );
+            }
+        }
+        cSlots += conv.cSlots;
+    }
+
+    *pcSlots    = cSlots;
+    *pcbStrings = cbStr;
+    return TRUE;
+}
+
+//
+//  Copies the slots and string arguments into pRec, which has room for them.
+//
+template <class CH>
+static void _bidRecCapture( const CH* fmt, BOOL bWideFmt, va_list args, UINT_PTR cSlots,
+                            __out PBIDRECORD pRec )
+{
+    const CH*   p       = fmt;
+    UINT_PTR*   pSrc    = (UINT_PTR*)args;
+    UINT_PTR*   pDst    = (UINT_PTR*)(pRec + 1);
+    BYTE*       pStr    = (BYTE*)(pDst + cSlots);
+    UINT_PTR    iSlot   = 0;
+    _bidRecConv conv;
+
+    memcpy( pDst, pSrc, cSlots * sizeof(UINT_PTR) );
+
+    while( *p != '\0' )
+    {
+        if( *p++ != '%' ) continue;
+        if( *p == '%' ){ p++; continue; }
+
+        p = _bidRecParseConv( p, bWideFmt, &conv );
+        iSlot += conv.cSlots;
+
+        if( conv.bString && pDst[iSlot - 1] != 0 )
+        {
+            int     limit = _BIDREC_MAX_STRLEN;
+            int     len   = 0;
+
+            if( conv.bPrecision )
+            {
+                int prec = (conv.precision < 0) ? (int)pDst[iSlot - 2] : conv.precision;
+                if( prec >= 0 && prec < limit ) limit = prec;
+            }
+
+            if( conv.bString == 1 )
+            {
+                PCSTR s = (PCSTR)pDst[iSlot - 1];
+                while( len < limit && s[len] != '\0' ) len++;
+                memcpy( pStr, s, len * sizeof(CHAR) );
+                ((CHAR*)pStr)[len] = '\0';
+                pDst[iSlot - 1] = (UINT_PTR)pStr;
+                pStr += _BIDREC_ALIGN( (len + 1) * sizeof(CHAR) );
+            }
+            else
+            {
+                PCWSTR s = (PCWSTR)pDst[iSlot - 1];
+                while( len < limit && s[len] != L'\0' ) len++;
+                memcpy( pStr, s, len * sizeof(WCHAR) );
+                ((WCHAR*)pStr)[len] = L'\0';
+                pDst[iSlot - 1] = (UINT_PTR)pStr;
+                pStr += _BIDREC_ALIGN( (len + 1) * sizeof(WCHAR) );
+            }
+        }
+    }
+}
+
+static PBIDRING _bidRecGetRing( void )
+{
+    PBIDRING    pRing = (PBIDRING)TlsGetValue( _bidRecTlsIndex );
+    PBIDRING    pHead;
+
+    if( pRing != NULL )
+    {
+        return pRing;
+    }
+
+    if( InterlockedIncrement( &_bidRecRingCount ) > _BIDREC_MAX_RINGS )
+    {
+        InterlockedDecrement( &_bidRecRingCount );
+        return NULL;
+    }
+
+    pRing = (PBIDRING)HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(_bidRing) + _bidRecRingSize );
+    if( pRing == NULL )
+    {
+        InterlockedDecrement( &_bidRecRingCount );
+        return NULL;
+    }
+    pRing->pBuf  = (BYTE*)(pRing + 1);
+    pRing->cbBuf = _bidRecRingSize;
+
+    //
+    //  Rings are never freed; a thread that exits just leaves an empty ring behind.
+    //
+    do
+    {
+        pHead = _bidRecRings;
+        pRing->pNext = pHead;
+    }
+    while( InterlockedCompareExchangePointer( (PVOID volatile*)&_bidRecRings, pRing, pHead ) != pHead );
+
+    TlsSetValue( _bidRecTlsIndex, pRing );
+    return pRing;
+}
+
+//
+//  Reserves cbRecord contiguous bytes in the calling thread's ring. Returns NULL if the ring is
+//  full. *piNewHead receives the head to publish once the record is written.
+//
+static PBIDRECORD _bidRecReserve( PBIDRING pRing, LONG cbRecord, __out LONG* piNewHead )
+{
+    LONG    head = pRing->iHead;
+    LONG    tail = pRing->iTail;
+    LONG    cb   = pRing->cbBuf;
+
+    if( tail > head )
+    {
+        if( head + cbRecord >= tail ) return NULL;
+        *piNewHead = head + cbRecord;
+        return (PBIDRECORD)(pRing->pBuf + head);
+    }
+
+    if( head + cbRecord < cb || (head + cbRecord == cb && tail != 0) )
+    {
+        *piNewHead = (head + cbRecord) % cb;
+        return (PBIDRECORD)(pRing->pBuf + head);
+    }
+
+    //
+    //  Doesn't fit before the end of the buffer; pad to the end and start over at 0.
+    //
+    if( cbRecord >= tail ) return NULL;
+
+    PBIDRECORD pPad = (PBIDRECORD)(pRing->pBuf + head);
+    pPad->cbRecord = (DWORD)(cb - head);
+    if( cb - head >= (LONG)sizeof(_bidRecord) )
+    {
+        pPad->fmt = NULL;
+    }
+    *piNewHead = cbRecord;
+    return (PBIDRECORD)pRing->pBuf;
+}
+
+template <class CH>
+static BOOL _bidRecRecord( HANDLE hID, UINT_PTR src, UINT_PTR info, const CH* fmt, va_list args, BOOL bWide )
+{
+    PBIDRING    pRing;
+    PBIDRECORD  pRec;
+    UINT_PTR    cSlots;
+    UINT_PTR    cbStrings;
+    LONG        cbRecord;
+    LONG        iNewHead;
+
+    if( fmt == NULL || !_bidRecMeasure( fmt, bWide, args, &cSlots, &cbStrings ) )
+    {
+        return FALSE;
+    }
+
+    cbRecord = (LONG)(sizeof(_bidRecord) + cSlots * sizeof(UINT_PTR) + cbStrings);
+    pRing = _bidRecGetRing();
+    if( pRing == NULL || cbRecord > pRing->cbBuf / 4 )
+    {
+        return FALSE;
+    }
+
+    pRec = _bidRecReserve( pRing, cbRecord, &iNewHead );
+    if( pRec == NULL )
+    {
+        InterlockedIncrement( &pRing->cDropped );
+        return TRUE;
+    }
+
+    pRec->cbRecord  = (DWORD)cbRecord;
+    pRec->bWide     = bWide;
+    pRec->hID       = hID;
+    pRec->src       = src;
+    pRec->info      = info;
+    pRec->fmt       = fmt;
+    pRec->cSlots    = cSlots;
+    _bidRecCapture( fmt, bWide, args, cSlots, pRec );
+
+    //
+    //  Publish the record; InterlockedExchange orders the writes above before the new head.
+    //
+    InterlockedExchange( &pRing->iHead, iNewHead );
+
+    //
+    //  Wake the drain thread early once the ring is half full.
+    //
+    LONG used = iNewHead - pRing->iTail;
+    if( used < 0 ) used += pRing->cbBuf;
+    if( used > pRing->cbBuf / 2 && InterlockedExchange( &pRing->bWakePending, 1 ) == 0 )
+    {
+        SetEvent( _bidRecWakeEvent );
+    }
+    return TRUE;
+}
+
+static BOOL WINAPI _bidRecTraceVA( HANDLE hID, UINT_PTR src, UINT_PTR info, PCSTR fmt, va_list args )
+{
+    if( _bidRecRecord( hID, src, info, fmt, args, FALSE ) )
+    {
+        return TRUE;
+    }
+    return (*_bidRecNextVA)( hID, src, info, fmt, args );
+}
+
+static BOOL WINAPI _bidRecTraceVW( HANDLE hID, UINT_PTR src, UINT_PTR info, PCWSTR fmt, va_list args )
+{
+    if( _bidRecRecord( hID, src, info, fmt, args, TRUE ) )
+    {
+        return TRUE;
+    }
+    return (*_bidRecNextVW)( hID, src, info, fmt, args );
+}
+
+static void _bidRecTraceDropped( LONG cDropped )
+{
+    UINT_PTR    arg = (UINT_PTR)cDropped;
+
+    (void)(*_bidRecNextVA)( _bidID, 0, 0, "<bid.rec|INFO> %d trace records dropped, ring full\n", (va_list)&arg );
+}
+
+//
+//  Replays everything recorded so far. Serialized so DllBidFinalize can drain alongside the
+//  drain thread.
+//
+static void _bidRecDrain( void )
+{
+    PBIDRING    pRing;
+    PBIDRECORD  pRec;
+    LONG        head;
+    LONG        tail;
+    LONG        cDropped;
+
+    EnterCriticalSection( &_bidRecDrainLock );
+
+    for( pRing = _bidRecRings; pRing != NULL; pRing = pRing->pNext )
+    {
+        InterlockedExchange( &pRing->bWakePending, 0 );
+
+        head = pRing->iHead;
+        tail = pRing->iTail;
+
+        while( tail != head )
+        {
+            pRec = (PBIDRECORD)(pRing->pBuf + tail);
+
+            if( pRing->cbBuf - tail >= (LONG)sizeof(_bidRecord) && pRec->fmt != NULL )
+            {
+                //
+                //  On x86 and x64 a va_list is a pointer to consecutive argument slots.
+                //
+                if( pRec->bWide )
+                {
+                    (void)(*_bidRecNextVW)( pRec->hID, pRec->src, pRec->info,
+                                            (PCWSTR)pRec->fmt, (va_list)(pRec + 1) );
+                }
+                else
+                {
+                    (void)(*_bidRecNextVA)( pRec->hID, pRec->src, pRec->info,
+                                            (PCSTR)pRec->fmt, (va_list)(pRec + 1) );
+                }
+            }
+            tail = (tail + (LONG)pRec->cbRecord) % pRing->cbBuf;
+        }
+
+        InterlockedExchange( &pRing->iTail, tail );
+
+        cDropped = InterlockedExchange( &pRing->cDropped, 0 );
+        if( cDropped != 0 )
+        {
+            _bidRecTraceDropped( cDropped );
+        }
+    }
+
+    LeaveCriticalSection( &_bidRecDrainLock );
+}
+
+static DWORD WINAPI _bidRecDrainThread( LPVOID pArg )
+{
+    pArg;
+    for( ;; )
+    {
+        WaitForSingleObject( _bidRecWakeEvent, _BIDREC_DRAIN_MSEC );
+        _bidRecDrain();
+    }
+}
+
+static void _bidRecEnable( void )
+{
+    HKEY    hKey     = NULL;
+    DWORD   dwKB     = 0;
+    DWORD   dwSize   = sizeof(dwKB);
+    DWORD   regType  = REG_NONE;
+    HANDLE  hThread;
+
+    if( BidNotLoaded() )
+    {
+        return;
+    }
+
+    if( BID_RegOpenKeyEx( HKEY_LOCAL_MACHINE, _BIDREC_REGKEY, 0, KEY_QUERY_VALUE, &hKey ) != ERROR_SUCCESS )
+    {
+        return;
+    }
+    if( BID_RegQueryValueEx( hKey, _BIDREC_VALUE, NULL, &regType, (LPBYTE)&dwKB, &dwSize ) != ERROR_SUCCESS ||
+        regType != REG_DWORD || dwKB == 0 )
+    {
+        dwKB = 0;
+    }
+    BID_RegCloseKey( hKey );
+
+    if( dwKB == 0 )
+    {
+        return;
+    }
+    if( dwKB < _BIDREC_MIN_KB ) dwKB = _BIDREC_MIN_KB;
+    if( dwKB > _BIDREC_MAX_KB ) dwKB = _BIDREC_MAX_KB;
+    _bidRecRingSize = (LONG)(dwKB * 1024);
+
+    _bidRecTlsIndex = TlsAlloc();
+    if( _bidRecTlsIndex == TLS_OUT_OF_INDEXES )
+    {
+        return;
+    }
+
+    if( !InitializeCriticalSectionAndSpinCount( &_bidRecDrainLock, 0 ) )
+    {
+        goto Fail;
+    }
+
+    _bidRecWakeEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+    if( _bidRecWakeEvent == NULL )
+    {
+        DeleteCriticalSection( &_bidRecDrainLock );
+        goto Fail;
+    }
+
+    _bidRecNextVA = _bidPfn.BidTraceVA;
+    _bidRecNextVW = _bidPfn.BidTraceVW;
+
+    hThread = CreateThread( NULL, 0, _bidRecDrainThread, NULL, 0, NULL );
+    if( hThread == NULL )
+    {
+        _bidRecNextVA = NULL;
+        _bidRecNextVW = NULL;
+        CloseHandle( _bidRecWakeEvent );
+        _bidRecWakeEvent = NULL;
+        DeleteCriticalSection( &_bidRecDrainLock );
+        goto Fail;
+    }
+    CloseHandle( hThread );
+
+    _bidPfn.BidTraceVA = _bidRecTraceVA;
+    _bidPfn.BidTraceVW = _bidRecTraceVW;
+    return;
+
+Fail:
+    TlsFree( _bidRecTlsIndex );
+    _bidRecTlsIndex = TLS_OUT_OF_INDEXES;
+}
+
+#define _bidRecFlush()      _bid_DO if( _bidRecNextVW != NULL ) _bidRecDrain(); _bid_WHILE0
+
+#else   // binary recorder needs a va_list that is a plain pointer to argument slots
+
+#define _bidRecEnable()
+#define _bidRecFlush()
+
+#endif
+
+
 //
 //  Explicit initialization
 //
@@ -37,6 +609,7 @@ extern "C" _bidAPI_EXPORT void WINAPI DllBidInitialize()
     if( InterlockedIncrement( &_bidIniCount ) == 1 )
     {
         BidSelectAndLoad();
+        _bidRecEnable();
     }
 }
 
@@ -46,6 +619,11 @@ extern "C" _bidAPI_EXPORT void WINAPI DllBidFinalize()
     {
         _bidIniCount = 0;
 
+        //
+        //  Hand whatever the binary recorder still holds to the implementation.
+        //
+        _bidRecFlush();
+
         //
         //  Disabled to reflect the fact that native part of the assembly stays loaded
         //  for the lifetime of Win32 process, no matter how many times managed appdomains
@@ -147,7 +147,8 @@ struct SNI_ConnWrapper
         m_fSyncOverAsyncRead(false),
         m_fSyncOverAsyncWrite(false),
         m_fSupportsSyncOverAsync(false),
-        m_fPendingRead(false)
+        m_fPendingRead(false),
+        m_lReadSpinState(READ_SPIN_IDLE)
     {
         m_ReadResponseReady = ::CreateSemaphore(NULL, 0, 1, NULL);
         m_WriteResponseReady = ::CreateSemaphore(NULL, 0, 1, NULL);
@@ -177,8 +178,26 @@ struct SNI_ConnWrapper
     bool m_fSyncOverAsyncRead;
     bool m_fSyncOverAsyncWrite;
     bool m_fSupportsSyncOverAsync;
+
+    // Hand-off between SNIReadSyncOverAsync spinning for a read and UnmanagedReadCallback.
+    // When the callback finds the reader spinning it sets READ_SPIN_COMPLETED instead of
+    // releasing m_ReadResponseReady, so the reader never waits on the semaphore.
+    enum { READ_SPIN_IDLE = 0, READ_SPIN_WAITING = 1, READ_SPIN_COMPLETED = 2 };
+    volatile LONG m_lReadSpinState;
 };
 
+// Number of times SNIReadSyncOverAsync polls for a pending read to complete before
+// blocking on m_ReadResponseReady.  0 (the default) always blocks straight away.
+static volatile DWORD g_dwSyncOverAsyncReadSpinCount = 0;
+
+void SNISetSyncOverAsyncReadSpinCount(DWORD dwSpinCount) {
+    SYSTEM_INFO si;
+    ::GetSystemInfo(&si);
+
+    // Spinning only helps if the completing thread can run at the same time.
+    g_dwSyncOverAsyncReadSpinCount = (si.dwNumberOfProcessors > 1) ? dwSpinCount : 0;
+}
+
 DWORD SNIWriteAsyncWrapper(__in SNI_ConnWrapper * pConn, __in SNI_Packet * pPacket) {
     pConn->m_fSyncOverAsyncWrite = false;
     return SNIWriteAsync(pConn->m_pConn, pPacket);
@@ -236,7 +255,28 @@ DWORD SNIReadSyncOverAsync(__in SNI_ConnWrapper * pConn, __out SNI_Packet ** ppN
     }
 
     if( ERROR_IO_PENDING == dwError ) {
-        dwError = ::WaitForSingleObject(pConn->m_ReadResponseReady, timeout);
+        DWORD dwSpinCount = g_dwSyncOverAsyncReadSpinCount;
+        bool fCompletedWhileSpinning = false;
+
+        if (0 != dwSpinCount && 0 != timeout) {
+            ::InterlockedExchange(&pConn->m_lReadSpinState, SNI_ConnWrapper::READ_SPIN_WAITING);
+
+            for (DWORD i = 0; i < dwSpinCount && SNI_ConnWrapper::READ_SPIN_COMPLETED != pConn->m_lReadSpinState; i++) {
+                YieldProcessor();
+            }
+
+            // Either withdraw from spinning, after which the callback releases the semaphore
+            // as usual, or find that it already completed the read for us.
+            fCompletedWhileSpinning = (SNI_ConnWrapper::READ_SPIN_WAITING != ::InterlockedCompareExchange(&pConn->m_lReadSpinState, 
+                                                                                                            SNI_ConnWrapper::READ_SPIN_IDLE, 
+                                                                                                            SNI_ConnWrapper::READ_SPIN_WAITING));
+            if (fCompletedWhileSpinning) {
+                assert(SNI_ConnWrapper::READ_SPIN_COMPLETED == pConn->m_lReadSpinState);
+                pConn->m_lReadSpinState = SNI_ConnWrapper::READ_SPIN_IDLE;
+            }
+        }
+
+        dwError = fCompletedWhileSpinning ? ERROR_SUCCESS : ::WaitForSingleObject(pConn->m_ReadResponseReady, timeout);
         
         if (dwError == ERROR_TIMEOUT) {
             // treat ERROR_TIMEOUT as WAIT_TIMEOUT as that is what is expected by callers
@@ -287,7 +327,12 @@ void UnmanagedReadCallback(LPVOID ConsKey, SNI_Packet * pPacket, DWORD dwError)
             assert(pConn->m_Error.dwNativeError != ERROR_SUCCESS);
         }
 
-        ::ReleaseSemaphore(pConn->m_ReadResponseReady, 1, NULL);
+        // A reader spinning in SNIReadSyncOverAsync picks the result up without the semaphore.
+        if (SNI_ConnWrapper::READ_SPIN_WAITING != ::InterlockedCompareExchange(&pConn->m_lReadSpinState, 
+                                                                               SNI_ConnWrapper::READ_SPIN_COMPLETED, 
+                                                                               SNI_ConnWrapper::READ_SPIN_WAITING)) {
+            ::ReleaseSemaphore(pConn->m_ReadResponseReady, 1, NULL);
+        }
     }
 
 }
@@ -649,6 +694,7 @@ private:
     static void (*SNIPacketReleasePtr)(SNI_Packet* pPacket) = ::SNIPacketRelease;
     static void (*SNIPacketResetPtr)(SNI_Conn*, SNI_Packet_IOType, SNI_Packet*, ConsumerNum) = ::SNIPacketReset;
     static DWORD (*SNIPacketGetDataWrapperPtr)(SNI_Packet*, BYTE*, DWORD, DWORD*) = ::SNIPacketGetDataWrapper;
+    static void (*SNIPacketGetDataPtr)(SNI_Packet*, BYTE**, DWORD*) = ::SNIPacketGetData;
     static void (*SNIPacketSetDataPtr)(SNI_Packet*, const BYTE*, DWORD) = ::SNIPacketSetData;
 
 internal:
@@ -812,6 +858,24 @@ internal:
             return ret;
         }
 
+        // Same as SNIPacketGetData, but returns a pointer to the payload in the packet's own
+        // (native, so never moved by the GC) buffer instead of copying it into a managed array.
+        // The pointer is only valid until the packet is passed to SNIPacketRelease or SNIPacketReset;
+        // callers must finish reading, or copy what they keep, before releasing the packet.
+        [ResourceExposure(ResourceScope::None)]
+        static System::UInt32 SNIPacketGetDataPointer (System::IntPtr packet, 
+                                      System::IntPtr%   data,
+                                      System::UInt32%   dataSize)
+        {
+            cli::pin_ptr<SNI_Packet>  pin_packet = static_cast<SNI_Packet*>(packet.ToPointer ());
+            BYTE* _data = NULL;
+            DWORD _dataSize = 0;
+            SNIPacketGetDataPtr(pin_packet, &_data, &_dataSize);
+            data = static_cast<System::IntPtr>(_data);
+            dataSize = _dataSize;
+            return ERROR_SUCCESS;
+        }
+
         [ResourceExposure(ResourceScope::None)]
         static void SNIPacketReset (SafeHandle^ pConn,
                                     IOType ioType,
@@ -1123,6 +1187,16 @@ internal:
            return ret;
         }
 
+        // Lets SNIReadSyncOverAsync poll briefly for a read to complete before blocking on
+        // an event; useful when round trips are short and the machine has spare cores.
+        // Reads that complete synchronously never wait either way.
+        [ResourceExposure(ResourceScope::Process)]
+        [ResourceConsumption(ResourceScope::Process, ResourceScope::Process)]
+        static void SNISetSyncOverAsyncReadSpinCount (System::UInt32 spinCount)
+        {
+            ::SNISetSyncOverAsyncReadSpinCount(spinCount);
+        }
+
         [ResourceExposure(ResourceScope::None)]
         static System::UInt32 SNICheckConnection (SafeHandle^  pConn)
         {
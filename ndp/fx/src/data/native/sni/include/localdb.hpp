@@ -28,6 +28,19 @@
 //
 #define LOCALDB_TRUNCATE_ERR_MESSAGE        0x0001L
 
+// Number of instance names whose resolved connection strings (named pipe
+// names) the LocalDB object remembers.  Applications rarely talk to more
+// than one or two LocalDB instances, so a small table is sufficient; when
+// it is full the oldest slot is reused.
+//
+#define LOCALDB_CACHE_SIZE 8
+
+typedef struct
+{
+	WCHAR wszInstanceName[CONNECT_MAX];
+	WCHAR wszConnect[CONNECT_MAX];
+} LocalDBCacheEntry;
+
 typedef HRESULT __cdecl
 FnLocalDBStartInstance(
         __in                PCWSTR  pInstanceName,
@@ -60,6 +73,13 @@ private:
         m_pfnLocalDBStartInstance = NULL;
         m_pfnLocalDBFormatMessage = NULL;
 		m_CS = NULL;
+		m_iNextCacheEntry = 0;
+
+		for( DWORD i = 0; i < LOCALDB_CACHE_SIZE; i++ )
+		{
+			m_rgCache[i].wszInstanceName[0] = L'\0';
+			m_rgCache[i].wszConnect[0] = L'\0';
+		}
     };
 
 	// PRIVATE: Destroying the singleton LocalDB object must be done only through the static
@@ -81,6 +101,17 @@ private:
 		// no op
 	}
 
+	// Connection strings returned by LocalDBStartInstance, keyed by instance 
+	// name.  Guarded by m_CS.
+	//
+	LocalDBCacheEntry m_rgCache[LOCALDB_CACHE_SIZE];
+
+	DWORD m_iNextCacheEntry;
+
+	int findCacheEntry( __in LPCWSTR wszInstanceName );
+
+	static bool fCachedPipeExists( __in LPCWSTR wszConnect );
+
 public:
 
 	volatile HMODULE m_hUserInstanceDll;
@@ -105,6 +136,8 @@ public:
                                            __out_ecount(pcchLocalDBConnectBuf) LPWSTR wszlocalDBConnect,
                                            __inout LPDWORD pcchLocalDBConnectBuf);
 
+    void invalidateLocalDBConnectionString( __in LPCWSTR wszInstanceName );
+
     static DWORD __cdecl getLocalDBErrorMessage(__in DWORD dwNativeError,
                                                     __out_ecount(pcchErrMsgBuf)LPWSTR wszErrorMessage,
                                                     __inout LPDWORD pcchErrMsgBuf);
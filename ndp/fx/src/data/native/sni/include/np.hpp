@@ -71,6 +71,17 @@ private:
 
 	bool 			m_fWritePending;
 
+	// The pending write was built by DeQueueCoalesced(), and every packet 
+	// chained behind its first one still needs its own completion.  
+	//
+	bool			m_fCoalescedWrite;
+
+	// Bounce buffer for writes of a packet chain (coalesced or gathered); 
+	// only one write is outstanding at a time, so one buffer is enough.  
+	//
+	BYTE *			m_pbWriteBuf;
+	DWORD			m_cbWriteBuf;
+
 	BOOL			m_fClose; 
 
 	DWORD			m_dwcHandleRef; 
@@ -136,6 +147,9 @@ public:
 
 	DWORD WriteAsync( SNI_Packet * pPacket, 
 		              SNI_ProvInfo * pProvInfo );
+
+	DWORD GatherWriteAsync( SNI_Packet * pPacket, 
+		              SNI_ProvInfo * pProvInfo );
 	
 	DWORD ReadDone( __deref_inout SNI_Packet ** ppPacket, 
 		            __deref_out SNI_Packet ** ppLeftOver, 
@@ -197,6 +211,8 @@ private:
 
 	DWORD SendPacketAsync( SNI_Packet *pPacket, DWORD *pdwBytesWritten );
 
+	SNI_Packet * DeQueueCoalesced();
+
 	DWORD Win9xWaitForData( int iTimeOut ); 
 
 };
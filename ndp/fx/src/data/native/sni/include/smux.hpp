@@ -48,7 +48,8 @@ private:
 	SNICritSec *m_SessionListCS;	//Critical section to protect session list
 
 	DWORD 	m_nSessions;		//Number of sessions
-	DWORD	m_MaxSessions;	//Number of sessions that we allocated space for
+	DWORD	m_MaxSessions;	//Number of session IDs in use so far (highest ID + 1)
+	DWORD	m_cSessionSlots;	//Number of entries allocated in m_rgSessions
 	Session ** m_rgSessions;	//pointer to start of Sessions array
 
 
@@ -197,6 +197,9 @@ typedef enum
 #ifdef SNI_BASED_CLIENT
 	// NOTE: Keep all conditional QTypes at the end of the enum
 	SNI_QUERY_TCP_SKIP_IO_COMPLETION_ON_SUCCESS,
+	SNI_QUERY_PACKET_CACHE_STATS,
+	SNI_QUERY_CONN_OPEN_TIMINGS,
+	SNI_QUERY_CONN_IO_STATS,
 #endif
 } QTypes;
 
@@ -332,6 +335,55 @@ typedef struct
 	int PeerAddrLen;
 } PeerAddrInfo;
 
+#ifdef SNI_BASED_CLIENT
+// Per-processor packet cache counters for SNI_QUERY_PACKET_CACHE_STATS.  
+// cbBuffer is set by the caller and selects the memory region that serves 
+// packets of that size; the counters are summed over all processors.
+typedef struct
+{
+	DWORD		cbBuffer;
+	DWORD		cMagazines;
+	DWORD		cMagazineSize;
+	ULONGLONG	cHits;
+	ULONGLONG	cMisses;
+	ULONGLONG	cOverflows;
+} SNI_PACKET_CACHE_STATS;
+#endif
+
+// Where the time went while opening a connection, for SNI_QUERY_CONN_OPEN_TIMINGS.  
+// All times are in milliseconds; a phase that did not run stays 0.  dwSspi 
+// and the other SSPI fields accumulate over SNISecGenClientContext calls, so 
+// they are only complete once the consumer has finished logging in.  Each 
+// round trip is one InitializeSecurityContext call.
+typedef struct
+{
+	DWORD	dwTotal;			// SNIOpenSyncEx, end to end
+	DWORD	dwSsrp;				// SQL Browser queries
+	DWORD	dwResolve;			// name resolution in Tcp::Open
+	DWORD	dwTcpConnect;		// socket connects, all addresses
+	DWORD	cAddresses;			// addresses the name resolved to
+	DWORD	cAddressAttempts;	// connects actually started
+	DWORD	dwSslHandshake;		// TLS handshake
+	DWORD	dwSspi;				// InitializeSecurityContext calls
+	DWORD	cSspiRoundTrips;	// InitializeSecurityContext calls made
+	DWORD	dwSspiMax;			// slowest of them
+	DWORD	dwSspiAcquireCred;	// AcquireCredentialsHandle, 0 on a cache hit
+} SNI_OPEN_TIMINGS;
+
+// Traffic on a connection since it was opened, for SNI_QUERY_CONN_IO_STATS.  
+// Bytes are counted per completed I/O: an I/O that completes asynchronously 
+// counts the transport's byte count (so SSL and SMUX framing is included), 
+// one that completes inline counts the packet size the consumer passed in 
+// or got back, or the partial read size.  
+typedef struct
+{
+	ULONGLONG	cbSent;
+	ULONGLONG	cbRecd;
+	DWORD		cPacketsSent;
+	DWORD		cPacketsRecd;
+	DWORD		cPartialReads;		// SNIPartialReadAsync/Sync calls
+} SNI_CONN_IO_STATS;
+
 
 //----------------------------------------------------------------------------
 // Name: 	SNI_ListenInfo
@@ -537,6 +589,23 @@ typedef struct
 extern "C" DWORD SNIInitialize(void * pmo = NULL);
 extern "C" DWORD SNIInitializeEx(void * pmo, const ProviderNum * rgProviders, DWORD cProviders, BOOL fIsSystemInst, BOOL fSandbox);
 extern "C" DWORD SNITerminate();
+#ifdef SNI_BASED_CLIENT
+extern "C" DWORD SNISetAsyncWaitThreadCount(DWORD cThreads);
+extern "C" DWORD SNISetAsyncWaitBatchSize(DWORD cEntries);
+extern "C" DWORD SNISetPacketCacheMagazineSize(DWORD cbBuffer, DWORD cPackets);
+#endif
+extern "C" DWORD SNISetSmuxWriteCoalescing(BOOL fCoalesce);
+extern "C" DWORD SNISetTcpAddressCache(DWORD dwTtl, DWORD dwNegativeTtl);
+extern "C" DWORD SNISetTcpConnectStagger(DWORD dwDelay);
+extern "C" DWORD SNISetTcpLoopbackFastPath(BOOL fEnable);
+extern "C" DWORD SNISetTcpCheckConnectionIdle(DWORD dwIdle);
+extern "C" DWORD SNISetTcpAcceptBacklog(DWORD cMin, DWORD cMax);
+extern "C" DWORD SNISetSsrpCache(DWORD dwTtl);
+extern "C" DWORD SNISetSpnCache(DWORD dwTtl);
+extern "C" DWORD SNISetSspiCredentialCache(BOOL fEnable);
+extern "C" DWORD SNISetNpWriteCoalescing(DWORD cbMax);
+extern "C" DWORD SNISetScopeSampling(DWORD dwSampleRate, DWORD dwMaxPerSec);
+extern "C" DWORD SNIDumpScopeStats(BOOL fReset);
 extern "C" DWORD SNIInitializeListener(__in SNI_CONSUMER_INFO * pConsumerInfo, __out HANDLE * pListenHandle);
 extern "C" DWORD SNITerminateListener(__inout HANDLE hListener);
 extern "C" DWORD SNIUpdateListener(HANDLE hListener, ProviderNum ProvNum, LPVOID pInfo);
@@ -569,6 +638,12 @@ extern "C"  DWORD SNIReadAsync( __out_opt SNI_Conn * pConn,
 extern "C"  DWORD SNIReadSync(	__in SNI_Conn    * pConn,
 								__out SNI_Packet ** ppNewPacket,
 								int        timeout );
+extern "C"  DWORD SNIReadSyncMultiple(	__in SNI_Conn    * pConn,
+										__out SNI_Packet ** ppPacketChain,
+										DWORD        cMaxPackets, 
+										DWORD        cbMaxBytes, 
+										int          timeout, 
+										__out DWORD * pcPackets );
 extern "C"  DWORD SNIPartialReadAsync( __out_opt SNI_Conn * pConn,
 							    __in SNI_Packet * pPacket, 
 							    DWORD cbBytesToRead,
@@ -672,9 +747,14 @@ extern "C"  DWORD SNISecRemoveSpn();
 
 extern "C" __success(ERROR_SUCCESS == return) DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 							__deref_out SNI_Conn ** ppConn);
+extern "C" DWORD SNIOpenSyncExMultiple( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
+							__out_ecount(cConns) SNI_Conn ** rgpConns,
+							DWORD cConns,
+							__out DWORD * pcOpened);
 
 extern "C" HANDLE SNIServerEnumOpen( LPWSTR pwszServer, BOOL fExtendedInfo);
 extern "C" HANDLE SNIServerEnumOpenEx( LPWSTR pwszServer, BOOL fExtendedInfo, DWORD waittime_least, DWORD waittimeout);
+extern "C" HANDLE SNIServerEnumOpenStreaming( LPWSTR pwszServer, BOOL fExtendedInfo, DWORD dwTotalTimeout);
 extern "C" __success(return > 0) int SNIServerEnumRead(__in HANDLE handle, __out_ecount_part(cBuf, return)  LPWSTR pwBuf, __in int cBuf, __out BOOL *pfMore);
 extern "C" __success(return > 0) int SNIServerEnumReadEx(__in HANDLE handle, __out_ecount_part(cBuf, return)  LPWSTR pwBuf, __in int cBuf, __out BOOL *pfMore, __in int timeout);
 extern "C" void SNIServerEnumClose(__inout_opt HANDLE handle);
@@ -145,11 +145,106 @@ typedef SOS_Task::Func WaitThreadRoutine;
 // See viahelper.cpp for BID_METATEXT definition of BIDX_APIGROUP_VIA_DESC
 //
 #define BIDX_APIGROUP_VIA_DESC		0x00002000	
+// See sni.cpp for BID_METATEXT definitions of the scope sampling and 
+// scope statistics bits; both only affect the BidxScopeAutoSNI scopes.  
+//
+#define BIDX_APIGROUP_SNI_SCOPE_SAMPLE	0x00004000
+#define BIDX_APIGROUP_SNI_SCOPE_STATS	0x00008000
 
 
 #define SNI_BID_TRACE_ON 	BidAreOn( BID_APIGROUP_TRACE | BIDX_APIGROUP_SNI )
 #define SNI_BID_SCOPE_ON    BidAreOn( BID_APIGROUP_SCOPE | BIDX_APIGROUP_SNI )
 
+// Per-packet code (packet allocation and release, SMUX session lookup, 
+// TCP read completion, SSL decryption) traces through the _HOTPATH_ 
+// flavors below.  Building with SNI_NO_HOTPATH_BID compiles those traces 
+// out entirely; otherwise they are the same as the regular ones.  
+//
+#ifdef SNI_NO_HOTPATH_BID
+#define SNI_BID_HOTPATH_TRACE_ON	(0)
+#else
+#define SNI_BID_HOTPATH_TRACE_ON	SNI_BID_TRACE_ON
+#endif
+
+//
+//	Every BidxScopeAutoSNI scope has a static SNI_SCOPE_SITE.  With the 
+//	BIDX_APIGROUP_SNI_SCOPE_SAMPLE bit on, only the scopes picked by 
+//	SNIScopeSample() are traced: 1 in N calls per site, and at most M per 
+//	second overall (see SNISetScopeSampling).  With the 
+//	BIDX_APIGROUP_SNI_SCOPE_STATS bit on, each site counts its calls and 
+//	their total duration, whether or not the scope is traced; 
+//	SNIDumpScopeStats() traces the totals.  
+//
+#if defined( __cplusplus )
+
+	struct SNI_SCOPE_SITE
+	{
+		LPCVOID					pvStf;			// scope format string; names the site
+		BOOL					fWide;
+		volatile LONG			cSampleTick;
+		volatile LONG			cCalls;
+		volatile LONGLONG		llTicks;		// QueryPerformanceCounter units
+		SNI_SCOPE_SITE * volatile pNext;		// in the list walked by SNIDumpScopeStats
+		volatile LONG			fListed;
+	};
+
+	#define SNI_SCOPE_SITE_INIT(stf, fWide)		{ (LPCVOID)(stf), fWide, 0, 0, 0, NULL, 0 }
+
+	BOOL SNIScopeSample( SNI_SCOPE_SITE * pSite );
+	void SNIScopeRecord( SNI_SCOPE_SITE * pSite, const LARGE_INTEGER * pliStart );
+
+	#define SNI_BID_SCOPE_AUTO_ON	\
+		( SNI_BID_SCOPE_ON && ( !_bidT( BIDX_APIGROUP_SNI_SCOPE_SAMPLE ) || SNIScopeSample( &_sniSite ) ) )
+
+//
+//	Scope anchor for the BidxScopeAutoSNI macros.  Unlike _bidCAutoScopeAnchor, 
+//	whose destructor is an out-of-line call to Out(), the "scope not entered" 
+//	case is checked inline, so that leaving a scope with tracing off costs a 
+//	compare rather than a call.  
+//
+	struct _sniCAutoScopeAnchor
+	{
+		_sniCAutoScopeAnchor( SNI_SCOPE_SITE * pSite )
+		{
+			m_hScp = BID_NOHANDLE;
+			m_pSite = NULL;
+			if( _bidT( BIDX_APIGROUP_SNI_SCOPE_STATS ) )
+			{
+				m_pSite = pSite;
+				QueryPerformanceCounter( &m_liStart );
+			}
+		}
+		~_sniCAutoScopeAnchor()
+		{
+			if( BID_NOHANDLE != m_hScp )
+			{
+				if( !_bidScpON )
+				{
+					m_hScp = BID_NOHANDLE;
+				}
+				else if( !xBidScopeLeave_( &m_hScp ) )
+				{
+					DBREAK();
+				}
+			}
+			if( NULL != m_pSite )
+			{
+				SNIScopeRecord( m_pSite, &m_liStart );
+			}
+		}
+		HANDLE* operator &()		{ return &m_hScp; }
+
+	 private:
+		HANDLE			m_hScp;
+		SNI_SCOPE_SITE *	m_pSite;
+		LARGE_INTEGER	m_liStart;
+	};
+
+	#define _sniCTA_(stf, fWide) \
+		static SNI_SCOPE_SITE _sniSite = SNI_SCOPE_SITE_INIT( stf, fWide ); _sniCAutoScopeAnchor _bidScp( &_sniSite )
+
+#endif
+
 
 //
 //	UPDATE NOTE:
@@ -182,29 +277,29 @@ typedef SOS_Task::Func WaitThreadRoutine;
 #define	BidxScopeEnterSNI9W(stf,a,b,c,d,e,f,g,h,i)		_bidCT;	_bid_C9(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f,g,h,i)
 #define	BidxScopeEnterSNI10W(stf,a,b,c,d,e,f,g,h,i,j)	_bidCT;	_bid_C10(W,SNI_BID_SCOPE_ON,&_bidScp,stf, a,b,c,d,e,f,g,h,i,j)  
 
-#define	BidxScopeAutoSNI0A(stf)							_bidCTA; _bid_C0(A,SNI_BID_SCOPE_ON,&_bidScp,stf)
-#define	BidxScopeAutoSNI1A(stf,a)						_bidCTA; _bid_C1(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a)
-#define	BidxScopeAutoSNI2A(stf,a,b)						_bidCTA; _bid_C2(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b)
-#define	BidxScopeAutoSNI3A(stf,a,b,c)					_bidCTA; _bid_C3(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c)
-#define	BidxScopeAutoSNI4A(stf,a,b,c,d)					_bidCTA; _bid_C4(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d)
-#define	BidxScopeAutoSNI5A(stf,a,b,c,d,e)				_bidCTA; _bid_C5(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e)
-#define	BidxScopeAutoSNI6A(stf,a,b,c,d,e,f)				_bidCTA; _bid_C6(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f)
-#define	BidxScopeAutoSNI7A(stf,a,b,c,d,e,f,g)			_bidCTA; _bid_C7(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f,g)
-#define	BidxScopeAutoSNI8A(stf,a,b,c,d,e,f,g,h)			_bidCTA; _bid_C8(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f,g,h)
-#define	BidxScopeAutoSNI9A(stf,a,b,c,d,e,f,g,h,i)		_bidCTA; _bid_C9(A,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f,g,h,i)
-#define	BidxScopeAutoSNI10A(stf,a,b,c,d,e,f,g,h,i,j)	_bidCTA;	_bid_C10(A,SNI_BID_SCOPE_ON,&_bidScp,stf, a,b,c,d,e,f,g,h,i,j)  
-
-#define	BidxScopeAutoSNI0W(stf)							_bidCTA; _bid_C0(W,SNI_BID_SCOPE_ON,&_bidScp,stf)
-#define	BidxScopeAutoSNI1W(stf,a)						_bidCTA; _bid_C1(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a)
-#define	BidxScopeAutoSNI2W(stf,a,b)						_bidCTA; _bid_C2(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b)
-#define	BidxScopeAutoSNI3W(stf,a,b,c)					_bidCTA; _bid_C3(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c)
-#define	BidxScopeAutoSNI4W(stf,a,b,c,d)					_bidCTA; _bid_C4(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d)
-#define	BidxScopeAutoSNI5W(stf,a,b,c,d,e)				_bidCTA; _bid_C5(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e)
-#define	BidxScopeAutoSNI6W(stf,a,b,c,d,e,f)				_bidCTA; _bid_C6(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f)
-#define	BidxScopeAutoSNI7W(stf,a,b,c,d,e,f,g)			_bidCTA; _bid_C7(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f,g)
-#define	BidxScopeAutoSNI8W(stf,a,b,c,d,e,f,g,h)			_bidCTA; _bid_C8(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f,g,h)
-#define	BidxScopeAutoSNI9W(stf,a,b,c,d,e,f,g,h,i)		_bidCTA; _bid_C9(W,SNI_BID_SCOPE_ON,&_bidScp,stf,a,b,c,d,e,f,g,h,i)
-#define	BidxScopeAutoSNI10W(stf,a,b,c,d,e,f,g,h,i,j)	_bidCTA;	_bid_C10(W,SNI_BID_SCOPE_ON,&_bidScp,stf, a,b,c,d,e,f,g,h,i,j)  
+#define	BidxScopeAutoSNI0A(stf)							_sniCTA_(stf, FALSE); _bid_C0(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf)
+#define	BidxScopeAutoSNI1A(stf,a)						_sniCTA_(stf, FALSE); _bid_C1(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a)
+#define	BidxScopeAutoSNI2A(stf,a,b)						_sniCTA_(stf, FALSE); _bid_C2(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b)
+#define	BidxScopeAutoSNI3A(stf,a,b,c)					_sniCTA_(stf, FALSE); _bid_C3(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c)
+#define	BidxScopeAutoSNI4A(stf,a,b,c,d)					_sniCTA_(stf, FALSE); _bid_C4(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d)
+#define	BidxScopeAutoSNI5A(stf,a,b,c,d,e)				_sniCTA_(stf, FALSE); _bid_C5(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e)
+#define	BidxScopeAutoSNI6A(stf,a,b,c,d,e,f)				_sniCTA_(stf, FALSE); _bid_C6(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f)
+#define	BidxScopeAutoSNI7A(stf,a,b,c,d,e,f,g)			_sniCTA_(stf, FALSE); _bid_C7(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f,g)
+#define	BidxScopeAutoSNI8A(stf,a,b,c,d,e,f,g,h)			_sniCTA_(stf, FALSE); _bid_C8(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f,g,h)
+#define	BidxScopeAutoSNI9A(stf,a,b,c,d,e,f,g,h,i)		_sniCTA_(stf, FALSE); _bid_C9(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f,g,h,i)
+#define	BidxScopeAutoSNI10A(stf,a,b,c,d,e,f,g,h,i,j)	_sniCTA_(stf, FALSE);	_bid_C10(A,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf, a,b,c,d,e,f,g,h,i,j)  
+
+#define	BidxScopeAutoSNI0W(stf)							_sniCTA_(stf, TRUE); _bid_C0(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf)
+#define	BidxScopeAutoSNI1W(stf,a)						_sniCTA_(stf, TRUE); _bid_C1(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a)
+#define	BidxScopeAutoSNI2W(stf,a,b)						_sniCTA_(stf, TRUE); _bid_C2(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b)
+#define	BidxScopeAutoSNI3W(stf,a,b,c)					_sniCTA_(stf, TRUE); _bid_C3(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c)
+#define	BidxScopeAutoSNI4W(stf,a,b,c,d)					_sniCTA_(stf, TRUE); _bid_C4(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d)
+#define	BidxScopeAutoSNI5W(stf,a,b,c,d,e)				_sniCTA_(stf, TRUE); _bid_C5(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e)
+#define	BidxScopeAutoSNI6W(stf,a,b,c,d,e,f)				_sniCTA_(stf, TRUE); _bid_C6(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f)
+#define	BidxScopeAutoSNI7W(stf,a,b,c,d,e,f,g)			_sniCTA_(stf, TRUE); _bid_C7(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f,g)
+#define	BidxScopeAutoSNI8W(stf,a,b,c,d,e,f,g,h)			_sniCTA_(stf, TRUE); _bid_C8(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f,g,h)
+#define	BidxScopeAutoSNI9W(stf,a,b,c,d,e,f,g,h,i)		_sniCTA_(stf, TRUE); _bid_C9(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf,a,b,c,d,e,f,g,h,i)
+#define	BidxScopeAutoSNI10W(stf,a,b,c,d,e,f,g,h,i,j)	_sniCTA_(stf, TRUE);	_bid_C10(W,SNI_BID_SCOPE_AUTO_ON,&_bidScp,stf, a,b,c,d,e,f,g,h,i,j)  
 
 #if	defined( _UNICODE )
 	#define	BidxScopeEnterSNI0		BidxScopeEnterSNI0W
@@ -257,6 +352,22 @@ typedef SOS_Task::Func WaitThreadRoutine;
 #endif
 
 
+#ifdef SNI_NO_HOTPATH_BID
+	#define	BidxScopeAutoSNIHotPath0(stf)
+	#define	BidxScopeAutoSNIHotPath1(stf,a)
+	#define	BidxScopeAutoSNIHotPath2(stf,a,b)
+	#define	BidxScopeAutoSNIHotPath3(stf,a,b,c)
+	#define	BidxScopeAutoSNIHotPath4(stf,a,b,c,d)
+	#define	BidxScopeAutoSNIHotPath5(stf,a,b,c,d,e)
+#else
+	#define	BidxScopeAutoSNIHotPath0	BidxScopeAutoSNI0
+	#define	BidxScopeAutoSNIHotPath1	BidxScopeAutoSNI1
+	#define	BidxScopeAutoSNIHotPath2	BidxScopeAutoSNI2
+	#define	BidxScopeAutoSNIHotPath3	BidxScopeAutoSNI3
+	#define	BidxScopeAutoSNIHotPath4	BidxScopeAutoSNI4
+	#define	BidxScopeAutoSNIHotPath5	BidxScopeAutoSNI5
+#endif
+
 #define ASSERT_CONNECTION_ON_CORRECT_NODE(pConn) \
 	Assert( pConn->m_NodeId == SOS_Node::GetCurrent()->GetNodeId())
 	
@@ -765,11 +876,15 @@ typedef struct
 { 
 	ULONG  SentPackets; 
 	ULONG  RecdPackets; 
+	ULONGLONG SentBytes;
+	ULONGLONG RecdBytes;
+	ULONG  PartialReads;
 	ULONG  ConsBufferSize; 
 	ULONG  ProvBufferSize;
 	ULONG  ProvOffset;
 	ProviderNum TransportProvider;
 	SNITime Timer;
+	SNI_OPEN_TIMINGS OpenTimings;
 } SNI_CONN_INFO, *PSNI_CONN_INFO; 
 
 //----------------------------------------------------------------------------
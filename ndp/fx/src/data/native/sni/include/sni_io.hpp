@@ -237,6 +237,9 @@ private:
 
 #ifdef SNI_BASED_CLIENT 
 		InitializeSListHead(&m_SListHeader);
+		m_rgMagazines = NULL;
+		m_cMagazines = 0;
+		m_cMagazineSize = 0;
 #else
 		m_pSOSPacketCache = NULL;
 		m_pPacketPmo = NULL;
@@ -251,14 +254,103 @@ private:
 	
 #ifdef SNI_BASED_CLIENT 
 
+	#define MAX_PACKET_MAGAZINE_SIZE		32
+	#define DEFAULT_PACKET_MAGAZINE_SIZE	8
+	#define MAX_PACKET_MAGAZINES			64
+
+	// Per-processor cache of packets in front of m_SListHeader, so that most
+	// allocations and releases don't touch the shared SList head.  A magazine
+	// is only used while m_lBusy is held; a thread that finds it busy (another
+	// thread on the same processor, or one that just migrated) goes straight
+	// to the SList instead of waiting.
+	struct PacketMagazine
+	{
+		volatile LONG	m_lBusy;
+		DWORD			m_cPackets;
+		ULONGLONG		m_cHits;		// Pops served from the magazine
+		ULONGLONG		m_cMisses;		// Pops that had to go to the SList
+		ULONGLONG		m_cOverflows;	// Pushes that found the magazine full
+		SNI_Packet *	m_rgPackets[MAX_PACKET_MAGAZINE_SIZE];
+	};
+
+	// Rounds each magazine up to a multiple of the cache line size so that
+	// neighbouring processors don't share a line
+	union PacketMagazineSlot
+	{
+		PacketMagazine	m_Magazine;
+		BYTE			m_rgbAlign[(sizeof(PacketMagazine) + 63) & ~63];
+	};
+
+	typedef DWORD (WINAPI * PFNGETCURRENTPROCESSORNUMBER)( VOID );
+
 	SLIST_HEADER m_SListHeader;
+	PacketMagazineSlot * m_rgMagazines;
+	DWORD m_cMagazines;
+	DWORD m_cMagazineSize;
+
+	static PFNGETCURRENTPROCESSORNUMBER s_pfnGetCurrentProcessorNumber;
 
 	DWORD FInit(MemTagTypes eMemTag)
 	{
 		InitTag(eMemTag);
+
+		m_cMagazineSize = s_rgcMagazineSize[eMemTag];
+
+		if( 0 == m_cMagazineSize )
+			return ERROR_SUCCESS;
+
+		SYSTEM_INFO si;
+
+		GetSystemInfo( &si );
+
+		m_cMagazines = si.dwNumberOfProcessors;
+
+		if( 0 == m_cMagazines )
+			m_cMagazines = 1;
+		else if( MAX_PACKET_MAGAZINES < m_cMagazines )
+			m_cMagazines = MAX_PACKET_MAGAZINES;
+
+		m_rgMagazines = NewNoX(gpmo) PacketMagazineSlot[m_cMagazines];
+
+		if( NULL == m_rgMagazines )
+			return ERROR_OUTOFMEMORY;
+
+		ZeroMemory( m_rgMagazines, m_cMagazines * sizeof(PacketMagazineSlot) );
+		
 		return ERROR_SUCCESS;
 	}
 
+	// Returns the current processor's magazine with m_lBusy held, or NULL 
+	// if magazines are disabled or the magazine is in use
+	PacketMagazine * AcquireMagazine()
+	{
+		if( NULL == m_rgMagazines )
+			return NULL;
+
+		DWORD dwIndex = s_pfnGetCurrentProcessorNumber ? s_pfnGetCurrentProcessorNumber() 
+													   : GetCurrentThreadId() >> 2;
+
+		PacketMagazine * pMagazine = &m_rgMagazines[dwIndex % m_cMagazines].m_Magazine;
+
+		if( 0 != InterlockedCompareExchange( &pMagazine->m_lBusy, 1, 0 ) )
+			return NULL;
+
+		return pMagazine;
+	}
+
+	// Waits for the magazine - only for Flush and statistics, never on the
+	// allocation path
+	static void WaitForMagazine( PacketMagazine * pMagazine )
+	{
+		while( 0 != InterlockedCompareExchange( &pMagazine->m_lBusy, 1, 0 ) )
+			SwitchToThread();
+	}
+
+	static void ReleaseMagazine( PacketMagazine * pMagazine )
+	{
+		InterlockedExchange( &pMagazine->m_lBusy, 0 );
+	}
+
 #else
 
 	SOS_ObjectStore	* m_pSOSPacketCache;
@@ -328,13 +420,122 @@ public:
 #ifdef SNI_BASED_CLIENT 
 
 	static SNIMemRegion * s_rgClientMemRegion;
+	static DWORD s_rgcMagazineSize[MAX_MEM_TAGS];
 
 	~SNIMemRegion()
 	{
 		InterlockedFlushSList(&m_SListHeader);
+
+		// Flush has already emptied the magazines
+		delete [] m_rgMagazines;
 	}
 
 	SNI_Packet * Pop()
+	{
+		PacketMagazine * pMagazine = AcquireMagazine();
+
+		if( NULL == pMagazine )
+			return PopShared();
+
+		SNI_Packet * pPacket;
+
+		if( 0 != pMagazine->m_cPackets )
+		{
+			pMagazine->m_cHits++;
+			pPacket = pMagazine->m_rgPackets[--pMagazine->m_cPackets];
+		}
+		else
+		{
+			pMagazine->m_cMisses++;
+			pPacket = PopShared();
+
+			// Refill half the magazine in one go, so the next few allocations on
+			// this processor stay local
+			if( NULL != pPacket )
+			{
+				SNI_Packet * pRefill;
+
+				while( pMagazine->m_cPackets < m_cMagazineSize / 2 &&
+					   NULL != (pRefill = PopShared()) )
+				{
+					pMagazine->m_rgPackets[pMagazine->m_cPackets++] = pRefill;
+				}
+			}
+		}
+
+		ReleaseMagazine( pMagazine );
+
+		return pPacket;
+	}
+
+	void Push( __out_opt SNI_Packet *pPacket)
+	{
+		PacketMagazine * pMagazine = AcquireMagazine();
+
+		if( NULL == pMagazine )
+		{
+			PushShared( pPacket );
+			return;
+		}
+
+		if( pMagazine->m_cPackets == m_cMagazineSize )
+		{
+			// Hand half the magazine back to the SList in one go
+			pMagazine->m_cOverflows++;
+
+			while( pMagazine->m_cPackets > m_cMagazineSize / 2 )
+			{
+				PushShared( pMagazine->m_rgPackets[--pMagazine->m_cPackets] );
+			}
+		}
+
+		pMagazine->m_rgPackets[pMagazine->m_cPackets++] = pPacket;
+
+		ReleaseMagazine( pMagazine );
+	}
+
+	void FlushMagazines()
+	{
+		for( DWORD i = 0; i < m_cMagazines; i++ )
+		{
+			PacketMagazine * pMagazine = &m_rgMagazines[i].m_Magazine;
+
+			WaitForMagazine( pMagazine );
+
+			while( 0 != pMagazine->m_cPackets )
+			{
+				SNIPacketDelete( pMagazine->m_rgPackets[--pMagazine->m_cPackets] );
+			}
+
+			ReleaseMagazine( pMagazine );
+		}
+	}
+
+	void GetMagazineStats( __out SNI_PACKET_CACHE_STATS * pStats )
+	{
+		pStats->cMagazines = m_cMagazines;
+		pStats->cMagazineSize = m_cMagazineSize;
+		pStats->cHits = 0;
+		pStats->cMisses = 0;
+		pStats->cOverflows = 0;
+
+		for( DWORD i = 0; i < m_cMagazines; i++ )
+		{
+			PacketMagazine * pMagazine = &m_rgMagazines[i].m_Magazine;
+
+			WaitForMagazine( pMagazine );
+
+			pStats->cHits += pMagazine->m_cHits;
+			pStats->cMisses += pMagazine->m_cMisses;
+			pStats->cOverflows += pMagazine->m_cOverflows;
+
+			ReleaseMagazine( pMagazine );
+		}
+	}
+
+private:
+
+	SNI_Packet * PopShared()
 	{
 		SOS_ObjectStoreDescriptor *pDescriptor;
 
@@ -346,7 +547,7 @@ public:
 			return SNIPacketContainingDescriptor(pDescriptor);
 	}
 
-	void Push( __out_opt SNI_Packet *pPacket)
+	void PushShared( __out_opt SNI_Packet *pPacket)
 	{
 		if( QueryDepthSList(&m_SListHeader) < MAX_PACKET_CACHE_SIZE - 1 )
 		{
@@ -368,6 +569,8 @@ public:
 		}
 	}
 
+public:
+
 #else		
 
 	~SNIMemRegion()
@@ -424,6 +627,16 @@ public:
 
 		SNIMemRegion * rgMemRegion;
 
+#ifdef SNI_BASED_CLIENT
+		WIN2K3_DEPENDENCY("Call GetCurrentProcessorNumber directly")
+		HMODULE hKernel32 = GetModuleHandleW( L"kernel32.dll" );
+
+		if( hKernel32 )
+		{
+			s_pfnGetCurrentProcessorNumber = (PFNGETCURRENTPROCESSORNUMBER) GetProcAddress( hKernel32, "GetCurrentProcessorNumber" );
+		}
+#endif
+
 		rgMemRegion= NewNoX(gpmo) SNIMemRegion[MAX_MEM_TAGS];
 		
 		if(NULL == rgMemRegion)
@@ -455,6 +668,10 @@ public:
 			// Free all the packets in this memory region's cache
 			SNI_Packet * pPacket;
 
+#ifdef SNI_BASED_CLIENT
+			rgMemRegion[i].FlushMagazines();
+#endif
+
 			while( NULL != (pPacket = (SNI_Packet *) rgMemRegion[i].Pop()) )
 			{
 				SNIPacketDelete(pPacket);
@@ -702,7 +919,7 @@ public:
 										  SNI_Packet_IOType IOType,
 										  ConsumerNum ConsNum)
 	{
-		BidTraceU3( SNI_BID_TRACE_ON, SNIAPI_TAG _T( "pConn: %p{SNI_Conn*}, IOType: %d, consumer: %d\n"), pConn, IOType, ConsNum);
+		BidTraceU3( SNI_BID_HOTPATH_TRACE_ON, SNIAPI_TAG _T( "pConn: %p{SNI_Conn*}, IOType: %d, consumer: %d\n"), pConn, IOType, ConsNum);
 
 		Assert( IOType < SNI_Packet_InvalidType );
 		Assert( ConsNum < SNI_Consumer_Invalid );
@@ -804,7 +1021,7 @@ public:
 			Assert(0==pPacket->m_cRef);
 			pPacket->m_cRef = 1;
 
-			BidTraceU2( SNI_BID_TRACE_ON, SNI_TAG 
+			BidTraceU2( SNI_BID_HOTPATH_TRACE_ON, SNI_TAG 
 				_T("%u#{SNI_Packet} from pool for %u#{SNI_Conn}\n"), 
 				SNIPacketGetBidId(pPacket), 
 				pConn->GetBidId() );
@@ -838,7 +1055,7 @@ public:
 
 	ret:
 
-		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), pPacket);
+		BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), pPacket);
 		
 		return (SNI_Packet *)pPacket;
 	}
@@ -862,7 +1079,7 @@ public:
 								    				SNI_Packet_IOType IOType,
 								   					SOS_IOCompRoutine pfunComp)
 	{
-		BidTraceU3( SNI_BID_TRACE_ON, SNIAPI_TAG _T( "pConn: %p{SNI_Conn*}, IOType: %d, SOS_IOCompRoutine: %p{SOS_IOCompRoutine}\n"), 
+		BidTraceU3( SNI_BID_HOTPATH_TRACE_ON, SNIAPI_TAG _T( "pConn: %p{SNI_Conn*}, IOType: %d, SOS_IOCompRoutine: %p{SOS_IOCompRoutine}\n"), 
 						pConn, IOType, pfunComp);
 		
 		Assert(	IOType < SNI_Packet_InvalidType );
@@ -872,7 +1089,7 @@ public:
 		if (pPacket)
 			pPacket->Init(0, 0, pfunComp, pPacket, FALSE);
 
-		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), pPacket);
+		BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), pPacket);
 		
 		return pPacket;
 	}
@@ -889,7 +1106,7 @@ public:
 									  SOS_IOCompRoutine* IOCompRoutine,
 									  ConsumerNum ConsNum )
 	{
-		BidTraceU2( SNI_BID_TRACE_ON, SNIAPI_TAG _T( "pConn: %p{SNI_Conn*}, IOType: %d\n"), pConn, IOType);
+		BidTraceU2( SNI_BID_HOTPATH_TRACE_ON, SNIAPI_TAG _T( "pConn: %p{SNI_Conn*}, IOType: %d\n"), pConn, IOType);
 
 		DWORD dwError = ERROR_SUCCESS;
 
@@ -948,7 +1165,7 @@ public:
 			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_SYSTEM, dwError );
 		}
 
-		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), pPacket);
+		BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), pPacket);
 		
 		return (SNI_Packet *)pPacket;
 	}
@@ -982,7 +1199,7 @@ public:
 	// released when the ref count drops to zero.
 	friend void SNIPacketAddRef(SNI_Packet * pPacket)
 	{
-		BidTraceU2( SNI_BID_TRACE_ON, SNIAPI_TAG _T("%u#{SNI_Packet}, ")
+		BidTraceU2( SNI_BID_HOTPATH_TRACE_ON, SNIAPI_TAG _T("%u#{SNI_Packet}, ")
 												 _T("pPacket: %p{SNI_Packet*}\n"), 
 												 SNIPacketGetBidId(pPacket), 
 												 pPacket);
@@ -994,7 +1211,7 @@ public:
 
 	friend void SNIPacketRelease(SNI_Packet * pPacket)
 	{	
-		BidTraceU2( SNI_BID_TRACE_ON, SNIAPI_TAG _T("%u#{SNI_Packet}, ")
+		BidTraceU2( SNI_BID_HOTPATH_TRACE_ON, SNIAPI_TAG _T("%u#{SNI_Packet}, ")
 												 _T("pPacket: %p{SNI_Packet*}\n"), 
 												 SNIPacketGetBidId(pPacket), 
 												 pPacket);
@@ -1014,7 +1231,7 @@ public:
 		// Only release the packet if it's ref count drops to zero.
 		if ( 0 != InterlockedDecrement( &pPacket->m_cRef ) ) 
 		{
-			BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG 
+			BidTraceU2( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG 
 				_T("%u#!{SNI_Packet}: ")
 				_T("Not final release.  ")
 				_T("pPacket: %p{SNI_Packet*}\n"), 
@@ -1082,7 +1299,7 @@ public:
 
 		pPacket->m_ConsBuf = SNI_Consumer_PacketIsReleased;
 
-		BidTraceU1( SNI_BID_TRACE_ON, SNI_TAG 
+		BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, SNI_TAG 
 			_T("%u#{SNI_Packet} to pool\n"), 
 			SNIPacketGetBidId(pPacket) );
 
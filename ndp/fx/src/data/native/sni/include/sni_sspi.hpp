@@ -38,6 +38,7 @@ class SNI_Sec
 		BOOL		m_fCtxt;
 		SecPkg		m_PkgId;
 		CredHandle	m_hCred;
+		BOOL		m_fSharedCred;	// m_hCred came from the credential cache
 		SecPkgContext_NegotiationInfo* m_pPkgInfo;
 		DWORD		m_dwLastError;  //Cache the error from SetPkgName so that GetSecPkgName can use  it.
 
@@ -205,6 +205,14 @@ private:
 
 	static bool				s_fChannelBindingsSupported;
 
+	// Completed handshakes by duration: bucket i counts handshakes that 
+	// took less than 2^(i+1) ms, the last bucket all the slower ones
+	#define SSL_HANDSHAKE_LATENCY_BUCKETS	10
+	static LONG				s_rgcHandshakeLatency[SSL_HANDSHAKE_LATENCY_BUCKETS];
+	static LONG				s_cHandshakesResumed;
+
+	DWORD		m_dwHandshakeStart;
+
 	BYTE *		m_pWriteBuffer;
 	DWORD 		m_iWriteOffset;
 	DWORD 		m_cWriteBuffer;
@@ -225,6 +233,12 @@ private:
 
 	BOOL		m_fConnBufSizeIncremented;
 
+	// Plaintext bytes delivered, and left-over ciphertext copied into new
+	// packets by Decrypt and CopyPacket; traced when the provider goes away
+	ULONGLONG	m_cbDecrypted;
+	ULONGLONG	m_cbLeftOverCopied;
+	DWORD		m_cLeftOverCopies;
+
 	// Internal helpers
 	static DWORD FindAndLoadCertificate( __in HCERTSTORE  hMyCertStore, 
 										 __in BOOL fHash, 
@@ -240,6 +254,8 @@ private:
 
 	DWORD SetChannelBindings();
 
+	void RecordHandshakeLatency();
+
 	virtual DWORD AdjustProtocolFields();
 	void IncConnBufSize();
 	DWORD CopyPacket( __inout SNI_Packet * pLeftOver, __deref_out SNI_Packet ** ppNewPacket, __in_opt LPVOID pPacketKey, SNI_Packet_IOType ioType ); 
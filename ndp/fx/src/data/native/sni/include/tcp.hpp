@@ -116,6 +116,13 @@ private:
 	SNICritSec *m_CSTuning;
 	LPWSAOVERLAPPED m_pOvSendNotificaiton;
 	BOOL m_fAuto;
+
+	// Read completion state that lets CheckConnection skip WSAPoll.  
+	// Written by the read paths, read by CheckConnection on the 
+	// consumer's thread.
+	//
+	volatile LONG	m_lReadError; 
+	volatile DWORD	m_dwLastReadTick; 
 	
 public:
 	Tcp(SNI_Conn * pConn);
@@ -136,7 +143,7 @@ public:
 	
 	DWORD LoadConnectEx(__in CONNECTEXFUNC** pfnCF);	
 	DWORD SocketOpenSync(__in ADDRINFOW* AIW, int timeout);
-	DWORD SocketOpenParallel(__in const ADDRINFOW *AIW, DWORD timeout);
+	DWORD SocketOpenParallel(__in const ADDRINFOW *AIW, DWORD timeout, DWORD dwStaggerDelay);
 	DWORD CheckConnection( );
 	DWORD ReadSync(__out SNI_Packet ** ppNewPacket, int timeout);
 	DWORD ReadAsync(__out SNI_Packet ** ppNewPacket, LPVOID pPacketKey);
@@ -157,6 +164,7 @@ public:
 	static DWORD GetLocalPort(__in SNI_Conn * pConn, __out USHORT * port);
 	static DWORD GetDnsName( WCHAR *wszAddress, __out_ecount(len) WCHAR *wszDnsName, int len);
 	static BOOL FIsLoopBack(const WCHAR* pwszServer);
+	static void AddrCacheFlush();
 
 	DWORD SetKeepAliveOption();
 	inline void SetSockBufAutoTuning(BOOL* pfAuto){ Assert (pfAuto); m_fAuto = (*pfAuto == TRUE && s_fAutoTuning ==TRUE); }
@@ -185,13 +193,14 @@ private:
 	void PrepareForAsyncCall(SNI_Packet *pPacket);
 	
 	DWORD PostReadAsync(SNI_Packet *pPacket, DWORD cbBuffer);
+	void RecordReadCompletion(DWORD dwBytes, DWORD dwError);
 	static Tcp * AcceptConnection( SNI_Conn *pConn, SOCKET AcceptSocket, char * szAddressBuffer);
 
 	static bool IsNumericAddress( LPWSTR name);
 
 	DWORD Tcp::FInit(); 
 
-	DWORD ParallelOpen(__in ADDRINFOW *AddrInfoW, int timeout, DWORD dwStartTickCount);
+	DWORD ParallelOpen(__in ADDRINFOW *AddrInfoW, int timeout, DWORD dwStartTickCount, DWORD dwStaggerDelay);
 	
 	__inline  DWORD CheckAndAdjustSendBufferSizeBasedOnISB();
 	
@@ -206,6 +215,15 @@ private:
 
 	static DWORD ShouldEnableSkipIOCompletion(__out BOOL* pfShouldEnable);
 	static UINT GetAddrCount(const ADDRINFOW *AIW);
+
+	// Name resolution and address cache used by Tcp::Open
+	static DWORD ResolveAddress(__in LPCWSTR wszServer, __in LPCWSTR wszPort, int timeout, DWORD dwStart, __out ADDRINFOW ** ppAddrInfo);
+	static DWORD GetAddrInfoTimed(__in LPCWSTR wszServer, __in LPCWSTR wszPort, __in const ADDRINFOW * pHints, int timeout, DWORD dwStart, __out ADDRINFOW ** ppAddrInfo);
+	static void FreeResolvedAddrInfo(__in_opt ADDRINFOW * pAddrInfo);
+	static BOOL AddrCacheLookup(__in LPCWSTR wszServer, __in LPCWSTR wszPort, __out DWORD * pdwError, __out ADDRINFOW ** ppAddrInfo);
+	static void AddrCacheInsert(__in LPCWSTR wszServer, __in LPCWSTR wszPort, DWORD dwError, __in_opt const ADDRINFOW * pAddrInfo);
+	static void AddrCacheRemove(__in LPCWSTR wszServer, __in LPCWSTR wszPort);
+	static void AddrCachePromote(__in LPCWSTR wszServer, __in LPCWSTR wszPort, __in const sockaddr * pAddr);
 };
 
 #endif
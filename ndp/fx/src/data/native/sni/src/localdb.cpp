@@ -332,6 +332,31 @@ ErrorExit:
 			goto ErrorExit;
 		}
 
+		// LocalDBStartInstance has to talk to the instance (and start it if it
+		// is stopped), which is far more expensive than the connect itself.
+		// Remember the pipe name per instance and only go back to it when the
+		// cached pipe is gone or a connect through it failed.  The call is
+		// made under m_CS so that concurrent opens of a stopped instance wait
+		// for one start instead of each starting it.
+		//
+		{
+		CAutoSNICritSec a_cs( m_CS, SNI_AUTOCS_ENTER );
+
+		int iEntry = findCacheEntry(wszInstanceName);
+
+		if( -1 != iEntry )
+		{
+			if( fCachedPipeExists(m_rgCache[iEntry].wszConnect) &&
+				SUCCEEDED(StringCchCopyW(wszlocalDBConnect, *pcchLocalDBConnectBuf, m_rgCache[iEntry].wszConnect)) )
+			{
+				BidTraceU1( SNI_BID_TRACE_ON, SNI_TAG _T("LocalDB: using cached connection string \"%ls\"\n"), wszlocalDBConnect );
+				goto ErrorExit;
+			}
+
+			m_rgCache[iEntry].wszInstanceName[0] = L'\0';
+			m_rgCache[iEntry].wszConnect[0] = L'\0';
+		}
+
 		// Get the named pipe for the instance
 		//
 		HRESULT hr = m_pfnLocalDBStartInstance(wszInstanceName, 0, wszlocalDBConnect, pcchLocalDBConnectBuf);
@@ -341,7 +366,23 @@ ErrorExit:
 			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_LocalDB, hr );
 			BidTrace1(ERROR_TAG _T("LocalDB: LocalDBStartInstance failed. %d{WINERR}\n"), hr);
 			return hr;
-		}		
+		}
+
+		// Names that do not fit are simply not cached.
+		//
+		LocalDBCacheEntry * pEntry = &m_rgCache[m_iNextCacheEntry];
+
+		if( SUCCEEDED(StringCchCopyW(pEntry->wszInstanceName, ARRAYSIZE(pEntry->wszInstanceName), wszInstanceName)) &&
+			SUCCEEDED(StringCchCopyW(pEntry->wszConnect, ARRAYSIZE(pEntry->wszConnect), wszlocalDBConnect)) )
+		{
+			m_iNextCacheEntry = (m_iNextCacheEntry + 1) % LOCALDB_CACHE_SIZE;
+		}
+		else
+		{
+			pEntry->wszInstanceName[0] = L'\0';
+			pEntry->wszConnect[0] = L'\0';
+		}
+		}// end of critical section scope
 
 ErrorExit:		
 
@@ -349,6 +390,63 @@ ErrorExit:
 		return dwRet;
 	}
 
+	// Forgets the cached connection string of an instance, so that the next
+	// open goes through LocalDBStartInstance again.  Called when a connect
+	// using the string failed, e.g. because the instance was stopped.
+	//
+	void LocalDB::invalidateLocalDBConnectionString(__in LPCWSTR wszInstanceName)
+	{
+		BidxScopeAutoSNI1( SNIAPI_TAG _T("wszInstanceName: \"%ls{WCHAR*}\"\n"), wszInstanceName );
+
+		CAutoSNICritSec a_cs( m_CS, SNI_AUTOCS_ENTER );
+
+		int iEntry = findCacheEntry(wszInstanceName);
+
+		if( -1 != iEntry )
+		{
+			m_rgCache[iEntry].wszInstanceName[0] = L'\0';
+			m_rgCache[iEntry].wszConnect[0] = L'\0';
+		}
+	}
+
+	// Caller must hold m_CS.
+	//
+	int LocalDB::findCacheEntry(__in LPCWSTR wszInstanceName)
+	{
+		for( int i = 0; i < LOCALDB_CACHE_SIZE; i++ )
+		{
+			if( L'\0' != m_rgCache[i].wszInstanceName[0] &&
+				!_wcsicmp(m_rgCache[i].wszInstanceName, wszInstanceName) )
+			{
+				return i;
+			}
+		}
+
+		return -1;
+	}
+
+	// An instance that has shut down (LocalDB instances stop on their own 
+	// after being idle) removes its pipe, so a cached "np:" string is only
+	// trusted while the pipe still exists.  WaitNamedPipe does not consume a
+	// pipe instance; a busy pipe times out rather than failing with
+	// ERROR_FILE_NOT_FOUND.
+	//
+	bool LocalDB::fCachedPipeExists(__in LPCWSTR wszConnect)
+	{
+		if( _wcsnicmp(wszConnect, L"np:", 3) )
+		{
+			return true;
+		}
+
+		if( !WaitNamedPipeW(wszConnect + 3, NMPWAIT_NOWAIT) &&
+			ERROR_FILE_NOT_FOUND == GetLastError() )
+		{
+			BidTrace1( ERROR_TAG _T("LocalDB: cached pipe \"%ls\" no longer exists\n"), wszConnect );
+			return false;
+		}
+
+		return true;
+	}
 
 void LocalDB::Terminate()
 {
@@ -26,6 +26,12 @@ DWORD const CLOSEIOWAIT = 1000;	//	milliseconds
 // Global Variables
 extern BOOL			gfIsWin9x;
 
+// Largest pipe write WriteDone may build out of the packets queued behind 
+// a pending write (see Np::DeQueueCoalesced).  Zero, the default, writes 
+// them one at a time; see SNISetNpWriteCoalescing.  
+//
+static DWORD		g_cbNpWriteCoalesce = 0;
+
 // DeleteNpAcl
 //
 // This function delete the Security Descriptor created by CreateNpAcl()
@@ -496,6 +502,12 @@ Np::Np( SNI_Conn * pConn, ProviderNum protToReport ) : SNI_Provider( pConn )
 
 	m_fWritePending = false;
 
+	m_fCoalescedWrite = false;
+
+	m_pbWriteBuf = NULL;
+
+	m_cbWriteBuf = 0;
+
 	m_fClose = FALSE; 
 
 	m_dwcHandleRef = 0; 
@@ -522,6 +534,7 @@ Np::~Np()
 	if( m_CSClose != NULL )
 		DeleteCriticalSection( &m_CSClose );
 
+	delete [] m_pbWriteBuf;
 
 	Assert( !m_fWritePending );
 }
@@ -1907,6 +1920,10 @@ DWORD Np::SendPacketAsync( SNI_Packet *pPacket, DWORD *pdwBytesWritten )
 
 	BOOL         fReturnValue;
 
+	SNI_Packet * pTmp;
+
+	DWORD        cbTotal;
+
 	if( NULL != m_pSyncReadPacket )
 	{
 		Assert( 0 && "It is forbidden to call SNIReadAsync or SNIPartialReadAsync when there is a cached Sync Read packet.\n");
@@ -1915,6 +1932,54 @@ DWORD Np::SendPacketAsync( SNI_Packet *pPacket, DWORD *pdwBytesWritten )
 		goto Exit;
 	}
 
+	// WriteFileGather does not work on pipes, so a chain of packets is 
+	// copied into the bounce buffer and written as one pipe message.  
+	// Only the first packet's OVERLAPPED is used.  
+	//
+	if( NULL != SNIPacketGetNext( pPacket ) )
+	{
+		cbTotal = 0;
+
+		for( pTmp = pPacket; NULL != pTmp; pTmp = SNIPacketGetNext( pTmp ) )
+		{
+			cbTotal += SNIPacketGetBufferSize( pTmp );
+		}
+
+		if( cbTotal > m_cbWriteBuf )
+		{
+			delete [] m_pbWriteBuf;
+			m_cbWriteBuf = 0;
+
+			m_pbWriteBuf = NewNoX(gpmo) BYTE[cbTotal];
+
+			if( NULL == m_pbWriteBuf )
+			{
+				dwError = ERROR_OUTOFMEMORY;
+				SNI_SET_LAST_ERROR( m_ProtToReport, SNIE_4, dwError );
+				goto Exit;
+			}
+
+			m_cbWriteBuf = cbTotal;
+		}
+
+		cbTotal = 0;
+
+		for( pTmp = pPacket; NULL != pTmp; pTmp = SNIPacketGetNext( pTmp ) )
+		{
+			BYTE * pbData;
+			DWORD cbData;
+
+			SNIPacketGetData( pTmp, &pbData, &cbData );
+			memcpy( m_pbWriteBuf + cbTotal, pbData, cbData );
+			cbTotal += cbData;
+		}
+
+		pBuffer = m_pbWriteBuf;
+		dwBufferSize = cbTotal;
+
+		BidTraceU2( SNI_BID_TRACE_ON, SNI_TAG _T("%u#, chained write: %d bytes\n"), GetBidId(), dwBufferSize);
+	}
+
 	PrepareForAsyncCall(pPacket);
 
 	// additional AddRef around WriteFile call protects
@@ -2009,6 +2074,125 @@ DWORD Np::WriteAsync( SNI_Packet   * pPacket,
 	return dwRet;
 }
 
+// Same contract as Tcp::GatherWriteAsync: the chain is sent as a single 
+// write (here one pipe message, through the bounce buffer), and only the 
+// first packet gets a completion.  It is queued like any other write, so 
+// ordering with WriteAsync is preserved.  
+//
+DWORD Np::GatherWriteAsync( SNI_Packet   * pPacket, 
+							SNI_ProvInfo * pInfo )
+{
+	BidxScopeAutoSNI3( SNIAPI_TAG _T("%u#, ")
+							  _T("pPacket: %p{SNI_Packet*}, ")
+							  _T("pInfo: %p{SNI_ProvInfo*}\n"), 
+							  GetBidId(),
+							  pPacket, 
+							  pInfo);
+
+	DWORD cPackets = 0;
+
+	for( SNI_Packet * pTmp = pPacket; NULL != pTmp; pTmp = SNIPacketGetNext( pTmp ) )
+	{
+		if( ++cPackets > MAX_GATHERWRITE_BUFS )
+		{
+			SNI_SET_LAST_ERROR( m_ProtToReport, SNIE_SYSTEM, ERROR_INVALID_PARAMETER );
+
+			BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_INVALID_PARAMETER);
+			
+			return ERROR_INVALID_PARAMETER;
+		}
+	}
+
+	DWORD dwRet = WriteAsync( pPacket, pInfo );
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+	
+	return dwRet;
+}
+
+// Opt-in: when consumer writes queue up behind a pending pipe write, the 
+// next write takes as many of them as fit in cbMax bytes and sends them 
+// as one pipe message; each packet still completes on its own, in order.  
+// Nothing is held back waiting for more packets.  The peer must read the 
+// pipe as a stream of TDS packets rather than one packet per message.  
+// Zero turns it off.  Applies to new writes as soon as it is set.  
+//
+DWORD SNISetNpWriteCoalescing( DWORD cbMax )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "cbMax: %u\n"), cbMax);
+
+	g_cbNpWriteCoalesce = cbMax;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+//---------------------------------------------------------------------
+// Function: Np::DeQueueCoalesced
+//
+// Description:
+//	Dequeues the packets at the front of the write queue that fit in 
+//	g_cbNpWriteCoalesce bytes, chained through SNIPacketSetNext().  
+//
+// Returns:
+//	The first packet of the chain, or NULL (and the queue is left alone) 
+//	if the first queued packet alone does not leave room for another 
+//	one or is itself a gathered write.  
+//
+// Assumptions:
+//	- Called while holding m_CS, with the queue not empty.  
+//
+// Notes:
+//	WriteDone() completes the chained packets one after the other 
+//	once the write completes; see m_fCoalescedWrite.  
+//
+SNI_Packet * Np::DeQueueCoalesced()
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T("%u#\n"), GetBidId() );
+
+	SNI_Packet * pHead = (SNI_Packet *) m_WritePacketQueue.Peek();
+
+	DWORD cbTotal = SNIPacketGetBufferSize( pHead );
+
+	if( NULL != SNIPacketGetNext( pHead ) || cbTotal >= g_cbNpWriteCoalesce )
+	{
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), NULL);
+		return NULL;
+	}
+
+	m_WritePacketQueue.DeQueue();
+
+	SNI_Packet * pTail = pHead;
+
+	DWORD cPackets = 1;
+
+	while( cPackets < MAX_GATHERWRITE_BUFS && !m_WritePacketQueue.IsEmpty() )
+	{
+		SNI_Packet * pPacket = (SNI_Packet *) m_WritePacketQueue.Peek();
+
+		if( NULL != SNIPacketGetNext( pPacket ) || 
+			cbTotal + SNIPacketGetBufferSize( pPacket ) > g_cbNpWriteCoalesce )
+		{
+			break;
+		}
+
+		m_WritePacketQueue.DeQueue();
+
+		SNIPacketSetNext( pTail, pPacket );
+		pTail = pPacket;
+
+		cbTotal += SNIPacketGetBufferSize( pPacket );
+		cPackets++;
+	}
+
+	BidTraceU3( SNI_BID_TRACE_ON, SNI_TAG _T("%u#, coalesced packets: %d, %d bytes\n"), GetBidId(), cPackets, cbTotal);
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%p{SNI_Packet*}\n"), pHead);
+	
+	return pHead;
+}
+
 Np * Np::AcceptConnection( SNI_Conn *pConn, __inout NpAcceptStruct *pAcc)
 {
 	BidxScopeAutoSNI2( SNIAPI_TAG _T( "pConn: %p{SNI_Conn*}, pAcc: %p{NpAcceptStruct*}\n"), pConn, pAcc);
@@ -2469,13 +2653,48 @@ DWORD Np::WriteDone( SNI_Packet ** ppPacket,
 
 	Assert( m_fWritePending );
 	m_fWritePending = false;
+
+	// The rest of a coalesced write completes one packet at a time, ahead 
+	// of anything still queued, the same way a queued write that completed 
+	// synchronously is completed.  The chain stays on the next packet.  
+	//
+	SNI_Packet *pChained = NULL;
+
+	if( m_fCoalescedWrite )
+	{
+		pChained = SNIPacketGetNext( *ppPacket );
+
+		if( NULL != pChained )
+		{
+			SNIPacketSetNext( *ppPacket, NULL );
+
+			m_fWritePending = true;
+
+			pChained->m_OrigProv = NP_PROV;
+
+			if( ERROR_SUCCESS != SNIPacketPostQCS( pChained, 
+					( ERROR_SUCCESS == dwError && 0 != dwBytes ) ? SNIPacketGetBufferSize( pChained ) : 0 ) )
+			{
+				//This assertion is used to catch unexpected system call failure.
+				Assert( 0 && "SNIPacketPostQCS failed\n" );
+				BidTrace0(ERROR_TAG _T("SNIPacketPostQCS failed\n"));
+			}
+		}
+		else
+		{
+			m_fCoalescedWrite = false;
+		}
+	}
 	
 	// If its an error, return the error. Named-Pipes does not treat
 	// any errors as "valid".
 	//
 	if( dwError )
 	{
-		CallbackError();
+		if( NULL == pChained )
+		{
+			CallbackError();
+		}
 
 		dwRet = dwError;
 
@@ -2492,13 +2711,16 @@ DWORD Np::WriteDone( SNI_Packet ** ppPacket,
 		Assert( (*ppPacket)->m_OrigProv == NP_PROV );
 		(*ppPacket)->m_OrigProv = INVALID_PROV;
 
-		CallbackError();
+		if( NULL == pChained )
+		{
+			CallbackError();
+		}
 
 		SNI_SET_LAST_ERROR( m_ProtToReport, SNIE_2, ERROR_PIPE_NOT_CONNECTED );
 
 		dwRet = ERROR_PIPE_NOT_CONNECTED;
 	}
-	else if( !m_WritePacketQueue.IsEmpty() )
+	else if( NULL == pChained && !m_WritePacketQueue.IsEmpty() )
 	{
 		SNI_Packet *pPacket;
 
@@ -2515,6 +2737,33 @@ DWORD Np::WriteDone( SNI_Packet ** ppPacket,
 			//
 			CallbackError(); 
 		}
+		else if( 0 != g_cbNpWriteCoalesce && 
+				 NULL != ( pPacket = DeQueueCoalesced() ) )
+		{
+			// The packets are off the queue already, so whatever the 
+			// outcome the chain completes through the first one.  
+			//
+			DWORD dwBytesWritten = 0;
+
+			DWORD dwSendError = SendPacketAsync( pPacket, &dwBytesWritten );
+
+			m_fWritePending = true;
+			m_fCoalescedWrite = true;
+
+			if( ERROR_IO_PENDING != dwSendError )
+			{
+				pPacket->m_OrigProv = NP_PROV;
+				
+				if( ERROR_SUCCESS != SNIPacketPostQCS( pPacket, ERROR_SUCCESS == dwSendError ? dwBytesWritten : 0 ) )
+				{
+					//This assertion is used to catch unexpected system call failure.
+					Assert( 0 && "SNIPacketPostQCS failed\n" );
+					BidTrace0(ERROR_TAG _T("SNIPacketPostQCS failed\n"));
+				}
+			}
+
+			ReleaseHandleRef(); 
+		}
 		else
 		{
 			DWORD dwBytesWritten = 0;
@@ -257,6 +257,229 @@ ErrorExit:
 	return ERROR_INVALID_PARAMETER;
 }
 
+// Composed SPNs, keyed by everything Connect() feeds into them.  Composing 
+// one costs a canonical-name lookup of the server (see Tcp::GetDnsName), 
+// which right after a pool clear every new connection repeats.  Entries 
+// expire after g_dwSpnCacheTtl milliseconds so DNS changes are picked up; 
+// see SNISetSpnCache.  
+//
+#define SPN_CACHE_SIZE 16
+
+typedef struct
+{
+	WCHAR *	wszKey;
+	WCHAR *	wszSpn;
+	DWORD	dwInsertTick;
+} SpnCacheEntry;
+
+static SpnCacheEntry g_rgSpnCache[SPN_CACHE_SIZE];
+static SNICritSec * g_csSpnCache = NULL;
+static DWORD g_dwSpnCacheTtl = 0;
+
+// Called with g_csSpnCache held.  
+//
+static void SpnCacheFree( __inout SpnCacheEntry * pEntry )
+{
+	delete [] pEntry->wszKey;
+	delete [] pEntry->wszSpn;
+	pEntry->wszKey = NULL;
+	pEntry->wszSpn = NULL;
+}
+
+static DWORD SpnCacheKey( __in ConnectParameter * pConnectParams, 
+						  __in ProtElem * pProtElem, 
+						  __out_ecount(cchKey) WCHAR * wszKey, 
+						  DWORD cchKey )
+{
+	WCHAR wszPort[MAX_PROTOCOLPARAMETER_LENGTH + 16];
+
+	wszPort[0] = L'\0';
+
+	switch( pProtElem->GetProviderNum() )
+	{
+		case TCP_PROV:
+			(void) StringCchCopyW( wszPort, ARRAYSIZE(wszPort), pProtElem->Tcp.wszPort );
+			break;
+
+		case VIA_PROV:
+			(void) StringCchPrintf_lW( wszPort, ARRAYSIZE(wszPort), L"%d,%s", GetDefaultLocale(), 
+									   pProtElem->Via.Port, pProtElem->Via.Param );
+			break;
+
+		default:
+			break;
+	}
+
+	if( FAILED( StringCchPrintf_lW( wszKey, cchKey, L"%d|%s|%s|%s|%s|%s", GetDefaultLocale(), 
+									pProtElem->GetProviderNum(), 
+									pProtElem->m_wszServerName, 
+									pConnectParams->m_wszProtocolName, 
+									pConnectParams->m_wszInstanceName, 
+									pConnectParams->m_wszProtocolParameter, 
+									wszPort ) ) )
+	{
+		return ERROR_INSUFFICIENT_BUFFER;
+	}
+
+	return ERROR_SUCCESS;
+}
+
+static bool SpnCacheLookup( __in LPCWSTR wszKey, __out_ecount(cchSpn) WCHAR * wszSpn, DWORD cchSpn )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T("wszKey: \"%ls\"\n"), wszKey );
+
+	bool fHit = false;
+
+	DWORD dwNow = GetTickCount();
+
+	CAutoSNICritSec a_csCache( g_csSpnCache, SNI_AUTOCS_ENTER );
+
+	for( int i = 0; i < SPN_CACHE_SIZE; i++ )
+	{
+		SpnCacheEntry * pEntry = &g_rgSpnCache[i];
+
+		if( NULL == pEntry->wszKey || wcscmp( pEntry->wszKey, wszKey ) )
+		{
+			continue;
+		}
+
+		if( (DWORD)(dwNow - pEntry->dwInsertTick) >= g_dwSpnCacheTtl )
+		{
+			SpnCacheFree( pEntry );
+		}
+		else if( SUCCEEDED( StringCchCopyW( wszSpn, cchSpn, pEntry->wszSpn ) ) )
+		{
+			fHit = true;
+		}
+
+		break;
+	}
+
+	a_csCache.Leave(); 
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{bool}\n"), fHit);
+
+	return fHit;
+}
+
+// Best effort; a failed allocation just leaves the SPN uncached.  
+//
+static void SpnCacheInsert( __in LPCWSTR wszKey, __in LPCWSTR wszSpn )
+{
+	BidxScopeAutoSNI2( SNIAPI_TAG _T("wszKey: \"%ls\", wszSpn: \"%ls\"\n"), wszKey, wszSpn );
+
+	size_t cchKey = wcslen( wszKey ) + 1;
+	size_t cchSpn = wcslen( wszSpn ) + 1;
+
+	WCHAR * wszNewKey = NewNoX(gpmo) WCHAR[cchKey];
+	WCHAR * wszNewSpn = NewNoX(gpmo) WCHAR[cchSpn];
+
+	if( NULL == wszNewKey || NULL == wszNewSpn )
+	{
+		delete [] wszNewKey;
+		delete [] wszNewSpn;
+
+		BidTraceU0( SNI_BID_TRACE_ON, RETURN_TAG _T("\n") );
+		return;
+	}
+
+	memcpy( wszNewKey, wszKey, cchKey * sizeof(WCHAR) );
+	memcpy( wszNewSpn, wszSpn, cchSpn * sizeof(WCHAR) );
+
+	DWORD dwNow = GetTickCount();
+
+	CAutoSNICritSec a_csCache( g_csSpnCache, SNI_AUTOCS_ENTER );
+
+	// Replace the same key, else a free slot, else the oldest entry.  
+	//
+	SpnCacheEntry * pVictim = &g_rgSpnCache[0];
+
+	for( int i = 0; i < SPN_CACHE_SIZE; i++ )
+	{
+		SpnCacheEntry * pEntry = &g_rgSpnCache[i];
+
+		if( NULL != pEntry->wszKey && !wcscmp( pEntry->wszKey, wszKey ) )
+		{
+			pVictim = pEntry;
+			break;
+		}
+
+		if( NULL == pEntry->wszKey )
+		{
+			if( NULL != pVictim->wszKey )
+			{
+				pVictim = pEntry;
+			}
+		}
+		else if( NULL != pVictim->wszKey && 
+				 (DWORD)(dwNow - pEntry->dwInsertTick) > (DWORD)(dwNow - pVictim->dwInsertTick) )
+		{
+			pVictim = pEntry;
+		}
+	}
+
+	SpnCacheFree( pVictim );
+
+	pVictim->wszKey = wszNewKey;
+	pVictim->wszSpn = wszNewSpn;
+	pVictim->dwInsertTick = dwNow;
+
+	a_csCache.Leave(); 
+
+	BidTraceU0( SNI_BID_TRACE_ON, RETURN_TAG _T("\n") );
+}
+
+// Opt-in: reuse the SPN composed for a server, instance and port for 
+// dwTtl milliseconds instead of resolving the server's canonical name on 
+// every open; 0 disables.  Only affects consumers that ask SNI for the 
+// SPN (SNI_CLIENT_CONSUMER_INFO::wszSPN).  
+//
+DWORD SNISetSpnCache( DWORD dwTtl )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "dwTtl: %u\n"), dwTtl);
+
+	DWORD dwRet = ERROR_SUCCESS;
+
+	// As for the SSRP cache, the lock is created on first use and kept 
+	// for the life of the process.  
+	//
+	if( NULL == g_csSpnCache )
+	{
+		SNICritSec * pcsNew = NULL;
+
+		dwRet = SNICritSec::Initialize( &pcsNew );
+		if( ERROR_SUCCESS != dwRet )
+		{
+			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_SYSTEM, dwRet );
+			goto Exit;
+		}
+
+		if( NULL != InterlockedCompareExchangePointer( (PVOID *) &g_csSpnCache, pcsNew, NULL ) )
+		{
+			DeleteCriticalSection( &pcsNew );
+		}
+	}
+
+	{
+		CAutoSNICritSec a_csCache( g_csSpnCache, SNI_AUTOCS_ENTER );
+
+		g_dwSpnCacheTtl = dwTtl;
+
+		for( int i = 0; i < SPN_CACHE_SIZE; i++ )
+		{
+			SpnCacheFree( &g_rgSpnCache[i] );
+		}
+
+		a_csCache.Leave(); 
+	}
+
+Exit:
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+	
+	return dwRet;
+}
+
 __success(ERROR_SUCCESS == return) 
 DWORD Connect(  __in ConnectParameter *pConnectParams, 
 					__in SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
@@ -282,6 +505,16 @@ DWORD Connect(  __in ConnectParameter *pConnectParams,
 	{
 		Assert(rgProvInfo[TCP_PROV].fInitialized);	// need TCP to be initialized to reverse DNS lookup.
 		Assert(pProtElem->m_wszServerName[0]);		// Server Name must be non-blank since we connected.
+
+		WCHAR wszSpnKey[MAX_NAME_SIZE + MAX_INSTANCENAME_LENGTH + 2 * MAX_PROTOCOLPARAMETER_LENGTH + MAX_PROTOCOLNAME_LENGTH + 64];
+
+		bool fSpnCache = ( 0 != g_dwSpnCacheTtl ) && 
+						 ( ERROR_SUCCESS == SpnCacheKey( pConnectParams, pProtElem, wszSpnKey, ARRAYSIZE(wszSpnKey) ) );
+
+		if( fSpnCache && SpnCacheLookup( wszSpnKey, (WCHAR *) pClientConsumerInfo->wszSPN, pClientConsumerInfo->cchSPN ) )
+		{
+			goto Exit;
+		}
 		
 		WCHAR wszDnsFQDN[NI_MAXHOST];
 
@@ -409,6 +642,10 @@ DWORD Connect(  __in ConnectParameter *pConnectParams,
 
 			*ppConn = NULL;
 		}
+		else if( fSpnCache )
+		{
+			SpnCacheInsert( wszSpnKey, pClientConsumerInfo->wszSPN );
+		}
 	}
 
 Exit:
@@ -592,6 +829,7 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 	
 	DWORD dwRet = ERROR_FAIL;
 	bool fLocalDB = false;
+	LocalDB* pLdbBInstance = NULL;
 	ConnectParameter * pConnectParams = NULL;
 
 	WCHAR wszLocaldbConnect[CONNECT_MAX] = L"\0";
@@ -602,6 +840,10 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 	DWORD dwStart = GetTickCount();
 	int timeleft = pClientConsumerInfo->timeout;
 
+	// Time spent waiting on the SQL Browser, reported in SNI_OPEN_TIMINGS.
+	DWORD dwSsrpStart;
+	DWORD dwSsrpTime = 0;
+
 	LPWSTR wszCopyConnect = NULL;
 
 	if( INVALID_PREFIX <= pClientConsumerInfo->networkLibrary )
@@ -633,7 +875,6 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 	{
 		// Obtain the singleton object
 		//
-		LocalDB* pLdbBInstance = NULL;
 		if(ERROR_SUCCESS != (dwRet = LocalDB::LDBInstance(&pLdbBInstance)))
 		{
 			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_SYSTEM, dwRet);
@@ -821,9 +1062,11 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 
 	if( fSsrpRequired )
 	{
+		dwSsrpStart = GetTickCount();
 		dwRet = SSRP::SsrpGetInfo(pConnectParams->m_wszServerName,
 									pConnectParams->m_wszInstanceName, 
 									&protList);
+		dwSsrpTime += GetTickCount() - dwSsrpStart;
 		if( dwRet != ERROR_SUCCESS )
 		{
 			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_26, dwRet );
@@ -896,10 +1139,15 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 				
 			{
 				USHORT port;
-				
-				if( !SSRP::GetAdminPort( pConnectParams->m_wszServerName, 
+				bool fGotPort;
+
+				dwSsrpStart = GetTickCount();
+				fGotPort = SSRP::GetAdminPort( pConnectParams->m_wszServerName, 
 										L"MSSQLServer", 
-										&port) )
+										&port);
+				dwSsrpTime += GetTickCount() - dwSsrpStart;
+				
+				if( !fGotPort )
 				{
 					SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_43, ERROR_FAIL );
 				}
@@ -925,6 +1173,8 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 			{
 				DWORD nlRet;
 
+				dwSsrpStart = GetTickCount();
+
 				if ( pConnectParams->m_wszInstanceName[0] == L'\0' ) 
 				{
 					nlRet = SSRP::SsrpGetInfo(pConnectParams->m_wszServerName, 
@@ -937,6 +1187,7 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 												pConnectParams->m_wszInstanceName, 
 												&protList);
 				}
+				dwSsrpTime += GetTickCount() - dwSsrpStart;
 				fSsrpDone = true;
 
 				pProtElem = protList.Head;
@@ -968,6 +1219,14 @@ DWORD SNIOpenSyncEx( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
 
 ExitFunc:
 
+	// A LocalDB connect that failed may have used a cached pipe name of an 
+	// instance that has since stopped; make the next open start it again.
+	//
+	if( ERROR_SUCCESS != dwRet && NULL != pLdbBInstance && NULL != wszCopyConnect )
+	{
+		pLdbBInstance->invalidateLocalDBConnectionString(wszCopyConnect + (sizeof(LOCALDB_INST_WSTR)/sizeof(WCHAR)-1));
+	}
+
 	if(wszCopyConnect)
 	{
 		delete [] wszCopyConnect;
@@ -976,6 +1235,23 @@ ExitFunc:
 
 	if( ERROR_SUCCESS == dwRet )
 	{
+		// Only the provider attempt that succeeded left its timings on 
+		// *ppConn; SSRP and the total cover the whole open.
+		//
+		SNI_OPEN_TIMINGS * pTimings = &(*ppConn)->m_ConnInfo.OpenTimings;
+
+		pTimings->dwSsrp = dwSsrpTime;
+		pTimings->dwTotal = GetTickCount() - dwStart;
+
+		BidTraceU7( SNI_BID_TRACE_ON, SNI_TAG _T("%u#{SNI_Conn}, open timings(ms): total: %d, ssrp: %d, resolve: %d, connect: %d, addresses: %d, attempts: %d\n"), 
+					(*ppConn)->GetBidId(), 
+					pTimings->dwTotal, 
+					pTimings->dwSsrp, 
+					pTimings->dwResolve, 
+					pTimings->dwTcpConnect, 
+					pTimings->cAddresses, 
+					pTimings->cAddressAttempts );
+
 		if (pConnectParams->m_fStandardInstName)
 		{
 			int cchInstanceName = wcslen(pConnectParams->m_wszInstanceName);
@@ -1021,6 +1297,150 @@ ExitFunc:
 	return dwRet;
 }
 
+// One of the connections SNIOpenSyncExMultiple opens on a worker thread.  
+// Each gets its own copy of the consumer info, since SNIOpenSyncEx writes 
+// the instance name back into it.
+//
+typedef struct
+{
+	SNI_CLIENT_CONSUMER_INFO	ClientConsumerInfo;
+	char						szInstanceName[MAX_NAME_SIZE+1];
+	SNI_Conn *					pConn;
+	DWORD						dwRet;
+} SNI_OPEN_MULTIPLE_ITEM;
+
+static DWORD WINAPI OpenMultipleWorker( LPVOID pvItem )
+{
+	SNI_OPEN_MULTIPLE_ITEM * pItem = (SNI_OPEN_MULTIPLE_ITEM *) pvItem;
+
+	pItem->dwRet = SNIOpenSyncEx( &pItem->ClientConsumerInfo, &pItem->pConn );
+
+	return 0;
+}
+
+// Opens up to cConns connections to the target in pClientConsumerInfo, 
+// e.g. to warm up a pool after failover.  The first connection is opened 
+// on the calling thread exactly like SNIOpenSyncEx, which primes the 
+// LastConnectCache with the protocol and port (so the others skip SSRP) and, 
+// when enabled, the SSRP and TCP address caches.  The others are then 
+// opened in parallel on their own threads.  
+//
+// Returns the error of the first open if it failed.  Otherwise returns 
+// ERROR_SUCCESS with the opened connections in rgpConns[0 .. *pcOpened-1]; 
+// the SPN is only returned for the first connection, all of them share it.
+//
+DWORD SNIOpenSyncExMultiple( __inout SNI_CLIENT_CONSUMER_INFO * pClientConsumerInfo,
+							__out_ecount(cConns) SNI_Conn ** rgpConns,
+							DWORD cConns,
+							__out DWORD * pcOpened )
+{
+	BidxScopeAutoSNI4( SNIAPI_TAG _T( "pClientConsumerInfo: %p{SNI_CLIENT_CONSUMER_INFO*}, ")
+								_T("rgpConns: %p{SNI_Conn**}, ")
+								_T("cConns: %d, ")
+								_T("pcOpened: %p{DWORD*}\n"),
+								pClientConsumerInfo,
+								rgpConns,
+								cConns,
+								pcOpened);
+
+	DWORD dwRet = ERROR_SUCCESS;
+	SNI_OPEN_MULTIPLE_ITEM * rgItems = NULL;
+	HANDLE rghThreads[MAXIMUM_WAIT_OBJECTS];
+	DWORD cThreads = 0;
+	DWORD cOpened = 0;
+
+	*pcOpened = 0;
+
+	if( 0 == cConns || MAXIMUM_WAIT_OBJECTS < cConns - 1 )
+	{
+		dwRet = ERROR_INVALID_PARAMETER;
+		SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_SYSTEM, dwRet );
+		goto Exit;
+	}
+
+	memset( rgpConns, 0, cConns * sizeof(rgpConns[0]) );
+
+	dwRet = SNIOpenSyncEx( pClientConsumerInfo, &rgpConns[0] );
+	if( ERROR_SUCCESS != dwRet )
+	{
+		goto Exit;
+	}
+
+	cOpened = 1;
+
+	if( 1 == cConns )
+	{
+		goto Exit;
+	}
+
+	rgItems = NewNoX(gpmo) SNI_OPEN_MULTIPLE_ITEM[cConns - 1];
+	if( NULL == rgItems )
+	{
+		// The first connection is still good; report just that one.
+		BidTrace0( ERROR_TAG _T("Out of memory, opened one connection\n") );
+		goto Exit;
+	}
+
+	for( DWORD i = 0; i < cConns - 1; i++ )
+	{
+		SNI_OPEN_MULTIPLE_ITEM * pItem = &rgItems[i];
+
+		pItem->ClientConsumerInfo = *pClientConsumerInfo;
+		pItem->ClientConsumerInfo.wszSPN = NULL;
+		pItem->ClientConsumerInfo.cchSPN = 0;
+		pItem->ClientConsumerInfo.szInstanceName = pItem->szInstanceName;
+		pItem->ClientConsumerInfo.cchInstanceName = ARRAYSIZE(pItem->szInstanceName);
+		pItem->ClientConsumerInfo.fOverrideLastConnectCache = FALSE;
+		pItem->szInstanceName[0] = '\0';
+		pItem->pConn = NULL;
+		pItem->dwRet = ERROR_FAIL;
+
+		rghThreads[cThreads] = CreateThread( NULL, 0, OpenMultipleWorker, pItem, 0, NULL );
+
+		if( NULL != rghThreads[cThreads] )
+		{
+			cThreads++;
+		}
+		else
+		{
+			(void) OpenMultipleWorker( pItem );
+		}
+	}
+
+	if( 0 < cThreads )
+	{
+		// Every open is bounded by the consumer's timeout.
+		(void) WaitForMultipleObjects( cThreads, rghThreads, TRUE, INFINITE );
+
+		for( DWORD i = 0; i < cThreads; i++ )
+		{
+			CloseHandle( rghThreads[i] );
+		}
+	}
+
+	for( DWORD i = 0; i < cConns - 1; i++ )
+	{
+		if( ERROR_SUCCESS == rgItems[i].dwRet )
+		{
+			rgpConns[cOpened++] = rgItems[i].pConn;
+		}
+		else
+		{
+			BidTrace2( ERROR_TAG _T("connection %d: %d{WINERR}\n"), i + 1, rgItems[i].dwRet );
+		}
+	}
+
+	delete [] rgItems;
+
+Exit:
+
+	*pcOpened = cOpened;
+
+	BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}, *pcOpened: %d\n"), dwRet, cOpened);
+	
+	return dwRet;
+}
+
 // NOTE: The caller assumes ownership of the dynamically allocated copy
 DWORD CopyConnectionString(__in LPCWSTR wszConnect, __out LPWSTR* pwszCopyConnect)
 {
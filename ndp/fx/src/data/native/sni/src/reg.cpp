@@ -91,13 +91,22 @@ public:
 };
 
 
+// The cache is split into shards by a hash of the alias, each with its 
+// own list and critical section, so that connections to different 
+// aliases do not all serialize on one lock.  
+//
+#define LAST_CONNECT_CACHE_SHARDS	16
+
 class Cache{
 
-	CacheItem *pHead;
+	CacheItem *m_rgpHead[LAST_CONNECT_CACHE_SHARDS];
 public:
-	Cache():
-		pHead(0)
+	Cache()
 	{
+		for( DWORD i = 0; i < LAST_CONNECT_CACHE_SHARDS; i++ )
+		{
+			m_rgpHead[i] = 0;
+		}
 	}
 	
 	~Cache()
@@ -109,17 +118,50 @@ public:
 	{
 		BidxScopeAutoSNI0( SNIAPI_TAG _T( "\n") );
 		
-		CacheItem *pNext=pHead;
-		while(pHead){
-			pNext = pHead->m_pNext;
-			delete pHead;
-			pHead=pNext;
+		for( DWORD i = 0; i < LAST_CONNECT_CACHE_SHARDS; i++ )
+		{
+			CacheItem *pNext=m_rgpHead[i];
+			while(m_rgpHead[i]){
+				pNext = m_rgpHead[i]->m_pNext;
+				delete m_rgpHead[i];
+				m_rgpHead[i]=pNext;
+			}
 		}
 	}
-	BOOL Insert( const WCHAR *wszValName, const WCHAR *wszValue)
+
+	// Returns the shard for an alias.  Aliases are compared with 
+	// NORM_IGNORECASE|NORM_IGNOREWIDTH, so hash the sort key for those 
+	// flags: two aliases that compare equal have the same sort key.  
+	//
+	static DWORD GetShard( const WCHAR * wszValName )
 	{
-		BidxScopeAutoSNI2( SNIAPI_TAG _T( "wszValName: \"%s\", wszValue: \"%s\"\n"), 
-						wszValName, wszValue);
+		BYTE rgbSortKey[4 * (MAX_NAME_SIZE + 1)];
+		DWORD dwHash = 0;
+		
+OACR_WARNING_PUSH
+OACR_WARNING_DISABLE(SYSTEM_LOCALE_MISUSE , " INTERNATIONALIZATION BASELINE AT KATMAI RTM. FUTURE ANALYSIS INTENDED. ")
+		int cbSortKey = LCMapStringW(LOCALE_SYSTEM_DEFAULT,
+									 LCMAP_SORTKEY|NORM_IGNORECASE|NORM_IGNOREWIDTH,
+									 wszValName, -1,
+									 (LPWSTR) rgbSortKey, sizeof(rgbSortKey));
+OACR_WARNING_POP
+
+		// A key that does not fit fails the same way for every alias 
+		// equal to this one, so they all land in shard 0.  
+		for( int i = 0; i < cbSortKey; i++ )
+		{
+			dwHash = dwHash * 31 + rgbSortKey[i];
+		}
+
+		return dwHash % LAST_CONNECT_CACHE_SHARDS;
+	}
+
+	BOOL Insert( DWORD iShard, const WCHAR *wszValName, const WCHAR *wszValue)
+	{
+		BidxScopeAutoSNI3( SNIAPI_TAG _T( "iShard: %u, wszValName: \"%s\", wszValue: \"%s\"\n"), 
+						iShard, wszValName, wszValue);
+		
+		Assert( iShard < LAST_CONNECT_CACHE_SHARDS );
 		
 		if(MAX_CACHEENTRY_LENGTH<wcslen(wszValue))
 		{			
@@ -142,21 +184,23 @@ public:
 	    		return FALSE;
 	    	}
 
-		pNewItem->m_pNext = pHead;			//it points to old first link
-		pHead = pNewItem;			//now first points to this
+		pNewItem->m_pNext = m_rgpHead[iShard];			//it points to old first link
+		m_rgpHead[iShard] = pNewItem;			//now first points to this
 
 		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{BOOL}\n"), TRUE);
 		return TRUE;
 	}
 
 	// Find item in the cache
-	CacheItem * Find( const WCHAR * wszValName)   
+	CacheItem * Find( DWORD iShard, const WCHAR * wszValName)   
 	{                           
-		BidxScopeAutoSNI1( SNIAPI_TAG _T( "wszValName: \"%s\"\n"), wszValName);
+		BidxScopeAutoSNI2( SNIAPI_TAG _T( "iShard: %u, wszValName: \"%s\"\n"), iShard, wszValName);
+
+		Assert( iShard < LAST_CONNECT_CACHE_SHARDS );
 
 		CacheItem *pCurrent;
 
-		for ( pCurrent = pHead; pCurrent; pCurrent = pCurrent->m_pNext )
+		for ( pCurrent = m_rgpHead[iShard]; pCurrent; pCurrent = pCurrent->m_pNext )
 OACR_WARNING_PUSH
 OACR_WARNING_DISABLE(SYSTEM_LOCALE_MISUSE , " INTERNATIONALIZATION BASELINE AT KATMAI RTM. FUTURE ANALYSIS INTENDED. ")
 			if ( CSTR_EQUAL == CompareStringW(LOCALE_SYSTEM_DEFAULT,
@@ -172,11 +216,13 @@ OACR_WARNING_POP
 	}
 
 	// Remove item from the cache
-	BOOL Remove(const WCHAR * wszValName)           
+	BOOL Remove( DWORD iShard, const WCHAR * wszValName)           
 	{
-		BidxScopeAutoSNI1( SNIAPI_TAG _T( "wszValName: \"%s\"\n"), wszValName);
+		BidxScopeAutoSNI2( SNIAPI_TAG _T( "iShard: %u, wszValName: \"%s\"\n"), iShard, wszValName);
 		
-		CacheItem ** ppCurrentItem = &pHead;
+		Assert( iShard < LAST_CONNECT_CACHE_SHARDS );
+
+		CacheItem ** ppCurrentItem = &m_rgpHead[iShard];
 
 		for ( ; *ppCurrentItem ; ppCurrentItem = &(*ppCurrentItem)->m_pNext)
 		{
@@ -207,7 +253,7 @@ OACR_WARNING_POP
 
 Cache *pgLastConnectCache;         // the LastConnectCache
 
-SNICritSec 	* critsecCache = 0;
+SNICritSec 	* rgcritsecCache[LAST_CONNECT_CACHE_SHARDS];	// one per Cache shard
 
 #ifndef SNIX
 //	For SNIX version, see below
@@ -231,9 +277,12 @@ void Initialize()
 		goto ErrorExit;
 	}
 	
-	if( ERROR_SUCCESS != SNICritSec::Initialize(&critsecCache))
+	for( DWORD i = 0; i < LAST_CONNECT_CACHE_SHARDS; i++ )
 	{
-		goto ErrorExit;
+		if( ERROR_SUCCESS != SNICritSec::Initialize(&rgcritsecCache[i]))
+		{
+			goto ErrorExit;
+		}
 	}
 
 	// Initialize persistent cache in registry.
@@ -285,7 +334,7 @@ void Initialize()
         {
             // There is a valid registry entry
             // So, insert into the LastConnectCache
-            if( !pgLastConnectCache->Insert( wszValueName, wszValue) )
+            if( !pgLastConnectCache->Insert( Cache::GetShard( wszValueName ), wszValueName, wszValue) )
             {
 				goto ErrorExit1;
             }
@@ -303,7 +352,10 @@ ErrorExit1:
 
 ErrorExit:
 
-	DeleteCriticalSection(&critsecCache);
+	for( DWORD i = 0; i < LAST_CONNECT_CACHE_SHARDS; i++ )
+	{
+		DeleteCriticalSection(&rgcritsecCache[i]);
+	}
 	if(pgLastConnectCache)
 		delete pgLastConnectCache;
 
@@ -326,7 +378,10 @@ void Shutdown()
 		return;
 	}
 
-	DeleteCriticalSection(&critsecCache);
+	for( DWORD i = 0; i < LAST_CONNECT_CACHE_SHARDS; i++ )
+	{
+		DeleteCriticalSection(&rgcritsecCache[i]);
+	}
 
 	delete pgLastConnectCache;
 
@@ -349,11 +404,12 @@ void RemoveEntry( const WCHAR *wszAlias)
 		return;
 	}
 	
-	CAutoSNICritSec a_csCache( critsecCache, SNI_AUTOCS_DO_NOT_ENTER );
+	DWORD iShard = Cache::GetShard( wszAlias );
+	CAutoSNICritSec a_csCache( rgcritsecCache[iShard], SNI_AUTOCS_DO_NOT_ENTER );
 
 	a_csCache.Enter();
 
-    if( pgLastConnectCache->Remove( wszAlias) )
+    if( pgLastConnectCache->Remove( iShard, wszAlias) )
     {
 		LONG ret;
 		
@@ -386,7 +442,8 @@ BOOL GetEntry( const WCHAR *wszAlias, __out ProtElem *pProtElem)
 	}
 	
 
-	CAutoSNICritSec a_csCache( critsecCache, SNI_AUTOCS_DO_NOT_ENTER );
+	DWORD iShard = Cache::GetShard( wszAlias );
+	CAutoSNICritSec a_csCache( rgcritsecCache[iShard], SNI_AUTOCS_DO_NOT_ENTER );
 
 	a_csCache.Enter();
 
@@ -394,7 +451,7 @@ BOOL GetEntry( const WCHAR *wszAlias, __out ProtElem *pProtElem)
     CacheItem * pItem;
 
     // Look for item in the cache
-    if( (pItem = pgLastConnectCache->Find(wszAlias)) == NULL)
+    if( (pItem = pgLastConnectCache->Find(iShard, wszAlias)) == NULL)
     {
 		a_csCache.Leave(); 
         goto ErrorExit;
@@ -543,7 +600,8 @@ void SetEntry( const WCHAR *wszAlias, __in ProtElem *pProtElem)
     WCHAR wszCacheVal[MAX_CACHEENTRY_LENGTH+1];
 
     // Enter critical section
-	CAutoSNICritSec a_csCache( critsecCache, SNI_AUTOCS_DO_NOT_ENTER );
+	DWORD iShard = Cache::GetShard( wszAlias );
+	CAutoSNICritSec a_csCache( rgcritsecCache[iShard], SNI_AUTOCS_DO_NOT_ENTER );
 
 	a_csCache.Enter();
 
@@ -601,9 +659,25 @@ void SetEntry( const WCHAR *wszAlias, __in ProtElem *pProtElem)
     if(MAX_CACHEENTRY_LENGTH<chCacheVal)
 		goto ErrorExit;
     
-	pgLastConnectCache->Remove(wszAlias);
+	// Every successful connect lands here; leave the entry, and the 
+	// registry, alone when it already holds this value.  
+	//
+	CacheItem * pItem;
+	WCHAR wszOldVal[MAX_CACHEENTRY_LENGTH+1];
+
+	pItem = pgLastConnectCache->Find( iShard, wszAlias );
+
+	if( pItem && 
+		pItem->CopyValue( wszOldVal, ARRAYSIZE(wszOldVal) ) && 
+		!wcscmp( wszOldVal, wszCacheVal ) )
+	{
+		BidTraceU0( SNI_BID_TRACE_ON, SNI_TAG _T("unchanged\n"));
+		goto ErrorExit;
+	}
+
+	pgLastConnectCache->Remove(iShard, wszAlias);
 
-    if( !pgLastConnectCache->Insert( wszAlias, wszCacheVal) )
+    if( !pgLastConnectCache->Insert( iShard, wszAlias, wszCacheVal) )
     {
     	goto ErrorExit;
     }
@@ -651,9 +725,12 @@ void Initialize()
 		goto ErrorExit;
 	}
 	
-	if( ERROR_SUCCESS != SNICritSec::Initialize(&critsecCache))
+	for( DWORD i = 0; i < LAST_CONNECT_CACHE_SHARDS; i++ )
 	{
-		goto ErrorExit;
+		if( ERROR_SUCCESS != SNICritSec::Initialize(&rgcritsecCache[i]))
+		{
+			goto ErrorExit;
+		}
 	}
 	
 	BidTraceU0( SNI_BID_TRACE_ON,RETURN_TAG _T("success\n"));
@@ -662,7 +739,10 @@ void Initialize()
 
 ErrorExit:
 
-	DeleteCriticalSection(&critsecCache);
+	for( DWORD i = 0; i < LAST_CONNECT_CACHE_SHARDS; i++ )
+	{
+		DeleteCriticalSection(&rgcritsecCache[i]);
+	}
 
 	delete pgLastConnectCache;
 
@@ -686,11 +766,12 @@ void RemoveEntry( const WCHAR *wszAlias)
 		return;
 	}
 	
-	CAutoSNICritSec a_csCache( critsecCache, SNI_AUTOCS_DO_NOT_ENTER );
+	DWORD iShard = Cache::GetShard( wszAlias );
+	CAutoSNICritSec a_csCache( rgcritsecCache[iShard], SNI_AUTOCS_DO_NOT_ENTER );
 
 	a_csCache.Enter();
 
-    pgLastConnectCache->Remove( wszAlias); 
+    pgLastConnectCache->Remove( iShard, wszAlias); 
 
 	a_csCache.Leave(); 
 
@@ -715,7 +796,8 @@ void SetEntry( const WCHAR *wszAlias, ProtElem *pProtElem)
     WCHAR wszCacheVal[MAX_CACHEENTRY_LENGTH+1];
 
     // Enter critical section
-	CAutoSNICritSec a_csCache( critsecCache, SNI_AUTOCS_DO_NOT_ENTER );
+	DWORD iShard = Cache::GetShard( wszAlias );
+	CAutoSNICritSec a_csCache( rgcritsecCache[iShard], SNI_AUTOCS_DO_NOT_ENTER );
 
 	a_csCache.Enter();
 
@@ -773,9 +855,25 @@ void SetEntry( const WCHAR *wszAlias, ProtElem *pProtElem)
     if(MAX_CACHEENTRY_LENGTH<chCacheVal)
 		goto ErrorExit;
     
-	pgLastConnectCache->Remove(wszAlias);
+	// Every successful connect lands here; leave the entry, and the 
+	// registry, alone when it already holds this value.  
+	//
+	CacheItem * pItem;
+	WCHAR wszOldVal[MAX_CACHEENTRY_LENGTH+1];
+
+	pItem = pgLastConnectCache->Find( iShard, wszAlias );
+
+	if( pItem && 
+		pItem->CopyValue( wszOldVal, ARRAYSIZE(wszOldVal) ) && 
+		!wcscmp( wszOldVal, wszCacheVal ) )
+	{
+		BidTraceU0( SNI_BID_TRACE_ON, SNI_TAG _T("unchanged\n"));
+		goto ErrorExit;
+	}
+
+	pgLastConnectCache->Remove(iShard, wszAlias);
 
-    if( !pgLastConnectCache->Insert( wszAlias, wszCacheVal) )
+    if( !pgLastConnectCache->Insert( iShard, wszAlias, wszCacheVal) )
     {
     	goto ErrorExit;
     }
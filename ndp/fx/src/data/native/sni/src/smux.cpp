@@ -48,6 +48,9 @@ BID_METATEXT( _T("<ApiGroup|SNI|SMUX_HEADER> 0x00001000: SNI SMUX packet headers
 #define SMUX_FIN	4
 #define SMUX_DATA	8
 
+// Set by SNISetSmuxWriteCoalescing; see Session::SendPendingPacketsGathered
+BOOL g_fSmuxCoalesceWrites = FALSE;
+
 
 //Smux header structure
 typedef struct 
@@ -130,6 +133,11 @@ public:
 private:
 
 	void SendPendingPackets();
+
+	void SendPendingPacketsGathered();
+
+	//Completes packets chained behind a gathered write
+	void CompleteGatheredPackets( __inout_opt SNI_Packet *pPacket, BOOL fSuccess );
 	
 	//Fills SmuxHeader for data to be send
 	void PrependSmuxHeader(SNI_Packet *pPacket, BYTE Flag);
@@ -1441,6 +1449,13 @@ void Session::SendPendingPackets()
 {
 	BidxScopeAutoSNI1( SNIAPI_TAG _T("%u#\n"), GetBidId() );
 
+	// Only Tcp implements GatherWriteAsync
+	if( g_fSmuxCoalesceWrites && !m_fSync && TCP_PROV == m_pNext->m_Prot )
+	{
+		SendPendingPacketsGathered();
+		return;
+	}
+
 	//if there is a packet waiting for room from peer and there is room send it
 	while( m_SequenceNumberForSend!=m_HighWaterForSend && !m_WritePacketQueue.IsEmpty() )
 	{
@@ -1474,6 +1489,124 @@ void Session::SendPendingPackets()
 	}
 }
 
+// Opt-in: lets a session send the packets queued behind its flow control
+// window in one gathered write.  Applies to new writes as soon as it is set.
+DWORD SNISetSmuxWriteCoalescing( BOOL fCoalesce )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "fCoalesce: %d{BOOL}\n"), fCoalesce);
+
+	g_fSmuxCoalesceWrites = fCoalesce;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+//---------------------------------------------------------------------
+// Function: Session::SendPendingPacketsGathered
+//
+// Description:
+//	Same as SendPendingPackets(), but sends all the queued packets the 
+//	peer has room for in a single GatherWriteAsync() call instead of one
+//	write each.  
+//
+// Assumptions:
+//	- Called while holding m_CS.  
+//	- m_pNext is Tcp and the connection is async.  
+//
+// Notes:
+//	Only the first packet's OVERLAPPED is used for the write, so only 
+//	it gets an I/O completion.  WriteDone() completes the rest of the 
+//	chain by posting them as SESSION_PROV packets, the same way a write
+//	that completed synchronously is completed.  
+//	
+//	Nothing is held back waiting for more packets, so this adds no 
+//	latency.  
+//
+void Session::SendPendingPacketsGathered()
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T("%u#\n"), GetBidId() );
+
+	while( m_SequenceNumberForSend!=m_HighWaterForSend && !m_WritePacketQueue.IsEmpty() )
+	{
+		SNI_Packet *pHead = NULL;
+		SNI_Packet *pTail = NULL;
+		DWORD cPackets = 0;
+
+		while( cPackets < MAX_GATHERWRITE_BUFS &&
+			   m_SequenceNumberForSend!=m_HighWaterForSend && 
+			   !m_WritePacketQueue.IsEmpty() )
+		{
+			Assert( !m_fFINSentOrToSend );
+			Assert( !m_fBadConnection );
+			
+			SNI_Packet *pPacket;
+			pPacket = (SNI_Packet *) m_WritePacketQueue.DeQueue();
+
+			Assert( !SNIPacketGetNext( pPacket ) );
+
+			m_SequenceNumberForSend++;	//first we increment Sequence number
+
+			PrependSmuxHeader( pPacket, SMUX_DATA);
+
+			SNI_BID_TRACE_SMUX_HEADER(
+				_T( "To send:\n" ), 
+				SNIPacketGetBufPtr( pPacket ) ); 
+
+			if( pTail )
+				SNIPacketSetNext( pTail, pPacket );
+			else
+				pHead = pPacket;
+
+			pTail = pPacket;
+			cPackets++;
+		}
+
+		BidTraceU2( SNI_BID_TRACE_ON, SNI_TAG _T("%u#, gathered packets: %d\n"), GetBidId(), cPackets);
+
+		DWORD dwRet = m_pNext->GatherWriteAsync( pHead, NULL );
+
+		if(dwRet == ERROR_SUCCESS || dwRet == ERROR_IO_PENDING )
+		{
+			m_LastHighWaterForReceive = m_HighWaterForReceive;
+		}
+
+		if( ERROR_IO_PENDING != dwRet )
+		{
+			// No I/O completion will arrive for any of the packets
+			CompleteGatheredPackets( pHead, ERROR_SUCCESS == dwRet );
+		}
+	}
+}
+
+void Session::CompleteGatheredPackets( __inout_opt SNI_Packet *pPacket, BOOL fSuccess )
+{
+	BidxScopeAutoSNI3( SNIAPI_TAG _T("%u#, ")
+							  _T( "pPacket: %p{SNI_Packet*}, ")
+							  _T( "fSuccess: %d{BOOL}\n"), 
+							  GetBidId(),
+							  pPacket, 
+							  fSuccess );
+
+	while( pPacket )
+	{
+		SNI_Packet *pNext = SNIPacketGetNext( pPacket );
+
+		SNIPacketSetNext( pPacket, NULL );
+		
+		pPacket->m_OrigProv = SESSION_PROV;
+		
+		if( ERROR_SUCCESS != SNIPacketPostQCS( pPacket, fSuccess ? SNIPacketGetBufferSize( pPacket ) : 0 ) )
+		{
+			//this assertion is used to catch unexpected system call failure.
+			Assert( 0 && "SNIPacketPostQCS failed\n" );
+			BidTrace0( ERROR_TAG _T("SNIPacketPostQCS failed\n") );
+		}
+
+		pPacket = pNext;
+	}
+}
+
 Session::Session(SNI_Conn *pConn, SNI_Provider *pNext, USHORT SessionId, __in Smux *pSmux): SNI_Provider( pConn )
 {
 	m_pNext = pNext;
@@ -1654,6 +1787,17 @@ DWORD Session::WriteDone(__inout SNI_Packet ** ppPacket, DWORD dwBytes, DWORD dw
 	DWORD dwRet;
 
 	bool fOriginator = false;
+
+	// The rest of a gathered write (see SendPendingPacketsGathered) 
+	// completes through its first packet
+	SNI_Packet *pGathered = SNIPacketGetNext( *ppPacket );
+
+	if( pGathered )
+	{
+		SNIPacketSetNext( *ppPacket, NULL );
+
+		CompleteGatheredPackets( pGathered, ERROR_SUCCESS == dwError && 0 != dwBytes );
+	}
 	
 	if( (*ppPacket)->m_OrigProv!=SESSION_PROV )
 	{
@@ -2257,7 +2401,7 @@ ErrorExit:
 
 DWORD Smux::GetSessionFromId( USHORT SessionId, __out Session **ppSession )
 {
-	BidxScopeAutoSNI3( SNIAPI_TAG _T("%u#, ")
+	BidxScopeAutoSNIHotPath3( SNIAPI_TAG _T("%u#, ")
 							  _T("SessionId: %d, ")
 							  _T("ppSession: %p{Session**}\n"), 
 							  GetBidId(),
@@ -2302,7 +2446,7 @@ DWORD Smux::GetSessionFromId( USHORT SessionId, __out Session **ppSession )
 
 	a_csSessionList.Leave(); 
 
-	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+	BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
 	
 	return dwRet;
 }
@@ -2465,7 +2609,8 @@ DWORD Smux::GetWholePacket( __inout SNI_Packet **ppPacket, __out SNI_Packet **pp
 // Function: Smux::GrowSessionList
 //
 // Description:
-//	Increase the size of the Session array by one.  
+//	Make room for one more session ID (m_MaxSessions).  The array 
+//	itself grows geometrically, so most calls do not reallocate.  
 //
 // Assumptions:
 //	- Called while holding the m_SmuxCS and m_SessionListCS critical 
@@ -2497,7 +2642,28 @@ DWORD Smux::GrowSessionList()
 		return ERROR_INVALID_STATE;
 	}
 	
-	rgNewSessions = NewNoX(gpmo) Session * [m_MaxSessions+1];
+	Assert( m_MaxSessions <= m_cSessionSlots );
+
+	if( m_MaxSessions < m_cSessionSlots )
+	{
+		// Entries past m_MaxSessions are kept NULL
+		Assert( !m_rgSessions[m_MaxSessions] );
+		m_MaxSessions++;
+
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+		return ERROR_SUCCESS;
+	}
+
+	// Double the array, up to one entry per possible session ID
+	DWORD cNewSlots = m_cSessionSlots ? 2 * m_cSessionSlots : 4;
+
+	if( USHRT_MAX + 1 < cNewSlots )
+	{
+		cNewSlots = USHRT_MAX + 1;
+	}
+
+	rgNewSessions = NewNoX(gpmo) Session * [cNewSlots];
 	if( !rgNewSessions )
 	{
 		SNI_SET_LAST_ERROR( SMUX_PROV, SNIE_4, ERROR_OUTOFMEMORY );
@@ -2508,10 +2674,12 @@ DWORD Smux::GrowSessionList()
 	}
 	
 	memcpy(rgNewSessions, m_rgSessions, m_MaxSessions*sizeof(Session *));
-	rgNewSessions[m_MaxSessions++]=0;
+	memset(rgNewSessions + m_MaxSessions, 0, (cNewSlots - m_MaxSessions)*sizeof(Session *));
+	m_MaxSessions++;
 	delete [] m_rgSessions;
 
 	m_rgSessions = rgNewSessions;
+	m_cSessionSlots = cNewSlots;
 
 	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
 	
@@ -2774,6 +2942,8 @@ DWORD  Smux::OpenSession(__out SNI_Conn *pConn, __out SNI_Provider ** ppProv)
 	
 	Assert(m_nSessions<=m_MaxSessions);
 	
+	USHORT SessionId = (USHORT) m_MaxSessions;
+	
 	if(m_nSessions==m_MaxSessions)	//if we don't have extra room for a new session then allocate
 	{
 		dwRet = GrowSessionList();
@@ -2781,16 +2951,18 @@ DWORD  Smux::OpenSession(__out SNI_Conn *pConn, __out SNI_Provider ** ppProv)
 		{
 			goto ErrorExit;
 		}
+
+		// All lower IDs are in use, so the new ID is the one we just added
 	}
-	
-	USHORT SessionId = (USHORT) m_MaxSessions;
-	
-	for ( DWORD i=0; i<m_MaxSessions; i++)
+	else
 	{
-		if( !m_rgSessions[i] )	//pick the first unused session number
+		for ( DWORD i=0; i<m_MaxSessions; i++)
 		{
-			SessionId = (USHORT)i;
-			break;
+			if( !m_rgSessions[i] )	//pick the first unused session number
+			{
+				SessionId = (USHORT)i;
+				break;
+			}
 		}
 	}
 	
@@ -3258,6 +3430,7 @@ Smux::Smux(SNI_Conn *pConn):SNI_Provider( pConn )
 
 	m_nSessions = 0;
 	m_MaxSessions=0;
+	m_cSessionSlots = 0;
 	m_rgSessions = NULL;
 
 	m_cClosed = 0;
@@ -72,6 +72,13 @@ BID_METATEXT( _T("<ApiGroupRange|SNI> 0x0003F000"));
 //
 BID_METATEXT( _T("<ApiGroup|SNI> 0x00020000: SNI component"));
 
+// !!! Important: the bits specified below must match 
+// BIDX_APIGROUP_SNI_SCOPE_SAMPLE and BIDX_APIGROUP_SNI_SCOPE_STATS 
+// defined in sni_common.hpp.  
+//
+BID_METATEXT( _T("<ApiGroup|SNI|SCOPE_SAMPLE> 0x00004000: SNI scope sampling and rate limiting"));
+BID_METATEXT( _T("<ApiGroup|SNI|SCOPE_STATS> 0x00008000: SNI per-scope call counts and durations"));
+
 
 // Type definitions
 
@@ -93,7 +100,26 @@ DWORD	gnWorkerThreadCount = 0;
 HANDLE	rghWorkerThreads[64];
 SNIMemObj	  * gpmo		= NULL;
 
+// Number of SNIAsyncWait threads to start on the IOCP (see 
+// SNISetAsyncWaitThreadCount), and the number actually started.  The 
+// cap leaves room in rghWorkerThreads for the VIA worker threads.
+#define MAX_ASYNC_WAIT_THREADS	32
+DWORD	gnAsyncWaitThreadCount = 1;
+DWORD	gnAsyncWaitThreadsStarted = 0;
+
+// Maximum number of completions each AsyncWait thread dequeues per call (see
+// SNISetAsyncWaitBatchSize); 1 keeps the GetQueuedCompletionStatus loop.
+#define MAX_ASYNC_WAIT_BATCH	32
+DWORD	gnAsyncWaitBatchSize = 1;
+
+typedef BOOL (WINAPI * PFNGETQUEUEDCOMPLETIONSTATUSEX)( HANDLE, LPOVERLAPPED_ENTRY, ULONG, PULONG, DWORD, BOOL );
+typedef ULONG (WINAPI * PFNRTLNTSTATUSTODOSERROR)( LONG );
+
+PFNGETQUEUEDCOMPLETIONSTATUSEX	gpfnGetQueuedCompletionStatusEx = NULL;
+PFNRTLNTSTATUSTODOSERROR		gpfnRtlNtStatusToDosError = NULL;
+
 DWORD WINAPI SNIAsyncWait (PVOID);
+DWORD WINAPI SNIAsyncWaitBatched (PVOID);
 
 
 #ifdef SNIX
@@ -827,6 +853,19 @@ ISOSHost_MemObj * g_pMO	 = NULL; 	// Global memory object
 #endif
 
 SNIMemRegion * SNIMemRegion::s_rgClientMemRegion = 0;
+SNIMemRegion::PFNGETCURRENTPROCESSORNUMBER SNIMemRegion::s_pfnGetCurrentProcessorNumber = NULL;
+
+C_ASSERT( 7 == MAX_MEM_TAGS );
+DWORD SNIMemRegion::s_rgcMagazineSize[MAX_MEM_TAGS] = 
+{
+	DEFAULT_PACKET_MAGAZINE_SIZE,	// REG_0K
+	DEFAULT_PACKET_MAGAZINE_SIZE,	// REG_4K
+	DEFAULT_PACKET_MAGAZINE_SIZE,	// REG_8K
+	DEFAULT_PACKET_MAGAZINE_SIZE,	// REG_16K
+	DEFAULT_PACKET_MAGAZINE_SIZE,	// REG_32K
+	DEFAULT_PACKET_MAGAZINE_SIZE,	// REG_64K
+	DEFAULT_PACKET_MAGAZINE_SIZE,	// REG_MAX
+};
 SOS_Node SOS_Node::s_ClientCurrentNode;
 SOS_Task SOS_Task::s_ClientTask;
 
@@ -1322,16 +1361,59 @@ DWORD SNIInitializeEx(void * pmo,
 			goto ErrorExit;
 		}
 		
+		// Use batched dequeues only if the OS has GetQueuedCompletionStatusEx
+		WaitThreadRoutine pfnAsyncWait = SNIAsyncWait;
+
+		if( 1 < gnAsyncWaitBatchSize )
+		{
+			WIN2K3_DEPENDENCY("Call GetQueuedCompletionStatusEx and RtlNtStatusToDosError directly")
+			HMODULE hKernel32 = GetModuleHandleW( L"kernel32.dll" );
+			HMODULE hNtdll = GetModuleHandleW( L"ntdll.dll" );
+
+			if( hKernel32 && hNtdll )
+			{
+				gpfnGetQueuedCompletionStatusEx = (PFNGETQUEUEDCOMPLETIONSTATUSEX) GetProcAddress( hKernel32, "GetQueuedCompletionStatusEx" );
+				gpfnRtlNtStatusToDosError = (PFNRTLNTSTATUSTODOSERROR) GetProcAddress( hNtdll, "RtlNtStatusToDosError" );
+			}
+
+			if( gpfnGetQueuedCompletionStatusEx && gpfnRtlNtStatusToDosError )
+			{
+				pfnAsyncWait = SNIAsyncWaitBatched;
+			}
+			else
+			{
+				BidTraceU0( SNI_BID_TRACE_ON, SNI_TAG _T("GetQueuedCompletionStatusEx not available, batched dequeue disabled.\n"));
+			}
+		}
+		
 		// Start at least one AsyncWait thread 
 		// Note: We need to do this before init'ing providers, since some mite interact with 
 		// the IOCP during their init procedures
 
-		dwError = SNICreateWaitThread(SNIAsyncWait, NULL);
+		dwError = SNICreateWaitThread(pfnAsyncWait, NULL);
 		
 		if( ERROR_SUCCESS != dwError )
 		{
 			goto ErrorExit;
 		}
+
+		gnAsyncWaitThreadsStarted = 1;
+
+		// Any additional AsyncWait threads are best effort - if one cannot
+		// be created we keep running with the ones we have
+		while( gnAsyncWaitThreadsStarted < gnAsyncWaitThreadCount )
+		{
+			DWORD dwThreadError = SNICreateWaitThread(pfnAsyncWait, NULL);
+
+			if( ERROR_SUCCESS != dwThreadError )
+			{
+				BidTrace2( ERROR_TAG _T("Started %d AsyncWait threads: %d{WINERR}\n"), 
+							gnAsyncWaitThreadsStarted, dwThreadError);
+				break;
+			}
+
+			gnAsyncWaitThreadsStarted++;
+		}
 	}
 #endif	// #ifdef SNI_BASED_CLIENT
 
@@ -1571,9 +1653,12 @@ DWORD SNITerminate()
 		Assert( !g_fTerminate );
 		g_fTerminate = true;
 
-		// We create only one WaitThread - so do a PostQCS to indicate
-		// we are shutting down
-		PostQueuedCompletionStatus( ghIoCompletionPort, 0, 0, 0);
+		// Each AsyncWait thread exits on the first empty completion it 
+		// dequeues, so post one per thread to indicate we are shutting down
+		for( DWORD i=0; i<gnAsyncWaitThreadsStarted; i++)
+			PostQueuedCompletionStatus( ghIoCompletionPort, 0, 0, 0);
+
+		gnAsyncWaitThreadsStarted = 0;
 	}
 
 	if( gnWorkerThreadCount )
@@ -2676,6 +2761,12 @@ void SNIReadDone(LPVOID pVoid)
 	// Fix the packet's bytes correctly - we need this only for Reads
 	Assert(SNIPacketGetBufferSize(pPacket) + dwBytes >= dwBytes);
 	SNIPacketSetBufferSize(pPacket, SNIPacketGetBufferSize(pPacket) + dwBytes);
+
+	if( ERROR_SUCCESS == dwError )
+	{
+		InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.RecdBytes, dwBytes);
+	}
+
 	SNI_TRY
 	{
 
@@ -2768,6 +2859,11 @@ void SNIWriteDone(LPVOID pVoid)
 	// For writes, the packet already has the correct number of bytes
 	// set.
 
+	if( ERROR_SUCCESS == dwError )
+	{
+		InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.SentBytes, dwBytes);
+	}
+
 	// Call Provider's WriteDone function
 	DWORD dwProvError = pConn->m_pProvHead->WriteDone(&pPacket, dwBytes, dwError);
 	
@@ -2845,6 +2941,7 @@ DWORD SNIReadAsync( __out_opt SNI_Conn    * pConn,
 		if( *ppNewPacket && (ERROR_SUCCESS == dwError) )
 		{
 			InterlockedIncrement((LONG *) &pConn->m_ConnInfo.RecdPackets);
+			InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.RecdBytes, SNIPacketGetBufferSize(*ppNewPacket));
 			SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_ReadDone );
 		}
 		
@@ -2881,6 +2978,7 @@ DWORD SNIReadSync( 	__in SNI_Conn    * pConn,
 	if( *ppNewPacket && (ERROR_SUCCESS == dwError) )
 	{
 		InterlockedIncrement((LONG *) &pConn->m_ConnInfo.RecdPackets);
+		InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.RecdBytes, SNIPacketGetBufferSize(*ppNewPacket));
 		SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_ReadDone );
 	}
 	
@@ -2889,6 +2987,97 @@ DWORD SNIReadSync( 	__in SNI_Conn    * pConn,
 	return dwError;
 }
 
+//----------------------------------------------------------------------------
+// NAME: SNIReadSyncMultiple
+//  
+// PURPOSE:
+//		Reads up to cMaxPackets packets, or until at least cbMaxBytes bytes 
+//		have been read, in one call.  Only the first read waits (up to 
+//		timeout); after that, packets are only added while they are already 
+//		available, i.e. while a read with a zero timeout succeeds.  
+//
+// PARAMETERS:
+//		ppPacketChain: the packets read, linked with SNIPacketSetNext in the 
+//			order they were received.  The caller walks the chain with 
+//			SNIPacketGetNext, and unlinks and releases each packet.  
+//		cMaxPackets: at most this many packets are returned; must be non-zero.  
+//		cbMaxBytes: stop once this many bytes were read; 0 means no limit.  
+//		pcPackets: number of packets in the chain.  
+//	
+// RETURNS:
+//		The result of the first read.  Later reads only end the batch: a 
+//		timed-out read stays pending in the providers and completes on the 
+//		next read, and other errors are returned by the next read as well.  
+//  
+//----------------------------------------------------------------------------
+DWORD SNIReadSyncMultiple( 	__in SNI_Conn    * pConn,
+							__out SNI_Packet ** ppPacketChain,
+							DWORD		  cMaxPackets, 
+							DWORD		  cbMaxBytes, 
+							int           timeout, 
+							__out DWORD * pcPackets )	
+{
+	BidxScopeAutoSNI5( SNIAPI_TAG _T("%u#{SNI_Conn}, ")
+							  _T("ppPacketChain: %p{SNI_Packet**}, ")
+							  _T("cMaxPackets: %u, ")
+							  _T("cbMaxBytes: %u, ")
+							  _T("timeout: %d\n"), 
+							  pConn->GetBidId(), 
+							  ppPacketChain, 
+							  cMaxPackets, 
+							  cbMaxBytes, 
+							  timeout);
+
+	*ppPacketChain = NULL;
+	*pcPackets = 0;
+
+	Assert( 0 != cMaxPackets );
+
+	SNI_Packet * pTail = NULL;
+	DWORD cbRead = 0;
+	DWORD dwError = SNIReadSync( pConn, ppPacketChain, timeout );
+
+	if( ERROR_SUCCESS == dwError )
+	{
+		pTail = *ppPacketChain;
+		cbRead = SNIPacketGetBufferSize( pTail );
+		*pcPackets = 1;
+	}
+
+	while( ERROR_SUCCESS == dwError && 
+		*pcPackets < cMaxPackets && 
+		(0 == cbMaxBytes || cbRead < cbMaxBytes) )
+	{
+		SNI_Packet * pPacket = NULL;
+
+		if( ERROR_SUCCESS != pConn->m_pProvHead->ReadSync( &pPacket, 0 ) )
+		{
+			// Nothing more is available right now (or the read failed, and 
+			// the caller will see that on its next read).  The batch that 
+			// was read is still good.  
+			Assert( NULL == pPacket );
+			break;
+		}
+
+		InterlockedIncrement((LONG *) &pConn->m_ConnInfo.RecdPackets);
+		InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.RecdBytes, SNIPacketGetBufferSize(pPacket));
+
+		SNIPacketSetNext( pTail, pPacket );
+		pTail = pPacket;
+		cbRead += SNIPacketGetBufferSize( pPacket );
+		(*pcPackets)++;
+	}
+
+	if( ERROR_SUCCESS == dwError && 1 < *pcPackets )
+	{
+		SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_ReadDone );
+	}
+
+	BidTraceU3( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}, packets: %u, bytes: %u\n"), dwError, *pcPackets, cbRead);
+	
+	return dwError;
+}
+
 DWORD SNICheckConnection(__in SNI_Conn* pConn)
 {
 	BidxScopeAutoSNI2( SNIAPI_TAG _T("%u#{SNI_Conn}, ")
@@ -2921,6 +3110,8 @@ DWORD SNIPartialReadAsync( __out_opt SNI_Conn     * pConn,
 							  cbBytesToRead, 
 							  pProvInfo);
 	
+	InterlockedIncrement((LONG *) &pConn->m_ConnInfo.PartialReads);
+
 	// Increment the refcount
 	pConn->AddRef( REF_Read );
 
@@ -2934,6 +3125,7 @@ DWORD SNIPartialReadAsync( __out_opt SNI_Conn     * pConn,
 		if( ERROR_SUCCESS == dwError )
 		{
 			InterlockedIncrement((LONG *) &pConn->m_ConnInfo.RecdPackets);
+			InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.RecdBytes, cbBytesToRead);
 			SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_ReadDone );
 		}
 		
@@ -2963,6 +3155,8 @@ DWORD SNIPartialReadSync(	__in SNI_Conn	* pConn,
 	
 	DWORD 	dwError;
 
+	InterlockedIncrement((LONG *) &pConn->m_ConnInfo.PartialReads);
+
 	dwError = pConn->m_pProvHead->PartialReadSync( pOldPacket, cbBytesToRead, timeout );
 
 	Assert( ERROR_IO_PENDING != dwError );
@@ -2970,6 +3164,7 @@ DWORD SNIPartialReadSync(	__in SNI_Conn	* pConn,
 	if( ERROR_SUCCESS == dwError )
 	{
 		InterlockedIncrement((LONG *) &pConn->m_ConnInfo.RecdPackets);
+		InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.RecdBytes, cbBytesToRead);
 		SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_ReadDone );
 	}
 
@@ -3002,6 +3197,9 @@ DWORD SNIWriteAsync( __out_opt SNI_Conn     * pConn,
 	SNIPacketAddRef( pPacket );
 #endif
 
+	// Taken before the providers add headers or encrypt in place.
+	DWORD cbPacket = SNIPacketGetBufferSize(pPacket);
+
 	// Call next Provider's WriteAsync function
 	DWORD dwError;
 
@@ -3022,6 +3220,7 @@ DWORD SNIWriteAsync( __out_opt SNI_Conn     * pConn,
 		if( ERROR_SUCCESS == dwError )
 		{
 			InterlockedIncrement((LONG *) &pConn->m_ConnInfo.SentPackets);
+			InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.SentBytes, cbPacket);
 			SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_WriteDone );
 		}
 		
@@ -3052,12 +3251,14 @@ DWORD SNIWriteSync( 	__in SNI_Conn     * pConn,
 							  pProvInfo);
 	
 	DWORD dwError;
+	DWORD cbPacket = SNIPacketGetBufferSize(pPacket);
 	
 	dwError = pConn->m_pProvHead->WriteSync( pPacket, pProvInfo );
 
 	if( ERROR_SUCCESS == dwError )
 	{
 		InterlockedIncrement((LONG *) &pConn->m_ConnInfo.SentPackets);
+		InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.SentBytes, cbPacket);
 		SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_WriteDone );
 	}
 	
@@ -3089,6 +3290,13 @@ DWORD SNIGatherWriteAsync( __out_opt SNI_Conn     * pConn,
 	// Increment the refcount
 	pConn->AddRef( REF_Write );
 
+	ULONGLONG cbChain = 0;
+
+	for( SNI_Packet * pTmp = pPacket; NULL != pTmp; pTmp = SNIPacketGetNext(pTmp) )
+	{
+		cbChain += SNIPacketGetBufferSize(pTmp);
+	}
+
 	// Call next Provider's WriteAsync function
 	dwError = pConn->m_pProvHead->GatherWriteAsync(pPacket, pProvInfo);
 
@@ -3098,6 +3306,7 @@ DWORD SNIGatherWriteAsync( __out_opt SNI_Conn     * pConn,
 		if( ERROR_SUCCESS == dwError )
 		{
 			InterlockedIncrement((LONG *) &pConn->m_ConnInfo.SentPackets);
+			InterlockedExchangeAdd64((LONGLONG *) &pConn->m_ConnInfo.SentBytes, cbChain);
 			SNITime::GetTick( &pConn->m_ConnInfo.Timer.m_WriteDone );
 		}
 		
@@ -3198,6 +3407,23 @@ DWORD SNIQueryInfo(  UINT QType, __out VOID * pbQInfo)
 
 			*(BOOL *)pbQInfo = Tcp::s_fSkipCompletionPort;
 			break;
+
+		case SNI_QUERY_PACKET_CACHE_STATS:
+
+			if( NULL == SNIMemRegion::s_rgClientMemRegion )
+			{
+				dwErr = ERROR_INVALID_STATE;
+				SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_10, dwErr );
+				break;
+			}
+
+			{
+				SNI_PACKET_CACHE_STATS * pStats = (SNI_PACKET_CACHE_STATS *)pbQInfo;
+				DWORD MemTag = SNIMemRegion::GetMemoryTag( pStats->cbBuffer );
+
+				SNIMemRegion::s_rgClientMemRegion[MemTag].GetMagazineStats( pStats );
+			}
+			break;
 #endif
 
 		default:
@@ -3649,6 +3875,28 @@ DWORD SNIGetInfo( __in SNI_Conn * pConn, UINT QType, __out VOID * pbQInfo)
 			}
 			break;
 
+#ifdef SNI_BASED_CLIENT
+		case SNI_QUERY_CONN_OPEN_TIMINGS:
+
+			memcpy(pbQInfo, (void*) &pConn->m_ConnInfo.OpenTimings, sizeof(SNI_OPEN_TIMINGS));
+
+			break;
+
+		case SNI_QUERY_CONN_IO_STATS:
+
+			{
+				SNI_CONN_IO_STATS * pStats = (SNI_CONN_IO_STATS *)pbQInfo;
+
+				pStats->cbSent = InterlockedCompareExchange64((LONGLONG *) &pConn->m_ConnInfo.SentBytes, 0, 0);
+				pStats->cbRecd = InterlockedCompareExchange64((LONGLONG *) &pConn->m_ConnInfo.RecdBytes, 0, 0);
+				pStats->cPacketsSent = InterlockedCompareExchange((LONG *) &pConn->m_ConnInfo.SentPackets, 0, 0);
+				pStats->cPacketsRecd = InterlockedCompareExchange((LONG *) &pConn->m_ConnInfo.RecdPackets, 0, 0);
+				pStats->cPartialReads = InterlockedCompareExchange((LONG *) &pConn->m_ConnInfo.PartialReads, 0, 0);
+			}
+
+			break;
+#endif
+
 		default:
 			//this assertion is used to catch unexpected coding errors.
 			Assert( 0 && " QType is unknown\n" );
@@ -4063,9 +4311,224 @@ DWORD SNIRemoveProvider(__inout SNI_Conn * pConn, ProviderNum ProvNum)
 
 }
 
+// Scope sampling and statistics; see SNI_SCOPE_SITE in sni_common.hpp.  
+// g_dwScopeSampleRate of 1 and g_dwScopeMaxPerSec of 0 trace every scope.  
+//
+static DWORD g_dwScopeSampleRate = 1;
+static DWORD g_dwScopeMaxPerSec = 0;
+static volatile LONG g_cScopeWindowCount = 0;
+static volatile DWORD g_dwScopeWindowStart = 0;
+static SNI_SCOPE_SITE * volatile g_pScopeSites = NULL;
+
+// Called only when both scope tracing and the BIDX_APIGROUP_SNI_SCOPE_SAMPLE 
+// bit are on, so it is kept out of line.  
+//
+BOOL SNIScopeSample( SNI_SCOPE_SITE * pSite )
+{
+	DWORD dwRate = g_dwScopeSampleRate;
+	DWORD dwMaxPerSec = g_dwScopeMaxPerSec;
+
+	if( 1 < dwRate && 
+		0 != ((DWORD) InterlockedIncrement( &pSite->cSampleTick ) % dwRate) )
+	{
+		return FALSE;
+	}
+
+	if( 0 != dwMaxPerSec )
+	{
+		// The bucket holds dwMaxPerSec tokens and is refilled once a 
+		// second.  Races on the refill only let a few extra scopes through.  
+		//
+		DWORD dwNow = GetTickCount();
+		DWORD dwStart = g_dwScopeWindowStart;
+
+		if( 1000 <= (DWORD)(dwNow - dwStart) && 
+			dwStart == (DWORD) InterlockedCompareExchange( (LONG volatile *) &g_dwScopeWindowStart, (LONG) dwNow, (LONG) dwStart ) )
+		{
+			InterlockedExchange( &g_cScopeWindowCount, 0 );
+		}
+
+		if( dwMaxPerSec < (DWORD) InterlockedIncrement( &g_cScopeWindowCount ) )
+		{
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+void SNIScopeRecord( SNI_SCOPE_SITE * pSite, const LARGE_INTEGER * pliStart )
+{
+	LARGE_INTEGER liEnd;
+
+	QueryPerformanceCounter( &liEnd );
+
+	InterlockedIncrement( &pSite->cCalls );
+	InterlockedExchangeAdd64( &pSite->llTicks, liEnd.QuadPart - pliStart->QuadPart );
+
+	// Add the site to the list on its first call.  
+	//
+	if( 0 == pSite->fListed && 0 == InterlockedExchange( &pSite->fListed, 1 ) )
+	{
+		SNI_SCOPE_SITE * pHead;
+
+		do
+		{
+			pHead = g_pScopeSites;
+			pSite->pNext = pHead;
+		}
+		while( pHead != InterlockedCompareExchangePointer( (PVOID volatile *) &g_pScopeSites, pSite, pHead ) );
+	}
+}
+
+// Opt-in: with BIDX_APIGROUP_SNI_SCOPE_SAMPLE on, trace one BidxScopeAutoSNI 
+// scope in dwSampleRate per call site, and at most dwMaxPerSec of them a 
+// second overall; 0 or 1 samples every call, and 0 removes the rate limit.  
+//
+DWORD SNISetScopeSampling( DWORD dwSampleRate, DWORD dwMaxPerSec )
+{
+	BidxScopeAutoSNI2( SNIAPI_TAG _T( "dwSampleRate: %u, dwMaxPerSec: %u\n"), dwSampleRate, dwMaxPerSec);
+
+	g_dwScopeSampleRate = ( 0 == dwSampleRate ) ? 1 : dwSampleRate;
+	g_dwScopeMaxPerSec = dwMaxPerSec;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+
+	return ERROR_SUCCESS;
+}
+
+// Traces the call count and total duration of every BidxScopeAutoSNI site 
+// that has run with BIDX_APIGROUP_SNI_SCOPE_STATS on; fReset zeroes them.  
+//
+DWORD SNIDumpScopeStats( BOOL fReset )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "fReset: %d{BOOL}\n"), fReset);
+
+	LARGE_INTEGER liFreq;
+
+	if( !QueryPerformanceFrequency( &liFreq ) || 0 == liFreq.QuadPart )
+	{
+		liFreq.QuadPart = 1000000;
+	}
+
+	for( SNI_SCOPE_SITE * pSite = g_pScopeSites; NULL != pSite; pSite = pSite->pNext )
+	{
+		LONG cCalls = fReset ? InterlockedExchange( &pSite->cCalls, 0 ) : pSite->cCalls;
+		LONGLONG llTicks = fReset ? InterlockedExchange64( &pSite->llTicks, 0 ) : pSite->llTicks;
+		ULONGLONG ullMicrosec = (ULONGLONG)( llTicks * 1000000 / liFreq.QuadPart );
+
+		if( pSite->fWide )
+		{
+			BidTraceU3( SNI_BID_TRACE_ON, SNI_TAG _T("calls: %d, total: %I64u us, site: %ls"), 
+				cCalls, ullMicrosec, (LPCWSTR) pSite->pvStf);
+		}
+		else
+		{
+			BidTraceU3( SNI_BID_TRACE_ON, SNI_TAG _T("calls: %d, total: %I64u us, site: %hs"), 
+				cCalls, ullMicrosec, (LPCSTR) pSite->pvStf);
+		}
+	}
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+
+	return ERROR_SUCCESS;
+}
+
 // Threads which will wait on IOCP
 #ifdef SNI_BASED_CLIENT
 
+// Sets the number of SNIAsyncWait threads that will service the IOCP.
+// Must be called before SNIInitialize; 0 means one thread per processor.  
+// The default is a single thread, which serializes all completion callbacks; 
+// callers asking for more must be able to handle concurrent completions.
+DWORD SNISetAsyncWaitThreadCount( DWORD cThreads )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "cThreads: %d\n"), cThreads);
+
+	if( NULL != ghIoCompletionPort )
+	{
+		SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_10, ERROR_INVALID_STATE );
+
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_INVALID_STATE);
+		
+		return ERROR_INVALID_STATE;
+	}
+
+	if( 0 == cThreads )
+	{
+		SYSTEM_INFO si;
+		
+		GetSystemInfo( &si );
+		cThreads = si.dwNumberOfProcessors;
+	}
+
+	if( 0 == cThreads )
+		cThreads = 1;
+	else if( MAX_ASYNC_WAIT_THREADS < cThreads )
+		cThreads = MAX_ASYNC_WAIT_THREADS;
+
+	gnAsyncWaitThreadCount = cThreads;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+// Sets the maximum number of completions each SNIAsyncWait thread dequeues
+// per system call.  Must be called before SNIInitialize; 1 (the default)
+// dequeues one completion at a time.  Batching needs 
+// GetQueuedCompletionStatusEx - without it SNI silently uses single dequeues.
+DWORD SNISetAsyncWaitBatchSize( DWORD cEntries )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "cEntries: %d\n"), cEntries);
+
+	if( NULL != ghIoCompletionPort )
+	{
+		SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_10, ERROR_INVALID_STATE );
+
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_INVALID_STATE);
+		
+		return ERROR_INVALID_STATE;
+	}
+
+	if( 0 == cEntries )
+		cEntries = 1;
+	else if( MAX_ASYNC_WAIT_BATCH < cEntries )
+		cEntries = MAX_ASYNC_WAIT_BATCH;
+
+	gnAsyncWaitBatchSize = cEntries;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+// Sets how many packets each per-processor cache holds for the memory region
+// that serves packets of cbBuffer bytes.  Must be called before SNIInitialize;
+// 0 disables the per-processor caches for that region.
+DWORD SNISetPacketCacheMagazineSize( DWORD cbBuffer, DWORD cPackets )
+{
+	BidxScopeAutoSNI2( SNIAPI_TAG _T( "cbBuffer: %d, cPackets: %d\n"), cbBuffer, cPackets);
+
+	if( NULL != SNIMemRegion::s_rgClientMemRegion )
+	{
+		SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_10, ERROR_INVALID_STATE );
+
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_INVALID_STATE);
+		
+		return ERROR_INVALID_STATE;
+	}
+
+	if( MAX_PACKET_MAGAZINE_SIZE < cPackets )
+		cPackets = MAX_PACKET_MAGAZINE_SIZE;
+
+	SNIMemRegion::s_rgcMagazineSize[SNIMemRegion::GetMemoryTag( cbBuffer )] = cPackets;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
 DWORD WINAPI SNIAsyncWait (PVOID)
 {
 	BidxScopeAutoSNI0( SNIAPI_TAG _T( "\n"));
@@ -4074,6 +4537,7 @@ DWORD WINAPI SNIAsyncWait (PVOID)
 	DWORD dwBytesTransferred;
 	ULONG_PTR ulKey;
 	DWORD dwError;
+	DWORD cCompletions = 0;
 
 	while(true)
 	{
@@ -4118,10 +4582,14 @@ DWORD WINAPI SNIAsyncWait (PVOID)
 				BidTrace0( ERROR_TAG _T("System call GetQueuedCompletionStatus failed\n") );
 				continue;
 			}
+
+			BidTraceU1( SNI_BID_TRACE_ON, SNI_TAG _T("Completions processed: %d\n"), cCompletions);
 			
 			return ERROR_SUCCESS;
 		}
 
+		cCompletions++;
+
 		// Update SOS_IOCompRequest and call IO Completion Routine
 		//
 		pSOSIo->SetErrorCode (dwError);
@@ -4135,6 +4603,104 @@ DWORD WINAPI SNIAsyncWait (PVOID)
 	}
 }
 
+// Same as SNIAsyncWait, but dequeues up to gnAsyncWaitBatchSize completions
+// per GetQueuedCompletionStatusEx call
+DWORD WINAPI SNIAsyncWaitBatched (PVOID)
+{
+	BidxScopeAutoSNI0( SNIAPI_TAG _T( "\n"));
+	
+	OVERLAPPED_ENTRY rgEntries[MAX_ASYNC_WAIT_BATCH];
+	ULONG cEntries;
+	DWORD cCompletions = 0;
+	DWORD cDequeues = 0;
+	ULONG cMaxBatch = 0;
+
+	Assert( gnAsyncWaitBatchSize <= RTL_NUMBER_OF(rgEntries) );
+
+	while(true)
+	{
+		cEntries = 0;
+
+		// Unlike GetQueuedCompletionStatus, a failed I/O does not fail this 
+		// call - its status comes back in the entry.  A failure here means
+		// nothing was dequeued.
+		if( 0 == gpfnGetQueuedCompletionStatusEx( ghIoCompletionPort,
+											rgEntries,
+											gnAsyncWaitBatchSize,
+											&cEntries,
+											INFINITE,
+											FALSE) )
+		{
+			if( !g_fTerminate )
+			{
+				//This assertion is used to catch unexpected system call errors.
+				Assert( 0 && " System call GetQueuedCompletionStatusEx failed\n" );
+				BidTrace1( ERROR_TAG _T("System call GetQueuedCompletionStatusEx failed: %d{WINERR}\n"), GetLastError() );
+				continue;
+			}
+
+			BidTraceU3( SNI_BID_TRACE_ON, SNI_TAG _T("Completions processed: %d, dequeues: %d, largest batch: %d\n"), 
+						cCompletions, cDequeues, cMaxBatch);
+			
+			return ERROR_SUCCESS;
+		}
+
+		cDequeues++;
+
+		if( cMaxBatch < cEntries )
+			cMaxBatch = cEntries;
+
+		DWORD cWakeups = 0;
+
+		for( ULONG i = 0; i < cEntries; i++ )
+		{
+			SOS_IOCompRequest * pSOSIo = (SOS_IOCompRequest *) rgEntries[i].lpOverlapped;
+
+			if( !pSOSIo )
+			{
+				cWakeups++;
+				continue;
+			}
+
+			// The entry carries the packet's NTSTATUS - translate it to the 
+			// error GetQueuedCompletionStatus would have reported
+			LONG status = (LONG) rgEntries[i].Internal;
+			DWORD dwError = ( 0 <= status ) ? ERROR_SUCCESS : gpfnRtlNtStatusToDosError( status );
+
+			cCompletions++;
+
+			// Update SOS_IOCompRequest and call IO Completion Routine
+			//
+			pSOSIo->SetErrorCode (dwError);
+			pSOSIo->SetActualBytes (rgEntries[i].dwNumberOfBytesTransferred);
+
+			// See SNIAsyncWait about SNI_Accept
+			(SNIPacketCompFunc((SNI_Packet *)pSOSIo))( pSOSIo );
+		}
+
+		if( cWakeups )
+		{
+			if( !g_fTerminate )
+			{
+				//This assertion is used to catch unexpected empty completions.
+				Assert( 0 && " Empty completion dequeued\n" );
+				BidTrace0( ERROR_TAG _T("Empty completion dequeued\n") );
+				continue;
+			}
+
+			// Each AsyncWait thread needs one shutdown completion, so keep 
+			// one and hand back any others this batch picked up
+			for( DWORD i = 1; i < cWakeups; i++ )
+				PostQueuedCompletionStatus( ghIoCompletionPort, 0, 0, 0);
+
+			BidTraceU3( SNI_BID_TRACE_ON, SNI_TAG _T("Completions processed: %d, dequeues: %d, largest batch: %d\n"), 
+						cCompletions, cDequeues, cMaxBatch);
+
+			return ERROR_SUCCESS;
+		}
+	}
+}
+
 // Spawn completion threads to call the specified function to wait on
 DWORD SNICreateWaitThread( WaitThreadRoutine pfnAsyncWait, PVOID pParam )
 {	
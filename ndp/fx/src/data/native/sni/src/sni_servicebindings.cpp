@@ -41,6 +41,27 @@ LPWSTR *SNI_ServiceBindings::s_pwszSPN = NULL;
 DWORD   SNI_ServiceBindings::s_dwcSPN = 0;
 
 #pragma endregion Members
+
+// The host name, address and Approved List arrays are sorted once, when they 
+// are set, so that matching a client-supplied target on every login is a 
+// binary search rather than a scan of every entry.  Names are ordered with 
+// the same locale-aware, case-insensitive compare that decides a match.
+
+static int __cdecl CompareNames(const void *pvName1, const void *pvName2)
+{
+	return _wcsicmp_l(*(const LPWSTR *)pvName1, *(const LPWSTR *)pvName2, GetDefaultLocale());
+}
+
+static int __cdecl CompareIPv4Addresses(const void *pvAddress1, const void *pvAddress2)
+{
+	return memcmp(pvAddress1, pvAddress2, sizeof(struct in_addr));
+}
+
+static int __cdecl CompareIPv6Addresses(const void *pvAddress1, const void *pvAddress2)
+{
+	return memcmp(pvAddress1, pvAddress2, sizeof(struct in6_addr));
+}
+
 #endif // ifndef SNIX
 
 #pragma region Public
@@ -319,6 +340,9 @@ DWORD SNI_ServiceBindings::SetClusterAddresses(__in ADDRINFOW *paiwClusterAddres
 				break;
 		}
 	}
+
+	qsort(s_piaIPv4Address, s_dwcIPv4Address, sizeof(struct in_addr), CompareIPv4Addresses);
+	qsort(s_pi6aIPv6Address, s_dwcIPv6Address, sizeof(struct in6_addr), CompareIPv6Addresses);
 	
 	Assert( ERROR_SUCCESS == dwRet );
 Exit:
@@ -407,6 +431,8 @@ DWORD SNI_ServiceBindings::SetClusterNames(__in_z LPWSTR wszClusterHostName)
 	wmemcpy(s_pwszHostNames[s_dwcHostNames], s_pwszHostNames[0], cchClusterNetbiosName);
 	s_pwszHostNames[s_dwcHostNames][cchClusterNetbiosName] = L'\0';
 	s_dwcHostNames++;
+
+	qsort(s_pwszHostNames, s_dwcHostNames, sizeof(LPWSTR), CompareNames);
 	
 Exit:
 	if( ERROR_SUCCESS != dwRet )
@@ -453,6 +479,11 @@ DWORD SNI_ServiceBindings::SetHostNamesAndAcceptedSPNs(__in_ecount_opt(dwcAccept
 	s_pwszSPN = pwszAcceptedSPNs;
 	s_dwcSPN = dwcAcceptedSPNs;
 
+	if( NULL != s_pwszSPN )
+	{
+		qsort(s_pwszSPN, s_dwcSPN, sizeof(LPWSTR), CompareNames);
+	}
+
 	if( s_fClusterHostNamesInitialized )
 	{
 		BidTraceU0(SNI_BID_TRACE_ON, SNI_TAG _T("Cluster host names have already been initialized - no need to initialize machine names or IPs.\n"));
@@ -591,6 +622,9 @@ DWORD SNI_ServiceBindings::SetHostNamesAndAcceptedSPNs(__in_ecount_opt(dwcAccept
 		}
 	}
 
+	qsort(s_piaIPv4Address, s_dwcIPv4Address, sizeof(struct in_addr), CompareIPv4Addresses);
+	qsort(s_pi6aIPv6Address, s_dwcIPv6Address, sizeof(struct in6_addr), CompareIPv6Addresses);
+
 	// 2. Host names. Same strategy: count, allocate, and repack.
 
 	// Counting. Retrieve BackConnectionHostNames. If it fails, remap 
@@ -687,6 +721,8 @@ DWORD SNI_ServiceBindings::SetHostNamesAndAcceptedSPNs(__in_ecount_opt(dwcAccept
 		}
 	}
 
+	qsort(s_pwszHostNames, s_dwcHostNames, sizeof(LPWSTR), CompareNames);
+
 Exit:
 	// Always free up the locally-allocated buffers created for BackConnectionHostNames and GetAdaptersAddresses
 	if( NULL != wszBackConnectionHostNames )
@@ -1052,13 +1088,10 @@ DWORD SNI_ServiceBindings::MatchAgainstNameList(__in_z LPWSTR wszHost)
 	Assert( NULL != wszHost );
 	
 	DWORD dwRet = SEC_E_BAD_BINDINGS;
-	for(DWORD dwIndex = 0; dwIndex < s_dwcHostNames; dwIndex++)
+	if( NULL != s_pwszHostNames &&
+		NULL != bsearch(&wszHost, s_pwszHostNames, s_dwcHostNames, sizeof(LPWSTR), CompareNames) )
 	{
-		if (0 == _wcsicmp_l(s_pwszHostNames[dwIndex], wszHost, GetDefaultLocale()))
-		{
-			dwRet = ERROR_SUCCESS;
-			break;
-		}
+		dwRet = ERROR_SUCCESS;
 	}
 
 	if( ERROR_SUCCESS != dwRet )
@@ -1092,13 +1125,11 @@ DWORD SNI_ServiceBindings::MatchAgainstIpv4AddressList(__in PSOCKADDR_STORAGE ps
 	Assert( NULL != psasIpv4Address );
 	
 	DWORD dwRet = SEC_E_BAD_BINDINGS;
-	for(DWORD dwIndex = 0; dwIndex < s_dwcIPv4Address; dwIndex++)
+	if( NULL != s_piaIPv4Address &&
+		NULL != bsearch(& ((PSOCKADDR_IN)(psasIpv4Address))->sin_addr, s_piaIPv4Address, s_dwcIPv4Address, sizeof(struct in_addr), CompareIPv4Addresses) )
 	{
-		if (0 == memcmp(& s_piaIPv4Address[dwIndex], & ((PSOCKADDR_IN)(psasIpv4Address))->sin_addr, sizeof(struct in_addr)))
-		{
-			dwRet = ERROR_SUCCESS;
-			goto Exit;
-		}
+		dwRet = ERROR_SUCCESS;
+		goto Exit;
 	}
 	
 	dwRet = IsIn4AddrLoopback((PSOCKADDR_IN)(psasIpv4Address)) ? ERROR_SUCCESS : dwRet;
@@ -1136,13 +1167,11 @@ DWORD SNI_ServiceBindings::MatchAgainstIpv6AddressList(__in PSOCKADDR_STORAGE ps
 	Assert( NULL != psasIpv6Address );
 	
 	DWORD dwRet = SEC_E_BAD_BINDINGS;
-	for(DWORD dwIndex = 0; dwIndex < s_dwcIPv6Address; dwIndex++)
+	if( NULL != s_pi6aIPv6Address &&
+		NULL != bsearch(& ((PSOCKADDR_IN6)(psasIpv6Address))->sin6_addr, s_pi6aIPv6Address, s_dwcIPv6Address, sizeof(struct in6_addr), CompareIPv6Addresses) )
 	{
-		if (0 == memcmp(& s_pi6aIPv6Address[dwIndex], & ((PSOCKADDR_IN6)(psasIpv6Address))->sin6_addr, sizeof(struct in6_addr)))
-		{
-			dwRet = ERROR_SUCCESS;
-			goto Exit;
-		}
+		dwRet = ERROR_SUCCESS;
+		goto Exit;
 	}
 	
 	dwRet = IsIn6AddrLoopback((PSOCKADDR_IN6)(psasIpv6Address)) ? ERROR_SUCCESS : dwRet;
@@ -1184,13 +1213,10 @@ DWORD SNI_ServiceBindings::MatchApprovedList(__in_z LPWSTR wszSPN)
 	Assert( NULL != wszSPN );
 	
 	DWORD dwRet = SEC_E_BAD_BINDINGS;
-	for(DWORD dwIndex = 0; dwIndex < s_dwcSPN; dwIndex++)
+	if( NULL != s_pwszSPN &&
+		NULL != bsearch(&wszSPN, s_pwszSPN, s_dwcSPN, sizeof(LPWSTR), CompareNames) )
 	{
-		if (0 == _wcsicmp_l(s_pwszSPN[dwIndex], wszSPN, GetDefaultLocale()))
-		{
-			dwRet = ERROR_SUCCESS;
-			break;
-		}
+		dwRet = ERROR_SUCCESS;
 	}
 	
 	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
@@ -81,9 +81,340 @@ static bool s_fServiceBindingsSupported = true;
 
 TCHAR g_szInstanceSPN[SNI_MAX_COMPOSED_SPN] = _T("");
 
+// Outbound credential handles shared by the connections opened under one 
+// logon session with one package, for as long as the handle is valid.  
+// Acquiring one per connection goes to the LSA each time, which right 
+// after a pool clear shows up as ticket cache contention.  A handle stays 
+// usable by the connections holding it after it leaves the cache; the 
+// last of them frees it.  See SNISetSspiCredentialCache.  
+//
+#define SSPI_CRED_CACHE_SIZE 8
+
+typedef struct
+{
+	LUID		LogonId;
+	TCHAR		szPackage[CCHMAXSSP];
+	CredHandle	hCred;
+	TimeStamp	Expiry;
+	LONG		cRef;		// connections using hCred, plus one while fCached
+	bool		fCached;	// can be handed to new connections
+} SspiCredCacheEntry;
+
+static SspiCredCacheEntry g_rgSspiCredCache[SSPI_CRED_CACHE_SIZE];
+static SNICritSec * g_csSspiCredCache = NULL;
+static BOOL g_fSspiCredCache = FALSE;
+
+// Credentials belong to a logon session, so that is the cache key rather 
+// than the token itself: impersonating another token of the same session 
+// gets the same credentials.  
+//
+static BOOL GetCallerLogonId( __out LUID * pLogonId )
+{
+	HANDLE hToken = NULL;
+
+	if( !OpenThreadToken( GetCurrentThread(), TOKEN_QUERY, TRUE, &hToken ) )
+	{
+		if( ERROR_NO_TOKEN != GetLastError() || 
+			!OpenProcessToken( GetCurrentProcess(), TOKEN_QUERY, &hToken ) )
+		{
+			return FALSE;
+		}
+	}
+
+	TOKEN_STATISTICS Stats;
+	DWORD cbStats = 0;
+
+	BOOL fRet = GetTokenInformation( hToken, TokenStatistics, &Stats, sizeof(Stats), &cbStats );
+
+	CloseHandle( hToken );
+
+	if( fRet )
+	{
+		*pLogonId = Stats.AuthenticationId;
+	}
+
+	return fRet;
+}
+
+static bool FSspiCredExpired( __in const SspiCredCacheEntry * pEntry )
+{
+	// SSPI reports credential expiry in local time.  
+	FILETIME ftNow;
+	FILETIME ftLocalNow;
+	ULARGE_INTEGER uliNow;
+
+	GetSystemTimeAsFileTime( &ftNow );
+	
+	if( !FileTimeToLocalFileTime( &ftNow, &ftLocalNow ) )
+	{
+		return true;
+	}
+
+	uliNow.LowPart = ftLocalNow.dwLowDateTime;
+	uliNow.HighPart = ftLocalNow.dwHighDateTime;
+
+	return (ULONGLONG) pEntry->Expiry.QuadPart <= uliNow.QuadPart;
+}
+
+// Called with g_csSspiCredCache held.  Returns true if the caller must 
+// free the entry's handle (a copy of which is left in *phFree) once the 
+// lock is released.  
+//
+static bool SspiCredCacheRelease( __inout SspiCredCacheEntry * pEntry, __out CredHandle * phFree )
+{
+	Assert( 0 < pEntry->cRef );
+
+	if( 0 != --pEntry->cRef )
+	{
+		return false;
+	}
+
+	*phFree = pEntry->hCred;
+	memset( pEntry, 0, sizeof(*pEntry) );
+	SecInvalidateHandle( &pEntry->hCred );
+
+	return true;
+}
+
+// Same contract as the AcquireCredentialsHandle call it replaces; on 
+// success *pfShared says whether the handle must be given back through 
+// SspiReleaseCredentials rather than freed.  
+//
+static DWORD SspiAcquireCredentials( __in TCHAR * pszPackage, 
+									 __out CredHandle * phCred, 
+									 __out BOOL * pfShared )
+{
+	BidxScopeAutoSNI3( SNIAPI_TAG _T("pszPackage: '%s', phCred: %p{CredHandle*}, pfShared: %p{BOOL*}\n"), 
+					pszPackage, phCred, pfShared );
+
+	DWORD dwRet;
+	TimeStamp Lifetime;
+	LUID LogonId;
+	CredHandle hFree;
+	bool fFree = false;
+	SspiCredCacheEntry * pEntry = NULL;
+
+	*pfShared = FALSE;
+
+	// pszPackage is always g_szSSP or one of g_rgszSSP, so it fits.  
+	bool fCache = g_fSspiCredCache && 
+				  NULL != g_csSspiCredCache && 
+				  GetCallerLogonId( &LogonId );
+
+	if( fCache )
+	{
+		CAutoSNICritSec a_csCache( g_csSspiCredCache, SNI_AUTOCS_ENTER );
+
+		for( int i = 0; i < SSPI_CRED_CACHE_SIZE; i++ )
+		{
+			SspiCredCacheEntry * pCur = &g_rgSspiCredCache[i];
+
+			if( !pCur->fCached || 
+				pCur->LogonId.LowPart != LogonId.LowPart ||
+				pCur->LogonId.HighPart != LogonId.HighPart ||
+				_tcsnicmp_l( pCur->szPackage, pszPackage, CCHMAXSSP, GetDefaultLocale() ) )
+			{
+				continue;
+			}
+
+			if( FSspiCredExpired( pCur ) )
+			{
+				pCur->fCached = false;
+				fFree = SspiCredCacheRelease( pCur, &hFree );
+				break;
+			}
+
+			pCur->cRef++;
+			*phCred = pCur->hCred;
+			*pfShared = TRUE;
+			break;
+		}
+
+		a_csCache.Leave(); 
+
+		if( fFree )
+		{
+			g_pFuncs->FreeCredentialsHandle( &hFree );
+			fFree = false;
+		}
+
+		if( *pfShared )
+		{
+			BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("cache hit, %d{WINERR}\n"), SEC_E_OK);
+			return SEC_E_OK;
+		}
+	}
+
+	dwRet = g_pFuncs->AcquireCredentialsHandle( NULL,			// principal
+												 (SEC_TCHAR *) pszPackage, // security package
+												 SECPKG_CRED_OUTBOUND,
+												 NULL,			// LOGON id
+												 NULL,			// auth data
+												 NULL,			// get key fn
+												 NULL,			// get key arg
+												 phCred,
+												 &Lifetime );
+
+	if( SEC_E_OK != dwRet || !fCache )
+	{
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+		return dwRet;
+	}
+
+	// Best effort: with no free slot the handle is simply not shared.  
+	//
+	{
+		CAutoSNICritSec a_csCache( g_csSspiCredCache, SNI_AUTOCS_ENTER );
+
+		for( int i = 0; i < SSPI_CRED_CACHE_SIZE; i++ )
+		{
+			if( 0 == g_rgSspiCredCache[i].cRef )
+			{
+				pEntry = &g_rgSspiCredCache[i];
+				break;
+			}
+		}
+
+		if( NULL != pEntry && g_fSspiCredCache )
+		{
+			pEntry->LogonId = LogonId;
+			int cch;
+
+			for( cch = 0; cch < ARRAYSIZE(pEntry->szPackage) - 1 && pszPackage[cch]; cch++ )
+			{
+				pEntry->szPackage[cch] = pszPackage[cch];
+			}
+			pEntry->szPackage[cch] = 0;
+			pEntry->hCred = *phCred;
+			pEntry->Expiry = Lifetime;
+			pEntry->cRef = 2;
+			pEntry->fCached = true;
+
+			*pfShared = TRUE;
+		}
+
+		a_csCache.Leave(); 
+	}
+
+	BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("shared: %d{BOOL}, %d{WINERR}\n"), *pfShared, dwRet);
+
+	return dwRet;
+}
+
+static void SspiReleaseCredentials( __in CredHandle * phCred )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T("phCred: %p{CredHandle*}\n"), phCred );
+
+	CredHandle hFree;
+	bool fFree = false;
+
+	Assert( NULL != g_csSspiCredCache );
+
+	CAutoSNICritSec a_csCache( g_csSspiCredCache, SNI_AUTOCS_ENTER );
+
+	for( int i = 0; i < SSPI_CRED_CACHE_SIZE; i++ )
+	{
+		SspiCredCacheEntry * pCur = &g_rgSspiCredCache[i];
+
+		if( 0 != pCur->cRef && 
+			pCur->hCred.dwLower == phCred->dwLower && 
+			pCur->hCred.dwUpper == phCred->dwUpper )
+		{
+			fFree = SspiCredCacheRelease( pCur, &hFree );
+			break;
+		}
+	}
+
+	a_csCache.Leave(); 
+
+	if( fFree )
+	{
+		g_pFuncs->FreeCredentialsHandle( &hFree );
+	}
+}
+
+// Drops the cache's own reference on every entry; handles still used by 
+// open connections are freed when the last of them closes.  
+//
+static void SspiCredCacheFlush()
+{
+	BidxScopeAutoSNI0( SNIAPI_TAG _T("\n") );
+
+	if( NULL == g_csSspiCredCache )
+	{
+		return;
+	}
+
+	for( int i = 0; i < SSPI_CRED_CACHE_SIZE; i++ )
+	{
+		CredHandle hFree;
+		bool fFree = false;
+
+		CAutoSNICritSec a_csCache( g_csSspiCredCache, SNI_AUTOCS_ENTER );
+
+		if( g_rgSspiCredCache[i].fCached )
+		{
+			g_rgSspiCredCache[i].fCached = false;
+			fFree = SspiCredCacheRelease( &g_rgSspiCredCache[i], &hFree );
+		}
+
+		a_csCache.Leave(); 
+
+		if( fFree )
+		{
+			g_pFuncs->FreeCredentialsHandle( &hFree );
+		}
+	}
+}
+
+// Opt-in: share outbound SSPI credential handles across connections opened 
+// under the same logon session; see SspiAcquireCredentials.  Turning it 
+// off drops the cached handles.  
+//
+DWORD SNISetSspiCredentialCache( BOOL fEnable )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "fEnable: %d{BOOL}\n"), fEnable);
+
+	DWORD dwRet = ERROR_SUCCESS;
+
+	// Same lifetime as the SSRP cache lock: created on first use and kept 
+	// for the life of the process.  
+	//
+	if( NULL == g_csSspiCredCache )
+	{
+		SNICritSec * pcsNew = NULL;
+
+		dwRet = SNICritSec::Initialize( &pcsNew );
+		if( ERROR_SUCCESS != dwRet )
+		{
+			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_SYSTEM, dwRet );
+			goto Exit;
+		}
+
+		if( NULL != InterlockedCompareExchangePointer( (PVOID *) &g_csSspiCredCache, pcsNew, NULL ) )
+		{
+			DeleteCriticalSection( &pcsNew );
+		}
+	}
+
+	g_fSspiCredCache = fEnable;
+
+	if( !fEnable && NULL != g_pFuncs )
+	{
+		SspiCredCacheFlush();
+	}
+
+Exit:
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+	
+	return dwRet;
+}
+
 SNI_Sec::SNI_Sec() 
 	: m_fCtxt(FALSE),
 	  m_PkgId(INVALID),
+	  m_fSharedCred(FALSE),
 	  m_pPkgInfo(0),
 	  m_dwLastError(ERROR_SUCCESS)
 {
@@ -114,7 +445,15 @@ void SNI_Sec::DeleteSspi()
 
 	if( SecIsValidHandle( &m_hCred) )
 	{
-		g_pFuncs->FreeCredentialsHandle(&m_hCred);
+		if( m_fSharedCred )
+		{
+			SspiReleaseCredentials(&m_hCred);
+			m_fSharedCred = FALSE;
+		}
+		else
+		{
+			g_pFuncs->FreeCredentialsHandle(&m_hCred);
+		}
 		SecInvalidateHandle( &m_hCred );
 	}
 
@@ -694,6 +1033,8 @@ DWORD SNISecTerminatePackage()
 	
 #endif
 
+	SspiCredCacheFlush();
+
 	if( g_hSspiLib )
 	{
 		FreeLibrary(g_hSspiLib);
@@ -1033,6 +1374,7 @@ DWORD SNISecGenClientContext (__in SNI_Conn * pConn,
 	TCHAR* 			pszPackage    = g_szSSP;
 	TCHAR*			pszTargetName = NULL; 
 	TCHAR*			pszBlankSpn=_T("");
+	DWORD			dwIscStart;
 
 #ifdef SNIX
 	
@@ -1141,16 +1483,12 @@ DWORD SNISecGenClientContext (__in SNI_Conn * pConn,
 	}
 	else
 	{
+		DWORD dwAcquireStart = GetTickCount();
 		
-		dwRet = g_pFuncs->AcquireCredentialsHandle( NULL,			// principal
-													 (SEC_TCHAR *) pszPackage, // security package
-													 SECPKG_CRED_OUTBOUND,
-													 NULL,			// LOGON id
-													 NULL,			// auth data
-													 NULL,			// get key fn
-													 NULL,			// get key arg
-													 &pSec->m_hCred,
-													 &Lifetime );
+		dwRet = SspiAcquireCredentials( pszPackage, &pSec->m_hCred, &pSec->m_fSharedCred );
+
+		pConn->m_ConnInfo.OpenTimings.dwSspiAcquireCred += GetTickCount() - dwAcquireStart;
+
 		if( SEC_E_OK != dwRet  )
 		{
 			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_10, dwRet );
@@ -1167,6 +1505,8 @@ Retry:
 
 	// Correct the total buffer count to be the # of buffers we filled, not the # we allocated.
 	InBuffDesc.cBuffers = dwBufferToWrite;
+
+	dwIscStart = GetTickCount();
 	
 	ss = g_pFuncs->InitializeSecurityContext (
 						(PCredHandle) &pSec->m_hCred,
@@ -1182,6 +1522,21 @@ Retry:
 						&ContextAttributes,
 						&Lifetime
 						);
+
+	{
+		DWORD dwIscElapsed = GetTickCount() - dwIscStart;
+
+		pConn->m_ConnInfo.OpenTimings.dwSspi += dwIscElapsed;
+		pConn->m_ConnInfo.OpenTimings.cSspiRoundTrips++;
+
+		if( dwIscElapsed > pConn->m_ConnInfo.OpenTimings.dwSspiMax )
+		{
+			pConn->m_ConnInfo.OpenTimings.dwSspiMax = dwIscElapsed;
+		}
+
+		BidTraceU3( SNI_BID_TRACE_ON, SNI_TAG _T("%u#{SNI_Conn}, round trip: %u, %u ms\n"), 
+			pConn->GetBidId(), pConn->m_ConnInfo.OpenTimings.cSspiRoundTrips, dwIscElapsed );
+	}
 	
 	if ( !SEC_SUCCESS( ss ) )
 	{
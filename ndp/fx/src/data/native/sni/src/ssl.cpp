@@ -85,6 +85,9 @@ CredHandle Ssl::s_hServerCred;
 PSecurityFunctionTable Ssl::s_pfTable = NULL;
 bool Ssl::s_fChannelBindingsSupported = true;
 
+LONG Ssl::s_rgcHandshakeLatency[SSL_HANDSHAKE_LATENCY_BUCKETS];
+LONG Ssl::s_cHandshakesResumed = 0;
+
 BOOL g_fisWin9x = FALSE;
 #ifdef SNIX
 // On windows 9x system, Schannel is supported by schannel.dll, not the secur32.dll(nt4) or secure.dll (Nt5)
@@ -2291,6 +2294,9 @@ DWORD Bytes2Text(__in_bcount(cbBytes) const BYTE* pBytes, __in DWORD cbBytes, __
 
 Ssl::~Ssl()
 {
+	BidTraceU4( SNI_BID_TRACE_ON, SNI_TAG _T("%u#, decrypted bytes: %I64u, left-over copies: %d, left-over bytes copied: %I64u\n"), 
+				GetBidId(), m_cbDecrypted, m_cLeftOverCopies, m_cbLeftOverCopied );
+
 	FreeReadWriteBuffers();
 
 	BidRecycleItemIDA( &m_iBidId, SNI_ID_TAG ); 
@@ -2518,7 +2524,7 @@ DWORD Ssl::AcquireCredentialsForServer(PCCERT_CONTEXT pCertContext)
 
 DWORD Ssl::Decrypt( __inout SNI_Packet *pPacket, __deref_out SNI_Packet **ppLeftOver )
 {
-	BidxScopeAutoSNI3( SNIAPI_TAG _T("%u#, ")
+	BidxScopeAutoSNIHotPath3( SNIAPI_TAG _T("%u#, ")
 							  _T("pPacket: %p{SNI_Packet*}, ")
 							  _T("ppLeftOver: %p{SNI_Packet**}\n"), 
 							  GetBidId(),
@@ -2610,6 +2616,8 @@ DWORD Ssl::Decrypt( __inout SNI_Packet *pPacket, __deref_out SNI_Packet **ppLeft
 
 			SNIPacketSetBufferSize( pPacket, Buffers[1].cbBuffer);
 
+			m_cbDecrypted += Buffers[1].cbBuffer;
+
 			if( Buffers[3].BufferType == SECBUFFER_EXTRA )
 			{
 				*ppLeftOver = SNIPacketAllocate( m_pConn, SNI_Packet_Read );
@@ -2624,6 +2632,9 @@ DWORD Ssl::Decrypt( __inout SNI_Packet *pPacket, __deref_out SNI_Packet **ppLeft
 				}
 				
 				SNIPacketSetData( *ppLeftOver, (BYTE *)Buffers[3].pvBuffer, Buffers[3].cbBuffer);
+
+				m_cLeftOverCopies++;
+				m_cbLeftOverCopied += Buffers[3].cbBuffer;
 			}
 		}
 	}
@@ -2642,7 +2653,7 @@ ExitFunc:
 
 	Assert( ERROR_SUCCESS == scRet || !*ppLeftOver );
 
-	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), scRet);
+	BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), scRet);
 
 	return scRet;	
 }
@@ -2828,6 +2839,11 @@ DWORD Ssl::Handshake( void )
 
 	Assert( m_State == SSL_INIT || m_State == SSL_MORE );
 
+	if( SSL_INIT == m_State )
+	{
+		m_dwHandshakeStart = GetTickCount();
+	}
+
 	THREAD_PREEMPTIVE_ON_START (PWAIT_PREEMPTIVE_OS_AUTHENTICATIONOPS);
 
 Retry:
@@ -2989,6 +3005,8 @@ Retry:
 		m_cbHeaderLength = StreamSizes.cbHeader;		
 		m_cbTrailerLength = StreamSizes.cbTrailer;
 		m_cbMaximumMessage = StreamSizes.cbMaximumMessage;
+
+		RecordHandshakeLatency();
 		
 		dwRet = AdjustProtocolFields();
 
@@ -3068,6 +3086,48 @@ ErrorExit:
 //
 //----------------------------------------------------------------------------
 
+//---------------------------------------------------------------------
+// NAME: Ssl::RecordHandshakeLatency
+//
+// PURPOSE:
+//		Adds a completed handshake to the latency histogram and traces 
+//		whether SChannel resumed a cached session for it.  
+//
+// NOTES:
+//	Sessions can only be resumed for connections sharing the process-wide
+//	client credentials, see SNI_SSL_USE_SCHANNEL_CACHE.  
+//
+void Ssl::RecordHandshakeLatency()
+{
+	DWORD dwElapsed = GetTickCount() - m_dwHandshakeStart;
+	DWORD iBucket = 0;
+
+	while( iBucket < SSL_HANDSHAKE_LATENCY_BUCKETS - 1 && dwElapsed >= (DWORD)(2 << iBucket) )
+	{
+		iBucket++;
+	}
+
+	InterlockedIncrement( &s_rgcHandshakeLatency[iBucket] );
+
+	m_pConn->m_ConnInfo.OpenTimings.dwSslHandshake = dwElapsed;
+
+	SecPkgContext_SessionInfo SessionInfo;
+	BOOL fResumed = FALSE;
+
+	if( SEC_E_OK == s_pfTable->QueryContextAttributes( &m_hContext, SECPKG_ATTR_SESSION_INFO, &SessionInfo ) )
+	{
+		fResumed = !!( SessionInfo.dwFlags & SSL_SESSION_RECONNECT );
+	}
+
+	if( fResumed )
+	{
+		InterlockedIncrement( &s_cHandshakesResumed );
+	}
+
+	BidTraceU4( SNI_BID_TRACE_ON, SNI_TAG _T("%u#, handshake: %d ms, resumed: %d{BOOL}, shared credentials: %d{bool}\n"), 
+				GetBidId(), dwElapsed, fResumed, m_fUseExistingCred );
+}
+
 DWORD Ssl::HandshakeReadDone( __inout_opt SNI_Packet *pPacket, __in DWORD dwError )
 {
 	BidxScopeAutoSNI3( SNIAPI_TAG _T("%u#, ")
@@ -4669,6 +4729,12 @@ Ssl::Ssl(SNI_Conn * pConn):CryptoBase( pConn )
 	m_cbMaximumMessage = 0;
 
 	m_fConnBufSizeIncremented = false;
+
+	m_cbDecrypted = 0;
+	m_cbLeftOverCopied = 0;
+	m_cLeftOverCopies = 0;
+
+	m_dwHandshakeStart = 0;
 	
 	BidObtainItemID2A( &m_iBidId, SNI_ID_TAG "%p{.} created by %u#{SNI_Conn}", 
 		this, pConn->GetBidId() );
@@ -4684,6 +4750,14 @@ DWORD Ssl::Terminate()
 		return ERROR_SUCCESS;
 	}
 
+	for( DWORD i = 0; i < SSL_HANDSHAKE_LATENCY_BUCKETS; i++ )
+	{
+		BidTraceU2( SNI_BID_TRACE_ON, SNI_TAG _T("Handshakes under %d ms: %d\n"), 
+					2 << i, s_rgcHandshakeLatency[i] );
+	}
+
+	BidTraceU1( SNI_BID_TRACE_ON, SNI_TAG _T("Handshakes resumed: %d\n"), s_cHandshakesResumed );
+	
 	if( s_pfTable != NULL && SecIsValidHandle( &s_hClientCred ) )
 	{
 		s_pfTable->FreeCredentialsHandle(&s_hClientCred);
@@ -5316,6 +5390,9 @@ DWORD Ssl::CopyPacket( __inout SNI_Packet * pOldPacket,
 	//
 	SNIPacketSetData( pNewPacket, pbLeftOver, cbLeftOver );
 
+	m_cLeftOverCopies++;
+	m_cbLeftOverCopied += cbLeftOver;
+
 	*ppNewPacket = (SNI_Packet *) pNewPacket;
 
 	SNIPacketSetKey(*ppNewPacket, pPacketKey);
@@ -470,6 +470,241 @@ public:
 	}
 };
 
+// Cache of SQL Browser replies, keyed by server name, instance name and 
+// request type.  Disabled (zero TTL) by default so that a port change after 
+// an instance restart is seen by the next connection; see SNISetSsrpCache.  
+// While one thread is waiting on the Browser for an entry, other threads 
+// asking for the same instance wait for its reply rather than sending their 
+// own request.  
+//
+#define SSRP_CACHE_SIZE 16
+#define SSRP_CACHE_MAX_REPLY 1024
+
+typedef struct
+{
+	HANDLE	hDone;		// manual-reset, set when the owner's query finishes
+	LONG	cRef;		// owner plus waiters, protected by g_csSsrpCache
+} SsrpPendingQuery;
+
+typedef struct
+{
+	WCHAR	wszServer[MAX_NAME_SIZE+1];
+	char	szInstance[MAX_NAME_SIZE+3];
+	char	bRequest;					// CLNT_UCAST_INST or CLNT_UCAST_DAC
+	DWORD	dwInsertTick;
+	int		cbReply;					// 0 until a valid reply has been stored
+	char	rgbReply[SSRP_CACHE_MAX_REPLY];
+	SsrpPendingQuery * pPending;		// non-NULL while a query is outstanding
+} SsrpCacheEntry;
+
+static SsrpCacheEntry g_rgSsrpCache[SSRP_CACHE_SIZE];
+static SNICritSec * g_csSsrpCache = NULL;
+static DWORD g_dwSsrpCacheTtl = 0;
+
+// Called with g_csSsrpCache held.  
+//
+static void ReleasePendingQuery( __inout SsrpPendingQuery * pPending )
+{
+	if( 0 == --pPending->cRef )
+	{
+		CloseHandle( pPending->hDone );
+		delete pPending;
+	}
+}
+
+// Returns the length of the cached reply copied into pBuf, or 0 if the 
+// caller has to query the Browser itself.  In the latter case *ppPending 
+// may be set, and the caller must then pass its result to 
+// CacheComplete() so that the threads waiting on it can use it.  
+//
+static int CacheAcquire( __in LPCWSTR wszServer, 
+						__in LPCSTR szInstance, 
+						char bRequest, 
+						__out_bcount(cBuf) char * pBuf, 
+						int cBuf, 
+						__out SsrpPendingQuery ** ppPending )
+{
+	SsrpPendingQuery * pWait = NULL;
+	int cbReply = 0;
+
+	*ppPending = NULL;
+
+	if( 0 == g_dwSsrpCacheTtl || NULL == g_csSsrpCache )
+	{
+		return 0;
+	}
+
+	if( wcslen( wszServer ) > MAX_NAME_SIZE || strlen( szInstance ) > MAX_NAME_SIZE )
+	{
+		return 0;
+	}
+
+	// The second pass runs after waiting for another thread's query; it 
+	// takes the reply that thread stored, or queries without waiting again.
+	//
+	for( int iPass = 0; iPass < 2; iPass++ )
+	{
+		CAutoSNICritSec a_csCache( g_csSsrpCache, SNI_AUTOCS_ENTER );
+
+		if( NULL != pWait )
+		{
+			ReleasePendingQuery( pWait );
+			pWait = NULL;
+		}
+
+		SsrpCacheEntry * pEntry = NULL;
+		SsrpCacheEntry * pVictim = NULL;
+		DWORD dwNow = GetTickCount();
+
+		for( int i = 0; i < SSRP_CACHE_SIZE; i++ )
+		{
+			SsrpCacheEntry * pCur = &g_rgSsrpCache[i];
+
+			if( L'\0' != pCur->wszServer[0] && 
+				bRequest == pCur->bRequest && 
+				!_wcsicmp( pCur->wszServer, wszServer ) && 
+				!_stricmp( pCur->szInstance, szInstance ) )
+			{
+				pEntry = pCur;
+				break;
+			}
+
+			// Otherwise reuse an empty slot, or the oldest idle entry.
+			if( NULL != pCur->pPending )
+			{
+				continue;
+			}
+
+			if( NULL == pVictim || 
+				(L'\0' != pVictim->wszServer[0] && 
+				 (L'\0' == pCur->wszServer[0] || 
+				  (DWORD)(dwNow - pCur->dwInsertTick) > (DWORD)(dwNow - pVictim->dwInsertTick))) )
+			{
+				pVictim = pCur;
+			}
+		}
+
+		if( NULL != pEntry && 0 != pEntry->cbReply && 
+			(DWORD)(dwNow - pEntry->dwInsertTick) < g_dwSsrpCacheTtl && 
+			pEntry->cbReply <= cBuf )
+		{
+			memcpy( pBuf, pEntry->rgbReply, pEntry->cbReply );
+			cbReply = pEntry->cbReply;
+		}
+		else if( NULL != pEntry && NULL != pEntry->pPending )
+		{
+			if( 0 == iPass )
+			{
+				pWait = pEntry->pPending;
+				pWait->cRef++;
+			}
+		}
+		else
+		{
+			if( NULL != pEntry )
+			{
+				pVictim = pEntry;
+			}
+
+			SsrpPendingQuery * pPending = NULL;
+
+			if( NULL != pVictim )
+			{
+				pPending = NewNoX(gpmo) SsrpPendingQuery;
+			}
+
+			if( NULL != pPending )
+			{
+				pPending->cRef = 1;
+				pPending->hDone = CreateEvent( NULL, TRUE, FALSE, NULL );
+
+				if( NULL == pPending->hDone )
+				{
+					delete pPending;
+					pPending = NULL;
+				}
+			}
+
+			if( NULL != pPending )
+			{
+				(void) StringCchCopyW( pVictim->wszServer, ARRAYSIZE(pVictim->wszServer), wszServer );
+				(void) StringCchCopyA( pVictim->szInstance, ARRAYSIZE(pVictim->szInstance), szInstance );
+				pVictim->bRequest = bRequest;
+				pVictim->cbReply = 0;
+				pVictim->pPending = pPending;
+
+				*ppPending = pPending;
+			}
+		}
+
+		a_csCache.Leave(); 
+
+		if( NULL == pWait )
+		{
+			break;
+		}
+
+		BidTraceU2( SNI_BID_TRACE_ON, SNI_TAG _T("wszServer: '%s', szInstance: '%hs', waiting for a query in progress\n"), 
+			wszServer, szInstance );
+
+		(void) WaitForSingleObject( pWait->hDone, DEFAULT_SSRPGETINFO_TIMEOUT );
+	}
+
+	return cbReply;
+}
+
+// Stores the reply of a query started after CacheAcquire() returned 
+// pPending, and wakes the threads waiting for it.  cbReply is 0 if the 
+// query failed, in which case nothing is cached.  
+//
+static void CacheComplete( __in_opt SsrpPendingQuery * pPending, __in_bcount_opt(cbReply) const char * pReply, int cbReply )
+{
+	if( NULL == pPending )
+	{
+		return;
+	}
+
+	CAutoSNICritSec a_csCache( g_csSsrpCache, SNI_AUTOCS_ENTER );
+
+	for( int i = 0; i < SSRP_CACHE_SIZE; i++ )
+	{
+		SsrpCacheEntry * pEntry = &g_rgSsrpCache[i];
+
+		if( pPending != pEntry->pPending )
+		{
+			continue;
+		}
+
+		pEntry->pPending = NULL;
+
+		if( 0 < cbReply && cbReply <= SSRP_CACHE_MAX_REPLY )
+		{
+			memcpy( pEntry->rgbReply, pReply, cbReply );
+			pEntry->cbReply = cbReply;
+			pEntry->dwInsertTick = GetTickCount();
+		}
+		else
+		{
+			memset( pEntry, 0, sizeof(*pEntry) );
+		}
+		break;
+	}
+
+	SetEvent( pPending->hDone );
+	ReleasePendingQuery( pPending );
+
+	a_csCache.Leave(); 
+}
+
+// Checks the header of a CLNT_UCAST_INST reply.  
+//
+static bool IsValidInstanceReply( __in_bcount(cBuf) const char * pBuf, int cBuf )
+{
+	return (cBuf > 15)	//$ SPT:351275, skip the "servername;", etc. so it has to be at least 15 char long!
+		&& (pBuf[0] == SVR_RESP)
+		&& (cBuf-3 == *(UNALIGNED USHORT *)(pBuf+1));
+}
+
 bool GetAdminPort( const WCHAR *wszServer, const WCHAR *wszInstance, __inout USHORT *pPort)
 {
 	BidxScopeAutoSNI3( SNIAPI_TAG _T( "wszServer: '%s', wszInstance: '%s', pPort: %p\n"),
@@ -479,6 +714,7 @@ bool GetAdminPort( const WCHAR *wszServer, const WCHAR *wszInstance, __inout USH
 	int		cBuf;
 
    	SsrpSocket ssrpSocket;
+	SsrpPendingQuery * pPending = NULL;
 	
 	char szInstance[MAX_NAME_SIZE+3];
 	int ret = WideCharToMultiByte(CP_ACP, 0, wszInstance, wcslen(wszInstance), NULL, 0, NULL, NULL);
@@ -504,22 +740,35 @@ bool GetAdminPort( const WCHAR *wszServer, const WCHAR *wszInstance, __inout USH
 		goto ErrorExit;
 
 	cBuf = (int)strlen( szInstance )+3;
-	
-	if( false == ssrpSocket.OpenUnicast( wszServer, pBuf, cBuf ))
-		goto ErrorExit;
-
-	cBuf = ssrpSocket.Read( pBuf, 6);
 
+	bool fValid;
+	
 	//format of the reply packet is
 	//first byte SVR_RESP
 	//two bytes length of the whole packet( it has to be 6 for version 1 )
 	//one byte version number( it has to be 1 for this implementation)
 	//last two bytes specifies the tcp port number for admin connection
-	
-	if( cBuf != 6 || pBuf[0]!=SVR_RESP || 
-		*(UNALIGNED USHORT *)(pBuf+1)!=6 || pBuf[3]!=1 )
+
+	if( 0 == CacheAcquire( wszServer, szInstance, CLNT_UCAST_DAC, pBuf, 6, &pPending ) )
 	{
-		goto ErrorExit;
+		if( ssrpSocket.OpenUnicast( wszServer, pBuf, cBuf ))
+		{
+			cBuf = ssrpSocket.Read( pBuf, 6);
+		}
+		else
+		{
+			cBuf = SOCKET_ERROR;
+		}
+
+		fValid = ( cBuf == 6 && pBuf[0]==SVR_RESP && 
+			*(UNALIGNED USHORT *)(pBuf+1)==6 && pBuf[3]==1 && 0 != *(UNALIGNED USHORT *)(pBuf+4) );
+
+		CacheComplete( pPending, pBuf, fValid ? cBuf : 0 );
+
+		if( !fValid )
+		{
+			goto ErrorExit;
+		}
 	}
 
 	*pPort = *(UNALIGNED USHORT *)(pBuf+4);
@@ -899,6 +1148,7 @@ DWORD SsrpGetInfo( __in LPWSTR wszServer, __in LPWSTR wszInstance, __inout ProtL
 	Assert( wszServer[0] );
 
 	SsrpSocket ssrpSocket;
+	SsrpPendingQuery * pPending = NULL;
 	
 	char szInstance[MAX_NAME_SIZE+3];
 	int ret = WideCharToMultiByte(CP_ACP, 0, wszInstance, wcslen(wszInstance), NULL, 0, NULL, NULL);
@@ -913,22 +1163,27 @@ DWORD SsrpGetInfo( __in LPWSTR wszServer, __in LPWSTR wszInstance, __inout ProtL
 	}
 	szInstance[ret]='\0';
 
-	if( false == ssrpSocket.Open( wszServer, szInstance ))
-	{
-		goto ErrorExit;
-	}
-
-	ssrpSocket.Starttimer();
-	
 	char pBuf[1024];
 	int cBuf = 1024;
-	
-	// The time out here must be less than TDS timeout value that currently is 15 seconds
-	cBuf = ssrpSocket.ReadEx( pBuf, sizeof(pBuf)-1, DEFAULT_SSRPGETINFO_TIMEOUT);
 
-	if ((cBuf <= 15) //$ SPT:351275, skip the "servername;", etc. so it has to be at least 15 char long!
-		|| (pBuf[0] != SVR_RESP)
-		|| (cBuf-3 != *(UNALIGNED USHORT *)(pBuf+1)))
+	cBuf = CacheAcquire( wszServer, szInstance, CLNT_UCAST_INST, pBuf, sizeof(pBuf)-1, &pPending );
+
+	if( 0 == cBuf )
+	{
+		cBuf = SOCKET_ERROR;
+		
+		if( ssrpSocket.Open( wszServer, szInstance ))
+		{
+			ssrpSocket.Starttimer();
+			
+			// The time out here must be less than TDS timeout value that currently is 15 seconds
+			cBuf = ssrpSocket.ReadEx( pBuf, sizeof(pBuf)-1, DEFAULT_SSRPGETINFO_TIMEOUT);
+		}
+
+		CacheComplete( pPending, pBuf, IsValidInstanceReply( pBuf, cBuf ) ? cBuf : 0 );
+	}
+
+	if( !IsValidInstanceReply( pBuf, cBuf ) )
 	{
 		goto ErrorExit;
 	}
@@ -993,6 +1248,89 @@ typedef NET_API_STATUS (NET_API_FUNCTION * FUNCNETSERVERENUM)( char *,
 
 typedef NET_API_STATUS (NET_API_FUNCTION * FUNCNETAPIBUFFERFREE)( LPVOID );
 
+// Set of the names SNIServerEnumRead has already returned, so that an 
+// instance answering on several sockets (e.g. broadcast and loopback), or 
+// reported by both SSRP and NetServerEnum, is listed once.  Records are 
+// compared up to the first ';', i.e. without the extended information.  
+//
+#define SERVER_NAME_SET_BUCKETS	64
+#define SERVER_NAME_SET_MAX_KEY	(2*MAX_NAME_SIZE+2)
+
+class ServerNameSet
+{
+	struct Node
+	{
+		Node *	m_pNext;
+		WCHAR	m_wszKey[SERVER_NAME_SET_MAX_KEY+1];
+	};
+
+	Node *	m_rgpBuckets[SERVER_NAME_SET_BUCKETS];
+
+public:
+
+	ServerNameSet()
+	{
+		memset( m_rgpBuckets, 0, sizeof(m_rgpBuckets) );
+	}
+
+	~ServerNameSet()
+	{
+		for( int i = 0; i < SERVER_NAME_SET_BUCKETS; i++ )
+		{
+			while( m_rgpBuckets[i] )
+			{
+				Node * pNode = m_rgpBuckets[i];
+				m_rgpBuckets[i] = pNode->m_pNext;
+				delete pNode;
+			}
+		}
+	}
+
+	// Returns false if the name of the record at pwszRecord was added 
+	// before.  Records that cannot be tracked (too long, out of memory) 
+	// are reported as new.
+	//
+	bool Insert( __in LPCWSTR pwszRecord )
+	{
+		int cchKey = 0;
+		DWORD dwHash = 0;
+
+		while( pwszRecord[cchKey] && L';' != pwszRecord[cchKey] )
+		{
+			dwHash = dwHash * 31 + towupper( pwszRecord[cchKey] );
+			cchKey++;
+		}
+
+		if( SERVER_NAME_SET_MAX_KEY < cchKey )
+		{
+			return true;
+		}
+
+		Node ** ppBucket = &m_rgpBuckets[dwHash % SERVER_NAME_SET_BUCKETS];
+
+		for( Node * pNode = *ppBucket; pNode; pNode = pNode->m_pNext )
+		{
+			if( (int)wcslen( pNode->m_wszKey ) == cchKey && 
+				!_wcsnicmp( pNode->m_wszKey, pwszRecord, cchKey ) )
+			{
+				return false;
+			}
+		}
+
+		Node * pNew = NewNoX(gpmo) Node;
+
+		if( pNew )
+		{
+			memcpy( pNew->m_wszKey, pwszRecord, cchKey * sizeof(WCHAR) );
+			pNew->m_wszKey[cchKey] = L'\0';
+			pNew->m_pNext = *ppBucket;
+			*ppBucket = pNew;
+		}
+
+		return true;
+	}
+};
+
 class ServerEnum
 {
 	//
@@ -1025,6 +1363,22 @@ class ServerEnum
 
 	DWORD		m_iEntry;
 
+	// NetServerEnum runs on this thread while SSRP replies are read; 
+	// m_pLanInfo and m_nEntries are only valid once it has exited.
+	HANDLE		m_hLanThread;
+
+	//
+	// streaming enumeration, see SNIServerEnumOpenStreaming
+	//
+
+	bool		m_fStreaming;
+
+	DWORD		m_dwTotalTimeout;		// INFINITE for no time budget
+
+	DWORD		m_dwDeadline;
+
+	ServerNameSet m_Seen;
+
 	//
 	// members which enable access to netapi32 library
 	//
@@ -1045,6 +1399,10 @@ public:
 		m_pLanInfo(0),
 		m_nEntries(0),
 		m_iEntry(0),
+		m_hLanThread(0),
+		m_fStreaming(false),
+		m_dwTotalTimeout(INFINITE),
+		m_dwDeadline(0),
 		m_hLan(0),
 		m_pfuncNetServerEnum(0),
 		m_pfuncNetApiBufferFree(0)
@@ -1053,6 +1411,16 @@ public:
 
 	~ServerEnum()
 	{
+		// NetServerEnum cannot be cancelled; it has to finish before its 
+		// buffer and the library can be released.
+		//
+		if( m_hLanThread )
+		{
+			WaitForSingleObject( m_hLanThread, INFINITE );
+			CloseHandle( m_hLanThread );
+			m_hLanThread = 0;
+		}
+
 		if( m_hLan )
 		{
 			Assert( m_pfuncNetApiBufferFree );
@@ -1099,6 +1467,23 @@ public:
 			return false;
 		}
 
+		// With SSRP under way, let NetServerEnum run next to it instead of 
+		// holding up the first SSRP results.
+		//
+		if( !IsSsrpFinished() )
+		{
+			m_hLanThread = CreateThread( NULL, 0, LanEnumThread, this, 0, NULL );
+
+			if( m_hLanThread )
+			{
+				m_hLan = hLan;
+
+				BidTraceU0( SNI_BID_TRACE_ON,RETURN_TAG _T("true\n"));
+
+				return true;
+			}
+		}
+
 		DWORD dwTotalEntries = 0;
 
 		NET_API_STATUS status;
@@ -1135,6 +1520,81 @@ public:
 
 		return true;
 	}
+
+	static DWORD WINAPI LanEnumThread( LPVOID pvServerEnum )
+	{
+		ServerEnum * pServerEnum = (ServerEnum *) pvServerEnum;
+
+		BidxScopeAutoSNI1( SNIAPI_TAG _T( "pServerEnum: %p\n"), pServerEnum);
+
+		DWORD dwTotalEntries = 0;
+
+		NET_API_STATUS status;
+
+		status = pServerEnum->m_pfuncNetServerEnum( 	NULL,
+										100,
+										(LPBYTE *)&pServerEnum->m_pLanInfo,
+										MAX_PREFERRED_LENGTH,
+										&pServerEnum->m_nEntries,
+										&dwTotalEntries,
+										SV_TYPE_SQLSERVER,
+										NULL,
+										NULL);
+		
+		if(	status != NERR_Success && 
+			status != ERROR_MORE_DATA )
+		{
+			Assert( !pServerEnum->m_pLanInfo );
+			Assert( !pServerEnum->m_nEntries );
+
+			pServerEnum->m_nEntries = 0;
+		}
+
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("status: %d\n"), status);
+
+		return 0;
+	}
+
+	// Returns true once the NetServerEnum results can be read, waiting 
+	// up to dwWait milliseconds for the enumeration thread.
+	//
+	bool WaitForLan( DWORD dwWait )
+	{
+		if( m_hLanThread && WAIT_OBJECT_0 != WaitForSingleObject( m_hLanThread, dwWait ) )
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	void SetStreaming( DWORD dwTotalTimeout )
+	{
+		m_fStreaming = true;
+		m_dwTotalTimeout = dwTotalTimeout;
+		m_dwDeadline = GetTickCount() + dwTotalTimeout;
+	}
+
+	inline bool IsStreaming() const
+	{
+		return m_fStreaming;
+	}
+
+	// Milliseconds left of the total time budget of a streaming enumeration.
+	//
+	DWORD GetTimeLeft() const
+	{
+		Assert( m_fStreaming );
+
+		if( INFINITE == m_dwTotalTimeout )
+		{
+			return INFINITE;
+		}
+
+		int timeleft = (int)(m_dwDeadline - GetTickCount());
+
+		return 0 < timeleft ? timeleft : 0;
+	}
 	
 	bool Initialize(__in LPCWSTR wszServer, __in DWORD waittime_least, __in DWORD waittimeout)
 	{
@@ -1522,6 +1982,10 @@ public:
 				{
 					BidTrace0(ERROR_TAG _T("Invalid params in ASCII to Unicode\n"));
 				}
+				else if( !m_Seen.Insert( pwBuf+cBufTotal ) )
+				{
+					BidTrace0(SNI_TAG _T("duplicate record dropped\n"));
+				}
 				else
 				{
 					cBufTotal += cRet;
@@ -1546,9 +2010,23 @@ public:
 			}
 			else
 				fisFirst = false;
-			
+
+			// When streaming, hand back what has arrived as soon as the 
+			// next reply is not already waiting.
+			//
+			if( m_fStreaming && cBufTotal )
+			{
+				if( !SsrpGetNextRecord(1) )
+				{
+					*pfMore = TRUE;
+
+					BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("cBufTotal: %d, *pfMore: %d{BOOL)\n"), cBufTotal, *pfMore);
+
+					return cBufTotal;
+				}
+			}
 			//BidTrace1(ERROR_TAG _T("timeleft:%d\n"),timeleft);
-			if( !SsrpGetNextRecord(timeleft))
+			else if( !SsrpGetNextRecord(timeleft))
 			{
 				Assert( !m_cSavedRecord );
 				Assert( !m_pSavedRecord );
@@ -1616,6 +2094,11 @@ public:
 				return cBufTotal;
 			}
 
+			if( !m_Seen.Insert( (WCHAR *)m_pLanInfo[m_iEntry].sv100_name ) )
+			{
+				continue;
+			}
+
 			memcpy( pwBuf+cBufTotal, m_pLanInfo[m_iEntry].sv100_name, cRecord*sizeof(pwBuf[0]));
 
 			cBufTotal += cRecord;
@@ -1634,6 +2117,61 @@ public:
 
 using namespace SSRP;
 
+// Opt-in: cache SQL Browser replies for dwTtl milliseconds and let 
+// concurrent lookups of one instance share a single request; 0 disables.  
+//
+DWORD SNISetSsrpCache( DWORD dwTtl )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "dwTtl: %u\n"), dwTtl);
+
+	DWORD dwRet = ERROR_SUCCESS;
+
+	// The lock is created on first use and kept for the life of the 
+	// process, since there is no SSRP initialization to hang it on.
+	//
+	if( NULL == g_csSsrpCache )
+	{
+		SNICritSec * pcsNew = NULL;
+
+		dwRet = SNICritSec::Initialize( &pcsNew );
+		if( ERROR_SUCCESS != dwRet )
+		{
+			SNI_SET_LAST_ERROR( INVALID_PROV, SNIE_SYSTEM, dwRet );
+			goto Exit;
+		}
+
+		if( NULL != InterlockedCompareExchangePointer( (PVOID *) &g_csSsrpCache, pcsNew, NULL ) )
+		{
+			DeleteCriticalSection( &pcsNew );
+		}
+	}
+
+	{
+		CAutoSNICritSec a_csCache( g_csSsrpCache, SNI_AUTOCS_ENTER );
+
+		g_dwSsrpCacheTtl = dwTtl;
+
+		// Drop the stored replies; entries with a query outstanding are 
+		// left to CacheComplete().
+		//
+		for( int i = 0; i < SSRP_CACHE_SIZE; i++ )
+		{
+			if( NULL == g_rgSsrpCache[i].pPending )
+			{
+				memset( &g_rgSsrpCache[i], 0, sizeof(g_rgSsrpCache[i]) );
+			}
+		}
+
+		a_csCache.Leave(); 
+	}
+
+Exit:
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+	
+	return dwRet;
+}
+
 HANDLE SNIServerEnumOpenEx( LPWSTR pwszServer, 
 							BOOL fExtendedInfo, 
 							DWORD waittime_least, 
@@ -1706,6 +2244,30 @@ HANDLE SNIServerEnumOpen( LPWSTR pwszServer, BOOL fExtendedInfo)
 	return SNIServerEnumOpenEx(pwszServer, fExtendedInfo,SSRP_WAIT_TIME_LEAST ,SSRP_WAIT_TIMEOUT);  //  use default timeout value;
 }
 
+// Like SNIServerEnumOpen, but SNIServerEnumRead returns the records that 
+// have arrived so far with *pfMore set instead of waiting to fill the 
+// buffer, and the whole enumeration ends after dwTotalTimeout milliseconds 
+// (INFINITE for no limit, 0 for DEFAULT_SSRP_ENUM_TIMEOUT).
+//
+HANDLE SNIServerEnumOpenStreaming( LPWSTR pwszServer, BOOL fExtendedInfo, DWORD dwTotalTimeout)
+{
+	BidxScopeAutoSNI3( SNIAPI_TAG _T("pwszServer: \"%ls\", ")
+							  _T("fExtendedInfo: %d{BOOL}, ")
+							  _T("dwTotalTimeout: %d\n"), 
+					pwszServer, fExtendedInfo, dwTotalTimeout);
+
+	ServerEnum * pServerEnum = (ServerEnum *) SNIServerEnumOpenEx( pwszServer, fExtendedInfo, SSRP_WAIT_TIME_LEAST, SSRP_WAIT_TIMEOUT );
+
+	if( NULL != pServerEnum )
+	{
+		pServerEnum->SetStreaming( 0 != dwTotalTimeout ? dwTotalTimeout : DEFAULT_SSRP_ENUM_TIMEOUT );
+	}
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%p\n"), pServerEnum);
+
+	return pServerEnum;
+}
+
 
 __success(return > 0) int SNIServerEnumReadEx(__in HANDLE handle, __out_ecount_part(cBuf, return)  LPWSTR pwBuf, __in int cBuf, __out BOOL *pfMore, __in int timeout)
 {
@@ -1728,6 +2290,36 @@ __success(return > 0) int SNIServerEnumReadEx(__in HANDLE handle, __out_ecount_p
 		return 0;
 	}
 
+	// A streaming enumeration stops when its total time budget is spent, 
+	// whatever is still outstanding.
+	//
+	if( pServerEnum->IsStreaming() )
+	{
+		DWORD dwTimeLeft = pServerEnum->GetTimeLeft();
+
+		if( 0 == dwTimeLeft )
+		{
+			if( !pServerEnum->IsSsrpFinished() )
+			{
+				pServerEnum->SetSsrpFinished();
+			}
+
+			if( !pServerEnum->IsLanFinished() )
+			{
+				pServerEnum->SetLanFinished();
+			}
+
+			BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("bytes: %d, *pfMore: %d{BOOL}\n"), cBufTotal, *pfMore);
+
+			return cBufTotal;
+		}
+
+		if( INFINITE == timeout || (DWORD)timeout > dwTimeLeft )
+		{
+			timeout = dwTimeLeft;
+		}
+	}
+
 	if( !pServerEnum->IsSsrpFinished() )
 	{
 		cBufTotal = pServerEnum->SsrpGetNext( pwBuf, cBuf, pfMore, timeout );
@@ -1751,6 +2343,28 @@ __success(return > 0) int SNIServerEnumReadEx(__in HANDLE handle, __out_ecount_p
 
 	if( !pServerEnum->IsLanFinished())
 	{
+		if( !pServerEnum->IsStreaming() )
+		{
+			(void) pServerEnum->WaitForLan( INFINITE );
+		}
+		else if( cBufTotal && !pServerEnum->WaitForLan( 0 ) )
+		{
+			// Return the SSRP results now; NetServerEnum is still running.
+			*pfMore = TRUE;
+
+			BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("bytes: %d, *pfMore: %d{BOOL}\n"), cBufTotal, *pfMore);
+
+			return cBufTotal;
+		}
+		else if( !pServerEnum->WaitForLan( pServerEnum->GetTimeLeft() ) )
+		{
+			pServerEnum->SetLanFinished();
+
+			BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("bytes: %d, *pfMore: %d{BOOL}\n"), cBufTotal, *pfMore);
+
+			return cBufTotal;
+		}
+
 		cBufTotal += pServerEnum->LanGetNext( pwBuf+cBufTotal, cBuf-cBufTotal, pfMore);
 
 		BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("bytes: %d, *pfMore: %d{BOOL}\n"), cBufTotal, *pfMore);
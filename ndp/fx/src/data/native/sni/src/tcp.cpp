@@ -67,6 +67,150 @@ static CONNECTEXFUNC* g_pConnectExFuncIpv6 = NULL;
 static HMODULE g_hKernel32 = NULL;
 static PFN_WIN32_SETFILECOMPLETIONNOTIFICATIONMODES g_pfnWin32SetFileCompletionNotificationModes = NULL;
 
+// GetAddrInfoExW with an OVERLAPPED is only supported on Windows 8 and 
+// later; it lets Tcp::Open bound the name lookup by the connection timeout.  
+// The ADDRINFOEXW layout is declared here so that we do not depend on the 
+// newer SDK headers.  
+//
+typedef struct _SNI_ADDRINFOEXW
+{
+	int		ai_flags;
+	int		ai_family;
+	int		ai_socktype;
+	int		ai_protocol;
+	size_t	ai_addrlen;
+	PWSTR	ai_canonname;
+	struct sockaddr * ai_addr;
+	void *	ai_blob;
+	size_t	ai_bloblen;
+	LPGUID	ai_provider;
+	struct _SNI_ADDRINFOEXW * ai_next;
+} SNI_ADDRINFOEXW;
+
+typedef INT (WSAAPI * PFN_GETADDRINFOEXW)( PCWSTR pName, 
+											PCWSTR pServiceName, 
+											DWORD dwNameSpace, 
+											LPGUID lpNspId, 
+											const SNI_ADDRINFOEXW * hints, 
+											SNI_ADDRINFOEXW ** ppResult, 
+											struct timeval * timeout, 
+											LPOVERLAPPED lpOverlapped, 
+											LPVOID lpCompletionRoutine, 
+											LPHANDLE lpHandle );
+typedef INT (WSAAPI * PFN_GETADDRINFOEXCANCEL)( LPHANDLE lpHandle );
+typedef INT (WSAAPI * PFN_GETADDRINFOEXOVERLAPPEDRESULT)( LPOVERLAPPED lpOverlapped );
+typedef void (WSAAPI * PFN_FREEADDRINFOEXW)( SNI_ADDRINFOEXW * pAddrInfoEx );
+
+static PFN_GETADDRINFOEXW g_pfnGetAddrInfoExW = NULL;
+static PFN_GETADDRINFOEXCANCEL g_pfnGetAddrInfoExCancel = NULL;
+static PFN_GETADDRINFOEXOVERLAPPEDRESULT g_pfnGetAddrInfoExOverlappedResult = NULL;
+static PFN_FREEADDRINFOEXW g_pfnFreeAddrInfoExW = NULL;
+
+// Cache of the addresses Tcp::Open resolved, keyed by server name and port.  
+// Disabled (zero TTL) by default, so that DNS changes such as a listener 
+// failover are seen by the next connection; see SNISetTcpAddressCache.  
+//
+#define TCP_ADDR_CACHE_SIZE 16
+
+typedef struct
+{
+	WCHAR	wszServer[MAX_NAME_SIZE+1];
+	WCHAR	wszPort[MAX_PROTOCOLPARAMETER_LENGTH+1];
+	DWORD	dwInsertTick;
+	DWORD	dwError;			// ERROR_SUCCESS, or EAI_NONAME for a negative entry
+	ADDRINFOW * pAddrInfo;		// allocated by CopyAddrInfo(), NULL for a negative entry
+} TcpAddrCacheEntry;
+
+static TcpAddrCacheEntry g_rgTcpAddrCache[TCP_ADDR_CACHE_SIZE];
+static SNICritSec * g_csTcpAddrCache = NULL;
+static DWORD g_dwTcpAddrCacheTtl = 0;
+static DWORD g_dwTcpAddrCacheNegativeTtl = 0;
+
+// Delay between the connection attempts Tcp::Open starts for a name with 
+// several addresses outside of MultiSubnetFailover.  Zero (the default) 
+// keeps trying the addresses one at a time; see SNISetTcpConnectStagger.  
+//
+static DWORD g_dwTcpConnectStaggerDelay = 0;
+
+// How long, in milliseconds, a successful read keeps Tcp::CheckConnection 
+// from polling the socket.  Zero (the default) polls on every check; see 
+// SNISetTcpCheckConnectionIdle.  
+//
+static DWORD g_dwTcpCheckConnectionIdle = 0;
+
+// SIO_LOOPBACK_FAST_PATH (Windows 8 and later) lets loopback TCP traffic 
+// skip most of the TCP/IP stack.  It only takes effect if both ends set it 
+// before connect()/listen(), and it bypasses WFP filters, so it is opt-in; 
+// see SNISetTcpLoopbackFastPath.  
+//
+#ifndef SIO_LOOPBACK_FAST_PATH
+#define SIO_LOOPBACK_FAST_PATH _WSAIOW(IOC_VENDOR,16)
+#endif
+
+static BOOL g_fTcpLoopbackFastPath = FALSE;
+
+// Number of AcceptEx calls kept posted on each listening socket.  A 
+// listener starts with g_cTcpAcceptMin of them, and whenever an accept 
+// completes with no other accept left posted on its socket (i.e. the 
+// connection rate outran the backlog) one more is added, up to 
+// g_cTcpAcceptMax.  Both default to 1, which is the original single 
+// accept per socket; see SNISetTcpAcceptBacklog.  
+//
+#define TCP_ACCEPT_BACKLOG_LIMIT	64
+
+static DWORD g_cTcpAcceptMin = 1;
+static DWORD g_cTcpAcceptMax = 1;
+
+// Best effort: older systems fail the ioctl with WSAEOPNOTSUPP, and the 
+// socket simply keeps using the regular loopback path.  
+//
+static void SetLoopbackFastPath( SOCKET sock )
+{
+	int iOptVal = 1;
+	DWORD dwBytes = 0;
+
+	if( SOCKET_ERROR == WSAIoctl( sock, 
+								  SIO_LOOPBACK_FAST_PATH, 
+								  &iOptVal, 
+								  sizeof(iOptVal), 
+								  NULL, 
+								  0, 
+								  &dwBytes, 
+								  NULL, 
+								  NULL ) )
+	{
+		BidTraceU1( SNI_BID_TRACE_ON, SNI_TAG _T("SIO_LOOPBACK_FAST_PATH: %d{WINERR}\n"), WSAGetLastError() );
+	}
+}
+
+// Matches 127.*.*.* and ::1; same checks as SNI_ServiceBindings::IsIn4AddrLoopback 
+// and IsIn6AddrLoopback, which avoid the undocumented IN4/IN6 macros.  
+//
+static bool IsLoopbackAddress( __in const ADDRINFOW * pAIW )
+{
+	if( AF_INET == pAIW->ai_family && pAIW->ai_addrlen >= sizeof(SOCKADDR_IN) )
+	{
+		OACR_WARNING_SUPPRESS(IPV6_ADDRESS_STRUCTURE_IPV4_SPECIFIC , "Separate path for handling IPv4-specific data - see the AF_INET6 path below");
+		const IN_ADDR *a = &(((SOCKADDR_IN *) pAIW->ai_addr)->sin_addr);
+		return (*((PUCHAR) a) == 0x7f);
+	}
+
+	if( AF_INET6 == pAIW->ai_family && pAIW->ai_addrlen >= sizeof(SOCKADDR_IN6) )
+	{
+		const IN6_ADDR *a = &(((SOCKADDR_IN6 *) pAIW->ai_addr)->sin6_addr);
+		return ((a->s6_words[0] == 0) &&
+				(a->s6_words[1] == 0) &&
+				(a->s6_words[2] == 0) &&
+				(a->s6_words[3] == 0) &&
+				(a->s6_words[4] == 0) &&
+				(a->s6_words[5] == 0) &&
+				(a->s6_words[6] == 0) &&
+				(a->s6_words[7] == 0x0100));
+	}
+
+	return false;
+}
+
 BOOL Tcp::s_fAutoTuning = FALSE; 
 BOOL Tcp::s_fSkipCompletionPort = FALSE;
 
@@ -1138,18 +1282,40 @@ private:
 
 	LONG			m_cRefCount;
 	ListenObject *		m_pParentListenObject;		
+
+	// All the AcceptObjects posting on one listening socket point at the 
+	// first one created for it, which owns (and closes) the socket and 
+	// keeps the per-socket counts below.  
+	//
+	AcceptObject *	m_pPrimary;
+	LONG			m_cPosted;
+	LONG			m_cGroup;
+
+	// Accept socket created ahead of time, right after the previous 
+	// AcceptEx was posted, so re-posting does not wait on socket creation.  
+	// Only used when the accept backlog is configured.  
+	//
+	SOCKET			m_SpareSocket;
 	
 	AcceptObject(ListenObject* pListenObject);
 	~AcceptObject();
 
+	SOCKET CreateAcceptSocket();
+
 public:
 
 	friend DWORD Tcp::AcceptDone(SNI_Conn * pConn, LPVOID pAcceptKey, DWORD dwBytes, DWORD dwError, SNI_Provider * * ppProv, LPVOID * ppAcceptInfo);
+	friend class ListenObject;
 	
 	char 			m_AddressBuffer[sizeof(SOCKADDR_STORAGE)*2+32];
 	bool			m_fPendingAccept;
 	
-	static DWORD InitObject( __out AcceptObject **ppAccept,SOCKET ListenSocket, int AddressFamily, ListenObject * pParentListenObject);
+	static DWORD InitObject( __out AcceptObject **ppAccept,SOCKET ListenSocket, int AddressFamily, ListenObject * pParentListenObject, __in_opt AcceptObject * pPrimary = NULL);
+
+	bool FOwnsListenSocket()
+	{
+		return m_pPrimary == this;
+	}
 
 	LONG AddRef()
 	{
@@ -1209,15 +1375,19 @@ public:
 		
 		DWORD dwRet;
 		
-		// Associate listen socket with completion port
+		// Associate listen socket with completion port; only once per 
+		// socket, the other AcceptObjects on it share the association.  
 		
-		dwRet = SNIRegisterForAccept( (HANDLE) m_ListenSocket );
-
-		if( ERROR_SUCCESS != dwRet )
+		if( FOwnsListenSocket() )
 		{
-			BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
-			
-			return dwRet;
+			dwRet = SNIRegisterForAccept( (HANDLE) m_ListenSocket );
+
+			if( ERROR_SUCCESS != dwRet )
+			{
+				BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+				
+				return dwRet;
+			}
 		}
 		
 		dwRet = SNICreateAccept( hSNIListener, TCP_PROV, (LPVOID) this, &m_pOverlapped );
@@ -1244,7 +1414,10 @@ public:
 
 		Assert( m_ListenSocket != INVALID_SOCKET );
 		
-		closesocket( m_ListenSocket );
+		if( FOwnsListenSocket() )
+		{
+			closesocket( m_ListenSocket );
+		}
 		m_ListenSocket = INVALID_SOCKET;
 
 		m_fTerminateListenerCalled = true;
@@ -1260,31 +1433,16 @@ private:
 	~ListenObject()
 	{
 		Assert( m_cRefCount == 0);
-	}
-
-public:
-	
-	AcceptObject	** 	m_ppAcceptObjects;
-	UINT 				m_nAcceptObjects;
-	UINT				m_nSize;
-	TcpListenInfo 		m_TcpListenInfo;
-
-	LONG			m_cRefCount;
 
-	ListenObject()
-	{
-		m_ppAcceptObjects = 0;
-		m_nAcceptObjects = 0;
-		m_nSize = 0;
-		m_cRefCount = 1;
+		if( m_csAcceptObjects != NULL )
+		{
+			DeleteCriticalSection( &m_csAcceptObjects );
+		}
 	}
 
-
-	DWORD Add( SOCKET sock, int af)
+	//check if array size is enough to add a new AcceptObject otherwise reallocate
+	DWORD EnsureSize()
 	{
-		BidxScopeAutoSNI2( SNIAPI_TAG _T("sock: %Iu{SOCKET}, af: %d\n"), sock, af );
-		
-		//check if array size is enough to add a new socket otherwise reallocate
 		if( m_nAcceptObjects == m_nSize )
 		{
 			UINT nNewSize = 0;
@@ -1317,10 +1475,54 @@ public:
 			m_ppAcceptObjects = pNew;
 		}
 
-		AcceptObject *pAcc;
+		return ERROR_SUCCESS;
+	}
+
+public:
+	
+	AcceptObject	** 	m_ppAcceptObjects;
+	UINT 				m_nAcceptObjects;
+	UINT				m_nSize;
+	TcpListenInfo 		m_TcpListenInfo;
+
+	LONG			m_cRefCount;
+
+	// Protects the AcceptObject array once accepts are posted, since 
+	// AcceptDone may add to it (see Grow).  
+	//
+	SNICritSec *	m_csAcceptObjects;
+	HANDLE			m_hSNIListener;
+	bool			m_fTerminated;
+
+	ListenObject()
+	{
+		m_ppAcceptObjects = 0;
+		m_nAcceptObjects = 0;
+		m_nSize = 0;
+		m_cRefCount = 1;
+		m_csAcceptObjects = NULL;
+		m_hSNIListener = NULL;
+		m_fTerminated = false;
+	}
+
 
+	DWORD Add( SOCKET sock, int af)
+	{
+		BidxScopeAutoSNI2( SNIAPI_TAG _T("sock: %Iu{SOCKET}, af: %d\n"), sock, af );
+		
 		DWORD dwRet;
 		
+		dwRet = EnsureSize();
+
+		if (ERROR_SUCCESS != dwRet )
+		{
+			BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+			
+			return dwRet;
+		}
+
+		AcceptObject *pAcc;
+
 		dwRet = AcceptObject::InitObject( &pAcc, sock, af, this);
 
 		if (ERROR_SUCCESS != dwRet )
@@ -1332,24 +1534,131 @@ public:
 		
 		m_ppAcceptObjects[m_nAcceptObjects++] = pAcc;
 
+		// Additional accepts for the configured minimum backlog.  These 
+		// are best effort: the socket is already owned by pAcc, so a 
+		// failure here just leaves a shallower backlog.  
+		//
+		while( (DWORD) pAcc->m_cGroup < g_cTcpAcceptMin )
+		{
+			AcceptObject *pShared;
+
+			if( ERROR_SUCCESS != EnsureSize() ||
+				ERROR_SUCCESS != AcceptObject::InitObject( &pShared, sock, af, this, pAcc) )
+			{
+				BidTrace1( ERROR_TAG _T("accept backlog: %d\n"), pAcc->m_cGroup );
+				break;
+			}
+
+			m_ppAcceptObjects[m_nAcceptObjects++] = pShared;
+		}
+
 		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
 		
 		return ERROR_SUCCESS;
 	}
 
-	//always removes a socket from the end and closes it
+	//always removes a socket from the end and closes it, along with 
+	//the AcceptObjects sharing it
 	void Remove()
 	{
 		BidxScopeAutoSNI0( SNIAPI_TAG _T("\n") );
 		
-		Assert( m_nAcceptObjects);
-		m_ppAcceptObjects[--m_nAcceptObjects]->Release();
+		AcceptObject *pAcc;
+
+		do
+		{
+			Assert( m_nAcceptObjects);
+			pAcc = m_ppAcceptObjects[--m_nAcceptObjects];
+
+			bool fOwner = pAcc->FOwnsListenSocket();
+			pAcc->Release();
+
+			if( fOwner )
+			{
+				break;
+			}
+		}
+		while( m_nAcceptObjects );
+	}
+
+	// Called from AcceptDone when an accept completed with no other accept 
+	// left posted on its socket: posts one more on that socket, unless the 
+	// configured maximum is reached.  Failures only leave the backlog as is.  
+	//
+	void Grow( AcceptObject * pPrimary )
+	{
+		BidxScopeAutoSNI1( SNIAPI_TAG _T("pPrimary: %p{AcceptObject*}\n"), pPrimary );
+
+		if( (DWORD) pPrimary->m_cGroup >= g_cTcpAcceptMax )
+		{
+			BidTraceU0( SNI_BID_TRACE_ON, RETURN_TAG _T("\n") );
+			return;
+		}
+
+		CAutoSNICritSec a_csAcceptObjects( m_csAcceptObjects, SNI_AUTOCS_ENTER );
+
+		AcceptObject *pAcc = NULL;
+		
+		DWORD dwRet = ERROR_SUCCESS;
+
+		if( m_fTerminated || (DWORD) pPrimary->m_cGroup >= g_cTcpAcceptMax )
+		{
+			goto Exit;
+		}
+		
+		dwRet = EnsureSize();
+
+		if( ERROR_SUCCESS != dwRet )
+		{
+			goto Exit;
+		}
+
+		dwRet = AcceptObject::InitObject( &pAcc, pPrimary->m_ListenSocket, pPrimary->m_AddressFamily, this, pPrimary );
+
+		if( ERROR_SUCCESS != dwRet )
+		{
+			goto Exit;
+		}
+
+		dwRet = pAcc->RegisterAcceptObject( m_hSNIListener );
+
+		if( ERROR_SUCCESS != dwRet )
+		{
+			pAcc->Release();
+			goto Exit;
+		}
+
+		m_ppAcceptObjects[m_nAcceptObjects++] = pAcc;
+
+		// If this fails the object is left with m_fPendingAccept set, 
+		// and SNIResumePendingAccepts will retry it like any other.  
+		//
+		pAcc->AddRef();
+
+		dwRet = pAcc->AsyncAccept();
+		if( ERROR_SUCCESS != dwRet )
+		{
+			pAcc->Release();
+		}
+
+	Exit:
+
+		a_csAcceptObjects.Leave();
+
+		BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("backlog: %d, %d{WINERR}\n"), pPrimary->m_cGroup, dwRet);
 	}
 
 	DWORD StartAccepting( HANDLE hSNIListener )
 	{
 		BidxScopeAutoSNI1( SNIAPI_TAG _T("hSNIListener: %p{HANDLE}\n"), hSNIListener );
 		
+		// Completions of the accepts posted here may call Grow before the 
+		// loop is done.  
+		//
+		CAutoSNICritSec a_csAcceptObjects( m_csAcceptObjects, SNI_AUTOCS_ENTER );
+
+		m_hSNIListener = hSNIListener;
+
 		// Associate listen sockets with completion port
 		UINT iAcceptObject;
 
@@ -1418,6 +1727,19 @@ public:
 	{
 		BidxScopeAutoSNI0( SNIAPI_TAG _T("\n") );
 
+		// Stop Grow from adding to the array.  The AcceptObjects sharing a 
+		// socket come after the one owning it, so they are all marked as 
+		// terminated before the socket is closed.  
+		//
+		if( m_csAcceptObjects != NULL )
+		{
+			CAutoSNICritSec a_csAcceptObjects( m_csAcceptObjects, SNI_AUTOCS_ENTER );
+
+			m_fTerminated = true;
+
+			a_csAcceptObjects.Leave();
+		}
+
 		while( m_nAcceptObjects)
 		{
 			m_nAcceptObjects--;
@@ -1447,6 +1769,10 @@ AcceptObject::AcceptObject(ListenObject* pListenObject)
 	m_pParentListenObject = pListenObject;
 	m_pParentListenObject->AddRef();
 	m_cRefCount = 1;
+	m_pPrimary = this;
+	m_cPosted = 0;
+	m_cGroup = 1;
+	m_SpareSocket = INVALID_SOCKET;
 }
 
 AcceptObject::~AcceptObject()
@@ -1459,7 +1785,7 @@ AcceptObject::~AcceptObject()
 		m_pOverlapped = 0;
 	}
 
-	if( INVALID_SOCKET != m_ListenSocket )
+	if( INVALID_SOCKET != m_ListenSocket && FOwnsListenSocket() )
 	{
 		closesocket( m_ListenSocket );
 		m_ListenSocket = INVALID_SOCKET;
@@ -1471,18 +1797,29 @@ AcceptObject::~AcceptObject()
 		m_AcceptSocket = INVALID_SOCKET;
 	}
 
+	if( INVALID_SOCKET != m_SpareSocket )
+	{
+		closesocket( m_SpareSocket );
+		m_SpareSocket = INVALID_SOCKET;
+	}
+
 	if( m_CSTerminateListener!=NULL )
 	{
 		DeleteCriticalSection(&m_CSTerminateListener);
 	}
 
+	if( !FOwnsListenSocket() )
+	{
+		m_pPrimary->Release();
+	}
+
 	m_pParentListenObject->Release();
 }
 
-DWORD AcceptObject::InitObject( __out AcceptObject **ppAccept,SOCKET ListenSocket, int AddressFamily, ListenObject * pParentListenObject)	
+DWORD AcceptObject::InitObject( __out AcceptObject **ppAccept,SOCKET ListenSocket, int AddressFamily, ListenObject * pParentListenObject, __in_opt AcceptObject * pPrimary)	
 {
-		BidxScopeAutoSNI4( SNIAPI_TAG _T("ppAccept: %p{AcceptObject**}, ListenSocket: %Iu{SOCKET}, AddressFamily: %d, pParentListenObject: %p{ListenObject*}\n"), 
-					ppAccept, ListenSocket, AddressFamily, pParentListenObject );
+		BidxScopeAutoSNI5( SNIAPI_TAG _T("ppAccept: %p{AcceptObject**}, ListenSocket: %Iu{SOCKET}, AddressFamily: %d, pParentListenObject: %p{ListenObject*}, pPrimary: %p{AcceptObject*}\n"), 
+					ppAccept, ListenSocket, AddressFamily, pParentListenObject, pPrimary );
 		
 		AcceptObject *pAccept;
 
@@ -1513,6 +1850,19 @@ DWORD AcceptObject::InitObject( __out AcceptObject **ppAccept,SOCKET ListenSocke
 		pAccept->m_ListenSocket = ListenSocket;
 		pAccept->m_AddressFamily = AddressFamily;
 
+		// Share pPrimary's listening socket; the reference keeps it (and 
+		// its counts) alive for as long as this object is.  
+		//
+		if( pPrimary )
+		{
+			Assert( pPrimary->FOwnsListenSocket() );
+			Assert( pPrimary->m_ListenSocket == ListenSocket );
+
+			pPrimary->AddRef();
+			pAccept->m_pPrimary = pPrimary;
+			InterlockedIncrement( &pPrimary->m_cGroup );
+		}
+
 		*ppAccept = pAccept;
 
 		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
@@ -1520,6 +1870,26 @@ DWORD AcceptObject::InitObject( __out AcceptObject **ppAccept,SOCKET ListenSocke
 		return ERROR_SUCCESS;
 }
 
+SOCKET AcceptObject::CreateAcceptSocket()
+{
+	SOCKET sock = socket( m_AddressFamily, SOCK_STREAM, 0);
+
+	if( INVALID_SOCKET != sock )
+	{
+		//
+		//	Prevent the handle from being inherited by child processes.  
+		//	We will ignore any errors though so that we keep listening
+		//	for incoming connections.  
+		//
+
+		SetHandleInformation( (HANDLE)sock, 
+			HANDLE_FLAG_INHERIT, 
+			~HANDLE_FLAG_INHERIT); 
+	}
+
+	return sock;
+}
+
 DWORD AcceptObject::AsyncAccept()
 {
 	BidxScopeAutoSNI0( SNIAPI_TAG _T("\n") );
@@ -1541,7 +1911,15 @@ DWORD AcceptObject::AsyncAccept()
 		goto ErrorExit;
 	}
 
-	m_AcceptSocket = socket( m_AddressFamily, SOCK_STREAM, 0);
+	if( INVALID_SOCKET != m_SpareSocket )
+	{
+		m_AcceptSocket = m_SpareSocket;
+		m_SpareSocket = INVALID_SOCKET;
+	}
+	else
+	{
+		m_AcceptSocket = CreateAcceptSocket();
+	}
 
 	if( INVALID_SOCKET == m_AcceptSocket )
 	{
@@ -1559,16 +1937,6 @@ DWORD AcceptObject::AsyncAccept()
 		goto ErrorExit;
 	}
 
-	//
-	//	Prevent the handle from being inherited by child processes.  
-	//	We will ignore any errors though so that we keep listening
-	//	for incoming connections.  
-	//
-
-	SetHandleInformation( (HANDLE)m_AcceptSocket, 
-		HANDLE_FLAG_INHERIT, 
-		~HANDLE_FLAG_INHERIT); 
-	
 	DWORD bytes_read;
 	
 	if (!AcceptEx(	m_ListenSocket,
@@ -1606,6 +1974,17 @@ DWORD AcceptObject::AsyncAccept()
 		DecrementPendingAccepts();
 	}
 
+	InterlockedIncrement( &m_pPrimary->m_cPosted );
+
+	// The accept is posted, so creating the socket for the next one no 
+	// longer leaves the port without a pending AcceptEx.  A failure here 
+	// is not an error; the next call simply creates the socket itself.  
+	//
+	if( 1 < g_cTcpAcceptMax )
+	{
+		m_SpareSocket = CreateAcceptSocket();
+	}
+
 ErrorExit:
 
 	if (dwRet != ERROR_SUCCESS)
@@ -2185,6 +2564,11 @@ public:
 			goto ErrorExit;
 		}
 		
+		if( g_fTcpLoopbackFastPath && IsLoopbackAddress( pwTargetAddress ) )
+		{
+			SetLoopbackFastPath( m_socket );
+		}
+		
 		m_pwTargetAddress = pwTargetAddress;
 		dwRet = ERROR_SUCCESS;
 		
@@ -2462,6 +2846,13 @@ OACR_WARNING_POP
 		goto ErrorExit;
 	}
 	
+	// Must be set on the listening socket for accepted loopback 
+	// connections to use the fast path.
+	if( g_fTcpLoopbackFastPath )
+	{
+		SetLoopbackFastPath( sock );
+	}
+	
 	if( SOCKET_ERROR == bind( sock, AIW->ai_addr, (int)AIW->ai_addrlen ))
 	{
 		dwRet = WSAGetLastError();
@@ -2882,6 +3273,9 @@ Tcp::Tcp(SNI_Conn * pConn) : SNI_Provider(pConn), m_pSyncReadPacket(0)
 	m_fAuto = FALSE;
 	m_pOvSendNotificaiton = NULL;
 	m_CSTuning = NULL;
+
+	m_lReadError = ERROR_SUCCESS;
+	m_dwLastReadTick = 0;
 	
 	BidObtainItemID2A( &m_iBidId, SNI_ID_TAG "%p{.} created by %u#{SNI_Conn}", 
 		this, pConn->GetBidId() );
@@ -3392,6 +3786,15 @@ DWORD Tcp::AcceptDone( SNI_Conn * pConn,
 	*ppAcceptInfo = NULL;
 
 	Tcp *pTcp = NULL;
+
+	// None of the other accepts on this socket is still posted: the 
+	// backlog was fully used by the time we got here, so deepen it.  
+	// Done once this accept is re-posted, to keep it off the path to 
+	// the listening socket having an accept outstanding again.  
+	//
+	bool fGrow = ( 0 == InterlockedDecrement( &pAcc->m_pPrimary->m_cPosted ) ) && 
+				 ( ERROR_SUCCESS == dwError ) && 
+				 ( 1 < g_cTcpAcceptMax );
 	
 	if( ERROR_SUCCESS == dwError )
 	{
@@ -3433,6 +3836,11 @@ DWORD Tcp::AcceptDone( SNI_Conn * pConn,
 	dwRet = pAcc->AsyncAccept();
 	if( ERROR_SUCCESS == dwRet )
 	{
+		if( fGrow )
+		{
+			pAcc->m_pParentListenObject->Grow( pAcc->m_pPrimary );
+		}
+
 		*ppProv = pTcp;
 
 		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
@@ -3592,6 +4000,16 @@ DWORD Tcp::GatherWriteAsync(__in SNI_Packet * pPacket, SNI_ProvInfo * pInfo)
 	DWORD dwFlags = 0;
 	LPWSAOVERLAPPED pOvl = SNIPacketOverlappedStruct(pPacket);
 	DWORD dwError = ERROR_FAIL;
+
+	if(m_fAuto && ERROR_SUCCESS != (dwError = CheckAndAdjustSendBufferSizeBasedOnISB()))
+	{
+		SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, dwError);
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwError);
+		return dwError;
+	}
+
+	// Only the first packet's OVERLAPPED is used
+	PrepareForAsyncCall(pPacket);
 	
 	SNI_Packet * pTmp = pPacket;
 
@@ -3991,14 +4409,52 @@ DWORD Tcp::Initialize(PSNI_PROVIDER_INFO pInfo)
 
 #endif
 
+	dwError = SNICritSec::Initialize( &g_csTcpAddrCache );
+	if( ERROR_SUCCESS != dwError )
+	{
+		SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, dwError );
+
+		goto ErrorExit;
+	}
+
+	// Use the overlapped GetAddrInfoExW if all of its entry points are 
+	// available (Windows 8 and later); otherwise Tcp::Open keeps using 
+	// the synchronous GetAddrInfoW.  ws2_32.dll is already loaded by 
+	// the WSAStartup() above.  
+	//
+	HMODULE hWs2_32 = GetModuleHandleW( L"ws2_32.dll" );
+
+	if( NULL != hWs2_32 )
+	{
+		g_pfnGetAddrInfoExW = (PFN_GETADDRINFOEXW) 
+			GetProcAddress( hWs2_32, "GetAddrInfoExW" );
+		g_pfnGetAddrInfoExCancel = (PFN_GETADDRINFOEXCANCEL) 
+			GetProcAddress( hWs2_32, "GetAddrInfoExCancel" );
+		g_pfnGetAddrInfoExOverlappedResult = (PFN_GETADDRINFOEXOVERLAPPEDRESULT) 
+			GetProcAddress( hWs2_32, "GetAddrInfoExOverlappedResult" );
+		g_pfnFreeAddrInfoExW = (PFN_FREEADDRINFOEXW) 
+			GetProcAddress( hWs2_32, "FreeAddrInfoExW" );
+
+		if( NULL == g_pfnGetAddrInfoExW || 
+			NULL == g_pfnGetAddrInfoExCancel || 
+			NULL == g_pfnGetAddrInfoExOverlappedResult || 
+			NULL == g_pfnFreeAddrInfoExW )
+		{
+			g_pfnGetAddrInfoExW = NULL;
+			g_pfnGetAddrInfoExCancel = NULL;
+			g_pfnGetAddrInfoExOverlappedResult = NULL;
+			g_pfnFreeAddrInfoExW = NULL;
+		}
+	}
+	BidTraceU1( SNI_BID_TRACE_ON, SNI_TAG _T("Overlapped GetAddrInfoExW available: %d{BOOL}\n"), NULL != g_pfnGetAddrInfoExW );
+
+	// Fill all these up
+	pInfo->fBaseProv = TRUE;
+	pInfo->Size = 0;
+	pInfo->Offset = 0;
+	pInfo->ProvNum = TCP_PROV;
+	pInfo->fInitialized = TRUE; 
 
-	// Fill all these up
-	pInfo->fBaseProv = TRUE;
-	pInfo->Size = 0;
-	pInfo->Offset = 0;
-	pInfo->ProvNum = TCP_PROV;
-	pInfo->fInitialized = TRUE; 
-
 ErrorExit:
 	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwError);
 	
@@ -4037,6 +4493,15 @@ DWORD Tcp::InitializeListener(HANDLE hSNIListener, __inout TcpListenInfo *pListe
 		goto ErrorExit;
 	}
 
+	dwRet = SNICritSec::Initialize( &pListenObject->m_csAcceptObjects );
+
+	if( ERROR_SUCCESS != dwRet )
+	{
+		SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, dwRet );
+
+		goto ErrorExit;
+	}
+
 	g_fIpv6Supported = IsIpVersionSupported( AF_INET6 );
 	g_fIpv4Supported = IsIpVersionSupported( AF_INET );
 	
@@ -4126,13 +4591,14 @@ bool Tcp::IsNumericAddress( LPWSTR name)
 }
 
 // Using ConnectEx, create a connected socket based on the specified linked list of ADDRINFO, by opening sockets in parallel.
-DWORD Tcp::SocketOpenParallel(const ADDRINFOW *AIW, DWORD timeout)
+DWORD Tcp::SocketOpenParallel(const ADDRINFOW *AIW, DWORD timeout, DWORD dwStaggerDelay)
 {
-	BidxScopeAutoSNI4( SNIAPI_TAG _T("%u#, ")
+	BidxScopeAutoSNI5( SNIAPI_TAG _T("%u#, ")
 								  _T("AIW: %p{ADDRINFOW*}, ")
 								  _T("ai_family: %d, ")
-								  _T("timeout: %d\n"),
-								  m_iBidId, AIW, AIW->ai_family, timeout);
+								  _T("timeout: %d, ")
+								  _T("dwStaggerDelay: %u\n"),
+								  m_iBidId, AIW, AIW->ai_family, timeout, dwStaggerDelay);
 	DWORD dwRet = ERROR_SUCCESS;
 	Assert(NULL != AIW);
 	
@@ -4143,6 +4609,9 @@ DWORD Tcp::SocketOpenParallel(const ADDRINFOW *AIW, DWORD timeout)
 	TcpConnection *pTcpConnections = NULL;
 	TcpConnection **ppPendingTcpConnections = NULL;
 	HANDLE *rgConnectionEvents = NULL;
+	const ADDRINFOW **rgpTargets = NULL;	// target addresses in the order they are tried
+	DWORD dwNextTarget = 0;
+	DWORD dwNextStartTick = dwStart;
 	
 	// walk the struct and find out how many addresses it has.
 	const ADDRINFOW *pAIWTemp = AIW;
@@ -4185,43 +4654,129 @@ DWORD Tcp::SocketOpenParallel(const ADDRINFOW *AIW, DWORD timeout)
 		goto Exit;
 	}
 	
-	pAIWTemp = AIW;
-	for(DWORD i=0;i<dwAddresses;i++)
+	rgpTargets = NewNoX(gpmo) const ADDRINFOW*[dwAddresses];
+	if( NULL == rgpTargets )
 	{
-		Assert(NULL != pAIWTemp);
+		dwRet = ERROR_OUTOFMEMORY;
+		SNI_SET_LAST_ERROR(TCP_PROV, SNIE_10, dwRet);
+		goto Exit;
+	}
 
-		// For each of these TcpConnection API calls, we have nothing to do in case of actual failure, except 
-		// to move on to the next address. If all the parallel connection attempts eventually fail, the 
-		// error code from wherever the failure occurred will be considered in calculating the overall return code,
-		// but that consideration will be done by the TcpConnection objects themselves, not by this function.
+	if( 0 == dwStaggerDelay )
+	{
+		// Start everything at once, in the order the resolver returned.
+		pAIWTemp = AIW;
+		for(DWORD i=0;i<dwAddresses;i++)
+		{
+			rgpTargets[i] = pAIWTemp;
+			pAIWTemp = pAIWTemp->ai_next;
+		}
+	}
+	else
+	{
+		// Alternate between the address families (RFC 8305), IPv4 first 
+		// for the same reason Tcp::Open tries IPv4 first sequentially.  
+		const ADDRINFOW *pNextV4 = AIW;
+		const ADDRINFOW *pNextV6 = AIW;
+		const ADDRINFOW *pNextOther = AIW;
+		DWORD dwTargets = 0;
 		
-		if( ERROR_SUCCESS == pTcpConnections[i].FInit(this, pAIWTemp) )
+		while( dwTargets < dwAddresses )
 		{
-			if( ERROR_SUCCESS == pTcpConnections[i].FInitForAsync() )
+			DWORD dwTargetsBefore = dwTargets;
+			
+			while( NULL != pNextV4 && AF_INET != pNextV4->ai_family )
+				pNextV4 = pNextV4->ai_next;
+			if( NULL != pNextV4 )
+			{
+				rgpTargets[dwTargets++] = pNextV4;
+				pNextV4 = pNextV4->ai_next;
+			}
+			
+			while( NULL != pNextV6 && AF_INET6 != pNextV6->ai_family )
+				pNextV6 = pNextV6->ai_next;
+			if( NULL != pNextV6 )
+			{
+				rgpTargets[dwTargets++] = pNextV6;
+				pNextV6 = pNextV6->ai_next;
+			}
+			
+			if( dwTargets == dwTargetsBefore )
 			{
-				DWORD dwAsyncOpenError = pTcpConnections[i].AsyncOpen();
-				if( ERROR_SUCCESS == dwAsyncOpenError )
+				// Only other families are left; append them unchanged.
+				for( ; NULL != pNextOther; pNextOther = pNextOther->ai_next )
 				{
-					// Connection succeeded. Retrieve the connected socket and exit.
-					m_sock = pTcpConnections[i].RelinquishSocket();
-					goto Exit;
+					if( AF_INET != pNextOther->ai_family && AF_INET6 != pNextOther->ai_family )
+						rgpTargets[dwTargets++] = pNextOther;
 				}
-				else if( ERROR_IO_PENDING == dwAsyncOpenError )
+				break;
+			}
+		}
+		Assert( dwTargets == dwAddresses );
+	}
+
+	for(;;)
+	{
+		// Start the next attempts: all of them when not staggering, otherwise one each 
+		// time the stagger delay has passed, or immediately when nothing is pending 
+		// because every earlier attempt already failed.
+		while( dwNextTarget < dwAddresses && 
+			(0 == dwStaggerDelay || 0 == dwConnectionsPending || (int)(GetTickCount() - dwNextStartTick) >= 0) )
+		{
+			TcpConnection *pConnection = &(pTcpConnections[dwNextTarget]);
+			const ADDRINFOW *pTarget = rgpTargets[dwNextTarget];
+			dwNextTarget++;
+			m_pConn->m_ConnInfo.OpenTimings.cAddressAttempts++;
+
+			// For each of these TcpConnection API calls, we have nothing to do in case of actual failure, except 
+			// to move on to the next address. If all the parallel connection attempts eventually fail, the 
+			// error code from wherever the failure occurred will be considered in calculating the overall return code,
+			// but that consideration will be done by the TcpConnection objects themselves, not by this function.
+			
+			if( ERROR_SUCCESS == pConnection->FInit(this, pTarget) )
+			{
+				if( ERROR_SUCCESS == pConnection->FInitForAsync() )
 				{
-					// Overlapped was pending. Add the object and its Event handle to our pending lists and continue on to the next target address.
-					ppPendingTcpConnections[dwConnectionsPending] = &(pTcpConnections[i]);
-					rgConnectionEvents[dwConnectionsPending] = (pTcpConnections[i]).GetEventForOutstandingOverlappedIO();
-					dwConnectionsPending++;
+					DWORD dwAsyncOpenError = pConnection->AsyncOpen();
+					if( ERROR_SUCCESS == dwAsyncOpenError )
+					{
+						// Connection succeeded. Retrieve the connected socket and exit.
+						m_sock = pConnection->RelinquishSocket();
+						goto Exit;
+					}
+					else if( ERROR_IO_PENDING == dwAsyncOpenError )
+					{
+						// Overlapped was pending. Add the object and its Event handle to our pending lists and continue on to the next target address.
+						ppPendingTcpConnections[dwConnectionsPending] = pConnection;
+						rgConnectionEvents[dwConnectionsPending] = pConnection->GetEventForOutstandingOverlappedIO();
+						dwConnectionsPending++;
+						dwNextStartTick = GetTickCount() + dwStaggerDelay;
+					}
 				}
 			}
 		}
-		pAIWTemp = pAIWTemp->ai_next;
-	}
 
-	while( 0 < dwConnectionsPending )
-	{		
+		if( 0 == dwConnectionsPending )
+		{
+			break;
+		}
+
+		// While there are attempts left to start, wake up in time for the next one.
+		DWORD dwWait = timeleft;
+		bool fStaggerWait = false;
+		if( 0 != dwStaggerDelay && dwNextTarget < dwAddresses )
+		{
+			int iUntilNext = (int)(dwNextStartTick - GetTickCount());
+			DWORD dwUntilNext = (0 < iUntilNext) ? (DWORD)iUntilNext : 0;
+			if( dwUntilNext < dwWait )
+			{
+				dwWait = dwUntilNext;
+				fStaggerWait = true;
+			}
+		}
+		
 		// Wait for *any* of the pending Overlapped IOs' event handles to complete
-		dwRet = WaitForMultipleObjects(dwConnectionsPending, rgConnectionEvents, FALSE /*bWaitAll*/, timeleft );
+		dwRet = WaitForMultipleObjects(dwConnectionsPending, rgConnectionEvents, FALSE /*bWaitAll*/, dwWait );
 		
 		// if this C_ASSERT were false, the if condition below it would also need to check that WAIT_OBJECT_0 <= dwRet. Since the C_ASSERT is true,
 		// that additional check would result in a compiler warning that the expression is always true...
@@ -4264,6 +4819,10 @@ DWORD Tcp::SocketOpenParallel(const ADDRINFOW *AIW, DWORD timeout)
 			dwRet = TcpConnection::CalculateReturnCode(pTcpConnections, dwAddresses, dwRet, TcpConnectionErrorLevel_WaitForObjects);
 			goto Exit;
 		}
+		else if( WAIT_TIMEOUT == dwRet && fStaggerWait )
+		{
+			// Time to start the next attempt; the pending ones keep running.
+		}
 		else
 		{
 			// either a timeout, or an unexpected return code from WaitForMultipleObjects. Either way, use the return code Windows gave us.
@@ -4357,8 +4916,13 @@ Exit:
 		delete []rgConnectionEvents;
 		rgConnectionEvents = NULL;
 	}
+	if( NULL != rgpTargets )
+	{
+		delete []rgpTargets;
+		rgpTargets = NULL;
+	}
 	
-	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+	BidTraceU2( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}, attempts started: %u\n"), dwRet, dwNextTarget);
 	return dwRet;
 }
 
@@ -4456,7 +5020,7 @@ inline DWORD Tcp::ComputeNewTimeout(DWORD timeout, DWORD dwStart)
 	}
 }
 
-DWORD Tcp::ParallelOpen(__in ADDRINFOW *AddrInfoW, int timeout, DWORD dwStartTickCount)
+DWORD Tcp::ParallelOpen(__in ADDRINFOW *AddrInfoW, int timeout, DWORD dwStartTickCount, DWORD dwStaggerDelay)
 {
 	int timeleft = timeout;
 
@@ -4480,7 +5044,7 @@ DWORD Tcp::ParallelOpen(__in ADDRINFOW *AddrInfoW, int timeout, DWORD dwStartTic
 		BidTraceU1(SNI_BID_TRACE_ON, SNI_TAG _T("timeout remaining: %d\n"), timeleft);
 	}
 
-	DWORD dwRet = SocketOpenParallel(AddrInfoW, timeleft);
+	DWORD dwRet = SocketOpenParallel(AddrInfoW, timeleft, dwStaggerDelay);
 	// Should have a valid socket handle IFF SocketOpenParallel returned success.
 	Assert((ERROR_SUCCESS == dwRet && m_sock != INVALID_SOCKET) || (ERROR_SUCCESS != dwRet && m_sock == INVALID_SOCKET));
 	if (dwRet != ERROR_SUCCESS)
@@ -4496,6 +5060,540 @@ DWORD Tcp::ParallelOpen(__in ADDRINFOW *AddrInfoW, int timeout, DWORD dwStartTic
 	return dwRet;
 }
 
+// Copies an ADDRINFOW or SNI_ADDRINFOEXW list into a single allocation 
+// owned by SNI, so that lists from either resolver, and from the address 
+// cache, are all freed with FreeResolvedAddrInfo().  
+//
+template <class T>
+static DWORD CopyAddrInfo( __in_opt const T * pSrc, __out ADDRINFOW ** ppCopy )
+{
+	const T * p;
+	size_t cb = 0;
+
+	*ppCopy = NULL;
+
+	for( p = pSrc; NULL != p; p = p->ai_next )
+	{
+		cb += sizeof(ADDRINFOW) + ((p->ai_addrlen + sizeof(void *) - 1) & ~(sizeof(void *) - 1));
+	}
+
+	if( 0 == cb )
+	{
+		return ERROR_SUCCESS;
+	}
+
+	BYTE * pb = NewNoX(gpmo) BYTE[cb];
+	if( NULL == pb )
+	{
+		return ERROR_OUTOFMEMORY;
+	}
+
+	ADDRINFOW ** ppNext = ppCopy;
+
+	for( p = pSrc; NULL != p; p = p->ai_next )
+	{
+		ADDRINFOW * pAI = (ADDRINFOW *) pb;
+		pb += sizeof(ADDRINFOW);
+
+		pAI->ai_flags = p->ai_flags;
+		pAI->ai_family = p->ai_family;
+		pAI->ai_socktype = p->ai_socktype;
+		pAI->ai_protocol = p->ai_protocol;
+		pAI->ai_addrlen = p->ai_addrlen;
+		pAI->ai_canonname = NULL;
+		pAI->ai_addr = (sockaddr *) pb;
+		pAI->ai_next = NULL;
+		memcpy( pAI->ai_addr, p->ai_addr, p->ai_addrlen );
+		pb += (p->ai_addrlen + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+
+		*ppNext = pAI;
+		ppNext = &pAI->ai_next;
+	}
+
+	return ERROR_SUCCESS;
+}
+
+void Tcp::FreeResolvedAddrInfo( __in_opt ADDRINFOW * pAddrInfo )
+{
+	// The whole list lives in the block starting at its first element.
+	delete [] (BYTE *) pAddrInfo;
+}
+
+//---------------------------------------------------------------------
+// Function: Tcp::GetAddrInfoTimed
+//
+// Description:
+//	Resolves wszServer/wszPort.  Where the overlapped GetAddrInfoExW is 
+//	available, the lookup is abandoned once the connection timeout has 
+//	run out (but never waits less than MIN_PARALLEL_WAIT_TIME, like 
+//	ParallelOpen); otherwise this is a plain GetAddrInfoW call.  
+//
+// Returns:
+//	ERROR_SUCCESS, with *ppAddrInfo to be freed by FreeResolvedAddrInfo().  
+//	WSA_WAIT_TIMEOUT if the lookup was cancelled, or a Winsock error.  
+//
+DWORD Tcp::GetAddrInfoTimed( __in LPCWSTR wszServer, 
+							  __in LPCWSTR wszPort, 
+							  __in const ADDRINFOW * pHints, 
+							  int timeout, 
+							  DWORD dwStart, 
+							  __out ADDRINFOW ** ppAddrInfo )
+{
+	DWORD dwRet;
+
+	*ppAddrInfo = NULL;
+
+	if( NULL == g_pfnGetAddrInfoExW || INFINITE == timeout )
+	{
+		ADDRINFOW * pAI = NULL;
+
+		if( GetAddrInfoW_l( wszServer, wszPort, pHints, &pAI, GetDefaultLocale()) )
+		{
+			return WSAGetLastError();
+		}
+
+		dwRet = CopyAddrInfo( pAI, ppAddrInfo );
+		FreeAddrInfoW( pAI );
+		return dwRet;
+	}
+
+	SNI_ADDRINFOEXW HintsEx;
+	SNI_ADDRINFOEXW * pAIEx = NULL;
+	OVERLAPPED Overlapped;
+	HANDLE hCancel = NULL;
+
+	memset( &HintsEx, 0, sizeof(HintsEx) );
+	HintsEx.ai_flags = pHints->ai_flags;
+	HintsEx.ai_family = pHints->ai_family;
+	HintsEx.ai_socktype = pHints->ai_socktype;
+
+	memset( &Overlapped, 0, sizeof(Overlapped) );
+	Overlapped.hEvent = CreateEventW( NULL, TRUE, FALSE, NULL );
+	if( NULL == Overlapped.hEvent )
+	{
+		return GetLastError();
+	}
+
+	dwRet = g_pfnGetAddrInfoExW( wszServer, wszPort, NS_ALL, NULL, &HintsEx, &pAIEx, NULL, &Overlapped, NULL, &hCancel );
+
+	if( WSA_IO_PENDING == dwRet )
+	{
+		BOOL fTimedOut = FALSE;
+		DWORD dwWait = ComputeNewTimeout( timeout < 0 ? 0 : timeout, dwStart );
+
+		if( 0 == dwWait )
+		{
+			dwWait = MIN_PARALLEL_WAIT_TIME;
+		}
+
+		if( WAIT_OBJECT_0 != WaitForSingleObject( Overlapped.hEvent, dwWait ) )
+		{
+			// The OVERLAPPED and pAIEx must stay valid until the lookup 
+			// completes, so wait for the cancellation to be acknowledged.
+			//
+			g_pfnGetAddrInfoExCancel( &hCancel );
+			WaitForSingleObject( Overlapped.hEvent, INFINITE );
+			fTimedOut = TRUE;
+		}
+
+		dwRet = g_pfnGetAddrInfoExOverlappedResult( &Overlapped );
+
+		// A lookup that finished just before the cancellation is still good.
+		if( fTimedOut && ERROR_SUCCESS != dwRet )
+		{
+			BidTrace1( ERROR_TAG _T("name resolution timed out after %u ms\n"), dwWait );
+			dwRet = WSA_WAIT_TIMEOUT;
+		}
+	}
+
+	if( ERROR_SUCCESS == dwRet )
+	{
+		dwRet = CopyAddrInfo( pAIEx, ppAddrInfo );
+	}
+
+	if( NULL != pAIEx )
+	{
+		g_pfnFreeAddrInfoExW( pAIEx );
+	}
+
+	CloseHandle( Overlapped.hEvent );
+
+	return dwRet;
+}
+
+//---------------------------------------------------------------------
+// Function: Tcp::ResolveAddress
+//
+// Description:
+//	Resolves the server name and port for Tcp::Open, consulting the 
+//	address cache first when it is enabled.  Only successful lookups and 
+//	EAI_NONAME are cached; transient failures are always retried.  
+//
+DWORD Tcp::ResolveAddress( __in LPCWSTR wszServer, 
+							__in LPCWSTR wszPort, 
+							int timeout, 
+							DWORD dwStart, 
+							__out ADDRINFOW ** ppAddrInfo )
+{
+	BidxScopeAutoSNI4( SNIAPI_TAG _T( "wszServer: '%ls', ")
+								_T("wszPort: '%ls', ")
+								_T("timeout: %d, ")
+								_T("ppAddrInfo: %p{ADDRINFOW**}\n"), 
+								wszServer, wszPort, timeout, ppAddrInfo );
+
+	DWORD dwRet;
+	ADDRINFOW Hints;
+
+	*ppAddrInfo = NULL;
+
+	if( AddrCacheLookup( wszServer, wszPort, &dwRet, ppAddrInfo ) )
+	{
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}, cached\n"), dwRet);
+		return dwRet;
+	}
+
+	memset(&Hints, 0, sizeof(Hints));
+	Hints.ai_family = PF_UNSPEC;
+	Hints.ai_socktype = SOCK_STREAM;
+
+	dwRet = GetAddrInfoTimed( wszServer, wszPort, &Hints, timeout, dwStart, ppAddrInfo );
+
+	if( EAI_NONAME == dwRet )
+	{
+		//For numeric name in form of three-part address, e.g. 127.0.1 or two-part address, e.g. 127.1, retry getaddrinfo with AI_NUMERICHOST 
+		// as hint.ai_flags;			
+		Hints.ai_flags |=  AI_NUMERICHOST;			
+		dwRet = GetAddrInfoTimed( wszServer, wszPort, &Hints, timeout, dwStart, ppAddrInfo );
+	}
+
+	if( ERROR_SUCCESS == dwRet || EAI_NONAME == dwRet )
+	{
+		AddrCacheInsert( wszServer, wszPort, dwRet, *ppAddrInfo );
+	}
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
+	return dwRet;
+}
+
+// Returns TRUE if an unexpired entry exists for wszServer/wszPort, with 
+// the cached result in *pdwError and, on success, a copy of the cached 
+// addresses in *ppAddrInfo.  
+//
+BOOL Tcp::AddrCacheLookup( __in LPCWSTR wszServer, 
+							__in LPCWSTR wszPort, 
+							__out DWORD * pdwError, 
+							__out ADDRINFOW ** ppAddrInfo )
+{
+	BOOL fHit = FALSE;
+
+	if( 0 == g_dwTcpAddrCacheTtl && 0 == g_dwTcpAddrCacheNegativeTtl )
+	{
+		return FALSE;
+	}
+
+	CAutoSNICritSec a_csCache( g_csTcpAddrCache, SNI_AUTOCS_ENTER );
+
+	for( int i = 0; i < TCP_ADDR_CACHE_SIZE; i++ )
+	{
+		TcpAddrCacheEntry * pEntry = &g_rgTcpAddrCache[i];
+
+		if( L'\0' == pEntry->wszServer[0] || 
+			_wcsicmp( pEntry->wszServer, wszServer ) || 
+			wcscmp( pEntry->wszPort, wszPort ) )
+		{
+			continue;
+		}
+
+		DWORD dwTtl = (ERROR_SUCCESS == pEntry->dwError) ? g_dwTcpAddrCacheTtl : g_dwTcpAddrCacheNegativeTtl;
+
+		if( (DWORD)(GetTickCount() - pEntry->dwInsertTick) >= dwTtl )
+		{
+			break;
+		}
+
+		*pdwError = pEntry->dwError;
+		if( ERROR_SUCCESS == pEntry->dwError )
+		{
+			*pdwError = CopyAddrInfo( pEntry->pAddrInfo, ppAddrInfo );
+		}
+		fHit = TRUE;
+		break;
+	}
+
+	a_csCache.Leave(); 
+
+	return fHit;
+}
+
+void Tcp::AddrCacheInsert( __in LPCWSTR wszServer, 
+							__in LPCWSTR wszPort, 
+							DWORD dwError, 
+							__in_opt const ADDRINFOW * pAddrInfo )
+{
+	ADDRINFOW * pCopy = NULL;
+
+	if( 0 == ((ERROR_SUCCESS == dwError) ? g_dwTcpAddrCacheTtl : g_dwTcpAddrCacheNegativeTtl) )
+	{
+		return;
+	}
+
+	if( wcslen( wszServer ) > MAX_NAME_SIZE || wcslen( wszPort ) > MAX_PROTOCOLPARAMETER_LENGTH )
+	{
+		return;
+	}
+
+	if( ERROR_SUCCESS == dwError && ERROR_SUCCESS != CopyAddrInfo( pAddrInfo, &pCopy ) )
+	{
+		return;
+	}
+
+	CAutoSNICritSec a_csCache( g_csTcpAddrCache, SNI_AUTOCS_ENTER );
+
+	// Reuse the entry for this name if there is one, otherwise an empty 
+	// slot, otherwise the oldest entry.
+	//
+	TcpAddrCacheEntry * pVictim = NULL;
+	DWORD dwNow = GetTickCount();
+
+	for( int i = 0; i < TCP_ADDR_CACHE_SIZE; i++ )
+	{
+		TcpAddrCacheEntry * pEntry = &g_rgTcpAddrCache[i];
+
+		if( L'\0' == pEntry->wszServer[0] )
+		{
+			if( NULL == pVictim || L'\0' != pVictim->wszServer[0] )
+			{
+				pVictim = pEntry;
+			}
+			continue;
+		}
+
+		if( !_wcsicmp( pEntry->wszServer, wszServer ) && !wcscmp( pEntry->wszPort, wszPort ) )
+		{
+			pVictim = pEntry;
+			break;
+		}
+
+		if( NULL == pVictim || 
+			(L'\0' != pVictim->wszServer[0] && 
+			 (DWORD)(dwNow - pEntry->dwInsertTick) > (DWORD)(dwNow - pVictim->dwInsertTick)) )
+		{
+			pVictim = pEntry;
+		}
+	}
+
+	Assert( NULL != pVictim );
+
+	FreeResolvedAddrInfo( pVictim->pAddrInfo );
+
+	(void) StringCchCopyW( pVictim->wszServer, ARRAYSIZE(pVictim->wszServer), wszServer );
+	(void) StringCchCopyW( pVictim->wszPort, ARRAYSIZE(pVictim->wszPort), wszPort );
+	pVictim->dwInsertTick = dwNow;
+	pVictim->dwError = dwError;
+	pVictim->pAddrInfo = pCopy;
+
+	a_csCache.Leave(); 
+}
+
+void Tcp::AddrCacheRemove( __in LPCWSTR wszServer, __in LPCWSTR wszPort )
+{
+	if( NULL == g_csTcpAddrCache )
+	{
+		return;
+	}
+
+	CAutoSNICritSec a_csCache( g_csTcpAddrCache, SNI_AUTOCS_ENTER );
+
+	for( int i = 0; i < TCP_ADDR_CACHE_SIZE; i++ )
+	{
+		TcpAddrCacheEntry * pEntry = &g_rgTcpAddrCache[i];
+
+		if( L'\0' != pEntry->wszServer[0] && 
+			!_wcsicmp( pEntry->wszServer, wszServer ) && 
+			!wcscmp( pEntry->wszPort, wszPort ) )
+		{
+			FreeResolvedAddrInfo( pEntry->pAddrInfo );
+			memset( pEntry, 0, sizeof(*pEntry) );
+			break;
+		}
+	}
+
+	a_csCache.Leave(); 
+}
+
+// Moves the cached address matching pAddr to the front of the cached list 
+// for wszServer/wszPort, swapping it with the address that was first.  
+//
+void Tcp::AddrCachePromote( __in LPCWSTR wszServer, __in LPCWSTR wszPort, __in const sockaddr * pAddr )
+{
+	if( 0 == g_dwTcpAddrCacheTtl )
+	{
+		return;
+	}
+
+	CAutoSNICritSec a_csCache( g_csTcpAddrCache, SNI_AUTOCS_ENTER );
+
+	for( int i = 0; i < TCP_ADDR_CACHE_SIZE; i++ )
+	{
+		TcpAddrCacheEntry * pEntry = &g_rgTcpAddrCache[i];
+
+		if( L'\0' == pEntry->wszServer[0] || 
+			NULL == pEntry->pAddrInfo || 
+			_wcsicmp( pEntry->wszServer, wszServer ) || 
+			wcscmp( pEntry->wszPort, wszPort ) )
+		{
+			continue;
+		}
+
+		ADDRINFOW * pFirst = pEntry->pAddrInfo;
+
+		for( ADDRINFOW * pAI = pFirst->ai_next; NULL != pAI; pAI = pAI->ai_next )
+		{
+			if( pAI->ai_family != pAddr->sa_family )
+			{
+				continue;
+			}
+
+			if( (AF_INET == pAI->ai_family && 
+				 !memcmp( &((SOCKADDR_IN *) pAI->ai_addr)->sin_addr, &((SOCKADDR_IN *) pAddr)->sin_addr, sizeof(IN_ADDR) )) || 
+				(AF_INET6 == pAI->ai_family && 
+				 !memcmp( &((SOCKADDR_IN6 *) pAI->ai_addr)->sin6_addr, &((SOCKADDR_IN6 *) pAddr)->sin6_addr, sizeof(IN6_ADDR) )) )
+			{
+				// Swap the contents rather than relinking, the first 
+				// element has to stay at the start of the allocation.
+				ADDRINFOW Temp = *pFirst;
+
+				pFirst->ai_flags = pAI->ai_flags;
+				pFirst->ai_family = pAI->ai_family;
+				pFirst->ai_socktype = pAI->ai_socktype;
+				pFirst->ai_protocol = pAI->ai_protocol;
+				pFirst->ai_addrlen = pAI->ai_addrlen;
+				pFirst->ai_addr = pAI->ai_addr;
+
+				pAI->ai_flags = Temp.ai_flags;
+				pAI->ai_family = Temp.ai_family;
+				pAI->ai_socktype = Temp.ai_socktype;
+				pAI->ai_protocol = Temp.ai_protocol;
+				pAI->ai_addrlen = Temp.ai_addrlen;
+				pAI->ai_addr = Temp.ai_addr;
+
+				BidTraceU1( SNI_BID_TRACE_ON, SNI_TAG _T("promoted cached address for '%ls'\n"), wszServer );
+				break;
+			}
+		}
+		break;
+	}
+
+	a_csCache.Leave(); 
+}
+
+void Tcp::AddrCacheFlush()
+{
+	if( NULL == g_csTcpAddrCache )
+	{
+		return;
+	}
+
+	CAutoSNICritSec a_csCache( g_csTcpAddrCache, SNI_AUTOCS_ENTER );
+
+	for( int i = 0; i < TCP_ADDR_CACHE_SIZE; i++ )
+	{
+		FreeResolvedAddrInfo( g_rgTcpAddrCache[i].pAddrInfo );
+		memset( &g_rgTcpAddrCache[i], 0, sizeof(g_rgTcpAddrCache[i]) );
+	}
+
+	a_csCache.Leave(); 
+}
+
+// Opt-in: lets Tcp::Open reuse resolved server addresses for dwTtl 
+// milliseconds, and remember names that do not exist for dwNegativeTtl 
+// milliseconds.  Zero disables either; changing the TTLs drops the 
+// current entries.  
+//
+DWORD SNISetTcpAddressCache( DWORD dwTtl, DWORD dwNegativeTtl )
+{
+	BidxScopeAutoSNI2( SNIAPI_TAG _T( "dwTtl: %u, dwNegativeTtl: %u\n"), dwTtl, dwNegativeTtl);
+
+	g_dwTcpAddrCacheTtl = dwTtl;
+	g_dwTcpAddrCacheNegativeTtl = dwNegativeTtl;
+
+	Tcp::AddrCacheFlush();
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+// Opt-in: starts the connection attempts to a name with several addresses 
+// dwDelay milliseconds apart (RFC 8305 suggests 250), alternating between 
+// IPv4 and IPv6, instead of one after the other.  Zero turns it off.  Does 
+// not change MultiSubnetFailover, which starts all attempts at once.  
+//
+DWORD SNISetTcpConnectStagger( DWORD dwDelay )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "dwDelay: %u\n"), dwDelay);
+
+	g_dwTcpConnectStaggerDelay = dwDelay;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+// Opt-in: sets SIO_LOOPBACK_FAST_PATH on new listening sockets and on 
+// client sockets connecting to a loopback address.  Affects sockets 
+// created after the call.  
+//
+// Opt-in: a read that completed less than dwIdle milliseconds ago lets 
+// SNICheckConnection report a TCP connection as alive without polling 
+// it.  Zero polls on every check.  
+//
+DWORD SNISetTcpCheckConnectionIdle( DWORD dwIdle )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "dwIdle: %u\n"), dwIdle);
+
+	g_dwTcpCheckConnectionIdle = dwIdle;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+DWORD SNISetTcpLoopbackFastPath( BOOL fEnable )
+{
+	BidxScopeAutoSNI1( SNIAPI_TAG _T( "fEnable: %d{BOOL}\n"), fEnable);
+
+	g_fTcpLoopbackFastPath = fEnable;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
+// Opt-in: keeps between cMin and cMax AcceptEx calls posted on each 
+// listening socket, growing towards cMax as connections arrive faster 
+// than the accepts are re-posted.  Affects listeners created after the 
+// call.  
+//
+DWORD SNISetTcpAcceptBacklog( DWORD cMin, DWORD cMax )
+{
+	BidxScopeAutoSNI2( SNIAPI_TAG _T( "cMin: %u, cMax: %u\n"), cMin, cMax);
+
+	if( 0 == cMin || cMin > cMax || TCP_ACCEPT_BACKLOG_LIMIT < cMax )
+	{
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_INVALID_PARAMETER);
+		
+		return ERROR_INVALID_PARAMETER;
+	}
+
+	g_cTcpAcceptMin = cMin;
+	g_cTcpAcceptMax = cMax;
+
+	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	
+	return ERROR_SUCCESS;
+}
+
 DWORD Tcp::Open( 	SNI_Conn 		* pConn,
 					ProtElem 		* pProtElem, 
 					__out SNI_Provider 	** ppProv,
@@ -4532,35 +5630,23 @@ DWORD Tcp::Open( 	SNI_Conn 		* pConn,
 		goto ErrorExit;
 	}
 
+	// Allocated by ResolveAddress(), free with FreeResolvedAddrInfo().
 	ADDRINFOW *AddrInfoW = NULL;
-	ADDRINFOW Hints;
+	DWORD dwConnectStart;
 
-	memset(&Hints, 0, sizeof(Hints));
-	Hints.ai_family = PF_UNSPEC;
-	Hints.ai_socktype = SOCK_STREAM;
+	dwRet = ResolveAddress( pProtElem->m_wszServerName, pProtElem->Tcp.wszPort, timeout, dwStart, &AddrInfoW );
+
+	dwConnectStart = GetTickCount();
+	pConn->m_ConnInfo.OpenTimings.dwResolve += dwConnectStart - dwStart;
 
-	if( GetAddrInfoW_l( pProtElem->m_wszServerName, pProtElem->Tcp.wszPort, &Hints, &AddrInfoW, GetDefaultLocale()))
+	if( ERROR_SUCCESS != dwRet )
 	{
-		dwRet = WSAGetLastError();
-		if ( EAI_NONAME == dwRet )
-		{
-			//For numeric name in form of three-part address, e.g. 127.0.1 or two-part address, e.g. 127.1, retry getaddrinfo with AI_NUMERICHOST 
-			// as hint.ai_flags;			
-			Hints.ai_flags |=  AI_NUMERICHOST;			
-			if( GetAddrInfoW_l( pProtElem->m_wszServerName, pProtElem->Tcp.wszPort, &Hints, &AddrInfoW, GetDefaultLocale()))				
-			{
-				dwRet = WSAGetLastError();			
-				SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, dwRet );
-				goto ErrorExit;
-			}
-		}
-		else
-		{
-			SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, dwRet );
-			goto ErrorExit;
-		}
+		SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, dwRet );
+		goto ErrorExit;
 	}
 
+	pConn->m_ConnInfo.OpenTimings.cAddresses = GetAddrCount(AddrInfoW);
+
 	dwRet = ERROR_SUCCESS;
 	// When TransparentNetworkResolution:
 	// 1. Try first IP addr with 500ms timeout, if the server has more than 64 IP addrs, using sequential connection and original timeout 
@@ -4576,7 +5662,21 @@ DWORD Tcp::Open( 	SNI_Conn 		* pConn,
     if (pProtElem->Tcp.fParallel || (pProtElem->Tcp.transparentNetworkIPResolution == TransparentNetworkResolutionMode::ParallelMode && !fAddrInfoCountGreaterThan64))
 	{
 		Assert(!fAddrInfoCountGreaterThan64);
-		dwRet = pTcpProv->ParallelOpen(AddrInfoW, timeout, dwStart);
+		dwRet = pTcpProv->ParallelOpen(AddrInfoW, timeout, dwStart, 0);
+		if (dwRet != ERROR_SUCCESS)
+		{
+			goto ErrorExit;
+		}
+	}
+	else if (0 != g_dwTcpConnectStaggerDelay && 
+		pProtElem->Tcp.transparentNetworkIPResolution == TransparentNetworkResolutionMode::DisabledMode && 
+		1 < GetAddrCount(AddrInfoW) && GetAddrCount(AddrInfoW) <= 64)
+	{
+		// Start the addresses one stagger delay apart instead of giving each 
+		// its own timeout in turn, so a dead first address costs the delay 
+		// rather than a connect timeout.  
+		//
+		dwRet = pTcpProv->ParallelOpen(AddrInfoW, timeout, dwStart, g_dwTcpConnectStaggerDelay);
 		if (dwRet != ERROR_SUCCESS)
 		{
 			goto ErrorExit;
@@ -4626,6 +5726,8 @@ DWORD Tcp::Open( 	SNI_Conn 		* pConn,
 				//TDS will cap the total timeout with necessary tolerance to decide whether this connection should 
 				//succeed.
 				//
+				pConn->m_ConnInfo.OpenTimings.cAddressAttempts++;
+				
 				if( ERROR_SUCCESS == (dwRet = pTcpProv->SocketOpenSync(AIW, timeleft )))
 				{
 					// Adjust the timeout to take acccount the time spent thus far, including DNS and all SocketOpenSync calls so far.
@@ -4657,11 +5759,18 @@ DWORD Tcp::Open( 	SNI_Conn 		* pConn,
 		}
 	}
 	
-	FreeAddrInfoW( AddrInfoW );
+	FreeResolvedAddrInfo( AddrInfoW );
 	AddrInfoW = NULL;
 
+	pConn->m_ConnInfo.OpenTimings.dwTcpConnect += GetTickCount() - dwConnectStart;
+
 	if( pTcpProv->m_sock == INVALID_SOCKET )
 	{
+		// None of the addresses worked; don't hand them out again from 
+		// the cache, the name may have moved to a different address.  
+		//
+		AddrCacheRemove( pProtElem->m_wszServerName, pProtElem->Tcp.wszPort );
+
 		if( dwRet == ERROR_SUCCESS )
 		{
 			dwRet = ERROR_FAIL;
@@ -4713,6 +5822,9 @@ DWORD Tcp::Open( 	SNI_Conn 		* pConn,
 		goto ErrorExit;
 	}
 
+	// Have the next connection to this server try the address that worked first.
+	AddrCachePromote( pProtElem->m_wszServerName, pProtElem->Tcp.wszPort, (sockaddr *) &PeerAddr );
+
 	// Get Local address
 	SOCKADDR_STORAGE LocalAddr;
 	addrlen = sizeof(SOCKADDR_STORAGE);
@@ -4791,7 +5903,7 @@ ErrorExit:
 
 	if( NULL != AddrInfoW )
 	{
-		FreeAddrInfoW( AddrInfoW );
+		FreeResolvedAddrInfo( AddrInfoW );
 		AddrInfoW = NULL;
 	}
 
@@ -5145,7 +6257,7 @@ Exit:
 
 DWORD Tcp::ReadDone(__inout SNI_Packet ** ppPacket, __out SNI_Packet **ppLeftOver, DWORD dwBytes, DWORD dwError)
 {
-	BidxScopeAutoSNI5( SNIAPI_TAG _T("%u#, ")
+	BidxScopeAutoSNIHotPath5( SNIAPI_TAG _T("%u#, ")
 							  _T("ppPacket: %p{SNI_Packet**}, ")
 							  _T("ppLeftOver: %p{SNI_Packet**}, ")
 							  _T("dwBytes: %d, ")
@@ -5158,12 +6270,14 @@ DWORD Tcp::ReadDone(__inout SNI_Packet ** ppPacket, __out SNI_Packet **ppLeftOve
 	
 	// If its an error, return the error. Tcp does not treat any errors as "valid".
 	*ppLeftOver = 0;
+
+	RecordReadCompletion( dwBytes, dwError );
 	
 	if( dwError )
 	{
 		SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, dwError);
 
-		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwError);
+		BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwError);
 		return dwError;
 	}
 	// Check if we received a 0 byte packet - that means the connection was disconnected
@@ -5172,12 +6286,12 @@ DWORD Tcp::ReadDone(__inout SNI_Packet ** ppPacket, __out SNI_Packet **ppLeftOve
 		SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, WSAECONNRESET);
 	
 		BidTrace0( ERROR_TAG _T("Successful 0-byte TCP read: returning WSAECONNRESET\n") );
-		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), WSAECONNRESET);
+		BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), WSAECONNRESET);
 		return WSAECONNRESET;			
 	
 	}
 	
-	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
+	BidTraceU1( SNI_BID_HOTPATH_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), ERROR_SUCCESS);
 	return ERROR_SUCCESS;
 }
 
@@ -5428,6 +6542,8 @@ DWORD Tcp::ReadSync(__out SNI_Packet ** ppNewPacket, int timeout)
 	
 	SNIPacketSetBufferSize( pPacket, dwBytesRead );
 
+	RecordReadCompletion( dwBytesRead, ERROR_SUCCESS );
+
 	*ppNewPacket = pPacket;
 
 	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
@@ -5467,6 +6583,25 @@ DWORD Tcp::CheckConnection( )
 	
 	DWORD dwRet = ERROR_FAIL;
 
+	// A read already saw the connection reset or closed by the peer.
+	LONG lReadError = m_lReadError;
+	if( ERROR_SUCCESS != lReadError )
+	{
+		BidTrace1( ERROR_TAG _T("Connection is known to be bad from an earlier read: %d{WINERR}\n"), lReadError );
+		SNI_SET_LAST_ERROR( TCP_PROV, SNIE_SYSTEM, (DWORD) lReadError );
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%u{WINERR}\n"), ERROR_FAIL);
+		return ERROR_FAIL;
+	}
+
+	// Data arrived recently enough that the connection is taken to be alive.
+	DWORD dwIdle = g_dwTcpCheckConnectionIdle;
+	DWORD dwLastReadTick = m_dwLastReadTick;
+	if( 0 != dwIdle && 0 != dwLastReadTick && GetTickCount() - dwLastReadTick < dwIdle )
+	{
+		BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%u{WINERR}\n"), ERROR_SUCCESS);
+		return ERROR_SUCCESS;
+	}
+
 	// Setup polling object
 	WSAPOLLFD poll;
 	poll.fd = m_sock;
@@ -5504,6 +6639,25 @@ DWORD Tcp::CheckConnection( )
 	return dwRet;
 }
 
+// Aborted reads are not recorded: ReadSync reposts a read that was 
+// cancelled because the thread that posted it exited, and Close aborts 
+// reads on a connection that is going away anyway.  
+//
+void Tcp::RecordReadCompletion(DWORD dwBytes, DWORD dwError)
+{
+	if( ERROR_SUCCESS == dwError && 0 != dwBytes )
+	{
+		// Zero is the "never read" value.
+		DWORD dwTick = GetTickCount();
+		m_dwLastReadTick = dwTick ? dwTick : 1;
+	}
+	else if( ERROR_OPERATION_ABORTED != dwError )
+	{
+		// A successful 0-byte read is the peer's FIN.
+		InterlockedExchange( &m_lReadError, dwError ? (LONG) dwError : WSAECONNRESET );
+	}
+}
+
 void Tcp::Release()
 {
 	BidxScopeAutoSNI0( SNIAPI_TAG _T( "\n") );
@@ -5584,6 +6738,18 @@ DWORD Tcp::Terminate()
 		return ERROR_SUCCESS;
 	}
 
+	AddrCacheFlush();
+
+	if( NULL != g_csTcpAddrCache )
+	{
+		DeleteCriticalSection( &g_csTcpAddrCache );
+	}
+
+	g_pfnGetAddrInfoExW = NULL;
+	g_pfnGetAddrInfoExCancel = NULL;
+	g_pfnGetAddrInfoExOverlappedResult = NULL;
+	g_pfnFreeAddrInfoExW = NULL;
+
 	// Cleanup Winsock
 	WSACleanup();
 	
@@ -5629,6 +6795,10 @@ DWORD Tcp::ResumePendingAccepts(__in HANDLE hListener)
 	//
 	ListenObject *pListenObject = static_cast<ListenObject *>(hListener);
 
+	// Grow may be adding to the array from an accept completion.  
+	//
+	CAutoSNICritSec a_csAcceptObjects( pListenObject->m_csAcceptObjects, SNI_AUTOCS_ENTER );
+
 	for (UINT i = 0; i < pListenObject->m_nAcceptObjects; i++)
 	{
 		if (pListenObject->m_ppAcceptObjects[i]->m_fPendingAccept)
@@ -5654,6 +6824,8 @@ DWORD Tcp::ResumePendingAccepts(__in HANDLE hListener)
 		}
 	}
 
+	a_csAcceptObjects.Leave();
+
 	BidTraceU1( SNI_BID_TRACE_ON, RETURN_TAG _T("%d{WINERR}\n"), dwRet);
 
 	return dwRet;
@@ -23,9 +23,14 @@
 //-------------------------------------------------------------------------------------------------
 
 #include "StdAfx.h"
+#include "..\CommandLine\Timing.h"
 
 #define VBCodeGenTemporaryPrefix L"CG"
 
+#if DEBUG
+VSEXTERN_SWITCH(fDumpLocalSlotSharing);
+#endif
+
 //-------------------------------------------------------------------------------------------------
 //
 // Initialize the code generator
@@ -270,11 +275,43 @@ void CodeGenerator::AssignLocalSlots()
     VSASSERT(ptempmgr, "Where's the tempmgr?  Every proc should have one!");
     iterTemp.Init(ptempmgr);
 
+    SHARED_TEMPORARY_SLOT *SharedSlots = NULL;
+    bool fShareSlots = CanShareTemporarySlots();
+    unsigned long cSharedTemporaries = 0;
+
     while (Temporary *Current = iterTemp.GetNext())
     {
+        if (fShareSlots && IsShareableTemporary(Current))
+        {
+            if (ShareTemporarySlot(Current, &SharedSlots))
+            {
+                cSharedTemporaries++;
+            }
+            continue;
+        }
+
         AddVariableToMethod(m_MethodScope, Current->Symbol, VAR_IS_COMP_GEN);
     }
 
+    if (cSharedTemporaries > 0)
+    {
+        unsigned long cLocals = m_MethodSlots->LocalVariableList()->NumberOfEntries();
+
+#if DEBUG
+        if (VSFSWITCH(fDumpLocalSlotSharing))
+        {
+            DebPrintf("Local slots for method : %S : %lu before sharing, %lu after\n",
+                      m_pproc->GetEmittedName(),
+                      cLocals + cSharedTemporaries,
+                      cLocals);
+        }
+#endif
+
+#if !IDE
+        TimerRecordLocalSlots(cLocals + cSharedTemporaries, cLocals);
+#endif
+    }
+
     // As a shortcut, cache the On Error slot numbers.
     if (ActiveHandlerTemporary)
     {
@@ -295,6 +332,141 @@ void CodeGenerator::AssignLocalSlots()
 }
 
 
+/*****************************************************************************
+// Long lived temporaries are never reused by the TemporaryManager, so a
+// method with many For, For Each, With, Using, SyncLock or Select blocks ends
+// up with one local per temporary per block.  When optimizing, let
+// temporaries of the same type share a slot as long as none of their blocks
+// contain one another.
+//
+// A long lived temporary is assigned on entry to the construct that owns it
+// and is dead once the construct is left, and a construct that reads such a
+// temporary can only be entered at its start: branches into For, With,
+// Using, SyncLock and Try blocks are errors, and a branch into a Case body
+// skips the tests that read the selector.  On Error is the exception, since
+// Resume can return into a construct after the handler has run other code,
+// so methods with On Error are left alone.  EnC keeps its slots stable.
+*****************************************************************************/
+bool CodeGenerator::CanShareTemporarySlots()
+{
+    return m_Project->GenerateOptimalIL() &&
+           !m_Project->GenerateENCableCode() &&
+           !m_ptreeFunc->AsProcedureBlock().fSeenOnErr;
+}
+
+bool CodeGenerator::IsShareableTemporary
+(
+    Temporary *Current
+)
+{
+    if (Current->Lifetime != LifetimeLongLived ||
+        Current->Block == NULL ||
+        Current->Symbol->GetRewrittenName())
+    {
+        return false;
+    }
+
+    // The block must belong to the tree being generated.  Otherwise (e.g. a
+    // temporary left pointing at a block of a tree that was copied) we
+    // cannot tell what the temporary overlaps with.
+    for (ILTree::ExecutableBlock *Block = Current->Block; Block; Block = Block->Parent)
+    {
+        if (Block == &m_ptreeFunc->AsExecutableBlock())
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Does Outer contain Inner, or are they the same block?
+static bool
+BlockContainsBlock
+(
+    ILTree::ExecutableBlock *Outer,
+    ILTree::ExecutableBlock *Inner
+)
+{
+    for (ILTree::ExecutableBlock *Block = Inner; Block; Block = Block->Parent)
+    {
+        if (Block == Outer)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Give the temporary the slot of an earlier temporary of the same type when
+// their blocks are disjoint, or a slot of its own otherwise.  Returns true if
+// an existing slot was shared.
+bool CodeGenerator::ShareTemporarySlot
+(
+    Temporary *Current,
+    _Inout_ SHARED_TEMPORARY_SLOT **ppSharedSlots
+)
+{
+    BCSYM_Variable *Variable = Current->Symbol;
+    Signature signature;
+
+    m_pmdemit->StartNewSignature(&signature);
+    m_pmdemit->EncodeType(Variable->GetCompilerType(), Variable->GetRawType()->GetLocation());
+
+    unsigned long cbSignature = m_pmdemit->GetSigSize();
+    BYTE *pbSignature = (BYTE *)m_pnra->Alloc(cbSignature);
+    memcpy(pbSignature, m_pmdemit->GetSignature(), cbSignature);
+
+    m_pmdemit->ReleaseSignature(&signature);
+
+    TEMPORARY_SLOT_BLOCK *NewBlock = (TEMPORARY_SLOT_BLOCK *)m_pnra->Alloc(sizeof(TEMPORARY_SLOT_BLOCK));
+    NewBlock->Block = Current->Block;
+
+    for (SHARED_TEMPORARY_SLOT *Slot = *ppSharedSlots; Slot; Slot = Slot->Next)
+    {
+        if (Slot->SignatureSize != cbSignature ||
+            memcmp(Slot->Signature, pbSignature, cbSignature) != 0)
+        {
+            continue;
+        }
+
+        bool fOverlaps = false;
+
+        for (TEMPORARY_SLOT_BLOCK *SlotBlock = Slot->Blocks; SlotBlock; SlotBlock = SlotBlock->Next)
+        {
+            if (BlockContainsBlock(SlotBlock->Block, Current->Block) ||
+                BlockContainsBlock(Current->Block, SlotBlock->Block))
+            {
+                fOverlaps = true;
+                break;
+            }
+        }
+
+        if (!fOverlaps)
+        {
+            Variable->SetLocalSlot(Slot->SlotNumber);
+
+            NewBlock->Next = Slot->Blocks;
+            Slot->Blocks = NewBlock;
+            return true;
+        }
+    }
+
+    AddVariableToMethod(m_MethodScope, Variable, VAR_IS_COMP_GEN);
+
+    SHARED_TEMPORARY_SLOT *NewSlot = (SHARED_TEMPORARY_SLOT *)m_pnra->Alloc(sizeof(SHARED_TEMPORARY_SLOT));
+    NewSlot->Signature = pbSignature;
+    NewSlot->SignatureSize = cbSignature;
+    NewSlot->SlotNumber = Variable->GetLocalSlot();
+    NewBlock->Next = NULL;
+    NewSlot->Blocks = NewBlock;
+    NewSlot->Next = *ppSharedSlots;
+    *ppSharedSlots = NewSlot;
+
+    return false;
+}
+
 /*****************************************************************************
 // Create the signature for the locals
 *****************************************************************************/
@@ -138,6 +138,36 @@ struct SWITCH_TABLE
     CODE_ADDRESS      pcodeaddrs[1];      // the table
 };
 
+//-------------------------------------------------------------------------------------------------
+//
+// Represents one "selector = constant" test of a String Select dispatched by length
+//
+struct STRING_CASE_LEAF
+{
+    ILTree::PILNode   Condition;          // the SX_EQ test
+    CODE_BLOCK      * pcblkBody;          // body of the Case owning the test
+    size_t            Length;             // length of the constant
+};
+
+//-------------------------------------------------------------------------------------------------
+//
+// A local slot shared by long lived temporaries of the same type whose blocks do not nest
+//
+struct TEMPORARY_SLOT_BLOCK
+{
+    ILTree::ExecutableBlock * Block;      // block owning one of the temporaries in the slot
+    TEMPORARY_SLOT_BLOCK    * Next;
+};
+
+struct SHARED_TEMPORARY_SLOT
+{
+    BYTE                    * Signature;  // local signature of the slot's type
+    unsigned long             SignatureSize;
+    unsigned long             SlotNumber;
+    TEMPORARY_SLOT_BLOCK    * Blocks;
+    SHARED_TEMPORARY_SLOT   * Next;
+};
+
 //-------------------------------------------------------------------------------------------------
 //
 // Represents a catch clause
@@ -383,6 +413,24 @@ private:
     unsigned long                 m_cTotalBytes;        // size of the code block, only valid after
                                                         // a call to CalculateBlockAddresses
 
+    // The branch rewrites OptimizeGeneratedIL can apply. Only debug builds
+    // count them, see DumpBranchOptimizations.
+    enum BranchOptimization
+    {
+        BranchOpt_BranchToNext,             // br x / x:                  -> x:
+        BranchOpt_CondBranchToNext,         // brtrue x / x:              -> pop / x:
+        BranchOpt_CondBranchOverBranch,     // brtrue x / br y / x:       -> brfalse y / x:
+        BranchOpt_BranchToBranch,           // br x ... x: br y           -> br y
+        BranchOpt_BranchToLeave,            // br x ... x: leave y        -> leave y
+        BranchOpt_BranchToRet,              // br x ... x: ret            -> ret
+        BranchOpt_SwitchToBranch,           // switch (.., x, ..) x: br y -> switch (.., y, ..)
+        BranchOpt_Count
+    };
+
+#if DEBUG
+    unsigned long                 m_rgcBranchOptimizations[BranchOpt_Count];
+#endif
+
     BCSYM_Proc                 ** m_RuntimeCallRemapTable;
 
     //
@@ -476,6 +524,9 @@ private:
 
     void AssignBlockLocalSlots(ILTree::ExecutableBlock &exblock, BlockScope *CurrentScope);
     void AssignLocalSlots();
+    bool CanShareTemporarySlots();
+    bool IsShareableTemporary(Temporary *Current);
+    bool ShareTemporarySlot(Temporary *Current, _Inout_ SHARED_TEMPORARY_SLOT **ppSharedSlots);
     void AssignParameterSlots();
     void CreateLocalsSignature();
 
@@ -525,6 +576,7 @@ private:
     void OptimizeGeneratedIL();
     void OptimizeBranches();
     void MarkLiveBlocks(CODE_BLOCK *pcblk);
+    unsigned long CBytesCodeBlock(CODE_BLOCK *pcblk);
     unsigned long CalculateBlockAddresses();
     void EmitEHClauses();
     bool ShouldEmitDebugInfoForProc();
@@ -628,6 +680,13 @@ private:
     void GenerateCatch(ILTree::CatchBlock *ptreeCatch);
     void GenerateFinally(ILTree::PILNode ptree);
     void GenerateSelect(ILTree::PILNode ptree);
+    void GenerateClusteredSelect(ILTree::SelectBlock *Select);
+    void GenerateClusterSearch(ILTree::SelectBlock *Select, CODE_BLOCK **CaseBodies, CODE_BLOCK *pcblkDefault,
+                               unsigned First, unsigned Last, bool LowKnown, bool HighKnown);
+    bool GenerateStringSelectDispatch(ILTree::SelectBlock *Select);
+    bool GatherStringCaseLeaves(ILTree::PILNode ptreeCond, BCSYM_Variable *SelectorTemporary, CODE_BLOCK *pcblkBody,
+                                _Out_opt_ STRING_CASE_LEAF *Leaves, _Inout_ unsigned *pcLeaves,
+                                _Inout_ size_t *pMinLength, _Inout_ size_t *pMaxLength);
     void GenerateEndSelect(ILTree::PILNode ptree);
     void GenerateCase(ILTree::PILNode ptree);
     void GenerateResume(ILTree::PILNode ptree);
@@ -723,6 +782,7 @@ private:
     void DumpCall(BCSYM_Proc *pproc);
     void DumpBeginMethod();
     void DumpEndMethod();
+    void DumpBranchOptimizations();
 #endif
 };
 
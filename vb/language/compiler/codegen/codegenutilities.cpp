@@ -9,6 +9,14 @@
 
 #include "StdAfx.h"
 
+#if DEBUG
+VSEXTERN_SWITCH(fDumpBranchOptimizations);
+
+#define COUNT_BRANCH_OPTIMIZATION(kind) (m_rgcBranchOptimizations[kind]++)
+#else
+#define COUNT_BRANCH_OPTIMIZATION(kind)
+#endif
+
 //-------------------------------------------------------------------------------------------------
 //
 // Opcode tables
@@ -1113,6 +1121,10 @@ void CodeGenerator::OptimizeGeneratedIL
     CSingleListIter<CODE_BLOCK> Iter(&m_cblkCodeList);
     CODE_BLOCK * pcblk;
 
+#if DEBUG
+    memset(m_rgcBranchOptimizations, 0, sizeof(m_rgcBranchOptimizations));
+#endif
+
     MarkLiveBlocks(m_cblkCodeList.GetFirst());
 
     VSASSERT(m_tryList.NumberOfEntries() == m_tryholderEncounteredList.NumberOfEntries(),
@@ -1273,8 +1285,47 @@ void CodeGenerator::OptimizeGeneratedIL
     }
 
     OptimizeBranches();
+
+#if DEBUG
+    if (VSFSWITCH(fDumpBranchOptimizations))
+    {
+        DumpBranchOptimizations();
+    }
+#endif
 }
 
+#if DEBUG
+//========================================================================
+// Dump how many of each branch optimization were applied to the method
+//========================================================================
+
+void CodeGenerator::DumpBranchOptimizations
+(
+)
+{
+    static const char * const s_rgszBranchOptimizations[BranchOpt_Count] =
+    {
+        "br to next block removed",
+        "conditional br to next block popped",
+        "conditional br over br inverted",
+        "br to br threaded",
+        "br to leave threaded",
+        "br to ret replaced",
+        "switch entry to br threaded",
+    };
+
+    DebPrintf("Branch optimizations for method : %S\n", m_pproc->GetEmittedName());
+
+    for (unsigned i = 0; i < BranchOpt_Count; i++)
+    {
+        if (m_rgcBranchOptimizations[i])
+        {
+            DebPrintf("    %-40s %lu\n", s_rgszBranchOptimizations[i], m_rgcBranchOptimizations[i]);
+        }
+    }
+}
+#endif
+
 bool
 SameDestination
 (
@@ -1320,6 +1371,7 @@ void CodeGenerator::OptimizeBranches
         if (pcblk->opcodeJump == CEE_BR_S && SameDestination(pcblk, pcblk->pcblkJumpDest))
         {
             pcblk->opcodeJump = CEE_NOP;
+            COUNT_BRANCH_OPTIMIZATION(BranchOpt_BranchToNext);
             continue;
         }
 
@@ -1332,6 +1384,7 @@ void CodeGenerator::OptimizeBranches
         {
             pcblk->opcodeJump = CEE_POP;
             pcblk->pcblkJumpDest = NULL;
+            COUNT_BRANCH_OPTIMIZATION(BranchOpt_CondBranchToNext);
             continue;
         }
 
@@ -1376,6 +1429,7 @@ void CodeGenerator::OptimizeBranches
 
             pcblk->opcodeJump = NewBranchOpcode;
             pcblk->pcblkJumpDest = pcblk->Next()->pcblkJumpDest;
+            COUNT_BRANCH_OPTIMIZATION(BranchOpt_CondBranchOverBranch);
             // advance the iterator because it's already sitting on the block
             // we want to delete.
             Iter.Next();
@@ -1429,12 +1483,14 @@ checkbranch:
                 // Unconditional branch to leave
                 pcblk->opcodeJump = CEE_LEAVE_S;
                 pcblk->pcblkJumpDest = pcblk->pcblkJumpDest->pcblkJumpDest;
+                COUNT_BRANCH_OPTIMIZATION(BranchOpt_BranchToLeave);
             }
             else if (pcblk->opcodeJump == CEE_BR_S && pcblk->pcblkJumpDest->opcodeJump == CEE_RET)
             {
                 // Unconditional branch to Return
                 pcblk->opcodeJump = CEE_RET;
                 pcblk->pcblkJumpDest = NULL;
+                COUNT_BRANCH_OPTIMIZATION(BranchOpt_BranchToRet);
                 // This is now a dead-end, so we're finished here.
                 return;
             }
@@ -1444,6 +1500,7 @@ checkbranch:
                 // (Un)conditional branch to branch
                 // leave to leave
                 pcblk->pcblkJumpDest = pcblk->pcblkJumpDest->pcblkJumpDest;
+                COUNT_BRANCH_OPTIMIZATION(BranchOpt_BranchToBranch);
                 goto checkbranch;
             }
         }
@@ -1467,7 +1524,24 @@ checkbranch:
 
         for (iBlk = 0; iBlk < pswtbl->cEntries; iBlk++)
         {
-            MarkLiveBlocks(pswtbl->pcodeaddrs[iBlk].pcblk);
+            CODE_ADDRESS * pcodeaddr = &pswtbl->pcodeaddrs[iBlk];
+
+            // An entry that lands on an empty block which just branches
+            // elsewhere can jump straight to the final destination, the same
+            // as a branch to a branch above. Large Select Case tables often
+            // have most of their entries pointing at such blocks.
+            if (pcodeaddr->uOffset == 0)
+            {
+                while (pcodeaddr->pcblk->usCodeSize == 0 &&
+                       pcodeaddr->pcblk->opcodeJump == CEE_BR_S &&
+                       pcodeaddr->pcblk->pcblkJumpDest != pcodeaddr->pcblk)
+                {
+                    pcodeaddr->pcblk = pcodeaddr->pcblk->pcblkJumpDest;
+                    COUNT_BRANCH_OPTIMIZATION(BranchOpt_SwitchToBranch);
+                }
+            }
+
+            MarkLiveBlocks(pcodeaddr->pcblk);
         }
 
         if (pswtbl->pcblkCaseElse)
@@ -1637,13 +1711,96 @@ CODE_BLOCK * pcblkSwitch
     return;
 }
 
+//========================================================================
+// Size in bytes of a code block, including the jump (or switch table)
+// that terminates it.
+//========================================================================
+
+unsigned long CodeGenerator::CBytesCodeBlock
+(
+    CODE_BLOCK *pcblk
+)
+{
+    unsigned long cBytes = pcblk->usCodeSize;
+
+    // Add the size of the jump byte code
+    // SWITCH table is a special case
+    if (pcblk->opcodeJump == CEE_SWITCH)
+    {
+        // Add size of SWITCH opcode + 4 byte unsigned "size of table" field
+        cBytes += CBytesOpcode(CEE_SWITCH) + sizeof(unsigned long);
+        cBytes += pcblk->pswTable->cEntries * sizeof(long);
+    }
+    else if (pcblk->opcodeJump == CEE_THROW ||
+             pcblk->opcodeJump == CEE_RETHROW ||
+             pcblk->opcodeJump == CEE_RET  ||
+             pcblk->opcodeJump == CEE_ENDFILTER ||
+             pcblk->opcodeJump == CEE_ENDFINALLY ||
+             pcblk->opcodeJump == CEE_POP)
+    {
+        cBytes += CBytesOpcode(pcblk->opcodeJump);
+    }
+    else if (pcblk->opcodeJump != CEE_NOP)
+    {
+        cBytes += CBytesBranchOpcodeOperand(pcblk->opcodeJump);
+    }
+
+    return cBytes;
+}
+
+//========================================================================
+// Binary indexed tree over the block sizes, used by
+// CalculateBlockAddresses to compute the offset of any block in
+// O(log n) while block sizes change. rgcbTree is 1-based and holds
+// cBlocks + 1 entries.
+//========================================================================
+
+static
+unsigned long BlockOffsetFromSizeTree
+(
+    _In_count_(iBlock + 1) const unsigned long *rgcbTree,
+    unsigned long iBlock      // offset of this block == size of all blocks before it
+)
+{
+    unsigned long cBytes = 0;
+
+    for (unsigned long i = iBlock; i > 0; i &= i - 1)
+    {
+        cBytes += rgcbTree[i];
+    }
+
+    return cBytes;
+}
+
+static
+void GrowBlockInSizeTree
+(
+    _Inout_count_(cBlocks + 1) unsigned long *rgcbTree,
+    unsigned long cBlocks,
+    unsigned long iBlock,
+    unsigned long cBytesGrowth
+)
+{
+    for (unsigned long i = iBlock + 1; i <= cBlocks; i += i & (0 - i))
+    {
+        rgcbTree[i] += cBytesGrowth;
+    }
+}
+
 //========================================================================
 // Iterate through all the code blocks and determine their offset
-// addresses. This is a multi-pass job. First, we go through and assume
-// all jumps are going to be short jumps and lay out the blocks. Then we
-// go back through and make any jumps to long that have to be. This may
-// cause other jumps to become long. We keep iterating until there are no
-// changes
+// addresses. All jumps start out as short jumps. Any short jump whose
+// displacement does not fit in a signed byte is made long, which grows
+// its block and may push other short jumps spanning that block out of
+// range. Rather than re-laying out the whole method until nothing
+// changes, keep a worklist of short jumps that still need checking and,
+// when a block grows, requeue only the short jumps near enough to it to
+// have been affected (a short jump spans at most 128 bytes).
+//
+// Jumps only ever go from short to long, and growing a block can only
+// lengthen the jumps that span it, so this reaches the same (smallest)
+// set of long jumps as repeated full passes would, and therefore the
+// same IL.
 //========================================================================
 
 unsigned long CodeGenerator::CalculateBlockAddresses
@@ -1651,69 +1808,141 @@ unsigned long CodeGenerator::CalculateBlockAddresses
 )
 {
     CODE_BLOCK *pcblk;
-    unsigned long cTotalBytes;
-    bool fModified = true;
+    unsigned long cBlocks = 0;
+    unsigned long iBlock;
+    unsigned long cTotalBytes = 0;
 
     CSingleListIter<CODE_BLOCK>  Iter(&m_cblkCodeList);
 
-    while (fModified)
+    // Until the final layout below, ulBlockOffset holds the ordinal of
+    // the block so jump destinations can be found in the arrays.
+    Iter.Reset();
+    while (pcblk = Iter.Next())
+    {
+        pcblk->ulBlockOffset = cBlocks++;
+    }
+
+    if (cBlocks == 0)
     {
-        fModified = false;
-        cTotalBytes = 0;
+        m_cTotalBytes = 0;
+        return 0;
+    }
+
+    NorlsAllocator nraLayout(NORLSLOC);
 
-        // Iterate through code blocks and set the block offsets
-        Iter.Reset();
-        while (pcblk = Iter.Next())
+    CODE_BLOCK **rgpcblk = (CODE_BLOCK **)nraLayout.Alloc(VBMath::Multiply(cBlocks, sizeof(CODE_BLOCK *)));
+    unsigned long *rgcbBlock = (unsigned long *)nraLayout.Alloc(VBMath::Multiply(cBlocks, sizeof(unsigned long)));
+    unsigned long *rgcbTree = (unsigned long *)nraLayout.Alloc(VBMath::Multiply(VBMath::Add(cBlocks, 1), sizeof(unsigned long)));
+    unsigned long *rgiWorklist = (unsigned long *)nraLayout.Alloc(VBMath::Multiply(cBlocks, sizeof(unsigned long)));
+    bool *rgfQueued = (bool *)nraLayout.Alloc(VBMath::Multiply(cBlocks, sizeof(bool)));
+    unsigned long cWorklist = 0;
+
+    // Lay out the blocks once with every jump short.
+    iBlock = 0;
+    Iter.Reset();
+    while (pcblk = Iter.Next())
+    {
+        rgpcblk[iBlock] = pcblk;
+        rgcbBlock[iBlock] = CBytesCodeBlock(pcblk);
+        rgcbTree[iBlock + 1] = rgcbBlock[iBlock];
+        iBlock++;
+    }
+
+    for (unsigned long i = 1; i <= cBlocks; i++)
+    {
+        unsigned long iParent = i + (i & (0 - i));
+
+        if (iParent <= cBlocks)
         {
-            pcblk->ulBlockOffset = cTotalBytes;
+            rgcbTree[iParent] += rgcbTree[i];
+        }
+    }
 
-            cTotalBytes += pcblk->usCodeSize;
+    // Queue the short jumps in reverse so they are checked in block order.
+    for (iBlock = cBlocks; iBlock-- > 0; )
+    {
+        if (IsShortBranch(rgpcblk[iBlock]->opcodeJump))
+        {
+            rgiWorklist[cWorklist++] = iBlock;
+            rgfQueued[iBlock] = true;
+        }
+    }
 
-            // Add the size of the jump byte code
-            // SWITCH table is a special case
-            if (pcblk->opcodeJump == CEE_SWITCH)
-            {
-                // Add size of SWITCH opcode + 4 byte unsigned "size of table" field
-                cTotalBytes += CBytesOpcode(CEE_SWITCH) + sizeof(unsigned long);
-                cTotalBytes += pcblk->pswTable->cEntries * sizeof(long);
-            }
-            else if (pcblk->opcodeJump == CEE_THROW ||
-                     pcblk->opcodeJump == CEE_RETHROW ||
-                     pcblk->opcodeJump == CEE_RET  ||
-                     pcblk->opcodeJump == CEE_ENDFILTER ||
-                     pcblk->opcodeJump == CEE_ENDFINALLY ||
-                     pcblk->opcodeJump == CEE_POP)
-            {
-                cTotalBytes += CBytesOpcode(pcblk->opcodeJump);
-            }
-            else if (pcblk->opcodeJump != CEE_NOP)
+    while (cWorklist > 0)
+    {
+        iBlock = rgiWorklist[--cWorklist];
+        rgfQueued[iBlock] = false;
+        pcblk = rgpcblk[iBlock];
+
+        VSASSERT(IsShortBranch(pcblk->opcodeJump), "CalculateBlockAddresses: only short jumps are queued");
+
+        unsigned long iDest = pcblk->pcblkJumpDest->ulBlockOffset;
+
+        VSASSERT(iDest < cBlocks && rgpcblk[iDest] == pcblk->pcblkJumpDest,
+                 "CalculateBlockAddresses: jump destination is not in the code block list");
+
+        // The displacement is measured from the end of the jump, which
+        // is the start of the next block.
+        signed long lJumpOffset =
+            (signed long)(BlockOffsetFromSizeTree(rgcbTree, iDest) -
+                          BlockOffsetFromSizeTree(rgcbTree, iBlock + 1));
+
+        if (lJumpOffset >= SCHAR_MIN && lJumpOffset <= SCHAR_MAX)
+        {
+            continue;
+        }
+
+        // Every short jump not on the worklist is currently in range, so
+        // the only ones this block's growth can push out of range are
+        // forward jumps ending within SCHAR_MAX bytes before it and
+        // backward jumps ending within -SCHAR_MIN bytes after its start.
+        unsigned long cbSpan = 0;
+
+        for (unsigned long i = iBlock; i-- > 0 && cbSpan <= (unsigned long)SCHAR_MAX; )
+        {
+            if (!rgfQueued[i] && IsShortBranch(rgpcblk[i]->opcodeJump))
             {
-                cTotalBytes += CBytesBranchOpcodeOperand(pcblk->opcodeJump);
+                rgiWorklist[cWorklist++] = i;
+                rgfQueued[i] = true;
             }
 
-        } // while
+            cbSpan += rgcbBlock[i];
+        }
+
+        cbSpan = rgcbBlock[iBlock];
 
-        // Now, check to make sure opcodes are OK
-        Iter.Reset();
-        while (pcblk = Iter.Next())
+        for (unsigned long i = iBlock + 1; i < cBlocks; i++)
         {
-            signed long lJumpOffset;
+            cbSpan += rgcbBlock[i];
 
-            if (IsShortBranch(pcblk->opcodeJump))
+            if (cbSpan > (unsigned long)-SCHAR_MIN)
             {
-                lJumpOffset = pcblk->pcblkJumpDest->ulBlockOffset -
-                                (pcblk->ulBlockOffset +
-                                 pcblk->usCodeSize +
-                                 CBytesBranchOpcodeOperand(pcblk->opcodeJump));
+                break;
+            }
 
-                if (lJumpOffset < SCHAR_MIN || lJumpOffset > SCHAR_MAX)
-                {
-                    // Gotta make it a long jump
-                    pcblk->opcodeJump = MapShort2LongJumpOpcode(pcblk->opcodeJump);
-                    fModified = true;
-                }
+            if (!rgfQueued[i] && IsShortBranch(rgpcblk[i]->opcodeJump))
+            {
+                rgiWorklist[cWorklist++] = i;
+                rgfQueued[i] = true;
             }
         }
+
+        // Gotta make it a long jump
+        unsigned long cbShort = CBytesBranchOpcodeOperand(pcblk->opcodeJump);
+
+        pcblk->opcodeJump = MapShort2LongJumpOpcode(pcblk->opcodeJump);
+
+        unsigned long cbGrowth = CBytesBranchOpcodeOperand(pcblk->opcodeJump) - cbShort;
+
+        rgcbBlock[iBlock] += cbGrowth;
+        GrowBlockInSizeTree(rgcbTree, cBlocks, iBlock, cbGrowth);
+    }
+
+    // Final layout
+    for (iBlock = 0; iBlock < cBlocks; iBlock++)
+    {
+        rgpcblk[iBlock]->ulBlockOffset = cTotalBytes;
+        cTotalBytes += rgcbBlock[iBlock];
     }
 
     m_cTotalBytes = cTotalBytes;
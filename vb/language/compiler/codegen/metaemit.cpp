@@ -16,6 +16,37 @@
 #undef IfFailGo
 #define IfFailGo(EXPR) IfFailGoto(EXPR, Error)
 
+#if DEBUG
+#define COUNT_TOKEN_CACHE_LOOKUP(kind, hit) (m_pBuilder->CountTokenCacheLookup(kind, hit))
+#else
+#define COUNT_TOKEN_CACHE_LOOKUP(kind, hit)
+#endif
+
+#if !IDE
+// Key for Builder::m_BindingTokenHashTable.  Zeroed first so padding
+// doesn't take part in the hash.
+struct BindingTokenKey
+{
+    unsigned Kind;
+    BCSYM_NamedRoot *pMember;
+    BCSYM_GenericBinding *pBinding;
+};
+
+static void InitBindingTokenKey
+(
+    _Out_ BindingTokenKey *pKey,
+    Builder::TokenCacheKind Kind,
+    BCSYM_NamedRoot *pMember,
+    BCSYM_GenericBinding *pBinding
+)
+{
+    memset(pKey, 0, sizeof(*pKey));
+    pKey->Kind = Kind;
+    pKey->pMember = pMember;
+    pKey->pBinding = pBinding;
+}
+#endif
+
 static const DWORD rgPEKind[] =
 {
     peILonly,                   // platformAgnostic
@@ -2379,66 +2410,94 @@ mdMemberRef MetaEmit::DefineMemberRefBySymbol
         {
             // This is a member of an instantation of a generic type.
 
-            Signature signature;
-            StartNewSignature(&signature);
+            mdMemberRef *CachedMemberRef = NULL;
 
-            mdTypeRef mdTypeRefParent = DefineTypeRefBySymbol(TypeBinding, pReferencingLocation);
+#if !IDE
+            BindingTokenKey MemberRefKey;
+            InitBindingTokenKey(&MemberRefKey, Builder::TokenCache_BoundMemberRef, pnamed, TypeBinding);
 
-            bool old_m_TrackReferrencesToEmbeddableInteropTypes = m_TrackReferrencesToEmbeddableInteropTypes;
-            bool old_m_ReferredToEmbeddableInteropType = m_ReferredToEmbeddableInteropType;
+            CachedMemberRef = (mdMemberRef *)m_pBuilder->m_BindingTokenHashTable.FindWithSize(&MemberRefKey, sizeof(MemberRefKey));
+            COUNT_TOKEN_CACHE_LOOKUP(Builder::TokenCache_BoundMemberRef, CachedMemberRef != NULL);
+#endif
+
+            if (CachedMemberRef)
+            {
+                tkMemberRef = *CachedMemberRef;
+            }
+            else
+            {
+                Signature signature;
+                StartNewSignature(&signature);
+
+                mdTypeRef mdTypeRefParent = DefineTypeRefBySymbol(TypeBinding, pReferencingLocation);
+
+                bool old_m_TrackReferrencesToEmbeddableInteropTypes = m_TrackReferrencesToEmbeddableInteropTypes;
+                bool old_m_ReferredToEmbeddableInteropType = m_ReferredToEmbeddableInteropType;
 
 #if IDE 
-            bool save_m_TrackUnsubstitutedLocalTypes = m_pCompilerProject->GetTrackUnsubstitutedLocalTypes();
-            ThrowIfTrue(save_m_TrackUnsubstitutedLocalTypes);
-            ThrowIfFalse(m_pCompilerProject->m_UnsubstitutedLocalTypes.Count() == 0);
+                bool save_m_TrackUnsubstitutedLocalTypes = m_pCompilerProject->GetTrackUnsubstitutedLocalTypes();
+                ThrowIfTrue(save_m_TrackUnsubstitutedLocalTypes);
+                ThrowIfFalse(m_pCompilerProject->m_UnsubstitutedLocalTypes.Count() == 0);
 
-            m_pCompilerProject->SetTrackUnsubstitutedLocalTypes(true);
+                m_pCompilerProject->SetTrackUnsubstitutedLocalTypes(true);
 #endif
 
-            ThrowIfTrue(m_TrackReferrencesToEmbeddableInteropTypes); // Shouldn't be getting into a nested case.
+                ThrowIfTrue(m_TrackReferrencesToEmbeddableInteropTypes); // Shouldn't be getting into a nested case.
 
-            m_TrackReferrencesToEmbeddableInteropTypes = true;
-            m_ReferredToEmbeddableInteropType = false;
+                m_TrackReferrencesToEmbeddableInteropTypes = true;
+                m_ReferredToEmbeddableInteropType = false;
 
-            // Dev10 #751770
-            bool* save_m_pReferredToEmbeddableInteropType = m_pCompilerProject->Get_pReferredToEmbeddableInteropType();
-            ThrowIfTrue(save_m_pReferredToEmbeddableInteropType); // Shouldn't be getting into a nested case.
-            m_pCompilerProject->Set_pReferredToEmbeddableInteropType(&m_ReferredToEmbeddableInteropType);
+                // Dev10 #751770
+                bool* save_m_pReferredToEmbeddableInteropType = m_pCompilerProject->Get_pReferredToEmbeddableInteropType();
+                ThrowIfTrue(save_m_pReferredToEmbeddableInteropType); // Shouldn't be getting into a nested case.
+                m_pCompilerProject->Set_pReferredToEmbeddableInteropType(&m_ReferredToEmbeddableInteropType);
 
-            if (TypeHelpers::IsEmbeddableInteropType(pnamed->GetParent()))
-            {
-                m_pCompilerProject->CachePiaTypeMemberRef(pnamed, pReferencingLocation, m_pBuilder->m_pErrorTable);
-                m_ReferredToEmbeddableInteropType = true;
-            }
+                if (TypeHelpers::IsEmbeddableInteropType(pnamed->GetParent()))
+                {
+                    m_pCompilerProject->CachePiaTypeMemberRef(pnamed, pReferencingLocation, m_pBuilder->m_pErrorTable);
+                    m_ReferredToEmbeddableInteropType = true;
+                }
 
-            EncodeMetaMemberRef(pnamed, mdTypeRefParent);
+                EncodeMetaMemberRef(pnamed, mdTypeRefParent);
 
-            if (pnamed->IsProc())
-            {
-                EncodeMethodSignature(pnamed->PProc(), pReferencingLocation);
-            }
-            else if (pnamed->IsMember())
-            {
-                EncodeFieldSignature(pnamed->PMember(), pReferencingLocation);
-            }
+                if (pnamed->IsProc())
+                {
+                    EncodeMethodSignature(pnamed->PProc(), pReferencingLocation);
+                }
+                else if (pnamed->IsMember())
+                {
+                    EncodeFieldSignature(pnamed->PMember(), pReferencingLocation);
+                }
 
-            EncodeFinishMetaMemberRef();
+                EncodeFinishMetaMemberRef();
 
-            // Get the reference.
-            tkMemberRef = DefineMemberRefByName(GetMetaMemberRef(), GetSigSize(), pnamed, mdTypeRefParent,
-                                            !m_ReferredToEmbeddableInteropType); // Dev10 #676210: Can't use DefineImportMember when embeddable type is in the picture
+                // Get the reference.
+                tkMemberRef = DefineMemberRefByName(GetMetaMemberRef(), GetSigSize(), pnamed, mdTypeRefParent,
+                                                !m_ReferredToEmbeddableInteropType); // Dev10 #676210: Can't use DefineImportMember when embeddable type is in the picture
+
+                bool ReferredToEmbeddableInteropType = m_ReferredToEmbeddableInteropType;
 
-            m_TrackReferrencesToEmbeddableInteropTypes = old_m_TrackReferrencesToEmbeddableInteropTypes;
-            m_ReferredToEmbeddableInteropType = old_m_ReferredToEmbeddableInteropType;
+                m_TrackReferrencesToEmbeddableInteropTypes = old_m_TrackReferrencesToEmbeddableInteropTypes;
+                m_ReferredToEmbeddableInteropType = old_m_ReferredToEmbeddableInteropType;
 
 #if IDE 
-            m_pCompilerProject->m_UnsubstitutedLocalTypes.Clear();
-            m_pCompilerProject->SetTrackUnsubstitutedLocalTypes(save_m_TrackUnsubstitutedLocalTypes);
+                m_pCompilerProject->m_UnsubstitutedLocalTypes.Clear();
+                m_pCompilerProject->SetTrackUnsubstitutedLocalTypes(save_m_TrackUnsubstitutedLocalTypes);
 #endif
 
-            m_pCompilerProject->Set_pReferredToEmbeddableInteropType(save_m_pReferredToEmbeddableInteropType);
+                m_pCompilerProject->Set_pReferredToEmbeddableInteropType(save_m_pReferredToEmbeddableInteropType);
+
+                ReleaseSignature(&signature);
 
-            ReleaseSignature(&signature);
+#if !IDE
+                // Only cache references that didn't involve embeddable interop types, so
+                // skipping the encoding on a hit can't skip recording a NoPia reference.
+                if (!ReferredToEmbeddableInteropType && !pnamed->IsStaticLocalBackingField())
+                {
+                    m_pBuilder->m_BindingTokenHashTable.AddWithSize(&MemberRefKey, sizeof(MemberRefKey), tkMemberRef);
+                }
+#endif
+            }
 
             // Remember this token so we can delete it on next decompile
             // 
@@ -2690,6 +2749,7 @@ mdMemberRef MetaEmit::DefineMemberRefByName
     if(psymNamed && !(psymNamed->IsStaticLocalBackingField()))
     {
         pmrFound = (mdMemberRef *)m_pBuilder->m_ProjectHashTable.FindWithSize(pmmr, cbSizeRef);
+        COUNT_TOKEN_CACHE_LOOKUP(Builder::TokenCache_MemberRef, pmrFound != NULL);
     }
     mdMemberRef mr;
 
@@ -2819,6 +2879,67 @@ MetaEmit::DefineGenericTypeInstantiation
     BCSYM_GenericTypeBinding *pBinding,
     Location *pReferencingLocation
 )
+{
+#if IDE
+    return DefineGenericTypeInstantiationBySignature(pBinding, pReferencingLocation);
+#else
+    BindingTokenKey TypeSpecKey;
+    InitBindingTokenKey(&TypeSpecKey, Builder::TokenCache_BoundTypeSpec, NULL, pBinding);
+
+    mdTypeSpec *CachedTypeSpec = (mdTypeSpec *)m_pBuilder->m_BindingTokenHashTable.FindWithSize(&TypeSpecKey, sizeof(TypeSpecKey));
+    COUNT_TOKEN_CACHE_LOOKUP(Builder::TokenCache_BoundTypeSpec, CachedTypeSpec != NULL);
+
+    if (CachedTypeSpec)
+    {
+        return *CachedTypeSpec;
+    }
+
+    // Track embeddable interop types in the encoding on our own, so only the
+    // instantiations without any get cached.  Whoever was tracking before
+    // still hears about them.
+    bool old_m_TrackReferrencesToEmbeddableInteropTypes = m_TrackReferrencesToEmbeddableInteropTypes;
+    bool old_m_ReferredToEmbeddableInteropType = m_ReferredToEmbeddableInteropType;
+    bool* save_m_pReferredToEmbeddableInteropType = m_pCompilerProject->Get_pReferredToEmbeddableInteropType();
+
+    m_TrackReferrencesToEmbeddableInteropTypes = true;
+    m_ReferredToEmbeddableInteropType = false;
+    m_pCompilerProject->Set_pReferredToEmbeddableInteropType(&m_ReferredToEmbeddableInteropType);
+
+    mdTypeSpec TypeSpec = DefineGenericTypeInstantiationBySignature(pBinding, pReferencingLocation);
+
+    bool ReferredToEmbeddableInteropType = m_ReferredToEmbeddableInteropType;
+
+    m_TrackReferrencesToEmbeddableInteropTypes = old_m_TrackReferrencesToEmbeddableInteropTypes;
+    m_ReferredToEmbeddableInteropType = old_m_ReferredToEmbeddableInteropType;
+    m_pCompilerProject->Set_pReferredToEmbeddableInteropType(save_m_pReferredToEmbeddableInteropType);
+
+    if (ReferredToEmbeddableInteropType)
+    {
+        if (old_m_TrackReferrencesToEmbeddableInteropTypes)
+        {
+            m_ReferredToEmbeddableInteropType = true;
+        }
+
+        if (save_m_pReferredToEmbeddableInteropType)
+        {
+            *save_m_pReferredToEmbeddableInteropType = true;
+        }
+    }
+    else
+    {
+        m_pBuilder->m_BindingTokenHashTable.AddWithSize(&TypeSpecKey, sizeof(TypeSpecKey), TypeSpec);
+    }
+
+    return TypeSpec;
+#endif
+}
+
+mdTypeSpec
+MetaEmit::DefineGenericTypeInstantiationBySignature
+(
+    BCSYM_GenericTypeBinding *pBinding,
+    Location *pReferencingLocation
+)
 {
     Signature GenericSignature;
     StartNewSignature(&GenericSignature);
@@ -2833,6 +2954,7 @@ MetaEmit::DefineGenericTypeInstantiation
 
     mdTypeSpec TypeSpec;
     mdTypeSpec *CachedTypeSpec = (mdTypeSpec *)m_pBuilder->m_ProjectHashTable.FindWithSize(GetTypeInstantiation(), GetSigSize());
+    COUNT_TOKEN_CACHE_LOOKUP(Builder::TokenCache_TypeSpec, CachedTypeSpec != NULL);
 
     if (CachedTypeSpec)
     {
@@ -2882,6 +3004,7 @@ MetaEmit::DefineGenericMethodInstantiation
     mdMethodSpec *CachedMethodSpec;
 
     CachedMethodSpec = (mdMethodSpec *)m_pBuilder->m_ProjectHashTable.FindWithSize(GetMethodInstantiation(), GetSigSize());
+    COUNT_TOKEN_CACHE_LOOKUP(Builder::TokenCache_MethodSpec, CachedMethodSpec != NULL);
 
     if (CachedMethodSpec)
     {
@@ -2931,6 +3054,7 @@ mdTypeSpec MetaEmit::DefineTypeSpec
     EncodeFinishArrayKey();
 
     pValue = (ArrayValue *)m_pBuilder->m_ProjectHashTable.FindWithSize(GetArrayKey(), GetSigSize());
+    COUNT_TOKEN_CACHE_LOOKUP(Builder::TokenCache_ArraySpec, pValue && pValue->m_tkTypeSpec);
 
     if (pValue && pValue->m_tkTypeSpec)
     {
@@ -5696,29 +5820,69 @@ ULONG MetaEmit::ALinkEmitOneResource
 
     if (presource->m_fEmbed)
     {
-        // We're embedding the resource, so map the file
-        // and copy its contents into the PE.
-        MapFile mapfile;
+        // We're embedding the resource, so read the file's contents
+        // straight into the PE.  Reading in fixed-size chunks rather than
+        // mapping the whole file keeps large resources from pulling a
+        // second full copy of themselves into the working set.
+        const DWORD cbReadChunk = 1024 * 1024;
+
+        DWORD  cbFile = 0;
+        HANDLE hFile = OpenFileEx(presource->m_pstrFile, &cbFile);
 
-        mapfile.Map(presource->m_pstrFile, pErrorTable);
-        if (mapfile.FMapped())
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            pErrorTable->CreateErrorWithError(ERRID_UnableToOpenFile1,
+                                              NULL,
+                                              GetLastHResultError(),
+                                              presource->m_pstrFile);
+        }
+        else
         {
-            DWORD   cbFile;
             void   *pvBuffer;
 
-            cbFile = mapfile.CbFile();
-
             // Size of the resource includes 4-byte size prefix
             cbResource = cbFile + sizeof(DWORD);
-            IfFalseThrow(cbResource >= cbFile);
+            if (cbResource < cbFile)
+            {
+                CloseHandle(hFile);
+                VbThrow(E_UNEXPECTED);
+            }
 
             // Write size of resource (in bytes) followed by resource's bits
             hr = pFileGen->GetSectionBlock(hCeeSection, cbResource, 1, &pvBuffer);
             if (SUCCEEDED(hr))
             {
+                PBYTE pbNext = (PBYTE)pvBuffer + sizeof(DWORD);
+                DWORD cbLeft = cbFile;
+
                 memcpy(pvBuffer, &cbFile, sizeof(DWORD));
-                memcpy((PBYTE)pvBuffer + sizeof(DWORD), mapfile.PbMapAddr(), cbFile);
 
+                while (cbLeft > 0)
+                {
+                    DWORD cbRead = 0;
+
+                    if (!ReadFile(hFile, pbNext, min(cbLeft, cbReadChunk), &cbRead, NULL))
+                    {
+                        hr = GetLastHResultError();
+                        break;
+                    }
+
+                    if (cbRead == 0)
+                    {
+                        // The file shrank after we sized it
+                        hr = HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+                        break;
+                    }
+
+                    pbNext += cbRead;
+                    cbLeft -= cbRead;
+                }
+            }
+
+            CloseHandle(hFile);
+
+            if (SUCCEEDED(hr))
+            {
                 hr = m_pALink->EmbedResource(
                     m_mdAssemblyOrModule,     // IN - Unique ID for the assembly
                     m_mdAssemblyOrModule,     // IN - FileToken or AssemblyID of file that has the resource
@@ -117,6 +117,7 @@ public:
     void EncodeGenericArguments(BCSYM_GenericBinding *Binding, unsigned stType, bool EncodeParentArguments, Location *pReferencingLocation);
 
     mdTypeSpec DefineGenericTypeInstantiation(BCSYM_GenericTypeBinding *pBinding, Location *pReferencingLocation);
+    mdTypeSpec DefineGenericTypeInstantiationBySignature(BCSYM_GenericTypeBinding *pBinding, Location *pReferencingLocation);
     mdMethodSpec DefineGenericMethodInstantiation(BCSYM_NamedRoot *pMethod, BCSYM_GenericBinding *pBinding, mdMemberRef tkUnboundMemberRef, Location *pReferencingLocation);
 
     // Define a method in the metadata.
@@ -7,9 +7,14 @@
 //-------------------------------------------------------------------------------------------------
 
 #include "StdAfx.h"
+#include "..\CommandLine\Timing.h"
 
 #define VERSION_BUFFER_SIZE 15 // a typical version is: v4.0.20324, so imagine V999.999.91225
 
+#if DEBUG
+VSEXTERN_SWITCH(fDumpTokenCacheHits);
+#endif
+
 //****************************************************************************
 // Helpers
 //****************************************************************************
@@ -495,12 +500,19 @@ Builder::Builder
     m_pCompilerProject(pProject),
     m_nra(NORLSLOC),
     m_ProjectHashTable(&m_nra),
+#if !IDE
+    m_BindingTokenHashTable(&m_nra),
+#endif
     m_pPDBForwardProcCache(NULL),
     m_pModulesCache(NULL)
 #if IDE 
     , m_bProcessingTransients(false)
 #endif IDE
 {
+#if DEBUG
+    memset(m_rgcTokenCacheLookups, 0, sizeof(m_rgcTokenCacheLookups));
+    memset(m_rgcTokenCacheHits, 0, sizeof(m_rgcTokenCacheHits));
+#endif
 }
 
 void Builder::Destroy()
@@ -599,7 +611,20 @@ void Builder::ClearCaches()
 {
     unsigned i;
 
+#if DEBUG
+    if (VSFSWITCH(fDumpTokenCacheHits))
+    {
+        DumpTokenCacheHits();
+    }
+
+    memset(m_rgcTokenCacheLookups, 0, sizeof(m_rgcTokenCacheLookups));
+    memset(m_rgcTokenCacheHits, 0, sizeof(m_rgcTokenCacheHits));
+#endif
+
     m_ProjectHashTable.Clear();
+#if !IDE
+    m_BindingTokenHashTable.Clear();
+#endif
     m_NoPiaTypeDefToTypeRefMap.Clear();
 
     // clear out the table which caches tokens for the runtime members
@@ -615,6 +640,35 @@ void Builder::ClearCaches()
     }
 }
 
+#if DEBUG
+//============================================================================
+// Dump how often each token cache saved a call into the metadata emitter.
+//============================================================================
+
+void Builder::DumpTokenCacheHits()
+{
+    static const char * const s_rgszTokenCaches[TokenCache_Count] =
+    {
+        "TypeSpec (by blob)",
+        "MethodSpec (by blob)",
+        "MemberRef (by blob)",
+        "array TypeSpec (by blob)",
+        "TypeSpec (by binding)",
+        "MemberRef (by binding)",
+    };
+
+    DebPrintf("Token cache hits for project : %S\n", m_pCompilerProject ? m_pCompilerProject->GetAssemblyName() : L"");
+
+    for (unsigned i = 0; i < TokenCache_Count; i++)
+    {
+        if (m_rgcTokenCacheLookups[i])
+        {
+            DebPrintf("    %-40s %lu of %lu\n", s_rgszTokenCaches[i], m_rgcTokenCacheHits[i], m_rgcTokenCacheLookups[i]);
+        }
+    }
+}
+#endif
+
 #if IDE 
 
 HRESULT Builder::GetSymbolHashKey(BCSYM_NamedRoot *pnamed, SymbolHash *pHash)
@@ -1566,9 +1620,7 @@ bool PEBuilder::Compile
 
     m_pErrorTable = pErrorTableProject;
 
-    AllContainersInFileInOrderIterator iter;
     CompilerFile *pFile = NULL;
-    BCSYM_Container *pContainer;
 
     pInfo->m_hasErrors = m_pCompilerProject->HasErrors_AllowCaching();
     m_pCompilerProject->GetSecAttrSetsToEmit()->Clear();
@@ -1616,7 +1668,7 @@ bool PEBuilder::Compile
 
 #if IDE 
     // Give priority to the preferred file
-    DynamicHashTable<CompilerFile *, bool> filesToPrefer;
+    PreferredFileTable filesToPrefer;
     SourceFile * pPrefferedFile = OptimizeFileCompilationList(filesToPrefer);
 #endif
     
@@ -1626,98 +1678,8 @@ bool PEBuilder::Compile
         if (pFile->IsSourceFile() && !pFile->CompileAsNeeded())
         {
             SourceFile *pSourceFile = pFile->PSourceFile();
-            Text TextInSourceFile;
-
-            // Hijack the PEBuilder's ErrorTable to point at the ErrorTable
-            // for this file.  This will let CompileMethodsOfContainer and
-            // EmitAttributes report errors on the file that's being compiled
-            m_pErrorTable = pSourceFile->GetCurrentErrorTable();
-
-            SetSourceFile(pSourceFile);
-
-            // Initialize the iterator that takes us over the classes.
-            iter.Init(pSourceFile);
-            pContainer = iter.Next();
-
-            if (pContainer)
-            {
-                IfFailThrow(TextInSourceFile.Init(pSourceFile));
-            }
-
-            // VSW#545896
-            // The lowest risk way to fix this bug is to ensure that ProcessAllXMLDocCommentNodes runs after
-            // Text::Init, so that xml doc errors are not misdetected by Text::Init as previously existing
-            // 'file load' errors.
-            //
-            // As the first step of compiling, process all the XML doccomments so they would be up-to-date.
-#if IDE
-            XMLParseTreeCache cache;
-            if (pContainer)
-            {
-                cache.SetText(pSourceFile, &TextInSourceFile);
-            }
-#endif
-            pSourceFile->GetXMLDocFile()->BindAllXMLDocCommentNodes();
-
-            //Make sure XML Errors Get accounted before starting codegen
-            if (!pInfo->m_hasErrors)
-            {
-                pInfo->m_hasErrors = pFile->HasActiveErrorsNoLock();
-            }
-
-#if IDE 
-            // See if we should stop the compiler.
-            if (CheckStop(NULL))
-            {
-                fAborted = true;
-                goto Abort;
-            }
-#endif IDE
-            if (pContainer)
-            {
-                // Emit each of the classes.
-                do
-                {
-                    if (pContainer->IsClass())
-                    {
-                        // Emit code for contents of container.
-
-                        // Line number tables and PE image buffers need to survive
-                        // incremental rebuilds, so line number tables and images
-                        // must be allocated with the same lifetimes as their
-                        //associated symbols.
-
-                        IfTrueAbort(CompileMethodsOfContainer(pContainer, &TextInSourceFile,
-                                                            pInfo, &metaemitHelper));
-                    }
-
-#if IDE 
-                    if (pSourceFile->GetHasGeneratedMetadata() && !m_pCompilerProject->OutputIsNone())
-                    {
-                        if (m_pCompilerProject->IsDebuggingInProgress())
-                        {
-                            m_pCompilerProject->m_fILEmitTasksSkippedDuringDebugging = true;
-                        }
-                        else
-#endif
-                        {
 
-                            // Emit custom attributes attached anywhere inside this
-                            // top-level container.  Note that we only do this if
-                            // this SourceFile has had metadata completely
-                            // generated for it.  Otherwise we will AV if we
-                            // try to attach attributes to un-emitted/stale tokens.
-                            IfTrueAbort(EmitAttributes(pContainer,
-                                                    pInfo, &metaemitHelper));
-                        }
-#if IDE 
-                    }
-#endif
-                } while (pContainer = iter.Next());
-            }
-
-            // Save the errors.
-            pSourceFile->MergeCurrentErrors();
+            IfTrueAbort(CompileMethodBodiesOfFile(pSourceFile, pInfo, &metaemitHelper));
 
 #if IDE 
             // Merge errors possibly added for the preferred file while processing partial types in the current file.
@@ -1897,7 +1859,7 @@ Abort:
 
 #if IDE 
 
-SourceFile * PEBuilder::OptimizeFileCompilationList(DynamicHashTable<CompilerFile *, bool> & filesToPrefer)
+SourceFile * PEBuilder::OptimizeFileCompilationList(PreferredFileTable & filesToPrefer)
 {
     // Give priority to the preferred file
     SourceFile * pPrefferedFile = m_pCompilerProject->GetCompilerHost()->GetPreferredSourceFile();
@@ -1946,7 +1908,7 @@ SourceFile * PEBuilder::OptimizeFileCompilationList(DynamicHashTable<CompilerFil
             }
 
             // Let's move marked files now
-            HashTableIterator<CompilerFile *, bool, VBAllocWrapper> filesToMoveIterator = filesToPrefer.GetIterator();
+            FlatHashTableIterator<CompilerFile *, bool, VBAllocWrapper> filesToMoveIterator = filesToPrefer.GetIterator();
             bool movePrefferedFile = false;
 
             while (filesToMoveIterator.MoveNext())
@@ -1986,6 +1948,120 @@ SourceFile * PEBuilder::OptimizeFileCompilationList(DynamicHashTable<CompilerFil
 
 
 
+//============================================================================
+// Generate the IL and emit the attributes for every class in one source
+// file.  This is the unit of work of the CS_TypesEmitted -> CS_Compiled
+// step: it only depends on the file, the shared PEInfo and the MetaEmit
+// helper that serializes emission into the module.
+//============================================================================
+bool PEBuilder::CompileMethodBodiesOfFile
+(
+    SourceFile *pSourceFile,
+    _Inout_ PEInfo *pInfo,
+    _Inout_ MetaEmit *pMetaemitHelper
+)
+{
+    bool fAborted = false;
+    AllContainersInFileInOrderIterator iter;
+    BCSYM_Container *pContainer;
+    Text TextInSourceFile;
+
+    // Hijack the PEBuilder's ErrorTable to point at the ErrorTable
+    // for this file.  This will let CompileMethodsOfContainer and
+    // EmitAttributes report errors on the file that's being compiled
+    m_pErrorTable = pSourceFile->GetCurrentErrorTable();
+
+    SetSourceFile(pSourceFile);
+
+    // Initialize the iterator that takes us over the classes.
+    iter.Init(pSourceFile);
+    pContainer = iter.Next();
+
+    if (pContainer)
+    {
+        IfFailThrow(TextInSourceFile.Init(pSourceFile));
+    }
+
+    // VSW#545896
+    // The lowest risk way to fix this bug is to ensure that ProcessAllXMLDocCommentNodes runs after
+    // Text::Init, so that xml doc errors are not misdetected by Text::Init as previously existing
+    // 'file load' errors.
+    //
+    // As the first step of compiling, process all the XML doccomments so they would be up-to-date.
+#if IDE
+    XMLParseTreeCache cache;
+    if (pContainer)
+    {
+        cache.SetText(pSourceFile, &TextInSourceFile);
+    }
+#endif
+    pSourceFile->GetXMLDocFile()->BindAllXMLDocCommentNodes();
+
+    //Make sure XML Errors Get accounted before starting codegen
+    if (!pInfo->m_hasErrors)
+    {
+        pInfo->m_hasErrors = pSourceFile->HasActiveErrorsNoLock();
+    }
+
+#if IDE 
+    // See if we should stop the compiler.
+    if (CheckStop(NULL))
+    {
+        fAborted = true;
+        goto Abort;
+    }
+#endif IDE
+    if (pContainer)
+    {
+        // Emit each of the classes.
+        do
+        {
+            if (pContainer->IsClass())
+            {
+                // Emit code for contents of container.
+
+                // Line number tables and PE image buffers need to survive
+                // incremental rebuilds, so line number tables and images
+                // must be allocated with the same lifetimes as their
+                //associated symbols.
+
+                IfTrueAbort(CompileMethodsOfContainer(pContainer, &TextInSourceFile,
+                                                    pInfo, pMetaemitHelper));
+            }
+
+#if IDE 
+            if (pSourceFile->GetHasGeneratedMetadata() && !m_pCompilerProject->OutputIsNone())
+            {
+                if (m_pCompilerProject->IsDebuggingInProgress())
+                {
+                    m_pCompilerProject->m_fILEmitTasksSkippedDuringDebugging = true;
+                }
+                else
+#endif
+                {
+
+                    // Emit custom attributes attached anywhere inside this
+                    // top-level container.  Note that we only do this if
+                    // this SourceFile has had metadata completely
+                    // generated for it.  Otherwise we will AV if we
+                    // try to attach attributes to un-emitted/stale tokens.
+                    IfTrueAbort(EmitAttributes(pContainer,
+                                            pInfo, pMetaemitHelper));
+                }
+#if IDE 
+            }
+#endif
+        } while (pContainer = iter.Next());
+    }
+
+    // Save the errors.
+    pSourceFile->MergeCurrentErrors();
+
+Abort:
+
+    return fAborted;
+}
+
 bool PEBuilder::CompleteCompilationTask(CompilerFile *pFile)
 {
     bool fAborted = false;
@@ -2014,6 +2090,8 @@ Abort:
 #if IDE 
 void PEBuilder::CompileToDisk(bool *pfGeneratedOutput, ErrorTable* pErrorTableProject)
 {
+    TIMEBLOCK(TIME_CompileToDisk);
+
     bool fGeneratedOutput = false;
     HRESULT hrCaught = NOERROR;
 
@@ -5146,6 +5224,8 @@ ILTree::ILNode *PEBuilder::GenerateBoundTreeForProc
 
             if (!pTree)
             {
+                TIMEBLOCK(TIME_InterpretMethodBodies);
+
                 IfFailThrow(
                     pSourceFile->GetBoundMethodBodyTrees(
                         pProc,
@@ -5351,6 +5431,8 @@ bool PEBuilder::GenerateCodeForContainer
 
                 VSASSERT(pMetaemitHelper->IsPrivateMembersEmpty(), "MetaEmit helper contains old data.");
 
+                TIMEBLOCK(TIME_GenerateMethods);
+
                 CodeGenerator codegen(m_pCompiler, &nraCodeGen, pNraSymbolStorage, pMetaemitHelper, NULL);
                 BYTE *pbImage;
                 unsigned cbImage;
@@ -154,6 +154,33 @@ public:
         return m_pErrorTable;
     }
 
+    // The token caches MetaEmit consults before calling the metadata emitter.
+    // Only debug builds count lookups, see DumpTokenCacheHits.
+    enum TokenCacheKind
+    {
+        TokenCache_TypeSpec,                // generic type instantiation, by signature blob
+        TokenCache_MethodSpec,              // generic method instantiation, by signature blob
+        TokenCache_MemberRef,               // member reference, by signature blob
+        TokenCache_ArraySpec,               // array type, by signature blob
+        TokenCache_BoundTypeSpec,           // generic type instantiation, by binding
+        TokenCache_BoundMemberRef,          // member of a generic type instantiation, by member and binding
+        TokenCache_Count
+    };
+
+#if DEBUG
+    void CountTokenCacheLookup(TokenCacheKind Kind, bool Hit)
+    {
+        m_rgcTokenCacheLookups[Kind]++;
+
+        if (Hit)
+        {
+            m_rgcTokenCacheHits[Kind]++;
+        }
+    }
+
+    void DumpTokenCacheHits();
+#endif
+
 protected:
     Builder(Compiler *pCompiler, CompilerProject *pProject);
     ~Builder() {}
@@ -218,6 +245,18 @@ protected:
     //
     HashTable<HASH_TABLE_SIZE> m_ProjectHashTable;
 
+#if !IDE
+    // Tokens for generic instantiations keyed on the binding symbols, so a repeated
+    // reference can skip encoding its signature blob.  Symbols aren't stable across
+    // decompilation, so the IDE relies on the blob-keyed entries in m_ProjectHashTable.
+    HashTable<HASH_TABLE_SIZE> m_BindingTokenHashTable;
+#endif
+
+#if DEBUG
+    unsigned long m_rgcTokenCacheLookups[TokenCache_Count];
+    unsigned long m_rgcTokenCacheHits[TokenCache_Count];
+#endif
+
     // This hash table is used to keep track of the definition order and TypeRef tokens that we create for NoPia embedded 
     // types. 
     struct PiaTypeDefInfo
@@ -326,7 +365,10 @@ public:
     bool Compile(CompileType type, _Out_ bool *pfGeneratedOutput, ErrorTable *pErrorTable, BYTE **ppImage);
 
 #if IDE 
-    SourceFile * OptimizeFileCompilationList(DynamicHashTable<CompilerFile *, bool> & filesToPrefer);
+    // Open addressed: this set is probed once per file on every compile.
+    typedef FlatHashTable<CompilerFile *, bool> PreferredFileTable;
+
+    SourceFile * OptimizeFileCompilationList(PreferredFileTable & filesToPrefer);
 
     void CompileToDisk(bool *pfGeneratedOutput, ErrorTable* pErrorTableProject);
     bool CompileToDiskAsync();
@@ -435,6 +477,13 @@ private:
     // Emit all the security attributes applied in this project.
     void EmitAllSecurityAttributes();
 
+    // Compile the method bodies and emit the attributes of all the classes
+    // in one source file.
+    //
+    bool CompileMethodBodiesOfFile(SourceFile *pSourceFile,
+                                   _Inout_ PEInfo *pInfo,
+                                   _Inout_ MetaEmit *metaemitHelper);
+
     // Compile any methods in this container.  The cached file and its hash
     // tabe must be set up before this call.
     //
@@ -635,6 +635,28 @@ ILTree::PILNode ptreeStmtCur    // SB_CASE
             }
         }
     }
+    else if (ptreeSelect->uFlags & (SBF_SELECT_STRING_DISPATCH | SBF_SELECT_CLUSTERED))
+    {
+        // The dispatch was all emitted by GenerateStringSelectDispatch or GenerateClusteredSelect,
+        // which left the body code block of each Case in its FalseBlock.
+        //
+        if (ptreeSelect->AsSelectBlock().ptreeChild != ptreeStmtCur)
+        {
+            VSASSERT(ptreeSelect->AsSelectBlock().EndBlock,
+                       "GenerateCase: SELECT must have a block end code block.");
+
+            // Add a Resume entry to protect against fall-through from the previous Case block.
+            UpdateResumeTable(ptreeStmtCur->AsStatement().ResumeIndex, false);
+            EndCodeBuffer(CEE_BR_S, ptreeSelect->AsSelectBlock().EndBlock);
+        }
+
+        VSASSERT(ptreeStmtCur->AsCaseBlock().FalseBlock,
+                   "GenerateCase: code block for dispatched CASE doesn't exist");
+
+        SetAsCurrentCodeBlock(ptreeStmtCur->AsCaseBlock().FalseBlock);
+        UpdateLineTable(ptreeStmtCur);
+        InsertNOP();
+    }
     else
     {
         ILTree::PILNode ptreeChild;
@@ -906,11 +928,491 @@ ILTree::PILNode ptreeStmtCur    // SB_SELECT
 
         SetAsCurrentCodeBlock(0);
     }
+    else if (Select->uFlags & SBF_SELECT_CLUSTERED)
+    {
+        // Generate the select assignment statement
+        GenerateRvalue(Select->SelectorCapture);
+
+        GenerateClusteredSelect(Select);
+    }
     else
     {
         // Generate the select assignment statement
         GenerateRvalue(Select->SelectorCapture);
+
+        GenerateStringSelectDispatch(Select);
+    }
+}
+
+//========================================================================
+// Generate the dispatch for a Select whose constants Semantics split into
+// dense clusters (see Semantics::RecommendClusteredSwitchTable).  The
+// selector is binary searched across the clusters.  A cluster of several
+// ranges gets its own SWITCH table;  a cluster of one range branches
+// straight to its Case once the bounds are known to hold:
+//
+//   VB Code                                   COM+ pseudocode
+//   ---------------------------------         ----------------------------------
+//   Select Case i                             temp = i
+//                                             if temp < 1000 branch L0
+//                                             if temp < 5000 branch L1
+//                                             switch (temp - 5000)    (5000-5030)
+//                                             branch CaseElse
+//                                       L1:   switch (temp - 1000)    (1000-1050)
+//                                             branch CaseElse
+//                                       L0:   switch (temp - 0)       (0-50)
+//                                             branch CaseElse
+//       Case 0, 1, ...                  Case1:
+//       ...
+//       Case Else                       CaseElse:
+//   End Select
+//
+// Each Case body gets its code block up front, kept in its FalseBlock.
+//========================================================================
+
+void CodeGenerator::GenerateClusteredSelect
+(
+    ILTree::SelectBlock *Select
+)
+{
+    VSASSERT(Select->ClusterCount > 0 && Select->Clusters && Select->Intervals,
+             "GenerateClusteredSelect: clustered Select without clusters");
+
+    unsigned cCases = 0;
+    ILTree::PILNode ptreeCase;
+
+    for (ptreeCase = Select->ptreeChild; ptreeCase; ptreeCase = ptreeCase->AsCaseBlock().Next)
+    {
+        cCases++;
+    }
+
+    CODE_BLOCK **CaseBodies = (CODE_BLOCK **)m_pnra->Alloc(VBMath::Multiply(cCases, sizeof(CODE_BLOCK *)));
+    CODE_BLOCK *pcblkDefault = Select->EndBlock;
+
+    cCases = 0;
+
+    for (ptreeCase = Select->ptreeChild; ptreeCase; ptreeCase = ptreeCase->AsCaseBlock().Next)
+    {
+        CaseBodies[cCases] = NewCodeBlock();
+        ptreeCase->AsCaseBlock().FalseBlock = CaseBodies[cCases];
+
+        if (ptreeCase->uFlags & SBF_CASE_ISELSE)
+        {
+            pcblkDefault = CaseBodies[cCases];
+        }
+
+        cCases++;
+    }
+
+    GenerateClusterSearch(Select, CaseBodies, pcblkDefault, 0, Select->ClusterCount, false, false);
+
+    SetAsCurrentCodeBlock(0);
+}
+
+//========================================================================
+// Generate the search over Clusters[First, Last).  LowKnown means the
+// selector is already known to be at least the low bound of the first
+// cluster;  HighKnown that it is at most the high bound of the last one.
+//========================================================================
+
+void CodeGenerator::GenerateClusterSearch
+(
+    ILTree::SelectBlock *Select,
+    CODE_BLOCK **CaseBodies,
+    CODE_BLOCK *pcblkDefault,
+    unsigned First,
+    unsigned Last,
+    bool LowKnown,
+    bool HighKnown
+)
+{
+    Vtypes vtype = Select->SelectorTemporary->GetType()->GetVtype();
+    bool Is64bit = vtype == t_i8 || vtype == t_ui8;
+    bool IsUnsigned = IsUnsignedType(vtype);
+    ILTree::CASE_INTERVAL *Intervals = Select->Intervals;
+
+    if (Last - First > 1)
+    {
+        unsigned Middle = First + (Last - First) / 2;
+        ILTree::CASE_INTERVAL *MiddleLow = &Intervals[Select->Clusters[Middle].FirstInterval];
+        ILTree::CASE_INTERVAL *BelowHigh = &Intervals[Select->Clusters[Middle].FirstInterval - 1];
+        CODE_BLOCK *pcblkBelow = NewCodeBlock();
+
+        GenerateLoadOrElseLoadLocal(Select->LiftedSelectorTemporary, Select->SelectorTemporary);
+        GenerateLiteralInt(MiddleLow->Low, Is64bit);
+        EndCodeBuffer(IsUnsigned ? CEE_BLT_UN_S : CEE_BLT_S, pcblkBelow, vtype);
+        SetAsCurrentCodeBlock(0);
+
+        GenerateClusterSearch(Select, CaseBodies, pcblkDefault, Middle, Last, true, HighKnown);
+
+        SetAsCurrentCodeBlock(pcblkBelow);
+
+        GenerateClusterSearch(Select, CaseBodies, pcblkDefault, First, Middle, LowKnown, BelowHigh->High + 1 == MiddleLow->Low);
+        return;
+    }
+
+    ILTree::CASE_CLUSTER *Cluster = &Select->Clusters[First];
+    ILTree::CASE_INTERVAL *ClusterLow = &Intervals[Cluster->FirstInterval];
+    ILTree::CASE_INTERVAL *ClusterHigh = &Intervals[Cluster->FirstInterval + Cluster->IntervalCount - 1];
+
+    // A single value needs only the one compare
+    if (Cluster->IntervalCount == 1 && !LowKnown && !HighKnown && ClusterLow->Low == ClusterLow->High)
+    {
+        GenerateLoadOrElseLoadLocal(Select->LiftedSelectorTemporary, Select->SelectorTemporary);
+        GenerateLiteralInt(ClusterLow->Low, Is64bit);
+        EndCodeBuffer(CEE_BEQ_S, CaseBodies[ClusterLow->CaseIndex], vtype);
+        SetAsCurrentCodeBlock(0);
+        EndCodeBuffer(CEE_BR_S, pcblkDefault);
+        return;
+    }
+
+    // A SWITCH on a 32-bit value rejects out of range values itself (the
+    // normalized index compares as unsigned), but a 64-bit one would be
+    // truncated, so guard it like a range.
+    //
+    if (Cluster->IntervalCount == 1 || Is64bit)
+    {
+        if (!LowKnown)
+        {
+            GenerateLoadOrElseLoadLocal(Select->LiftedSelectorTemporary, Select->SelectorTemporary);
+            GenerateLiteralInt(ClusterLow->Low, Is64bit);
+            EndCodeBuffer(IsUnsigned ? CEE_BLT_UN_S : CEE_BLT_S, pcblkDefault, vtype);
+            SetAsCurrentCodeBlock(0);
+        }
+
+        if (!HighKnown)
+        {
+            GenerateLoadOrElseLoadLocal(Select->LiftedSelectorTemporary, Select->SelectorTemporary);
+            GenerateLiteralInt(ClusterHigh->High, Is64bit);
+            EndCodeBuffer(IsUnsigned ? CEE_BGT_UN_S : CEE_BGT_S, pcblkDefault, vtype);
+            SetAsCurrentCodeBlock(0);
+        }
+    }
+
+    if (Cluster->IntervalCount == 1)
+    {
+        EndCodeBuffer(CEE_BR_S, CaseBodies[ClusterLow->CaseIndex]);
+        return;
+    }
+
+    unsigned long cEntries = (unsigned long)(ClusterHigh->High - ClusterLow->Low + 1);
+    SWITCH_TABLE *SwitchTable = AllocSwitchTable(cEntries);
+    unsigned long iEntry;
+    unsigned iInterval;
+
+    SwitchTable->cEntries = cEntries;
+    SwitchTable->LowVal = ClusterLow->Low;
+    SwitchTable->HiVal = ClusterHigh->High;
+    SwitchTable->pcblkCaseElse = pcblkDefault != Select->EndBlock ? pcblkDefault : NULL;
+    SwitchTable->pcblkFallThrough = NewCodeBlock();
+
+    for (iEntry = 0; iEntry < cEntries; iEntry++)
+    {
+        SwitchTable->pcodeaddrs[iEntry].pcblk = pcblkDefault;
+    }
+
+    for (iInterval = Cluster->FirstInterval; iInterval < Cluster->FirstInterval + Cluster->IntervalCount; iInterval++)
+    {
+        unsigned long iHigh = (unsigned long)(Intervals[iInterval].High - SwitchTable->LowVal);
+
+        for (iEntry = (unsigned long)(Intervals[iInterval].Low - SwitchTable->LowVal); iEntry <= iHigh; iEntry++)
+        {
+            SwitchTable->pcodeaddrs[iEntry].pcblk = CaseBodies[Intervals[iInterval].CaseIndex];
+        }
+    }
+
+    GenerateLoadOrElseLoadLocal(Select->LiftedSelectorTemporary, Select->SelectorTemporary);
+
+    if (SwitchTable->LowVal != 0)
+    {
+        GenerateLiteralInt(SwitchTable->LowVal, Is64bit);
+        EmitOpcode(CEE_SUB, GetSymbolForVtype(vtype));
+    }
+
+    // switch opcodes only take I4;  the guards above keep the conversion exact
+    Vtypes vtypeNormalization = vtype;
+    if (vtype == t_i8)
+    {
+        vtypeNormalization = t_i4;
+        EmitOpcode(CEE_CONV_I4, GetSymbolForVtype(vtypeNormalization));
+    }
+    else if (vtype == t_ui8)
+    {
+        vtypeNormalization = t_ui4;
+        EmitOpcode(CEE_CONV_U4, GetSymbolForVtype(vtypeNormalization));
+    }
+
+    // ENC requires a remappable point before each switch (VSW#205252).
+    InsertENCRemappablePoint(GetSymbolForVtype(vtypeNormalization));
+
+    StartHiddenIL();
+    EndCodeBuffer(CEE_SWITCH, SwitchTable); // CEE_SWITCH does not push any values.
+
+    SetAsCurrentCodeBlock(SwitchTable->pcblkFallThrough);
+    EndCodeBuffer(CEE_BR_S, pcblkDefault);
+}
+
+//========================================================================
+// Collect the "selector = constant" tests of a String Case condition in
+// source order.  Pass NULL Leaves to only count and validate them.
+// Returns false if the condition is anything other than an OrElse chain
+// of binary compares of the selector temporary against string constants.
+//========================================================================
+
+bool CodeGenerator::GatherStringCaseLeaves
+(
+    ILTree::PILNode ptreeCond,
+    BCSYM_Variable *SelectorTemporary,
+    CODE_BLOCK *pcblkBody,
+    _Out_opt_ STRING_CASE_LEAF *Leaves,
+    _Inout_ unsigned *pcLeaves,
+    _Inout_ size_t *pMinLength,
+    _Inout_ size_t *pMaxLength
+)
+{
+    if (ptreeCond->bilop == SX_ORELSE)
+    {
+        return
+            GatherStringCaseLeaves(ptreeCond->AsExpressionWithChildren().Left, SelectorTemporary, pcblkBody, Leaves, pcLeaves, pMinLength, pMaxLength) &&
+            GatherStringCaseLeaves(ptreeCond->AsExpressionWithChildren().Right, SelectorTemporary, pcblkBody, Leaves, pcLeaves, pMinLength, pMaxLength);
+    }
+
+    // Option Compare Text compares are not length preserving, so they can't be bucketed
+    if (ptreeCond->bilop != SX_EQ || (ptreeCond->uFlags & SXF_RELOP_TEXT))
+    {
+        return false;
+    }
+
+    ILTree::PILNode ptreeL = ptreeCond->AsExpressionWithChildren().Left;
+    ILTree::PILNode ptreeR = ptreeCond->AsExpressionWithChildren().Right;
+
+    if (ptreeL->bilop != SX_SYM ||
+        ptreeL->AsSymbolReferenceExpression().Symbol != SelectorTemporary ||
+        ptreeL->AsSymbolReferenceExpression().BaseReference ||
+        ptreeR->bilop != SX_CNS_STR)
+    {
+        return false;
+    }
+
+    size_t Length = ptreeR->AsStringConstant().Length;
+
+    if (*pcLeaves == 0 || Length < *pMinLength)
+    {
+        *pMinLength = Length;
+    }
+    if (*pcLeaves == 0 || Length > *pMaxLength)
+    {
+        *pMaxLength = Length;
+    }
+
+    if (Leaves)
+    {
+        Leaves[*pcLeaves].Condition = ptreeCond;
+        Leaves[*pcLeaves].pcblkBody = pcblkBody;
+        Leaves[*pcLeaves].Length = Length;
+    }
+
+    (*pcLeaves)++;
+    return true;
+}
+
+//========================================================================
+// Optimized Select Case over a String where every Case is a list of
+// constants compared with Option Compare Binary.  Rather than testing
+// each constant in turn, SWITCH on the length of the selector and only
+// compare against the constants of that length:
+//
+//   VB Code                                   COM+ pseudocode
+//   ---------------------------------         ----------------------------------
+//   Select Case s                             temp = s
+//                                             if temp Is Nothing, branch L0
+//                                             switch (temp.Length - 2)
+//                                             0:  branch L2
+//                                             1:  branch L3
+//                                             branch CaseElse
+//                                       L2:   if temp = "ab" branch Case1
+//                                             if temp = "cd" branch Case2
+//                                             branch CaseElse
+//                                       L3:   if temp = "xyz" branch Case1
+//                                             branch CaseElse
+//       Case "ab", "xyz"                Case1:
+//       Case "cd"                       Case2:
+//       Case Else                       CaseElse:
+//   End Select
+//
+// The tests themselves are the ones Semantics built, so Nothing still
+// matches "" and the first matching Case in source order still wins.
+// Returns false (and generates nothing) if the Select doesn't qualify.
+//========================================================================
+
+bool CodeGenerator::GenerateStringSelectDispatch
+(
+    ILTree::SelectBlock *Select
+)
+{
+    // Fewer constants than this are compared faster one after the other
+    const unsigned MinimumDispatchLeaves = 8;
+
+    Select->uFlags &= ~SBF_SELECT_STRING_DISPATCH;
+
+    if (!m_Project->GenerateOptimalIL() ||
+        m_ptreeFunc->AsProcedureBlock().fSeenOnErr ||
+        Select->LiftedSelectorTemporary ||
+        (Select->uFlags & SBF_SELECT_TABLE) ||
+        Select->SelectorTemporary->GetType()->GetVtype() != t_string)
+    {
+        return false;
+    }
+
+    ILTree::PILNode ptreeCase;
+    unsigned cLeaves = 0;
+    size_t MinLength = 0;
+    size_t MaxLength = 0;
+
+    for (ptreeCase = Select->ptreeChild; ptreeCase; ptreeCase = ptreeCase->AsCaseBlock().Next)
+    {
+        if (ptreeCase->uFlags & SBF_CASE_ISELSE)
+        {
+            continue;
+        }
+
+        if (!(ptreeCase->uFlags & SBF_CASE_CONDITION) ||
+            !ptreeCase->AsCaseBlock().Conditional ||
+            !GatherStringCaseLeaves(ptreeCase->AsCaseBlock().Conditional, Select->SelectorTemporary, NULL, NULL, &cLeaves, &MinLength, &MaxLength))
+        {
+            return false;
+        }
+    }
+
+    // Only worth it if the lengths are dense enough for a SWITCH table
+    if (cLeaves < MinimumDispatchLeaves ||
+        MaxLength > 0x7fffffff ||
+        MaxLength - MinLength + 1 > 2 * (size_t)cLeaves + 16)
+    {
+        return false;
+    }
+
+    BCSYM_NamedRoot *pLength = GetSymbolForVtype(t_string)->PClass()->SimpleBind(NULL, STRING_CONST(m_pCompiler, Length));
+
+    if (!pLength || !pLength->IsProperty() || !pLength->PProperty()->GetProperty())
+    {
+        return false;
+    }
+
+    unsigned long cBuckets = (unsigned long)(MaxLength - MinLength + 1);
+    STRING_CASE_LEAF *Leaves = (STRING_CASE_LEAF *)m_pnra->Alloc(VBMath::Multiply(cLeaves, sizeof(STRING_CASE_LEAF)));
+    STRING_CASE_LEAF *SortedLeaves = (STRING_CASE_LEAF *)m_pnra->Alloc(VBMath::Multiply(cLeaves, sizeof(STRING_CASE_LEAF)));
+    unsigned *BucketStart = (unsigned *)m_pnra->Alloc(VBMath::Multiply(cBuckets + 1, sizeof(unsigned)));
+    CODE_BLOCK *pcblkCaseElse = NULL;
+    unsigned iLeaf = 0;
+    unsigned long iBucket;
+
+    // Each Case body gets its code block up front so the dispatch can branch to it.
+    // The conditions aren't generated by GenerateCase, so FalseBlock is free to hold it.
+    //
+    cLeaves = 0;
+
+    for (ptreeCase = Select->ptreeChild; ptreeCase; ptreeCase = ptreeCase->AsCaseBlock().Next)
+    {
+        CODE_BLOCK *pcblkBody = NewCodeBlock();
+
+        ptreeCase->AsCaseBlock().FalseBlock = pcblkBody;
+
+        if (ptreeCase->uFlags & SBF_CASE_ISELSE)
+        {
+            pcblkCaseElse = pcblkBody;
+        }
+        else
+        {
+            GatherStringCaseLeaves(ptreeCase->AsCaseBlock().Conditional, Select->SelectorTemporary, pcblkBody, Leaves, &cLeaves, &MinLength, &MaxLength);
+        }
+    }
+
+    // Bucket the tests by length, keeping source order within a bucket
+    memset(BucketStart, 0, (cBuckets + 1) * sizeof(unsigned));
+
+    for (iLeaf = 0; iLeaf < cLeaves; iLeaf++)
+    {
+        BucketStart[Leaves[iLeaf].Length - MinLength + 1]++;
+    }
+    for (iBucket = 0; iBucket < cBuckets; iBucket++)
+    {
+        BucketStart[iBucket + 1] += BucketStart[iBucket];
+    }
+    for (iLeaf = 0; iLeaf < cLeaves; iLeaf++)
+    {
+        SortedLeaves[BucketStart[Leaves[iLeaf].Length - MinLength]++] = Leaves[iLeaf];
+    }
+    // BucketStart[i] now holds the end of bucket i, which is the start of bucket i + 1
+
+    CODE_BLOCK *pcblkDefault = pcblkCaseElse ? pcblkCaseElse : Select->EndBlock;
+    SWITCH_TABLE *SwitchTable = AllocSwitchTable(cBuckets);
+
+    SwitchTable->cEntries = cBuckets;
+    SwitchTable->LowVal = MinLength;
+    SwitchTable->HiVal = MaxLength;
+    SwitchTable->pcblkCaseElse = pcblkCaseElse;
+    SwitchTable->pcblkFallThrough = NewCodeBlock();
+
+    for (iBucket = 0; iBucket < cBuckets; iBucket++)
+    {
+        unsigned First = iBucket ? BucketStart[iBucket - 1] : 0;
+
+        SwitchTable->pcodeaddrs[iBucket].pcblk = (BucketStart[iBucket] > First) ? NewCodeBlock() : pcblkDefault;
     }
+
+    Select->uFlags |= SBF_SELECT_STRING_DISPATCH;
+
+    // Nothing has no length;  it is only equal to "", which lives in the first bucket
+    GenerateLoadOrElseLoadLocal(NULL, Select->SelectorTemporary);
+    EndCodeBuffer(CEE_BRFALSE_S, MinLength == 0 ? SwitchTable->pcodeaddrs[0].pcblk : pcblkDefault, t_string);
+    SetAsCurrentCodeBlock(0);
+
+    GenerateLoadOrElseLoadLocal(NULL, Select->SelectorTemporary);
+
+    mdMemberRef LengthToken = m_pmdemit->DefineMemberRefBySymbol(pLength->PProperty()->GetProperty(), NULL, &Select->Loc);
+
+    // For calls, we need to explicitly manage the stack, so pop the call target off of the stack.
+    m_stackTypes.PopOrDequeue();
+    EmitOpcode_Tok(CEE_CALLVIRT, LengthToken, GetSymbolForVtype(t_i4));
+
+    if (MinLength != 0)
+    {
+        GenerateLiteralInt((__int32)MinLength);
+        EmitOpcode(CEE_SUB, GetSymbolForVtype(t_i4));
+    }
+
+    // ENC requires a remappable point before each switch (VSW#205252).
+    InsertENCRemappablePoint(GetSymbolForVtype(t_i4));
+
+    StartHiddenIL();
+    EndCodeBuffer(CEE_SWITCH, SwitchTable); // CEE_SWITCH does not push any values.
+
+    SetAsCurrentCodeBlock(SwitchTable->pcblkFallThrough);
+    EndCodeBuffer(CEE_BR_S, pcblkDefault);
+
+    for (iBucket = 0; iBucket < cBuckets; iBucket++)
+    {
+        unsigned First = iBucket ? BucketStart[iBucket - 1] : 0;
+
+        if (BucketStart[iBucket] == First)
+        {
+            continue;
+        }
+
+        SetAsCurrentCodeBlock(SwitchTable->pcodeaddrs[iBucket].pcblk);
+
+        for (iLeaf = First; iLeaf < BucketStart[iBucket]; iLeaf++)
+        {
+            GenerateCondition(SortedLeaves[iLeaf].Condition, false, SortedLeaves[iLeaf].pcblkBody, NewCodeBlock());
+        }
+
+        EndCodeBuffer(CEE_BR_S, pcblkDefault);
+    }
+
+    SetAsCurrentCodeBlock(0);
+
+    return true;
 }
 
 //========================================================================
@@ -0,0 +1,31 @@
+// ==++==
+//
+//   Copyright (c) Microsoft Corporation.  All rights reserved.
+//
+// ==--==
+// ===========================================================================
+// File: timerids.h
+//
+// The list of timed sections reported by timing.cpp.  Each TIMERID names a
+// section and the subtotal group it is reported in; sections in a group must
+// be listed together.  Times are exclusive, so a section that runs inside
+// another one is not counted twice.
+// ===========================================================================
+
+TIMER_GROUP(0, "Declared")
+TIMERID(TIME_BuildSymbols,           "Scan, parse and declare (per file)",      0)
+TIMERID(TIME_PromoteToDeclared,      "Project to Declared",                     0)
+
+TIMER_GROUP(1, "Bound")
+TIMERID(TIME_BindSymbols,            "Bindable (per file)",                     1)
+TIMERID(TIME_PromoteToBound,         "Project to Bound",                        1)
+
+TIMER_GROUP(2, "Emit")
+TIMERID(TIME_PromoteToTypesEmitted,  "Emit types and members",                  2)
+TIMERID(TIME_InterpretMethodBodies,  "Semantics and lowering of method bodies", 2)
+TIMERID(TIME_GenerateMethods,        "CodeGenerator",                           2)
+TIMERID(TIME_PromoteToCompiled,      "Project to Compiled",                     2)
+TIMERID(TIME_CompileToDisk,          "Write PE and PDB",                        2)
+
+#define LAST_TIMER_GROUP_ID 3
+TIMER_GROUP(LAST_TIMER_GROUP_ID, "")
@@ -44,10 +44,16 @@ struct TIMERSECTIONDATA
 {
     unsigned totalCount;
     __int64 totalTime;
+    unsigned maxPageHeapUse;    // most NorlsAllocator page memory seen at the start or end of the section
 };
 
 TIMERSECTIONDATA g_timerData[TIMERID_MAX];
 
+// Local slots of the methods in which CodeGenerator shared temporary slots.
+unsigned g_cMethodsWithSharedSlots;
+unsigned g_cLocalsBeforeSharing;
+unsigned g_cLocalsAfterSharing;
+
 #define TIMER_GROUP(cat, name)
 #define TIMERID(id, text, subtotal) { L##text, subtotal} ,
 const TIMERSECTIONINFO g_timerInfo[TIMERID_MAX] =
@@ -129,8 +135,13 @@ void ActivateTiming()
     {
         g_timerData[id].totalCount = 0;
         g_timerData[id].totalTime = 0;
+        g_timerData[id].maxPageHeapUse = 0;
     }
 
+    g_cMethodsWithSharedSlots = 0;
+    g_cLocalsBeforeSharing = 0;
+    g_cLocalsAfterSharing = 0;
+
     InitializeTimerTick();
     g_stopTime = 0;
     g_timeridStackPtr = -1;
@@ -150,6 +161,26 @@ void FinishTiming()
 }
 
 
+// Remember the page heap use for the section.  Sampling only at the
+// start and end keeps this cheap; the transient peaks inside a section
+// still show up in the process-wide high-water mark in the report.
+static void RecordPageHeapUse(TIMERID timerId)
+{
+    unsigned pageHeapUse = g_pvbNorlsManager->GetPageHeap().GetCurrentUseSize();
+
+    if (pageHeapUse > g_timerData[timerId].maxPageHeapUse)
+    {
+        g_timerData[timerId].maxPageHeapUse = pageHeapUse;
+    }
+}
+
+void DoTimerRecordLocalSlots(unsigned cLocalsBefore, unsigned cLocalsAfter)
+{
+    g_cMethodsWithSharedSlots++;
+    g_cLocalsBeforeSharing += cLocalsBefore;
+    g_cLocalsAfterSharing += cLocalsAfter;
+}
+
 #pragma optimize("", off) // Otherwise the compiler ----s up stack walking in retail and confuses Watson
  __declspec(noreturn) inline void OnCriticalInternalError()
 {
@@ -198,6 +229,7 @@ void DoTimerStart(TIMERID timerId)
 
     // update the count and remember when we started.
     ++g_timerData[timerId].totalCount;
+    RecordPageHeapUse(timerId);
     g_lastTime = now;
 }
 
@@ -221,6 +253,7 @@ void DoTimerStop(TIMERID timerId)
     // Record the amount of time so far in the current section, if any.
     g_timerData[timerId].totalTime += (now - g_lastTime);
     g_timeridStackPtr = stackPtr;
+    RecordPageHeapUse(timerId);
 
     // remember the new time
     g_lastTime = now;
@@ -372,6 +405,84 @@ void ReportTimes(FILE * outputFile)
     fwprintf(outputFile, L"%-50s  %10s  %7.3f%%\n\n", L"TOTAL OF TIMED SECTIONS", L"",
              (double) total / elapsedTime * 100.0);
 }
+
+/*
+ * Write the timed sections as a JSON document, for tools that track the
+ * numbers from build to build.  Times are in milliseconds.
+ */
+void ReportTimesInJSON(FILE * outputFile)
+{
+    LARGE_INTEGER qpcFreq;
+    QueryPerformanceFrequency(& qpcFreq);
+
+    double elapsedTime = (double)(g_stopTime - g_startTime);
+    double elapsedTimeMsec = (double)(g_qpcStopTime.QuadPart - g_qpcStartTime.QuadPart) / (double) qpcFreq.QuadPart * 1000.0;
+    PageHeap & pageHeap = g_pvbNorlsManager->GetPageHeap();
+
+    fwprintf(outputFile, L"{\n");
+    fwprintf(outputFile, L"  \"totalMsec\": %.1f,\n", elapsedTimeMsec);
+    fwprintf(outputFile, L"  \"pageHeapMaxUse\": %u,\n", pageHeap.GetMaxUseSize());
+    fwprintf(outputFile, L"  \"pageHeapMaxReserve\": %u,\n", pageHeap.GetMaxReserveSize());
+    fwprintf(outputFile,
+             L"  \"sharedLocalSlots\": { \"methods\": %u, \"localsBefore\": %u, \"localsAfter\": %u },\n",
+             g_cMethodsWithSharedSlots,
+             g_cLocalsBeforeSharing,
+             g_cLocalsAfterSharing);
+    fwprintf(outputFile, L"  \"sections\": [");
+
+    bool first = true;
+
+    for (TIMERID id = (TIMERID)0; id < TIMERID_MAX; id = (TIMERID) (id + 1))
+    {
+        if (g_timerData[id].totalCount == 0)
+        {
+            continue;
+        }
+
+        PCWSTR groupName = L"";
+
+        for (const TimerGroupName * tgroup = g_timergroups; tgroup->m_group_id != LAST_TIMER_GROUP_ID; tgroup++)
+        {
+            if (tgroup->m_group_id == g_timerInfo[id].subTotal)
+            {
+                groupName = tgroup->m_group_name;
+                break;
+            }
+        }
+
+        // The section names are literals from timerids.h and never need escaping.
+        fwprintf(outputFile,
+                 L"%s\n    { \"group\": \"%s\", \"name\": \"%s\", \"hits\": %u, \"msec\": %.3f, \"pageHeapMaxUse\": %u }",
+                 first ? L"" : L",",
+                 groupName,
+                 g_timerInfo[id].name,
+                 g_timerData[id].totalCount,
+                 elapsedTime > 0 ? (double) g_timerData[id].totalTime / elapsedTime * elapsedTimeMsec : 0.0,
+                 g_timerData[id].maxPageHeapUse);
+
+        first = false;
+    }
+
+    fwprintf(outputFile, L"\n  ]\n}\n");
+}
+
+void ReportTimesInJSON(PCWSTR outputFile)
+{
+    if (!_wcsicmp(outputFile, L"stdout"))
+    {
+        ReportTimesInJSON(stdout);
+    }
+    else
+    {
+        FILE * file = NULL;
+
+        if (!_wfopen_s(&file, outputFile, L"w"))
+        {
+            ReportTimesInJSON(file);
+            fclose(file);
+        }
+    }
+}
 #endif
 
 #ifdef CSEE
@@ -45,6 +45,7 @@ extern void ActivateTiming();
 extern void FinishTiming();
 extern void DoTimerStart(TIMERID timerId);
 extern void DoTimerStop(TIMERID timerId);
+extern void DoTimerRecordLocalSlots(unsigned cLocalsBefore, unsigned cLocalsAfter);
 
 // Begin timing something.
 __forceinline void TimerStart(TIMERID timerId)
@@ -60,6 +61,13 @@ __forceinline void TimerStop(TIMERID timerId)
         DoTimerStop(timerId);
 }
 
+// Record the locals of a method before and after temporary slots were shared
+__forceinline void TimerRecordLocalSlots(unsigned cLocalsBefore, unsigned cLocalsAfter)
+{
+    if (g_isTimingActive)
+        DoTimerRecordLocalSlots(cLocalsBefore, cLocalsAfter);
+}
+
 // class to time a block of code
 class TIMERBLOCK
 {
@@ -90,6 +98,10 @@ void ReportTimesInXML(FILE * outputFile);
 // pass in "stdout" to output to console. Otherwise, specified file is opened for append.
 void ReportTimesInXML(PCWSTR outputFile);
 
+// Same as the above, as JSON.  The specified file is overwritten.
+void ReportTimesInJSON(FILE * outputFile);
+void ReportTimesInJSON(PCWSTR outputFile);
+
 #else   //CSEE
 
 extern __int64 GetCurrentTimerTickM();
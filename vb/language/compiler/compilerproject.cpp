@@ -7,6 +7,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include "StdAfx.h"
+#include "CommandLine\Timing.h"
 
 #if IDE 
 #define ENCDUMPTASKLISTKEY      L"VBENCSUITESDUMPTASKLIST"
@@ -137,6 +138,118 @@ void LiftedUserDefinedOperatorCache::NodeOperations::copy(
     pNodeDest->pLiftedOperator = pNodeSrc->pLiftedOperator;
 }
 
+ConversionCache::ConversionCache(NorlsAllocator * pNorls) :
+    m_cache(pNorls),
+    m_cHits(0),
+    m_cMisses(0)
+{
+    ThrowIfNull(pNorls);
+}
+
+bool
+ConversionCache::LookupInCache
+(
+    BCSYM * pTargetType,                            //[in] - the target of the conversion
+    BCSYM * pSourceType,                            //[in] - the source of the conversion
+    unsigned Flags,                                 //[in] - the flags the conversion was classified with
+    int * pClassification,                          //[out] - the cached ConversionClass
+    BCSYM_Proc ** ppOperatorMethod,                 //[out] - the cached conversion operator, may be NULL
+    bool * pRequiresUnliftedAccessToNullableValue   //[out] - may be null
+)
+{
+    Node * pNode = NULL;
+
+    if (m_cache.Find(&Key(pTargetType, pSourceType, Flags), &pNode))
+    {
+        m_cHits++;
+
+        *pClassification = pNode->Classification;
+        *ppOperatorMethod = pNode->pOperatorMethod;
+
+        if (pRequiresUnliftedAccessToNullableValue)
+        {
+            *pRequiresUnliftedAccessToNullableValue = pNode->RequiresUnliftedAccessToNullableValue;
+        }
+        return true;
+    }
+    else
+    {
+        m_cMisses++;
+        return false;
+    }
+}
+
+void
+ConversionCache::AddEntry
+(
+    BCSYM * pTargetType,
+    BCSYM * pSourceType,
+    unsigned Flags,
+    int Classification,
+    BCSYM_Proc * pOperatorMethod,
+    bool RequiresUnliftedAccessToNullableValue
+)
+{
+    Node * pNode = NULL;
+
+    m_cache.Insert(&Key(pTargetType, pSourceType, Flags), &pNode);
+    pNode->Classification = Classification;
+    pNode->pOperatorMethod = pOperatorMethod;
+    pNode->RequiresUnliftedAccessToNullableValue = RequiresUnliftedAccessToNullableValue;
+}
+
+void ConversionCache::Clear()
+{
+    m_cache.Clear();
+}
+
+NorlsAllocator * ConversionCache::GetNorlsAllocator()
+{
+    return m_cache.GetNorlsAllocator();
+}
+
+ConversionCache::Key::Key() :
+    pTargetType(NULL),
+    pSourceType(NULL),
+    Flags(0)
+{
+}
+
+ConversionCache::Key::Key(BCSYM * pTarget, BCSYM * pSource, unsigned KeyFlags) :
+    pTargetType(pTarget),
+    pSourceType(pSource),
+    Flags(KeyFlags)
+{
+}
+
+int ConversionCache::KeyOperations::compare(
+    const Key * pKey1,
+    const Key * pKey2)
+{
+    if (pKey1->pTargetType != pKey2->pTargetType)
+    {
+        return pKey1->pTargetType < pKey2->pTargetType ? -1 : 1;
+    }
+    if (pKey1->pSourceType != pKey2->pSourceType)
+    {
+        return pKey1->pSourceType < pKey2->pSourceType ? -1 : 1;
+    }
+    if (pKey1->Flags != pKey2->Flags)
+    {
+        return pKey1->Flags < pKey2->Flags ? -1 : 1;
+    }
+    return 0;
+}
+
+void ConversionCache::NodeOperations::copy(
+    Node * pNodeDest,
+    const Node * pNodeSrc)
+{
+    pNodeDest->Classification = pNodeSrc->Classification;
+    pNodeDest->pOperatorMethod = pNodeSrc->pOperatorMethod;
+    pNodeDest->RequiresUnliftedAccessToNullableValue = pNodeSrc->RequiresUnliftedAccessToNullableValue;
+}
+
 //forward declaration
 bool IsEqual(
     DynamicArray<VbCompilerWarningItemLevel> * memberWarningsLevelTable,
@@ -304,11 +417,259 @@ NorlsAllocator * ExtensionMethodNameLookupCache::GetNorlsAllocator()
     return m_cache.GetNorlsAllocator();
 }
 
+LookupCache::LookupCache(_In_ NorlsAllocator *pNoReleaseAllocator) :
+    m_pNoReleaseAllocator(pNoReleaseAllocator),
+    m_rgBuckets(NULL),
+    m_cBuckets(0),
+    m_cNodes(0),
+    m_cMaxEntries(0),
+    m_pLruHead(NULL),
+    m_pLruTail(NULL),
+    m_cHits(0),
+    m_cMisses(0),
+    m_cEvictions(0)
+{
+}
+
+unsigned long LookupCache::HashKey(const LookupKey *pKey)
+{
+    // The STRING_INFO hash is computed once when the name is interned, so
+    // the only per-lookup work is folding in the scope and the flags.
+    unsigned long hash = pKey->Name ? pKey->Name->m_ulLocalHash : 0;
+
+    hash = hash * 31 + (unsigned long)((UINT_PTR)pKey->Scope >> 3);
+    hash = hash * 31 + (unsigned long)(pKey->Flags ^ (pKey->Flags >> 32));
+    hash = hash * 31 + pKey->BindspaceMask;
+    hash = hash * 31 + (unsigned long)pKey->GenericTypeArity;
+    hash = hash * 31 + pKey->IgnoreFlags;
+    hash = hash * 31 + (unsigned long)((UINT_PTR)pKey->m_pProject >> 3);
+
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+bool LookupCache::KeysEqual(const LookupKey *pKey1, const LookupKey *pKey2)
+{
+    return
+        pKey1->Name == pKey2->Name &&
+        pKey1->Scope == pKey2->Scope &&
+        pKey1->Flags == pKey2->Flags &&
+        pKey1->BindspaceMask == pKey2->BindspaceMask &&
+        pKey1->GenericTypeArity == pKey2->GenericTypeArity &&
+        pKey1->IgnoreFlags == pKey2->IgnoreFlags &&
+        pKey1->m_pProject == pKey2->m_pProject;
+}
+
+bool LookupCache::Find(const LookupKey *pKey, _Out_opt_ LookupNode **ppNode)
+{
+    VSASSERT(pKey != NULL, "Invalid Null Pointer");
+
+    if (m_rgBuckets)
+    {
+        unsigned long hash = HashKey(pKey);
+
+        for (LookupNode *pNode = m_rgBuckets[hash & (m_cBuckets - 1)]; pNode; pNode = pNode->m_pNextInBucket)
+        {
+            if (pNode->m_hash == hash && KeysEqual(&pNode->key, pKey))
+            {
+                m_cHits++;
+
+                if (m_cMaxEntries)
+                {
+                    // Recency only matters when we may have to evict.
+                    UnlinkFromLru(pNode);
+                    LinkAtLruHead(pNode);
+                }
+
+                if (ppNode)
+                {
+                    *ppNode = pNode;
+                }
+                return true;
+            }
+        }
+    }
+
+    m_cMisses++;
+
+    if (ppNode)
+    {
+        *ppNode = NULL;
+    }
+    return false;
+}
+
+//============================================================================
+// Returns true if a new node was inserted, false if a node with the same key
+// already existed. Either way *ppNode receives that node.
+//============================================================================
+bool LookupCache::Insert(const LookupKey *pKey, _Out_opt_ LookupNode **ppNode)
+{
+    VSASSERT(pKey != NULL, "Invalid Null Pointer");
+
+    unsigned long hash = HashKey(pKey);
+
+    if (m_rgBuckets)
+    {
+        for (LookupNode *pNode = m_rgBuckets[hash & (m_cBuckets - 1)]; pNode; pNode = pNode->m_pNextInBucket)
+        {
+            if (pNode->m_hash == hash && KeysEqual(&pNode->key, pKey))
+            {
+                if (ppNode)
+                {
+                    *ppNode = pNode;
+                }
+                return false;
+            }
+        }
+    }
+
+    LookupNode *pNewNode = NULL;
+
+    if (m_cMaxEntries && m_cNodes >= m_cMaxEntries)
+    {
+        pNewNode = EvictLeastRecentlyUsed();
+        memset(pNewNode, 0, sizeof(LookupNode));
+    }
+    else
+    {
+        if (!m_rgBuckets || m_cNodes >= m_cBuckets)
+        {
+            Grow();
+        }
+
+        pNewNode = m_pNoReleaseAllocator->Alloc<LookupNode>();
+    }
+
+    pNewNode->key = *pKey;
+    pNewNode->m_hash = hash;
+
+    LookupNode **ppBucket = &m_rgBuckets[hash & (m_cBuckets - 1)];
+    pNewNode->m_pNextInBucket = *ppBucket;
+    *ppBucket = pNewNode;
+
+    LinkAtLruHead(pNewNode);
+    m_cNodes++;
+
+    if (ppNode)
+    {
+        *ppNode = pNewNode;
+    }
+    return true;
+}
+
+//============================================================================
+// Drops all entries. The node and bucket storage belongs to the no-release
+// allocator and is reclaimed when that allocator is freed.
+//============================================================================
+void LookupCache::Clear()
+{
+    m_rgBuckets = NULL;
+    m_cBuckets = 0;
+    m_cNodes = 0;
+    m_pLruHead = NULL;
+    m_pLruTail = NULL;
+}
+
+//============================================================================
+// Doubles the bucket array. The old array is left on the no-release
+// allocator, which at most doubles the bucket memory over the cache lifetime.
+//============================================================================
+void LookupCache::Grow()
+{
+    ULONG cNewBuckets = m_cBuckets ? VBMath::Multiply(m_cBuckets, 2) : InitialBucketCount;
+    LookupNode **rgNewBuckets = m_pNoReleaseAllocator->AllocArray<LookupNode *>(cNewBuckets);
+
+    for (ULONG i = 0; i < m_cBuckets; i++)
+    {
+        LookupNode *pNode = m_rgBuckets[i];
+        while (pNode)
+        {
+            LookupNode *pNext = pNode->m_pNextInBucket;
+            LookupNode **ppBucket = &rgNewBuckets[pNode->m_hash & (cNewBuckets - 1)];
+
+            pNode->m_pNextInBucket = *ppBucket;
+            *ppBucket = pNode;
+            pNode = pNext;
+        }
+    }
+
+    m_rgBuckets = rgNewBuckets;
+    m_cBuckets = cNewBuckets;
+}
+
+//============================================================================
+// Unlinks the least recently used node from its bucket and the LRU list and
+// returns it so its storage can be reused.
+//============================================================================
+LookupNode *LookupCache::EvictLeastRecentlyUsed()
+{
+    LookupNode *pVictim = m_pLruTail;
+    VSASSERT(pVictim != NULL, "Evicting from an empty lookup cache");
+
+    LookupNode **ppLink = &m_rgBuckets[pVictim->m_hash & (m_cBuckets - 1)];
+    while (*ppLink != pVictim)
+    {
+        ppLink = &(*ppLink)->m_pNextInBucket;
+    }
+    *ppLink = pVictim->m_pNextInBucket;
+
+    UnlinkFromLru(pVictim);
+    m_cNodes--;
+    m_cEvictions++;
+
+    return pVictim;
+}
+
+void LookupCache::LinkAtLruHead(LookupNode *pNode)
+{
+    pNode->m_pLruPrev = NULL;
+    pNode->m_pLruNext = m_pLruHead;
+
+    if (m_pLruHead)
+    {
+        m_pLruHead->m_pLruPrev = pNode;
+    }
+    else
+    {
+        m_pLruTail = pNode;
+    }
+
+    m_pLruHead = pNode;
+}
+
+void LookupCache::UnlinkFromLru(LookupNode *pNode)
+{
+    if (pNode->m_pLruPrev)
+    {
+        pNode->m_pLruPrev->m_pLruNext = pNode->m_pLruNext;
+    }
+    else
+    {
+        m_pLruHead = pNode->m_pLruNext;
+    }
+
+    if (pNode->m_pLruNext)
+    {
+        pNode->m_pLruNext->m_pLruPrev = pNode->m_pLruPrev;
+    }
+    else
+    {
+        m_pLruTail = pNode->m_pLruPrev;
+    }
+
+    pNode->m_pLruPrev = NULL;
+    pNode->m_pLruNext = NULL;
+}
+
 CompilationCaches::CompilationCaches():
     m_nrlsCachedData(NORLSLOC),
     m_LookupCache(&m_nrlsCachedData),
     m_ExtensionMethodLookupCache(&m_nrlsCachedData),  
     m_LiftedOperatorCache(&m_nrlsCachedData),
+    m_ConversionCache(&m_nrlsCachedData),
     m_MergedNamespaceCache(&m_nrlsCachedData)
 {
 #if IDE  
@@ -322,6 +683,7 @@ CompilationCaches::CompilationCaches(NorlsAllocator * pnorls):
     m_LookupCache(pnorls),
     m_ExtensionMethodLookupCache(pnorls),  
     m_LiftedOperatorCache(pnorls),
+    m_ConversionCache(pnorls),
     m_MergedNamespaceCache(pnorls)
 {
     VSASSERT(GetCompilerSharedState()->IsInMainThread(), "GetCompilerSharedState()->IsInMainThread()");
@@ -366,7 +728,9 @@ void CompilationCaches::ClearCompilationCaches(int  cacheType /*= 0*/)
     }
     if (cacheType  & CompCacheType_LiftedUDFOp )
     {
+        // Conversion results depend on the same user-defined operators.
         m_LiftedOperatorCache.Clear();
+        m_ConversionCache.Clear();
     }
     if (cacheType  & CompCacheType_NSRing )
     {
@@ -430,10 +794,10 @@ bool AllocatorLifeTimeOk(NorlsAllocator *pRecordedAlloc, NorlsAllocator *pCompCa
 #endif NRLSTRACK
 
 
-template<> void LookupTree::ValidateNodes(void)
+void LookupCache::ValidateNodes(void)
 {
 #if NRLSTRACK
-    LookupTree::Iterator oLookupTreeIterator(this);
+    LookupCache::Iterator oLookupTreeIterator(this);
     LookupNode *pLookupNode;
 
     for (long i = 0 ; (pLookupNode = oLookupTreeIterator.Next()) ; i++)
@@ -442,7 +806,7 @@ template<> void LookupTree::ValidateNodes(void)
         {
             if (!AllocatorLifeTimeOk(pLookupNode->Result->GetRecordedAllocator(), m_pNoReleaseAllocator))
             {
-                VSASSERT(false,"LookupTree Wrong allocator");
+                VSASSERT(false,"LookupCache Wrong allocator");
             }
         }
     }
@@ -525,12 +889,12 @@ template<> void NamespaceRingTree::ValidateNodes(void)
 
 #define TEMPBUFSIZE   2048* sizeof(WCHAR)      
 
-CComBSTR  LookupTree::GetNodeDump(_In_opt_ bool fOutputDebugWindow)
+CComBSTR  LookupCache::GetNodeDump(_In_opt_ bool fOutputDebugWindow)
 {
     CComBSTR bstrResult;
     WCHAR szBuffer[TEMPBUFSIZE];
 
-    LookupTree::Iterator oLookupTreeIterator(this);
+    LookupCache::Iterator oLookupTreeIterator(this);
     LookupNode *pLookupNode;
     
     for (long i = 0 ; (pLookupNode = oLookupTreeIterator.Next()) ; i++)
@@ -560,6 +924,23 @@ CComBSTR  LookupTree::GetNodeDump(_In_opt_ bool fOutputDebugWindow)
     return bstrResult;
 }
 
+void LookupCache::DumpCacheStats()
+{
+    DebPrintf("Nodes=%5u Buckets=%5u Max=%5u", m_cNodes, m_cBuckets, m_cMaxEntries);
+    DebPrintf(" SRCH hits=%5u miss=%5u evict=%5u\n", m_cHits, m_cMisses, m_cEvictions);
+}
+
+void ConversionCache::DumpCacheStats()
+{
+    ULONG cLookups = m_cHits + m_cMisses;
+
+    m_cache.DumpTreeStats();
+    DebPrintf("        SRCH hits=%5u miss=%5u rate=%5.1f%%\n",
+        m_cHits,
+        m_cMisses,
+        cLookups ? (100.0 * m_cHits) / cLookups : 0.0);
+}
+
 CComBSTR ExtensionMethodNameLookupCache::tree_type::GetNodeDump(_In_opt_ bool fOutputDebugWindow)
 {
     CComBSTR bstrResult;
@@ -686,7 +1067,7 @@ CComBSTR NamespaceRingTree::GetNodeDump(_In_opt_ bool fOutputDebugWindow)
 void CompilationCaches::DumpStats()
 {
     DebPrintf("Lookup  ");
-    m_LookupCache.DumpTreeStats();
+    m_LookupCache.DumpCacheStats();
     m_LookupCache.GetNodeDump(true);
         
     DebPrintf("ExtMthd ");
@@ -697,13 +1078,18 @@ void CompilationCaches::DumpStats()
     m_LiftedOperatorCache.m_cache.DumpTreeStats();
     m_LiftedOperatorCache.m_cache.GetNodeDump(true);
 
+    DebPrintf("Convrsn ");
+    m_ConversionCache.DumpCacheStats();
+
     DebPrintf("MrgdNsp ");
     m_MergedNamespaceCache.DumpTreeStats();
     m_MergedNamespaceCache.GetNodeDump(true);
 
-    m_LookupCache.ClearTreeStats();
+    m_LookupCache.ClearCacheStats();
     m_ExtensionMethodLookupCache.m_cache.ClearTreeStats();
     m_LiftedOperatorCache.m_cache.ClearTreeStats();
+    m_ConversionCache.ClearCacheStats();
+    m_ConversionCache.m_cache.ClearTreeStats();
     m_MergedNamespaceCache.ClearTreeStats();
     
 }
@@ -855,6 +1241,7 @@ CompilerProject::CompilerProject(Compiler * pCompiler)
 ,m_ImportsCache(&m_nrlsLookupCaches)
 ,m_ExtensionMethodLookupCache(&m_nrlsLookupCaches)
 ,m_LiftedOperatorCache(&m_nrlsLookupCaches)
+,m_ConversionCache(&m_nrlsLookupCaches)
 ,m_SourceFileCache(pCompiler)
 ,m_LangVersion(LANGUAGE_CURRENT)
 ,m_PotentiallyEmbedsPiaTypes(false)
@@ -7951,6 +8338,8 @@ void CompilerProject::RemoveCompilerFile(CompilerFile* pCompilerFile)
 
 bool CompilerProject::_PromoteToDeclared()
 {
+    TIMEBLOCK(TIME_PromoteToDeclared);
+
     bool fAborted = false;
     CompilerFile *pfile = NULL;
     ErrorTable errors(m_pCompiler, this, NULL);
@@ -8096,6 +8485,8 @@ Abort:
 
 bool CompilerProject::_PromoteToBound()
 {
+    TIMEBLOCK(TIME_PromoteToBound);
+
     bool fAborted = false;
     CompilerFile *pfile;
 
@@ -8640,6 +9031,8 @@ CompilerProject::FinishPromoteToBoundForFile
 
 bool CompilerProject::_PromoteToTypesEmitted()
 {
+    TIMEBLOCK(TIME_PromoteToTypesEmitted);
+
     VSASSERT(m_cs < CS_TypesEmitted, "Attempt to promote a project to TypesEmitted that is already in this state.");
 
     bool fAborted = false;
@@ -8746,6 +9139,8 @@ Abort:
 //============================================================================
 bool CompilerProject::_PromoteToCompiled()
 {
+    TIMEBLOCK(TIME_PromoteToCompiled);
+
     bool fAborted = false;
     bool fGeneratedOutput = false;
     CompilerFile *pFile = NULL;
@@ -12329,6 +12724,11 @@ void CompilerProject::WriteToXMLDocFile()
             UTF8FileWriter XMLDocForProject(hFile, m_pCompiler);
             VB_ENTRY();
             hr = GetXMLDocForProject(&XMLDocForProject);
+
+            if (SUCCEEDED(hr))
+            {
+                XMLDocForProject.Flush();
+            }
             VB_EXIT_NORETURN();
 
             if (FAILEDHR(hr))
@@ -380,6 +380,121 @@ private:
     tree_type m_cache;
 };
 
+//============================================================================
+// ConversionCache:
+//
+//      Caches the result of classifying a user-defined conversion between two
+//      types, keyed on the (target type, source type, flags) triple. Only
+//      conversions between long lived type symbols are cached (see
+//      Semantics::ClassifyConversion), so the keys and the cached operator
+//      method stay valid until the cache is cleared along with the other
+//      lookup caches.
+//
+//      The classification is stored as an int because ConversionClass is
+//      declared in semantics.h.
+//============================================================================
+class ConversionCache
+{
+    friend class CompilationCaches;
+    friend class CVbCompilerCompCache;
+public:
+    ConversionCache
+    (
+        NorlsAllocator * pNorls
+    );
+
+    bool
+    LookupInCache
+    (
+        BCSYM * pTargetType,                            //[in] - the target of the conversion
+        BCSYM * pSourceType,                            //[in] - the source of the conversion
+        unsigned Flags,                                 //[in] - the flags the conversion was classified with
+        int * pClassification,                          //[out] - the cached ConversionClass
+        BCSYM_Proc ** ppOperatorMethod,                 //[out] - the cached conversion operator, may be NULL
+        bool * pRequiresUnliftedAccessToNullableValue   //[out] - may be null
+    );
+
+    void
+    AddEntry
+    (
+        BCSYM * pTargetType,
+        BCSYM * pSourceType,
+        unsigned Flags,
+        int Classification,
+        BCSYM_Proc * pOperatorMethod,
+        bool RequiresUnliftedAccessToNullableValue
+    );
+
+    void Clear();
+    NorlsAllocator * GetNorlsAllocator();
+
+    ULONG GetHitCount()
+    {
+        return m_cHits;
+    }
+
+    ULONG GetMissCount()
+    {
+        return m_cMisses;
+    }
+
+    void ClearCacheStats()
+    {
+        m_cHits = 0;
+        m_cMisses = 0;
+    }
+
+#if DEBUG
+    void DumpCacheStats();
+#endif DEBUG
+
+    // Flags making up the key
+    static const unsigned ConsiderConversionsOnNullableBool = 0x1;
+
+private:
+    struct Key
+    {
+        BCSYM * pTargetType;
+        BCSYM * pSourceType;
+        unsigned Flags;
+
+        Key();
+        Key
+        (
+            BCSYM * pTarget,
+            BCSYM * pSource,
+            unsigned KeyFlags
+        );
+    };
+public:
+    struct Node :
+        public RedBlackNodeBaseT<Key>
+    {
+        int Classification;
+        BCSYM_Proc * pOperatorMethod;
+        bool RequiresUnliftedAccessToNullableValue;
+    };
+private:
+    struct KeyOperations :
+        public SimpleKeyOperationsT<Key>
+    {
+        int compare(const Key *pKey1, const Key * pKey2);
+    };
+
+    struct NodeOperations :
+        public EmptyNodeOperationsT<Node>
+    {
+        void copy(Node *pNodeDest, const Node *pNodeSrc);
+    };
+public:
+    typedef RedBlackTreeT<Key, KeyOperations, Node, NodeOperations> tree_type;
+private:
+    tree_type m_cache;
+
+    ULONG m_cHits;
+    ULONG m_cMisses;
+};
+
 
 struct LookupKey
 {
@@ -432,37 +547,141 @@ struct LookupKey
     CompilerProject *m_pProject;
 };
 
-struct LookupKeyOperations :
-    public SimpleKeyOperationsT<LookupKey>
-{
-    int compare(const LookupKey *pKey1, const LookupKey *pKey2)
-    {
-        return memcmp(pKey1, pKey2, sizeof(LookupKey));
-    }
-};
-
-struct LookupNode :
-    public RedBlackNodeBaseT<LookupKey>
+struct LookupNode
 {
+    LookupKey key;
     BCSYM_NamedRoot *Result;
     BCSYM_GenericBinding *GenericBindingContext;
+
+private:
+    friend class LookupCache;
+
+    LookupNode *m_pNextInBucket;
+    LookupNode *m_pLruPrev;        // towards the most recently used node
+    LookupNode *m_pLruNext;        // towards the least recently used node
+    unsigned long m_hash;
 };
 
-struct LookupNodeOperations :
-    public EmptyNodeOperationsT<LookupNode>
+//============================================================================
+// LookupCache:
+//
+//      Hashed cache of namespace name lookup results. Nodes are chained per
+//      bucket and allocated on the no-release allocator handed to the
+//      constructor, so pointers returned by Find and Insert stay valid until
+//      Clear is called (and the allocator is eventually freed).
+//
+//      The bucket is selected from the STRING_INFO hash of the name mixed with
+//      the lookup scope; the remaining key fields are only compared on a hash
+//      match.
+//
+//      The cache may optionally be bounded with SetMaxEntries. Once the bound
+//      is reached the least recently used node is unlinked and its storage is
+//      reused for the new entry, so memory use stays flat.
+//============================================================================
+class LookupCache
 {
-    void copy(LookupNode *pNodeDest, const LookupNode *pNodeSrc)
+    friend class CVbCompilerCompCache; // test hook
+public:
+    LookupCache(_In_ NorlsAllocator *pNoReleaseAllocator);
+
+    //============================================================================
+    //     In-order (most recently used first) iterator over the cached nodes.
+    //============================================================================
+    class Iterator
+    {
+    public:
+        Iterator(LookupCache *pCache) :
+            m_pNext(pCache->m_pLruHead)
+        {
+        }
+
+        LookupNode *Next()
+        {
+            LookupNode *pCurrent = m_pNext;
+            if (pCurrent)
+            {
+                m_pNext = pCurrent->m_pLruNext;
+            }
+            return pCurrent;
+        }
+
+    private:
+        LookupNode *m_pNext;
+    };
+
+    friend Iterator;
+
+    bool Find(const LookupKey *pKey, _Out_opt_ LookupNode **ppNode = NULL);
+    bool Insert(const LookupKey *pKey, _Out_opt_ LookupNode **ppNode = NULL);
+    void Clear();
+
+    ULONG Count()
     {
-        pNodeDest->Result = pNodeSrc->Result;
-        pNodeDest->GenericBindingContext = pNodeSrc->GenericBindingContext;
+        return m_cNodes;
     }
-};
 
-typedef RedBlackTreeT<
-    LookupKey,
-    LookupKeyOperations,
-    LookupNode,
-    LookupNodeOperations> LookupTree;
+    // Zero means unbounded, which is the default.
+    void SetMaxEntries(ULONG cMaxEntries)
+    {
+        m_cMaxEntries = cMaxEntries;
+    }
+
+    ULONG GetHitCount()
+    {
+        return m_cHits;
+    }
+
+    ULONG GetMissCount()
+    {
+        return m_cMisses;
+    }
+
+    ULONG GetEvictionCount()
+    {
+        return m_cEvictions;
+    }
+
+    void ClearCacheStats()
+    {
+        m_cHits = 0;
+        m_cMisses = 0;
+        m_cEvictions = 0;
+    }
+
+    NorlsAllocator *GetNorlsAllocator()
+    {
+        return m_pNoReleaseAllocator;
+    }
+
+#if DEBUG
+    CComBSTR GetNodeDump(_In_opt_ bool fOutputDebugWindow ) ; // dump the contents into a string
+    void ValidateNodes();   // assert on the nodes
+    void DumpCacheStats();
+#endif DEBUG
+
+private:
+    static const ULONG InitialBucketCount = 256;
+
+    static unsigned long HashKey(const LookupKey *pKey);
+    static bool KeysEqual(const LookupKey *pKey1, const LookupKey *pKey2);
+
+    void Grow();
+    LookupNode *EvictLeastRecentlyUsed();
+    void LinkAtLruHead(LookupNode *pNode);
+    void UnlinkFromLru(LookupNode *pNode);
+
+    NorlsAllocator *m_pNoReleaseAllocator;
+    LookupNode **m_rgBuckets;
+    ULONG m_cBuckets;       // always a power of two once allocated
+    ULONG m_cNodes;
+    ULONG m_cMaxEntries;
+    LookupNode *m_pLruHead;
+    LookupNode *m_pLruTail;
+
+    ULONG m_cHits;
+    ULONG m_cMisses;
+    ULONG m_cEvictions;
+};
 
 // Merging of the namespace symbols happens at the compilerhost level. While calculating the
 // merged hash of a namespace ring, only symbols in the current CompilerHost are added to this
@@ -552,7 +771,7 @@ public:
     ~CompilationCaches();
 
 
-    LookupTree *GetLookupCache()
+    LookupCache *GetLookupCache()
     {
         return &m_LookupCache;
     }
@@ -567,6 +786,11 @@ public:
         return &m_LiftedOperatorCache;
     }
 
+    ConversionCache *GetConversionCache()
+    {
+        return &m_ConversionCache;
+    }
+
     NamespaceRingTree *GetMergedNamespaceCache()
     {
         return &m_MergedNamespaceCache;
@@ -582,9 +806,10 @@ public:
 #endif DEBUG
 
 private:
-    LookupTree m_LookupCache;
+    LookupCache m_LookupCache;
     ExtensionMethodNameLookupCache m_ExtensionMethodLookupCache;
     LiftedUserDefinedOperatorCache m_LiftedOperatorCache;
+    ConversionCache m_ConversionCache;
     NamespaceRingTree m_MergedNamespaceCache;
     NorlsAllocator m_nrlsCachedData;
 };
@@ -3352,7 +3577,7 @@ public:
         return &m_ExtensionMethodExistsCache;
     }
 
-    LookupTree *GetLookupCache()
+    LookupCache *GetLookupCache()
     {
         return &m_LookupCache;
     }
@@ -3367,12 +3592,18 @@ public:
         return &m_LiftedOperatorCache;
     }
 
+    ConversionCache * GetConversionCache()
+    {
+        return &m_ConversionCache;
+    }
+
     void ClearLookupCaches()
     {
         m_LookupCache.Clear();
         m_ImportsCache.Clear();
         m_ExtensionMethodLookupCache.Clear();
         m_LiftedOperatorCache.Clear();
+        m_ConversionCache.Clear();
         m_nrlsLookupCaches.FreeHeap();   
     }
 
@@ -3414,7 +3645,7 @@ public:
 private:
     NorlsAllocator m_nrlsLookupCaches;
 
-    LookupTree m_LookupCache;
+    LookupCache m_LookupCache;
     ResolvedImportsTree m_ImportsCache;
     ExtensionMethodNameLookupCache m_ExtensionMethodLookupCache;
     // When metadata is loaded, every method that has the extension attribute is added to this cache.  This cache is not used to speed up extension
@@ -3424,6 +3655,7 @@ private:
     // Note, this cache does not return the extension method symbol, it only answers whether the project contains an extension method with this name.
     HashSet<STRING_INFO*> m_ExtensionMethodExistsCache; // Entry for existence of an extension method with the name    
     LiftedUserDefinedOperatorCache m_LiftedOperatorCache;
+    ConversionCache m_ConversionCache;
 
     // The declaration type refs are populated when going to Declared state.
     HashSet<BCSYM*> m_DeclarationPiaTypeRefCache;
@@ -72,6 +72,9 @@ VBDEFINE_SWITCH(fDumpCallGraph,             "Dump Call Graph");
 VBDEFINE_SWITCH(fDumpDeclTrees,             "Dump declaration trees");
 VBDEFINE_SWITCH(fDumpDocCommentString,      "Dump Doc Comment Signature");
 VBDEFINE_SWITCH(fDumpLineTable,             "Dump Line Table");
+VBDEFINE_SWITCH(fDumpBranchOptimizations,   "Dump branch optimizations applied to each method");
+VBDEFINE_SWITCH(fDumpTokenCacheHits,        "Dump metadata token cache hits for each build");
+VBDEFINE_SWITCH(fDumpLocalSlotSharing,      "Dump locals saved by sharing temporary slots in each method");
 VBDEFINE_SWITCH(fDumpSyntheticCode,         "Dump Synthetic code" );
 VBDEFINE_SWITCH(fTraceCodeElementsExt,      "External CodeModel:  CodeElements - Trace interface calls");
 VBDEFINE_SWITCH(fTraceCodeElementsInt,      "CodeModel:  CodeElements - Trace interface calls");
@@ -93,6 +96,7 @@ VBDEFINE_SWITCH(fDumpStateChanges,          "Dump all state transitions");
 VBDEFINE_SWITCH(fDebugIntellidocCache,      "Turn on Intellidoc cache debugging");
 VBDEFINE_SWITCH(fDumpSymbols,               "Dump generated symbols");
 VBDEFINE_SWITCH(fDumpNonVBSymbols,          "Dump symbols for non-vb files");
+VBDEFINE_SWITCH(fDumpMetaDataImportStats,   "Dump how many types and members of each reference were imported");
 VBDEFINE_SWITCH(fDumpBasicRep,              "Dump Basic representation");
 VBDEFINE_SWITCH(fTraceReturn,               "Trace FAILED(hr) returns");
 VBDEFINE_SWITCH(fDebugEmptyEdit,            "Turn on empty edit debugging (EditClassify)");
@@ -1969,6 +1969,30 @@ struct LocationComparer
 
 #endif IDE
 
+// helper class used in AddErrorsToErrorArray to drop exact duplicate
+// diagnostics (same id, location and message) reported against one table
+struct CompileErrorComparer
+{
+    bool operator() (const CompileError* lhs, const CompileError* rhs) const
+    {
+        int Result = Location::Compare(lhs->m_loc, rhs->m_loc);
+
+        if (Result == 0 && lhs->m_errid != rhs->m_errid)
+        {
+            Result = lhs->m_errid < rhs->m_errid ? -1 : 1;
+        }
+
+        if (Result == 0)
+        {
+            Result = wcscmp(
+                lhs->m_wszMessage ? lhs->m_wszMessage : L"",
+                rhs->m_wszMessage ? rhs->m_wszMessage : L"");
+        }
+
+        return Result < 0;
+    }
+};
+
 void BuildErrorArrayHelper::AddErrorsToErrorArray
 (
     ErrorTable*     pErrorTable,
@@ -2023,6 +2047,10 @@ void BuildErrorArrayHelper::AddErrorsToErrorArray
     std::set<Location, LocationComparer> commentLocations; 
 #endif
 
+    // Used to avoid reporting the same diagnostic more than once. The table
+    // itself keeps the duplicates since callers compare error counts.
+    std::set<CompileError*, CompileErrorComparer> reportedErrors;
+
     // Examine each error in turn
     while (pError = errors.Next())
     {
@@ -2040,6 +2068,12 @@ void BuildErrorArrayHelper::AddErrorsToErrorArray
         // value in the pair returned by insert will be false
         if (pError->IsComment() && !commentLocations.insert( pError->m_loc ).second)
             continue;
+#endif
+
+        if (!pError->IsComment() && !reportedErrors.insert(pError).second)
+            continue;
+
+#if IDE
 
         if (pError->m_pCompilerProject &&
             pError->m_pCompilerProject->GetCompilerTaskProvider() &&
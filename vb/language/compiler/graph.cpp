@@ -40,6 +40,7 @@ void Graph::AddNode(_Out_ GraphNode * node)
     VSASSERT(!Contains(node), "Node already exists, why are you adding a vertice twice?");
     VSASSERT(node->m_Graph == NULL || node->m_Graph == this, "Node is already owned by a different tree?");
     node->m_Graph = this;
+    node->m_IsVertex = true;
     m_vertices.Add(node);
 }
 
@@ -230,13 +231,23 @@ void Graph::FinishAlgorithm()
 
 bool Graph::Contains(GraphNode * node)
 {
+    // A node is only ever a vertex of the graph it was constructed for, so the
+    // flag set by AddNode is enough. AddEdge calls this for both ends of every
+    // edge, and a linear search made building the inference graph quadratic.
+    bool isVertex = node->m_Graph == this && node->m_IsVertex;
+
+#if DEBUG
     GraphNodeComparer comparer;
-    return m_vertices.LinearSearch<GraphNodeComparer>(node, NULL, comparer);
+    VSASSERT(isVertex == m_vertices.LinearSearch<GraphNodeComparer>(node, NULL, comparer), "Vertex flag out of sync with the vertex list");
+#endif
+
+    return isVertex;
 }
 
 GraphNode::GraphNode(_In_ Graph * graph) :
     m_Incoming(*graph->GetAllocatorWrapper()) ,
-    m_Outgoing(*graph->GetAllocatorWrapper())
+    m_Outgoing(*graph->GetAllocatorWrapper()),
+    m_IsVertex(false)
 {
     m_Graph = graph;
 }
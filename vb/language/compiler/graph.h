@@ -160,6 +160,10 @@ private:
     GraphNodeArrayList  m_Outgoing;
 
     GraphAlgorithmData  m_AlgorithmData;
+
+    // Set once the node is added to m_Graph's vertex list, so that
+    // membership checks do not have to search the vertices.
+    bool                m_IsVertex;
 };
 
 
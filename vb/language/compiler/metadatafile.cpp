@@ -8,6 +8,10 @@
 
 #include "StdAfx.h"
 
+#if DEBUG
+VSEXTERN_SWITCH(fDumpMetaDataImportStats);
+#endif
+
 //****************************************************************************
 //****************************************************************************
 //****************************************************************************
@@ -112,6 +116,13 @@ Error:
 
 MetaDataFile::~MetaDataFile()
 {
+#if DEBUG
+    if (VSFSWITCH(fDumpMetaDataImportStats))
+    {
+        DumpImportStats();
+    }
+#endif
+
     ReleaseImport();
 
 #if IDE 
@@ -136,6 +147,21 @@ MetaDataFile::~MetaDataFile()
 #endif IDE
 }
 
+#if DEBUG
+void MetaDataFile::DumpImportStats()
+{
+    DebPrintf("MetaData import stats for '%S':\n", m_pstrName ? m_pstrName : L"");
+    DebPrintf("    Types imported:                %lu\n", m_cTypesImported);
+    DebPrintf("    Types with children loaded:    %lu (%lu%%)\n",
+        m_cTypesWithChildrenLoaded,
+        m_cTypesImported ? (unsigned long)((m_cTypesWithChildrenLoaded * 100ull) / m_cTypesImported) : 0);
+    DebPrintf("    Members in loaded types:       %lu\n", m_cMembersInLoadedTypes);
+    DebPrintf("    Members imported:              %lu (%lu%%)\n",
+        m_cMembersImported,
+        m_cMembersInLoadedTypes ? (unsigned long)((m_cMembersImported * 100ull) / m_cMembersInLoadedTypes) : 0);
+}
+#endif
+
 HRESULT MetaDataFile::LoadAssemblyRefs()
 {
     HRESULT hr = NOERROR;
@@ -67,6 +67,19 @@ public:
         m_pstrName = pstrName;
     }
 
+    // The MVID of the scope, read when the types are imported.  Together
+    // with the file name this identifies exactly which build of an
+    // assembly the imported symbols came from.
+    const GUID &GetMvid()
+    {
+        return m_guidMvid;
+    }
+
+    void SetMvid(const GUID &guidMvid)
+    {
+        m_guidMvid = guidMvid;
+    }
+
     IMetaDataImport *GetImport()
     {
         return m_pmdImport;
@@ -143,6 +156,17 @@ public:
     // Whether the metadatafile has one of the attributes indicating that this is a PIA
     TriState<bool> IsPIA();
 
+#if DEBUG
+    // How much of this file has actually been imported, updated by MetaImport.
+    // Members are only counted for types whose children have been loaded.
+    unsigned long m_cTypesImported;
+    unsigned long m_cTypesWithChildrenLoaded;
+    unsigned long m_cMembersInLoadedTypes;
+    unsigned long m_cMembersImported;
+
+    void DumpImportStats();
+#endif
+
 protected:
 
     //========================================================================
@@ -214,6 +238,12 @@ protected:
     : CompilerFile(pCompiler)
     , m_AssemblyRefs(pCompiler)
     , m_fAssemblyRefsLoaded(false)
+#if DEBUG
+    , m_cTypesImported(0)
+    , m_cTypesWithChildrenLoaded(0)
+    , m_cMembersInLoadedTypes(0)
+    , m_cMembersImported(0)
+#endif
     {
     }
 
@@ -224,6 +254,9 @@ protected:
     // The name of the scope.
     STRING *m_pstrName;
 
+    // The module version id of the scope.
+    GUID m_guidMvid;
+
     // The IMetaDataImport2 we will use when delay-loading
     // the containers defined in this library.  This structure owns the
     // reference to this.
@@ -8,6 +8,13 @@
 
 #include "StdAfx.h"
 
+#if defined(_M_IX86) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SCANNER_SSE2 1
+#else
+#define SCANNER_SSE2 0
+#endif
+
 #if IDE
 typedef int (STDAPICALLTYPE *PFN_GetCalendarInfoA)(LCID, CALID, CALTYPE, LPTSTR, int, LPDWORD);
 const char szCalendarInfo[] = "GetCalendarInfoA";
@@ -317,6 +324,141 @@ IsIdentifierCharacter
     return IsWideIdentifierCharacter(c);
 }
 
+//
+// The identifier, whitespace and comment loops below get most of the
+// scanner's traffic, and almost all of what they see is plain ASCII.  On x86
+// and x64 the helpers here step over runs of 8 code units with SSE2 and stop
+// at the first code unit they are not sure about; the scalar loop that
+// follows them then handles that code unit (and anything non-ASCII) exactly
+// as before.  On other platforms they do nothing.
+//
+
+#if SCANNER_SSE2
+
+inline const WCHAR *
+SkipWithMask
+(
+    const WCHAR *Here,
+    __m128i Matches
+)
+{
+    // Each WCHAR that matched sets two bits in the mask.
+    unsigned long Mismatch = ~_mm_movemask_epi8(Matches) & 0xFFFF;
+    unsigned long FirstMismatch;
+
+    _BitScanForward(&FirstMismatch, Mismatch);
+    return Here + FirstMismatch / 2;
+}
+
+#endif
+
+// Skip ASCII letters, digits and '_'.
+inline const WCHAR *
+SkipAsciiIdentifierCharacters
+(
+    _In_ const WCHAR *Here,
+    _In_ const WCHAR *End
+)
+{
+#if SCANNER_SSE2
+    const __m128i Below0 = _mm_set1_epi16('0' - 1);
+    const __m128i Above9 = _mm_set1_epi16('9' + 1);
+    const __m128i Belowa = _mm_set1_epi16('a' - 1);
+    const __m128i Abovez = _mm_set1_epi16('z' + 1);
+    const __m128i LowerCaseBit = _mm_set1_epi16(0x20);
+    const __m128i Underscore = _mm_set1_epi16('_');
+
+    while (End - Here >= 8)
+    {
+        // The compares are signed, so anything at or above 0x8000 looks
+        // negative and fails every range test, which is what we want.
+        __m128i Chars = _mm_loadu_si128((const __m128i *)Here);
+        __m128i Folded = _mm_or_si128(Chars, LowerCaseBit);
+
+        __m128i Digit = _mm_and_si128(_mm_cmpgt_epi16(Chars, Below0), _mm_cmplt_epi16(Chars, Above9));
+        __m128i Letter = _mm_and_si128(_mm_cmpgt_epi16(Folded, Belowa), _mm_cmplt_epi16(Folded, Abovez));
+        __m128i Matches = _mm_or_si128(_mm_or_si128(Digit, Letter), _mm_cmpeq_epi16(Chars, Underscore));
+
+        if (_mm_movemask_epi8(Matches) != 0xFFFF)
+        {
+            return SkipWithMask(Here, Matches);
+        }
+
+        Here += 8;
+    }
+#endif
+
+    return Here;
+}
+
+// Skip ASCII spaces and tabs.
+inline const WCHAR *
+SkipAsciiBlanks
+(
+    _In_ const WCHAR *Here,
+    _In_ const WCHAR *End
+)
+{
+#if SCANNER_SSE2
+    const __m128i Space = _mm_set1_epi16(' ');
+    const __m128i Tab = _mm_set1_epi16('\t');
+
+    while (End - Here >= 8)
+    {
+        __m128i Chars = _mm_loadu_si128((const __m128i *)Here);
+        __m128i Matches = _mm_or_si128(_mm_cmpeq_epi16(Chars, Space), _mm_cmpeq_epi16(Chars, Tab));
+
+        if (_mm_movemask_epi8(Matches) != 0xFFFF)
+        {
+            return SkipWithMask(Here, Matches);
+        }
+
+        Here += 8;
+    }
+#endif
+
+    return Here;
+}
+
+// Skip anything that is not a line break.  The test is exact (it checks
+// every code unit IsLineBreak accepts), so comment bodies with non-ASCII
+// text are still skipped in bulk.
+inline const WCHAR *
+SkipToLineBreak
+(
+    _In_ const WCHAR *Here,
+    _In_ const WCHAR *End
+)
+{
+#if SCANNER_SSE2
+    const __m128i CarriageReturn = _mm_set1_epi16(UCH_CR);
+    const __m128i LineFeed = _mm_set1_epi16(UCH_LF);
+    const __m128i NextLine = _mm_set1_epi16(0x0085);
+    const __m128i LineSeparator = _mm_set1_epi16(0x2028);
+    const __m128i ParagraphSeparator = _mm_set1_epi16(0x2029);
+
+    while (End - Here >= 8)
+    {
+        __m128i Chars = _mm_loadu_si128((const __m128i *)Here);
+        __m128i Breaks =
+            _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi16(Chars, CarriageReturn), _mm_cmpeq_epi16(Chars, LineFeed)),
+                _mm_or_si128(
+                    _mm_cmpeq_epi16(Chars, NextLine),
+                    _mm_or_si128(_mm_cmpeq_epi16(Chars, LineSeparator), _mm_cmpeq_epi16(Chars, ParagraphSeparator))));
+
+        if (_mm_movemask_epi8(Breaks) != 0)
+        {
+            return SkipWithMask(Here, _mm_cmpeq_epi16(Breaks, _mm_setzero_si128()));
+        }
+
+        Here += 8;
+    }
+#endif
+
+    return Here;
+}
+
 inline bool
 BeginsExponent
 (
@@ -969,7 +1111,7 @@ Scanner::EatWhitespace
     // running the loop.  Would have to check callers before making that change
     // though.
 
-    const WCHAR *Here = m_InputStreamPosition + 1;
+    const WCHAR *Here = SkipAsciiBlanks(m_InputStreamPosition + 1, m_InputStreamEnd);
 
     while (Here < m_InputStreamEnd && IsBlank(*Here)) {
 
@@ -1209,6 +1351,8 @@ void Scanner::ScanComment
 
     const WCHAR *CommentStart = Here;
 
+    Here = SkipToLineBreak(Here, m_InputStreamEnd);
+
     while (Here < m_InputStreamEnd) {
 
         WCHAR Next = *Here;
@@ -1279,6 +1423,8 @@ Scanner::ScanIdentifier
     // The C++ compiler refuses to inline IsIdentifierCharacter, so the
     // < 128 test is inline here. (This loop gets a *lot* of traffic.)
 
+    Here = SkipAsciiIdentifierCharacters(Here, m_InputStreamEnd);
+
     while (Here < m_InputStreamEnd &&
            (*Here < 128 ? IsIDChar[*Here] : IsWideIdentifierCharacter(*Here)))
     {
@@ -580,6 +580,10 @@ struct Token
 // and that m_DummyFirstField is the first field in struct Token.
 COMPILE_ASSERT(FIELD_OFFSET(struct Token, m_DummyFirstField) == 0);
 
+// The parser's lookahead walks the token ring constantly; keep a token within
+// one cache line so that each step touches a single line.
+COMPILE_ASSERT(sizeof(Token) <= 64);
+
 // Because of Xml Literals with expressions holes, the scanner is no longer a simple lexical scanner but a mini parser.  It must
 // be restartable for the colorizer, so a stack has been added to keep track of the possible nested states.
 
@@ -15,6 +15,7 @@ Text::Text() :
     m_cchText = 0;
     m_wszCurrent = NULL;
     m_iLineCurrent = 0;
+    m_initedIndexArray = false;
 
 #if DEBUG
     m_fFileOpen = false;
@@ -69,6 +70,8 @@ HRESULT Text::Init(SourceFile *pfile)
     m_iLineCurrent = 0;
     m_wszCurrent = NULL;
 #pragma prefast(pop)
+    m_IndexArray.Reset();
+    m_initedIndexArray = false;
 
 #if DEBUG && IDE
     m_fFileOpen = pfile->HasSourceFileView();
@@ -295,6 +298,16 @@ const WCHAR *Text::FindLine
     const WCHAR *wszLine, *wszEnd;
     long iLine;
 
+    // Lines that exist are looked up directly in the index array, so
+    // error reporting that asks for lines out of order does not rescan
+    // the file from the top each time.
+    EnsureIndexArrayInitialized();
+
+    if (iLineFind >= 0 && (ULONG)iLineFind < m_IndexArray.Count())
+    {
+        return m_wszText + m_IndexArray.Element((ULONG)iLineFind);
+    }
+
     // Find where to start from.
     if (m_iLineCurrent <= iLineFind && m_wszCurrent)
     {
@@ -344,6 +357,53 @@ const WCHAR *Text::FindLine
     return wszLine;
 }
 
+void
+Text::EnsureIndexArrayInitialized()
+{
+    if (m_initedIndexArray)
+    {
+        return;
+    }
+
+    if (IsLineBlank(m_wszText,m_cchText))
+    {
+        m_initedIndexArray = true;  // Text is immutable so this won't change, don't check again 
+        return;
+    }
+
+    InitIndexArray();
+}
+
+//Build index array to speed up getting code text by given line/column
+//or position
+void Text::InitIndexArray()
+{
+    if (m_wszText && m_cchText)
+    {
+        VSASSERT(!m_initedIndexArray, "already initialized");
+        m_initedIndexArray = true;
+        const WCHAR * wszText = m_wszText;
+        size_t iIndex = 0;
+        m_IndexArray.Add() = iIndex;
+
+        while (iIndex < m_cchText)
+        {
+            if (IsLineBreak(*wszText))
+            {
+                const WCHAR * wsz = LineBreakAdvance(wszText);
+                iIndex += (size_t)(wsz - wszText);
+                m_IndexArray.Add() = iIndex;
+                wszText = wsz;
+            }
+            else
+            {
+                wszText++;
+                iIndex++;
+            }
+        }
+    }
+}
+
 #if IDE 
 
 HRESULT 
@@ -489,36 +549,6 @@ HRESULT TextEx::GetLineLength(size_t iLine, size_t* piLength)
     return hr;
 }
 
-//Build index array to speed up getting code text by given line/column
-//or position
-void TextEx::InitIndexArray()
-{
-    if (m_wszText && m_cchText)
-    {
-        VSASSERT(!m_initedIndexArray, "already initialized");
-        m_initedIndexArray = true;
-        const WCHAR * wszText = m_wszText;
-        size_t iIndex = 0;
-        m_IndexArray.Add() = iIndex;
-
-        while (iIndex < m_cchText)
-        {
-            if (IsLineBreak(*wszText))
-            {
-                const WCHAR * wsz = LineBreakAdvance(wszText);
-                iIndex += (size_t)(wsz - wszText);
-                m_IndexArray.Add() = iIndex;
-                wszText = wsz;
-            }
-            else
-            {
-                wszText++;
-                iIndex++;
-            }
-        }
-    }
-}
-
 //Get code text based on our location.
 //
 // DoesLocationEncloseText = false
@@ -569,23 +599,6 @@ void TextEx::Reset()
 	m_maybeSnapshot.ClearValue();
 }
 
-void
-TextEx::EnsureIndexArrayInitialized()
-{
-    if (m_initedIndexArray)
-    {
-        return;
-    }
-
-    if (IsLineBlank(m_wszText,m_cchText))
-    {
-        m_initedIndexArray = true;  // Text is immutable so this won't change, don't check again 
-        return;
-    }
-
-    InitIndexArray();
-}
-
 bool VxUtil::TryConvertVsTextLinesToVxTextBuffer( _In_ IVsTextLines* pLines, _Out_ CComPtr<IVxTextBuffer>& spRet )
 {
     HRESULT hr = S_OK;
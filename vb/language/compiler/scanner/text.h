@@ -79,6 +79,8 @@ struct Text
 
     HRESULT GetTextLineRange(long iLineStart, long iLineEnd, _Out_ BSTR *pbstrTextRange);
 
+    void EnsureIndexArrayInitialized();
+
 #if IDE
 
     TriState<CComPtr<IVxTextSnapshot>> MaybeGetCachedSnapshot()
@@ -110,6 +112,11 @@ protected:
     const WCHAR *m_wszCurrent;
     long m_iLineCurrent;
 
+    // Offset of the start of each line, lazily initialized when needed.
+    void InitIndexArray();
+    bool m_initedIndexArray;
+    DynamicArray<size_t> m_IndexArray;
+
 #if DEBUG
     bool m_fFileOpen;
 #endif
@@ -135,7 +142,6 @@ struct TextEx : public Text
 {
     TextEx() : Text() {}
     TextEx( _In_ IVxTextSnapshot* pSnapshot);
-    void EnsureIndexArrayInitialized();
     virtual __override ~TextEx() { Reset(); }
     void InitForSnapshot( _In_ IVxTextSnapshot* pSnapshot );
     void InitForEmpty();
@@ -159,10 +165,6 @@ private:
     // Define an init method here with no implementation.  This will prevent the IDE from silently binding 
     // to the Text::Init method and make them choose a declarative init method
     void Init();
-
-    void InitIndexArray();
-    bool m_initedIndexArray;
-    DynamicArray<size_t> m_IndexArray;  // this is lazily initialized when needed
 };
 
 
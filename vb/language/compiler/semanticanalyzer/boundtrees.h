@@ -395,6 +395,8 @@ struct LABEL_ENTRY_BIL
 
   #define SBF_SELECT_HAS_CASE_ELSE    0x2000    // SL_SELECT as tableswitch
   #define SBF_SELECT_TABLE            0x1000    // SL_SELECT as tableswitch
+  #define SBF_SELECT_STRING_DISPATCH  0x4000    // SL_SELECT on String dispatched by length (set by codegen)
+  #define SBF_SELECT_CLUSTERED        0x8000    // SL_SELECT as binary search over tableswitch clusters
 
   #define SBF_CASE_CONDITION          0x2000
   #define SBF_CASE_ISELSE             0x1000    // CASE
@@ -857,6 +859,10 @@ namespace ILTree
 	    SWITCH_TABLE    * SwitchTable;        // table switch
 	    __int64           Minimum;
 	    __int64           Maximum;
+	    struct CASE_INTERVAL * Intervals;     // clustered table switch (SBF_SELECT_CLUSTERED)
+	    struct CASE_CLUSTER  * Clusters;
+	    unsigned          IntervalCount;
+	    unsigned          ClusterCount;
     
         SymbolReferenceExpression *LiftedSelectorTemporary;  // If used in a resumable method, we have to lift the temporaries
 	};
@@ -877,6 +883,24 @@ namespace ILTree
 	};
 
 
+	//*****************************************************************************
+	// For clustered Select Case switch tables: the disjoint constant ranges of
+	// all the cases in ascending order, split into runs that share one table
+	//*****************************************************************************
+	struct CASE_INTERVAL
+	{
+	    __int64          Low;
+	    __int64          High;
+	    unsigned         CaseIndex;     // ordinal of the owning Case within the Select
+	};
+
+	struct CASE_CLUSTER
+	{
+	    unsigned         FirstInterval;
+	    unsigned         IntervalCount; // 1 means a plain range test, more means a SWITCH table
+	};
+
+
 	// Use AsIfCaseBlock() accessor.
 	  // AsIfCaseBlock - If and Case statements
 	struct IfCaseBlock : ExecutableBlock
@@ -1714,7 +1714,7 @@ BlockData* ClosureRoot::PopBlock()
 ILTree::ExecutableBlock *ClosureRoot::GetCurrentBlock() const
 {
     EnsureInState(CRState_Iterating);
-    ConstIterator<BlockData*> it = m_blockStack.GetConstIterator();
+    ArrayListReverseConstIterator<BlockData*,NorlsAllocWrapper> it = m_blockStack.GetConstIterator();
     while ( it.MoveNext() )
     {
         if ( it.Current()->GetBlock() )
@@ -1734,7 +1734,7 @@ Procedure *ClosureRoot::GetCurrentReferencingProcedure() const
     {
         // Walk the frame stack backwards until we find the first
         // Lambda and return its procedure
-        ConstIterator<ClosureFrame*> it = m_frameStack.GetConstIterator();
+        ArrayListReverseConstIterator<ClosureFrame*,NorlsAllocWrapper> it = m_frameStack.GetConstIterator();
         while ( it.MoveNext() )
         {
             ClosureFrame *cur = it.Current();
@@ -1901,7 +1901,7 @@ void ClosureRoot::LiftVariable(Variable *var, ILTree::SymbolReferenceExpression
     ThrowIfNull(lambdaData);
 
     // Find the current real lambda we are in and update it's variable use
-    Iterator<ClosureFrame*> frameIt = m_frameStack.GetIterator();
+    ArrayListReverseIterator<ClosureFrame*,NorlsAllocWrapper> frameIt = m_frameStack.GetIterator();
     while ( frameIt.MoveNext() )
     {
         ClosureFrame *cur = frameIt.Current();
@@ -1998,7 +1998,7 @@ void ClosureRoot::LiftVariable(Variable *var, ILTree::SymbolReferenceExpression
         Declaration *parent = var->GetImmediateParent();
         if ( parent )
         {
-            Iterator<BlockData*> it = m_blockStack.GetIterator();
+            ArrayListReverseIterator<BlockData*,NorlsAllocWrapper> it = m_blockStack.GetIterator();
             LocalScopeInjection * injection = m_LocalScopesToInject;  // #576786
             while ( it.MoveNext() )
             {
@@ -2192,7 +2192,7 @@ void ClosureRoot::AddVariableFlag(Variable *var, VariableFlags flag)
 
 void ClosureRoot::FixupExpressionTrees()
 {
-    Iterator<TrackedExpression*> it = m_trackedList.GetIterator();
+    ListValueIterator<TrackedExpression*,NorlsAllocWrapper> it = m_trackedList.GetIterator();
     while (it.MoveNext())
     {
         TrackedExpression *cur = it.Current();
@@ -2289,7 +2289,7 @@ bool ClosureRoot::IsLocalOrParamFromOutsideFrame(Variable* var)
     // Walk the block stack until we
     //  1) Hit the boundary block in which case it's outside the frame
     //  2) Find the owner of the variable
-    Iterator<BlockData*> it = m_blockStack.GetIterator();
+    ArrayListReverseIterator<BlockData*,NorlsAllocWrapper> it = m_blockStack.GetIterator();
     LocalScopeInjection * injection = m_LocalScopesToInject;
     while (it.MoveNext() )
     {
@@ -2536,7 +2536,7 @@ void ClosureRoot::FixupEmptyBlocks()
         // You may be thinking we could associate statements with TrackedExpression instances
         // instead of Block.  It's not possible because that would cause us to loose all
         // context for nested lambdas and break scenario #1.
-        Iterator<TrackedExpression*> listIt = m_trackedList.GetIterator();
+        ListValueIterator<TrackedExpression*,NorlsAllocWrapper> listIt = m_trackedList.GetIterator();
         while ( listIt.MoveNext())
         {
             TrackedExpression *cur = listIt.Current();
@@ -2588,7 +2588,7 @@ void ClosureRoot::FixupMyBaseMyClassCalls(_In_opt_ List<ILTree::Expression*, Nor
     ChangeState(CRState_MyBaseMyClassFixup);
 
     // Iterate over the MyBase/MyClass calls and generate the appropriate stubs
-    Iterator<ILTree::Expression*> it = fixupThese->GetIterator();
+    ListValueIterator<ILTree::Expression*,NorlsAllocWrapper> it = fixupThese->GetIterator();
     while ( it.MoveNext() )
     {
         ILTree::Expression *cur = it.Current();
@@ -2803,7 +2803,7 @@ void ClosureRoot::FixupClosureTreeStructure()
     // in the file so that the tree will be processed in the same order
     // every time
     ChangeState(CRState_ClosureTreeBuilding);
-    ConstIterator<KeyValuePair<ILTree::ExecutableBlock*,Closure*> > mapIt = m_map.GetConstIterator();
+    HashTableConstIterator<ILTree::ExecutableBlock*,Closure*,NorlsAllocWrapper> mapIt = m_map.GetConstIterator();
     ArrayList<Closure*,NorlsAllocWrapper> sortedList(m_alloc);
     while (mapIt.MoveNext())
     {
@@ -2812,7 +2812,7 @@ void ClosureRoot::FixupClosureTreeStructure()
 
     ClosureLocationComparer comp;
     sortedList.Sort(comp);
-    Iterator<Closure*> it = sortedList.GetIterator();
+    ArrayListIterator<Closure*,NorlsAllocWrapper> it = sortedList.GetIterator();
     while ( it.MoveNext() )
     {
         Closure *current = it.Current();
@@ -2986,7 +2986,7 @@ ILTree::Statement *ClosureRoot::FindOwningStatementOfShortLivedTemporary(Filo<IL
     ThrowIfFalse(var->GetTemporaryInfo()->Lifetime == LifetimeShortLived);
     ThrowIfFalse(statementStack.Count() > 0);
 
-    ConstIterator<ILTree::Statement*> it = statementStack.GetConstIterator();
+    ArrayListReverseConstIterator<ILTree::Statement*,NorlsAllocWrapper> it = statementStack.GetConstIterator();
     while (it.MoveNext())
     {
         ILTree::Statement *candidateStatement = it.Current();
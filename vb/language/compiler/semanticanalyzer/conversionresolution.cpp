@@ -288,6 +288,36 @@ Semantics::ClassifyConversion
             *pConversionRequiresUnliftedAccessToNullableValue = false;
         }
 
+        // Collecting and resolving the conversion operators walks both base
+        // class chains, so remember the outcome for pairs of declared types.
+        // Bindings and other constructed types are not cached because they
+        // are allocated per use and their addresses are not stable keys.
+        bool CacheConversion =
+            m_ConversionCache &&
+            IsCacheableConversionType(SourceType) &&
+            IsCacheableConversionType(TargetType);
+        unsigned CacheFlags =
+            considerConversionsOnNullableBool ? ConversionCache::ConsiderConversionsOnNullableBool : 0;
+
+        if (CacheConversion)
+        {
+            int CachedResult;
+
+            if (m_ConversionCache->LookupInCache(
+                    TargetType,
+                    SourceType,
+                    CacheFlags,
+                    &CachedResult,
+                    &OperatorMethod,
+                    pConversionRequiresUnliftedAccessToNullableValue))
+            {
+                OperatorMethodGenericContext = NULL;
+                return (ConversionClass)CachedResult;
+            }
+        }
+
+        bool RequiresUnliftedAccessToNullableValue = false;
+
         Result =
             ClassifyUserDefinedConversion
             (
@@ -297,13 +327,47 @@ Semantics::ClassifyConversion
                 OperatorMethodGenericContext,
                 &OperatorMethodIsLifted,
                 considerConversionsOnNullableBool,
-                pConversionRequiresUnliftedAccessToNullableValue
+                &RequiresUnliftedAccessToNullableValue
             );
+
+        if (pConversionRequiresUnliftedAccessToNullableValue)
+        {
+            *pConversionRequiresUnliftedAccessToNullableValue = RequiresUnliftedAccessToNullableValue;
+        }
+
+        if (CacheConversion && !OperatorMethodGenericContext && !OperatorMethodIsLifted)
+        {
+            m_ConversionCache->AddEntry(
+                TargetType,
+                SourceType,
+                CacheFlags,
+                Result,
+                Result != ConversionError ? OperatorMethod : NULL,
+                RequiresUnliftedAccessToNullableValue);
+        }
     }
 
     return Result;
 }
 
+/*=======================================================================================
+IsCacheableConversionType
+
+Whether a type can be used as a key into the conversion cache: declared classes,
+structures and type parameters live as long as the cache does, constructed types do not.
+=======================================================================================*/
+bool
+Semantics::IsCacheableConversionType
+(
+    Type *pType
+)
+{
+    return
+        pType &&
+        !pType->IsGenericBinding() &&
+        (pType->IsContainer() || pType->IsGenericParam());
+}
+
 
 /*=======================================================================================
 ClassifyCLRReferenceConversion
@@ -3240,50 +3240,19 @@ DWORD_PTR __fastcall BITSET::testBitsLarge(unsigned start, unsigned size)
 
 }
 
-static const unsigned bitsPerNibble[] =
-{
-    0,          // 0000
-    1,          // 0001
-    1,          // 0010
-    2,          // 0011
-    1,          // 0100
-    2,          // 0101
-    2,          // 0110
-    3,          // 0111
-    1,          // 1000
-    2,          // 1001
-    2,          // 1010
-    3,          // 1011
-    2,          // 1100
-    3,          // 1101
-    3,          // 1110
-    4,          // 1111
-};
-
 unsigned __fastcall BITSET::numberSet(DWORD_PTR dw)
 {
-#define NUM_BITS(val) (bitsPerNibble[((val) & 0xF)])
-#if defined(_M_IX86)
-    // 8 Nibbles in a DWORD_PTR
-    return NUM_BITS(dw      ) + NUM_BITS(dw >> 4 ) + NUM_BITS(dw >> 8 ) + NUM_BITS(dw >> 12)
-         + NUM_BITS(dw >> 16) + NUM_BITS(dw >> 20) + NUM_BITS(dw >> 24) + NUM_BITS(dw >> 28);
-
-#elif defined(_WIN64)
-    // 16 Nibbles in a DWORD_PTR
-    return NUM_BITS(dw      ) + NUM_BITS(dw >> 4 ) + NUM_BITS(dw >> 8 ) + NUM_BITS(dw >> 12)
-         + NUM_BITS(dw >> 16) + NUM_BITS(dw >> 20) + NUM_BITS(dw >> 24) + NUM_BITS(dw >> 28)
-         + NUM_BITS(dw >> 32) + NUM_BITS(dw >> 36) + NUM_BITS(dw >> 40) + NUM_BITS(dw >> 44)
-         + NUM_BITS(dw >> 48) + NUM_BITS(dw >> 52) + NUM_BITS(dw >> 56) + NUM_BITS(dw >> 60);
-
-#else
-    unsigned count = 0;
-    for ( ; dw; dw >>= 4) {
-        count += NUM_BITS(dw);
-    }
-    return count;
+    // Count the bits a word at a time: sum adjacent pairs, then nibbles,
+    // then fold the per-byte counts together with one multiply.
+    const DWORD_PTR m1 = ((DWORD_PTR)-1) / 3;           // 0x5555...
+    const DWORD_PTR m2 = ((DWORD_PTR)-1) / 15 * 3;      // 0x3333...
+    const DWORD_PTR m4 = ((DWORD_PTR)-1) / 255 * 15;    // 0x0f0f...
+    const DWORD_PTR h01 = ((DWORD_PTR)-1) / 255;        // 0x0101...
 
-#endif
-#undef NUM_BITS
+    dw = dw - ((dw >> 1) & m1);
+    dw = (dw & m2) + ((dw >> 2) & m2);
+    dw = (dw + (dw >> 4)) & m4;
+    return (unsigned) ((dw * h01) >> (MAX_SIZE - 8));
 }
 
 unsigned __fastcall BITSET::numberSet()
@@ -3577,11 +3546,18 @@ BITSET * __fastcall BITSET::setIntoLarge(BITSET * source, NorlsAllocator * alloc
     }
 
     BITSETIMP * bitset = (BITSETIMP*)source;
-    size_t size = bitset->arrayEnd - bitset->bitArray; // this is size in DWORD_PTRS
     BITSETIMP * rval = (BITSETIMP*) this;
-    *changed = memcmp(bitset->bitArray, rval->bitArray, size * sizeof(DWORD_PTR));
-    memcpy(rval->bitArray, bitset->bitArray , size * sizeof(DWORD_PTR));
-    rval->arrayEnd = rval->bitArray + size;
+    DWORD_PTR * sourceDword = bitset->bitArray;
+    DWORD_PTR * thisDword = rval->bitArray;
+
+    // Compare and copy in one pass rather than a memcmp followed by a memcpy.
+    DWORD_PTR differs = 0;
+    while (sourceDword != bitset->arrayEnd) {
+        differs |= *thisDword ^ *sourceDword;
+        *(thisDword++) = *(sourceDword++);
+    }
+    *changed = (differs != 0);
+    rval->arrayEnd = thisDword;
     return (BITSET*) rval;
 }
 
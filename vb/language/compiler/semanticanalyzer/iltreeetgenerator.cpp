@@ -440,10 +440,7 @@ ILTree::Expression* ILTreeETGenerator::CreateMemberInitExpr
             ThrowIfNull(BindMethodName);
 
             ParseTree::Expression *MemberAssignment = m_PH.CreateMethodCall(
-                m_PH.CreateExpressionTreeNameExpression(
-                    m_Compiler,
-                    BindMethodName
-                    ),
+                CreateFactoryMethodNameExpression(BindMethodName),
                 BindMethodArgs
                 );
 
@@ -1706,10 +1703,10 @@ ILTree::Expression* ILTreeETGenerator::GenerateExpressionTreeCall
     ParseTree::Expression *ExpressionTree = m_PH.CreateMethodCall(
         TypeArgs ?
             m_PH.CreateGenericQualifiedExpression(
-                m_PH.CreateExpressionTreeNameExpression(m_Compiler, MethodName),
+                CreateFactoryMethodNameExpression(MethodName),
                 TypeArgs
                 ) :
-            m_PH.CreateExpressionTreeNameExpression(m_Compiler, MethodName),
+            CreateFactoryMethodNameExpression(MethodName),
         Arguments
         );
 
@@ -1724,6 +1721,33 @@ ILTree::Expression* ILTreeETGenerator::GenerateExpressionTreeCall
     return Result;
 }
 
+// ----------------------------------------------------------------------------
+// The factory methods are called once per converted node, so qualifying them
+// by name means looking up System, Linq, Expressions and Expression from the
+// global namespace every time. Refer to the Expression class through its
+// FX symbol instead and leave only the method name to be bound. If the FX
+// type is not usable, e.g. it was imported from more than one project, fall
+// back to the fully qualified name so that the usual errors are reported.
+// ----------------------------------------------------------------------------
+
+ParseTree::Expression* ILTreeETGenerator::CreateFactoryMethodNameExpression
+(
+    _In_z_ STRING* MethodName
+)
+{
+    ThrowIfNull( MethodName );
+
+    if (GetFXSymbolProvider()->IsTypeAvailable(FX::ExpressionType))
+    {
+        return m_PH.CreateQualifiedExpression(
+            m_PH.CreateBoundSymbol(GetFXSymbolProvider()->GetExpressionType()),
+            m_PH.CreateNameExpression(MethodName)
+            );
+    }
+
+    return m_PH.CreateExpressionTreeNameExpression(m_Compiler, MethodName);
+}
+
 ILTree::Expression* ILTreeETGenerator::AllocateSymbolReference
 (
     Declaration *Symbol,
@@ -421,6 +421,16 @@ private:
         ParseTree::TypeList* TypeArgs = NULL
     );
 
+    // ----------------------------------------------------------------------------
+    // Build the name of an expression tree factory method, qualified by the
+    // already bound System.Linq.Expressions.Expression class when possible.
+    // ----------------------------------------------------------------------------
+
+    ParseTree::Expression* CreateFactoryMethodNameExpression
+    (
+        _In_z_ STRING* MethodName
+    );
+
     ILTree::Expression* AllocateSymbolReference
     (
         Declaration *Symbol,
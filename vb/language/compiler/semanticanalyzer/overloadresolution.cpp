@@ -1110,6 +1110,16 @@ Semantics::CollectOverloadCandidates
     RejectedForTypeArgumentCount = 0;
     RejectedForArgumentCount = 0;
 
+    unsigned ArgumentCountToUseForComparison = (OvrldFlags & OvrldSomeCandidatesAreExtensionMethods) ? ArgumentCount  - 1: ArgumentCount;
+
+#if DEBUG
+    STRING *OverloadedProcedureName = OverloadedProcedure->GetName();
+    unsigned ProceduresConsidered = 0;
+    unsigned ProceduresRejectedByShape = 0;
+    unsigned AccessChecksSkipped = 0;
+    unsigned CandidateCountOnEntry = CandidateCount;
+#endif
+
     do
     {
         GenericBinding *CandidateGenericBinding = NULL;
@@ -1167,49 +1177,70 @@ Semantics::CollectOverloadCandidates
             }
 #endif
 
-            // ---- out inaccessible procedures.
+#if DEBUG
+            ProceduresConsidered++;
+#endif
 
-            if (!IsAccessible(
-                    NextProcedure,
-                    NULL,   // Accessing through base, don't need a binding context
-                    AccessingInstanceType))
-            {
-                continue;
-            }
+            // Work out from the shape of the procedure alone (its type parameter count,
+            // parameter counts and paramarray) whether it can possibly accept the call,
+            // before doing the comparatively expensive accessibility check.
 
-            // If type arguments have been supplied, ---- out procedures that don't have an
-            // appropriate number of type parameters.
+            unsigned RequiredParameterCount = 0;
+            unsigned MaximumParameterCount = 0;
+            bool HasParamArray = false;
+            unsigned *ShapeRejectionCount = NULL;
 
             if (TypeArgumentCount > 0 &&
                 TypeArgumentCount != NextProcedure->GetGenericParamCount())
             {
-                RejectedForTypeArgumentCount++;
-                continue;
+                // Type arguments have been supplied and the procedure doesn't have an
+                // appropriate number of type parameters.
+                ShapeRejectionCount = &RejectedForTypeArgumentCount;
             }
+            else
+            {
+                NonAliasProcedure->GetAllParameterCounts(RequiredParameterCount, MaximumParameterCount, HasParamArray);
 
-            // ---- out procedures that cannot accept the number of supplied arguments.
+                // The procedure cannot accept the number of supplied arguments.
+                if (ArgumentCountToUseForComparison < RequiredParameterCount ||
+                    (ArgumentCountToUseForComparison > MaximumParameterCount && !HasParamArray) ||
+                    (HasFlag(OvrldFlags, OvrldExactArgCount) && ArgumentCountToUseForComparison < MaximumParameterCount) ||
+                    (HasFlag(OvrldFlags, OvrldIgnoreParamArray) && ArgumentCountToUseForComparison > MaximumParameterCount))
+                {
+                    ShapeRejectionCount = &RejectedForArgumentCount;
+                }
+            }
 
-            unsigned RequiredParameterCount = 0;
-            unsigned MaximumParameterCount = 0;
-            bool HasParamArray = false;
+            // Only accessible procedures count as rejected, but callers only ever test
+            // the rejection counts against zero. Once the count is nonzero, another
+            // procedure of the wrong shape can be dropped without asking whether it is
+            // accessible; for heavily overloaded names that is most of them.
 
-            NonAliasProcedure->GetAllParameterCounts(RequiredParameterCount, MaximumParameterCount, HasParamArray);
+            if (ShapeRejectionCount && *ShapeRejectionCount > 0)
+            {
+#if DEBUG
+                ProceduresRejectedByShape++;
+                AccessChecksSkipped++;
+#endif
+                continue;
+            }
 
-            unsigned ArgumentCountToUseForComparison = (OvrldFlags & OvrldSomeCandidatesAreExtensionMethods) ? ArgumentCount  - 1: ArgumentCount;
+            // ---- out inaccessible procedures.
 
-            if (ArgumentCountToUseForComparison < RequiredParameterCount ||
-                (ArgumentCountToUseForComparison > MaximumParameterCount && !HasParamArray))
+            if (!IsAccessible(
+                    NextProcedure,
+                    NULL,   // Accessing through base, don't need a binding context
+                    AccessingInstanceType))
             {
-                RejectedForArgumentCount++;
                 continue;
             }
 
-            if(
-                (HasFlag(OvrldFlags, OvrldExactArgCount) && ArgumentCountToUseForComparison < MaximumParameterCount) ||
-                (HasFlag(OvrldFlags, OvrldIgnoreParamArray) && ArgumentCountToUseForComparison > MaximumParameterCount)
-               )
+            if (ShapeRejectionCount)
             {
-                RejectedForArgumentCount++;
+#if DEBUG
+                ProceduresRejectedByShape++;
+#endif
+                (*ShapeRejectionCount)++;
                 continue;
             }
 
@@ -1321,6 +1352,13 @@ Semantics::CollectOverloadCandidates
         RestoreOriginalArguments(SavedArguments, Arguments);
     }
 
+    DBG_SWITCH_PRINTF(fDumpOverload, L"Collected overload candidates for %s: %u procedures considered, %u rejected by shape (%u without an access check), %u candidates added\n",
+        OverloadedProcedureName,
+        ProceduresConsidered,
+        ProceduresRejectedByShape,
+        AccessChecksSkipped,
+        CandidateCount - CandidateCountOnEntry);
+
     return Candidates;
 }
 
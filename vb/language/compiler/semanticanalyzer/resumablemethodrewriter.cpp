@@ -3565,12 +3565,17 @@ Semantics::LowerResumableMethod(_In_opt_ ILTree::ProcedureBlock *BoundBody)
 
             // If the initial code contained any calls to MyBase.f(), or MyClass.f(),
             // then they have to be redirected through a stub. (Incidentally lambda closures
-            // have to do the same thing). Anyway, we fix this first:
-            ClosureRoot croot(BoundBody->pproc, BoundBody, this, m_TransientSymbolCreator);
+            // have to do the same thing). Anyway, we fix this first. Most resumable
+            // methods have no such calls, so only set up a ClosureRoot (and its
+            // allocator and maps) when the walk actually found some.
             List<ILTree::Expression*, NorlsAllocWrapper> mybase_fixups(m_TransientSymbolCreator.GetNorlsAllocator());
             FindMyBaseMyClass finder(&mybase_fixups);
             finder.Visit(BoundBody);
-            croot.FixupMyBaseMyClassCalls(&mybase_fixups);
+            if (mybase_fixups.Count() > 0)
+            {
+                ClosureRoot croot(BoundBody->pproc, BoundBody, this, m_TransientSymbolCreator);
+                croot.FixupMyBaseMyClassCalls(&mybase_fixups);
+            }
 
             // Now we can create the state-machine class, including a rewritten "MoveNextBody"
             ResumableMethodLowerer lowerer(this, BoundBody);
@@ -2838,6 +2838,11 @@ Semantics::InitializeInterpretationState
             {
                 m_LiftedOperatorCache = m_Project->GetLiftedOperatorCache();
             }
+
+            if (!m_ConversionCache)
+            {
+                m_ConversionCache = m_Project->GetConversionCache();
+            }
         }
 
         if (GetCompilerHost() && !m_MergedNamespaceCache)
@@ -3602,6 +3607,7 @@ Semantics::Semantics
     m_statementGroupId(1),
     m_ExtensionMethodLookupCache(NULL),
     m_LiftedOperatorCache(NULL),
+    m_ConversionCache(NULL),
     m_InterpretingMethodBody(false),
     m_XmlNameVars(NULL),
     m_AnonymousTypeBindingTable(NULL),
@@ -3663,6 +3669,7 @@ Semantics::Semantics
             m_LookupCache = m_SourceFile->GetProject()->GetLookupCache();
             m_ExtensionMethodLookupCache = m_SourceFile->GetProject()->GetExtensionMethodLookupCache();
             m_LiftedOperatorCache = m_SourceFile->GetProject()->GetLiftedOperatorCache();
+            m_ConversionCache = m_SourceFile->GetProject()->GetConversionCache();
         }
 
         if (GetCompilerHost())
@@ -3725,6 +3732,7 @@ Semantics::SetIDECompilationCaches(CompilationCaches *pCompilationCaches)
         m_LookupCache = pCompilationCaches->GetLookupCache();
         m_ExtensionMethodLookupCache = pCompilationCaches->GetExtensionMethodLookupCache();
         m_LiftedOperatorCache = pCompilationCaches->GetLiftedOperatorCache();
+        m_ConversionCache = pCompilationCaches->GetConversionCache();
         m_MergedNamespaceCache = pCompilationCaches->GetMergedNamespaceCache();
 
         m_CompilationCaches = pCompilationCaches;
@@ -4209,6 +4209,15 @@ protected:
         _Out_ ILTree::SelectBlock *Select
     );
 
+    bool
+    RecommendClusteredSwitchTable
+    (
+        _Out_ ILTree::SelectBlock *Select,
+        bool IsUnsigned,
+        unsigned IfBlockCount,
+        unsigned IfRangeBlockCount
+    );
+
     void
     OptimizeSelectStatement
     (
@@ -8446,6 +8455,12 @@ protected:
         DelegateRelaxationLevel *pConversionRelaxationLevel = NULL,  // [out] If converting a VB$AnonymousDelegate to a delegate type, how did it relax?
         bool IgnoreOperatorMethod = false
     );
+
+    static bool
+    IsCacheableConversionType
+    (
+        Type *pType
+    );
     
     ConversionClass
     ClassifyPredefinedCLRConversion
@@ -10783,9 +10798,10 @@ protected:
     // A mechanism to build the call graph for the given method.
     CallGraph *m_CallGraph;
 
-    LookupTree *m_LookupCache;
+    LookupCache *m_LookupCache;
     ExtensionMethodNameLookupCache * m_ExtensionMethodLookupCache;
     LiftedUserDefinedOperatorCache * m_LiftedOperatorCache;
+    ConversionCache * m_ConversionCache;
     NamespaceRingTree *m_MergedNamespaceCache;
     bool m_DoNotMergeNamespaceCaches;
     CompilationCaches *m_CompilationCaches;
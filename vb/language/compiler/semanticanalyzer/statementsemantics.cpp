@@ -3246,6 +3246,12 @@ Semantics::InterpretCaseStatement
     }
 }
 
+// Sizes used to weigh a SWITCH table against an IF list.  See RecommendSwitchTable.
+static unsigned const IF_BLOCK_SIZE = 15;   // ld+param, ld+param, br+addr
+static unsigned const IF_RANGE_BLOCK_SIZE = 30;   // 2 * if block size
+static unsigned const SWITCH_HEADER_SIZE = 29;   // ld+param, ld+param, sub, switch+ui4
+static unsigned const SWITCH_ELEMENT_SIZE = 4;    // addr
+
 bool
 Semantics::RecommendSwitchTable
 (
@@ -3377,11 +3383,6 @@ Semantics::RecommendSwitchTable
     // 
 
 
-    unsigned const IF_BLOCK_SIZE = 15;   // ld+param, ld+param, br+addr
-    unsigned const IF_RANGE_BLOCK_SIZE = 30;   // 2 * if block size
-    unsigned const SWITCH_HEADER_SIZE = 29;   // ld+param, ld+param, sub, switch+ui4
-    unsigned const SWITCH_ELEMENT_SIZE = 4;    // addr
-
     VSASSERT((IsUnsigned && (unsigned __int64)Maximum >= (unsigned __int64)Minimum) ||
              (!IsUnsigned && Maximum >= Minimum),
              "PreprocessSelect: Max and Min invalid");
@@ -3403,7 +3404,10 @@ Semantics::RecommendSwitchTable
          (CountOfEntries > INT_MAX))
     {
         ClearFlag32(Select, SBF_SELECT_TABLE);
-        return false;
+
+        // The values are too sparse for one table, but they may still fall
+        // into a handful of dense clusters.
+        return RecommendClusteredSwitchTable(Select, IsUnsigned, IfBlockCount, IfRangeBlockCount);
     }
 
     Select->Minimum = Minimum;
@@ -3413,6 +3417,194 @@ Semantics::RecommendSwitchTable
     return true;
 }
 
+static int _cdecl
+SortCaseIntervalsSigned
+(
+    const void *arg1,
+    const void *arg2
+)
+{
+    Quadword Low1 = ((const ILTree::CASE_INTERVAL *)arg1)->Low;
+    Quadword Low2 = ((const ILTree::CASE_INTERVAL *)arg2)->Low;
+
+    return Low1 < Low2 ? -1 : (Low1 > Low2 ? 1 : 0);
+}
+
+static int _cdecl
+SortCaseIntervalsUnsigned
+(
+    const void *arg1,
+    const void *arg2
+)
+{
+    unsigned __int64 Low1 = (unsigned __int64)((const ILTree::CASE_INTERVAL *)arg1)->Low;
+    unsigned __int64 Low2 = (unsigned __int64)((const ILTree::CASE_INTERVAL *)arg2)->Low;
+
+    return Low1 < Low2 ? -1 : (Low1 > Low2 ? 1 : 0);
+}
+
+// Called when the Case constants are too sparse for a single SWITCH table.
+// Sorts the constants into disjoint ranges and splits those into runs that
+// are each dense enough for their own table (by the same size heuristic as
+// RecommendSwitchTable).  Codegen then binary searches the selector across
+// the runs, so dispatch costs O(log n) compares plus one SWITCH instead of
+// one compare per Case.  Returns false, leaving an IF list, if cases overlap
+// or the clustered code isn't within twice the size of the IF list.
+
+bool
+Semantics::RecommendClusteredSwitchTable
+(
+    _Out_ ILTree::SelectBlock *Select,
+    bool IsUnsigned,
+    unsigned IfBlockCount,
+    unsigned IfRangeBlockCount
+)
+{
+    // Below this many clauses the IF list is about as fast as a search
+    unsigned const MIN_CLUSTERED_CLAUSES = 8;
+
+    unsigned IntervalCount = IfBlockCount + IfRangeBlockCount;
+
+    if (IntervalCount < MIN_CLUSTERED_CLAUSES)
+    {
+        return false;
+    }
+
+    ILTree::CASE_INTERVAL *Intervals =
+        (ILTree::CASE_INTERVAL *)m_TreeStorage.Alloc(VBMath::Multiply(IntervalCount, sizeof(ILTree::CASE_INTERVAL)));
+
+    unsigned IntervalIndex = 0;
+    unsigned CaseIndex = 0;
+    ILTree::Statement *CurrentStatement = Select->Child;
+
+    while (CurrentStatement &&
+           CurrentStatement->bilop == SB_CASE &&
+           !HasFlag32(CurrentStatement, SBF_CASE_ISELSE))
+    {
+        ILTree::CASELIST *CurrentCaseClause = CurrentStatement->AsCaseBlock().BoundCaseList;
+
+        while (CurrentCaseClause)
+        {
+            VSASSERT(IntervalIndex < IntervalCount, "RecommendClusteredSwitchTable: clause count out of sync");
+
+            Intervals[IntervalIndex].Low = CurrentCaseClause->LowBound->AsIntegralConstantExpression().Value;
+            Intervals[IntervalIndex].High =
+                CurrentCaseClause->IsRange ?
+                    CurrentCaseClause->HighBound->AsIntegralConstantExpression().Value :
+                    Intervals[IntervalIndex].Low;
+            Intervals[IntervalIndex].CaseIndex = CaseIndex;
+            IntervalIndex++;
+
+            CurrentCaseClause = CurrentCaseClause->Next;
+        }
+
+        CaseIndex++;
+        CurrentStatement = CurrentStatement->Next;
+    }
+
+    qsort(Intervals, IntervalCount, sizeof(ILTree::CASE_INTERVAL), IsUnsigned ? SortCaseIntervalsUnsigned : SortCaseIntervalsSigned);
+
+    // Coalesce overlapping and touching ranges of the same Case.  A value shared
+    // by two different Cases has to be resolved by source order, so give up on those.
+    //
+    unsigned Last = 0;
+
+    for (IntervalIndex = 1; IntervalIndex < IntervalCount; IntervalIndex++)
+    {
+        ILTree::CASE_INTERVAL *Previous = &Intervals[Last];
+        ILTree::CASE_INTERVAL *Current = &Intervals[IntervalIndex];
+
+        bool Overlaps =
+            IsUnsigned ?
+                (unsigned __int64)Current->Low <= (unsigned __int64)Previous->High :
+                Current->Low <= Previous->High;
+
+        if (Overlaps || (Current->Low == Previous->High + 1 && Current->CaseIndex == Previous->CaseIndex))
+        {
+            if (Current->CaseIndex != Previous->CaseIndex)
+            {
+                return false;
+            }
+
+            if ((IsUnsigned && (unsigned __int64)Current->High > (unsigned __int64)Previous->High) ||
+                (!IsUnsigned && Current->High > Previous->High))
+            {
+                Previous->High = Current->High;
+            }
+        }
+        else
+        {
+            Intervals[++Last] = *Current;
+        }
+    }
+
+    IntervalCount = Last + 1;
+
+    // Greedily grow each cluster while it stays cheaper as a table than as an IF list.
+    //
+    ILTree::CASE_CLUSTER *Clusters =
+        (ILTree::CASE_CLUSTER *)m_TreeStorage.Alloc(VBMath::Multiply(IntervalCount, sizeof(ILTree::CASE_CLUSTER)));
+    unsigned ClusterCount = 0;
+    unsigned __int64 ClusteredSize = 0;
+
+    for (IntervalIndex = 0; IntervalIndex < IntervalCount; )
+    {
+        unsigned First = IntervalIndex;
+        unsigned __int64 ClusterIfSize = 0;
+        unsigned __int64 TableEntries = 0;
+
+        do
+        {
+            unsigned __int64 IfSize =
+                ClusterIfSize +
+                (Intervals[IntervalIndex].Low == Intervals[IntervalIndex].High ? IF_BLOCK_SIZE : IF_RANGE_BLOCK_SIZE);
+
+            // Wraps to 0 when the range covers all 64-bit values
+            unsigned __int64 Entries = (unsigned __int64)(Intervals[IntervalIndex].High - Intervals[First].Low) + 1;
+
+            if (IntervalIndex > First &&
+                (Entries == 0 ||
+                 Entries > INT_MAX ||
+                 SWITCH_HEADER_SIZE + SWITCH_ELEMENT_SIZE * Entries > 2 * IfSize))
+            {
+                break;
+            }
+
+            ClusterIfSize = IfSize;
+            TableEntries = Entries;
+            IntervalIndex++;
+        }
+        while (IntervalIndex < IntervalCount);
+
+        Clusters[ClusterCount].FirstInterval = First;
+        Clusters[ClusterCount].IntervalCount = IntervalIndex - First;
+
+        ClusteredSize +=
+            Clusters[ClusterCount].IntervalCount == 1 ?
+                ClusterIfSize :
+                SWITCH_HEADER_SIZE + SWITCH_ELEMENT_SIZE * TableEntries;
+
+        ClusterCount++;
+    }
+
+    // Each cluster after the first costs one more compare in the search
+    ClusteredSize += IF_BLOCK_SIZE * (ClusterCount - 1);
+
+    if (ClusterCount < 2 ||
+        ClusteredSize > 2 * (IF_BLOCK_SIZE * IfBlockCount + IF_RANGE_BLOCK_SIZE * IfRangeBlockCount))
+    {
+        return false;
+    }
+
+    Select->Intervals = Intervals;
+    Select->IntervalCount = IntervalCount;
+    Select->Clusters = Clusters;
+    Select->ClusterCount = ClusterCount;
+    SetFlag32(Select, SBF_SELECT_CLUSTERED);
+
+    return true;
+}
+
 // Determine what kind of byte codes to generate for SELECT.
 // There are two choices, use an IF list or a SWITCH table
 // This function determines which method to use
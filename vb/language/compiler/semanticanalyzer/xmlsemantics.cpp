@@ -2032,7 +2032,8 @@ Semantics::ConcatenateAdjacentText(ParseTree::ExpressionList *&Content, ParseTre
 {
      ParseTree::XmlCharDataExpression *XmlCharData;
      ILTree::Expression *StringValue = NULL;
-     StringBuffer Buffer;
+     size_t Length = 0;
+     ParseTree::ExpressionList *First=Content;
      ParseTree::ExpressionList *Last=Content;
 
      VSASSERT(!Content ||
@@ -2041,12 +2042,11 @@ Semantics::ConcatenateAdjacentText(ParseTree::ExpressionList *&Content, ParseTre
          Content->Element->Opcode == ParseTree::Expression::XmlReference ||
          Content->Element->Opcode == ParseTree::Expression::SyntaxError)), "Bad Xml Content List");
 
+     // First find the extent of the text run, validating it and summing its length,
+     // so that the text can then be copied once straight into tree storage.
      for (ParseTree::ExpressionList *Current = Content; Current; Current = Current->Next)
      {
-         // If this is an attribute value then normalize new lines to whitespace
-
          ParseTree::Expression *Expr = Current->Element;
-         bool AppendData = true;
 
          switch (Expr->Opcode)
          {
@@ -2054,40 +2054,21 @@ Semantics::ConcatenateAdjacentText(ParseTree::ExpressionList *&Content, ParseTre
              XmlCharData = Expr->AsXmlCharData();
              if (XmlCharData->IsSignificant)
              {
-                 switch (Opcode)
+                 if (Opcode == ParseTree::Expression::XmlComment &&
+                     XmlCharData->LengthInCharacters == 2 &&
+                     XmlCharData->Value[0] == '-' &&
+                     XmlCharData->Value[1] == '-')
                  {
-                 case ParseTree::Expression::XmlAttribute:
-                     // Normalize attribute whitespace
-                     NormalizeAttributeValue(XmlCharData, Buffer);
-                     AppendData = false;
-                     break;
-
-                 case ParseTree::Expression::XmlComment:
-                     if (XmlCharData->LengthInCharacters == 2 &&
-                         XmlCharData->Value[0] == '-' &&
-                         XmlCharData->Value[1] == '-')
-                     {
-                         ReportSemanticError(ERRID_IllegalXmlCommentChar, Expr->TextSpan);
-                         break;
-                     }
-                     break;
+                     ReportSemanticError(ERRID_IllegalXmlCommentChar, Expr->TextSpan);
                  }
 
-                 if (AppendData)
-                    Buffer.AppendWithLength(XmlCharData->Value, XmlCharData->LengthInCharacters);
+                 Length += XmlCharData->LengthInCharacters;
              }
              break;
 
          case ParseTree::Expression::XmlReference:
-             // Do not normalize entity references.  Per spec, character entity references are exempt.
-             // Because general entity references are not supported by VB, there is no need to do any normalization.
-             {
-                 ParseTree::XmlReferenceExpression *Reference= Expr->AsXmlReference();
-
-                 ValidateEntityReference(Reference);
-
-                 Buffer.AppendWithLength(Reference->Value, Reference->LengthInCharacters);
-             }
+             ValidateEntityReference(Expr->AsXmlReference());
+             Length += Expr->AsXmlReference()->LengthInCharacters;
              break;
 
          default:
@@ -2100,16 +2081,52 @@ Semantics::ConcatenateAdjacentText(ParseTree::ExpressionList *&Content, ParseTre
 
 Done:
      Content = Last;
-     if (Buffer.GetStringLength())
+     if (Length)
      {
-         long Length = Buffer.GetStringLength();
          WCHAR *Value = new(m_TreeStorage) WCHAR[Length + 1];
+         size_t Offset = 0;
+
+         for (ParseTree::ExpressionList *Current = First; Current; Current = Current->Next)
+         {
+             ParseTree::Expression *Expr = Current->Element;
 
-         memcpy(
-             Value,
-             Buffer.GetString(),
-             Length * sizeof(WCHAR));
+             switch (Expr->Opcode)
+             {
+             case ParseTree::Expression::XmlCharData:
+                 XmlCharData = Expr->AsXmlCharData();
+                 if (XmlCharData->IsSignificant)
+                 {
+                     // If this is an attribute value then normalize new lines to whitespace
+                     if (Opcode == ParseTree::Expression::XmlAttribute)
+                     {
+                         NormalizeAttributeValue(XmlCharData, Value + Offset);
+                     }
+                     else
+                     {
+                         memcpy(Value + Offset, XmlCharData->Value, XmlCharData->LengthInCharacters * sizeof(WCHAR));
+                     }
+                     Offset += XmlCharData->LengthInCharacters;
+                 }
+                 break;
 
+             case ParseTree::Expression::XmlReference:
+                 // Do not normalize entity references.  Per spec, character entity references are exempt.
+                 // Because general entity references are not supported by VB, there is no need to do any normalization.
+                 {
+                     ParseTree::XmlReferenceExpression *Reference= Expr->AsXmlReference();
+                     memcpy(Value + Offset, Reference->Value, Reference->LengthInCharacters * sizeof(WCHAR));
+                     Offset += Reference->LengthInCharacters;
+                 }
+                 break;
+             }
+
+             if (Current == Last)
+             {
+                 break;
+             }
+         }
+
+         VSASSERT(Offset == Length, "Xml text run changed length while being copied");
          Value[Length] = L'\0';
 
          StringValue = ProduceStringConstantExpression(
@@ -2129,24 +2146,15 @@ Semantics::InterpretXmlCharData(ParseTree::XmlCharDataExpression *XmlCharData, P
     size_t Length;
     WCHAR *Value;
 
+    Length = XmlCharData->LengthInCharacters;
+    Value = new(m_TreeStorage) WCHAR[Length + 1];
+
     if (Opcode == ParseTree::Expression::XmlAttribute)
     {
-        StringBuffer Buffer;
-
-        NormalizeAttributeValue(XmlCharData, Buffer);
-        Length = Buffer.GetStringLength();
-
-        Value = new(m_TreeStorage) WCHAR[Length + 1];
-        memcpy(
-            Value,
-            Buffer.GetString(),
-            Length * sizeof(WCHAR));
+        NormalizeAttributeValue(XmlCharData, Value);
     }
     else
     {
-        Length = XmlCharData->LengthInCharacters;
-
-        Value = new(m_TreeStorage) WCHAR[Length + 1];
         memcpy(
             Value,
             XmlCharData->Value,
@@ -2964,13 +2972,15 @@ Semantics::GetXmlHelperMethod
 }
 
 
+// Normalization never changes the length of the text, so callers write the
+// result directly into a buffer of XmlCharData->LengthInCharacters characters.
 void
-NormalizeAttributeValue(ParseTree::XmlCharDataExpression *XmlCharData, StringBuffer &Buffer)
+NormalizeAttributeValue(ParseTree::XmlCharDataExpression *XmlCharData, _Out_cap_(XmlCharData->LengthInCharacters) WCHAR *Buffer)
 {
     // Normalize attribute whitespace
     if (XmlCharData->LengthInCharacters == 1 && XmlCharData->Value[0] == '\n')
     {
-        Buffer.AppendChar(L' ');
+        Buffer[0] = L' ';
     }
     else
     {
@@ -2978,9 +2988,9 @@ NormalizeAttributeValue(ParseTree::XmlCharDataExpression *XmlCharData, StringBuf
         {
             WCHAR c = XmlCharData->Value[i];
             if (c == '\t')
-                Buffer.AppendChar(L' ');
+                Buffer[i] = L' ';
             else
-                Buffer.AppendChar(c);
+                Buffer[i] = c;
         }
     }
 }
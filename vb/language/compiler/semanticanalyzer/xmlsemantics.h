@@ -289,7 +289,7 @@ void
 NormalizeAttributeValue
 (
     ParseTree::XmlCharDataExpression *XmlCharData,
-    StringBuffer &Buffer
+    _Out_cap_(XmlCharData->LengthInCharacters) WCHAR *Buffer
 );
 
 
@@ -7,6 +7,7 @@
 //-------------------------------------------------------------------------------------------------
 
 #include "StdAfx.h"
+#include "CommandLine\Timing.h"
 using namespace std;
 
 //****************************************************************************
@@ -33,6 +34,7 @@ using namespace std;
 bool SourceFile::_StepToBuiltSymbols()
 {
     DebCheckInCompileThread(m_pCompiler);
+    TIMEBLOCK(TIME_BuildSymbols);
 
     ErrorTable       *perrorTable = this->GetCurrentErrorTable();
     BCSYM_Container  *pcontainer = NULL;
@@ -178,6 +180,7 @@ bool SourceFile::_StepToBuiltSymbols()
 bool SourceFile::_StepToBoundSymbols()
 {
     DebCheckInCompileThread(m_pCompiler);
+    TIMEBLOCK(TIME_BindSymbols);
 
     ErrorTable errors(m_pCompiler, m_pProject, NULL);
 
@@ -764,10 +764,27 @@ UTF8FileWriter::UTF8FileWriter(
     HANDLE hFile,
     Compiler * pCompiler) :
     m_hFile(hFile),
-    m_alloc(NORLSLOC)
+    m_alloc(NORLSLOC),
+    m_cbBuffered(0)
 {
 }
 
+UTF8FileWriter::~UTF8FileWriter()
+{
+    // Output that was never flushed is discarded; Flush can fail, so it is not done here.
+}
+
+void UTF8FileWriter::Flush()
+{
+    if (m_cbBuffered > 0)
+    {
+        ULONG cb = m_cbBuffered;
+
+        m_cbBuffered = 0;
+        WriteBytes(m_Buffer, cb);
+    }
+}
+
 void UTF8FileWriter::AppendSTRING(_In_opt_z_ STRING * strBuffer)
 {
     if (strBuffer == NULL)
@@ -788,7 +805,16 @@ void UTF8FileWriter::AppendString(_In_opt_z_ PCWCH wszBuffer)
 
 void UTF8FileWriter::AppendChar(WCHAR wchBuffer)
 {
-    AppendData(&wchBuffer, 1);
+    if (wchBuffer < 0x80)
+    {
+        // ASCII is its own UTF8 encoding.
+        BYTE b = (BYTE)wchBuffer;
+        AppendBytes(&b, 1);
+    }
+    else
+    {
+        AppendData(&wchBuffer, 1);
+    }
 }
 
 void UTF8FileWriter::AppendMultiCopiesOfAWChar(
@@ -833,16 +859,40 @@ void UTF8FileWriter::AppendData(
 
         ConvertUnicodeToUTF8(pv, (ULONG)length, &m_alloc, &UTF8String, &UTF8StringLength);
 
-        ULONG BytesWritten = 0;
+        AppendBytes(UTF8String, UTF8StringLength);
+        m_alloc.FreeHeap();
+    }
+}
 
-        if (!WriteFile(m_hFile, UTF8String, UTF8StringLength, &BytesWritten, NULL))
-        {
-            DWORD dwLastError = GetLastError();
-            throw HRESULT_FROM_WIN32(dwLastError);
-        }
-        else
+void UTF8FileWriter::AppendBytes(
+    const BYTE * pb,
+    ULONG cb)
+{
+    if (cb > BufferSize - m_cbBuffered)
+    {
+        Flush();
+
+        if (cb >= BufferSize)
         {
-            m_alloc.FreeHeap();
+            // Too big to be worth buffering.
+            WriteBytes(pb, cb);
+            return;
         }
     }
+
+    memcpy(m_Buffer + m_cbBuffered, pb, cb);
+    m_cbBuffered += cb;
+}
+
+void UTF8FileWriter::WriteBytes(
+    const BYTE * pb,
+    ULONG cb)
+{
+    ULONG BytesWritten = 0;
+
+    if (!WriteFile(m_hFile, pb, cb, &BytesWritten, NULL))
+    {
+        DWORD dwLastError = GetLastError();
+        throw HRESULT_FROM_WIN32(dwLastError);
+    }
 }
@@ -273,7 +273,8 @@ private:
 };
 
 //Defines a replacement for the string buffer class
-//that immedietly outputs to a file, in UTF8 format
+//that outputs to a file, in UTF8 format. Output is buffered;
+//call Flush once everything has been written.
 class UTF8FileWriter :
     public virtual BaseWriter
 {
@@ -282,6 +283,11 @@ public:
         HANDLE hFile,
         Compiler * pCompiler);
 
+    ~UTF8FileWriter();
+
+    // Writes any buffered output to the file. Throws the HRESULT on failure.
+    void Flush();
+
     virtual
     void AppendSTRING(_In_opt_z_ STRING * strBuffer);
 
@@ -306,7 +312,19 @@ private:
         const WCHAR * pv,
         size_t cbSize);
 
+    void AppendBytes(
+        const BYTE * pb,
+        ULONG cb);
+
+    void WriteBytes(
+        const BYTE * pb,
+        ULONG cb);
+
 private:
     NorlsAllocator m_alloc;
     HANDLE m_hFile;
+
+    static const ULONG BufferSize = 16 * 1024;
+    BYTE m_Buffer[BufferSize];
+    ULONG m_cbBuffered;
 };
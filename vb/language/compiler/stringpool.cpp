@@ -39,6 +39,7 @@ StringPool::StringPool() :
     m_ulSpellingHashTableSize = BaseSpellingHashTableSize;
     m_ulSpellingHashTableMask = m_ulSpellingHashTableSize - 1;
     m_spellingHashTable = VBAllocator::AllocateArray<Casing*>(BaseSpellingHashTableSize);
+    m_cRetiredSpellingTables = 0;
 
     // calculate thresholds.
     m_ulStrInfoThreshold = IdealBucketSize * BaseStrInfoHashTableSize;
@@ -136,7 +137,12 @@ StringPool::StringPool() :
 StringPool::~StringPool()
 {
     VBFree(m_strinfoHashTable);
-    VBFree(m_spellingHashTable);
+    VBFree((void *)m_spellingHashTable);
+
+    for (unsigned iTable = 0; iTable < m_cRetiredSpellingTables; iTable++)
+    {
+        VBFree((void *)m_rgRetiredSpellingTables[iTable]);
+    }
 }
 
 //============================================================================
@@ -390,12 +396,17 @@ bool StringPool::ExpandSpellingTable()
     // move up spelling threshold.
     m_ulSpellingThreshold = m_ulSpellingThreshold << 1;
 
-    Casing** spellingNewHashTable = NULL;
+    if (m_cRetiredSpellingTables == MaxRetiredSpellingTables)
+    {
+        VSFAIL("Too many spelling table doublings.");
+        return false;
+    }
 
-    // Reallocate the stringinfo hash table with new size
-    spellingNewHashTable =
-        (Casing**)VBRealloc(  m_spellingHashTable,
-                              2 * m_ulSpellingHashTableSize * sizeof(Casing*));
+    // Build the doubled table off to the side rather than reallocating in
+    // place.  FindSpellingNoLock may be walking the old table right now, so it
+    // has to stay where it is until the pool is destroyed.
+    unsigned ulNewHashTableSize = 2 * m_ulSpellingHashTableSize;
+    Casing* volatile* spellingNewHashTable = VBAllocator::AllocateArray<Casing*>(ulNewHashTableSize);
 
     // fail if unable to expand table further
     if (spellingNewHashTable == NULL)
@@ -403,62 +414,38 @@ bool StringPool::ExpandSpellingTable()
         return false;
     }
 
-    m_spellingHashTable = spellingNewHashTable;
-
-    // zerofill newly allocated memory
-    memset( m_spellingHashTable + m_ulSpellingHashTableSize,
-            0,
-            (size_t)(m_ulSpellingHashTableSize * sizeof(Casing*)));
-
-    // take old table and fill into new table, starting at bottom
+    // take old table and fill into new table
+    Casing* volatile* spellingOldHashTable = m_spellingHashTable;
     unsigned ispellingTablePos = m_ulSpellingHashTableSize;
     unsigned index;
-    Casing *pspellingPrev, *pspellingCur, *pspellingNext;
-
-    unsigned ulPrevHashTableDoublings = (m_ulSpellingHashTableSize / 1024) - 1;
-    m_ulSpellingHashTableSize *= 2;
-    m_ulSpellingHashTableMask = m_ulSpellingHashTableSize - 1;
+    Casing *pspellingCur, *pspellingNext;
 
     do
     {
-        // go though one bucket of the table and place items elsewhere
+        // go though one bucket of the table and place items in the new one
         ispellingTablePos--;
-        pspellingPrev = NULL;
-        pspellingCur = m_spellingHashTable[ispellingTablePos];
+        pspellingCur = spellingOldHashTable[ispellingTablePos];
         while (pspellingCur != NULL)
         {
-
             pspellingNext = pspellingCur->m_pspellingNext;
             index = ((pspellingCur->m_ulSpellingHash << 10)+(ispellingTablePos & 1023))
-                    & (m_ulSpellingHashTableSize-1);
+                    & (ulNewHashTableSize-1);
 
-            // move it if necessary
-            if (index != ispellingTablePos)
-            {
-                // remove it from the current bucket
-                if (pspellingPrev == NULL)
-                {
-                    m_spellingHashTable[ispellingTablePos] = pspellingNext;
-                }
-                else
-                {
-                    pspellingPrev->m_pspellingNext = pspellingNext;
-                }
-
-                // place it in a new bucket
-                pspellingCur->m_pspellingNext = m_spellingHashTable[index];
-                m_spellingHashTable[index] = pspellingCur;
-
-            }
-            else
-            {
-                pspellingPrev = pspellingCur;
-            }
+            pspellingCur->m_pspellingNext = spellingNewHashTable[index];
+            spellingNewHashTable[index] = pspellingCur;
 
             pspellingCur = pspellingNext;
         }
     } while (ispellingTablePos > 0);
 
+    // Publish the table before the mask so that a reader which sees the larger
+    // mask also sees the larger table.  A reader that pairs the new table with
+    // the old mask just probes the wrong bucket and retries under the lock.
+    m_rgRetiredSpellingTables[m_cRetiredSpellingTables++] = spellingOldHashTable;
+    m_ulSpellingHashTableSize = ulNewHashTableSize;
+    m_spellingHashTable = spellingNewHashTable;
+    m_ulSpellingHashTableMask = ulNewHashTableSize - 1;
+
     return true;
 }
 
@@ -779,6 +766,41 @@ unsigned long StringPool::ComputeHashValue(
     return hash;
 }
 
+//============================================================================
+// Case insensitive comparison of the first cch characters of two strings,
+// returning zero if they match. Nearly all identifiers are ASCII, so fold
+// those directly and only defer to CompareNoCaseN from the first character
+// that is not ASCII (or is NUL) in either string; non-ASCII characters can
+// fold to ASCII ones (e.g. KELVIN SIGN to 'k'), so the result is unchanged.
+//============================================================================
+
+static inline
+int CompareNoCaseNAsciiFirst(
+    _In_count_(cch) const WCHAR * pwch1,
+    _In_count_(cch) const WCHAR * pwch2,
+    int cch)
+{
+    for (int i = 0; i < cch; i++)
+    {
+        WCHAR wch1 = pwch1[i];
+        WCHAR wch2 = pwch2[i];
+
+        if ((wch1 | wch2) >= 0x80 || wch1 == 0 || wch2 == 0)
+        {
+            return CompareNoCaseN(pwch1 + i, pwch2 + i, cch - i);
+        }
+
+        // Equal ignoring case only if they are the same letter, differing in the 0x20 bit.
+        if (wch1 != wch2 &&
+            ((wch1 ^ wch2) != 0x20 || (unsigned)((wch1 | 0x20) - L'a') > (unsigned)(L'z' - L'a')))
+        {
+            return wch1 < wch2 ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
 //============================================================================
 // Computes the hash value of a wchar string. You can choose whether you
 // want the case sensitive or case insensitive hash value computed. The
@@ -919,6 +941,47 @@ unsigned long _fastcall StringPool::ComputeStringHashValue(
     return hash;
 }
 
+//============================================================================
+// Look for an exact spelling without taking m_CriticalSection.  Spellings
+// are never removed and are fully initialized before they are published, so
+// a match is final.  A miss is not; the caller retries under the lock, and
+// can skip the walk if the bucket and head returned here are unchanged.
+//============================================================================
+
+Casing * StringPool::FindSpellingNoLock(
+    _In_count_(cchSize) const WCHAR * pwchar,
+    size_t cchSize,
+    unsigned ulSpHash,
+    unsigned ulSpCompare,
+    _Out_ Casing * volatile * * pppspellingBucket,
+    _Out_ Casing ** ppspellingHead)
+{
+    size_t clSizeLong = cchSize >> 1;
+    size_t cchAfterLong = (cchSize) & 1;
+
+    // Read the mask before the table; ExpandSpellingTable publishes them in
+    // the opposite order.
+    unsigned index = ulSpHash & (m_ulSpellingHashTableMask);
+    Casing * volatile *ppspellingBucket = &m_spellingHashTable[index];
+    Casing *pspellingHead = *ppspellingBucket;
+
+    *pppspellingBucket = ppspellingBucket;
+    *ppspellingHead = pspellingHead;
+
+    for (Casing *pspelling = pspellingHead;
+         pspelling;
+         pspelling = pspelling->m_pspellingNext)
+    {
+        if (pspelling->m_ulCompare == ulSpCompare &&
+            !dmemcmp((const unsigned *)pspelling->m_str, (const unsigned *)pwchar, clSizeLong, cchAfterLong))
+        {
+            return pspelling;
+        }
+    }
+
+    return NULL;
+}
+
 //============================================================================
 // Lookup a string without adding it if it isn't already there.
 //============================================================================
@@ -942,6 +1005,18 @@ STRING * StringPool::LookupStringWithLen(
     //
 
     ulHash = ComputeStringHashValue((unsigned long *)pwchar, clSizeLong, cchAfterLong, true);
+    ulCompare = GetCompareValue(cchSize, GetSignificantSpellingHashValue(ulHash));
+
+    // See AddStringWithLen.
+    Casing * volatile *ppspellingBucket;
+    Casing *pspellingHead;
+
+    pspelling = FindSpellingNoLock(pwchar, cchSize, ulHash, ulCompare, &ppspellingBucket, &pspellingHead);
+
+    if (pspelling)
+    {
+        return pspelling->m_str;
+    }
 
     // Grab the lock after ComputeStringHashValue.  Profiles show that this method in particular 
     // is very expensive and accounts to up to 2/3 of the entire AddStringWithLength call.  It is 
@@ -952,9 +1027,16 @@ STRING * StringPool::LookupStringWithLen(
     CompilerIdeLock lock(m_CriticalSection);
 
     index = ulHash & (m_ulSpellingHashTableMask);
-    ulCompare = GetCompareValue(cchSize, GetSignificantSpellingHashValue(ulHash));
 
-    for (pspelling = m_spellingHashTable[index];
+    pspelling = m_spellingHashTable[index];
+
+    // Nothing new in the bucket FindSpellingNoLock already searched.
+    if (&m_spellingHashTable[index] == ppspellingBucket && pspelling == pspellingHead)
+    {
+        pspelling = NULL;
+    }
+
+    for (;
          pspelling;
          pspelling = pspelling->m_pspellingNext)
     {
@@ -1024,7 +1106,7 @@ STRING * StringPool::LookupStringWithLen(
             // which is correct both from the standpoint of normal comparison, but also
             // from the standpoint of case sensitivity (i.e. we use the standard Unicode
             // 1-1 case mappings rather than dealing with local sensitive casing)
-            if (!CompareNoCaseN(pwchar, pstrinfo->m_spelling.m_str, (int)cchSize))
+            if (!CompareNoCaseNAsciiFirst(pwchar, pstrinfo->m_spelling.m_str, (int)cchSize))
             {
                 pstr = pstrinfo->m_spelling.m_str;
                 goto Done;
@@ -1074,6 +1156,22 @@ STRING *
     //
 
     ulSpHash = ComputeStringHashValue((unsigned long *)pwchar, clSizeLong, cchAfterLong, true);
+    ulSpCompare = GetCompareValue(cchSize, GetSignificantSpellingHashValue(ulSpHash));
+
+    // Nearly every call is for a spelling that is already in the pool, so look
+    // for it before contending for the lock.  Remember which bucket we looked at
+    // and what was at its head: if neither has changed by the time we own the
+    // lock, nobody has added this spelling in the meantime and there is no need
+    // to walk the bucket again.
+    Casing * volatile *ppspellingBucket;
+    Casing *pspellingHead;
+
+    pspelling = FindSpellingNoLock(pwchar, cchSize, ulSpHash, ulSpCompare, &ppspellingBucket, &pspellingHead);
+
+    if (pspelling)
+    {
+        return pspelling->m_str;
+    }
 
     // Grab the lock after ComputeStringHashValue.  Profiles show that this method in particular 
     // is very expensive and accounts to up to 2/3 of the entire AddStringWithLength call.  It is 
@@ -1083,9 +1181,16 @@ STRING *
     CompilerIdeLock lock(m_CriticalSection);
 
     indexSp = ulSpHash & (m_ulSpellingHashTableMask);
-    ulSpCompare = GetCompareValue(cchSize, GetSignificantSpellingHashValue(ulSpHash));
 
-    for (pspelling = m_spellingHashTable[indexSp];
+    pspelling = m_spellingHashTable[indexSp];
+
+    // Nothing new in the bucket FindSpellingNoLock already searched.
+    if (&m_spellingHashTable[indexSp] == ppspellingBucket && pspelling == pspellingHead)
+    {
+        pspelling = NULL;
+    }
+
+    for (;
          pspelling;
          pspelling = pspelling->m_pspellingNext)
     {
@@ -1147,7 +1252,7 @@ STRING *
 #endif // DEBUG
 
         // compare the strings.
-        if (!CompareNoCaseN(pwchar, pstrinfo->m_spelling.m_str, (int)cchSize))
+        if (!CompareNoCaseNAsciiFirst(pwchar, pstrinfo->m_spelling.m_str, (int)cchSize))
         {
             break;
         }
@@ -1239,7 +1344,10 @@ STRING *
     VSASSERT(pspelling->m_cchLength == cchSize, "Overflow.");
     VSASSERT(pspelling->m_ulCompare == ulSpCompare, "Overflow.");
 
+    // Everything FindSpellingNoLock looks at must be visible before the
+    // spelling is.
     pspelling->m_pspellingNext = m_spellingHashTable[indexSp];
+    MemoryBarrier();
     m_spellingHashTable[indexSp] = pspelling;
 
     // update the counter
@@ -192,6 +192,14 @@ private:
     bool ExpandStrInfoTable();
     bool ExpandSpellingTable();
 
+    Casing * FindSpellingNoLock(
+        _In_count_(cchSize) const WCHAR * pwchar,
+        size_t cchSize,
+        unsigned ulSpHash,
+        unsigned ulSpCompare,
+        _Out_ Casing * volatile * * pppspellingBucket,
+        _Out_ Casing ** ppspellingHead);
+
 public:
     NEW_MUST_ZERO()
 
@@ -483,13 +491,20 @@ private:
     //
 
     STRING_INFO **m_strinfoHashTable;     // string hash table
-    Casing **m_spellingHashTable;       // spelling hash table
+    Casing * volatile * volatile m_spellingHashTable;  // spelling hash table, probed without the lock
 
     unsigned m_ulStrInfoHashTableSize;    // current size of the strinfo hash table
     unsigned m_ulSpellingHashTableSize;   // current size of the spelling hash table
 
     unsigned m_ulStrInfoHashTableMask;    // size of hash table minus 1.
-    unsigned m_ulSpellingHashTableMask;
+    volatile unsigned m_ulSpellingHashTableMask;
+
+    // Spelling tables replaced by ExpandSpellingTable.  A reader that is probing
+    // without the lock may still be walking one of these, so they are only freed
+    // when the pool goes away.
+    static const unsigned MaxRetiredSpellingTables = 8;
+    Casing * volatile *m_rgRetiredSpellingTables[MaxRetiredSpellingTables];
+    unsigned m_cRetiredSpellingTables;
 
     unsigned m_ulStrInfoThreshold;        // thresholds for resizing hash table.
     unsigned m_ulSpellingThreshold;
@@ -540,6 +555,12 @@ private:
     //   - m_spellingHashTable
     //   - m_ul*
     //
+    // The one exception is the exact-spelling probe in FindSpellingNoLock.  Writers
+    // only ever push fully initialized spellings on the head of a bucket, and a
+    // rehash builds a new table rather than reallocating the old one, so a reader
+    // without the lock can only miss a spelling, never see a bad one.  Misses are
+    // retried under the lock.
+    //
     // All other member variables, while potentially accessed in multiple threads, are
     // initialized to their final state within the StringPool constructor and hence
     // are safe to read from multiple threads
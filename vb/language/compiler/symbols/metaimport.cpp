@@ -223,6 +223,7 @@ void MetaImport::DoImportTypes()
     unsigned long cchScope;
     WCHAR *wszScope;
     STRING *pstrScope;
+    GUID guidMvid;
     bool fMissingTypes = false;
 
     MetaType *rgtypes;
@@ -248,7 +249,7 @@ void MetaImport::DoImportTypes()
     IfFailThrow(m_pmdImport->GetScopeProps(NULL,
                                            0,
                                            &cchScope,
-                                           NULL));
+                                           &guidMvid));
 
     if (cchScope)
     {
@@ -270,6 +271,7 @@ void MetaImport::DoImportTypes()
 
     // Remember the scope name to help when debugging.
     m_pMetaDataFile->SetName(pstrScope);
+    m_pMetaDataFile->SetMvid(guidMvid);
     if (m_pMetaDataFile->GetProject()->GetScopeName() == NULL)
     {
         m_pMetaDataFile->GetProject()->SetScopeName(pstrScope);
@@ -283,7 +285,9 @@ void MetaImport::DoImportTypes()
     pAttrTokenHash = (DynamicFixedSizeHashTable<mdToken, AttrIdentity *> *)
         m_pMetaDataFile->SymbolStorage()->Alloc(sizeof(DynamicFixedSizeHashTable<mdToken, AttrIdentity *>));
 #endif
-    pAttrTokenHash->Init(m_pMetaDataFile->SymbolStorage(), 16);
+    // One entry per distinct attribute constructor referenced by the file; framework
+    // assemblies reference hundreds, so don't let the (fixed) chains get long.
+    pAttrTokenHash->Init(m_pMetaDataFile->SymbolStorage(), 128);
     m_pMetaDataFile->SetAttributeTokenHash(pAttrTokenHash);
 
     CheckWhetherToImportInaccessibleMembers();
@@ -703,6 +707,10 @@ void MetaImport::LoadTypes
         if (!GetTypeDefProps(rgtypes, cTypes, *pfMissingTypes, td, &IsClass, &pstrName, &pstrNameSpace, &DeclFlags, &tkExtends, &rgtypes[iType].m_tdNestingContainer))
             continue;
 
+#if DEBUG
+        m_pMetaDataFile->m_cTypesImported++;
+#endif
+
         // Create the appropriate symbol.
         if (!IsClass)
         {
@@ -2069,6 +2077,10 @@ void MetaImport::DoImportTypeChildren
     m_pcontainer = pContainer;
     m_td = pContainer->GetTypeDef();
 
+#if DEBUG
+    m_pMetaDataFile->m_cTypesWithChildrenLoaded++;
+#endif
+
 #if FV_TRACK_MEMORY
     DebPrintf("Loading children for '%S.%S' in '%S'.\n", m_pcontainer->GetNameSpace(), m_pcontainer->GetName(), m_pcontainer->GetContainingProject()->GetAssemblyName());
 #endif
@@ -2350,6 +2362,11 @@ void MetaImport::LoadChildren
 
     // Remember how many we actually have.
     m_cMembers = iMemberWrite;
+
+#if DEBUG
+    m_pMetaDataFile->m_cMembersInLoadedTypes += iMember;
+    m_pMetaDataFile->m_cMembersImported += iMemberWrite;
+#endif
 }
 
 //============================================================================
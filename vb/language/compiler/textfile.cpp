@@ -153,6 +153,16 @@ HRESULT TextFile::GetFileText(
             }
         }
 
+#if !IDE
+        // The text is still sitting in the view we kept the last time.
+        if (!hasFileData && m_pMappedView)
+        {
+            wszFileContents = (WCHAR *)(m_pMappedView + sizeof(WCHAR));
+            cchFileSize = (m_cbMappedView - sizeof(WCHAR)) / sizeof(WCHAR);
+            hasFileData = true;
+        }
+#endif
+
         // If the file was not loaded into a buffer or if the buffer
         // was empty, load the text from the original file on disk.
         //
@@ -191,26 +201,44 @@ HRESULT TextFile::GetFileText(
                     IfNullThrow(hMap);
                     pData = (BYTE *)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
                     IfNullThrow(pData);
-                    //Microsoft: moved file conversion to Unicode here
-                    //so that we can cache it in this format
-                    IfFailThrow(LoadTextFileFromBytes(
-                                                        pnra,
-                                                        pData,
-                                                        dwSize,
-                                                        lti,
-                                                        &m_lti,
-                                                        &wszFileContents,
-                                                        &cchFileSize));
-
-                    // We need the timestamp for the SourceFileCache
-                    FILETIME ftTimestamp;
-                    GetFileTime(m_hFile, NULL, NULL, &ftTimestamp);
-
-                    // Cache the source file contents to the source file cache so we
-                    // don't spends all of our time in CreateFile() to re-read the file.
-                    WriteUnicodeSourceFileCache(wszFileContents, cchFileSize, ftTimestamp, IsDetectUTF8WithoutSig);
-
-                    //Microsoft: we used to do the conversion here, but now moved it up so we cache Unicode
+#if !IDE
+                    if (IsUnicodeTextWithSignature(pData, dwSize))
+                    {
+                        // Nothing to convert, so keep the view and scan it in place.
+                        IfFailThrow(GetImageFormat2(lti, dwSize, pData, &m_lti));
+
+                        m_hMappedView = hMap.Detach();
+                        m_pMappedView = pData;
+                        m_cbMappedView = dwSize;
+                        pData = NULL;
+
+                        wszFileContents = (WCHAR *)(m_pMappedView + sizeof(WCHAR));
+                        cchFileSize = (m_cbMappedView - sizeof(WCHAR)) / sizeof(WCHAR);
+                    }
+                    else
+#endif
+                    {
+                        //Microsoft: moved file conversion to Unicode here
+                        //so that we can cache it in this format
+                        IfFailThrow(LoadTextFileFromBytes(
+                                                            pnra,
+                                                            pData,
+                                                            dwSize,
+                                                            lti,
+                                                            &m_lti,
+                                                            &wszFileContents,
+                                                            &cchFileSize));
+
+                        // We need the timestamp for the SourceFileCache
+                        FILETIME ftTimestamp;
+                        GetFileTime(m_hFile, NULL, NULL, &ftTimestamp);
+
+                        // Cache the source file contents to the source file cache so we
+                        // don't spends all of our time in CreateFile() to re-read the file.
+                        WriteUnicodeSourceFileCache(wszFileContents, cchFileSize, ftTimestamp, IsDetectUTF8WithoutSig);
+
+                        //Microsoft: we used to do the conversion here, but now moved it up so we cache Unicode
+                    }
                 }
                 else
                 {
@@ -477,6 +505,20 @@ void TextFile::CloseFile()
 {
     CompilerIdeLock spLock(m_TextFileCriticalSection);
 
+#if !IDE
+    if (m_pMappedView != NULL)
+    {
+        UnmapViewOfFile(m_pMappedView);
+        m_pMappedView = NULL;
+        m_cbMappedView = 0;
+    }
+    if (m_hMappedView != NULL)
+    {
+        CloseHandle(m_hMappedView);
+        m_hMappedView = NULL;
+    }
+#endif
+
     if (m_hFile != INVALID_HANDLE_VALUE)
     {
         CloseHandle(m_hFile);
@@ -490,6 +532,25 @@ void TextFile::CloseFile()
     spLock.Unlock();
 }
 
+#if !IDE
+//============================================================================
+// IsUnicodeTextWithSignature
+//============================================================================
+bool TextFile::IsUnicodeTextWithSignature(
+    const BYTE * pData,
+    DWORD dwSize)
+{
+    // FF FE 00 00 is the UTF-32LE signature, so insist on at least one real
+    // character that isn't NUL.  An odd byte count means a truncated file,
+    // which LoadTextFileFromBytes knows how to report.
+    return dwSize >= 2 * sizeof(WCHAR) &&
+           (dwSize % sizeof(WCHAR)) == 0 &&
+           pData[0] == 0xFF &&
+           pData[1] == 0xFE &&
+           (pData[2] != 0 || pData[3] != 0);
+}
+#endif
+
 //============================================================================
 // LoadTextFileFromBytes
 //============================================================================
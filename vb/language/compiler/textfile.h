@@ -23,6 +23,10 @@ struct TextFile : ZeroInit<TextFile>
     {
         m_hFile = INVALID_HANDLE_VALUE;
         m_pTextFileCacheRef = NULL;
+#if !IDE
+        m_hMappedView = NULL;
+        m_pMappedView = NULL;
+#endif
     }
 
     ~TextFile()
@@ -152,6 +156,23 @@ private:
     //
     HANDLE m_hFile;
 
+#if !IDE
+    // Returns true if the bytes are UTF-16LE with a signature, and hence can
+    // be handed to the scanner as they are.
+    static bool IsUnicodeTextWithSignature(
+        const BYTE * pData,
+        DWORD dwSize);
+
+    // A read-only view of the file, kept for the life of m_hFile when the file
+    // is already UTF-16LE.  The handle is opened without FILE_SHARE_WRITE, so
+    // the view cannot go stale while we hold it and GetFileText can return a
+    // pointer straight into it instead of copying the text into the allocator
+    // and the TextFileCache.
+    HANDLE m_hMappedView;
+    BYTE * m_pMappedView;
+    DWORD m_cbMappedView;
+#endif
+
     // Host-provided (VBA) in-memory buffer
     BSTR m_bstrBuffer;
 
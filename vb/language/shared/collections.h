@@ -568,6 +568,212 @@ public:
     unsigned long Count() const;
 };
 
+template <class K,class V,class A, class H>
+class FlatHashTable;
+
+//====================================================================
+// A single inline slot of a FlatHashTable.  m_state is one of the
+// FlatHashTableSlotState values; the cached hash lets probes reject
+// most non-matching slots without calling H::AreEqual.
+//====================================================================
+enum FlatHashTableSlotState
+{
+    FlatSlotEmpty = 0,
+    FlatSlotDeleted = 1,
+    FlatSlotOccupied = 2
+};
+
+template <class K, class V>
+struct FlatHashTableSlot
+{
+    KeyValuePair<K,V> m_kvp;
+    unsigned long m_hash;
+    unsigned long m_state;
+};
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V, class A, class H = DefaultHashFunction<K> >
+class FlatHashTableIterator : public virtual IIterator<KeyValuePair<K,V> >
+{
+public:
+    FlatHashTableIterator(FlatHashTable<K,V,A,H> * pHashTable);
+    FlatHashTableIterator(const FlatHashTableIterator<K,V,A,H> & src);
+    virtual bool MoveNext();
+    virtual KeyValuePair<K,V> Current();
+    virtual void Remove();
+private:
+    unsigned long m_tableIndex;
+    bool m_fBeforeStart;
+    FlatHashTable<K,V,A,H> * m_pHashTable;
+};
+
+//====================================================================
+//
+//====================================================================
+template <class K, class V, class A, class H = DefaultHashFunction<K>>
+class FlatHashTableConstIterator : public ConstIteratorWrapper<KeyValuePair<K,V>, FlatHashTable<K,V,A,H>, FlatHashTableIterator<K,V,A,H> >
+{
+public:
+    FlatHashTableConstIterator(const FlatHashTable<K,V,A,H> *pHashTable)
+        :ConstIteratorWrapper(pHashTable)
+    {
+    }
+    FlatHashTableConstIterator(const FlatHashTableConstIterator<K,V,A,H> &src)
+        :ConstIteratorWrapper(src)
+    {
+    }
+};
+
+//====================================================================
+//
+//====================================================================
+template <class K, class V, class A, class H = DefaultHashFunction<K>>
+class FlatHashTableKeyIterator : public virtual IIterator<K>
+{
+public:
+    FlatHashTableKeyIterator(FlatHashTable<K,V,A,H> * pHashTable)
+        : m_iter(pHashTable)
+    {
+    }
+    virtual bool MoveNext()
+    {
+        return m_iter.MoveNext();
+    }
+    virtual K Current()
+    {
+        return m_iter.Current().Key();
+    }
+    virtual void Remove()
+    {
+        m_iter.Remove();
+    }
+private:
+    FlatHashTableIterator<K,V,A,H> m_iter;
+};
+
+//====================================================================
+//
+//====================================================================
+template <class K, class V, class A, class H = DefaultHashFunction<K>>
+class FlatHashTableValueIterator : public virtual IIterator<V>
+{
+public:
+    FlatHashTableValueIterator(FlatHashTable<K,V,A,H> * pHashTable)
+        : m_iter(pHashTable)
+    {
+    }
+    virtual bool MoveNext()
+    {
+        return m_iter.MoveNext();
+    }
+    virtual V Current()
+    {
+        return m_iter.Current().Value();
+    }
+    virtual void Remove()
+    {
+        m_iter.Remove();
+    }
+private:
+    FlatHashTableIterator<K,V,A,H> m_iter;
+};
+
+//====================================================================
+//
+//====================================================================
+template <class K, class V, class A, class H = DefaultHashFunction<K>>
+class FlatHashTableValueConstIterator : public ConstIteratorWrapper<V, FlatHashTable<K,V,A,H>, FlatHashTableValueIterator<K,V,A,H> >
+{
+public:
+    FlatHashTableValueConstIterator(const FlatHashTable<K,V,A,H> *pHashTable)
+        :ConstIteratorWrapper(pHashTable)
+    {
+    }
+    FlatHashTableValueConstIterator(const FlatHashTableValueConstIterator<K,V,A,H> &src)
+        :ConstIteratorWrapper(src)
+    {
+    }
+};
+
+//====================================================================
+// Open addressed variant of DynamicHashTable.  Keys and values are
+// stored inline in a single power-of-two sized slot array and
+// collisions are resolved with linear probing, so a lookup touches a
+// handful of adjacent cache lines and an insert never allocates
+// unless the table has to grow.
+//
+// The public surface mirrors DynamicHashTable so that a call site can
+// switch between the two with a typedef.  Removal leaves a tombstone
+// which keeps iterator Remove() safe; tombstones are purged whenever
+// the table is rehashed.
+//====================================================================
+template <class K, class V, class A=VBAllocWrapper, class H = DefaultHashFunction<K>>
+class FlatHashTable
+{
+    friend class FlatHashTableIterator<K,V,A,H>;
+public:
+    ~FlatHashTable();
+    FlatHashTable(const A & alloc = A(), const H & hashFunc = H(), const unsigned long capacity = default_initial_capacity);
+
+    bool Init(const unsigned long capacity);
+    void SetValue(const K & key, const V & value);
+    bool Contains(const K & key) const;
+    unsigned long Count() const;
+    bool GetValue(const K & key, _Out_opt_ V * pOutValue) const;
+    V GetValue(const K &key) const;
+    V GetValueOrDefault(const K &key, V defaultValue = V()) const;
+    bool Remove(const K & key);
+    void Clear();
+    static const unsigned long default_initial_capacity = 16;
+
+    FlatHashTableKeyIterator<K,V,A,H> GetKeyIterator()
+    {
+        return FlatHashTableKeyIterator<K,V,A,H>(this);
+    }
+
+    FlatHashTableValueConstIterator<K,V,A,H> GetValueConstIterator() const
+    {
+        return FlatHashTableValueConstIterator<K,V,A,H>(this);
+    }
+
+    FlatHashTableValueIterator<K,V,A,H> GetValueIterator()
+    {
+        return FlatHashTableValueIterator<K,V,A,H>(this);
+    }
+
+    FlatHashTableConstIterator<K,V,A,H> GetConstIterator() const
+    {
+        return FlatHashTableConstIterator<K,V,A,H>(this);
+    }
+
+    FlatHashTableIterator<K,V,A,H> GetIterator()
+    {
+        return FlatHashTableIterator<K,V,A,H>(this);
+    }
+
+protected:
+    A m_alloc;
+private:
+    typedef FlatHashTableSlot<K,V> Slot;
+
+    // Do not autogenerate
+    FlatHashTable(const FlatHashTable<K,V,A,H> &);
+    FlatHashTable<K,V,A,H>& operator=(const FlatHashTable<K,V,A,H>&);
+
+    static unsigned long RoundUpToPowerOfTwo(unsigned long value);
+    unsigned long Hash(const K & key) const;
+    long FindSlot(const K & key, unsigned long hash) const;
+    void Rehash(unsigned long newCapacity);
+
+    unsigned long m_capacity;
+    unsigned long m_count;
+    unsigned long m_deleted;
+    Slot * m_rgSlots;
+    H m_hashFunc;
+};
+
 template <class T>
 class LessThanComparer
 {
@@ -2215,6 +2421,421 @@ unsigned long HashSet<T,A,H>::Count() const
     return DynamicHashTable<T,bool, A, H>::Count();
 }
 
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A,class H>
+FlatHashTableIterator<K,V,A,H>::FlatHashTableIterator(FlatHashTable<K,V,A,H> * pHashTable) :
+    m_tableIndex(0),
+    m_fBeforeStart(true),
+    m_pHashTable(pHashTable)
+{
+    Assume(pHashTable,L"An attempt was made to construct an iterator with a null hash table.");
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A,class H>
+FlatHashTableIterator<K,V,A,H>::FlatHashTableIterator(const FlatHashTableIterator<K,V,A,H> & src) :
+    m_tableIndex(src.m_tableIndex),
+    m_fBeforeStart(src.m_fBeforeStart),
+    m_pHashTable(src.m_pHashTable)
+{
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A,class H>
+bool FlatHashTableIterator<K,V,A,H>::MoveNext()
+{
+    if (!m_pHashTable || !m_pHashTable->m_rgSlots)
+    {
+        return false;
+    }
+
+    if (m_fBeforeStart)
+    {
+        m_fBeforeStart = false;
+    }
+    else if (m_tableIndex < m_pHashTable->m_capacity)
+    {
+        ++m_tableIndex;
+    }
+
+    while (m_tableIndex < m_pHashTable->m_capacity)
+    {
+        if (FlatSlotOccupied == m_pHashTable->m_rgSlots[m_tableIndex].m_state)
+        {
+            return true;
+        }
+        ++m_tableIndex;
+    }
+
+    return false;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A,class H>
+KeyValuePair<K,V> FlatHashTableIterator<K,V,A,H>::Current()
+{
+    bool fValid =
+        !m_fBeforeStart &&
+        m_tableIndex < m_pHashTable->m_capacity &&
+        FlatSlotOccupied == m_pHashTable->m_rgSlots[m_tableIndex].m_state;
+
+    Assume(fValid,L"An attempt was made to call current on an interator in an invalid state. Perhaps a call is missing to MoveNext() or the sequence has been exausted.");
+    if (fValid)
+    {
+        return m_pHashTable->m_rgSlots[m_tableIndex].m_kvp;
+    }
+    else
+        return KeyValuePair<K,V>();
+}
+
+//====================================================================
+// Leaves a tombstone behind so the slots not yet visited by this
+// iterator are unaffected by the removal.
+//====================================================================
+template <class K,class V,class A,class H>
+void FlatHashTableIterator<K,V,A,H>::Remove()
+{
+    if (!m_fBeforeStart &&
+        m_tableIndex < m_pHashTable->m_capacity &&
+        FlatSlotOccupied == m_pHashTable->m_rgSlots[m_tableIndex].m_state)
+    {
+        typename FlatHashTable<K,V,A,H>::Slot & slot = m_pHashTable->m_rgSlots[m_tableIndex];
+        slot.m_kvp = KeyValuePair<K,V>();
+        slot.m_state = FlatSlotDeleted;
+        m_pHashTable->m_count--;
+        m_pHashTable->m_deleted++;
+    }
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+FlatHashTable<K,V,A,H>::~FlatHashTable()
+{
+    if (m_rgSlots)
+    {
+        m_alloc.DeAllocateArray(m_rgSlots);
+    }
+
+    m_rgSlots = NULL;
+    m_capacity = 0;
+    m_count = 0;
+    m_deleted = 0;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+FlatHashTable<K,V,A,H>::FlatHashTable
+(
+    const A & alloc,
+    const H & hashFunc,
+    const unsigned long capacity
+) :
+    m_capacity(0),
+    m_count(0),
+    m_deleted(0),
+    m_rgSlots(NULL),
+    m_hashFunc(hashFunc),
+    m_alloc(alloc)
+{
+    TemplateUtil::CompileAssertSizeIsPointerMultiple<K>();
+    Init(capacity);
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+bool FlatHashTable<K,V,A,H>::Init(unsigned long capacity)
+{
+    Assume(capacity, L"An attempt was made to initialize a FlatHashTable<K,V,A,H> with capacity zero.");
+
+    capacity = RoundUpToPowerOfTwo(capacity);
+    Slot * rgSlots = m_alloc.AllocateArray<Slot>(capacity);
+    Assume(rgSlots,L"Allocation failed in FlatHashTable<K,V,A,H>::Init.");
+    if (rgSlots)
+    {
+        if (m_rgSlots)
+        {
+            m_alloc.DeAllocateArray(m_rgSlots);
+        }
+
+        m_rgSlots = rgSlots;
+        m_capacity = capacity;
+        m_count = 0;
+        m_deleted = 0;
+    }
+    return rgSlots != NULL;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+void FlatHashTable<K,V,A,H>::SetValue(const K &key, const V &value)
+{
+    Assume(m_rgSlots,L"SetValue was called on a FlatHashTable<K,V,A,H> that is in an invalid state. The underlying array should never be null.");
+    if (!m_rgSlots)
+    {
+        return;
+    }
+
+    const unsigned long hash = Hash(key);
+    long existing = FindSlot(key, hash);
+    if (existing >= 0)
+    {
+        m_rgSlots[existing].m_kvp.Value() = value;
+        return;
+    }
+
+    // Keep the load factor, tombstones included, at or below 3/4 so
+    // probe sequences stay short.  If most of the load is tombstones
+    // a same size rehash is enough to reclaim them.
+    if ((m_count + m_deleted + 1) * 4 > m_capacity * 3)
+    {
+        Rehash((m_count + 1) * 2 > m_capacity ? m_capacity * 2 : m_capacity);
+        if (!m_rgSlots)
+        {
+            return;
+        }
+    }
+
+    const unsigned long mask = m_capacity - 1;
+    unsigned long idx = hash & mask;
+    while (FlatSlotOccupied == m_rgSlots[idx].m_state)
+    {
+        idx = (idx + 1) & mask;
+    }
+
+    if (FlatSlotDeleted == m_rgSlots[idx].m_state)
+    {
+        --m_deleted;
+    }
+
+    m_rgSlots[idx].m_kvp = KeyValuePair<K,V>(key, value);
+    m_rgSlots[idx].m_hash = hash;
+    m_rgSlots[idx].m_state = FlatSlotOccupied;
+    ++m_count;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+bool FlatHashTable<K,V,A,H>::Contains(const K &key) const
+{
+    return GetValue(key, NULL);
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+unsigned long FlatHashTable<K,V,A,H>::Count() const
+{
+    return m_count;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+bool FlatHashTable<K,V,A,H>::GetValue(const K &key, _Out_opt_ V *pOutValue) const
+{
+    Assume(m_rgSlots,L"GetValue was called on a FlatHashTable<K,V,A,H> that is in an invalid state. The underlying array should never be null.");
+    long idx = m_rgSlots ? FindSlot(key, Hash(key)) : -1;
+    if (idx >= 0)
+    {
+        if (pOutValue)
+        {
+            *pOutValue = m_rgSlots[idx].m_kvp.Value();
+        }
+        return true;
+    }
+    return false;
+}
+
+//====================================================================
+// Operates the same as bool GetValue(const K, V*) except this will
+// throw if the key is not present in the dictionary
+//====================================================================
+template <class K,class V,class A, class H>
+V FlatHashTable<K,V,A,H>::GetValue(const K &key) const
+{
+    V temp = V();
+    if ( !GetValue(key, &temp) )
+    {
+        Assume(false, L"Key not present in the FlatHashTable<K,V,A,H>");
+    }
+
+    return temp;
+}
+
+//====================================================================
+//
+// Gets the value from the hash table.  If no value for the key is found
+// then it will return the default value as specified
+//
+//====================================================================
+template <class K,class V,class A, class H>
+V
+FlatHashTable<K,V,A,H>::GetValueOrDefault(const K &key, V defaultValue) const
+{
+    V value;
+    if ( GetValue(key, &value) )
+    {
+        return value;
+    }
+
+    return defaultValue;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+bool FlatHashTable<K,V,A,H>::Remove(const K & key)
+{
+    Assume(m_rgSlots,L"Remove was called on a FlatHashTable<K,V,A,H> that is in an invalid state. The underlying array should never be null.");
+    long idx = m_rgSlots ? FindSlot(key, Hash(key)) : -1;
+    if (idx >= 0)
+    {
+        m_rgSlots[idx].m_kvp = KeyValuePair<K,V>();
+        m_rgSlots[idx].m_state = FlatSlotDeleted;
+        --m_count;
+        ++m_deleted;
+        return true;
+    }
+    return false;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+void FlatHashTable<K,V,A,H>::Clear()
+{
+    if (m_rgSlots)
+    {
+        for (unsigned long i = 0; i < m_capacity; ++i)
+        {
+            m_rgSlots[i].m_kvp = KeyValuePair<K,V>();
+            m_rgSlots[i].m_state = FlatSlotEmpty;
+        }
+        m_count = 0;
+        m_deleted = 0;
+    }
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+unsigned long FlatHashTable<K,V,A,H>::RoundUpToPowerOfTwo(unsigned long value)
+{
+    unsigned long result = 1;
+    while (result < value && result < 0x80000000)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+//====================================================================
+// H::GetHashCode is tuned for modulo bucketing; fold the high bits
+// down so masking off the low bits still spreads pointer keys, whose
+// low bits are mostly zero.
+//====================================================================
+template <class K,class V,class A, class H>
+unsigned long FlatHashTable<K,V,A,H>::Hash(const K & key) const
+{
+    unsigned long hash = m_hashFunc.GetHashCode(key);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+//====================================================================
+// Returns the index of the slot holding key, or -1 if it is absent.
+//====================================================================
+template <class K,class V,class A, class H>
+long FlatHashTable<K,V,A,H>::FindSlot(const K & key, unsigned long hash) const
+{
+    const unsigned long mask = m_capacity - 1;
+    unsigned long idx = hash & mask;
+
+    for (unsigned long probes = 0; probes < m_capacity; ++probes)
+    {
+        const Slot & slot = m_rgSlots[idx];
+        if (FlatSlotEmpty == slot.m_state)
+        {
+            break;
+        }
+
+        if (FlatSlotOccupied == slot.m_state &&
+            slot.m_hash == hash &&
+            m_hashFunc.AreEqual(slot.m_kvp.Key(), key))
+        {
+            return (long)idx;
+        }
+
+        idx = (idx + 1) & mask;
+    }
+
+    return -1;
+}
+
+//====================================================================
+//
+//====================================================================
+template <class K,class V,class A, class H>
+void FlatHashTable<K,V,A,H>::Rehash(unsigned long newCapacity)
+{
+    unsigned long oldCapacity = m_capacity;
+    unsigned long oldCount = m_count;
+    Slot * oldSlots = m_rgSlots;
+
+    Slot * newSlots = m_alloc.AllocateArray<Slot>(newCapacity);
+    Assume(newSlots,L"Allocation failed in FlatHashTable<K,V,A,H>::Rehash.");
+    if (!newSlots)
+    {
+        return;
+    }
+
+    const unsigned long mask = newCapacity - 1;
+    for (unsigned long i = 0; i < oldCapacity; ++i)
+    {
+        if (FlatSlotOccupied == oldSlots[i].m_state)
+        {
+            unsigned long idx = oldSlots[i].m_hash & mask;
+            while (FlatSlotOccupied == newSlots[idx].m_state)
+            {
+                idx = (idx + 1) & mask;
+            }
+            newSlots[idx] = oldSlots[i];
+        }
+    }
+
+    m_rgSlots = newSlots;
+    m_capacity = newCapacity;
+    m_count = oldCount;
+    m_deleted = 0;
+
+    m_alloc.DeAllocateArray(oldSlots);
+}
+
 //====================================================================
 // This hash method was stolen from our string pool and works
 // really good for strings.  We need to verify that it's ok
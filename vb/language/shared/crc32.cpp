@@ -155,63 +155,76 @@ DWORD NewCRC32(
     return CRC32_LOOKUP_TABLE[ (BYTE)(crc ^ bNextByte) ] ^ (crc >> 8);
 }
 
-DWORD CRC32::Update(BYTE bNextByte)
+// Tables for the slice-by-4 loop: CRC32_SLICE_TABLE[k][i] is the CRC contribution
+// of byte value i when it is followed by k + 1 more bytes of the same word.
+// They are derived from CRC32_LOOKUP_TABLE, so the result is identical to
+// processing a byte at a time.
+static bool CRC32_SLICE_TABLE_INITIALIZED = false;
+
+static DWORD CRC32_SLICE_TABLE [3][256];
+
+static
+void initslicetables()
 {
     inittable();
-    m_CRC32 = NewCRC32(m_CRC32, bNextByte);
-    return m_CRC32;
+
+    if( !CRC32_SLICE_TABLE_INITIALIZED ) {
+        for (unsigned i = 0; i < 256; ++i) {
+            DWORD entry = CRC32_LOOKUP_TABLE[i];
+
+            for (unsigned k = 0; k < 3; ++k) {
+                entry = NewCRC32(entry, 0);
+                CRC32_SLICE_TABLE[k][i] = entry;
+            }
+        }
+        CRC32_SLICE_TABLE_INITIALIZED = true;
+    }
 }
 
-DWORD CRC32::Update(
-    const void * pBuffer,
+static
+DWORD UpdateCRC32(
+    DWORD dwCurrentCRC32,
+    const BYTE * pByte,
     size_t uLength)
 {
-    inittable();
-
-    // modifies the current state
-    DWORD dwCurrentCRC32 = m_CRC32;
-
-    const BYTE* pByte= (const BYTE*)pBuffer;
-    for(; uLength > 4; uLength-=4 ) {
-        // constant unrolling 4x dramatically helps the crc code
-        // beyond that there's not much gain
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
+    initslicetables();
+
+    // Fold in a whole word per step; the four table lookups are independent
+    // of each other, unlike the chain of lookups when going a byte at a time.
+    for(; uLength >= 4; uLength-=4, pByte+=4 ) {
+        dwCurrentCRC32 ^= (DWORD)pByte[0] | ((DWORD)pByte[1] << 8) | ((DWORD)pByte[2] << 16) | ((DWORD)pByte[3] << 24);
+        dwCurrentCRC32 =
+            CRC32_SLICE_TABLE[2][dwCurrentCRC32 & 0xFF] ^
+            CRC32_SLICE_TABLE[1][(dwCurrentCRC32 >> 8) & 0xFF] ^
+            CRC32_SLICE_TABLE[0][(dwCurrentCRC32 >> 16) & 0xFF] ^
+            CRC32_LOOKUP_TABLE[dwCurrentCRC32 >> 24];
     }
     // finish up the remainder
     for(; uLength > 0; uLength-- ) {
         dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
     }
-    m_CRC32 = dwCurrentCRC32;
     return dwCurrentCRC32;
 }
 
-// This function is nearly identical, but we win out on a few assignments
-// This is done for some speed (can avoid assigning m_CRC32 several times)
-CRC32::CRC32(
-    const void * pPtr,
-    size_t uLength)
+DWORD CRC32::Update(BYTE bNextByte)
 {
     inittable();
+    m_CRC32 = NewCRC32(m_CRC32, bNextByte);
+    return m_CRC32;
+}
 
-    // do not rely on the optimizer to treat m_CRC32 as a local variable
-    // assigned at the end
-    DWORD dwCurrentCRC32 = ~DWORD(0);
+DWORD CRC32::Update(
+    const void * pBuffer,
+    size_t uLength)
+{
+    // modifies the current state
+    m_CRC32 = UpdateCRC32(m_CRC32, (const BYTE*)pBuffer, uLength);
+    return m_CRC32;
+}
 
-    const BYTE* pByte= (const BYTE*)pPtr;
-    for(; uLength > 4; uLength-=4 ) {
-        // constant unrolling 4x dramatically helps the crc code
-        // beyond that there's not much gain
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-    }
-    // finish up the remainder
-    for (; uLength > 0; uLength-- ) {
-        dwCurrentCRC32 = NewCRC32(dwCurrentCRC32, *pByte++);
-    }
-    m_CRC32 = dwCurrentCRC32;
+CRC32::CRC32(
+    const void * pPtr,
+    size_t uLength)
+{
+    m_CRC32 = UpdateCRC32(~DWORD(0), (const BYTE*)pPtr, uLength);
 }
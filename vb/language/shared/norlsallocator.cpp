@@ -106,6 +106,9 @@ void NorlsAllocator::Init(ProtectedEntityFlagsEnum entity)
     anyPageMarkedReadOnly = false;
     inAllowingWrite = false;
     this->entity = entity;
+#if NRLSSTATS
+    ClearAllocStats();
+#endif NRLSSTATS
 }
 
 NorlsAllocator::~NorlsAllocator()
@@ -262,7 +265,7 @@ void NorlsAllocator::MakeAllHeapReadOnlyInternal()
     SetAllPagesWriteStatus(false);
 }
 
-void* NorlsAllocator::AllocNonZero(size_t sz)
+void* NorlsAllocator::AllocNonZeroSlow(size_t sz)
 {
     size_t roundedUpSize = sz;
     void* result = _AllocNonZero(roundedUpSize);
@@ -330,6 +333,9 @@ void* NorlsAllocator::_AllocNonZero(size_t& sz)
 #endif NRLSTRACK
     
     sz = roundSize;
+#if NRLSSTATS
+    m_stats.RecordAlloc(roundSize);
+#endif NRLSSTATS
 #if NRLSTRACK
     VSASSERT(m_dwAllocThreadId == 0," NorlsAlloc: only 1 thread allowed at a time");
     m_dwAllocThreadId = GetCurrentThreadId();
@@ -362,9 +368,9 @@ void* NorlsAllocator::_AllocNonZero(size_t& sz)
  *     allocation rounded up to a pointer multiple
  */
 
-void* NorlsAllocator::Alloc(size_t sz)
+void* NorlsAllocator::AllocSlow(size_t sz)
 {
-    void* buf = AllocNonZero(sz); //sz may be changed
+    void* buf = _AllocNonZero(sz); //sz may be changed
     return memset(buf, 0, sz);
 }
 
@@ -491,6 +497,10 @@ NorlsPage * NorlsAllocator::NewPage(size_t sz)
     // Allocate the new page.
     newPage = (NorlsPage *) m_heapPage.AllocPages(allocSize);
 
+#if NRLSSTATS
+    m_stats.RecordPage(allocSize);
+#endif NRLSSTATS
+
 #if DEBUG
     // Add buffer overflow detection
     newPage->sentinalStart = DEBUGSENTINAL; 
@@ -656,6 +666,44 @@ void NorlsAllocator::FreeHeap()
 
 }
 
+#if NRLSSTATS
+
+void NorlsAllocator::ClearAllocStats()
+{
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void NorlsAllocator::DumpAllocStats(_In_z_ const char *szPhase, bool fClear)
+{
+    DebPrintf("NorlsAllocator %p [%s] pages=%u bytes=%Iu largest=%Iu\n",
+              this,
+              szPhase,
+              m_stats.m_cPages,
+              m_stats.m_cbPages,
+              m_stats.m_cbLargestAlloc);
+
+    size_t cbClass = sizeof(void*);
+
+    for (unsigned iClass = 0; iClass < NorlsAllocStats::SizeClassCount; iClass++, cbClass <<= 1)
+    {
+        if (m_stats.m_cAllocs[iClass])
+        {
+            DebPrintf("    %s%6Iu allocs=%8u bytes=%10Iu\n",
+                      iClass == NorlsAllocStats::SizeClassCount - 1 ? ">" : "<=",
+                      iClass == NorlsAllocStats::SizeClassCount - 1 ? cbClass >> 1 : cbClass,
+                      m_stats.m_cAllocs[iClass],
+                      m_stats.m_cbAllocs[iClass]);
+        }
+    }
+
+    if (fClear)
+    {
+        ClearAllocStats();
+    }
+}
+
+#endif NRLSSTATS
+
 void
 NorlsAllocator::VerifyHeap()
 {
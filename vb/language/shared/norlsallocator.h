@@ -15,6 +15,10 @@
 //#define NRLSTRACK  DEBUG &&  !defined( VBDBGEE )  && !defined(NDEBUG) && !defined(BUILDING_VBC) && !defined(BUILDING_VB7TO8)
 //#define NRLSTRACK_GETSTACKS NRLSTRACK
 
+// set NRLSSTATS to 1 to keep a histogram of allocation sizes and a count of the pages
+// taken by each NorlsAllocator.  Cheap enough for retail, but off by default.
+//#define NRLSSTATS 1
+
 #if NRLSTRACK
 
 // we're tracking allocations.
@@ -90,6 +94,49 @@ struct NorlsPage
 #endif
 };
 
+#if NRLSSTATS
+
+// Allocation statistics for one NorlsAllocator.  Sizes are bucketed by
+// power of two, starting at the pointer size.
+struct NorlsAllocStats
+{
+    static const unsigned SizeClassCount = 12;
+
+    unsigned long m_cAllocs[SizeClassCount];   // allocations in each size class
+    size_t m_cbAllocs[SizeClassCount];         // bytes handed out in each size class
+    unsigned long m_cPages;                    // pages taken from the PageHeap
+    size_t m_cbPages;                          // bytes taken from the PageHeap
+    size_t m_cbLargestAlloc;
+
+    void RecordAlloc(size_t roundSize)
+    {
+        unsigned iClass = 0;
+        size_t cbClass = sizeof(void*);
+
+        while (cbClass < roundSize && iClass < SizeClassCount - 1)
+        {
+            cbClass <<= 1;
+            iClass++;
+        }
+
+        m_cAllocs[iClass]++;
+        m_cbAllocs[iClass] += roundSize;
+
+        if (roundSize > m_cbLargestAlloc)
+        {
+            m_cbLargestAlloc = roundSize;
+        }
+    }
+
+    void RecordPage(size_t cbPage)
+    {
+        m_cPages++;
+        m_cbPages += cbPage;
+    }
+};
+
+#endif NRLSSTATS
+
 class NorlsMark
 {
 private:
@@ -236,8 +283,48 @@ public:
         return false;
     }
 
-    void* AllocNonZero(size_t sz); 
-    void* Alloc(size_t sz);
+    // The common case, where the request fits in the current page and no page
+    // has been made read-only, is handled inline.  Everything else (the first
+    // allocation, a new page, write protection, zero-sized requests, and the
+    // DEBUG and NRLSTRACK bookkeeping) goes through the out-of-line versions.
+    void* AllocNonZero(size_t sz)
+    {
+#if !DEBUG && !NRLSTRACK
+        size_t roundSize = VBMath::RoundUpAllocSize(sz);
+
+        if (sz != 0 && roundSize <= (size_t)(limitFree - nextFree) && !anyPageMarkedReadOnly)
+        {
+            void * p = nextFree;
+            nextFree += roundSize;
+#if NRLSSTATS
+            m_stats.RecordAlloc(roundSize);
+#endif
+            return p;
+        }
+#endif
+
+        return AllocNonZeroSlow(sz);
+    }
+
+    void* Alloc(size_t sz)
+    {
+#if !DEBUG && !NRLSTRACK
+        size_t roundSize = VBMath::RoundUpAllocSize(sz);
+
+        if (sz != 0 && roundSize <= (size_t)(limitFree - nextFree) && !anyPageMarkedReadOnly)
+        {
+            void * p = nextFree;
+            nextFree += roundSize;
+#if NRLSSTATS
+            m_stats.RecordAlloc(roundSize);
+#endif
+            return memset(p, 0, roundSize);
+        }
+#endif
+
+        return AllocSlow(sz);
+    }
+
     template <typename T>
     T* Alloc()
     {
@@ -262,6 +349,18 @@ public:
     void FreeHeap();
     size_t CalcCommittedSize () const;
     const WCHAR* GetDebugIdentifier() const;
+
+#if NRLSSTATS
+    const NorlsAllocStats & GetAllocStats() const
+    {
+        return m_stats;
+    }
+
+    // Dumps the histogram to the debug output, tagged with szPhase, and
+    // optionally starts over so that the next dump covers the next phase only.
+    void DumpAllocStats(_In_z_ const char *szPhase, bool fClear = true);
+    void ClearAllocStats();
+#endif NRLSSTATS
 #if NRLSTRACK
     WCHAR *m_szFile;
     long m_nLineNo;
@@ -297,6 +396,9 @@ private:
     //'sz' [in/out] returns the true allocation size
     void* _AllocNonZero(size_t& sz); 
 
+    void* AllocNonZeroSlow(size_t sz);
+    void* AllocSlow(size_t sz);
+
     void DisallowReadOnlyDirectivesInternal()
     {
         allowReadOnlyDirectives = false;
@@ -336,6 +438,10 @@ private:
     bool anyPageMarkedReadOnly;
     bool inAllowingWrite;
 
+#if NRLSSTATS
+    NorlsAllocStats m_stats;
+#endif NRLSSTATS
+
 #ifdef DEBUG
     inline size_t DebugSize (size_t sz) const
     {
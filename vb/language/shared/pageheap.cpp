@@ -88,11 +88,26 @@ bool PageHeap::PageArena::HasUsedPages() const
     return false;
 }
 
+size_t PageHeap::PageArena::CountCommittedPages() const
+{
+    size_t cPages = 0;
+
+    for (unsigned int iPage = 0; iPage < PAGES_PER_ARENA; iPage++)
+    {
+        if (IsPageCommitted(iPage))
+            cPages++;
+    }
+
+    return cPages;
+}
+
 PageHeap::PageHeap() :
 m_pageCurUse(0),
 m_pageMaxUse(0),
 m_pageCurReserve(0),
 m_pageMaxReserve(0),
+m_pageCurCommit(0),
+m_cbShrinkThreshold(0),
 arenaList(NULL),
 arenaLast(NULL),
 singlePageArenaList(NULL),
@@ -128,6 +143,33 @@ void PageHeap::ShrinkUnusedResources()
 #endif
 }
 
+bool PageHeap::ShrinkUnusedResourcesOverThreshold()
+{
+    CTinyGate gate (&lock); // Acquire the lock
+
+    VSASSERT(m_pageCurCommit >= m_pageCurUse, "Invalid");
+
+    if ((m_pageCurCommit - m_pageCurUse) * pageSize <= m_cbShrinkThreshold)
+    {
+        return false;
+    }
+
+    ShrinkUnusedResources();
+    return true;
+}
+
+void PageHeap::NotifyMemoryPressure(MemoryPressureLevel level)
+{
+    if (level == HighMemoryPressure)
+    {
+        ShrinkUnusedResources();
+    }
+    else
+    {
+        DecommitUnusedPages();
+    }
+}
+
 // Microsoft Search a segment of pages in an arena for cPages of contiguous free pages.
 int PageHeap::PageArena::LookForPages(unsigned int cPages, int indexPageBegin, int indexLastValidPage)
 {
@@ -190,14 +232,16 @@ void * PageHeap::PageArena::AllocPagesHelper(int iPage, unsigned int cPages, Pag
 {
     size_t cBytes = cPages << pageShift;
     void* p = (BYTE *)pages + (iPage << pageShift);    // Calculate address of allocation.
-    bool allCommitted = true;
+    unsigned cUncommitted = 0;
 
-    for (unsigned i = 0; i < cPages && allCommitted; i++)
+    for (unsigned i = 0; i < cPages; i++)
     {
         if (! (IsPageCommitted(iPage + i)))
-            allCommitted = false;
+            cUncommitted++;
     }
 
+    bool allCommitted = (cUncommitted == 0);
+
     //  Commit the pages from the OS if needed.
     if (!allCommitted)
     {
@@ -213,6 +257,8 @@ void * PageHeap::PageArena::AllocPagesHelper(int iPage, unsigned int cPages, Pag
                 VbThrow(GetLastHResultError());
             }
         }
+
+        parent.m_pageCurCommit += cUncommitted;
     }
     if (!reliableCommit || allCommitted)
     {
@@ -388,7 +434,9 @@ void PageHeap::FreeUnusedArenas()
         if (!arena->HasUsedPages())
         {
             //unlink from list.
+            addressToArenaMap.erase(arena->pages);
             RemoveArena(arena, arenaList, arenaLast);
+            m_pageCurCommit -= arena->CountCommittedPages();
             size_t addressSpace = arena->GetAddressSpaceSize();
             arena->FreeAddressSpace();
             m_pageCurReserve -= addressSpace / pageSize;
@@ -409,6 +457,7 @@ void PageHeap::FreeUnusedArenas()
             // Unlink from list and delete the arena
             addressToSinglePageArenaMap.erase(arena->pages);
             RemoveArena(arena, singlePageArenaList, singlePageArenaLast);
+            m_pageCurCommit -= arena->CountCommittedPages();
             size_t addressSpace = arena->GetAddressSpaceSize();
             arena->FreeAddressSpace();                       // sets arena->pages = NULL
             m_pageCurReserve -= addressSpace / pageSize;
@@ -520,6 +569,7 @@ void* PageHeap::LargeAlloc(size_t sz)
     CTinyGate gate (&lock); // Acquire the lock
     // Create an arena for this large allocation.
     PageArena* newArena = CreateArena(LargeAllocation, sz);
+    m_pageCurCommit += sz / pageSize;
 
 #ifdef DEBUG
     // Make sure they aren't zero filled.
@@ -540,6 +590,9 @@ void PageHeap::LargeFree(void * p, size_t sz)
     VSASSERT(arena && arena->type == LargeAllocation && arena->pages == p && arena->size == sz, "Invalid");
 
     m_pageCurReserve -= sz / pageSize;
+    m_pageCurCommit -= sz / pageSize;
+
+    addressToArenaMap.erase(arena->pages);
 
     // Free the pages.
     BOOL b;
@@ -681,10 +734,11 @@ void PageHeap::FreeAllPages(bool checkLeaks)
     FreeArenaList(arenaList, checkLeaks);
     FreeArenaList(singlePageArenaList, checkLeaks);
 
-    m_pageCurUse = m_pageCurReserve = 0;
+    m_pageCurUse = m_pageCurReserve = m_pageCurCommit = 0;
     arenaList = arenaLast = NULL;
     singlePageArenaList = singlePageArenaLast = NULL;
 
+    addressToArenaMap.clear();
     addressToSinglePageArenaMap.clear();  
     singlePageArenasWithFreePages = std::queue<SinglePageArena*>();
 }
@@ -706,6 +760,12 @@ bool PageHeap::DecommitUnusedPagesFromArenaList(PageArena* list)
             // Can we decommit 32 pages at once with one OS call?
             if (arena->used[dwIndex] == 0 && arena->committed[dwIndex] != 0)
             {
+                size_t cCommitted = 0;
+                for (DWORD bits = arena->committed[dwIndex]; bits; bits &= bits - 1)
+                {
+                    cCommitted++;
+                }
+
 #pragma warning (push)
 #pragma warning (disable: 6250)
                 b = VirtualFree((BYTE *)arena->pages + ((dwIndex * BITS_DWORD) << pageShift),
@@ -717,6 +777,7 @@ bool PageHeap::DecommitUnusedPagesFromArenaList(PageArena* list)
                 {
                     anyDecommitted = true;
                     arena->committed[dwIndex] = 0;
+                    m_pageCurCommit -= cCommitted;
                 }
             }
             else if (arena->used[dwIndex] != arena->committed[dwIndex])
@@ -736,6 +797,7 @@ bool PageHeap::DecommitUnusedPagesFromArenaList(PageArena* list)
                         {
                             anyDecommitted = true;
                             arena->committed[iPage >> DWORD_BIT_SHIFT] &= ~(1 << (iPage & DWORD_BIT_MASK));
+                            m_pageCurCommit--;
                         }
                     }
                 }
@@ -845,6 +907,12 @@ PageHeap::PageArena * PageHeap::CreateArena(PageArenaType type, size_t sz)
         addressToSinglePageArenaMap[newSinglePageArena->pages] = newSinglePageArena;
         singlePageArenasWithFreePages.push(newSinglePageArena);
     }
+    else
+    {
+        VSASSERT(addressToArenaMap.find(newArena->pages) == addressToArenaMap.end(),
+            "We shouldn't already have an arena for this address");
+        addressToArenaMap[newArena->pages] = newArena;
+    }
 
     m_pageCurReserve += sz / pageSize;
     if (m_pageCurReserve > m_pageMaxReserve)
@@ -863,10 +931,14 @@ PageHeap::PageArena * PageHeap::CreateArena(PageArenaType type, size_t sz)
 */
 PageHeap::PageArena * PageHeap::FindArena(const void * p)
 {
-    PageArena * arena;
+    // p belongs to the closest arena whose first page is <= p, and upper_bound returns
+    // the first arena whose first page is strictly greater than p.
+    std::map<void *, PageArena*>::const_iterator it = addressToArenaMap.upper_bound(const_cast<void *>(p));
 
-    for (arena = arenaList; arena != NULL; arena = arena->nextArena)
+    if (it != addressToArenaMap.begin())
     {
+        PageArena * arena = (--it)->second;
+
         if (arena->OwnsPage(p))
             return arena;
     }
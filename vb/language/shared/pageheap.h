@@ -83,6 +83,7 @@ public:
         }
 
         bool HasUsedPages() const;
+        size_t CountCommittedPages() const;
 
         size_t GetAddressSpaceSize() const
         {
@@ -151,6 +152,29 @@ public:
     void FreeUnusedArenas();
     // Microsoft this call first decommits unused pages and then frees unused arenas.
     void ShrinkUnusedResources();
+    // Like ShrinkUnusedResources, but only when more than the shrink threshold of
+    // committed memory is unused. Lets hosts that shrink after every unit of work
+    // keep a working set of pages around for the next one.
+    bool ShrinkUnusedResourcesOverThreshold();
+
+    size_t GetShrinkThreshold() const
+    {
+        return m_cbShrinkThreshold;
+    }
+    void SetShrinkThreshold(size_t cbThreshold)
+    {
+        m_cbShrinkThreshold = cbThreshold;
+    }
+
+    enum MemoryPressureLevel
+    {
+        ModerateMemoryPressure,     // decommit unused pages
+        HighMemoryPressure          // also return unused address space
+    };
+
+    // For hosts that learn about memory pressure from outside (e.g. a low memory
+    // notification); releases unused resources regardless of the shrink threshold.
+    void NotifyMemoryPressure(MemoryPressureLevel level);
 
     static size_t pageSize;         // The system page size.
 
@@ -170,6 +194,10 @@ public:
     {
         return (unsigned)(m_pageMaxReserve * pageSize);
     }
+    unsigned GetCurrentCommitSize() const
+    {
+        return (unsigned)(m_pageCurCommit * pageSize);
+    }
 
     PageArena* FindArena(const void * p);
 
@@ -203,6 +231,9 @@ private:
     PageArena* arenaList;          // List of memory arenas.
     PageArena* arenaLast;          // Last memory arena in list.
 
+    // used to efficiently find the arena (normal or large allocation) a freed memory address belonged to
+    std::map<void *, PageArena*> addressToArenaMap;
+
     ProtectedEntityFlagsEnum whatIsProtected;
 
     static int pageShift;           // log2 of the page size
@@ -210,4 +241,6 @@ private:
 
     size_t m_pageCurUse, m_pageMaxUse;
     size_t m_pageCurReserve, m_pageMaxReserve;
+    size_t m_pageCurCommit;
+    size_t m_cbShrinkThreshold;
 };
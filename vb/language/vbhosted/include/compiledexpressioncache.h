@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CompilerContext.h"
+
+namespace Microsoft 
+{ 
+    namespace Compiler 
+    { 
+        namespace VisualBasic
+        {
+            // Most-recently-used cache of the code blocks produced for expressions that
+            // compiled without errors or warnings. Entries are keyed by the expression
+            // text, the CompilerContext instance and the target type. The context is
+            // compared by identity because its scopes are host callbacks whose answers
+            // cannot be inspected, so the host must clear the cache whenever a context
+            // it reuses starts resolving names differently.
+            private ref class CompiledExpressionCache sealed
+            {
+            private:
+                typedef System::Tuple<System::String ^, CompilerContext ^, System::Type ^> CacheKey;
+                typedef System::Collections::Generic::KeyValuePair<CacheKey ^, System::Linq::Expressions::LambdaExpression ^> CacheEntry;
+
+                void TrimToCapacity();
+
+                int m_capacity;
+
+                // Most recently used entry first.
+                System::Collections::Generic::LinkedList<CacheEntry> ^m_entries;
+                System::Collections::Generic::Dictionary<CacheKey ^, System::Collections::Generic::LinkedListNode<CacheEntry> ^> ^m_index;
+
+            public:
+                CompiledExpressionCache();
+
+                // Maximum number of cached code blocks. Zero disables the cache.
+                property int Capacity {
+                    int get();
+                    void set(int value);
+                }
+
+                System::Linq::Expressions::LambdaExpression ^Lookup(System::String ^expression,
+                                                                     CompilerContext ^context,
+                                                                     System::Type ^targetType);
+
+                void Add(System::String ^expression,
+                         CompilerContext ^context,
+                         System::Type ^targetType,
+                         System::Linq::Expressions::LambdaExpression ^codeBlock);
+
+                void Clear();
+            };
+        }
+    }
+}
@@ -23,11 +23,30 @@ namespace Microsoft
                                        gcroot<System::Type ^> targetType,
                                        gcroot<CompilerResults ^> results);
 
+                // Compiles each expression against the same context, filling in the
+                // corresponding element of results (which must be as long as expressions).
+                // Null or empty expressions are skipped and leave their results empty.
+                void CompileExpressions(gcroot<array<System::String ^> ^> expressions, 
+                                        gcroot<CompilerContext ^> context,
+                                        gcroot<System::Type ^> targetType,
+                                        gcroot<array<CompilerResults ^> ^> results);
+
                 void CompileStatements(gcroot<System::String ^> statements, 
                                        gcroot<CompilerContext ^> context,
                                        gcroot<CompilerResults ^> results);
 
+                bool IsInvalid()
+                {
+                    return m_fInvalid;
+                }
+
             private:
+                void CompileExpression(gcroot<System::String ^> expression, 
+                                       VbContext *pContext,
+                                       gcroot<System::Type ^> targetType,
+                                       gcroot<CompilerResults ^> results,
+                                       bool fInBatch);
+
                 VbHostedCompiler m_VbHostedCompiler;
 
                 // Do not want to support copy semantics for this class, so 
@@ -3,6 +3,7 @@
 #include "CompilerResults.h"
 #include "CompilerContext.h"
 #include "CompilerBridge.h"
+#include "CompiledExpressionCache.h"
 
 #ifdef DEBUG
 #define TRACE
@@ -22,6 +23,9 @@ namespace Microsoft
 	        {
             private:
                 CompilerBridge *m_pCompilerBridge;
+                CompiledExpressionCache ^m_expressionCache;
+
+                static bool IsCacheable(CompilerResults ^results);
 
 #ifdef TRACE
 				System::Diagnostics::BooleanSwitch ^tracePageHeap;
@@ -36,6 +40,38 @@ namespace Microsoft
                 ~HostedCompiler();
 
                 void CheckInvalid();
+
+            internal:
+                // True once the compiler has failed with an internal error; every later
+                // compilation on this instance will throw.
+                property bool IsInvalid {
+                    bool get();
+                }
+
+            public:
+                // Number of successfully compiled expressions whose code blocks are kept and
+                // returned again when the same expression text is compiled with the same
+                // CompilerContext instance and target type. Zero (the default) disables caching.
+                property int ExpressionCacheCapacity {
+                    int get();
+                    void set(int value);
+                }
+
+                // Must be called when a CompilerContext that is passed again may now resolve
+                // names, types or variables differently than it did before.
+                void ClearExpressionCache();
+
+                // Bytes of unused, committed compiler memory that are kept (shared by all
+                // instances in the process) after each compilation instead of being returned
+                // to the OS. Zero (the default) releases all unused memory every time.
+                static property int RetainedMemoryThreshold {
+                    int get();
+                    void set(int value);
+                }
+
+                // Releases unused compiler memory now. When high is true, unused address
+                // space is returned as well.
+                static void NotifyMemoryPressure(bool high);
                 
                 CompilerResults ^CompileExpression(System::String ^expression, 
                                                    CompilerContext ^context);
@@ -43,6 +79,12 @@ namespace Microsoft
                 CompilerResults ^CompileExpression(System::String ^expression, 
                                                    CompilerContext ^context,
                                                    System::Type ^targetType);
+
+                // Compiles many expressions that share one context. The results are in
+                // the same order as the expressions.
+                array<CompilerResults ^> ^CompileExpressions(array<System::String ^> ^expressions, 
+                                                             CompilerContext ^context,
+                                                             System::Type ^targetType);
 	        };
         }
     }
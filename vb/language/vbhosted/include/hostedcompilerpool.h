@@ -0,0 +1,44 @@
+#pragma once
+
+#include "HostedCompiler.h"
+
+namespace Microsoft 
+{ 
+    namespace Compiler 
+    { 
+        namespace VisualBasic
+        {
+            // A fixed set of HostedCompiler instances over the same reference assemblies,
+            // for hosts that compile from many threads. A HostedCompiler must only be used
+            // by one thread at a time; CheckOut hands an idle instance to the calling thread
+            // (waiting for one if all are in use) and CheckIn returns it to the pool.
+#if USEPRIVATE
+            private ref class HostedCompilerPool sealed
+#else
+            public ref class HostedCompilerPool sealed
+#endif
+            {
+            private:
+                System::Collections::Generic::IList<System::Reflection::Assembly ^> ^m_referenceAssemblies;
+                System::Collections::Generic::Stack<HostedCompiler ^> ^m_idle;
+                System::Collections::Generic::List<HostedCompiler ^> ^m_all;
+                bool m_fDisposed;
+
+                HostedCompiler ^CreateCompiler();
+
+            public:
+                // Creates size compilers and compiles a trivial expression with each so that
+                // mscorlib and the reference assemblies are imported before the first CheckOut.
+                HostedCompilerPool(System::Collections::Generic::IList<System::Reflection::Assembly ^> ^referenceAssemblies,
+                                   int size);
+
+                ~HostedCompilerPool();
+
+                HostedCompiler ^CheckOut();
+
+                // A compiler that failed with an internal error is replaced by a new instance.
+                void CheckIn(HostedCompiler ^compiler);
+            };
+        }
+    }
+}
@@ -22,6 +22,11 @@ namespace Microsoft
                 AssemblyBuilder^ m_assemblyBuilder;
                 ModuleBuilder^ m_moduleBuilder;
 
+                //Members looked up without a binding context, reused for every reference
+                System::Collections::Generic::Dictionary<System::IntPtr, System::Reflection::MethodInfo^>^ m_methods;
+                System::Collections::Generic::Dictionary<System::IntPtr, System::Reflection::ConstructorInfo^>^ m_constructors;
+                System::Collections::Generic::Dictionary<System::IntPtr, System::Reflection::FieldInfo^>^ m_fields;
+
             public:
                 ~SymbolMap();
                 System::Type^ GetType(BCSYM* pSymbol);
@@ -43,6 +48,10 @@ namespace Microsoft
                     AnonymousDelegateEmitter^ get();
                 }
 
+                System::Reflection::MethodInfo^ LookupMethod(BCSYM_Proc * pMethodSymbol, GenericBinding* pBindingContext);
+                System::Reflection::ConstructorInfo^ LookupConstructor(BCSYM_Proc * pConstructorSymbol, GenericTypeBinding* pBindingContext);
+                System::Reflection::FieldInfo^ LookupField(BCSYM_Variable * pFieldSymbol, GenericTypeBinding* pBindingContext);
+
                 System::Type^ GetType(BCSYM* pSymbol, GenericBinding* pBindingContext);
                 System::Type^ GetAnonymousType(BCSYM_GenericTypeBinding* pSymbol);
                 System::Type^ GetAnonymousDelegate(BCSYM* pSymbol);
@@ -24,6 +24,12 @@ namespace Microsoft
                 TypeEmitter(SymbolMap^ symbolMap, ModuleBuilder^ moduleBuilder);
                 virtual bool TryGetType(BCSYM_NamedRoot* pSymbol, System::Type^% type) abstract;
 
+                //Anonymous types and delegates with the same shape are emitted once per process
+                //and reused by every hosted compilation.
+                static System::String^ GetShapeKey(BCSYM_NamedRoot* pSymbol);
+                static bool TryGetSharedType(System::String^ shapeKey, System::Type^% type);
+                static System::Type^ AddSharedType(System::String^ shapeKey, System::Type^ type);
+
             protected:
                 property ModuleBuilder^ DynamicModuleBuilder{
                     ModuleBuilder^ get();
@@ -31,6 +37,13 @@ namespace Microsoft
 
                 static System::Type^ VoidType;
 
+            private:
+                static initonly System::Collections::Generic::Dictionary<System::String^, System::Type^>^ SharedTypes;
+
+                static void AppendShape(System::Text::StringBuilder^ shape, BCSYM* pSymbol);
+
+            protected:
+
                 virtual TypeBuilder^ DefineType(BCSYM_NamedRoot* pSymbol);
                 virtual void DefineGenericTypeParameter(TypeBuilder^ typeBuilder, GenericTypeParameterBuilder^ paramBuilder, BCSYM_GenericParam* pParam);
                 virtual FieldBuilder^ DefineField(TypeBuilder^ typeBuilder, BCSYM_Variable* pField);
@@ -13,6 +13,13 @@ public:
     virtual ~VbHostedCompiler();
 
     STDMETHODIMP CompileExpression(/*[in]*/ BSTR Expression, /*[in]*/ VbContext *pContext, /*[in]*/ gcroot<System::Type ^> TargetType, /*[in,out]*/ VbParsed *pParsed);
+
+    // Same as CompileExpression, but leaves the unused page heap resources in place
+    // so that a batch of expressions does not release and re-reserve pages for every
+    // expression. Call EndExpressionBatch once the batch is complete.
+    STDMETHODIMP CompileExpressionInBatch(/*[in]*/ BSTR Expression, /*[in]*/ VbContext *pContext, /*[in]*/ gcroot<System::Type ^> TargetType, /*[in,out]*/ VbParsed *pParsed);
+    void EndExpressionBatch();
+
     STDMETHODIMP CompileStatements(/*[in]*/ BSTR Statements, /*[in]*/ VbContext *pContext, /*[in,out]*/ VbParsed *pParsed);
     
 private:
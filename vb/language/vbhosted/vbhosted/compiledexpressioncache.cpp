@@ -0,0 +1,77 @@
+#include "stdafx.h"
+
+using namespace Microsoft::Compiler::VisualBasic;
+
+CompiledExpressionCache::CompiledExpressionCache() :
+    m_capacity(0)
+{
+    m_entries = gcnew System::Collections::Generic::LinkedList<CacheEntry>();
+    m_index = gcnew System::Collections::Generic::Dictionary<CacheKey ^, System::Collections::Generic::LinkedListNode<CacheEntry> ^>();
+}
+
+int CompiledExpressionCache::Capacity::get()
+{
+    return m_capacity;
+}
+
+void CompiledExpressionCache::Capacity::set(int value)
+{
+    if (value < 0)
+        throw gcnew System::ArgumentOutOfRangeException("value");
+
+    m_capacity = value;
+    TrimToCapacity();
+}
+
+System::Linq::Expressions::LambdaExpression ^CompiledExpressionCache::Lookup(System::String ^expression,
+                                                                             CompilerContext ^context,
+                                                                             System::Type ^targetType)
+{
+    System::Collections::Generic::LinkedListNode<CacheEntry> ^node = nullptr;
+
+    if (m_capacity > 0 && m_index->TryGetValue(gcnew CacheKey(expression, context, targetType), node))
+    {
+        m_entries->Remove(node);
+        m_entries->AddFirst(node);
+        return node->Value.Value;
+    }
+
+    return nullptr;
+}
+
+void CompiledExpressionCache::Add(System::String ^expression,
+                                  CompilerContext ^context,
+                                  System::Type ^targetType,
+                                  System::Linq::Expressions::LambdaExpression ^codeBlock)
+{
+    if (m_capacity == 0 || codeBlock == nullptr)
+        return;
+
+    CacheKey ^key = gcnew CacheKey(expression, context, targetType);
+    System::Collections::Generic::LinkedListNode<CacheEntry> ^node = nullptr;
+
+    if (m_index->TryGetValue(key, node))
+    {
+        m_entries->Remove(node);
+    }
+
+    node = m_entries->AddFirst(CacheEntry(key, codeBlock));
+    m_index[key] = node;
+
+    TrimToCapacity();
+}
+
+void CompiledExpressionCache::Clear()
+{
+    m_entries->Clear();
+    m_index->Clear();
+}
+
+void CompiledExpressionCache::TrimToCapacity()
+{
+    while (m_entries->Count > m_capacity)
+    {
+        m_index->Remove(m_entries->Last->Value.Key);
+        m_entries->RemoveLast();
+    }
+}
@@ -18,10 +18,43 @@ void CompilerBridge::CompileExpression(gcroot<System::String ^> expression,
                                        gcroot<CompilerContext ^> context,
                                        gcroot<System::Type ^> targetType,
                                        gcroot<CompilerResults ^> results)
+{
+    VbContext Context(context);
+
+    CompileExpression(expression, &Context, targetType, results, false /* fInBatch */);
+}
+
+void CompilerBridge::CompileExpressions(gcroot<array<System::String ^> ^> expressions, 
+                                        gcroot<CompilerContext ^> context,
+                                        gcroot<System::Type ^> targetType,
+                                        gcroot<array<CompilerResults ^> ^> results)
+{
+    VbContext Context(context);
+    array<System::String ^> ^expressionArray = expressions;
+    array<CompilerResults ^> ^resultArray = results;
+
+    ASSERT(expressionArray->Length == resultArray->Length, "[CompilerBridge::CompileExpressions] 'results' does not match 'expressions'");
+
+    for (int i = 0; i < expressionArray->Length; i++)
+    {
+        if (!System::String::IsNullOrEmpty(expressionArray[i]))
+        {
+            CompileExpression(expressionArray[i], &Context, targetType, resultArray[i], true /* fInBatch */);
+        }
+    }
+
+    // Release the page heap resources once for the whole batch.
+    m_VbHostedCompiler.EndExpressionBatch();
+}
+
+void CompilerBridge::CompileExpression(gcroot<System::String ^> expression, 
+                                       VbContext *pContext,
+                                       gcroot<System::Type ^> targetType,
+                                       gcroot<CompilerResults ^> results,
+                                       bool fInBatch)
 {
     HRESULT hr = S_OK;
     CComBSTR bstrExpression;
-    VbContext Context(context);
     VbParsed Parsed;
     pin_ptr<const wchar_t> pExpression = nullptr;
 
@@ -39,7 +72,14 @@ void CompilerBridge::CompileExpression(gcroot<System::String ^> expression,
         IfFailGoto(bstrExpression.Append((LPCOLESTR) pExpression, expression->Length), Exit);
         ASSERT(SUCCEEDED(hr), "memory allocation error copying expression to BSTR");
 
-        IfFailGoto(m_VbHostedCompiler.CompileExpression(bstrExpression, &Context, targetType, &Parsed), Exit);
+        if (fInBatch)
+        {
+            IfFailGoto(m_VbHostedCompiler.CompileExpressionInBatch(bstrExpression, pContext, targetType, &Parsed), Exit);
+        }
+        else
+        {
+            IfFailGoto(m_VbHostedCompiler.CompileExpression(bstrExpression, pContext, targetType, &Parsed), Exit);
+        }
 
         // translate pResults to results
         IfFailGoto(Parsed.CopyErrorsToResults(results), Exit);
@@ -1297,8 +1297,7 @@ DLRExpressionTree* DLRTreeETGenerator::CreateStringConstantExpr
     {
         ManagedString = gcnew System::String(Value, 0, LengthInCharacters);
     }
-    Expression^ Expr = Expression::Constant(ManagedString, System::String::typeid);
-    return ToDLRExpressionTree(Expr);
+    return ToInternedConstantExpr(ManagedString, System::String::typeid);
 }
 
 DLRExpressionTree* DLRTreeETGenerator::CreateIntegralConstantExpr
@@ -1363,9 +1362,7 @@ DLRExpressionTree* DLRTreeETGenerator::CreateIntegralConstantExpr
         ManagedValue = System::Enum::Parse(ManagedType, System::Convert::ToString(ManagedValue, System::Globalization::CultureInfo::InvariantCulture->NumberFormat));
     }
 
-    Expression^ Expr = Expression::Constant(ManagedValue, ManagedType);
-
-    return ToDLRExpressionTree(Expr);
+    return ToInternedConstantExpr(ManagedValue, ManagedType);
 }
 
 DLRExpressionTree* DLRTreeETGenerator::CreateFloatingPointConstantExpr
@@ -1429,9 +1426,7 @@ DLRExpressionTree* DLRTreeETGenerator::CreateBooleanConstantExpr
     const Location &Loc
 )
 {
-    Expression^ Expr = Expression::Constant(gcnew System::Boolean(Value), System::Boolean::typeid);
-
-    return ToDLRExpressionTree(Expr);
+    return ToInternedConstantExpr(gcnew System::Boolean(Value), System::Boolean::typeid);
 }
 
 DLRExpressionTree* DLRTreeETGenerator::CreateCharConstantExpr
@@ -1441,9 +1436,7 @@ DLRExpressionTree* DLRTreeETGenerator::CreateCharConstantExpr
     const Location &Loc
 )
 {
-    Expression^ Expr = Expression::Constant(gcnew System::Char(Value), System::Char::typeid);
-
-    return ToDLRExpressionTree(Expr);
+    return ToInternedConstantExpr(gcnew System::Char(Value), System::Char::typeid);
 }
 
 DLRExpressionTree* DLRTreeETGenerator::CreateDateConstantExpr
@@ -1453,9 +1446,7 @@ DLRExpressionTree* DLRTreeETGenerator::CreateDateConstantExpr
     const Location &Loc
 )
 {
-    Expression^ Expr = Expression::Constant(gcnew System::DateTime(Value), System::DateTime::typeid);
-
-    return ToDLRExpressionTree(Expr);
+    return ToInternedConstantExpr(gcnew System::DateTime(Value), System::DateTime::typeid);
 }
 
 DLRExpressionTree* DLRTreeETGenerator::CreateNothingConstantExpr
@@ -1468,9 +1459,7 @@ DLRExpressionTree* DLRTreeETGenerator::CreateNothingConstantExpr
     ThrowIfNull(NothingType);
 
     System::Type^ ManagedType = GetTypeRef(NothingType);
-    Expression^ Expr = Expression::Constant(nullptr, ManagedType);
-
-    return ToDLRExpressionTree(Expr);
+    return ToInternedConstantExpr(nullptr, ManagedType);
 }
 
 DLRExpressionTree* DLRTreeETGenerator::CreateTypeRefExpr
@@ -1483,9 +1472,7 @@ DLRExpressionTree* DLRTreeETGenerator::CreateTypeRefExpr
     ThrowIfNull(TypeSymbol);
 
     System::Type^ ManagedType = GetTypeRef(TypeSymbol);
-    Expression^ Expr = Expression::Constant(ManagedType, System::Type::typeid);
-
-    return ToDLRExpressionTree(Expr);
+    return ToInternedConstantExpr(ManagedType, System::Type::typeid);
 }
 
 DLRExpressionTree* DLRTreeETGenerator::CreateMethodRefExpr
@@ -1777,3 +1764,32 @@ Expression^ DLRTreeETGenerator::FromDLRExpressionTree
 
     return m_ExprMap->default[Key];
 }
+
+// Floating point and decimal constants are not interned: 0.0 equals -0.0 and
+// 1.0 equals 1.00 even though they are different constants.
+DLRExpressionTree* DLRTreeETGenerator::ToInternedConstantExpr
+(
+    System::Object^ Value,
+    System::Type^ ManagedType
+)
+{
+    ThrowIfNull(ManagedType);
+
+    ConstantKey^ Key = gcnew ConstantKey(ManagedType, Value);
+    unsigned ExprKey = 0;
+
+    if (!m_ConstantMap->TryGetValue(Key, ExprKey))
+    {
+        DLRExpressionTree *ExprTree = ToDLRExpressionTree(Expression::Constant(Value, ManagedType));
+
+#pragma warning (push)
+#pragma warning (disable:4311)
+#pragma warning (disable:4302)
+        ExprKey = (unsigned)ExprTree;
+#pragma warning (pop)
+
+        m_ConstantMap->Add(Key, ExprKey);
+    }
+
+    return (DLRExpressionTree *)ExprKey;
+}
@@ -21,6 +21,8 @@ using System::Linq::Expressions::MemberAssignment;
 
 typedef struct{} DLRExpressionTree;
 typedef System::Collections::Generic::Dictionary<unsigned, Expression^> IntToExprDictionary;
+typedef System::Tuple<System::Type^, System::Object^> ConstantKey;
+typedef System::Collections::Generic::Dictionary<ConstantKey^, unsigned> ConstantToKeyDictionary;
 
 class DLRTreeETGenerator : public ExpressionTreeGenerator<DLRExpressionTree>
 {
@@ -35,6 +37,7 @@ public:
         ThrowIfNull(Allocator);
 
         m_ExprMap = gcnew IntToExprDictionary();
+        m_ConstantMap = gcnew ConstantToKeyDictionary();
 
         m_UnmanagedToManagedSymbolMap =
             gcnew Microsoft::Compiler::VisualBasic::SymbolMap();
@@ -544,6 +547,12 @@ private:
         DLRExpressionTree *ExprTree
     );
 
+    DLRExpressionTree* ToInternedConstantExpr
+    (
+        System::Object^ Value,
+        System::Type^ ManagedType
+    );
+
 private:
 
     // Data members
@@ -553,6 +562,10 @@ private:
     unsigned m_NextAvailableKey;
     gcroot<IntToExprDictionary^> m_ExprMap;
 
+    // ConstantExpressions are immutable, so repeated constants of the same
+    // type and value share one node.
+    gcroot<ConstantToKeyDictionary^> m_ConstantMap;
+
     gcroot<Microsoft::Compiler::VisualBasic::SymbolMap^> m_UnmanagedToManagedSymbolMap;
 
     // Types
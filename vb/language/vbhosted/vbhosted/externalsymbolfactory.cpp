@@ -8,7 +8,9 @@ ExternalSymbolFactory::ExternalSymbolFactory(VBHostedAllocator* pAllocator, VbCo
     m_pExternalModule(NULL), 
     m_symbols(m_pCompiler, m_pAllocator->GetNorlsAllocator(), NULL /*LineMarkerTable*/),
     m_htTypeHash(pAllocator->GetNorlsAllocator()),
-	m_htRefTypeHash(pAllocator->GetNorlsAllocator())
+	m_htRefTypeHash(pAllocator->GetNorlsAllocator()),
+    m_hsUnresolvedTypeNames(pAllocator->GetNorlsAllocator()),
+    m_hsUnresolvedVariableNames(pAllocator->GetNorlsAllocator())
 {
     m_pExtTypeBuilder = new ExternalTypeBuilder(m_pCompiler, m_pCompilerFile, &m_symbols, m_pContext, this);
 }
@@ -36,22 +38,34 @@ BCSYM_NamedRoot* ExternalSymbolFactory::GetVariableForName(const STRING* Name)
 
     VerifyInPtrRetNull(Name, "[ExternalSymbolFactory::GetVariableForName] 'Name' parameter is null");
 
+    // Consider: casting away const is not good, but fixing it would require large scale changes.
+    STRING* nonConstName = const_cast<STRING*>(Name);
+
+    if (m_hsUnresolvedVariableNames.Contains(nonConstName))
+        return NULL;
+
     hr = m_pContext->FindVariable(name, pType);
     if(FAILED(hr) || !pType)
+    {
+        m_hsUnresolvedVariableNames.Add(nonConstName);
         return NULL;
+    }
     //Will return S_FALSE if symbol is not found
     //IfFailThrow(GetType(pType, &pTypeSymbol));
 
     // Fields of void type are not valid.
     if (System::Void::typeid->Equals(pType))
+    {
+        m_hsUnresolvedVariableNames.Add(nonConstName);
         return NULL;
+    }
 
     pTypeSymbol = GetExternalTypeBuilder()->GetSymbolForType(pType, NULL, NULL);
     if(!pTypeSymbol)
+    {
+        m_hsUnresolvedVariableNames.Add(nonConstName);
         return NULL;
-
-    // Consider: casting away const is not good, but fixing it would require large scale changes.
-    STRING* nonConstName = const_cast<STRING*>(Name);
+    }
 
     pVar = m_symbols.AllocVariable(false, false);
     m_symbols.GetVariable(
@@ -95,10 +109,19 @@ BCSYM_NamedRoot* ExternalSymbolFactory::GetSymbolForName(const STRING* Name, BCS
     VerifyInPtrRetNull(Name, "[ExternalSymbolFactory::GetSymbolForName] 'Name' parameter is null");
     VerifyInPtrRetNull(pNS, "[ExternalSymbolFactory::GetSymbolForName] 'pNS' parameter is null");
 
+    STRING* pstrQualifiedName = GetExternalTypeBuilder()->GetQualifiedName(Name, pNS);
+    if (m_hsUnresolvedTypeNames.Contains(pstrQualifiedName))
+        return NULL;
+
     //GetNamespaceForName and GetTypeForName -- if successful, will add to parent hash.
     BCSYM_NamedRoot* ns = GetExternalTypeBuilder()->GetNamespaceForName(Name, pNS);
     BCSYM_NamedRoot* nr = GetExternalTypeBuilder()->GetTypeForName(Name, pNS);
 
+    if (!nr && !ns)
+    {
+        m_hsUnresolvedTypeNames.Add(pstrQualifiedName);
+    }
+
     //If nr exists, it will have a reference to ns as the next element.
     // If neither exists, both are null. Simple, no?
     return nr ? nr : ns;
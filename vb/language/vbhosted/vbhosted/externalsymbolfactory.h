@@ -85,6 +85,13 @@ private:
     ExternalTypeBuilder* m_pExtTypeBuilder;
     HandleSymHashTable m_htTypeHash;
 	HandleSymHashTable m_htRefTypeHash;
+
+    // Names the host has already failed to resolve. Successful lookups are added
+    // to the hash they were made in and never reach the factory again, but a miss
+    // would otherwise call back into the host's scopes on every lookup of the name.
+    // Type and namespace names are recorded by their qualified name.
+    HashSet<STRING*, NorlsAllocWrapper> m_hsUnresolvedTypeNames;
+    HashSet<STRING*, NorlsAllocWrapper> m_hsUnresolvedVariableNames;
 };
 
 class ExternalVariableFactory :
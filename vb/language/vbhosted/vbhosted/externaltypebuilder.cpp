@@ -32,21 +32,7 @@ BCSYM_NamedRoot* ExternalTypeBuilder::GetNamespaceForName(const STRING* Name, BC
     //First, need to build the full name to use.
     //This feels really ---- because in all likelihood we have this as a complete string somewhere else.
     // Unfortunately, at this point in the callstack we only have the current name, and the parent we're looking up in.
-    if (StringPool::IsNullOrEmpty(pParentNamespace->GetQualifiedEmittedName()))
-    {
-        //If pParentNamespace->GetQualifiedName() is Null or Empty, we should be in the unnamed namespace
-        // Which means that we should NOT be concatenating or adding "."
-        pstrQualifiedName = m_pCompiler->AddString(Name);
-    }
-    else
-    {
-        const int nNames = 2;
-        const WCHAR* pNames[2];
-        pNames[0] = pParentNamespace->GetQualifiedEmittedName();
-        pNames[1] = Name;
-
-        pstrQualifiedName = m_pCompiler->ConcatStringsArray(nNames, pNames, WIDE("."));
-    }
+    pstrQualifiedName = GetQualifiedName(Name, pParentNamespace);
 
     BOOL bExists = FALSE;
 
@@ -73,6 +59,26 @@ Error:
     return ((hr == S_OK) && pNS) ? pNS->PNamedRoot() : NULL;
 }
 
+STRING* ExternalTypeBuilder::GetQualifiedName(const STRING* Name, BCSYM_Namespace* pParentNamespace)
+{
+    VerifyInPtrRetNull(Name, "[ExternalTypeBuilder::GetQualifiedName] 'Name' parameter is NULL");
+    VerifyInPtrRetNull(pParentNamespace, "[ExternalTypeBuilder::GetQualifiedName] 'pParentNamespace' parameter is NULL");
+
+    if (StringPool::IsNullOrEmpty(pParentNamespace->GetQualifiedEmittedName()))
+    {
+        //If pParentNamespace->GetQualifiedName() is Null or Empty, we should be in the unnamed namespace
+        // Which means that we should NOT be concatenating or adding "."
+        return m_pCompiler->AddString(Name);
+    }
+
+    const int nNames = 2;
+    const WCHAR* pNames[2];
+    pNames[0] = pParentNamespace->GetQualifiedEmittedName();
+    pNames[1] = Name;
+
+    return m_pCompiler->ConcatStringsArray(nNames, pNames, WIDE("."));
+}
+
 BCSYM_NamedRoot* ExternalTypeBuilder::GetTypeForName(const STRING* Name, BCSYM_Namespace* pParentNamespace)
 {
     HRESULT hr = S_OK;
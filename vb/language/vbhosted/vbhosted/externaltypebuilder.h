@@ -18,6 +18,9 @@ public:
     BCSYM_NamedRoot* GetTypeForName(const STRING* Name, BCSYM_Namespace* pParentNamespace);
     BCSYM_NamedRoot* GetNamespaceForName(const STRING* Name, BCSYM_Namespace* pParentNamespace);
 
+    // Returns the pooled, fully qualified emitted name of Name within pParentNamespace.
+    STRING* GetQualifiedName(const STRING* Name, BCSYM_Namespace* pParentNamespace);
+
     HRESULT SetupChildrenForType(BCSYM_Container* pTypeSymbol);
 
     BCSYM_NamedRoot* MakeSymbolForType(gcroot<System::Type^> pType);
@@ -14,6 +14,7 @@ HostedCompiler::HostedCompiler(System::Collections::Generic::IList<System::Refle
         referenceAssemblies = gcnew System::Collections::Generic::List<System::Reflection::Assembly ^>();
 
     m_pCompilerBridge = new CompilerBridge(referenceAssemblies);
+    m_expressionCache = gcnew CompiledExpressionCache();
     
 #ifdef TRACE    
     tracePageHeap = gcnew System::Diagnostics::BooleanSwitch("TracePageHeap", "Trace the VB Page Heap after each compilation");
@@ -42,6 +43,54 @@ void HostedCompiler::CheckInvalid()
         throw gcnew System::InvalidOperationException();
 }
 
+bool HostedCompiler::IsInvalid::get()
+{
+    return !m_pCompilerBridge || m_pCompilerBridge->IsInvalid();
+}
+
+int HostedCompiler::ExpressionCacheCapacity::get()
+{
+    return m_expressionCache->Capacity;
+}
+
+void HostedCompiler::ExpressionCacheCapacity::set(int value)
+{
+    m_expressionCache->Capacity = value;
+}
+
+void HostedCompiler::ClearExpressionCache()
+{
+    m_expressionCache->Clear();
+}
+
+int HostedCompiler::RetainedMemoryThreshold::get()
+{
+    return (int)g_pvbNorlsManager->GetPageHeap().GetShrinkThreshold();
+}
+
+void HostedCompiler::RetainedMemoryThreshold::set(int value)
+{
+    if (value < 0)
+    {
+        throw gcnew System::ArgumentOutOfRangeException("value");
+    }
+
+    g_pvbNorlsManager->GetPageHeap().SetShrinkThreshold((size_t)value);
+}
+
+void HostedCompiler::NotifyMemoryPressure(bool high)
+{
+    g_pvbNorlsManager->GetPageHeap().NotifyMemoryPressure(
+        high ? PageHeap::HighMemoryPressure : PageHeap::ModerateMemoryPressure);
+}
+
+// Only results without errors or warnings are cached, so that a cache hit only
+// has to hand back the code block.
+bool HostedCompiler::IsCacheable(CompilerResults ^results)
+{
+    return results->CodeBlock != nullptr && results->Errors->Count == 0 && results->Warnings->Count == 0;
+}
+
 CompilerResults ^HostedCompiler::CompileExpression(System::String ^expression, 
                                                    CompilerContext ^context)
 {
@@ -70,26 +119,100 @@ CompilerResults ^HostedCompiler::CompileExpression(System::String ^expression,
     {
         if(context == nullptr)
             context = CompilerContext::Empty;
+
+        System::Linq::Expressions::LambdaExpression ^cachedCodeBlock = m_expressionCache->Lookup(expression, context, targetType);
+        if (cachedCodeBlock != nullptr)
+        {
+            results->SetCodeBlock(cachedCodeBlock);
+            return results;
+        }
     
         m_pCompilerBridge->CompileExpression(expression, context, targetType, results);
 
+        if (IsCacheable(results))
+        {
+            m_expressionCache->Add(expression, context, targetType, results->CodeBlock);
+        }
+
 #ifdef TRACE
         if(tracePageHeap->Enabled)
         {
             System::Diagnostics::Trace::WriteLine(
                 System::String::Format(
                     System::Globalization::CultureInfo::InvariantCulture,
-                    "Expression = \"{0}\" :: CurrentReservedSize = {1} :: CurrentUseSize = {2} :: MaxReservedSize = {3} :: MaxUseSize = {4} :: WorkingSet64 = {5} :: PagedMemorySize64 = {6}", 
+                    "Expression = \"{0}\" :: CurrentReservedSize = {1} :: CurrentUseSize = {2} :: MaxReservedSize = {3} :: MaxUseSize = {4} :: WorkingSet64 = {5} :: PagedMemorySize64 = {6} :: CurrentCommitSize = {7}", 
                     expression, 
                     g_pvbNorlsManager->GetPageHeap().GetCurrentReserveSize(), 
                     g_pvbNorlsManager->GetPageHeap().GetCurrentUseSize(), 
                     g_pvbNorlsManager->GetPageHeap().GetMaxReserveSize(), 
                     g_pvbNorlsManager->GetPageHeap().GetMaxUseSize(),
                     System::Diagnostics::Process::GetCurrentProcess()->WorkingSet64,
-                    System::Diagnostics::Process::GetCurrentProcess()->PagedMemorySize64));
+                    System::Diagnostics::Process::GetCurrentProcess()->PagedMemorySize64,
+                    g_pvbNorlsManager->GetPageHeap().GetCurrentCommitSize()));
         }
 #endif
     }
     
     return results;
 }
+
+array<CompilerResults ^> ^HostedCompiler::CompileExpressions(array<System::String ^> ^expressions, 
+                                                             CompilerContext ^context,
+                                                             System::Type ^targetType)
+{
+    CheckInvalid();
+
+    if (expressions == nullptr)
+        throw gcnew System::ArgumentNullException("expressions");
+
+    // Target type cannot be the "Void" type. Check for this and throw.
+    //
+    // Note that the message for the ArgumentException is an empty string.
+    // This is intentional since we will not be able to localize this message.
+    //
+    if (targetType != nullptr && System::Void::typeid->Equals(targetType))
+        throw gcnew System::ArgumentException("", "targetType");
+
+    array<CompilerResults ^> ^results = gcnew array<CompilerResults ^>(expressions->Length);
+    for (int i = 0; i < results->Length; i++)
+    {
+        results[i] = gcnew CompilerResults();
+    }
+
+    if(context == nullptr)
+        context = CompilerContext::Empty;
+
+    // Expressions found in the cache are removed from the batch. Null or empty
+    // expressions are skipped by the bridge and keep their empty results, as with
+    // CompileExpression.
+    array<System::String ^> ^toCompile = gcnew array<System::String ^>(expressions->Length);
+    for (int i = 0; i < expressions->Length; i++)
+    {
+        System::Linq::Expressions::LambdaExpression ^cachedCodeBlock = nullptr;
+        if(!System::String::IsNullOrEmpty(expressions[i]))
+        {
+            cachedCodeBlock = m_expressionCache->Lookup(expressions[i], context, targetType);
+        }
+
+        if (cachedCodeBlock != nullptr)
+        {
+            results[i]->SetCodeBlock(cachedCodeBlock);
+        }
+        else
+        {
+            toCompile[i] = expressions[i];
+        }
+    }
+
+    m_pCompilerBridge->CompileExpressions(toCompile, context, targetType, results);
+
+    for (int i = 0; i < toCompile->Length; i++)
+    {
+        if (toCompile[i] != nullptr && IsCacheable(results[i]))
+        {
+            m_expressionCache->Add(toCompile[i], context, targetType, results[i]->CodeBlock);
+        }
+    }
+
+    return results;
+}
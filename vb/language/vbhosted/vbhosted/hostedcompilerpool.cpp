@@ -0,0 +1,126 @@
+#include "stdafx.h"
+
+using namespace Microsoft::Compiler::VisualBasic;
+
+HostedCompilerPool::HostedCompilerPool(System::Collections::Generic::IList<System::Reflection::Assembly ^> ^referenceAssemblies,
+                                       int size) :
+    m_fDisposed(false)
+{
+    if (size <= 0)
+        throw gcnew System::ArgumentOutOfRangeException("size");
+
+    if(referenceAssemblies == nullptr)
+        referenceAssemblies = gcnew System::Collections::Generic::List<System::Reflection::Assembly ^>();
+
+    m_referenceAssemblies = gcnew System::Collections::Generic::List<System::Reflection::Assembly ^>(referenceAssemblies);
+    m_idle = gcnew System::Collections::Generic::Stack<HostedCompiler ^>(size);
+    m_all = gcnew System::Collections::Generic::List<HostedCompiler ^>(size);
+
+    for (int i = 0; i < size; i++)
+    {
+        HostedCompiler ^compiler = CreateCompiler();
+        m_all->Add(compiler);
+        m_idle->Push(compiler);
+    }
+}
+
+HostedCompilerPool::~HostedCompilerPool()
+{
+    System::Threading::Monitor::Enter(m_idle);
+    try
+    {
+        // Compilers that are checked out are released when they are checked in.
+        m_fDisposed = true;
+        while (m_idle->Count > 0)
+        {
+            HostedCompiler ^compiler = m_idle->Pop();
+            m_all->Remove(compiler);
+            delete compiler;
+        }
+        System::Threading::Monitor::PulseAll(m_idle);
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(m_idle);
+    }
+}
+
+HostedCompiler ^HostedCompilerPool::CreateCompiler()
+{
+    HostedCompiler ^compiler = gcnew HostedCompiler(m_referenceAssemblies);
+
+    // The first compilation initializes the compiler and brings the referenced
+    // projects to bound; do it now rather than on the first caller's thread.
+    compiler->CompileExpression("Nothing", CompilerContext::Empty);
+
+    return compiler;
+}
+
+HostedCompiler ^HostedCompilerPool::CheckOut()
+{
+    System::Threading::Monitor::Enter(m_idle);
+    try
+    {
+        while (!m_fDisposed && m_idle->Count == 0)
+        {
+            System::Threading::Monitor::Wait(m_idle);
+        }
+
+        if (m_fDisposed)
+            throw gcnew System::ObjectDisposedException("HostedCompilerPool");
+
+        return m_idle->Pop();
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(m_idle);
+    }
+}
+
+void HostedCompilerPool::CheckIn(HostedCompiler ^compiler)
+{
+    if (compiler == nullptr)
+        throw gcnew System::ArgumentNullException("compiler");
+
+    HostedCompiler ^replacement = nullptr;
+
+    if (compiler->IsInvalid)
+    {
+        // Build the replacement outside the lock; warming it up compiles mscorlib.
+        replacement = CreateCompiler();
+    }
+
+    System::Threading::Monitor::Enter(m_idle);
+    try
+    {
+        int index = m_all->IndexOf(compiler);
+        if (index < 0)
+            throw gcnew System::ArgumentException("", "compiler");
+
+        if (m_fDisposed || replacement != nullptr)
+        {
+            m_all->RemoveAt(index);
+            delete compiler;
+        }
+
+        if (m_fDisposed)
+        {
+            if (replacement != nullptr)
+                delete replacement;
+            return;
+        }
+
+        if (replacement != nullptr)
+        {
+            m_all->Add(replacement);
+            compiler = replacement;
+        }
+
+        m_idle->Push(compiler);
+        System::Threading::Monitor::Pulse(m_idle);
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(m_idle);
+    }
+}
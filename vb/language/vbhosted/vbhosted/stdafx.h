@@ -290,6 +290,7 @@ inline void VSFree(void *pv)
 #include "AnonymousDelegateEmitter.h"
 #include "AnonymousTypeEmitter.h"
 #include "BadNodeException.h"
+#include "CompiledExpressionCache.h"
 #include "CompilerBridge.h"
 #include "CompilerContext.h"
 #include "CompilerOptions.h"
@@ -301,6 +302,7 @@ inline void VSFree(void *pv)
 #include "ExternalTypeBuilder.h"
 #include "Helpers.h"
 #include "HostedCompiler.h"
+#include "HostedCompilerPool.h"
 #include "Import.h"
 #include "ImportScope.h"
 #include "ScriptScope.h"
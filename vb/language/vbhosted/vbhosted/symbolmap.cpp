@@ -127,10 +127,13 @@ System::Type^ SymbolMap::GetAnonymousType(BCSYM_GenericTypeBinding * pSymbol)
 
     BCSYM_NamedRoot* pNamed = pSymbol->PNamedRoot();
     System::Type^ typeDef = nullptr;
+    System::String^ shapeKey = TypeEmitter::GetShapeKey(pNamed);
 
-    if(!DynamicAnonymousTypeEmitter->TryGetType(pNamed, typeDef))
+    //Look in the process wide cache first so that no dynamic assembly is created when the shape was already emitted
+    if(!TypeEmitter::TryGetSharedType(shapeKey, typeDef) &&
+       !DynamicAnonymousTypeEmitter->TryGetType(pNamed, typeDef))
     {
-        typeDef = DynamicAnonymousTypeEmitter->EmitType(pNamed);
+        typeDef = TypeEmitter::AddSharedType(shapeKey, DynamicAnonymousTypeEmitter->EmitType(pNamed));
     }
 
     ASSERT(typeDef != nullptr, "[SymbolMap::GetAnonymousType] Could not load Anonymous Type");
@@ -144,10 +147,12 @@ System::Type^ SymbolMap::GetAnonymousDelegate(BCSYM * pSymbol)
 
     BCSYM_NamedRoot* pNamed = pSymbol->PNamedRoot();
     System::Type^ typeDef = nullptr;
+    System::String^ shapeKey = TypeEmitter::GetShapeKey(pNamed);
 
-    if(!DynamicAnonymousDelegateEmitter->TryGetType(pNamed, typeDef))
+    if(!TypeEmitter::TryGetSharedType(shapeKey, typeDef) &&
+       !DynamicAnonymousDelegateEmitter->TryGetType(pNamed, typeDef))
     {
-        typeDef = DynamicAnonymousDelegateEmitter->EmitType(pNamed);
+        typeDef = TypeEmitter::AddSharedType(shapeKey, DynamicAnonymousDelegateEmitter->EmitType(pNamed));
     }
 
     ASSERT(typeDef != nullptr, "[SymbolMap::GetAnonymousDelegate] Could not load Anonymous Delegate");
@@ -397,6 +402,32 @@ Assembly^ SymbolMap::GetAssembly(BCSYM_NamedRoot* pSymbol)
 }
 
 MethodInfo^ SymbolMap::GetMethod(BCSYM_Proc * pMethodSymbol, GenericBinding* pBindingContext)
+{
+    //Bindings are not cached since they are synthesized per reference
+    if(pBindingContext)
+    {
+        return LookupMethod(pMethodSymbol, pBindingContext);
+    }
+
+    if(m_methods == nullptr)
+    {
+        m_methods = gcnew System::Collections::Generic::Dictionary<System::IntPtr, MethodInfo^>();
+    }
+
+    MethodInfo^ rv = nullptr;
+    if(!m_methods->TryGetValue(System::IntPtr(pMethodSymbol), rv))
+    {
+        rv = LookupMethod(pMethodSymbol, NULL);
+        if(rv != nullptr)
+        {
+            m_methods->Add(System::IntPtr(pMethodSymbol), rv);
+        }
+    }
+
+    return rv;
+}
+
+MethodInfo^ SymbolMap::LookupMethod(BCSYM_Proc * pMethodSymbol, GenericBinding* pBindingContext)
 {
     ASSERT(pMethodSymbol, "[SymbolMap::GetMethod] 'pMethodSymbol' parameter is null");
     IfFalseThrow(pMethodSymbol != NULL)
@@ -573,6 +604,31 @@ MethodInfo^ SymbolMap::GetMethod(BCSYM_Proc * pMethodSymbol, GenericBinding* pBi
 }
 
 ConstructorInfo^ SymbolMap::GetConstructor(BCSYM_Proc * pConstuctorSymbol, GenericTypeBinding* pBindingContext)
+{
+    if(pBindingContext)
+    {
+        return LookupConstructor(pConstuctorSymbol, pBindingContext);
+    }
+
+    if(m_constructors == nullptr)
+    {
+        m_constructors = gcnew System::Collections::Generic::Dictionary<System::IntPtr, ConstructorInfo^>();
+    }
+
+    ConstructorInfo^ rv = nullptr;
+    if(!m_constructors->TryGetValue(System::IntPtr(pConstuctorSymbol), rv))
+    {
+        rv = LookupConstructor(pConstuctorSymbol, NULL);
+        if(rv != nullptr)
+        {
+            m_constructors->Add(System::IntPtr(pConstuctorSymbol), rv);
+        }
+    }
+
+    return rv;
+}
+
+ConstructorInfo^ SymbolMap::LookupConstructor(BCSYM_Proc * pConstuctorSymbol, GenericTypeBinding* pBindingContext)
 {
     ASSERT(pConstuctorSymbol, "[SymbolMap::GetConstructor] 'pConstuctorSymbol' parameter is null");
     IfFalseThrow(pConstuctorSymbol != NULL)
@@ -969,6 +1025,31 @@ bool SymbolMap::EqualsArrayType(BCSYM_ArrayType* pSymbol, System::Type^ type)
 }
 
 System::Reflection::FieldInfo^ SymbolMap::GetField(BCSYM_Variable * pFieldSymbol, GenericTypeBinding* pBindingContext)
+{
+    if(pBindingContext)
+    {
+        return LookupField(pFieldSymbol, pBindingContext);
+    }
+
+    if(m_fields == nullptr)
+    {
+        m_fields = gcnew System::Collections::Generic::Dictionary<System::IntPtr, FieldInfo^>();
+    }
+
+    FieldInfo^ rv = nullptr;
+    if(!m_fields->TryGetValue(System::IntPtr(pFieldSymbol), rv))
+    {
+        rv = LookupField(pFieldSymbol, NULL);
+        if(rv != nullptr)
+        {
+            m_fields->Add(System::IntPtr(pFieldSymbol), rv);
+        }
+    }
+
+    return rv;
+}
+
+System::Reflection::FieldInfo^ SymbolMap::LookupField(BCSYM_Variable * pFieldSymbol, GenericTypeBinding* pBindingContext)
 {
     ASSERT(pFieldSymbol, "[SymbolMap::GetField] 'pFieldSymbol' parameter is null");
     ASSERT(!pFieldSymbol->IsFromScriptScope(), "[SymbolMap::GetField] 'pFieldSymbol' is from Script Scope");
@@ -19,6 +19,7 @@ using namespace Microsoft::Compiler::VisualBasic;
 static TypeEmitter::TypeEmitter()
 {
     VoidType = System::Void::typeid;
+    SharedTypes = gcnew System::Collections::Generic::Dictionary<System::String^, System::Type^>();
 }
 
 TypeEmitter::TypeEmitter(SymbolMap^ symbolMap, ModuleBuilder^ moduleBuilder) :
@@ -29,6 +30,136 @@ TypeEmitter::TypeEmitter(SymbolMap^ symbolMap, ModuleBuilder^ moduleBuilder) :
     ASSERT(moduleBuilder, "[TypeEmitter::TypeEmitter`1] 'moduleBuilder' parameter is null");
 }
 
+System::String^ TypeEmitter::GetShapeKey(BCSYM_NamedRoot* pType)
+{
+    ASSERT(pType, "[TypeEmitter::GetShapeKey] 'pType' parameter is null");
+    ASSERT(pType->IsAnonymousType() || pType->IsAnonymousDelegate(), "[TypeEmitter::GetShapeKey] only anonymous types and delegates are shared");
+
+    //The emitted name is not part of the key; it is only unique within one compilation.
+    System::Text::StringBuilder^ shape = gcnew System::Text::StringBuilder();
+    shape->Append(pType->IsAnonymousType() ? L"T" : L"D");
+
+    for (BCSYM_GenericParam* pParam = pType->GetFirstGenericParam(); pParam; pParam = pParam->GetNextParam())
+    {
+        shape->Append(L'<')->Append(gcnew System::String(pParam->GetEmittedName()));
+    }
+
+    BCITER_CHILD members(pType);
+    while (BCSYM_NamedRoot* pMember = members.GetNext())
+    {
+        shape->Append(L'|')->Append(gcnew System::String(pMember->GetEmittedName()))->Append(L':');
+
+        if (pMember->IsVariable())
+        {
+            AppendShape(shape, pMember->PVariable()->GetType());
+        }
+        else if (pMember->IsProc())
+        {
+            BCSYM_Proc* pProc = pMember->PProc();
+            if (pProc->IsProperty() && pProc->PProperty()->IsReadOnly())
+            {
+                //Read only properties are the Key members
+                shape->Append(L"key ");
+            }
+
+            shape->Append(L'(');
+            for (BCSYM_Param* pParam = pProc->GetFirstParam(); pParam; pParam = pParam->GetNext())
+            {
+                shape->Append(gcnew System::String(pParam->GetName()))->Append(L' ');
+                AppendShape(shape, pParam->GetType());
+                shape->Append(L',');
+            }
+            shape->Append(L')');
+            AppendShape(shape, pProc->GetType());
+        }
+    }
+
+    return shape->ToString();
+}
+
+void TypeEmitter::AppendShape(System::Text::StringBuilder^ shape, BCSYM* pSymbol)
+{
+    ASSERT(shape, "[TypeEmitter::AppendShape] 'shape' parameter is null");
+
+    if (pSymbol == NULL)
+    {
+        //compiler denotes void as NULL
+        shape->Append(L"void");
+    }
+    else if (pSymbol->IsGenericParam())
+    {
+        shape->Append(L'!')->Append(pSymbol->PGenericParam()->GetPosition());
+    }
+    else if (pSymbol->IsPointerType())
+    {
+        AppendShape(shape, pSymbol->PPointerType()->GetRoot());
+        shape->Append(L'&');
+    }
+    else if (pSymbol->IsArrayType())
+    {
+        AppendShape(shape, pSymbol->PArrayType()->GetRoot());
+        shape->Append(L'[')->Append(pSymbol->PArrayType()->GetRank())->Append(L']');
+    }
+    else if (pSymbol->IsGenericTypeBinding())
+    {
+        BCSYM_GenericTypeBinding* pBinding = pSymbol->PGenericTypeBinding();
+        shape->Append(gcnew System::String(pBinding->GetGeneric()->GetQualifiedEmittedName()))->Append(L'[');
+        for (unsigned ind = 0; ind < pBinding->GetArgumentCount(); ind++)
+        {
+            AppendShape(shape, pBinding->GetArgument(ind));
+            shape->Append(L',');
+        }
+        shape->Append(L']');
+    }
+    else if (pSymbol->IsNamedRoot())
+    {
+        shape->Append(gcnew System::String(pSymbol->PNamedRoot()->GetQualifiedEmittedName()));
+    }
+    else
+    {
+        shape->Append(L'?');
+    }
+}
+
+bool TypeEmitter::TryGetSharedType(System::String^ shapeKey, System::Type^% type)
+{
+    ASSERT(shapeKey, "[TypeEmitter::TryGetSharedType] 'shapeKey' parameter is null");
+
+    System::Threading::Monitor::Enter(SharedTypes);
+    try
+    {
+        return SharedTypes->TryGetValue(shapeKey, type);
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(SharedTypes);
+    }
+}
+
+System::Type^ TypeEmitter::AddSharedType(System::String^ shapeKey, System::Type^ type)
+{
+    ASSERT(shapeKey, "[TypeEmitter::AddSharedType] 'shapeKey' parameter is null");
+    ASSERT(type && !dynamic_cast<TypeBuilder^>(type), "[TypeEmitter::AddSharedType] only created types can be shared");
+
+    System::Threading::Monitor::Enter(SharedTypes);
+    try
+    {
+        //Another compilation may have emitted the same shape first; keep the first one
+        System::Type^ existing = nullptr;
+        if (SharedTypes->TryGetValue(shapeKey, existing))
+        {
+            return existing;
+        }
+
+        SharedTypes->Add(shapeKey, type);
+        return type;
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(SharedTypes);
+    }
+}
+
 ModuleBuilder^ TypeEmitter::DynamicModuleBuilder::get()
 {
     return m_moduleBuilder;
@@ -54,12 +54,30 @@ STDMETHODIMP VbHostedCompiler::CompileExpression
         gcroot<System::Type ^> TargetType,
         VbParsed *pParsed
     )
+{
+    HRESULT hr = CompileExpressionInBatch(Expression, pContext, TargetType, pParsed);
+
+    if (SUCCEEDED(hr))
+    {
+        EndExpressionBatch();
+    }
+
+    return hr;
+}
+
+STDMETHODIMP VbHostedCompiler::CompileExpressionInBatch
+    (
+        BSTR Expression, 
+        VbContext* pContext, 
+        gcroot<System::Type ^> TargetType,
+        VbParsed *pParsed
+    )
 {
     // Asserts are NOT necessary since the Verify* macros all invoke VSFAIL which is a VSASSERT wrapper.
-    VerifyInPtr(Expression, "[VbHostedCompiler::CompileExpression] 'Expression' parameter is null");
-    VerifyParamCond(SysStringLen(Expression) > 0, E_INVALIDARG, "[VbHostedCompiler::CompileExpression] 'Expression' parameter is zero length string");
-    VerifyInPtr(pContext, "[VbHostedCompiler::CompileExpression] 'pContext' parameter is null");
-    VerifyInPtr(pParsed, "[VbHostedCompiler::CompileExpression] 'pParsed' parameter is null");
+    VerifyInPtr(Expression, "[VbHostedCompiler::CompileExpressionInBatch] 'Expression' parameter is null");
+    VerifyParamCond(SysStringLen(Expression) > 0, E_INVALIDARG, "[VbHostedCompiler::CompileExpressionInBatch] 'Expression' parameter is zero length string");
+    VerifyInPtr(pContext, "[VbHostedCompiler::CompileExpressionInBatch] 'pContext' parameter is null");
+    VerifyInPtr(pParsed, "[VbHostedCompiler::CompileExpressionInBatch] 'pParsed' parameter is null");
 
     VB_ENTRY();
 
@@ -74,11 +92,14 @@ STDMETHODIMP VbHostedCompiler::CompileExpression
         IfFailGo(session.CompileExpression(pParsed));
     }
 
-    g_pvbNorlsManager->GetPageHeap().ShrinkUnusedResources();
-
     VB_EXIT_LABEL();
 }
 
+void VbHostedCompiler::EndExpressionBatch()
+{
+    g_pvbNorlsManager->GetPageHeap().ShrinkUnusedResourcesOverThreshold();
+}
+
 STDMETHODIMP VbHostedCompiler::CompileStatements
     (
         BSTR Statements, 
@@ -25,6 +25,7 @@ using System.Windows.Markup;
 [assembly:InternalsVisibleTo(BuildInfo.PresentationFrameworkAeroLite)]
 [assembly:InternalsVisibleTo(BuildInfo.PresentationFrameworkClassic)]
 [assembly:InternalsVisibleTo(BuildInfo.ReachFramework)]
+[assembly:InternalsVisibleTo(BuildInfo.SystemPrinting)]
 [assembly:InternalsVisibleTo(BuildInfo.SystemWindowsPresentation)]
 [assembly:InternalsVisibleTo(BuildInfo.PresentationFrameworkSystemCore)]
 [assembly:InternalsVisibleTo(BuildInfo.PresentationFrameworkSystemData)]
@@ -298,10 +298,150 @@ namespace MS.Internal.FontFace
                     glyphs.CopyTo(glyphArray, 0);
                 }
 
-                return TrueTypeSubsetter.ComputeSubset(fontData, fileSize, SourceUri, _directoryOffset, glyphArray);
+                if (glyphArray == null)
+                    return TrueTypeSubsetter.ComputeSubset(fontData, fileSize, SourceUri, _directoryOffset, glyphArray);
+
+                // The subset only depends on the set of glyphs, so the sorted list serves both as
+                // the cache key and as the subsetter input.
+                Array.Sort(glyphArray);
+
+                // The table directory holds the checksum, offset and length of every table of this face,
+                // which identifies the font content without reading the tables themselves.
+                byte[] directory = new byte[(4 + 2 + 2 + 2 + 2) + _tableDirectory.Length * (4 + 4 + 4 + 4)];
+                Marshal.Copy((IntPtr)((byte*)fontData + _directoryOffset), directory, 0, directory.Length);
+
+                SubsetCacheKey key = new SubsetCacheKey(SourceUri, _faceIndex, fileSize, directory, glyphArray);
+
+                byte[] subset = LookupSubset(key);
+                if (subset == null)
+                {
+                    subset = TrueTypeSubsetter.ComputeSubset(fontData, fileSize, SourceUri, _directoryOffset, glyphArray);
+                    AddSubset(key, subset);
+                }
+
+                // Cached subsets are shared, callers get their own copy.
+                return (byte[])subset.Clone();
+            }
+        }
+
+        /// <summary>
+        /// Returns the cached subset for the key and marks it most recently used, or null.
+        /// </summary>
+        /// <SecurityNote>
+        ///     Critical: Returns font data from the subset cache.
+        /// </SecurityNote>
+        [SecurityCritical]
+        private static byte[] LookupSubset(SubsetCacheKey key)
+        {
+            lock (_subsetCache)
+            {
+                LinkedListNode<KeyValuePair<SubsetCacheKey, byte[]>> node;
+                if (!_subsetCache.TryGetValue(key, out node))
+                    return null;
+
+                _subsetLru.Remove(node);
+                _subsetLru.AddFirst(node);
+                return node.Value.Value;
             }
         }
 
+        /// <summary>
+        /// Adds a subset to the cache, evicting the least recently used subsets to stay within SubsetCacheBudget.
+        /// Subsets larger than a quarter of the budget are not cached.
+        /// </summary>
+        /// <SecurityNote>
+        ///     Critical: Stores font data in the subset cache.
+        /// </SecurityNote>
+        [SecurityCritical]
+        private static void AddSubset(SubsetCacheKey key, byte[] subset)
+        {
+            if (subset == null || subset.Length > SubsetCacheBudget / 4)
+                return;
+
+            lock (_subsetCache)
+            {
+                if (_subsetCache.ContainsKey(key))
+                    return;
+
+                while (_subsetCacheBytes + subset.Length > SubsetCacheBudget && _subsetLru.Count != 0)
+                {
+                    LinkedListNode<KeyValuePair<SubsetCacheKey, byte[]>> oldest = _subsetLru.Last;
+                    _subsetLru.RemoveLast();
+                    _subsetCache.Remove(oldest.Value.Key);
+                    _subsetCacheBytes -= oldest.Value.Value.Length;
+                }
+
+                _subsetCache.Add(key, _subsetLru.AddFirst(new KeyValuePair<SubsetCacheKey, byte[]>(key, subset)));
+                _subsetCacheBytes += subset.Length;
+            }
+        }
+
+        /// <summary>
+        /// Identifies a subset: the font face, its table directory and the sorted glyph indices.
+        /// </summary>
+        private sealed class SubsetCacheKey
+        {
+            internal SubsetCacheKey(Uri sourceUri, int faceIndex, int fileSize, byte[] directory, ushort[] sortedGlyphs)
+            {
+                _sourceUri = sourceUri;
+                _faceIndex = faceIndex;
+                _fileSize = fileSize;
+                _directory = directory;
+                _sortedGlyphs = sortedGlyphs;
+
+                int hash = HashFn.HashMultiply(fileSize) + faceIndex;
+                foreach (byte b in directory)
+                {
+                    hash = HashFn.HashMultiply(hash) + b;
+                }
+                foreach (ushort glyph in sortedGlyphs)
+                {
+                    hash = HashFn.HashMultiply(hash) + glyph;
+                }
+                _hashCode = HashFn.HashScramble(hash);
+            }
+
+            public override int GetHashCode()
+            {
+                return _hashCode;
+            }
+
+            public override bool Equals(object o)
+            {
+                SubsetCacheKey other = o as SubsetCacheKey;
+                if (other == null
+                    || _hashCode != other._hashCode
+                    || _faceIndex != other._faceIndex
+                    || _fileSize != other._fileSize
+                    || _directory.Length != other._directory.Length
+                    || _sortedGlyphs.Length != other._sortedGlyphs.Length
+                    || !Uri.Equals(_sourceUri, other._sourceUri))
+                {
+                    return false;
+                }
+
+                for (int i = 0; i < _directory.Length; ++i)
+                {
+                    if (_directory[i] != other._directory[i])
+                        return false;
+                }
+
+                for (int i = 0; i < _sortedGlyphs.Length; ++i)
+                {
+                    if (_sortedGlyphs[i] != other._sortedGlyphs[i])
+                        return false;
+                }
+                return true;
+            }
+
+            private readonly Uri      _sourceUri;
+            private readonly int      _faceIndex;
+            private readonly int      _fileSize;
+            private readonly byte[]   _directory;
+            private readonly ushort[] _sortedGlyphs;
+            private readonly int      _hashCode;
+        }
+
             
         #endregion Public methods and properties   
         
@@ -319,6 +459,26 @@ namespace MS.Internal.FontFace
         private int _directoryOffset; // table directory offset for TTC, 0 for TTF
         private DirectoryEntry[] _tableDirectory;
 
+        // Process wide cache of computed subsets, shared by all drivers. Printing and XPS serialization
+        // subset the same fonts with the same glyphs for every document.
+        private const int SubsetCacheBudget = 32 * 1024 * 1024;
+
+        /// <SecurityNote>
+        ///     Critical: Holds font data.
+        /// </SecurityNote>
+        [SecurityCritical]
+        private static Dictionary<SubsetCacheKey, LinkedListNode<KeyValuePair<SubsetCacheKey, byte[]>>> _subsetCache =
+            new Dictionary<SubsetCacheKey, LinkedListNode<KeyValuePair<SubsetCacheKey, byte[]>>>();
+
+        /// <SecurityNote>
+        ///     Critical: Holds font data.
+        /// </SecurityNote>
+        [SecurityCritical]
+        private static LinkedList<KeyValuePair<SubsetCacheKey, byte[]>> _subsetLru =
+            new LinkedList<KeyValuePair<SubsetCacheKey, byte[]>>(); // most recently used first
+
+        private static int _subsetCacheBytes; // protected by the lock on _subsetCache
+
         #endregion
     }
 }
@@ -26,64 +26,93 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         _flags = 0;
     }
 
-    FontFace^ Font::AddFontFaceToCache()
+    Font::FontFaceCacheShard^ Font::GetFontFaceCacheShard()
+    {
+        array<FontFaceCacheShard^>^ fontFaceCache = _fontFaceCache;
+
+        if (nullptr == fontFaceCache)
+        {
+            int shardSize = (_requestedFontFaceCacheShardSize > 0) ? _requestedFontFaceCacheShardSize : _fontFaceCacheSize;
+
+            fontFaceCache = gcnew array<FontFaceCacheShard^>(_fontFaceCacheShardCount);
+            for (int i=0; i < _fontFaceCacheShardCount; i++)
+            {
+                fontFaceCache[i] = gcnew FontFaceCacheShard(shardSize);
+            }
+
+            // If another thread got there first, use its cache instead.
+            array<FontFaceCacheShard^>^ publishedCache = System::Threading::Interlocked::CompareExchange<array<FontFaceCacheShard^>^>(_fontFaceCache, fontFaceCache, nullptr);
+            if (publishedCache != nullptr)
+            {
+                fontFaceCache = publishedCache;
+            }
+        }
+
+        int hashCode = System::Runtime::CompilerServices::RuntimeHelpers::GetHashCode(this);
+        return fontFaceCache[(hashCode & 0x7FFFFFFF) % _fontFaceCacheShardCount];
+    }
+
+    FontFace^ Font::AddFontFaceToCache(FontFaceCacheShard^ shard)
     {
         FontFace^ fontFace = CreateFontFace();
         FontFace^ bumpedFontFace = nullptr;
 
         // NB: if the cache is busy, we simply return the new FontFace
         // without bothering to cache it.
-        if (System::Threading::Interlocked::Increment(_mutex) == 1)
+        if (System::Threading::Interlocked::Increment(shard->mutex) == 1)
         {
-            if (nullptr == _fontFaceCache)
-            {
-                _fontFaceCache = gcnew array<FontFaceCacheEntry>(_fontFaceCacheSize);
-            }
-            
+            array<FontFaceCacheEntry>^ entries = shard->entries;
+
             // Default to a slot that is not the MRU.
-            _fontFaceCacheMRU = (_fontFaceCacheMRU + 1) % _fontFaceCacheSize;
+            shard->mru = (shard->mru + 1) % entries->Length;
 
             // Look for an empty slot.
-            for (int i=0; i < _fontFaceCacheSize; i++)
+            for (int i=0; i < entries->Length; i++)
             {
-                if (_fontFaceCache[i].font == nullptr)
+                if (entries[i].font == nullptr)
                 {
-                    _fontFaceCacheMRU = i;
+                    shard->mru = i;
                     break;
                 }
             }
 
             // Keep a reference to any discarded entry, clean it up after releasing
             // the mutex.
-            bumpedFontFace = _fontFaceCache[_fontFaceCacheMRU].fontFace;
+            bumpedFontFace = entries[shard->mru].fontFace;
 
             // Record the new entry.
-            _fontFaceCache[_fontFaceCacheMRU].font = this;
-            _fontFaceCache[_fontFaceCacheMRU].fontFace = fontFace;
+            entries[shard->mru].font = this;
+            entries[shard->mru].fontFace = fontFace;
             fontFace->AddRef();
         }
-        System::Threading::Interlocked::Decrement(_mutex);
+        else
+        {
+            System::Threading::Interlocked::Increment(_fontFaceCacheBusyMisses);
+        }
+        System::Threading::Interlocked::Decrement(shard->mutex);
 
         // If the cache was full and we replaced an unreferenced entry, release it now.
         if (bumpedFontFace != nullptr)
         {
+            System::Threading::Interlocked::Increment(_fontFaceCacheEvictions);
             bumpedFontFace->Release();
         }
 
         return fontFace;
     }
 
-    FontFace^ Font::LookupFontFaceSlow()
+    FontFace^ Font::LookupFontFaceSlow(FontFaceCacheShard^ shard)
     {
         FontFace^ fontFace = nullptr;
+        array<FontFaceCacheEntry>^ entries = shard->entries;
 
-        for (int i=0; i < _fontFaceCacheSize; i++)
+        for (int i=0; i < entries->Length; i++)
         {
-            if (_fontFaceCache[i].font == this)
+            if (entries[i].font == this)
             {
-                fontFace = _fontFaceCache[i].fontFace;
+                fontFace = entries[i].fontFace;
                 fontFace->AddRef();
-                _fontFaceCacheMRU = i;
+                shard->mru = i;
                 break;
             }
         }
@@ -93,56 +122,97 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
 
     void Font::ResetFontFaceCache()
     {
-        array<FontFaceCacheEntry>^ fontFaceCache = nullptr;
+        array<FontFaceCacheShard^>^ fontFaceCache = _fontFaceCache;
 
-        // NB: If the cache is busy, we do nothing.
-        if (System::Threading::Interlocked::Increment(_mutex) == 1)
+        if (fontFaceCache == nullptr)
         {
-            fontFaceCache = _fontFaceCache;
-            _fontFaceCache = nullptr;
+            return;
         }
-        System::Threading::Interlocked::Decrement(_mutex);
 
-        if (fontFaceCache != nullptr)
+        for (int shardIndex=0; shardIndex < fontFaceCache->Length; shardIndex++)
         {
-            for (int i=0; i < _fontFaceCacheSize; i++)
+            FontFaceCacheShard^ shard = fontFaceCache[shardIndex];
+            array<FontFaceCacheEntry>^ entries = nullptr;
+
+            // NB: If the shard is busy, we leave it alone.
+            if (System::Threading::Interlocked::Increment(shard->mutex) == 1)
+            {
+                entries = shard->entries;
+                shard->entries = gcnew array<FontFaceCacheEntry>(entries->Length);
+                shard->mru = 0;
+            }
+            System::Threading::Interlocked::Decrement(shard->mutex);
+
+            if (entries != nullptr)
             {
-                if (fontFaceCache[i].fontFace != nullptr)
+                for (int i=0; i < entries->Length; i++)
                 {
-                    fontFaceCache[i].fontFace->Release();
+                    if (entries[i].fontFace != nullptr)
+                    {
+                        entries[i].fontFace->Release();
+                    }
                 }
             }
         }
     }
 
+    int Font::FontFaceCacheSize::get()
+    {
+        int shardSize = (_requestedFontFaceCacheShardSize > 0) ? _requestedFontFaceCacheShardSize : _fontFaceCacheSize;
+        return shardSize * _fontFaceCacheShardCount;
+    }
+
+    void Font::FontFaceCacheSize::set(int value)
+    {
+        if (value < _fontFaceCacheShardCount)
+        {
+            throw gcnew System::ArgumentOutOfRangeException("value");
+        }
+
+        if (_fontFaceCache != nullptr)
+        {
+            throw gcnew System::InvalidOperationException();
+        }
+
+        _requestedFontFaceCacheShardSize = (value + _fontFaceCacheShardCount - 1) / _fontFaceCacheShardCount;
+    }
+
+    int Font::FontFaceCacheEvictions::get()
+    {
+        return _fontFaceCacheEvictions;
+    }
+
+    int Font::FontFaceCacheBusyMisses::get()
+    {
+        return _fontFaceCacheBusyMisses;
+    }
+
     FontFace^ Font::GetFontFace()
     {
         FontFace^ fontFace = nullptr;
+        FontFaceCacheShard^ shard = GetFontFaceCacheShard();
 
-        if (System::Threading::Interlocked::Increment(_mutex) == 1)
+        if (System::Threading::Interlocked::Increment(shard->mutex) == 1)
         {
-            if (_fontFaceCache != nullptr)
+            FontFaceCacheEntry entry;
+            // Try the fast path first -- is caller accessing exactly the mru entry?
+            if ((entry = shard->entries[shard->mru]).font == this)
             {
-                FontFaceCacheEntry entry;
-                // Try the fast path first -- is caller accessing exactly the mru entry?
-                if ((entry = _fontFaceCache[_fontFaceCacheMRU]).font == this)
-                {
-                    entry.fontFace->AddRef();
-                    fontFace = entry.fontFace;
-                }
-                else
-                {
-                    // No luck, do a search through the cache.
-                    fontFace = LookupFontFaceSlow();
-                }
+                entry.fontFace->AddRef();
+                fontFace = entry.fontFace;
+            }
+            else
+            {
+                // No luck, do a search through the cache.
+                fontFace = LookupFontFaceSlow(shard);
             }
         }
-        System::Threading::Interlocked::Decrement(_mutex);
+        System::Threading::Interlocked::Decrement(shard->mutex);
 
         // If the cache was busy or did not contain this Font, create a new FontFace.
         if (nullptr == fontFace)
         {
-            fontFace = AddFontFaceToCache();
+            fontFace = AddFontFaceToCache(shard);
         }
 
         return fontFace;
@@ -35,6 +35,36 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                 FontFace^ fontFace;
             };
 
+            /// <summary>
+            /// One shard of the FontFace cache. Each shard has its own mutex, so
+            /// threads looking up different fonts rarely find the cache busy.
+            /// </summary>
+            ref class FontFaceCacheShard sealed
+            {
+                internal:
+
+                    FontFaceCacheShard(int size)
+                    {
+                        entries = gcnew array<FontFaceCacheEntry>(size);
+                    }
+
+                    /// <summary>
+                    /// Cached FontFace instances.
+                    /// </summary>
+                    array<FontFaceCacheEntry>^ entries;
+
+                    /// <summary>
+                    /// Mutex used to control access to entries, which is locked when
+                    /// mutex > 0.
+                    /// </summary>
+                    int mutex;
+
+                    /// <summary>
+                    /// Most recently used element in entries.
+                    /// </summary>
+                    int mru;
+            };
+
             /// <summary>
             /// The DWrite font object that this class wraps.
             /// </summary>
@@ -59,13 +89,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             int _flags;
 
             /// <summary>
-            /// Mutex used to control access to _fontFaceCache, which is locked when
-            /// _mutex > 0.
-            /// </summary>
-            static int _mutex;
-
-            /// <summary>
-            /// Size of the _fontFaceCache, maximum number of FontFace instances cached.
+            /// Default size of each _fontFaceCache shard, maximum number of FontFace instances cached per shard.
             /// </summary>
             /// <remarks>
             /// Cache size could be based upon measurements of the TextFormatter micro benchmarks.
@@ -74,29 +98,50 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             ///
             /// However, dwrite circa win7 has an issue aggressively consuming address space and
             /// therefore we need to be conservative holding on to font references.  Dev10
-            /// bug 759523 has details.
+            /// bug 759523 has details.  Spread over the shards below the default total is still
+            /// 16, which the FontFaceCacheSize property lets hosts with many fonts raise.
             /// </remarks>
             static const int _fontFaceCacheSize = 4;
 
             /// <summary>
-            /// Cached FontFace instances.
+            /// Number of shards the FontFace cache is split into.  A Font always maps to the same shard.
             /// </summary>
-            static array<FontFaceCacheEntry>^ _fontFaceCache;
+            static const int _fontFaceCacheShardCount = 4;
 
             /// <summary>
-            /// Most recently used element in the FontFace cache.
+            /// Shard size requested through FontFaceCacheSize, 0 for _fontFaceCacheSize.
             /// </summary>
-            static int _fontFaceCacheMRU;
+            static int _requestedFontFaceCacheShardSize;
+
+            /// <summary>
+            /// Cached FontFace instances, allocated on first use.
+            /// </summary>
+            static array<FontFaceCacheShard^>^ _fontFaceCache;
+
+            /// <summary>
+            /// Number of cached FontFace instances discarded to make room for another.
+            /// </summary>
+            static int _fontFaceCacheEvictions;
+
+            /// <summary>
+            /// Number of lookups that created an uncached FontFace because the shard was busy.
+            /// </summary>
+            static int _fontFaceCacheBusyMisses;
+
+            /// <summary>
+            /// Returns the FontFace cache shard for this Font, allocating the cache if necessary.
+            /// </summary>
+            FontFaceCacheShard^ GetFontFaceCacheShard();
 
             /// <summary>
             /// Adds a new FontFace to the cache, discarding an older entry if necessary.
             /// </summary>
-            FontFace^ AddFontFaceToCache();
+            FontFace^ AddFontFaceToCache(FontFaceCacheShard^ shard);
 
             /// <summary>
-            /// Does a linear search through the FontFace cache, looking for a match for the current Font.
+            /// Does a linear search through the FontFace cache shard, looking for a match for the current Font.
             /// </summary>
-            FontFace^ LookupFontFaceSlow();
+            FontFace^ LookupFontFaceSlow(FontFaceCacheShard^ shard);
 
             /// <summary>
             /// Creates a font face object for the font.
@@ -215,6 +260,34 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             /// </remarks>
             static void ResetFontFaceCache();
 
+            /// <summary>
+            /// Gets or sets the maximum number of FontFace instances cached across all shards.
+            /// </summary>
+            /// <remarks>
+            /// Can only be set before the first FontFace is requested.
+            /// </remarks>
+            static property int FontFaceCacheSize
+            {
+                int get();
+                void set(int value);
+            }
+
+            /// <summary>
+            /// Gets the number of cached FontFace instances discarded to make room for another.
+            /// </summary>
+            static property int FontFaceCacheEvictions
+            {
+                int get();
+            }
+
+            /// <summary>
+            /// Gets the number of FontFace lookups that bypassed the cache because it was busy.
+            /// </summary>
+            static property int FontFaceCacheBusyMisses
+            {
+                int get();
+            }
+
             /// <summary>
             /// Returns a FontFace matching this Font.
             /// </summary>
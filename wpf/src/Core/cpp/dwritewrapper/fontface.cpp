@@ -193,6 +193,17 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         __out_ecount(glyphCount) GlyphMetrics *pGlyphMetrics
         )
     {      
+        if (_designGlyphMetrics == nullptr)
+        {
+            _designGlyphMetrics = gcnew array<array<GlyphMetrics>^>((GlyphCount + GlyphMetricsBlockSize - 1) / GlyphMetricsBlockSize);
+        }
+
+        if (GetCachedGlyphMetrics(_designGlyphMetrics, pGlyphIndices, glyphCount, pGlyphMetrics, nullptr))
+        {
+            return;
+        }
+
+        // Out of range glyph indices: let DWrite report the error as before.
         HRESULT hr = _fontFace->Value->GetDesignGlyphMetrics(
                                                       pGlyphIndices,
                                                       glyphCount,
@@ -220,6 +231,30 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         float pixelsPerDip
         )
     {
+        // Callers lay out a run at one size at a time, so caching the metrics
+        // for the most recent parameters catches nearly all repeated requests.
+        DisplayGlyphMetricsCache^ cache = _displayGlyphMetrics;
+        if (   cache == nullptr
+            || cache->emSize            != emSize
+            || cache->pixelsPerDip      != pixelsPerDip
+            || cache->useDisplayNatural != useDisplayNatural
+            || cache->isSideways        != isSideways)
+        {
+            cache = gcnew DisplayGlyphMetricsCache();
+            cache->emSize            = emSize;
+            cache->pixelsPerDip      = pixelsPerDip;
+            cache->useDisplayNatural = useDisplayNatural;
+            cache->isSideways        = isSideways;
+            cache->blocks            = gcnew array<array<GlyphMetrics>^>((GlyphCount + GlyphMetricsBlockSize - 1) / GlyphMetricsBlockSize);
+            _displayGlyphMetrics = cache;
+        }
+
+        if (GetCachedGlyphMetrics(cache->blocks, pGlyphIndices, glyphCount, pGlyphMetrics, cache))
+        {
+            return;
+        }
+
+        // Out of range glyph indices: let DWrite report the error as before.
         HRESULT hr = _fontFace->Value->GetGdiCompatibleGlyphMetrics(
             emSize,
             pixelsPerDip, //FLOAT pixelsPerDip,
@@ -234,6 +269,84 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         ConvertHresultToException(hr, "array<GlyphMetrics^>^ FontFace::GetDesignGlyphMetrics");
     }
 
+    /// <SecurityNote>
+    /// Critical - Uses security critical member _fontFace.
+    ///            Receives a native pointer as an argument.
+    ///            Writes through a native pointer.
+    /// </SecurityNote>
+    [SecurityCritical]
+    bool FontFace::GetCachedGlyphMetrics(
+        array<array<GlyphMetrics>^>^ blocks,
+        __in_ecount(glyphCount) const UINT16 *pGlyphIndices,
+        UINT32 glyphCount,
+        __out_ecount(glyphCount) GlyphMetrics *pGlyphMetrics,
+        DisplayGlyphMetricsCache^ displayParameters
+        )
+    {
+        UINT32 fontGlyphCount = GlyphCount;
+        for (UINT32 i = 0; i < glyphCount; ++i)
+        {
+            if (pGlyphIndices[i] >= fontGlyphCount)
+            {
+                return false;
+            }
+        }
+
+        for (UINT32 i = 0; i < glyphCount; ++i)
+        {
+            UINT32 glyphIndex = pGlyphIndices[i];
+            UINT32 blockIndex = glyphIndex / GlyphMetricsBlockSize;
+            array<GlyphMetrics>^ block = blocks[blockIndex];
+
+            if (block == nullptr)
+            {
+                UINT32 firstGlyph = blockIndex * GlyphMetricsBlockSize;
+                UINT32 blockGlyphCount = Math::Min(GlyphMetricsBlockSize, fontGlyphCount - firstGlyph);
+
+                UINT16 blockGlyphIndices[GlyphMetricsBlockSize];
+                for (UINT32 j = 0; j < blockGlyphCount; ++j)
+                {
+                    blockGlyphIndices[j] = (UINT16)(firstGlyph + j);
+                }
+
+                block = gcnew array<GlyphMetrics>(GlyphMetricsBlockSize);
+                pin_ptr<GlyphMetrics> pBlockPinned = &block[0];
+
+                HRESULT hr;
+                if (displayParameters == nullptr)
+                {
+                    hr = _fontFace->Value->GetDesignGlyphMetrics(
+                        blockGlyphIndices,
+                        blockGlyphCount,
+                        reinterpret_cast<DWRITE_GLYPH_METRICS *>(pBlockPinned)
+                        );
+                }
+                else
+                {
+                    hr = _fontFace->Value->GetGdiCompatibleGlyphMetrics(
+                        displayParameters->emSize,
+                        displayParameters->pixelsPerDip,
+                        NULL,
+                        displayParameters->useDisplayNatural,
+                        blockGlyphIndices,
+                        blockGlyphCount,
+                        reinterpret_cast<DWRITE_GLYPH_METRICS *>(pBlockPinned),
+                        displayParameters->isSideways
+                        );
+                }
+                System::GC::KeepAlive(_fontFace);
+                ConvertHresultToException(hr, "bool FontFace::GetCachedGlyphMetrics");
+
+                // Publish only complete blocks; a racing thread at worst fetches the same block again.
+                blocks[blockIndex] = block;
+            }
+
+            pGlyphMetrics[i] = block[glyphIndex % GlyphMetricsBlockSize];
+        }
+
+        return true;
+    }
+
     /// <SecurityNote>
     /// Critical - Uses security critical member _fontFace.
     ///            Receives a native pointer as an argument.
@@ -260,8 +373,10 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
 
     /// <SecurityNote>
     /// Critical - Exposes the data from a font.
+    ///            Asserts unmanaged code permission to call Marshal::Copy.
     /// </SecurityNote>
     [SecurityCritical]
+    [SecurityPermission(SecurityAction::Assert, UnmanagedCode=true)]
     __declspec(noinline) bool FontFace::TryGetFontTable(
                                                                           OpenTypeTableTag openTypeTableTag,         
                                   [System::Runtime::InteropServices::Out] array<byte>^%    tableData
@@ -283,15 +398,20 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
 
         if (exists)
         {
-            tableData = gcnew array<byte>(tableSizeDWrite);
-            for(unsigned int i = 0; i < tableSizeDWrite; ++i)
+            try
             {
-                tableData[i] = ((byte*)tableDataDWrite)[i];
+                tableData = gcnew array<byte>(tableSizeDWrite);
+                if (tableSizeDWrite > 0)
+                {
+                    System::Runtime::InteropServices::Marshal::Copy(System::IntPtr(tableDataDWrite), tableData, 0, (int)tableSizeDWrite);
+                }
+            }
+            finally
+            {
+                _fontFace->Value->ReleaseFontTable(
+                                           tableContext
+                                           );
             }
-            
-            _fontFace->Value->ReleaseFontTable(
-                                       tableContext
-                                       );
         }
         System::GC::KeepAlive(_fontFace);
         return (!!exists);     
@@ -304,6 +424,12 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
     [SecuritySafeCritical]
     __declspec(noinline) bool FontFace::ReadFontEmbeddingRights([System::Runtime::InteropServices::Out] unsigned short% fsType)
     {
+        if (_embeddingRightsState != EmbeddingRights_Unknown)
+        {
+            fsType = _fsType;
+            return (_embeddingRightsState == EmbeddingRights_Read);
+        }
+
         void* os2Table;
         void* tableContext;
         UINT32 tableSizeDWrite = 0;
@@ -333,6 +459,9 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         }
         
         System::GC::KeepAlive(_fontFace);
+
+        _fsType = fsType;
+        _embeddingRightsState = success ? EmbeddingRights_Read : EmbeddingRights_Missing;
         
         return success; 
     }
@@ -50,6 +50,60 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             /// </remarks>
             int _refCount;
 
+            /// <summary>
+            /// Glyph metrics are cached in blocks of this many consecutive glyph ids,
+            /// each block fetched from DWrite with a single call.
+            /// </summary>
+            static const UINT32 GlyphMetricsBlockSize = 256;
+
+            /// <summary>
+            /// Cached GDI compatible glyph metrics for one set of rendering parameters.
+            /// </summary>
+            ref class DisplayGlyphMetricsCache sealed
+            {
+                internal:
+
+                    FLOAT                         emSize;
+                    float                         pixelsPerDip;
+                    bool                          useDisplayNatural;
+                    bool                          isSideways;
+                    array<array<GlyphMetrics>^>^  blocks;
+            };
+
+            /// <summary>
+            /// Design glyph metrics blocks, indexed by glyph id / GlyphMetricsBlockSize. Lazily allocated.
+            /// </summary>
+            array<array<GlyphMetrics>^>^ _designGlyphMetrics;
+
+            /// <summary>
+            /// GDI compatible glyph metrics for the most recently requested parameters. Lazily allocated.
+            /// </summary>
+            DisplayGlyphMetricsCache^ _displayGlyphMetrics;
+
+            /// <summary>
+            /// OS/2 fsType, valid once _embeddingRightsState is no longer EmbeddingRights_Unknown.
+            /// </summary>
+            unsigned short _fsType;
+
+            static const int EmbeddingRights_Unknown = 0;
+            static const int EmbeddingRights_Read    = 1;
+            static const int EmbeddingRights_Missing = 2;
+
+            int _embeddingRightsState;
+
+            /// <summary>
+            /// Copies glyph metrics out of the given block cache, fetching missing blocks from DWrite.
+            /// Returns false, copying nothing, if a glyph index is out of range.
+            /// </summary>
+            [SecurityCritical]
+            bool GetCachedGlyphMetrics(
+                array<array<GlyphMetrics>^>^ blocks,
+                __in_ecount(glyphCount) const UINT16 *pGlyphIndices,
+                UINT32 glyphCount,
+                __out_ecount(glyphCount) GlyphMetrics *pGlyphMetrics,
+                DisplayGlyphMetricsCache^ displayParameters
+                );
+
         internal:
 
             /// <summary>
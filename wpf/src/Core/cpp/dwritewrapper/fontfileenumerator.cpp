@@ -9,10 +9,124 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                                           IDWriteFactory*            factory
                                           )
     {
-        _fontSourceCollectionEnumerator = fontSourceCollection->GetEnumerator();                
+        // Take a snapshot of the collection up front so the font sources can be handed to the
+        // prefetch workers by index rather than walking the managed enumerator on DWrite's thread.
+        List<IFontSource^>^ fontSources = gcnew List<IFontSource^>(fontSourceCollection);
+        _fontSources                    = fontSources->ToArray();
+        _currentIndex                   = -1;
         _fontFileLoader                 = fontFileLoader;
         factory->AddRef();
         _factory                        = factory;
+
+        PrefetchFontFiles();
+    }
+
+    FontFileEnumerator::~FontFileEnumerator()
+    {
+        this->!FontFileEnumerator();
+    }
+
+    FontFileEnumerator::!FontFileEnumerator()
+    {
+        ReleasePrefetchedFontFiles();
+    }
+
+    /// <summary>
+    /// For large collections creates the IDWriteFontFile for every font source and analyzes it on
+    /// the thread pool, with the calling thread taking its share of the work. DWrite's own pass over
+    /// the enumerator then only has to pick up the prepared files, and the font data it validates
+    /// next is already in the file cache. Small collections are left to GetCurrentFontFile.
+    /// </summary>
+    void FontFileEnumerator::PrefetchFontFiles()
+    {
+        int workers = Math::Min(Environment::ProcessorCount, _fontSources->Length / MinimumSourcesPerPrefetchWorker);
+        if (workers <= 1)
+        {
+            return;
+        }
+
+        _prefetchedFontFiles    = gcnew array<IntPtr>(_fontSources->Length);
+        _nextPrefetchIndex      = 0;
+        _pendingPrefetchWorkers = workers - 1;
+        _prefetchWorkersDone    = gcnew ManualResetEvent(false);
+
+        for (int i = 0; i < workers - 1; ++i)
+        {
+            ThreadPool::QueueUserWorkItem(gcnew WaitCallback(this, &FontFileEnumerator::PrefetchFontFiles), this);
+        }
+
+        PrefetchFontFiles(nullptr);
+
+        _prefetchWorkersDone->WaitOne();
+        _prefetchWorkersDone->Close();
+        _prefetchWorkersDone = nullptr;
+    }
+
+    /// <summary>
+    /// Prefetch worker. Claims font sources one at a time until none are left. Failures are not
+    /// reported here; the slot is left empty so GetCurrentFontFile recreates the file and returns
+    /// the same HRESULT DWrite would have seen without prefetching.
+    /// </summary>
+    /// <param name="state">Non-null for thread pool workers, null when run on the calling thread.</param>
+    void FontFileEnumerator::PrefetchFontFiles(
+                                              Object^ state
+                                              )
+    {
+        for (int i = Interlocked::Increment(_nextPrefetchIndex) - 1;
+             i < _fontSources->Length;
+             i = Interlocked::Increment(_nextPrefetchIndex) - 1)
+        {
+            IDWriteFontFile* dwriteFontFile = NULL;
+            try
+            {
+                HRESULT hr = Factory::CreateFontFile(
+                                                    _factory,
+                                                    _fontFileLoader,
+                                                    _fontSources[i]->Uri,
+                                                    &dwriteFontFile
+                                                    );
+                if (SUCCEEDED(hr))
+                {
+                    BOOL                  isSupported;
+                    DWRITE_FONT_FILE_TYPE fontFileType;
+                    DWRITE_FONT_FACE_TYPE fontFaceType;
+                    UINT32                numberOfFaces;
+                    dwriteFontFile->Analyze(&isSupported, &fontFileType, &fontFaceType, &numberOfFaces);
+
+                    _prefetchedFontFiles[i] = IntPtr(dwriteFontFile);
+                    dwriteFontFile = NULL;
+                }
+            }
+            catch(System::Exception^)
+            {
+            }
+
+            if (dwriteFontFile != NULL)
+            {
+                dwriteFontFile->Release();
+            }
+        }
+
+        if (state != nullptr && Interlocked::Decrement(_pendingPrefetchWorkers) == 0)
+        {
+            _prefetchWorkersDone->Set();
+        }
+    }
+
+    void FontFileEnumerator::ReleasePrefetchedFontFiles()
+    {
+        if (_prefetchedFontFiles != nullptr)
+        {
+            for (int i = 0; i < _prefetchedFontFiles->Length; ++i)
+            {
+                if (_prefetchedFontFiles[i] != IntPtr::Zero)
+                {
+                    ((IDWriteFontFile*)_prefetchedFontFiles[i].ToPointer())->Release();
+                    _prefetchedFontFiles[i] = IntPtr::Zero;
+                }
+            }
+            _prefetchedFontFiles = nullptr;
+        }
     }
 
     /// <SecurityNote>
@@ -29,7 +143,11 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         HRESULT hr = S_OK;
         try
         {
-            hasCurrentFile = _fontSourceCollectionEnumerator->MoveNext();
+            if (_currentIndex < _fontSources->Length)
+            {
+                ++_currentIndex;
+            }
+            hasCurrentFile = (_currentIndex < _fontSources->Length);
         }
         catch(System::Exception^ exception)
         {
@@ -48,10 +166,23 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             return E_INVALIDARG;
         }
 
+        if (_currentIndex < 0 || _currentIndex >= _fontSources->Length)
+        {
+            return E_UNEXPECTED;
+        }
+
+        if (_prefetchedFontFiles != nullptr && _prefetchedFontFiles[_currentIndex] != IntPtr::Zero)
+        {
+            // Ownership of the prefetched reference passes to the caller.
+            *fontFile = (IDWriteFontFile*)_prefetchedFontFiles[_currentIndex].ToPointer();
+            _prefetchedFontFiles[_currentIndex] = IntPtr::Zero;
+            return S_OK;
+        }
+
         return Factory::CreateFontFile(
                                       _factory,
                                       _fontFileLoader,
-                                      _fontSourceCollectionEnumerator->Current->Uri,
+                                      _fontSources[_currentIndex]->Uri,
                                       fontFile
                                       );
     }
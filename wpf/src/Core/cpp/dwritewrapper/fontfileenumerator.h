@@ -9,6 +9,7 @@
 using namespace System;
 using namespace System::Collections::Generic;
 using namespace System::Diagnostics;
+using namespace System::Threading;
 
 namespace MS { namespace Internal { namespace Text { namespace TextInterface
 {
@@ -18,10 +19,34 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
     {     
         private:
 
-            IEnumerator<IFontSource^>^    _fontSourceCollectionEnumerator;
+            array<IFontSource^>^          _fontSources;
+            int                           _currentIndex;
             FontFileLoader^               _fontFileLoader;
             IDWriteFactory*               _factory;
 
+            /// <summary>
+            /// IDWriteFontFile pointers created ahead of time for large collections, indexed like _fontSources.
+            /// GetCurrentFontFile hands each one over to DWrite and clears its slot. Null when nothing was prefetched.
+            /// </summary>
+            array<IntPtr>^                _prefetchedFontFiles;
+            int                           _nextPrefetchIndex;
+            int                           _pendingPrefetchWorkers;
+            ManualResetEvent^             _prefetchWorkersDone;
+
+            /// <summary>
+            /// Collections smaller than this are enumerated lazily as before; larger ones have their
+            /// font files created and analyzed on the thread pool before DWrite starts enumerating.
+            /// </summary>
+            static const int MinimumSourcesPerPrefetchWorker = 32;
+
+            void PrefetchFontFiles();
+
+            void PrefetchFontFiles(
+                                  Object^ state
+                                  );
+
+            void ReleasePrefetchedFontFiles();
+
         public:
 
             FontFileEnumerator() { Debug::Assert(false); }
@@ -32,6 +57,10 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                               IDWriteFactory*            factory
                               );
 
+            ~FontFileEnumerator();
+
+            !FontFileEnumerator();
+
             /// <summary>
             /// Advances to the next font file in the collection. When it is first created, the enumerator is positioned
             /// before the first element of the collection and the first call to MoveNext advances to the first file.
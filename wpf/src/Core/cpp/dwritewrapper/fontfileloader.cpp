@@ -5,6 +5,66 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
     FontFileLoader::FontFileLoader(IFontSourceFactory^ fontSourceFactory)
     {
         _fontSourceFactory = fontSourceFactory;
+        _streamCache       = gcnew System::Collections::Generic::Dictionary<String^, WeakReference^>();
+    }
+
+    FontFileStream^ FontFileLoader::GetCachedStream(String^ uriString)
+    {
+        System::Threading::Monitor::Enter(_streamCache);
+        try
+        {
+            WeakReference^ reference;
+            if (_streamCache->TryGetValue(uriString, reference))
+            {
+                FontFileStream^ stream = safe_cast<FontFileStream^>(reference->Target);
+                if (stream == nullptr)
+                {
+                    _streamCache->Remove(uriString);
+                }
+                return stream;
+            }
+            return nullptr;
+        }
+        finally
+        {
+            System::Threading::Monitor::Exit(_streamCache);
+        }
+    }
+
+    void FontFileLoader::AddCachedStream(String^ uriString, FontFileStream^ stream)
+    {
+        System::Threading::Monitor::Enter(_streamCache);
+        try
+        {
+            if (_streamCache->Count >= MaxStreamCacheSize && !_streamCache->ContainsKey(uriString))
+            {
+                // Drop collected streams first; if every entry is still alive start over.
+                System::Collections::Generic::List<String^>^ deadKeys = gcnew System::Collections::Generic::List<String^>();
+                for each (System::Collections::Generic::KeyValuePair<String^, WeakReference^> entry in _streamCache)
+                {
+                    if (!entry.Value->IsAlive)
+                    {
+                        deadKeys->Add(entry.Key);
+                    }
+                }
+
+                for each (String^ key in deadKeys)
+                {
+                    _streamCache->Remove(key);
+                }
+
+                if (_streamCache->Count >= MaxStreamCacheSize)
+                {
+                    _streamCache->Clear();
+                }
+            }
+
+            _streamCache[uriString] = gcnew WeakReference(stream);
+        }
+        finally
+        {
+            System::Threading::Monitor::Exit(_streamCache);
+        }
     }
 
     /// <SecurityNote>
@@ -38,8 +98,15 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
 
         try
         {
-            IFontSource^ fontSource = _fontSourceFactory->Create(uriString);        
-            FontFileStream^ customFontFileStream = gcnew FontFileStream(fontSource);
+            // FontFileStream serializes its own reads, so a live stream can be shared by
+            // every DWrite reference to the same font file.
+            FontFileStream^ customFontFileStream = GetCachedStream(uriString);
+            if (customFontFileStream == nullptr)
+            {
+                IFontSource^ fontSource = _fontSourceFactory->Create(uriString);        
+                customFontFileStream = gcnew FontFileStream(fontSource);
+                AddCachedStream(uriString, customFontFileStream);
+            }
 
             IntPtr pIDWriteFontFileStreamMirror = Marshal::GetComInterfaceForObject(
                                                     customFontFileStream,
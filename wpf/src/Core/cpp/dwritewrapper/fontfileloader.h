@@ -17,6 +17,19 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
     {
         IFontSourceFactory^         _fontSourceFactory;
 
+        /// <summary>
+        /// Streams handed out to DWrite, by reference key, so a font DWrite asks for again
+        /// while its stream is still alive reuses it. Weak so the cache never keeps font
+        /// data alive on its own; bounded by MaxStreamCacheSize entries.
+        /// </summary>
+        System::Collections::Generic::Dictionary<String^, WeakReference^>^ _streamCache;
+
+        static const int MaxStreamCacheSize = 64;
+
+        FontFileStream^ GetCachedStream(String^ uriString);
+
+        void AddCachedStream(String^ uriString, FontFileStream^ stream);
+
     public:
 
         FontFileLoader() { Debug::Assert(false); }
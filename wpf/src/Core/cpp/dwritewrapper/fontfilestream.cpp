@@ -24,6 +24,26 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
 
         // Create lock to control access to font source stream.
         _fontSourceStreamLock = gcnew Object();
+
+        _fontSourceLength = _fontSourceStream->Length;
+
+        // Both mapped font files and in-memory fonts come back as an UnmanagedMemoryStream.
+        // Its memory stays put until the stream is closed, so fragments can point straight
+        // into it instead of being copied into pinned buffers.
+        _fontSourceMemory = NULL;
+        UnmanagedMemoryStream^ unmanagedStream = dynamic_cast<UnmanagedMemoryStream^>(_fontSourceStream);
+        if (unmanagedStream != nullptr)
+        {
+            try
+            {
+                unmanagedStream->Seek(0, System::IO::SeekOrigin::Begin);
+                _fontSourceMemory = unmanagedStream->PositionPointer;
+            }
+            catch(System::NotSupportedException^) // Streams over a SafeBuffer do not expose a pointer.
+            {
+                _fontSourceMemory = NULL;
+            }
+        }
     }
 
     FontFileStream::~FontFileStream()
@@ -55,12 +75,21 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                 || 
                 fileOffset > UINT64_MAX - fragmentSize           // make sure next sum doesn't overflow
                 || 
-                fileOffset + fragmentSize  > (UINT64)_fontSourceStream->Length // reading past the end of the Stream
+                fileOffset + fragmentSize  > (UINT64)_fontSourceLength // reading past the end of the Stream
               ) 
             {
                 return E_INVALIDARG;
             }
 
+            // Fast path: hand out a pointer into the font's memory. Nothing to lock,
+            // copy or release; a NULL context makes ReleaseFileFragment a no-op.
+            if (_fontSourceMemory != NULL)
+            {
+                *fragmentStart = _fontSourceMemory + fileOffset;
+                *fragmentContext = NULL;
+                return S_OK;
+            }
+
             int fragmentSizeInt = (int)fragmentSize;
             array<byte>^ buffer = gcnew array<byte>(fragmentSizeInt);
             
@@ -132,7 +161,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         HRESULT hr = S_OK;
         try
         {
-            *fileSize = _fontSourceStream->Length;
+            *fileSize = _fontSourceLength;
         }
         catch(System::Exception^ exception)
         {
@@ -24,6 +24,13 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             INT64                              _lastWriteTime;
             Object^                            _fontSourceStreamLock;
 
+            /// <SecurityNote>
+            /// SecurityCritical : Pointer to the font file data, NULL unless the
+            ///                    source stream exposes its memory directly.
+            /// </SecurityNote>
+            const byte*                        _fontSourceMemory;
+            INT64                              _fontSourceLength;
+
         public:
 
             /// Asserts false because COM convention requires us to have a default constructor
@@ -81,11 +81,15 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         // Lazily allocate the keys.
         if (_keys == nullptr)
         {
-            _keys = gcnew array<CultureInfo^>(StringsCount);
-            for(unsigned int i = 0; i < StringsCount; i++)
+            array<String^>^ localeNames = GetAllStrings(true);
+            array<CultureInfo^>^ keys = gcnew array<CultureInfo^>(localeNames->Length);
+            for(int i = 0; i < localeNames->Length; i++)
             {
-                _keys[i] = gcnew CultureInfo(GetLocaleName(i));
+                // GetCultureInfo hands out one cached read only instance per name for the
+                // whole process, instead of a new CultureInfo per font name.
+                keys[i] = CultureInfo::GetCultureInfo(localeNames[i]);
             }
+            _keys = keys;
         }
         return _keys;
     }
@@ -105,15 +109,71 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
     {
         if (_values == nullptr)
         {
-            _values = gcnew array<String^>(StringsCount);
-            
-            for(unsigned int i = 0; i < StringsCount; i++)
+            _values = GetAllStrings(false);
+        }
+
+        return _values;
+    }
+
+    /// <SecurityNote>
+    /// Critical - Asserts unmanaged code permission to allocate and delete a native WCHAR buffer.
+    ///            Uses security critical member _localizedStrings.
+    /// TreatAsSafe - Caller does not control size of native buffer and buffer is not exposed.
+    ///             - Method does not return critical data.
+    /// </SecurityNote>
+    [SecuritySafeCritical]
+    [SecurityPermission(SecurityAction::Assert, UnmanagedCode=true)]
+    __declspec(noinline) array<System::String^>^ LocalizedStrings::GetAllStrings(
+                                                            bool localeNames
+                                                            )
+    {
+        UINT32 count = StringsCount;
+        array<System::String^>^ strings = gcnew array<System::String^>(count);
+
+        if (count == 0)
+        {
+            return strings;
+        }
+
+        IDWriteLocalizedStrings* localizedStrings = _localizedStrings->Value;
+
+        // Length pass, so one buffer fits every entry.
+        UINT32 maxLength = 0;
+        for (UINT32 i = 0; i < count; i++)
+        {
+            UINT32 length = 0;
+            HRESULT hr = localeNames ? localizedStrings->GetLocaleNameLength(i, &length)
+                                     : localizedStrings->GetStringLength(i, &length);
+            ConvertHresultToException(hr, "array<String^>^ LocalizedStrings::GetAllStrings");
+            if (length > maxLength)
             {
-                _values[i] = GetString(i);
+                maxLength = length;
             }
         }
 
-        return _values;
+        MS::Internal::Invariant::Assert(maxLength < UINT_MAX);
+        WCHAR* buffer = NULL;
+        try
+        {
+            buffer = new WCHAR[maxLength + 1];
+            for (UINT32 i = 0; i < count; i++)
+            {
+                HRESULT hr = localeNames ? localizedStrings->GetLocaleName(i, buffer, maxLength + 1)
+                                         : localizedStrings->GetString(i, buffer, maxLength + 1);
+                ConvertHresultToException(hr, "array<String^>^ LocalizedStrings::GetAllStrings");
+                strings[i] = gcnew System::String(buffer);
+            }
+        }
+        finally
+        {
+            if (buffer != NULL)
+            {
+                delete[] buffer;
+            }
+        }
+
+        System::GC::KeepAlive(_localizedStrings);
+        return strings;
     }
 
     /// <SecurityNote>
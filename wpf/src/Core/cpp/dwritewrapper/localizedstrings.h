@@ -45,6 +45,16 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                                   UINT32 index
                                   );
            
+            /// <summary>
+            /// Reads every locale name (or every string) in one pass, through a single
+            /// buffer sized to the longest entry.
+            /// </summary>
+            /// <param name="localeNames">True for the locale names, false for the strings.</param>
+            /// <returns>The names or strings, in index order.</returns>
+            array<String^>^ GetAllStrings(
+                                        bool localeNames
+                                        );
+
             // This is a lazily initialized array of CultureInfo's used when this
             // object is used through the ICollection interface.
             array<CultureInfo^>^ _keys;
@@ -159,67 +159,37 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         )
     {
         // Text will never be of zero length. This is enforced by Itemize().
-        bool isCombining;
-        bool needsCaretInfo;
-        bool isIndic;
-        bool isDigit;
-        bool isLatin;
-        bool isStrong;
-        bool isExtended;
-
-        classificationUtility->GetCharAttribute(
-            text[0],
-            isCombining,
-            needsCaretInfo,
-            isIndic,
-            isDigit,
-            isLatin,
-            isStrong
-            );
+        LatinCharClassification^ latin = GetLatinCharClassification(classificationUtility);
 
-        isExtended = ItemizerHelper::IsExtendedCharacter(text[0]);
+        bool isDigit;
 
         UINT32 isDigitRangeStart = 0;
         UINT32 isDigitRangeEnd = 0;
-        bool   previousIsDigitValue = (numberCulture == nullptr) ? false : isDigit;
+        bool   previousIsDigitValue = false;
         bool   currentIsDigitValue;
 
-        // pCharAttribute is assumed to have the same length as text. This is enforced by Itemize().
-        pCharAttribute[0] = (CharAttributeType)
-                            (((isCombining)    ? CharAttribute::IsCombining    : CharAttribute::None)
-                           | ((needsCaretInfo) ? CharAttribute::NeedsCaretInfo : CharAttribute::None)
-                           | ((isLatin)        ? CharAttribute::IsLatin        : CharAttribute::None)
-                           | ((isIndic)        ? CharAttribute::IsIndic        : CharAttribute::None)
-                           | ((isStrong)       ? CharAttribute::IsStrong       : CharAttribute::None)
-                           | ((isExtended)     ? CharAttribute::IsExtended     : CharAttribute::None));
-
-        UINT32 i = 1;
+        UINT32 i = 0;
         for (; i < length; ++i)
         {
-            classificationUtility->GetCharAttribute(
-            text[i],
-            isCombining,
-            needsCaretInfo,
-            isIndic,
-            isDigit,
-            isLatin,
-            isStrong
-            );
-
-            isExtended = ItemizerHelper::IsExtendedCharacter(text[i]);
-            
-
-            pCharAttribute[i] = (CharAttributeType)
-                                (((isCombining)    ? CharAttribute::IsCombining    : CharAttribute::None)
-                               | ((needsCaretInfo) ? CharAttribute::NeedsCaretInfo : CharAttribute::None)
-                               | ((isLatin)        ? CharAttribute::IsLatin        : CharAttribute::None)
-                               | ((isIndic)        ? CharAttribute::IsIndic        : CharAttribute::None)
-                               | ((isStrong)       ? CharAttribute::IsStrong       : CharAttribute::None)
-                               | ((isExtended)     ? CharAttribute::IsExtended     : CharAttribute::None));
+            WCHAR ch = text[i];
 
+            // pCharAttribute is assumed to have the same length as text. This is enforced by Itemize().
+            if (ch < LatinCharClassificationLength)
+            {
+                pCharAttribute[i] = latin->charAttributes[ch];
+                isDigit           = latin->isDigit[ch];
+            }
+            else
+            {
+                pCharAttribute[i] = GetCharAttribute(ch, classificationUtility, isDigit);
+            }
 
             currentIsDigitValue = (numberCulture == nullptr) ? false : isDigit;
-            if (previousIsDigitValue != currentIsDigitValue)
+            if (i == 0)
+            {
+                previousIsDigitValue = currentIsDigitValue;
+            }
+            else if (previousIsDigitValue != currentIsDigitValue)
             {
 
                 isDigitRangeEnd = i;
@@ -235,6 +205,69 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         textItemizer->SetIsDigit(isDigitRangeStart, isDigitRangeEnd - isDigitRangeStart, previousIsDigitValue);
     }
 
+    CharAttributeType TextAnalyzer::GetCharAttribute(
+        WCHAR            ch,
+        IClassification^ classificationUtility,
+        bool%            isDigit
+        )
+    {
+        bool isCombining;
+        bool needsCaretInfo;
+        bool isIndic;
+        bool isLatin;
+        bool isStrong;
+        bool isDigitValue;
+
+        classificationUtility->GetCharAttribute(
+            ch,
+            isCombining,
+            needsCaretInfo,
+            isIndic,
+            isDigitValue,
+            isLatin,
+            isStrong
+            );
+
+        bool isExtended = ItemizerHelper::IsExtendedCharacter(ch);
+
+        isDigit = isDigitValue;
+
+        return (CharAttributeType)
+               (((isCombining)    ? CharAttribute::IsCombining    : CharAttribute::None)
+              | ((needsCaretInfo) ? CharAttribute::NeedsCaretInfo : CharAttribute::None)
+              | ((isLatin)        ? CharAttribute::IsLatin        : CharAttribute::None)
+              | ((isIndic)        ? CharAttribute::IsIndic        : CharAttribute::None)
+              | ((isStrong)       ? CharAttribute::IsStrong       : CharAttribute::None)
+              | ((isExtended)     ? CharAttribute::IsExtended     : CharAttribute::None));
+    }
+
+    LatinCharClassification^ TextAnalyzer::GetLatinCharClassification(
+        IClassification^ classificationUtility
+        )
+    {
+        LatinCharClassification^ latin = _latinCharClassification;
+
+        if (latin == nullptr || latin->classificationUtility != classificationUtility)
+        {
+            latin = gcnew LatinCharClassification();
+            latin->classificationUtility = classificationUtility;
+            latin->charAttributes        = gcnew array<CharAttributeType>(LatinCharClassificationLength);
+            latin->isDigit               = gcnew array<bool>(LatinCharClassificationLength);
+
+            for (UINT32 ch = 0; ch < LatinCharClassificationLength; ++ch)
+            {
+                bool isDigit;
+                latin->charAttributes[ch] = GetCharAttribute((WCHAR)ch, classificationUtility, isDigit);
+                latin->isDigit[ch]        = isDigit;
+            }
+
+            // Racing threads fill identical tables, so last writer wins.
+            _latinCharClassification = latin;
+        }
+
+        return latin;
+    }
+
     /// <SecurityNote>
     /// Critical    - Receives pointers, arrays and their bounds as input.
     /// </SecurityNote>
@@ -372,6 +405,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             UINT32 featureRanges = 0;
             array<GCHandle>^ dwriteFontFeaturesGCHandles = nullptr;
             DWRITE_TYPOGRAPHIC_FEATURES** dwriteTypographicFeatures = NULL;
+            DWRITE_TYPOGRAPHIC_FEATURES*  dwriteTypographicFeatureRanges = NULL;
 
 
             if (features != nullptr)
@@ -381,6 +415,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                 featureRanges = (UINT32)featureRangeLengths->Length;
                 dwriteFontFeaturesGCHandles = gcnew array<GCHandle>(featureRanges);
                 dwriteTypographicFeatures = new DWRITE_TYPOGRAPHIC_FEATURES*[featureRanges];
+                dwriteTypographicFeatureRanges = new DWRITE_TYPOGRAPHIC_FEATURES[featureRanges];
             }
 
             FontFace^ fontFace = font->GetFontFace();
@@ -391,7 +426,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                     for (UINT32 i = 0; i < featureRanges; ++i)
                     {
                         dwriteFontFeaturesGCHandles[i] = GCHandle::Alloc(features[i], GCHandleType::Pinned);
-                        dwriteTypographicFeatures[i] = new DWRITE_TYPOGRAPHIC_FEATURES();
+                        dwriteTypographicFeatures[i] = &dwriteTypographicFeatureRanges[i];
                         dwriteTypographicFeatures[i]->features = reinterpret_cast<DWRITE_FONT_FEATURE*>(dwriteFontFeaturesGCHandles[i].AddrOfPinnedObject().ToPointer());
                         dwriteTypographicFeatures[i]->featureCount = features[i]->Length;
                     }
@@ -460,7 +495,6 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                     for (UINT32 i = 0; i < featureRanges; ++i)
                     {
                         dwriteFontFeaturesGCHandles[i].Free();
-                        delete dwriteTypographicFeatures[i];
                     }
                 }
 
@@ -493,6 +527,11 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                 {
                     delete[] dwriteTypographicFeatures;
                 }
+
+                if (dwriteTypographicFeatureRanges != NULL)
+                {
+                    delete[] dwriteTypographicFeatureRanges;
+                }
             }
         }
     }
@@ -642,6 +681,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             array<GCHandle>^ dwriteFontFeaturesGCHandles = nullptr;
             UINT32 featureRanges = 0;
             DWRITE_TYPOGRAPHIC_FEATURES** dwriteTypographicFeatures = NULL;
+            DWRITE_TYPOGRAPHIC_FEATURES*  dwriteTypographicFeatureRanges = NULL;
             pin_ptr<UINT32> pFeatureRangeLengthsPinned;
             UINT32* pFeatureRangeLengths = NULL;
 
@@ -649,6 +689,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             {
                 featureRanges = (UINT32)featureRangeLengths->Length;
                 dwriteTypographicFeatures = new DWRITE_TYPOGRAPHIC_FEATURES*[featureRanges];
+                dwriteTypographicFeatureRanges = new DWRITE_TYPOGRAPHIC_FEATURES[featureRanges];
                 pFeatureRangeLengthsPinned = &featureRangeLengths[0];
                 pFeatureRangeLengths = reinterpret_cast<UINT32*> (pFeatureRangeLengthsPinned);
                 dwriteFontFeaturesGCHandles = gcnew array<GCHandle>(featureRanges);
@@ -666,7 +707,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                     for (UINT32 i = 0; i < featureRanges; ++i)
                     {
                         dwriteFontFeaturesGCHandles[i] = GCHandle::Alloc(features[i], GCHandleType::Pinned);
-                        dwriteTypographicFeatures[i] = new DWRITE_TYPOGRAPHIC_FEATURES();
+                        dwriteTypographicFeatures[i] = &dwriteTypographicFeatureRanges[i];
                         dwriteTypographicFeatures[i]->features = reinterpret_cast<DWRITE_FONT_FEATURE*>(dwriteFontFeaturesGCHandles[i].AddrOfPinnedObject().ToPointer());
                         dwriteTypographicFeatures[i]->featureCount = features[i]->Length;
                     }
@@ -792,7 +833,6 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                     for (UINT32 i = 0; i < featureRanges; ++i)
                     {
                         dwriteFontFeaturesGCHandles[i].Free();
-                        delete dwriteTypographicFeatures[i];
                     }
                 }
 
@@ -836,6 +876,11 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                 {
                     delete[] dwriteTypographicFeatures;
                 }
+
+                if (dwriteTypographicFeatureRanges != NULL)
+                {
+                    delete[] dwriteTypographicFeatureRanges;
+                }
             }
         }
     }
@@ -870,100 +915,404 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         [System::Runtime::InteropServices::Out] array<GlyphOffset>   ^% glyphOffsets
         )
     {
-        UINT32 maxGlyphCount = 3 * textLength;
-        clusterMap = gcnew array<unsigned short>(textLength);
-        pin_ptr<unsigned short> pclusterMapPinned = &clusterMap[0];
-
-        DWRITE_SHAPING_TEXT_PROPERTIES*  textProps          = new DWRITE_SHAPING_TEXT_PROPERTIES[textLength];
-        DWRITE_SHAPING_GLYPH_PROPERTIES* glyphProps         = NULL;
-        unsigned short*                  glyphIndicesNative = NULL;
-
-        try
+        ShapingCacheKey^ shapingCacheKey = nullptr;
+        if (_shapingCacheMemoryLimit > 0)
         {
-            UINT32 actualGlyphCount = maxGlyphCount + 1;
+            shapingCacheKey = CreateShapingCacheKey(
+                textString,
+                textLength,
+                font,
+                blankGlyphIndex,
+                isSideways,
+                isRightToLeft,
+                cultureInfo,
+                features,
+                featureRangeLengths,
+                fontEmSize,
+                scalingFactor,
+                pixelsPerDip,
+                textFormattingMode,
+                itemProps
+                );
 
-            // Loop and everytime increase the size of the GlyphIndices buffer.
-            while(actualGlyphCount > maxGlyphCount)
+            if (shapingCacheKey != nullptr
+                && LookupShapingCache(shapingCacheKey, clusterMap, glyphIndices, glyphAdvances, glyphOffsets))
             {
-                maxGlyphCount = actualGlyphCount;
-                if (glyphProps != NULL)
-                {
-                    delete[] glyphProps;
-                    glyphProps = NULL;
-                }
-                glyphProps   = new DWRITE_SHAPING_GLYPH_PROPERTIES[maxGlyphCount];
+                return;
+            }
+        }
 
-                if (glyphIndicesNative != NULL)
-                {
-                    delete[] glyphIndicesNative;
-                    glyphIndicesNative = NULL;
-                }
-                glyphIndicesNative = new unsigned short[maxGlyphCount];
+        // DWrite's own estimate of the glyph count for a run of this length.
+        UINT32 maxGlyphCount = 3 * textLength / 2 + 16;
+        clusterMap = gcnew array<unsigned short>(textLength);
+        pin_ptr<unsigned short> pclusterMapPinned = &clusterMap[0];
 
-                GetGlyphs(
-                    textString,
-                    textLength,
-                    font,
-                    blankGlyphIndex,
-                    isSideways,
-                    isRightToLeft,
-                    cultureInfo,
-                    features,
-                    featureRangeLengths,
-                    maxGlyphCount,
-                    textFormattingMode,
-                    itemProps,
-                    reinterpret_cast<UINT16*> (pclusterMapPinned),
-                    (UINT16*) textProps,
-                    reinterpret_cast<UINT16*> (glyphIndicesNative),
-                    reinterpret_cast<UINT32*> (glyphProps),
-                    NULL,
-                    actualGlyphCount
-                    );
-            }
+        array<UINT16>^ textProps = GetShapingScratch(_textPropsScratch, textLength);
+        pin_ptr<UINT16> pTextPropsPinned = &textProps[0];
+
+        array<UINT16>^ glyphProps = nullptr;
+        array<UINT16>^ glyphIndicesScratch = nullptr;
+        pin_ptr<UINT16> pGlyphPropsPinned;
+        pin_ptr<UINT16> pGlyphIndicesPinned;
 
-            glyphIndices = gcnew array<unsigned short>(actualGlyphCount);
-            Marshal::Copy(System::IntPtr((void*)glyphIndicesNative), (array<Int16>^)glyphIndices, 0, actualGlyphCount);
+        UINT32 actualGlyphCount = maxGlyphCount + 1;
+
+        // Loop and everytime increase the size of the GlyphIndices buffer.
+        while(actualGlyphCount > maxGlyphCount)
+        {
+            maxGlyphCount = actualGlyphCount;
 
-            glyphAdvances = gcnew array<int>(actualGlyphCount);
-            pin_ptr<int> glyphAdvancesPinned = &glyphAdvances[0]; 
-            glyphOffsets = gcnew array<GlyphOffset>(actualGlyphCount);
+            // DWRITE_SHAPING_GLYPH_PROPERTIES is 16 bits, as is a glyph index.
+            glyphProps          = GetShapingScratch(_glyphPropsScratch, maxGlyphCount);
+            glyphIndicesScratch = GetShapingScratch(_glyphIndicesScratch, maxGlyphCount);
+            pGlyphPropsPinned   = &glyphProps[0];
+            pGlyphIndicesPinned = &glyphIndicesScratch[0];
 
-            GetGlyphPlacements(
+            GetGlyphs(
                 textString,
-                reinterpret_cast<UINT16*> (pclusterMapPinned),
-                (UINT16*) textProps,
                 textLength,
-                reinterpret_cast<UINT16*> (glyphIndicesNative),
-                reinterpret_cast<UINT32*> (glyphProps),
-                actualGlyphCount,
                 font,
-                fontEmSize,
-                scalingFactor,
+                blankGlyphIndex,
                 isSideways,
                 isRightToLeft,
                 cultureInfo,
                 features,
                 featureRangeLengths,
+                maxGlyphCount,
                 textFormattingMode,
                 itemProps,
-                pixelsPerDip,
-                reinterpret_cast<int*>(glyphAdvancesPinned),
-                glyphOffsets
+                reinterpret_cast<UINT16*> (pclusterMapPinned),
+                reinterpret_cast<UINT16*> (pTextPropsPinned),
+                reinterpret_cast<UINT16*> (pGlyphIndicesPinned),
+                reinterpret_cast<UINT32*> (pGlyphPropsPinned),
+                NULL,
+                actualGlyphCount
                 );
         }
+
+        glyphIndices = gcnew array<unsigned short>(actualGlyphCount);
+        Array::Copy(glyphIndicesScratch, glyphIndices, (int)actualGlyphCount);
+
+        glyphAdvances = gcnew array<int>(actualGlyphCount);
+        pin_ptr<int> glyphAdvancesPinned = &glyphAdvances[0]; 
+        glyphOffsets = gcnew array<GlyphOffset>(actualGlyphCount);
+
+        GetGlyphPlacements(
+            textString,
+            reinterpret_cast<UINT16*> (pclusterMapPinned),
+            reinterpret_cast<UINT16*> (pTextPropsPinned),
+            textLength,
+            reinterpret_cast<UINT16*> (pGlyphIndicesPinned),
+            reinterpret_cast<UINT32*> (pGlyphPropsPinned),
+            actualGlyphCount,
+            font,
+            fontEmSize,
+            scalingFactor,
+            isSideways,
+            isRightToLeft,
+            cultureInfo,
+            features,
+            featureRangeLengths,
+            textFormattingMode,
+            itemProps,
+            pixelsPerDip,
+            reinterpret_cast<int*>(glyphAdvancesPinned),
+            glyphOffsets
+            );
+
+        if (shapingCacheKey != nullptr)
+        {
+            AddToShapingCache(shapingCacheKey, clusterMap, glyphIndices, glyphAdvances, glyphOffsets);
+        }
+    }
+
+    array<UINT16>^ TextAnalyzer::GetShapingScratch(
+        array<UINT16>^% scratch,
+        UINT32 length
+        )
+    {
+        // Never hand out an empty array; callers pin its first element.
+        if (length == 0)
+        {
+            length = 1;
+        }
+
+        if (scratch != nullptr && (UINT32)scratch->Length >= length)
+        {
+            return scratch;
+        }
+
+        array<UINT16>^ buffer = gcnew array<UINT16>(length);
+        if (length <= MaxShapingScratchLength)
+        {
+            scratch = buffer;
+        }
+
+        return buffer;
+    }
+
+    bool ShapingCacheKey::Equals(Object^ obj)
+    {
+        ShapingCacheKey^ other = dynamic_cast<ShapingCacheKey^>(obj);
+        if (other == nullptr)
+        {
+            return false;
+        }
+
+        if (   font               != other->font
+            || blankGlyphIndex    != other->blankGlyphIndex
+            || isSideways         != other->isSideways
+            || isRightToLeft      != other->isRightToLeft
+            || fontEmSize         != other->fontEmSize
+            || scalingFactor      != other->scalingFactor
+            || pixelsPerDip       != other->pixelsPerDip
+            || textFormattingMode != other->textFormattingMode
+            || script             != other->script
+            || !String::Equals(text, other->text)
+            || !String::Equals(cultureName, other->cultureName))
+        {
+            return false;
+        }
+
+        if (features == nullptr || other->features == nullptr)
+        {
+            return features == other->features;
+        }
+
+        if (features->Length != other->features->Length)
+        {
+            return false;
+        }
+
+        for (int i = 0; i < features->Length; ++i)
+        {
+            if (features[i] != other->features[i])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    int ShapingCacheKey::GetHashCode()
+    {
+        int hash = text->GetHashCode();
+        hash = hash * 31 + System::Runtime::CompilerServices::RuntimeHelpers::GetHashCode(font);
+        hash = hash * 31 + fontEmSize.GetHashCode();
+        hash = hash * 31 + (int)script;
+        hash = hash * 31 + (isRightToLeft ? 1 : 0) + (isSideways ? 2 : 0);
+        return hash;
+    }
+
+    /// <SecurityNote>
+    /// Critical    - Reads the native script analysis and the text buffer.
+    /// </SecurityNote>
+    [SecurityCritical]
+    ShapingCacheKey^ TextAnalyzer::CreateShapingCacheKey(
+        __in_ecount(textLength) const WCHAR* textString,
+        UINT32 textLength,
+        Font^ font,
+        UINT16 blankGlyphIndex,
+        bool isSideways,
+        bool isRightToLeft,
+        CultureInfo^ cultureInfo,
+        array<array<DWriteFontFeature>^>^ features,
+        array<UINT32>^ featureRangeLengths,
+        double fontEmSize,
+        double scalingFactor,
+        float pixelsPerDip,
+        TextFormattingMode textFormattingMode,
+        ItemProps^ itemProps
+        )
+    {
+        // Number substitution objects have no value identity we could key on.
+        if (itemProps->NumberSubstitutionNoAddRef != NULL)
+        {
+            return nullptr;
+        }
+
+        ShapingCacheKey^ key = gcnew ShapingCacheKey();
+
+        key->text               = gcnew String(textString, 0, (int)textLength);
+        key->font               = font;
+        key->blankGlyphIndex    = blankGlyphIndex;
+        key->isSideways         = isSideways;
+        key->isRightToLeft      = isRightToLeft;
+        key->cultureName        = cultureInfo->IetfLanguageTag;
+        key->fontEmSize         = fontEmSize;
+        key->scalingFactor      = scalingFactor;
+        key->pixelsPerDip       = pixelsPerDip;
+        key->textFormattingMode = textFormattingMode;
+
+        DWRITE_SCRIPT_ANALYSIS* scriptAnalysis = (DWRITE_SCRIPT_ANALYSIS*)(itemProps->ScriptAnalysis);
+        key->script = ((UINT32)scriptAnalysis->script << 16) | (UINT32)scriptAnalysis->shapes;
+
+        if (features != nullptr)
+        {
+            int count = 0;
+            for (int i = 0; i < features->Length; ++i)
+            {
+                count += 2 + 2 * features[i]->Length;
+            }
+
+            key->features = gcnew array<UINT32>(count);
+
+            int index = 0;
+            for (int i = 0; i < features->Length; ++i)
+            {
+                key->features[index++] = featureRangeLengths[i];
+                key->features[index++] = (UINT32)features[i]->Length;
+                for (int j = 0; j < features[i]->Length; ++j)
+                {
+                    key->features[index++] = (UINT32)features[i][j].nameTag;
+                    key->features[index++] = features[i][j].parameter;
+                }
+            }
+        }
+
+        return key;
+    }
+
+    bool TextAnalyzer::LookupShapingCache(
+        ShapingCacheKey^ key,
+        array<unsigned short>^% clusterMap,
+        array<unsigned short>^% glyphIndices,
+        array<int>           ^% glyphAdvances,
+        array<GlyphOffset>   ^% glyphOffsets
+        )
+    {
+        ShapingCacheEntry^ entry = nullptr;
+
+        System::Threading::Monitor::Enter(_shapingCacheLock);
+        try
+        {
+            System::Collections::Generic::LinkedListNode<ShapingCacheEntry^>^ node = nullptr;
+            if (_shapingCache != nullptr && _shapingCache->TryGetValue(key, node))
+            {
+                _shapingCacheLru->Remove(node);
+                _shapingCacheLru->AddFirst(node);
+                entry = node->Value;
+                ++_shapingCacheHits;
+            }
+            else
+            {
+                ++_shapingCacheMisses;
+            }
+        }
         finally
         {
-            delete[] textProps;
-            if (glyphProps != NULL)
+            System::Threading::Monitor::Exit(_shapingCacheLock);
+        }
+
+        if (entry == nullptr)
+        {
+            return false;
+        }
+
+        // Entries are shared; callers get their own copies.
+        clusterMap    = safe_cast<array<unsigned short>^>(entry->clusterMap->Clone());
+        glyphIndices  = safe_cast<array<unsigned short>^>(entry->glyphIndices->Clone());
+        glyphAdvances = safe_cast<array<int>^>(entry->glyphAdvances->Clone());
+        glyphOffsets  = safe_cast<array<GlyphOffset>^>(entry->glyphOffsets->Clone());
+        return true;
+    }
+
+    void TextAnalyzer::AddToShapingCache(
+        ShapingCacheKey^ key,
+        array<unsigned short>^ clusterMap,
+        array<unsigned short>^ glyphIndices,
+        array<int>           ^ glyphAdvances,
+        array<GlyphOffset>   ^ glyphOffsets
+        )
+    {
+        ShapingCacheEntry^ entry = gcnew ShapingCacheEntry();
+        entry->key           = key;
+        entry->clusterMap    = safe_cast<array<unsigned short>^>(clusterMap->Clone());
+        entry->glyphIndices  = safe_cast<array<unsigned short>^>(glyphIndices->Clone());
+        entry->glyphAdvances = safe_cast<array<int>^>(glyphAdvances->Clone());
+        entry->glyphOffsets  = safe_cast<array<GlyphOffset>^>(glyphOffsets->Clone());
+        entry->size          = 2 * key->text->Length
+                             + 2 * clusterMap->Length
+                             + (2 + 4 + (int)sizeof(GlyphOffset)) * glyphIndices->Length;
+
+        System::Threading::Monitor::Enter(_shapingCacheLock);
+        try
+        {
+            if (_shapingCacheMemoryLimit <= 0 || entry->size > _shapingCacheMemoryLimit)
+            {
+                return;
+            }
+
+            if (_shapingCache == nullptr)
+            {
+                _shapingCache = gcnew System::Collections::Generic::Dictionary<ShapingCacheKey^, System::Collections::Generic::LinkedListNode<ShapingCacheEntry^>^>();
+                _shapingCacheLru = gcnew System::Collections::Generic::LinkedList<ShapingCacheEntry^>();
+            }
+
+            // Another thread may have shaped the same run meanwhile.
+            if (_shapingCache->ContainsKey(key))
             {
-                delete[] glyphProps;
+                return;
             }
-            if (glyphIndicesNative != NULL)
+
+            while (_shapingCacheSize + entry->size > _shapingCacheMemoryLimit)
             {
-                delete[] glyphIndicesNative;
+                ShapingCacheEntry^ evicted = _shapingCacheLru->Last->Value;
+                _shapingCacheLru->RemoveLast();
+                _shapingCache->Remove(evicted->key);
+                _shapingCacheSize -= evicted->size;
             }
+
+            _shapingCache->Add(key, _shapingCacheLru->AddFirst(entry));
+            _shapingCacheSize += entry->size;
+        }
+        finally
+        {
+            System::Threading::Monitor::Exit(_shapingCacheLock);
+        }
+    }
+
+    int TextAnalyzer::ShapingCacheMemoryLimit::get()
+    {
+        return _shapingCacheMemoryLimit;
+    }
+
+    void TextAnalyzer::ShapingCacheMemoryLimit::set(int value)
+    {
+        if (value < 0)
+        {
+            throw gcnew System::ArgumentOutOfRangeException("value");
         }
+
+        System::Threading::Monitor::Enter(_shapingCacheLock);
+        try
+        {
+            _shapingCacheMemoryLimit = value;
+
+            // Trim to the new limit; a limit of 0 drops everything.
+            while (_shapingCacheLru != nullptr && _shapingCacheSize > _shapingCacheMemoryLimit)
+            {
+                ShapingCacheEntry^ evicted = _shapingCacheLru->Last->Value;
+                _shapingCacheLru->RemoveLast();
+                _shapingCache->Remove(evicted->key);
+                _shapingCacheSize -= evicted->size;
+            }
+        }
+        finally
+        {
+            System::Threading::Monitor::Exit(_shapingCacheLock);
+        }
+    }
+
+    int TextAnalyzer::ShapingCacheHits::get()
+    {
+        return _shapingCacheHits;
+    }
+
+    int TextAnalyzer::ShapingCacheMisses::get()
+    {
+        return _shapingCacheMisses;
     }
 
     /// <SecurityNote>
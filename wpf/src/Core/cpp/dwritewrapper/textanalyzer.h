@@ -76,6 +76,59 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
     /// </SecurityNote>
     [SecurityCritical]
     private delegate void* GetNumberSubstitutionList(void*);
+
+    /// <summary>
+    /// Identifies a shaping request in the TextAnalyzer shaping cache: everything
+    /// GetGlyphsAndTheirPlacements bases its output on.
+    /// </summary>
+    private ref class ShapingCacheKey sealed
+    {
+        internal:
+
+            String^            text;
+            Font^              font;
+            UINT16             blankGlyphIndex;
+            bool               isSideways;
+            bool               isRightToLeft;
+            String^            cultureName;
+            array<UINT32>^     features;          // per range: length, feature count, then tag/parameter pairs
+            double             fontEmSize;
+            double             scalingFactor;
+            float              pixelsPerDip;
+            TextFormattingMode textFormattingMode;
+            UINT32             script;            // DWRITE_SCRIPT_ANALYSIS script and shapes
+
+            virtual bool Equals(Object^ obj) override;
+            virtual int GetHashCode() override;
+    };
+
+    /// <summary>
+    /// Output of one GetGlyphsAndTheirPlacements call held by the shaping cache.
+    /// </summary>
+    private ref class ShapingCacheEntry sealed
+    {
+        internal:
+
+            ShapingCacheKey^       key;
+            array<unsigned short>^ clusterMap;
+            array<unsigned short>^ glyphIndices;
+            array<int>^            glyphAdvances;
+            array<GlyphOffset>^    glyphOffsets;
+            int                    size;       // approximate bytes held
+    };
+
+    /// <summary>
+    /// CharAttribute flags and digit classification of U+0000..U+00FF as reported
+    /// by one IClassification, so Latin text skips the per character call.
+    /// </summary>
+    private ref class LatinCharClassification sealed
+    {
+        internal:
+
+            IClassification^             classificationUtility;
+            array<CharAttributeType>^    charAttributes;
+            array<bool>^                 isDigit;
+    };
     /// <summary>
     /// This class is responsible for Text Analysis and Shaping.
     /// For the most part it mirrors the DWrite IDWriteTextAnalyzer interface
@@ -90,6 +143,95 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             [SecurityCritical]
             NativeIUnknownWrapper<IDWriteTextAnalyzer>^ _textAnalyzer;
 
+            /// <summary>
+            /// Per-thread shaping buffers reused by GetGlyphsAndTheirPlacements, grown as needed.
+            /// </summary>
+            [ThreadStatic]
+            static array<UINT16>^ _textPropsScratch;
+
+            [ThreadStatic]
+            static array<UINT16>^ _glyphPropsScratch;
+
+            [ThreadStatic]
+            static array<UINT16>^ _glyphIndicesScratch;
+
+            /// <summary>
+            /// Longest buffer kept for reuse; longer runs get a buffer of their own
+            /// so one huge run does not pin memory for the life of the thread.
+            /// </summary>
+            static const UINT32 MaxShapingScratchLength = 4096;
+
+            static array<UINT16>^ GetShapingScratch(
+                array<UINT16>^% scratch,
+                UINT32 length
+                );
+
+            /// <summary>
+            /// Opt-in LRU cache of shaping results, most recently used first.
+            /// Disabled while _shapingCacheMemoryLimit is 0.
+            /// </summary>
+            static System::Collections::Generic::Dictionary<ShapingCacheKey^, System::Collections::Generic::LinkedListNode<ShapingCacheEntry^>^>^ _shapingCache;
+            static System::Collections::Generic::LinkedList<ShapingCacheEntry^>^ _shapingCacheLru;
+            static Object^ _shapingCacheLock = gcnew Object();
+            static int _shapingCacheMemoryLimit;
+            static int _shapingCacheSize;
+            static int _shapingCacheHits;
+            static int _shapingCacheMisses;
+
+            /// <summary>
+            /// Classification of U+0000..U+00FF for the last classification utility seen,
+            /// published as a whole so readers never see a partially filled table.
+            /// </summary>
+            static LatinCharClassification^ _latinCharClassification;
+            static const UINT32 LatinCharClassificationLength = 0x100;
+
+            static CharAttributeType GetCharAttribute(
+                WCHAR            ch,
+                IClassification^ classificationUtility,
+                [System::Runtime::InteropServices::Out] bool% isDigit
+                );
+
+            static LatinCharClassification^ GetLatinCharClassification(
+                IClassification^ classificationUtility
+                );
+
+            /// <SecurityNote>
+            /// Critical    - Reads the native script analysis and the text buffer.
+            /// </SecurityNote>
+            [SecurityCritical]
+            static ShapingCacheKey^ CreateShapingCacheKey(
+                __in_ecount(textLength) const WCHAR* textString,
+                UINT32 textLength,
+                Font^ font,
+                UINT16 blankGlyphIndex,
+                bool isSideways,
+                bool isRightToLeft,
+                CultureInfo^ cultureInfo,
+                array<array<DWriteFontFeature>^>^ features,
+                array<UINT32>^ featureRangeLengths,
+                double fontEmSize,
+                double scalingFactor,
+                float pixelsPerDip,
+                TextFormattingMode textFormattingMode,
+                ItemProps^ itemProps
+                );
+
+            static bool LookupShapingCache(
+                ShapingCacheKey^ key,
+                array<unsigned short>^% clusterMap,
+                array<unsigned short>^% glyphIndices,
+                array<int>           ^% glyphAdvances,
+                array<GlyphOffset>   ^% glyphOffsets
+                );
+
+            static void AddToShapingCache(
+                ShapingCacheKey^ key,
+                array<unsigned short>^ clusterMap,
+                array<unsigned short>^ glyphIndices,
+                array<int>           ^ glyphAdvances,
+                array<GlyphOffset>   ^ glyphOffsets
+                );
+
             void GetBlankGlyphsForControlCharacters(
                 __in_ecount(textLength) const WCHAR* pTextString,
                 UINT32 textLength,
@@ -170,6 +312,32 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             // Core\CSharp\System\Windows\Media\textformatting\TextFormatterContext.cs
             // It is passed to LS to replace soft hyphens when needed.
             static const System::Char CharHyphen = '\x002d';
+
+            /// <summary>
+            /// Gets or sets the approximate number of bytes the shaping cache may hold.
+            /// 0, the default, disables the cache and empties it.
+            /// </summary>
+            static property int ShapingCacheMemoryLimit
+            {
+                int get();
+                void set(int value);
+            }
+
+            /// <summary>
+            /// Gets the number of GetGlyphsAndTheirPlacements calls answered from the shaping cache.
+            /// </summary>
+            static property int ShapingCacheHits
+            {
+                int get();
+            }
+
+            /// <summary>
+            /// Gets the number of cacheable GetGlyphsAndTheirPlacements calls that had to shape.
+            /// </summary>
+            static property int ShapingCacheMisses
+            {
+                int get();
+            }
             
             /// <summary>
             /// Contructs a Font object.
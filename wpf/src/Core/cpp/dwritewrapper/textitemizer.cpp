@@ -10,7 +10,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         _pNumberSubstitutionListHead = pNumberSubstitutionListHead;
 
         _isDigitList           = gcnew List<bool>();
-        _isDigitListRanges     = gcnew List<array<UINT32>^>();
+        _isDigitListRanges     = gcnew List<UINT32>();
     }
 
     UINT32 TextItemizer::GetNextSmallestPos(
@@ -25,7 +25,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
         
         UINT32 scriptAnalysisPos = (*ppScriptAnalysisCurrent != NULL)?(*ppScriptAnalysisCurrent)->Range[scriptAnalysisRangeIndex] : UInt32::MaxValue;
         UINT32 numberSubPos      = (*ppNumberSubstitutionCurrent != NULL)?(*ppNumberSubstitutionCurrent)->Range[numberSubstitutionRangeIndex] : UInt32::MaxValue;
-        UINT32 isDigitPos        = (isDigitIndex < (UINT32)_isDigitListRanges->Count)?_isDigitListRanges[isDigitIndex][isDigitRangeIndex] : UInt32::MaxValue;
+        UINT32 isDigitPos        = (isDigitIndex < (UINT32)_isDigitList->Count)?_isDigitListRanges[2 * isDigitIndex + isDigitRangeIndex] : UInt32::MaxValue;
 
         UINT32 smallestPos = Math::Min(scriptAnalysisPos, numberSubPos);
         smallestPos = Math::Min(smallestPos, isDigitPos);
@@ -80,6 +80,9 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                                       isDigitIndex, isDigitRangeIndex);
 
         List<Span^>^ spanVector = gcnew List<Span^>();
+
+        List<ItemPropsKey>^ internedItemPropsKeys = gcnew List<ItemPropsKey>();
+        List<ItemProps^>^   internedItemProps     = gcnew List<ItemProps^>();
         while (
             rangeEnd != textLength 
             && (pScriptAnalysisListCurrent != NULL
@@ -182,16 +185,53 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             // Refer to the comment about isIndic above.
             bool isLatin = (strongCharCount > 0) && (latinCount == strongCharCount);
 
-            ItemProps^ itemProps = ItemProps::Create(
-                    &(pScriptAnalysisListPrevious->Value),
-                    pNumberSubstitution,
-                    _isDigitList[isDigitIndexOld] ? numberCulture : nullptr,
-                    hasCombiningMark,
-                    needsCaretInfo,
-                    hasExtended,
-                    isIndic,
-                    isLatin
-                    );
+            CultureInfo^ digitCulture = _isDigitList[isDigitIndexOld] ? numberCulture : nullptr;
+
+            // ItemProps never change once created, so runs with the same properties
+            // can share one instead of each allocating its own native copies.
+            ItemPropsKey key;
+            key.script             = ((UINT32)pScriptAnalysisListPrevious->Value.script << 16) | (UINT32)pScriptAnalysisListPrevious->Value.shapes;
+            key.numberSubstitution = pNumberSubstitution;
+            key.digitCulture       = digitCulture;
+            key.flags              = (hasCombiningMark ? 0x01 : 0)
+                                   | (needsCaretInfo   ? 0x02 : 0)
+                                   | (hasExtended      ? 0x04 : 0)
+                                   | (isIndic          ? 0x08 : 0)
+                                   | (isLatin          ? 0x10 : 0);
+
+            ItemProps^ itemProps = nullptr;
+            for (int i = 0; i < internedItemPropsKeys->Count; ++i)
+            {
+                ItemPropsKey internedKey = internedItemPropsKeys[i];
+                if (   internedKey.script             == key.script
+                    && internedKey.numberSubstitution == key.numberSubstitution
+                    && internedKey.digitCulture       == key.digitCulture
+                    && internedKey.flags              == key.flags)
+                {
+                    itemProps = internedItemProps[i];
+                    break;
+                }
+            }
+
+            if (itemProps == nullptr)
+            {
+                itemProps = ItemProps::Create(
+                        &(pScriptAnalysisListPrevious->Value),
+                        pNumberSubstitution,
+                        digitCulture,
+                        hasCombiningMark,
+                        needsCaretInfo,
+                        hasExtended,
+                        isIndic,
+                        isLatin
+                        );
+
+                if (internedItemPropsKeys->Count < MaxInternedItemProps)
+                {
+                    internedItemPropsKeys->Add(key);
+                    internedItemProps->Add(itemProps);
+                }
+            }
 
             spanVector->Add(gcnew Span(itemProps, (int)(rangeEnd - rangeStart)));
         }
@@ -206,9 +246,7 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
                                  )
     {
         _isDigitList->Add(isDigit);
-        array<UINT32>^ range = gcnew array<UINT32>(2);
-        range[0] = textPosition;
-        range[1] = textPosition + textLength;
-        _isDigitListRanges->Add(range);
+        _isDigitListRanges->Add(textPosition);
+        _isDigitListRanges->Add(textPosition + textLength);
     }
 }}}}//MS::Internal::Text::TextInterface
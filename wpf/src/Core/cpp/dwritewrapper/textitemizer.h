@@ -47,7 +47,26 @@ namespace MS { namespace Internal { namespace Text { namespace TextInterface
             DWriteTextAnalysisNode<IDWriteNumberSubstitution*>* _pNumberSubstitutionListHead;
 
             List<bool>^           _isDigitList;
-            List<array<UINT32>^>^ _isDigitListRanges;
+
+            // Start and end of each _isDigitList range, two entries per range.
+            List<UINT32>^         _isDigitListRanges;
+
+            /// <summary>
+            /// What an ItemProps is created from; runs that agree on all of it share one ItemProps.
+            /// </summary>
+            value struct ItemPropsKey
+            {
+                UINT32       script;          // DWRITE_SCRIPT_ANALYSIS script and shapes
+                void*        numberSubstitution;
+                CultureInfo^ digitCulture;
+                int          flags;
+            };
+
+            /// <summary>
+            /// Most distinct ItemProps looked up for reuse within one Itemize call.
+            /// Paragraphs rarely mix more than a handful of scripts.
+            /// </summary>
+            static const int MaxInternedItemProps = 16;
 
 
             UINT32 GetNextSmallestPos(
@@ -320,6 +320,9 @@ uint16 usFoundEncoding;
 int16 KeepBullet = FALSE;
 int16 FoundBullet = FALSE;
 uint16 fKeepFlag; 
+uint16 *pausGlyphQueue = NULL;  /* glyphs of the current generation still to be expanded */
+uint16 usQueueHead;
+uint16 usQueueTail;
 uint16 usGlyphKeepCount;
 uint16 usMaxGlyphIndexUsed;
 uint32 ulCmapOffset;
@@ -345,6 +348,14 @@ CMAP_SUBHEADER_GEN CmapSubHeader;
     if (pausComponents == NULL)
         return(ERR_MEM);
 
+    /* each glyph enters the queue at most once per generation */
+    pausGlyphQueue = (uint16 *)Mem_Alloc((usGlyphListCount > 0 ? usGlyphListCount : 1) * sizeof(uint16));
+    if (pausGlyphQueue == NULL)
+    {
+        Mem_Free(pausComponents);
+        return(ERR_MEM);
+    }
+
     /* fill in array of glyphs to keep.  Glyph 0 is the missing chr glyph,
         glyph 1 is the NULL glyph. Don't violate the array */
     if( bAddRelatedGlyphs )
@@ -509,19 +520,32 @@ CMAP_SUBHEADER_GEN CmapSubHeader;
     {
         usGlyphKeepCount = 0;
         usMaxGlyphIndexUsed = 0;
-        /* Now gather up any components referenced by the list of glyphs to keep and TTO glyphs */
-        for (usGlyphIdx = 0; usGlyphIdx < usGlyphListCount; ++usGlyphIdx) /* gather up any components */
+        usQueueHead = 0;
+        usQueueTail = 0;
+        /* The frontier is every glyph added by the previous TTO/Mort pass (or the initial list) */
+        for (usGlyphIdx = 0; usGlyphIdx < usGlyphListCount; ++usGlyphIdx)
         {
             if (puchKeepGlyphList[ usGlyphIdx ] == fKeepFlag)
-            {
-                usMaxGlyphIndexUsed = usGlyphIdx;
-                ++ (usGlyphKeepCount);
+                pausGlyphQueue[ usQueueTail++ ] = usGlyphIdx;
+        }
+
+        /* Now gather up any components referenced by the frontier. Components join the current
+           generation and are expanded from the queue right away, so one TTO/Mort pass below sees
+           the whole component closure instead of one extra pass per level of nesting. */
+        while (usQueueHead < usQueueTail)
+        {
+            usGlyphIdx = pausGlyphQueue[ usQueueHead++ ];
 
-                GetComponentGlyphList( pInputBufferInfo, usGlyphIdx, &usnComponents, pausComponents, usnMaxComponents, &usnComponentDepth, 0, usIdxToLocFmt, ulLocaOffset, ulGlyfOffset);
-                for ( j = 0; j < usnComponents; j++ )   /* check component value before assignment */
+            usMaxGlyphIndexUsed = max(usGlyphIdx, usMaxGlyphIndexUsed);
+            ++ (usGlyphKeepCount);
+
+            GetComponentGlyphList( pInputBufferInfo, usGlyphIdx, &usnComponents, pausComponents, usnMaxComponents, &usnComponentDepth, 0, usIdxToLocFmt, ulLocaOffset, ulGlyfOffset);
+            for ( j = 0; j < usnComponents; j++ )   /* check component value before assignment */
+            {
+                if ((pausComponents[ j ] < usGlyphListCount) && ((puchKeepGlyphList)[ pausComponents[ j ] ] == 0))
                 {
-                    if ((pausComponents[ j ] < usGlyphListCount) && ((puchKeepGlyphList)[ pausComponents[ j ] ] == 0))
-                        (puchKeepGlyphList)[ pausComponents[ j ] ] = (uint8)(fKeepFlag + 1);  /* so it will be grabbed next time around */
+                    (puchKeepGlyphList)[ pausComponents[ j ] ] = (uint8)fKeepFlag;
+                    pausGlyphQueue[ usQueueTail++ ] = pausComponents[ j ];
                 }
             }
         }
@@ -540,6 +564,7 @@ CMAP_SUBHEADER_GEN CmapSubHeader;
                 break;
         }
     }
+    Mem_Free(pausGlyphQueue);
     Mem_Free(pausComponents);
     
     return errCode;
@@ -36,7 +36,7 @@ typedef struct cmapoffsetrecordkeeper CMAPOFFSETRECORDKEEPER;
 
 struct cmapoffsetrecordkeeper      /* housekeeping structure */
 {
-    __field_ecount(usCmapOffsetArrayLen) CmapOffsetRecord * pCmapOffsetArray;
+    __field_ecount(usCmapOffsetArrayLen) CmapOffsetRecord * pCmapOffsetArray;   /* kept sorted by ulOldCmapOffset */
     uint16 usCmapOffsetArrayLen;
     uint16 usNextArrayIndex;
 };
@@ -62,6 +62,29 @@ PRIVATE void FreeCmapOffsetArray(PCMAPOFFSETRECORDKEEPER pKeeper)
     pKeeper->usCmapOffsetArrayLen = 0;
     pKeeper->usNextArrayIndex = 0;
 }
+/* ------------------------------------------------------------------- */
+/* binary search the sorted record array. Returns the index of the record */
+/* for ulOldCmapOffset, or the index at which it would be inserted */
+/* ------------------------------------------------------------------- */
+[System::Security::SecurityCritical]
+PRIVATE uint16 FindCmapOffsetIndex(PCMAPOFFSETRECORDKEEPER pKeeper, 
+                                   uint32 ulOldCmapOffset)
+{
+uint16 usLow = 0;
+uint16 usHigh = pKeeper->usNextArrayIndex;
+uint16 usMid;
+
+    while (usLow < usHigh)
+    {
+        usMid = (uint16) (usLow + (usHigh - usLow) / 2);
+        if (pKeeper->pCmapOffsetArray[usMid].ulOldCmapOffset < ulOldCmapOffset)
+            usLow = (uint16) (usMid + 1);
+        else
+            usHigh = usMid;
+    }
+    return usLow;
+}
+
 /* ------------------------------------------------------------------- */
 [System::Security::SecurityCritical]
 PRIVATE int16 RecordCmapOffset(PCMAPOFFSETRECORDKEEPER pKeeper, 
@@ -69,10 +92,18 @@ PRIVATE int16 RecordCmapOffset(PCMAPOFFSETRECORDKEEPER pKeeper,
                                 uint32 ulNewCmapOffset)
   /* record this block as being used */
 {
+uint16 usIndex;
+
+    usIndex = FindCmapOffsetIndex(pKeeper, ulOldCmapOffset);
+    if (usIndex < pKeeper->usNextArrayIndex && pKeeper->pCmapOffsetArray[usIndex].ulOldCmapOffset == ulOldCmapOffset)
+        return NO_ERROR;    /* already recorded, the first mapping wins as it did for the linear lookup */
     if (pKeeper->usNextArrayIndex >= pKeeper->usCmapOffsetArrayLen)
         return ERR_INVALID_CMAP;
-    pKeeper->pCmapOffsetArray[pKeeper->usNextArrayIndex].ulOldCmapOffset = ulOldCmapOffset;
-    pKeeper->pCmapOffsetArray[pKeeper->usNextArrayIndex].ulNewCmapOffset = ulNewCmapOffset ;
+    /* insert in order, so lookups can binary search */
+    memmove(&(pKeeper->pCmapOffsetArray[usIndex + 1]), &(pKeeper->pCmapOffsetArray[usIndex]), 
+            (pKeeper->usNextArrayIndex - usIndex) * sizeof(*(pKeeper->pCmapOffsetArray)));
+    pKeeper->pCmapOffsetArray[usIndex].ulOldCmapOffset = ulOldCmapOffset;
+    pKeeper->pCmapOffsetArray[usIndex].ulNewCmapOffset = ulNewCmapOffset ;
     ++pKeeper->usNextArrayIndex;
     return NO_ERROR;
 }
@@ -82,13 +113,11 @@ PRIVATE int16 RecordCmapOffset(PCMAPOFFSETRECORDKEEPER pKeeper,
 PRIVATE uint32 LookupCmapOffset(PCMAPOFFSETRECORDKEEPER pKeeper, 
                                 uint32 ulOldCmapOffset)
 {
-uint16 i;
+uint16 usIndex;
 
-    for (i = 0; i < pKeeper->usNextArrayIndex; ++i)
-    {
-         if (ulOldCmapOffset == pKeeper->pCmapOffsetArray[i].ulOldCmapOffset)
-            return(pKeeper->pCmapOffsetArray[i].ulNewCmapOffset);
-    }
+    usIndex = FindCmapOffsetIndex(pKeeper, ulOldCmapOffset);
+    if (usIndex < pKeeper->usNextArrayIndex && ulOldCmapOffset == pKeeper->pCmapOffsetArray[usIndex].ulOldCmapOffset)
+        return(pKeeper->pCmapOffsetArray[usIndex].ulNewCmapOffset);
     return(0L);
 }
 
@@ -96,9 +125,22 @@ uint16 i;
 /* ------------------------------------------------------------------- */
 typedef struct {  /* used to sort and keep track of new offsets */
     uint16 usIndex;    /* index into the CMAP_TABLELOC array read from the original font */
+    uint32 ulOldOffset; /* offset of that subtable before compression - the sort key */
     uint32 ulNewOffset;
 } IndexOffset;
 
+/* ------------------------------------------------------------------- */
+[System::Security::SecurityCritical]
+PRIVATE int CRTCB AscendingOldOffsetCompare( CONST void *arg1, CONST void *arg2 )
+{
+    if (((IndexOffset *)(arg1))->ulOldOffset != ((IndexOffset *)(arg2))->ulOldOffset)
+        return (((IndexOffset *)(arg1))->ulOldOffset < ((IndexOffset *)(arg2))->ulOldOffset) ? -1 : 1;
+    /* keep directory order for shared subtables, as the insertion sort did */
+    if (((IndexOffset *)(arg1))->usIndex == ((IndexOffset *)(arg2))->usIndex)
+        return 0;
+    return (((IndexOffset *)(arg1))->usIndex < ((IndexOffset *)(arg2))->usIndex) ? -1 : 1;
+}
+
 /* ------------------------------------------------------------------- */
 /* Must sort subtables by offset, so that their data blocks may be moved in order */
 /* output of this function is the IndexOffset array */
@@ -106,23 +148,14 @@ typedef struct {  /* used to sort and keep track of new offsets */
 [System::Security::SecurityCritical]
 PRIVATE void SortCmapSubByOffset(CMAP_TABLELOC *pCmapTableLoc, uint16 usSubTableCount, IndexOffset *pIndexArray)
 {
-uint16 i, j, k;
+uint16 i;
 
     for (i = 0; i < usSubTableCount; ++i)
     {
-        for (j = 0; j < i; ++j)    /* look for where to insert this index in the Index array thingum */
-        {
-            if (pCmapTableLoc[i].offset < pCmapTableLoc[pIndexArray[j].usIndex].offset) /* need to insert it here */
-            {  /* push down any that are ahead of this one */
-                for (k = i; k > j; -- k)
-                {
-                      pIndexArray[k].usIndex = pIndexArray[k-1].usIndex;
-                }
-                break;
-            }
-        }
-        pIndexArray[j].usIndex = i;      /* insert it */
+        pIndexArray[i].usIndex = i;
+        pIndexArray[i].ulOldOffset = pCmapTableLoc[i].offset;
     }
+    qsort(pIndexArray, usSubTableCount, sizeof(*pIndexArray), AscendingOldOffsetCompare);
 } 
 
 /* ------------------------------------------------------------------- */
@@ -170,7 +203,7 @@ uint16 usPadBytes;
     {
         usIndex = pIndexArray[i].usIndex;
         /* check to see if this offset is the same as the last one copied. If so, ignore, as it has already been copied */
-        if (i > 0 && pCmapTableLoc[usIndex].offset == ulLastOffset) /* we're pointing to some already copied data */
+        if (i > 0 && pIndexArray[i].ulOldOffset == ulLastOffset) /* we're pointing to some already copied data */
         {
             pIndexArray[i].ulNewOffset = pIndexArray[i-1].ulNewOffset;
             continue;
@@ -190,7 +223,7 @@ uint16 usPadBytes;
             break;
         }
         pIndexArray[i].ulNewOffset = ulCurrentOffset-ulCmapOffset;    /* calculate the new offset of the cmap subtable, and store in local structure */
-        ulLastOffset = pCmapTableLoc[usIndex].offset;
+        ulLastOffset = pIndexArray[i].ulOldOffset;
         /* now copy the subtable to it's new locations */
         if ((errCode = CopyBlock(pOutputBufferInfo, ulCurrentOffset, ulCmapOffset + pCmapTableLoc[usIndex].offset,CmapSubHeader.length)) != NO_ERROR)
             break;
@@ -220,33 +220,71 @@ int16 WriteBytes(TTFACC_FILEBUFFERINFO * pOutputBufferInfo, uint8 * puchBuffer,
     return NO_ERROR;    
 }
 /* ---------------------------------------------------------------------- */
-/* ReadGeneric - Generic read of data - Translation buffer provided for Word and Long swapping and RISC alignment handling */
-/* 
-Output:
-puchDestBuffer updated with new data
-pusByteRead - number of bytes read 
+/* GetGenericReadSize - walk a control string once and work out how many bytes
+it consumes from the file, checking that it exactly fills a buffer of usBufferSize.
+Lets ReadGeneric and ReadGenericRepeat bounds check a whole structure (or a whole
+array of structures) once instead of once per field.
 Return:
 0 if OK
-error code if not. */
+ERR_READCONTROL if the control string is bad or doesn't fit the buffer */
 /* ---------------------------------------------------------------------- */
 [System::Security::SecurityCritical]
 __checkReturn __success(return==NO_ERROR) 
-int16 ReadGeneric(
-    TTFACC_FILEBUFFERINFO * pInputBufferInfo, /* buffer info of file buffer to read from */
-    uint8 * puchBuffer,      /* buffer to read into - pad according to pControl data    */
-    uint16 usBufferSize,     /* size of buffer */
-    uint8 * puchControl,    /* pControl - describes the size of each element in the structure, if a pad byte should be inserted in the output buffer */
-    uint32 ulOffset,           /* offset into input TTF Buffer of where to read */
-    uint16 * pusBytesRead /* number of bytes read from the file */
+PRIVATE int16 GetGenericReadSize(
+    uint8 * puchControl,    /* pControl - describes the size of each element in the structure */
+    uint16 usBufferSize,    /* size of buffer the structure is read into */
+    uint16 * pusFileSize    /* number of bytes the structure occupies in the file */
 )
 {
-uint32 ulCurrOffset = ulOffset;      /* offset into TTF data buffer */
-uint16 usBufferOffset = 0;          /* offset into local read buffer */
-uint16 usControlCount;        /* number of elements in the Control array */
-UNALIGNED uint16 *pusBuffer;                  /* coerced puchBuffer */
-UNALIGNED uint32 *pulBuffer;
+uint16 usBufferOffset = 0;
+uint16 usFileSize = 0;
+uint16 usElementSize;
+uint16 usControlCount;
+uint16 i;
+
+    usControlCount = puchControl[0]; 
+    for (i = 1; i <= usControlCount; ++i)
+    {
+        switch (puchControl[i] & TTFACC_DATA)
+        {
+        case TTFACC_BYTE:
+            usElementSize = sizeof(uint8);
+        break;
+        case TTFACC_WORD:
+            usElementSize = sizeof(uint16);
+        break;
+        case TTFACC_LONG:
+            usElementSize = sizeof(uint32);
+        break;
+        default:
+            return ERR_READCONTROL; /* don't read any, bad control */
+        }  /* end switch */
+
+        if (usBufferOffset + usElementSize > usBufferSize)
+            return ERR_READCONTROL;  /* trying to stuff too many bytes into target buffer */ 
+        usBufferOffset += usElementSize;
+        if (!(puchControl[i] & TTFACC_PAD))
+            usFileSize += usElementSize;
+    } /* end for i */
+    if (usBufferOffset < usBufferSize)  /* didn't fill up the buffer */
+        return ERR_READCONTROL;  /* control thing doesn't fit the buffer */
+    *pusFileSize = usFileSize;
+    return NO_ERROR;
+}
+/* ---------------------------------------------------------------------- */
+/* DecodeGeneric - translate one structure described by puchControl from file
+data into puchBuffer. No checking: the control string must already have been
+validated by GetGenericReadSize and the source range by CheckInOffset. */
+/* ---------------------------------------------------------------------- */
+[System::Security::SecurityCritical]
+PRIVATE void DecodeGeneric(
+    CONST uint8 * puchSource,    /* file data to read from */
+    uint8 * puchBuffer,          /* buffer to read into - pad according to pControl data */
+    uint8 * puchControl          /* pControl - describes the size of each element in the structure */
+)
+{
+uint16 usControlCount;
 uint16 i;
-int16 errCode;
 
     usControlCount = puchControl[0]; 
     for (i = 1; i <= usControlCount; ++i)
@@ -254,71 +292,74 @@ int16 errCode;
         switch (puchControl[i] & TTFACC_DATA)
         {
         case TTFACC_BYTE:
-            if (usBufferOffset + sizeof(uint8) > usBufferSize)
-                return ERR_READCONTROL;  /* trying to stuff too many bytes into target buffer */ 
             if (puchControl[i] & TTFACC_PAD) /* don't read, just pad */
-                *(puchBuffer + usBufferOffset) = 0;
+                *puchBuffer = 0;
             else
-            {
-                if ((errCode = ReadByte(pInputBufferInfo, puchBuffer + usBufferOffset, ulCurrOffset))!=NO_ERROR)
-                    return errCode;
-
-                ulCurrOffset += sizeof(uint8);
-            }
-            usBufferOffset += sizeof(uint8);
+                *puchBuffer = *puchSource++;
+            puchBuffer += sizeof(uint8);
         break;
         case TTFACC_WORD:
-            if (usBufferOffset + sizeof(uint16) > usBufferSize)
-                return ERR_READCONTROL;  /* trying to stuff too many bytes into target buffer */ 
-            pusBuffer = (uint16 *) (puchBuffer + usBufferOffset);
             if (puchControl[i] & TTFACC_PAD) /* don't read, just pad */
-                *pusBuffer = 0;
+                *(UNALIGNED uint16 *) puchBuffer = 0;
             else
             {
                 if (puchControl[i] & TTFACC_NO_XLATE)
-                {
-                    if ((errCode = ReadBytes(pInputBufferInfo, puchBuffer + usBufferOffset, ulCurrOffset, 2))!=NO_ERROR)
-                        return errCode;
-                }
+                    memcpy(puchBuffer, puchSource, sizeof(uint16));
                 else
-                {
-                    if ((errCode = ReadWord(pInputBufferInfo, pusBuffer, ulCurrOffset))!=NO_ERROR)
-                        return errCode;
-                }
-                ulCurrOffset += sizeof(uint16);
+                    *(UNALIGNED uint16 *) puchBuffer = SWAPW(*puchSource);
+                puchSource += sizeof(uint16);
             }
-            usBufferOffset += sizeof(uint16);
+            puchBuffer += sizeof(uint16);
         break;
         case TTFACC_LONG:
-            if (usBufferOffset + sizeof(uint32) > usBufferSize)
-                return ERR_READCONTROL;  /* trying to stuff too many bytes into target buffer */ 
-            pulBuffer = (uint32 *) (puchBuffer + usBufferOffset);
             if (puchControl[i] & TTFACC_PAD) /* don't read, just pad */
-                *pulBuffer = 0;
+                *(UNALIGNED uint32 *) puchBuffer = 0;
             else
             {
-                  if (puchControl[i] & TTFACC_NO_XLATE)
-                {
-                    /* read as 4 bytes instead */
-                    if ((errCode = ReadBytes(pInputBufferInfo, puchBuffer + usBufferOffset, ulCurrOffset, 4))!=NO_ERROR)
-                        return errCode;
-                }
+                if (puchControl[i] & TTFACC_NO_XLATE)
+                    memcpy(puchBuffer, puchSource, sizeof(uint32)); /* read as 4 bytes instead */
                 else
-                {
-                    if ((errCode = ReadLong(pInputBufferInfo, pulBuffer, ulCurrOffset))!=NO_ERROR)
-                        return errCode;
-                }
-                ulCurrOffset += sizeof(uint32);
+                    *(UNALIGNED uint32 *) puchBuffer = SWAPL(*puchSource);
+                puchSource += sizeof(uint32);
             }
-            usBufferOffset += sizeof(uint32);
+            puchBuffer += sizeof(uint32);
         break;
-        default:
-            return ERR_READCONTROL; /* don't read any, bad control */
         }  /* end switch */
     } /* end for i */
-    if (usBufferOffset < usBufferSize)  /* didn't fill up the buffer */
-        return ERR_READCONTROL;  /* control thing doesn't fit the buffer */
-    * pusBytesRead = (uint16) (ulCurrOffset - ulOffset); 
+}
+/* ---------------------------------------------------------------------- */
+/* ReadGeneric - Generic read of data - Translation buffer provided for Word and Long swapping and RISC alignment handling */
+/* 
+Output:
+puchDestBuffer updated with new data
+pusByteRead - number of bytes read 
+Return:
+0 if OK
+error code if not. */
+/* ---------------------------------------------------------------------- */
+[System::Security::SecurityCritical]
+__checkReturn __success(return==NO_ERROR) 
+int16 ReadGeneric(
+    TTFACC_FILEBUFFERINFO * pInputBufferInfo, /* buffer info of file buffer to read from */
+    uint8 * puchBuffer,      /* buffer to read into - pad according to pControl data    */
+    uint16 usBufferSize,     /* size of buffer */
+    uint8 * puchControl,    /* pControl - describes the size of each element in the structure, if a pad byte should be inserted in the output buffer */
+    uint32 ulOffset,           /* offset into input TTF Buffer of where to read */
+    uint16 * pusBytesRead /* number of bytes read from the file */
+)
+{
+uint16 usFileSize;
+int16 errCode;
+
+    if ((errCode = GetGenericReadSize(puchControl, usBufferSize, &usFileSize)) != NO_ERROR)
+        return errCode;
+
+    /* one bounds check covers every field of the structure */
+    if ((errCode = CheckInOffset(pInputBufferInfo, ulOffset, usFileSize)) != NO_ERROR)
+        return errCode;
+
+    DecodeGeneric(pInputBufferInfo->puchBuffer + ulOffset, puchBuffer, puchControl);
+    * pusBytesRead = usFileSize; 
     return NO_ERROR;
 }
 /* ---------------------------------------------------------------------- */
@@ -344,15 +385,47 @@ uint16 usItemSize         /* size of item in buffer */
 {
 uint16 i;
 int16 errCode;
-uint16 usBytesRead;
+uint16 usFileSize;
+CONST uint8 * puchSource;
 
-    for (i = 0; i < usItemCount; ++i)
+    if (usItemCount > 0)
     {
-        errCode = ReadGeneric( pInputBufferInfo, puchBuffer, usItemSize, puchControl, ulOffset, &usBytesRead);
-        if (errCode != NO_ERROR)
+        if ((errCode = GetGenericReadSize(puchControl, usItemSize, &usFileSize)) != NO_ERROR)
             return errCode;
-        ulOffset += usBytesRead;
-        puchBuffer += usItemSize;
+
+        /* check the whole array at once, then translate it item by item */
+        if ((errCode = CheckInOffset(pInputBufferInfo, ulOffset, (uint32) usFileSize * usItemCount)) != NO_ERROR)
+            return errCode;
+
+        puchSource = pInputBufferInfo->puchBuffer + ulOffset;
+        if (puchControl[0] == 1 && (puchControl[1] & (TTFACC_PAD | TTFACC_NO_XLATE)) == 0)
+        {
+            /* arrays of plain words or longs (loca, glyph id and offset arrays) are by far the
+               most common case, so swap them without going through the control string */
+            switch (puchControl[1] & TTFACC_DATA)
+            {
+            case TTFACC_BYTE:
+                memcpy(puchBuffer, puchSource, usItemCount);
+            break;
+            case TTFACC_WORD:
+                for (i = 0; i < usItemCount; ++i, puchSource += sizeof(uint16))
+                    ((UNALIGNED uint16 *) puchBuffer)[i] = SWAPW(*puchSource);
+            break;
+            case TTFACC_LONG:
+                for (i = 0; i < usItemCount; ++i, puchSource += sizeof(uint32))
+                    ((UNALIGNED uint32 *) puchBuffer)[i] = SWAPL(*puchSource);
+            break;
+            }
+        }
+        else
+        {
+            for (i = 0; i < usItemCount; ++i)
+            {
+                DecodeGeneric(puchSource, puchBuffer, puchControl);
+                puchSource += usFileSize;
+                puchBuffer += usItemSize;
+            }
+        }
     }
 
     *pulBytesRead = usItemSize * usItemCount;
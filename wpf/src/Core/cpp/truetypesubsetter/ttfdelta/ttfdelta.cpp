@@ -433,8 +433,48 @@ uint16 usBytesWritten;
 /*                in addition any array tables (LTSH, loca, hmtx, hdmx, vmtx) will have a percentage discarded */
 /* Format Delta will keep only a list of tables, and the Subset1 compacted and Glyf tables will keep only a portion */
 /* ---------------------------------------------------------------------- */
+/* CalcKeptGlyfLength - sum the glyf bytes ModGlyfLocaAndHead will copy for the glyphs in puchKeepGlyphList,
+including the pad byte it adds after odd length glyphs. Returns FALSE if the loca can't be read, in which
+case the caller falls back to estimating from the glyph count. */
+/* ---------------------------------------------------------------------- */
+[System::Security::SecurityCritical]
+PRIVATE BOOL CalcKeptGlyfLength(CONST_TTFACC_FILEBUFFERINFO *pInputBufferInfo,
+                                uint8 *puchKeepGlyphList,
+                                uint16 usGlyphListCount,
+                                uint32 *pulKeptGlyfLength)
+{
+uint32 * aulLoca;
+uint32 ulKeptGlyfLength = 0;
+uint32 ulGlyphLength;
+uint16 i;
+
+    aulLoca = (uint32 *)Mem_Alloc( (usGlyphListCount + 1) * sizeof( uint32 ));
+    if ( aulLoca == NULL )
+        return FALSE;
+
+    if (GetLoca((TTFACC_FILEBUFFERINFO *)pInputBufferInfo, aulLoca, usGlyphListCount + 1) == 0L)
+    {
+        Mem_Free(aulLoca);
+        return FALSE;
+    }
+
+    for ( i = 0; i < usGlyphListCount; i++ )
+    {
+        if (puchKeepGlyphList[i] && aulLoca[ i ] < aulLoca[ i+1 ])
+        {
+            ulGlyphLength = aulLoca[ i+1 ] - aulLoca[ i ];
+            ulKeptGlyfLength += ulGlyphLength + (ulGlyphLength & 1);
+        }
+    }
+
+    Mem_Free(aulLoca);
+    *pulKeptGlyfLength = ulKeptGlyfLength;
+    return TRUE;
+}
+/* ---------------------------------------------------------------------- */
 [System::Security::SecurityCritical]
 PRIVATE void CalcOutputBufferSize(CONST_TTFACC_FILEBUFFERINFO *pInputBufferInfo,
+                                 uint8 *puchKeepGlyphList,
                                  uint16 usGlyphListCount,
                                  uint16 usGlyphKeepCount,
                                  uint16 usFormat,
@@ -447,6 +487,10 @@ uint32 ulEBDTTableLength = 0, ulEBDTTableOffset = 0;
 uint32 ulBdatTableLength= 0;  
 uint32 ulAllGlyphsLength= 0;  /* glyf, EBDT, bloc length */
 uint32 ulKeepTablesLength = 0;
+uint32 ulGlyfTableLength = 0;
+uint32 ulKeptGlyfLength = 0;
+uint32 ulExactGlyfLength = 0; /* glyf bytes accounted for exactly rather than by percentage */
+uint32 ulDiscardedGlyfLength = 0;
 
         /* make a good guess as to how much memory we will need */
         /* first figure out percentage of glyph's being discarded */
@@ -466,7 +510,21 @@ uint32 ulKeepTablesLength = 0;
                 ulBdatTableLength = 0;          
         }
         ulAllGlyphsLength = ulEBDTTableLength + ulBdatTableLength;
-        ulAllGlyphsLength += TTTableLength((TTFACC_FILEBUFFERINFO *)pInputBufferInfo, GLYF_TAG);
+
+        /* the glyf table is usually most of the font, and the share of it kept can be far from the share
+           of glyphs kept (think of a few CJK glyphs against many small ones), so size it from loca exactly */
+        ulGlyfTableLength = TTTableLength((TTFACC_FILEBUFFERINFO *)pInputBufferInfo, GLYF_TAG);
+        if (ulGlyfTableLength != DIRECTORY_ERROR && ulGlyfTableLength > 0 &&
+            CalcKeptGlyfLength(pInputBufferInfo, puchKeepGlyphList, usGlyphListCount, &ulKeptGlyfLength))
+        {
+            /* keep the same 10% cushion the percentage estimate used, against other tables growing */
+            ulExactGlyfLength = ulKeptGlyfLength + ulGlyfTableLength/10;
+            if (ulExactGlyfLength > ulGlyfTableLength)
+                ulExactGlyfLength = ulGlyfTableLength;
+            ulDiscardedGlyfLength = ulGlyfTableLength - ulExactGlyfLength;
+        }
+        else
+            ulAllGlyphsLength += ulGlyfTableLength;
 
         if (usFormat == TTFDELTA_DELTA || usFormat == TTFDELTA_SUBSET1)
         {  /* these formats will compact some tables, discarding a percentage of these tables as well */
@@ -491,11 +549,11 @@ uint32 ulKeepTablesLength = 0;
             if (ulBdatTableLength > 0)
                 ulKeepTablesLength += TTTableLength((TTFACC_FILEBUFFERINFO *)pInputBufferInfo, BLOC_TAG);
             
-            *pulOutputBufferLength = ulKeepTablesLength + (uint32)(flKeepPercent * ulGlyphDependentDataLength/100);
+            *pulOutputBufferLength = ulKeepTablesLength + ulExactGlyfLength + (uint32)(flKeepPercent * ulGlyphDependentDataLength/100);
         }
         else
         /* for straight subset, this will be: ulSrcBufferSize - (discard % * (Glyf table size + EBDT table size + bdat table size)) */
-            *pulOutputBufferLength = ulSrcBufferSize - (uint32)(flDiscardPercent * ulGlyphDependentDataLength/100);
+            *pulOutputBufferLength = ulSrcBufferSize - ulDiscardedGlyfLength - (uint32)(flDiscardPercent * ulGlyphDependentDataLength/100);
 }
 
 
@@ -778,7 +836,7 @@ CONST_TTFACC_FILEBUFFERINFO InputBufferInfo;
 
     if (*ppuchDestBuffer == NULL || *pulDestBufferSize == 0) /* need to allocate some memory */
     {
-        CalcOutputBufferSize(&InputBufferInfo, usGlyphListCount, usGlyphKeepCount, usFormat, ulSrcBufferSize, pulDestBufferSize);
+        CalcOutputBufferSize(&InputBufferInfo, puchKeepGlyphList, usGlyphListCount, usGlyphKeepCount, usFormat, ulSrcBufferSize, pulDestBufferSize);
 #ifdef _DEBUG
 /*      printf("Allocating %lu bytes for output buffer.\n", *pulDestBufferSize);  */
 #endif
@@ -602,6 +602,79 @@ account possible overlap between source and target */
     return(NO_ERROR);
 }
 
+/* ---------------------------------------------------------------------- */
+/* same as CopyBlock, but also hands back the table checksum of the block, */
+/* as CalcChecksum would compute it at ulTarget after the copy. The sum is */
+/* accumulated while the data is moved, so a table being compacted is only */
+/* read once. */
+/* ---------------------------------------------------------------------- */
+[System::Security::SecurityCritical]
+int16 CopyBlockWithChecksum( TTFACC_FILEBUFFERINFO * pInputBufferInfo, 
+                uint32 ulTarget,
+                uint32 ulSource,
+                uint32 ulSize,
+                uint32 * pulChecksum )
+{
+int16 errCode;
+uint8 * puchSource;
+uint8 * puchTarget;
+uint32 ulWord;
+uint32 ulLongs;
+uint32 i;
+uint32 j;
+
+    /* nothing to move, or moving up over itself (never done when compacting): */
+    /* fall back on the separate passes */
+    if ( ulTarget == ulSource || ulSize == 0L || 
+        (ulTarget > ulSource && ulTarget < ulSource + ulSize) )
+    {
+        if ((errCode = CopyBlock(pInputBufferInfo, ulTarget, ulSource, ulSize)) != NO_ERROR)
+            return errCode;
+        return CalcChecksum(pInputBufferInfo, ulTarget, ulSize, pulChecksum);
+    }
+
+    *pulChecksum = 0;
+
+    if ((errCode=CheckInOffset(pInputBufferInfo,ulSource,ulSize)) != NO_ERROR)
+    {
+        return errCode;
+    }
+
+    if ((errCode=CheckOutOffset(pInputBufferInfo,ulTarget,ulSize)) != NO_ERROR)
+    {
+        return errCode;
+    }
+
+    puchSource = pInputBufferInfo->puchBuffer + ulSource;
+    puchTarget = pInputBufferInfo->puchBuffer + ulTarget;
+
+    /* a forward copy is safe when the target is below the source: a long is */
+    /* always read before anything is written over it */
+    ulLongs = ulSize & ~3;
+    for (i = 0; i < ulLongs; i += sizeof(uint32))
+    {
+        memcpy(&ulWord, puchSource + i, sizeof(uint32));
+        memcpy(puchTarget + i, &ulWord, sizeof(uint32));
+        /* tables are summed as big-endian longs */
+        *pulChecksum += ((uint32) puchTarget[i] << 24) + ((uint32) puchTarget[i + 1] << 16) + 
+                        ((uint32) puchTarget[i + 2] << 8) + (uint32) puchTarget[i + 3];
+    }
+
+    /* the tail that is not 4-byte even, padded with virtual zeros as CalcChecksum does */
+    if (ulSize % 4)
+    {
+        ulWord = 0;
+        for (j = 0; j < (ulSize % 4); j++)
+        {
+            puchTarget[i + j] = puchSource[i + j];
+            ulWord = (ulWord << 8) + puchTarget[i + j];
+        }
+        ulWord = ulWord << ( (4 - j) * 8 );
+        *pulChecksum += ulWord;
+    }
+    return(NO_ERROR);
+}
+
 /* ---------------------------------------------------------------------- */
 [System::Security::SecurityCritical]
 int16 CopyBlockOver( TTFACC_FILEBUFFERINFO * pOutputBufferInfo,
@@ -247,12 +247,12 @@ uint32 GetLoca( TTFACC_FILEBUFFERINFO               *pInputBufferInfo,
                   )
 {
 uint32 ulOffset = 0;
-uint16 usOffset;
 HEAD Head;
 uint16 usIdxToLocFmt;
 uint32 ulGlyphCount;
 uint32 i;
 uint32 ulBytesRead;
+uint8 * puchShortLoca;
 
     if ( ! GetHead( pInputBufferInfo, &Head ))
         return( 0L );
@@ -267,11 +267,14 @@ uint32 ulBytesRead;
 
     if ( usIdxToLocFmt == SHORT_OFFSETS )
     {
-        for (i = 0; i <= ulGlyphCount; ++i)
+        /* read the raw short offsets into the front of the long buffer with a single bounds
+           check, then widen them in place from the end so no entry is overwritten before use */
+        puchShortLoca = (uint8 *) pulLoca;
+        if (ReadBytes( pInputBufferInfo, puchShortLoca, ulOffset, (ulGlyphCount + 1) * sizeof(uint16)) != NO_ERROR)
+            return 0L;
+        for (i = ulGlyphCount + 1; i-- > 0; )
         {
-            if (ReadWord( pInputBufferInfo, &usOffset, ulOffset + (i*sizeof(uint16))) != NO_ERROR)
-                return 0L;
-            pulLoca[i] = (int32) usOffset * 2L;
+            pulLoca[i] = (int32) SWAPW(puchShortLoca[i * sizeof(uint16)]) * 2L;
         }
     }
     else
@@ -2245,7 +2248,8 @@ int16 errCode;
         spot, thus filling in any existing gaps */
         if (!DoTwo)   /* if not the 2nd of two directories pointing to the same data */
         {
-            if ((errCode = CopyBlock( pOutputBufferInfo, ulOffset, aDirectory[ usTableIdx ].offset, aDirectory[ usTableIdx ].length )) != NO_ERROR)
+            /* the checksum for the entry is computed while the table moves */
+            if ((errCode = CopyBlockWithChecksum( pOutputBufferInfo, ulOffset, aDirectory[ usTableIdx ].offset, aDirectory[ usTableIdx ].length, &aDirectory[ usTableIdx ].checkSum )) != NO_ERROR)
                 break;
 
             if (usTableIdx + 1 < usnNewTables)
@@ -2262,17 +2266,16 @@ int16 errCode;
             aDirectory[ usTableIdx ].offset = ulOffset;
             /* calc offset for next table */
 
-        /* zero out any pad bytes and determine the checksum for the entry */
+        /* zero out any pad bytes */
             if ((errCode = ZeroLongWordGap( pOutputBufferInfo, aDirectory[ usTableIdx ].offset, aDirectory[ usTableIdx ].length, &ulOffset)) != NO_ERROR)
                 break;
         }
         else
         {
             DoTwo = FALSE; /* so next time we'll perform the copy */
+            /* same data, same length as the entry just copied */
+            aDirectory[ usTableIdx ].checkSum = aDirectory[ usTableIdx - 1 ].checkSum;
         }
-        
-        if ((errCode = CalcChecksum( pOutputBufferInfo, aDirectory[ usTableIdx ].offset, aDirectory[ usTableIdx ].length, &aDirectory[ usTableIdx ].checkSum )) != NO_ERROR)
-            break;
     }
 
 
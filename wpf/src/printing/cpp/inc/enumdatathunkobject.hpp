@@ -76,6 +76,22 @@ namespace PrintWin32Thunk
             UInt32                        numberOfJobs
             );
 
+        ///<SecurityNote>
+        /// Critical    - Calls critical Release on InfoLevelCoverageList.
+        /// TreatAsSafe - InfoLevelCoverageList created in the method and not exposed.
+        ///</SecurityNote>
+        [SecuritySafeCritical]
+        void
+        RefreshPrintSystemValuesPerPrintQueues(
+            PrintServer^                        printServer,
+            array<EnumeratedPrintQueueTypes>^   flags,
+            System::
+            Collections::
+            Generic::
+            Dictionary<String^, PrintQueue^>^   printQueuesByName,
+            array<String^>^                     propertyFilter
+            );
+
         private:
 
         EnumDataThunkObject(
@@ -15,6 +15,54 @@
 
 ref class FontInfo;
 
+//
+// Process-wide index of font file identities, mapping a font file path to the checksum of its
+// contents. Entries are revalidated against file length and last write time, so fonts that
+// are compared repeatedly across print jobs are read once per process rather than once per job.
+//
+ref class FontIdentityIndex abstract sealed
+{
+public:
+    /// <SecurityNote>
+    /// Critical    - Asserts read permission on font file, returns information describing font contents
+    /// </SecurityNote>
+    /// <Remarks>
+    /// Returns checksum of the file at path, or nullptr if the file can't be read.
+    /// </Remarks>
+    [SecurityCritical]
+    static array<Byte>^ GetChecksum(String^ path);
+
+    /// <SecurityNote>
+    /// Critical    - Reads font stream
+    /// </SecurityNote>
+    /// <Remarks>
+    /// Computes checksum of stream from its current position; used for fonts not backed by a file.
+    /// </Remarks>
+    [SecurityCritical]
+    static array<Byte>^ ComputeChecksum(Stream^ stream);
+
+    /// <Remarks>
+    /// Forgets all identities, e.g. after fonts were installed or removed from the system.
+    /// </Remarks>
+    static void Clear();
+
+    static bool ChecksumEquals(array<Byte>^ a, array<Byte>^ b);
+
+private:
+    value struct Identity
+    {
+        Int64        length;
+        DateTime     lastWriteTime;
+        array<Byte>^ checksum;
+    };
+
+    /// <SecurityNote>
+    /// Critical    - Contains font paths and information describing font contents
+    /// </SecurityNote>
+    [SecurityCritical]
+    static Dictionary<String^, Identity>^ s_identities = gcnew Dictionary<String^, Identity>(StringComparer::OrdinalIgnoreCase);
+};
+
 //
 // Wraps a font stream source (file Uri or GlyphTypeface) and allows comparing
 // font streams to determine if two fonts are the same.
@@ -96,8 +144,8 @@ public:
     /// TreatAsSafe - Returns only bool indicating if two streams are the same; no critical information leak
     /// </SecurityNote>
     /// <Remarks>
-    /// Determines if two font streams are the same, comparing length and first CompareLength
-    /// bytes if necessary.
+    /// Determines if two font streams are the same, comparing length and then content
+    /// checksums if necessary; falls back to comparing bytes if a checksum is unavailable.
     /// </Remarks>
     [SecurityCritical, SecurityTreatAsSafe]
     bool Equals(FontStreamContext %otherContext);
@@ -123,6 +171,24 @@ private:
     /// </SecurityNote>
     [SecurityCritical]
     int _streamLength;
+
+    /// <SecurityNote>
+    /// Critical    - Describes font stream contents
+    /// </SecurityNote>
+    [SecurityCritical]
+    array<Byte>^ _checksum;
+
+// Private Methods
+private:
+    /// <SecurityNote>
+    /// Critical    - Accesses font location and stream
+    /// </SecurityNote>
+    /// <Remarks>
+    /// Gets checksum of the font stream, from FontIdentityIndex when the font is a file.
+    /// May return nullptr if unable to read the font.
+    /// </Remarks>
+    [SecurityCritical]
+    array<Byte>^ GetChecksum();
 };
 
 //
@@ -165,6 +231,19 @@ public:
     [SecurityCritical]
     Object^ Install(FontStreamContext% context, String^ % newFamilyName, unsigned faceIndex);
 
+    /// <SecurityNote>
+    /// Critical    - Calls native methods, asserts to compute font subset, returns critical installation data
+    /// </SecurityNote>
+    /// <Remarks>
+    /// Installs a GDI font from memory containing only the given glyphs of typeface, which must be the
+    /// font described by context. Subsets are cached across print jobs by font identity and glyph set.
+    ///
+    /// Returns null if the font is too small to be worth subsetting or subsetting failed; caller
+    /// should then fall back to Install.
+    /// </Remarks>
+    [SecurityCritical]
+    Object^ InstallSubset(FontStreamContext% context, String^ % newFamilyName, GlyphTypeface^ typeface, ICollection<unsigned short>^ glyphs);
+
     /// <SecurityNote>
     /// Critical    - Calls native methods, takes in critical data
     /// </SecurityNote>
@@ -191,6 +270,24 @@ private:
     [SecurityCritical]
     int _streamLength;
 
+    // Fonts smaller than this are installed whole; subsetting them doesn't pay for itself.
+    static const int SubsetMinimumStreamLength = 1024 * 1024;
+
+    // Bytes of font subsets kept across jobs, see InstallSubset.
+    static const int SubsetCacheBudget = 32 * 1024 * 1024;
+
+    /// <SecurityNote>
+    /// Critical    - Contains font data
+    /// </SecurityNote>
+    /// <Remarks>
+    /// Subset cache, hash from subset key String^ -> array<Byte>^ subset font data. s_subsetCacheOrder
+    /// holds keys oldest first for eviction. Protected by the caller's lock on CGDIDevice font state.
+    /// </Remarks>
+    [SecurityCritical]
+    static Hashtable^ s_subsetCache = gcnew Hashtable();
+    static System::Collections::Queue^ s_subsetCacheOrder = gcnew System::Collections::Queue();
+    static int s_subsetCacheBytes;
+
 // Private Methods
 private:
     /// <SecurityNote>
@@ -239,7 +336,7 @@ public:
     /// to filling glyph geometry.
     /// </Remarks>
     [SecurityCritical, SecurityTreatAsSafe]
-    bool UsePrivate(GlyphTypeface^ typeface);
+    bool UsePrivate(GlyphTypeface^ typeface, ICollection<unsigned short>^ glyphs);
 
     /// <SecurityNote>
     /// Critical    - Touches critical install handle
@@ -249,6 +346,24 @@ public:
     [SecurityCritical, SecurityTreatAsSafe]
     void UninstallPrivate();
 
+    /// <SecurityNote>
+    /// Critical    - Stores critical font installation information
+    /// </SecurityNote>
+    /// <Remarks>
+    /// Takes the system installation of current, the entry for the same name in a rebuilt installed
+    /// font list; current may be nullptr if no font with this name is installed anymore.
+    /// </Remarks>
+    [SecurityCritical]
+    void SetSystemInstall(FontInfo^ current);
+
+    property bool HasPrivateInstall
+    {
+        bool get()
+        {
+            return _privateInstall != nullptr;
+        }
+    }
+
     property String^ NewFamilyName
     {
         String^ get()
@@ -264,6 +379,15 @@ private:
     String^          _newFamilyName;    // New 'unique' font family name to avoid name conflict. 
                                         // Should be valid when _privateInstall has value
 
+    // Glyphs in the installed private font when it's a subset; nullptr when the whole font is installed.
+    Dictionary<unsigned short, bool>^ _installedGlyphs;
+
+    // Number of times a growing subset of the current private font was installed. Once this
+    // reaches MaximumSubsetInstalls the whole font is installed instead.
+    int              _subsetInstalls;
+
+    static const int MaximumSubsetInstalls = 4;
+
     /// <SecurityNote>
     /// Critical    - Contains critical font path or font handle
     /// </SecurityNote>
@@ -45,6 +45,14 @@ public:
     [SecuritySafeCritical]
     HRESULT Load(BitmapSource ^ pBitmap, array<Byte>^ buffer, PixelFormat LoadFormat);
 
+    // Loads rows [firstRow, firstRow + rowCount) of pBitmap only, for banded rendering.
+    /// <SecurityNote>
+    /// Critical    - It calls PresentationCore internal function CriticalCopyPixels
+    /// TreatAsSafe - Image is copied to m_Buffer, which is marked as SecurityCritical
+    /// </SecurityNote>
+    [SecuritySafeCritical]
+    HRESULT LoadBand(BitmapSource ^ pBitmap, array<Byte>^ buffer, PixelFormat LoadFormat, int firstRow, int rowCount);
+
     System::Collections::Generic::IList<Color> ^ GetColorTable();
 
 //  HRESULT CopyCropImage();
@@ -80,6 +88,16 @@ public:
         return m_Buffer != nullptr;
     }
 
+    /// <SecurityNote>
+    /// Critical    - Uses m_Buffer
+    /// TreatAsSafe - Only the size is exposed
+    /// </SecurityNote>
+    [SecuritySafeCritical]
+    int GetBufferSize(void)
+    {
+        return ((m_Buffer != nullptr) ? m_Buffer->Length : 0) + ((m_Bi != nullptr) ? m_Bi->Length : 0);
+    }
+
     /// <SecurityNote>
     ///  Critical: Calls critical SetQuad
     /// </SecurityNote>
@@ -19,6 +19,8 @@ ref class CachedGDIObject
 {
 protected:
     array<Byte>   ^ m_RawData;
+    int             m_hash;
+    int             m_type;
 
     /// <SecurityNote>
     ///     Critical : Field for critical type
@@ -27,6 +29,19 @@ protected:
     GdiSafeHandle ^ m_handle;
     
 public:
+    CachedGDIObject ^ m_nextInBucket;   // Hash bucket chain
+    CachedGDIObject ^ m_newer;          // LRU list, towards most recently used
+    CachedGDIObject ^ m_older;          // LRU list, towards least recently used
+
+    property int Hash
+    {
+        int get() { return m_hash; }
+    }
+
+    property int Type
+    {
+        int get() { return m_type; }
+    }
     
     property GdiSafeHandle^ Handle
     {
@@ -41,7 +56,7 @@ public:
     ///     Critical : Unmanaged pointer
     /// </SecurityNote>
     [SecurityCritical]
-    CachedGDIObject(const interior_ptr<Byte> pData, int size, GdiSafeHandle ^ handle)
+    CachedGDIObject(const interior_ptr<Byte> pData, int size, int hash, int type, GdiSafeHandle ^ handle)
     {
         m_RawData = gcnew array<Byte>(size);
 
@@ -50,6 +65,8 @@ public:
             m_RawData[i] = pData[i];
         }
 
+        m_hash   = hash;
+        m_type   = type;
         m_handle = handle;
     }
 
@@ -57,9 +74,9 @@ public:
     ///     Critical : Unmanaged pointer
     /// </SecurityNote>
     [SecurityCritical]
-    GdiSafeHandle^ Match(const interior_ptr<Byte> pData, int size)
+    GdiSafeHandle^ Match(const interior_ptr<Byte> pData, int size, int hash)
     {
-        if (size != m_RawData->Length)
+        if ((hash != m_hash) || (size != m_RawData->Length))
         {
             return nullptr;
         }
@@ -76,6 +93,29 @@ public:
     }
 };
 
+// Cached DC state at the time of a SaveDC. RestoreDC selects the same objects and
+// modes back into the DC, so the cache can be restored from here instead of reset.
+ref class SavedDCState
+{
+public:
+    /// <SecurityNote>
+    ///     Critical : Fields for critical type
+    /// </SecurityNote>
+    [SecurityCritical]
+    GdiSafeHandle ^ m_font;
+
+    [SecurityCritical]
+    GdiSafeHandle ^ m_pen;
+
+    [SecurityCritical]
+    GdiSafeHandle ^ m_brush;
+
+    COLORREF        m_textColor;
+    int             m_polyFillMode;
+    unsigned        m_textAlign;
+    float           m_miterLimit;
+};
+
 
 /// <Summary>
 ///     Thin wrapper over an HDC
@@ -97,8 +137,21 @@ protected:
 
     array<Byte>^ m_lastDevmode;
 
+    // GDI object cache: hashed on the raw LOGxxx key, evicted least recently used first.
+    // Capacity is per object type (OBJ_BRUSH, OBJ_PEN, OBJ_FONT); see CacheCapacity.
     array<CachedGDIObject ^> ^ m_Cache;
-    int                             m_CacheFirst;
+    CachedGDIObject ^               m_CacheNewest;
+    CachedGDIObject ^               m_CacheOldest;
+    array<int> ^                    m_CacheCount;
+    array<int> ^                    m_CacheCapacity;    // Snapshot of GetCacheCapacity for this job
+
+    // Per print job cache statistics, reset by Initialize
+    int                             m_CacheHits;
+    int                             m_CacheMisses;
+    int                             m_CacheEvictions;
+
+    static array<int>             ^ s_CacheRequested = gcnew array<int>{ 128, 128, 64 };   // Brush, pen, font
+    static array<int>             ^ s_CacheCapacity;                                     // s_CacheRequested bounded by GDI quota
     
     /// <SecurityNote>
     ///     Critical : Field for critical type
@@ -123,6 +176,8 @@ protected:
     unsigned                        m_lastTextAlign;
     float                           m_lastMiterLimit;
 
+    System::Collections::Stack    ^ m_savedStates;      // SavedDCState per outstanding SaveDCState
+
     /// <SecurityNote>
     ///     Critical : It contains list of fonts installed on the system and their paths
     /// </SecurityNote>
@@ -135,6 +190,13 @@ protected:
                                                         // So for the moment, we will leak the fonts until applications closes
                                                         // In long term, we need a way to wait for job completion
     static Object                 ^ s_lockObject = gcnew Object();            // Synchronization
+
+    /// <SecurityNote>
+    ///     Critical : Registry key handle obtained under registry permission assert
+    /// </SecurityNote>
+    [SecurityCritical]
+    static Microsoft::Win32::RegistryKey ^ s_fontsKey;                        // Kept open to watch for font installs/uninstalls
+    static System::Threading::AutoResetEvent ^ s_fontsChanged;                // Signaled when s_fontsKey changes; s_InstalledFonts is then rebuilt
     static ArrayList              ^ s_oldPrivateFonts = gcnew ArrayList();    // Fonts to be deleted after 10 minutes, upon new print job  
     
 public:
@@ -171,6 +233,27 @@ public:
         }
     }
 
+    /// <Summary>
+    ///     Maximum number of cached GDI objects of type OBJ_BRUSH, OBJ_PEN or OBJ_FONT kept per page.
+    ///     Takes effect for print jobs started afterwards, and is always bounded by the process GDI handle quota.
+    /// </Summary>
+    static void SetCacheCapacity(int type, int capacity);
+
+    property int CacheHits
+    {
+        int get() { return m_CacheHits; }
+    }
+
+    property int CacheMisses
+    {
+        int get() { return m_CacheMisses; }
+    }
+
+    property int CacheEvictions
+    {
+        int get() { return m_CacheEvictions; }
+    }
+
     // Constructor
     /// <SecurityNote>
     /// Critical    - It calls native methods to obtains stock GDI objects
@@ -191,6 +274,15 @@ public:
     /// </SecurityCritical>
     [SecurityCritical]
     void ResetStates();
+
+    /// <SecurityNote>
+    /// Critical    - Calls native methods to save and restore critical GDI state
+    /// </SecurityNote>
+    [SecurityCritical]
+    BOOL SaveDCState();
+
+    [SecurityCritical]
+    BOOL RestoreDCState();
     
     // Initialization
     /// <SecurityNote>
@@ -387,13 +479,31 @@ public:
     ///     Critical : Calls critical method to retrieve cached GDI handle
     /// </SecurityNote>
     [SecurityCritical]
-    GdiSafeHandle^ CacheMatch(const interior_ptr<Byte> pData, int size);
+    GdiSafeHandle^ CacheMatch(const interior_ptr<Byte> pData, int size, int type);
 
     /// <SecurityNote>
     ///     Critical : Calls critical method to cache GDI handle
     /// </SecurityNote>
     [SecurityCritical]
-    void CacheObject(const interior_ptr<Byte> pData, int size, GdiSafeHandle^ handle);
+    void CacheObject(const interior_ptr<Byte> pData, int size, int type, GdiSafeHandle^ handle);
+
+    /// <SecurityNote>
+    ///     Critical : Closes cached GDI handles
+    /// </SecurityNote>
+    [SecurityCritical]
+    void CacheFlush();
+
+    /// <SecurityNote>
+    ///     Critical : Accesses critical GDI handles
+    /// </SecurityNote>
+    [SecurityCritical]
+    void CacheUnlink(CachedGDIObject ^ entry);
+
+    /// <SecurityNote>
+    ///     Critical : Calls critical method to read GDI handle quota from the registry
+    /// </SecurityNote>
+    [SecurityCritical]
+    static array<int>^ GetCacheCapacity();
 
     /// <SecurityNote>
     /// Critical    - Calls native method to obtain create GDI pen from WPF pen
@@ -429,8 +539,20 @@ public:
     /// <Returns>Returns nullptr if unable to retrieve font directory name or install the font.
     /// Otherwise, (new) font family name will be returned.
     /// If nullptr is returned, caller should fallback to filling text geometry.</Returns>
+    /// glyphs are the glyph indices about to be rendered; private fonts may be installed as a subset covering them.
+    [SecurityCritical]
+    String^ CheckFont(GlyphTypeface^ typeface, ICollection<unsigned short>^ glyphs, String ^ name, [Out] Boolean% isPrivateFont);
+
+    /// <SecurityNote>
+    ///     Critical   : Opens registry key and calls native RegNotifyChangeKeyValue; caller must assert
+    ///                  registry read and unmanaged code permissions
+    /// </SecurityNote>
+    /// <Remarks>
+    /// Returns the installed fonts registry key, arming s_fontsChanged to be signaled on its next change.
+    /// Called under s_lockObject by BuildFontList.
+    /// </Remarks>
     [SecurityCritical]
-    String^ CheckFont(GlyphTypeface^ typeface, String ^ name, [Out] Boolean% isPrivateFont);
+    static Microsoft::Win32::RegistryKey^ WatchFontsKey();
 
     /// <SecurityNote>
     ///     Critical   : Uninstalls fonts via critical FontInfo::Uninstall
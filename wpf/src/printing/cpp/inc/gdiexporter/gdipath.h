@@ -7,6 +7,9 @@ private:
     CGDIPath(GeometryProxy% geometry, Matrix matrix, bool ForFill, Pen^ pen);
 
 public:
+    // Returns point buffers for reuse by later paths; path is invalid afterwards.
+    ~CGDIPath();
+
     static CGDIPath^ CreateFillPath(GeometryProxy% geometry, Matrix matrix)
     {
         return gcnew CGDIPath(geometry, matrix, true, nullptr);
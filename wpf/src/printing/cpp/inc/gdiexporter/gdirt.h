@@ -144,6 +144,13 @@ public:
     [SecurityCritical]
     virtual void Comment(String ^ comment);
 
+    // Sets the per band memory budget used by banded rendering, for jobs drawn afterwards.
+    static void SetBandMemoryBudget(int bytes);
+
+    // Sets whether FillLinearGradient may drop gradient stops whose bands are narrower than a
+    // device pixel, for jobs drawn afterwards.
+    static void SetCollapseGradientBands(bool collapse);
+
 protected:
     // current state data
     System::Collections::Stack^ m_state;
@@ -201,6 +208,200 @@ protected:
 
     System::Collections::Hashtable^ m_cachedUnstyledFontCharsets;
 
+    // Per job cache of RasterizeBrush results, so that headers, logos and watermarks repeated on
+    // every page are only rasterized once. Keyed on brush content and everything RasterizeBrush
+    // derives the raster from; bounded by RasterizedBrushCacheBudget bytes, least recently used
+    // entries are dropped first.
+    //
+    // Hash from RasterizedBrushKey^ -> RasterizedBrushEntry^
+    ref class RasterizedBrushKey sealed
+    {
+    public:
+        // Returns nullptr if the brush content may change between uses and can't be cached.
+        static RasterizedBrushKey^ Create(
+            Brush^      brush,
+            Int32Rect   renderBounds,
+            Int32Rect   bounds,
+            Rect        geometryBounds,
+            bool        vertical,
+            bool        horizontal,
+            double      scaleX,
+            double      scaleY,
+            Matrix      transform
+            );
+
+    private:
+        Object^     m_content;          // brush, or the ImageSource/Drawing a tile brush paints
+        Rect        m_viewport;
+        Rect        m_viewbox;
+        int         m_tileFlags;
+        double      m_opacity;
+        Matrix      m_brushTransform;
+        Matrix      m_relativeTransform;
+        Int32Rect   m_renderBounds;
+        Int32Rect   m_bounds;
+        Rect        m_geometryBounds;
+        bool        m_vertical;
+        bool        m_horizontal;
+        double      m_scaleX;
+        double      m_scaleY;
+        Matrix      m_transform;
+
+    public:
+        virtual int GetHashCode() override sealed
+        {
+            return System::Runtime::CompilerServices::RuntimeHelpers::GetHashCode(m_content) ^
+                m_renderBounds.GetHashCode() ^ m_geometryBounds.GetHashCode() ^
+                m_transform.GetHashCode() ^ m_scaleX.GetHashCode();
+        }
+
+        virtual bool Equals(Object^ other) override sealed
+        {
+            RasterizedBrushKey^ o = dynamic_cast<RasterizedBrushKey^>(other);
+
+            if (o == nullptr)
+            {
+                return false;
+            }
+            else
+            {
+                return Object::ReferenceEquals(m_content, o->m_content) &&
+                    m_viewport == o->m_viewport &&
+                    m_viewbox == o->m_viewbox &&
+                    m_tileFlags == o->m_tileFlags &&
+                    m_opacity == o->m_opacity &&
+                    m_brushTransform == o->m_brushTransform &&
+                    m_relativeTransform == o->m_relativeTransform &&
+                    m_renderBounds == o->m_renderBounds &&
+                    m_bounds == o->m_bounds &&
+                    m_geometryBounds == o->m_geometryBounds &&
+                    m_vertical == o->m_vertical &&
+                    m_horizontal == o->m_horizontal &&
+                    m_scaleX == o->m_scaleX &&
+                    m_scaleY == o->m_scaleY &&
+                    m_transform == o->m_transform;
+            }
+        }
+    };
+
+    ref class RasterizedBrushEntry sealed
+    {
+    public:
+        CGDIBitmap                                          bitmap;
+        int                                                 size;
+        LinkedListNode<RasterizedBrushKey^>               ^ node;
+    };
+
+    // Per job cache of decoded and format converted DrawBitmap sources, so that an image drawn on
+    // every page is only decoded once. Only frozen sources are cached; bounded by
+    // LoadedBitmapCacheBudget bytes, least recently used entries are dropped first.
+    //
+    // Hash from LoadedBitmapKey^ -> LoadedBitmapEntry^
+    ref class LoadedBitmapKey sealed
+    {
+    public:
+        LoadedBitmapKey(BitmapSource^ source, PixelFormat format)
+        {
+            m_source = source;
+            m_format = format;
+        }
+
+    private:
+        BitmapSource^   m_source;
+        PixelFormat     m_format;
+
+    public:
+        virtual int GetHashCode() override sealed
+        {
+            return System::Runtime::CompilerServices::RuntimeHelpers::GetHashCode(m_source) ^
+                m_format.GetHashCode();
+        }
+
+        virtual bool Equals(Object^ other) override sealed
+        {
+            LoadedBitmapKey^ o = dynamic_cast<LoadedBitmapKey^>(other);
+
+            if (o == nullptr)
+            {
+                return false;
+            }
+            else
+            {
+                return Object::ReferenceEquals(m_source, o->m_source) &&
+                    m_format == o->m_format;
+            }
+        }
+    };
+
+    ref class LoadedBitmapEntry sealed
+    {
+    public:
+        CGDIBitmap                                          bitmap;
+        int                                                 size;
+        LinkedListNode<LoadedBitmapKey^>                  ^ node;
+    };
+
+    // Per job cache of DrawBitmap_PassThrough results for frozen sources: the encoded JPEG/PNG
+    // payload and the driver's CHECKJPEGFORMAT/CHECKPNGFORMAT verdict, so the same image on every
+    // page isn't re-encoded and re-checked. Bounded by PassThroughCacheBudget bytes of payload.
+    //
+    // Hash from BitmapSource^ -> PassThroughEntry^
+    ref class PassThroughEntry sealed
+    {
+    public:
+        array<Byte>                                       ^ raw;            // nullptr if not passed through
+        DWORD                                               compression;    // BI_JPEG, BI_PNG, or BI_RGB if not supported
+        int                                                 size;
+        LinkedListNode<BitmapSource^>                     ^ node;
+    };
+
+    void AddPassThroughEntry(BitmapSource ^ pIBitmap, PassThroughEntry ^ entry);
+
+    // Upper bound, in bytes, on the intermediate bitmap of one band when DrawBitmap or
+    // RasterizeShape render in bands, so peak memory does not grow with image or page size.
+    static int                                  s_bandMemoryBudget = DefaultBandMemoryBudget;
+
+    // Loads pImage in LoadFormat into source, going through the loaded bitmap cache.
+    HRESULT LoadBitmap(
+        CGDIBitmap    % source,
+        BitmapSource ^ pImage,
+        PixelFormat    LoadFormat
+        );
+
+    // Draws pImage through bands of source rows, each loaded and sent to the DC separately.
+    HRESULT DrawBitmapBanded(
+        BitmapSource ^ pImage,
+        PixelFormat    LoadFormat,
+        Int32Rect      rcDstBounds,
+        bool           flipHoriz,
+        bool           flipVert
+        );
+
+    // When set, FillLinearGradient drops a gradient stop if the band between its neighbours spans
+    // less than one device pixel, shrinking GradientFill records of densely stopped gradients.
+    static bool                                 s_collapseGradientBands = true;
+
+    // GradientFill vertex/index buffers, reused across FillLinearGradient calls and grown as needed.
+    array<CNativeMethods::TriVertex>^           m_gradientVertices;
+    array<unsigned long>^                       m_gradientIndices;
+
+    // RenderGlyphRun text and lpDx buffers, reused across glyph runs and grown as needed.
+    array<Char>^                                m_glyphCharacters;
+    array<unsigned short>^                      m_glyphIndices;
+    array<int>^                                 m_glyphDx;
+
+    System::Collections::Hashtable^             m_rasterizedBrushCache;
+    LinkedList<RasterizedBrushKey^>^            m_rasterizedBrushLru;   // most recently used first
+    int                                         m_rasterizedBrushBytes;
+
+    System::Collections::Hashtable^             m_loadedBitmapCache;
+    LinkedList<LoadedBitmapKey^>^               m_loadedBitmapLru;      // most recently used first
+    int                                         m_loadedBitmapBytes;
+
+    System::Collections::Hashtable^             m_passThroughCache;
+    LinkedList<BitmapSource^>^                  m_passThroughLru;       // most recently used first
+    int                                         m_passThroughBytes;
+
     // Throws an exception for an HRESULT if it's a failure.
     // Special case: Throws PrintingCanceledException for ERROR_CANCELLED/ERROR_PRINT_CANCELLED.
 
@@ -272,6 +473,8 @@ protected:
         IN ImageBrush^ brush
         );
 
+    // Rasterizes pFillBrush over renderBounds using the current world transform.
+    // See also RasterizeBrushBand in gdirt.cpp, which the band pipeline runs off the DC thread.
     HRESULT RasterizeBrush(
         CGDIBitmap    % bmpdata,
         Int32Rect       renderBounds,     // render bounds in device space, rounded
@@ -982,6 +982,26 @@ internal:
         );
 
 
+    /// <SecurityNote>
+    ///     Critical: Elevates to unmanagedcode permission
+    /// </SecurityNote>
+    [DllImport(
+            "advapi32.dll",
+            EntryPoint = "RegNotifyChangeKeyValue",
+            CallingConvention = CallingConvention::Winapi)]
+    [SecurityCritical]
+    [SuppressUnmanagedCodeSecurity]
+    static
+    LONG
+    RegNotifyChangeKeyValue(
+        Microsoft::Win32::SafeHandles::SafeRegistryHandle^ hKey,    // key to watch
+        BOOL bWatchSubtree,                                         // also watch subkeys
+        DWORD dwNotifyFilter,                                       // REG_NOTIFY_CHANGE_*
+        Microsoft::Win32::SafeHandles::SafeWaitHandle^ hEvent,      // signaled on change
+        BOOL fAsynchronous                                          // must be TRUE with hEvent
+        );
+
+
     const static int CSIDL_FONTS = 0x0014; // shlobj.h
 
     /// <SecurityNote>
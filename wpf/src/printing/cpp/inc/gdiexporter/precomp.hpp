@@ -29,6 +29,7 @@ using namespace System::Windows;
 using namespace System::Windows::Media;
 
 using namespace Microsoft::Internal::AlphaFlattener;
+using namespace MS::Utility;
 
 #include "..\LegacyDevice.hpp"
 
@@ -123,6 +123,10 @@ Geometry^ TransformGeometry(Geometry^ geometry, Matrix transform);
 // Maximum rasterization size in pixels
 const int RasterizeBandPixelLimit = 1600 * 1200;
 
+// Default memory budget, in bytes, for one band of banded rendering. Sized so a
+// RasterizeBandPixelLimit band fits both its Pbgra32 raster and Bgr24 copy.
+const int DefaultBandMemoryBudget = RasterizeBandPixelLimit * (4 + 3);
+
 // Proxy for Geometry that caches Geometry conversions and attributes.
 ref struct GeometryProxy
 {
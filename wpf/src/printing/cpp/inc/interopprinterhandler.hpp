@@ -1626,6 +1626,24 @@ namespace PrintWin32Thunk
 
         int                                 jobIdentifier;
 
+        //
+        // Size of the last EnumJobs result, used to size the first call
+        // of the next enumeration so the probing call can be skipped
+        //
+        UInt32                              enumJobsBufferHint;
+
+        //
+        // Size of the last EnumPrinters result per level, shared by all
+        // enumerations in the process. Lost updates only cost a probing call.
+        //
+        static
+        array<UInt32>^                      enumPrintersBufferHints;
+
+        //
+        // Size of the last GetPrinter result per level on this handle
+        //
+        array<UInt32>^                      getPrinterBufferHints;
+
         ///<SecurityNote>
         /// Critical        : Field for type from non-APTCA Reachframework.dll (XpsDocumentEventType)
         ///</SecurityNote>
@@ -193,6 +193,54 @@ namespace Win32ApiThunk
         bool
         InvokeEnumJobs(IntPtr, UInt32, UInt32, UInt32, SafeMemoryHandle^, UInt32, UInt32*, UInt32*);
 
+        ///<SecurityNote>
+        /// Critical    - SUC applied; enables FindFirstPrinterChangeNotification API call in Intranet Zone 
+        ///             - non-admin operation; callers must demand DefaultPrinting
+        ///</SecurityNote>
+        [DllImportAttribute("winspool.drv",EntryPoint="FindFirstPrinterChangeNotification",
+                             CharSet=CharSet::Unicode,
+                             SetLastError=true, 
+                             CallingConvention = CallingConvention::Winapi)]
+        static
+        IntPtr
+        InvokeFindFirstPrinterChangeNotification(IntPtr, UInt32, UInt32, IntPtr);
+
+        ///<SecurityNote>
+        /// Critical    - SUC applied; enables FindNextPrinterChangeNotification API call in Intranet Zone 
+        ///             - non-admin operation; callers must demand DefaultPrinting
+        ///</SecurityNote>
+        [DllImportAttribute("winspool.drv",EntryPoint="FindNextPrinterChangeNotification",
+                             CharSet=CharSet::Unicode,
+                             SetLastError=true, 
+                             CallingConvention = CallingConvention::Winapi)]
+        static
+        bool
+        InvokeFindNextPrinterChangeNotification(IntPtr, UInt32*, IntPtr, IntPtr*);
+
+        ///<SecurityNote>
+        /// Critical    - SUC applied; enables FindClosePrinterChangeNotification API call in Intranet Zone 
+        ///             - non-admin operation; callers must demand DefaultPrinting
+        ///</SecurityNote>
+        [DllImportAttribute("winspool.drv",EntryPoint="FindClosePrinterChangeNotification",
+                             CharSet=CharSet::Unicode,
+                             SetLastError=true, 
+                             CallingConvention = CallingConvention::Winapi)]
+        static
+        bool
+        InvokeFindClosePrinterChangeNotification(IntPtr);
+
+        ///<SecurityNote>
+        /// Critical    - SUC applied; enables FreePrinterNotifyInfo API call in Intranet Zone 
+        ///             - non-admin operation; callers must demand DefaultPrinting
+        ///</SecurityNote>
+        [DllImportAttribute("winspool.drv",EntryPoint="FreePrinterNotifyInfo",
+                             CharSet=CharSet::Unicode,
+                             SetLastError=true, 
+                             CallingConvention = CallingConvention::Winapi)]
+        static
+        bool
+        InvokeFreePrinterNotifyInfo(IntPtr);
+
         #ifdef XPSJOBNOTIFY
 
         ///<SecurityNote>
@@ -19,6 +19,7 @@
 --*/
 
 #using PRESENTATIONCORE_DLL as_friend
+#using WINDOWSBASE_DLL      as_friend   // MS::Utility::EventTrace
 
 using namespace System;
 
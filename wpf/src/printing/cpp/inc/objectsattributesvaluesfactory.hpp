@@ -380,10 +380,18 @@ namespace Activation
         Object^                         syncRoot;
 
         bool                            isDisposed;
-        Hashtable^                      valueDelegatesTable;
-        Hashtable^                      noValueDelegatesTable;
-        Hashtable^                      valueLinkedDelegatesTable;
-        Hashtable^                      noValueLinkedDelegatesTable;
+
+        //
+        // Keyed by the object Type; see PrintPropertyFactory
+        //
+        System::Collections::Generic::
+        Dictionary<Type^, PrintSystemObject::CreateWithValue^>^            valueDelegatesTable;
+        System::Collections::Generic::
+        Dictionary<Type^, PrintSystemObject::CreateWithNoValue^>^          noValueDelegatesTable;
+        System::Collections::Generic::
+        Dictionary<Type^, PrintSystemObject::CreateWithValueLinked^>^      valueLinkedDelegatesTable;
+        System::Collections::Generic::
+        Dictionary<Type^, PrintSystemObject::CreateWithNoValueLinked^>^    noValueLinkedDelegatesTable;
     };
 }
 }
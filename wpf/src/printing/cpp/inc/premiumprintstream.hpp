@@ -260,6 +260,18 @@ namespace Printing
             void
             );
 
+        /// <summary>
+        /// Maximum number of BeginWrite requests queued on this stream before
+        /// BeginWrite blocks the caller until the writer catches up.
+        /// </summary>
+        property
+        Int32
+        MaxPendingWrites
+        {
+            Int32 get();
+            void set(Int32 value);
+        }
+
         ///<SecurityNote>
         /// Critical    - Calls helper method InitializePrintStream which asserts DefaultPrinting
         ///               if the PrintQueue has the InPartialTrust property set to True
@@ -350,6 +362,24 @@ namespace Printing
             String^ messageId
             );
 
+        ///<SecurityNote>
+        /// Critical    - Calls Write which writes to the spool file stream obtained as a result of an elevation.
+        ///</SecurityNote>
+        [SecurityCritical]
+        void
+        DrainWriteQueue(
+            Object^ state
+            );
+
+        void
+        WaitForPendingWrites(
+            void
+            );
+
+        static
+        const
+        Int32           defaultMaxPendingWrites = 16;
+
         PrintQueue^     printQueue;
 
         ///<SecurityNote>
@@ -399,6 +429,16 @@ namespace Printing
         PrintSystemDispatcherObject^    accessVerifier;
 
         Boolean                             isFinalizer;
+
+        /// <summary>
+        /// BeginWrite requests not yet written, in submission order. A single thread pool
+        /// work item drains the queue while writeWorkerActive is set, which keeps the writes
+        /// ordered. These fields are protected by locking writeQueue.
+        /// </summary>
+        System::Collections::Queue^         writeQueue;
+        Boolean                             writeWorkerActive;
+        System::Threading::Thread^          writeWorkerThread;
+        Int32                               maxPendingWrites;
     };
 
     private ref class WritePrinterAsyncResult :
@@ -458,6 +498,16 @@ namespace Printing
             void
             );
 
+        /// <summary>
+        /// Exception thrown by the write, rethrown to the caller of EndWrite.
+        /// </summary>
+        property
+        Exception^
+        WriteException
+        {
+            Exception^ get();
+        }
+
         private:
 
         Stream^                             printStream;
@@ -468,6 +518,7 @@ namespace Printing
         array<Byte>^                        dataArray;
         Int32                               dataOffset;
         Int32                               numberOfBytes;
+        Exception^                          writeException;
     };
 
 
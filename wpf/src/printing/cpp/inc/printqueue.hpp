@@ -164,6 +164,8 @@ namespace Printing
         DefaultPrintTicket
     };
 
+    ref class PrintQueueChangeWatcher;
+
     /// <summary>
     /// This class abstracts the functionality of a print queue.
     /// </summary>
@@ -682,6 +684,26 @@ namespace Printing
             PrintJobSettings^ get();
         }
 
+        /// <summary>
+        /// Gets or sets how many pages the XPS serializer accumulates before it writes the font subsets
+        /// used by those pages to the print job.
+        /// </summary>
+        /// <remarks>
+        /// The default is 4. A value of 1 streams the job page by page: each page is written to the spooler
+        /// together with its fonts as soon as it is serialized, so memory use does not grow with the
+        /// number of pages, at the cost of larger font subsets in the spool file.
+        /// The value applies to writers created after it is set and only to queues that are printed to
+        /// through the XPS package path.
+        /// </remarks>
+        /// <exception cref="ArgumentOutOfRangeException">The value is less than 1.</exception>
+        property
+        Int32
+        XpsFontSubsettingPageCount
+        {
+            Int32 get();
+            void set(Int32 pageCount);
+        }
+
 
         PrintSystemJobInfo^
         GetJob(
@@ -1428,6 +1450,100 @@ namespace Printing
             void
             ) override;
 
+        /// <summary>
+        /// Starts watching the Print Spooler service for changes to this print queue.
+        /// </summary>
+        /// <remarks>
+        /// While change notifications are on, changed properties are refreshed as the spooler reports
+        /// them and <see cref="SpoolerPropertiesChanged"/> is raised on the thread that created the
+        /// queue, if that thread runs a Dispatcher. Refresh only fetches properties reported as
+        /// changed, and does nothing when there are none, so uncommitted values of other properties are kept.
+        /// </remarks>
+        /// <exception cref="PrintQueueException">Thrown on failure.</exception>
+        ///<SecurityNote>
+        /// Critical    - Registers for spooler notifications on the critical printer handle
+        /// PublicOK    - Only properties already exposed by Refresh are updated
+        ///</SecurityNote>
+        [SecuritySafeCritical]
+        void
+        StartChangeNotifications(
+            void
+            );
+
+        /// <summary>
+        /// Stops watching the Print Spooler service for changes to this print queue.
+        /// </summary>
+        ///<SecurityNote>
+        /// Critical    - Closes spooler notifications on the critical printer handle
+        /// PublicOK    - Only releases the notification registration
+        ///</SecurityNote>
+        [SecuritySafeCritical]
+        void
+        StopChangeNotifications(
+            void
+            );
+
+        /// <summary>
+        /// Occurs after properties of this print queue were changed in the Print Spooler service and refreshed.
+        /// </summary>
+        /// <remarks>
+        /// Raised only while change notifications are on; see <see cref="StartChangeNotifications"/>.
+        /// </remarks>
+        event EventHandler<PrintSystemObjectPropertiesChangedEventArgs^>^ SpoolerPropertiesChanged;
+
+        internal:
+
+        /// <summary>
+        /// Refreshes properties reported changed by the change watcher and raises SpoolerPropertiesChanged.
+        /// Runs on the thread owning the queue.
+        /// </summary>
+        ///<SecurityNote>
+        /// Critical    - Uses the critical change watcher
+        /// TreatAsSafe - Refreshes data exposed by Refresh
+        ///</SecurityNote>
+        [SecuritySafeCritical]
+        void
+        ApplySpoolerChanges(
+            void
+            );
+
+        virtual
+        void
+        OnPropertiesChanged(
+            PrintSystemObject^                            sender,
+            PrintSystemObjectPropertiesChangedEventArgs^  e
+            ) override;
+
+        /// <summary>
+        /// The properties refreshed by Refresh.
+        /// </summary>
+        property
+        array<String^>^
+        RefreshPropertiesFilter
+        {
+            array<String^>^ get();
+        }
+
+        /// <summary>
+        /// True if the queue can be refreshed from an enumeration of the queues on its server.
+        /// Browsable queues must be activated and watched queues only fetch what changed,
+        /// so both keep going through Refresh.
+        /// </summary>
+        property
+        Boolean
+        CanRefreshFromEnumeration
+        {
+            Boolean get();
+        }
+
+        /// <summary>
+        /// Completes a refresh done by PrintServer::RefreshPrintQueues.
+        /// </summary>
+        void
+        EndRefreshFromEnumeration(
+            void
+            );
+
         internal:
         /// <summary>
         /// Return an implementation ot ILegacyDevice implementation for printing to legacy printers
@@ -2033,6 +2149,30 @@ namespace Printing
             String^ downlevelPropertyName
             );
 
+        ///<SecurityNote>
+        /// Critical    - Uses critical printTicketManager field and non-APTCA reachframework.dll type (PrintTicket)
+        ///</SecurityNote>
+        [SecurityCritical]
+        PrintTicket^
+        ConvertDevModeToPrintTicket(
+            array<Byte>^                devMode
+            );
+
+        ///<SecurityNote>
+        /// Critical    - Uses critical printTicketManager field and non-APTCA reachframework.dll type (PrintTicket)
+        ///</SecurityNote>
+        [SecurityCritical]
+        array<Byte>^
+        ConvertPrintTicketToDevMode(
+            PrintTicket^                printTicket,
+            System::Printing::Interop::BaseDevModeType baseType
+            );
+
+        void
+        ClearTicketConversionCache(
+            void
+            );
+
         String^
         PrepareNameForDownLevelConnectivity(
             String^ serverName,
@@ -2326,6 +2466,23 @@ namespace Printing
 
         PrintJobSettings^                   _currentJobSettings;
 
+        //
+        // Results of the PrintTicket provider's DEVMODE <-> PrintTicket conversions
+        // for this queue, keyed by content. Batch jobs submitted with the same
+        // settings skip the provider round trip; a driver change clears both.
+        //
+        System::Collections::Generic::Dictionary<String^, array<Byte>^>^ printTicketXmlByDevMode;
+        System::Collections::Generic::Dictionary<String^, array<Byte>^>^ devModeByPrintTicketXml;
+
+        static const Int32                  maxTicketConversionCacheEntries = 16;
+
+        //
+        // Pages per font subset commit for XPS serialization; 0 means the default
+        //
+        Int32                               xpsFontSubsettingPageCount;
+
+        static const Int32                  defaultXpsFontSubsettingPageCount = 4;
+
         //
         // The following set of boolean properties represent
         // the status of the PrintQueue
@@ -2482,7 +2639,11 @@ namespace Printing
             L"Attributes"
         };
 
-        Hashtable^ collectionsTable;
+        //
+        // Whether an attribute lives in the thunking collection rather
+        // than in PropertiesCollection; shared by all instances
+        //
+        static System::Collections::Generic::Dictionary<String^, Boolean>^ thunkedAttributeNames;
 
         static Hashtable^ attributeNameTypes;
         static Hashtable^ upLevelToDownLevelMapping;
@@ -2537,6 +2698,12 @@ namespace Printing
         Object^                         _lockObject;
 
         XpsCompatiblePrinter^           xpsCompatiblePrinter;
+
+        ///<SecurityNote>
+        /// Critical    - Holds a reference on the printer handle
+        ///</SecurityNote>
+        [SecurityCritical]
+        PrintQueueChangeWatcher^        changeWatcher;      // non-null while change notifications are on
     };
 
     public ref class PrintQueueCollection :
@@ -2626,6 +2793,160 @@ namespace Printing
 
     };
 
+    /// <summary>
+    /// Watches a print queue through FindFirstPrinterChangeNotification and records which
+    /// properties the spooler reports changed. Watchers are waited on by shared background threads,
+    /// each multiplexing up to MaximumWatchersPerThread queues, so monitoring many queues costs a
+    /// few threads rather than one per queue or a polling Refresh per queue.
+    /// </summary>
+    ///<SecurityNote>
+    /// Critical    - Calls Win32 notification APIs with SUC applied on a critical printer handle
+    ///</SecurityNote>
+    [SecurityCritical(SecurityCriticalScope::Everything)]
+    private ref class PrintQueueChangeWatcher sealed
+    {
+        public:
+
+        PrintQueueChangeWatcher(
+            PrintQueue^                                             printQueue,
+            MS::Internal::PrintWin32Thunk::PrinterThunkHandler^     printerHandler,
+            System::Windows::Threading::Dispatcher^                 dispatcher
+            );
+
+        /// <summary>
+        /// Stops watching. The change handle is closed by the wait thread once it stops waiting on it.
+        /// </summary>
+        void
+        Close(
+            void
+            );
+
+        /// <summary>
+        /// Returns the downlevel names of properties changed since the last call, and resets them.
+        /// fullRefresh is set when notifications were lost and every property must be refreshed.
+        /// </summary>
+        array<String^>^
+        TakeChanges(
+            bool%   fullRefresh
+            );
+
+        private:
+
+        //
+        // Wraps a change notification handle for WaitHandle::WaitAny; the handle is not owned.
+        //
+        ref class ChangeWaitHandle sealed : public System::Threading::WaitHandle
+        {
+            public:
+
+            ChangeWaitHandle(
+                IntPtr  changeHandle
+                )
+            {
+                SafeWaitHandle = gcnew Microsoft::Win32::SafeHandles::SafeWaitHandle(changeHandle, false);
+            }
+        };
+
+        //
+        // One wait thread and the watchers it waits on.
+        //
+        ref class WaitGroup sealed
+        {
+            public:
+
+            WaitGroup(
+                void
+                ) :
+            watchers(gcnew System::Collections::Generic::List<PrintQueueChangeWatcher^>()),
+            closing(gcnew System::Collections::Generic::List<PrintQueueChangeWatcher^>()),
+            wake(gcnew System::Threading::AutoResetEvent(false))
+            {
+            }
+
+            System::Collections::Generic::List<PrintQueueChangeWatcher^>^   watchers;
+            System::Collections::Generic::List<PrintQueueChangeWatcher^>^   closing;    // closed, handles pending release
+            System::Threading::AutoResetEvent^                              wake;       // signaled when either list changes
+        };
+
+        // Called on the wait thread when the change handle is signaled.
+        void
+        OnSignaled(
+            void
+            );
+
+        void
+        AddChangedField(
+            unsigned short  field
+            );
+
+        // Posted to the queue's dispatcher by OnSignaled.
+        void
+        ApplyOnQueueThread(
+            void
+            );
+
+        // Called on the wait thread after it stopped waiting on the change handle.
+        void
+        ReleaseHandle(
+            void
+            );
+
+        static
+        void
+        WaitGroupThread(
+            Object^ group
+            );
+
+        // WaitAny handles at most 64 handles; one is the group's wake event.
+        static const int MaximumWatchersPerThread = 63;
+
+        static System::Collections::Generic::List<WaitGroup^>^  groups = gcnew System::Collections::Generic::List<WaitGroup^>();
+        static Object^                                          groupsLock = gcnew Object();
+
+        //
+        // Downlevel property names refreshed for each PRINTER_NOTIFY_FIELD_* value, indexed by field
+        //
+        static array<array<String^>^>^ fieldProperties =
+        {
+            /* SERVER_NAME          */  gcnew array<String^> { L"HostingPrintServerName" },
+            /* PRINTER_NAME         */  gcnew array<String^> { L"Name", L"Description" },
+            /* SHARE_NAME           */  gcnew array<String^> { L"ShareName" },
+            /* PORT_NAME            */  gcnew array<String^> { L"QueuePortName" },
+            /* DRIVER_NAME          */  gcnew array<String^> { L"QueueDriverName", L"Description", L"IsXpsEnabled" },
+            /* COMMENT              */  gcnew array<String^> { L"Comment" },
+            /* LOCATION             */  gcnew array<String^> { L"Location", L"Description" },
+            /* DEVMODE              */  gcnew array<String^> { L"DefaultDevMode", L"UserDevMode" },
+            /* SEPFILE              */  gcnew array<String^> { L"SeparatorFile" },
+            /* PRINT_PROCESSOR      */  gcnew array<String^> { L"QueuePrintProcessorName" },
+            /* PARAMETERS           */  nullptr,
+            /* DATATYPE             */  nullptr,
+            /* SECURITY_DESCRIPTOR  */  nullptr,
+            /* ATTRIBUTES           */  gcnew array<String^> { L"Attributes" },
+            /* PRIORITY             */  gcnew array<String^> { L"Priority" },
+            /* DEFAULT_PRIORITY     */  gcnew array<String^> { L"DefaultPriority" },
+            /* START_TIME           */  gcnew array<String^> { L"StartTimeOfDay" },
+            /* UNTIL_TIME           */  gcnew array<String^> { L"UntilTimeOfDay" },
+            /* STATUS               */  gcnew array<String^> { L"Status" },
+            /* STATUS_STRING        */  nullptr,
+            /* CJOBS                */  gcnew array<String^> { L"NumberOfJobs" },
+            /* AVERAGE_PPM          */  gcnew array<String^> { L"AveragePagesPerMinute" }
+        };
+
+        PrintQueue^                                             queue;
+        MS::Internal::PrintWin32Thunk::PrinterThunkHandler^     printerThunkHandler;    // AddRef'd while changeHandle is open
+        System::Windows::Threading::Dispatcher^                 queueDispatcher;
+        IntPtr                                                  changeHandle;
+        ChangeWaitHandle^                                       waitHandle;
+        WaitGroup^                                              waitGroup;
+
+        // Guarded by syncRoot
+        Object^                                                 syncRoot;
+        System::Collections::Generic::Dictionary<String^, bool>^ changedProperties;
+        bool                                                    changesLost;
+        bool                                                    applyPosted;
+        bool                                                    isClosed;
+    };
+
 
 }
 }
@@ -476,6 +476,22 @@ namespace Printing
             array<EnumeratedPrintQueueTypes>^    enumerationFlag
             );
 
+        /// <summary>
+        /// Refreshes a set of <c>PrintQueue</c> objects hosted on this print server.
+        /// </summary>
+        /// <param name="printQueues">The <c>PrintQueue</c> objects to be refreshed.</param>
+        /// <remarks>
+        /// The queues are refreshed from a single enumeration of the local and connected queues on the server,
+        /// covering only the properties the queues refresh, instead of one call to the server per queue.
+        /// Queues that are not found in the enumeration are refreshed by calling <c>Refresh</c> on them.
+        /// </remarks>
+        /// <exception cref="PrintServerException">Thrown if the enumeration fails.</exception>
+        /// <exception cref="PrintQueueException">Thrown if refreshing a queue that was not enumerated fails.</exception>
+        void
+        RefreshPrintQueues(
+            System::Collections::Generic::IEnumerable<PrintQueue^>^  printQueues
+            );
+
         /// <summary>
         /// Commits the properties marked as modified to the Print Spooler service.
         /// </summary>
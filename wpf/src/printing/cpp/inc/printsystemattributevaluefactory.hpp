@@ -179,10 +179,19 @@ namespace Activation
         Object^                             syncRoot; 
 
         bool                                isDisposed;
-        Hashtable^                          valueDelegatesTable;
-        Hashtable^                          noValueDelegatesTable;
-        Hashtable^                          valueLinkedDelegatesTable;
-        Hashtable^                          noValueLinkedDelegatesTable;
+
+        //
+        // The tables are keyed by the Type itself rather than its FullName,
+        // so a lookup neither hashes the name string nor casts the delegate
+        //
+        System::Collections::Generic::
+        Dictionary<Type^, PrintProperty::CreateWithValue^>^            valueDelegatesTable;
+        System::Collections::Generic::
+        Dictionary<Type^, PrintProperty::CreateWithNoValue^>^          noValueDelegatesTable;
+        System::Collections::Generic::
+        Dictionary<Type^, PrintProperty::CreateWithValueLinked^>^      valueLinkedDelegatesTable;
+        System::Collections::Generic::
+        Dictionary<Type^, PrintProperty::CreateWithNoValueLinked^>^    noValueLinkedDelegatesTable;
     };
 
 }
@@ -762,13 +762,17 @@ namespace Printing
 
         static Hashtable^ upLevelToDownLevelMapping;
 
-        Hashtable^                              collectionsTable;
+        static
+        System::Collections::Generic::
+        Dictionary<String^, Boolean>^           thunkedAttributeNames;
         PrintPropertyDictionary^                thunkPropertiesCollection;
 
         array<String^>^                         refreshPropertiesFilter;
         Boolean                                 reportProgress;
     };
 
+    ref class PrintJobInfoCollectionEnumerator;
+
     public ref class PrintJobInfoCollection :
     public PrintSystemObjects,
     public System::Collections::Generic::IEnumerable<PrintSystemJobInfo^>,
@@ -803,6 +807,14 @@ namespace Printing
             PrintSystemJobInfo^ printObject
             );
 
+        internal:
+
+        Boolean
+        TryGetJob(
+            Int32                   index,
+            PrintSystemJobInfo^%    jobInfo
+            );
+
         private:
 
         PrintJobInfoCollection(
@@ -816,14 +828,76 @@ namespace Printing
             void
             );
 
+        void
+        EnumerateNextPage(
+            void
+            );
 
+        //
+        // Jobs are enumerated from the spooler in pages of this many jobs,
+        // as the collection is walked, instead of all at construction time
+        //
+        static
+        const
+        UInt32                               jobsPerPage = 256;
 
         System::Collections::Generic::
-        Queue<PrintSystemJobInfo^>^          jobInfoCollection;
+        List<PrintSystemJobInfo^>^           jobInfoCollection;
+        System::Collections::Generic::
+        List<PrintSystemJobInfo^>^           addedJobInfoCollection;
         PrintQueue^                          hostingPrintQueue;
+        array<String^>^                      jobPropertiesFilter;
+        UInt32                               nextJobIndex;
+        Boolean                              isEnumerationComplete;
         PrintSystemDispatcherObject^    accessVerifier;
 
     };
+
+    private ref class PrintJobInfoCollectionEnumerator :
+    public System::Collections::Generic::IEnumerator<PrintSystemJobInfo^>
+    {
+        public:
+
+        PrintJobInfoCollectionEnumerator(
+            PrintJobInfoCollection^ collection
+            );
+
+        ~PrintJobInfoCollectionEnumerator(
+            void
+            );
+
+        virtual
+        Boolean
+        MoveNext(
+            void
+            );
+
+        virtual
+        void
+        Reset(
+            void
+            );
+
+        property
+        PrintSystemJobInfo^
+        Current
+        {
+            virtual PrintSystemJobInfo^ get();
+        }
+
+        property
+        Object^
+        NonGenericCurrent
+        {
+            virtual Object^ get() = System::Collections::IEnumerator::Current::get;
+        }
+
+        private:
+
+        PrintJobInfoCollection^             jobInfoCollection;
+        Int32                               index;
+        PrintSystemJobInfo^                 currentJobInfo;
+    };
 }
 }
 
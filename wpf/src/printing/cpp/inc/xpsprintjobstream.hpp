@@ -153,9 +153,60 @@ namespace PrintWin32Thunk
         SetLength (
             Int64 value
         ) override;
+
+        /// <Summary>
+        /// Size of the buffers writes are accumulated in before they are handed
+        /// to the background writer; 0 writes synchronously on the caller's thread.
+        /// Applies to streams created afterwards.
+        /// </Summary>
+        static
+        property
+        Int32
+        WriteBufferSize
+        {
+            Int32 get();
+            void set(Int32 value);
+        }
         
         private:
 
+        /// <Summary>
+        /// Hands the filled buffer to the background writer, once the previous
+        /// buffer is written, and swaps in the other buffer to keep filling
+        /// </Summary>
+        void
+        QueueFillBuffer (
+            void
+        );
+
+        /// <Summary>
+        /// Waits for the buffer in flight and rethrows the error it failed with, if any
+        /// </Summary>
+        void
+        WaitForPendingWrite (
+            void
+        );
+
+        /// <SecurityNote>
+        /// Critical - Calls critical WriteToInner
+        /// </SecurityNote>
+        [SecurityCritical]
+        void
+        WritePendingBuffer (
+            Object^ state
+        );
+
+        /// <SecurityNote>
+        /// Critical - Calls native method to write untrusted data to printer device
+        /// </SecurityNote>
+        [SecurityCritical]
+        void
+        WriteToInner (
+            array<Byte> ^ buffer,
+            Int32 offset,
+            Int32 count
+        );
+
         /// <Summary>
         /// Wrapper around WaitForSingleObjectEx that hides away its various return codes
         /// </Summary>
@@ -192,6 +243,20 @@ namespace PrintWin32Thunk
         Boolean canRead;
         Boolean canWrite;
         Int64 position;
+
+        //
+        // Double buffering: the serializer fills one buffer while the
+        // background writer sends the other one to the spooler
+        //
+        array<Byte>^ fillBuffer;
+        Int32 fillCount;
+        array<Byte>^ pendingBuffer;
+        Int32 pendingCount;
+        Boolean writeInFlight;
+        Exception^ writeException;
+        Object^ writeLock;
+
+        static Int32 writeBufferSize = 1024 * 1024;
     };
 }
 }
@@ -275,6 +275,130 @@ GetPrintSystemValuesPerPrintQueues(
 
 }
 
+/*++
+
+Routine Name:
+
+    RefreshPrintSystemValuesPerPrintQueues
+
+Routine Description:
+
+    Refreshes existing PrintQueue objects from a single enumeration of the
+    queues on the server, instead of one GetPrinter call per queue. Only the
+    levels covering the propertyFilter are enumerated. Each enumerated queue
+    is matched by name and only the properties in its own refresh filter are
+    updated. Queues that were refreshed are removed from printQueuesByName.
+
+Arguments:
+
+    printServer         - the server hosting the queues
+    flags               - the types of queues to be enumerated
+    printQueuesByName   - the queues to be refreshed, keyed by queue name
+    propertyFilter      - the union of the refresh filters of the queues
+
+Return Value:
+
+    void
+
+--*/
+void
+EnumDataThunkObject::
+RefreshPrintSystemValuesPerPrintQueues(
+    PrintServer^                        printServer,
+    array<EnumeratedPrintQueueTypes>^   flags,
+    System::
+    Collections::
+    Generic::
+    Dictionary<String^, PrintQueue^>^   printQueuesByName,
+    array<String^>^                     propertyFilter
+    )
+{
+    InfoLevelMask           attributesMask = InfoLevelMask::NoLevel;
+    InfoLevelCoverageList^  coverageList   = nullptr;
+
+    try
+    {
+        attributesMask = TypeToLevelMap::GetCoverageMaskForPropertiesFilter(printingType,
+                                                                            TypeToLevelMap::OperationType::Enumeration,
+                                                                            propertyFilter);
+
+        if (attributesMask != InfoLevelMask::NoLevel)
+        {
+            MapEnumeratePrinterQueuesFlags(flags);
+
+            try
+            {
+                coverageList = BuildCoverageListAndEnumerateData(printServer->Name,
+                                                                 win32EnumerationFlags,
+                                                                 attributesMask);
+            }
+            catch (InternalPrintSystemException^)
+            {
+                win32EnumerationFlags |= PRINTER_ENUM_NAME;
+
+                coverageList = BuildCoverageListAndEnumerateData(printServer->Name,
+                                                                 win32EnumerationFlags,
+                                                                 attributesMask);
+            }
+
+            Hashtable^   attributeMap = TypeToLevelMap::GetAttributeMapPerType(printingType,
+                                                                               TypeToLevelMap::OperationType::Enumeration);
+
+            if (coverageList)
+            {
+                InfoAttributeData^  nameData       = (InfoAttributeData^)attributeMap["Name"];
+                InfoLevelThunk^     nameLevelThunk = (InfoLevelThunk^)coverageList->
+                                                                      GetInfoLevelThunk((UInt64)nameData->mask);
+
+                for(UInt32 objectIndex = 0;
+                    nameLevelThunk && objectIndex < coverageList->Count;
+                    objectIndex++)
+                {
+                    String^     queueName  = (String^)nameLevelThunk->GetValueFromInfoData("Name", objectIndex);
+                    PrintQueue^ printQueue = nullptr;
+
+                    if (!queueName ||
+                        !printQueuesByName->TryGetValue(queueName, printQueue))
+                    {
+                        continue;
+                    }
+
+                    array<String^>^ queuePropertyFilter = printQueue->RefreshPropertiesFilter;
+
+                    for(Int32 propertyIndex = 0; propertyIndex < queuePropertyFilter->Length; propertyIndex++)
+                    {
+                        String^             valueName       = queuePropertyFilter[propertyIndex];
+                        InfoAttributeData^  infoData        = (InfoAttributeData^)attributeMap[valueName];
+                        InfoLevelThunk^     infoLevelThunk  = (InfoLevelThunk^)coverageList->
+                                                                               GetInfoLevelThunk((UInt64)infoData->mask);
+
+                        PrintProperty^      attributeValue  = printQueue->get_InternalPropertiesCollection(valueName)->
+                                                              GetProperty(valueName);
+
+                        attributeValue->IsInternallyInitialized = true;
+
+                        if (infoLevelThunk)
+                        {
+                            attributeValue->Value = infoLevelThunk->GetValueFromInfoData(valueName, objectIndex);
+                        }
+
+                        attributeValue->IsInternallyInitialized = false;
+                    }
+
+                    printQueuesByName->Remove(queueName);
+                }
+            }
+        }
+    }
+    __finally
+    {
+        if (coverageList)
+        {
+            coverageList->Release();
+        }
+    }
+}
+
 void
 EnumDataThunkObject::
 GetPrintSystemValuesPerPrintJobs(
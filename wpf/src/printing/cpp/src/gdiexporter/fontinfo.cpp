@@ -15,6 +15,132 @@
 *
 **************************************************************************/
 
+// FontIdentityIndex
+array<Byte>^ FontIdentityIndex::GetChecksum(String^ path)
+{
+    FileIOPermission^ fileIOPermission = gcnew FileIOPermission(FileIOPermissionAccess::Read, path);
+    fileIOPermission->Assert(); // BlessedAssert
+
+    try
+    {
+        FileInfo^ file = gcnew FileInfo(path);
+
+        if (! file->Exists)
+        {
+            return nullptr;
+        }
+
+        Int64    length        = file->Length;
+        DateTime lastWriteTime = file->LastWriteTimeUtc;
+
+        Identity identity;
+
+        System::Threading::Monitor::Enter(s_identities);
+
+        try
+        {
+            if (s_identities->TryGetValue(path, identity) &&
+                (identity.length == length) && (identity.lastWriteTime == lastWriteTime))
+            {
+                return identity.checksum;
+            }
+        }
+        finally
+        {
+            System::Threading::Monitor::Exit(s_identities);
+        }
+
+        // Read the file outside the lock; racing readers compute the same checksum.
+        Stream^ stream = File::OpenRead(path);
+
+        try
+        {
+            identity.checksum = ComputeChecksum(stream);
+        }
+        finally
+        {
+            stream->Close();
+        }
+
+        identity.length        = length;
+        identity.lastWriteTime = lastWriteTime;
+
+        System::Threading::Monitor::Enter(s_identities);
+
+        try
+        {
+            s_identities[path] = identity;
+        }
+        finally
+        {
+            System::Threading::Monitor::Exit(s_identities);
+        }
+
+        return identity.checksum;
+    }
+    catch (IOException^)
+    {
+        return nullptr;
+    }
+    catch (UnauthorizedAccessException^)
+    {
+        return nullptr;
+    }
+    finally
+    {
+        fileIOPermission->RevertAssert();
+    }
+}
+
+array<Byte>^ FontIdentityIndex::ComputeChecksum(Stream^ stream)
+{
+    Debug::Assert(stream != nullptr);
+
+    // SHA1CryptoServiceProvider rather than SHA1Managed, which isn't allowed when FIPS policy is enforced
+    System::Security::Cryptography::SHA1CryptoServiceProvider^ sha1 = gcnew System::Security::Cryptography::SHA1CryptoServiceProvider();
+
+    try
+    {
+        return sha1->ComputeHash(stream);
+    }
+    finally
+    {
+        sha1->Clear();
+    }
+}
+
+void FontIdentityIndex::Clear()
+{
+    System::Threading::Monitor::Enter(s_identities);
+
+    try
+    {
+        s_identities->Clear();
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(s_identities);
+    }
+}
+
+bool FontIdentityIndex::ChecksumEquals(array<Byte>^ a, array<Byte>^ b)
+{
+    if (a->Length != b->Length)
+    {
+        return false;
+    }
+
+    for (int index = 0; index < a->Length; index++)
+    {
+        if (a[index] != b[index])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 // FontStreamContext
 FontStreamContext::FontStreamContext(GlyphTypeface^ source)
 {
@@ -139,6 +265,36 @@ void FontStreamContext::UpdateStreamLength()
     }
 }
 
+array<Byte>^ FontStreamContext::GetChecksum()
+{
+    if (_checksum == nullptr)
+    {
+        Uri^ fileUri = _sourceUri;
+
+        if (fileUri == nullptr && _sourceTypeface != nullptr)
+        {
+            fileUri = Microsoft::Internal::AlphaFlattener::Utility::GetFontUri(_sourceTypeface);
+        }
+
+        if (fileUri != nullptr && fileUri->IsFile)
+        {
+            _checksum = FontIdentityIndex::GetChecksum(fileUri->LocalPath);
+        }
+
+        if (_checksum == nullptr)
+        {
+            Stream^ stream = GetStream();
+
+            if (stream != nullptr)
+            {
+                _checksum = FontIdentityIndex::ComputeChecksum(stream);
+            }
+        }
+    }
+
+    return _checksum;
+}
+
 bool FontStreamContext::Equals(FontStreamContext% otherContext)
 {
     // make sure stream lengths are valid for comparison
@@ -151,6 +307,19 @@ bool FontStreamContext::Equals(FontStreamContext% otherContext)
         return false;
     }
 
+    // Then compare checksums, cached per file across print jobs
+    array<Byte>^ thisChecksum = GetChecksum();
+
+    if (thisChecksum != nullptr)
+    {
+        array<Byte>^ otherChecksum = otherContext.GetChecksum();
+
+        if (otherChecksum != nullptr)
+        {
+            return FontIdentityIndex::ChecksumEquals(thisChecksum, otherChecksum);
+        }
+    }
+
     // otherwise compare first CompareLength bytes of both streams
     Stream^ thisStream = GetStream();
 
@@ -800,6 +969,8 @@ Object^ FontInstallInfo::Install(FontStreamContext% context, String^ % newFamily
         context.UpdateStreamLength();
         int size = context.StreamLength;
 
+        EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXConvertFontBegin, size);
+
         if (size > 0 && size < FontStreamContext::MaximumStreamLength)
         {
             Stream^ stream = context.GetStream();
@@ -821,12 +992,150 @@ Object^ FontInstallInfo::Install(FontStreamContext% context, String^ % newFamily
                 }
             }
         }
+
+        EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXConvertFontEnd, installHandle != nullptr);
     }
 
     return installHandle;
 }
 
 
+// Builds the subset cache key: font identity (length and a hash of the leading bytes), face and sorted glyphs.
+String^ GetSubsetKey(Stream^ stream, int streamLength, unsigned faceIndex, ICollection<unsigned short>^ glyphs)
+{
+    array<Byte>^ head = gcnew array<Byte>(Math::Min(streamLength, c_FontBufferSize));
+
+    int read = 0;
+
+    while (read < head->Length)
+    {
+        int count = stream->Read(head, read, head->Length - read);
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        read += count;
+    }
+
+    unsigned hash = 2166136261u;
+
+    for (int i = 0; i < read; i ++)
+    {
+        hash = (hash ^ head[i]) * 16777619;
+    }
+
+    List<unsigned short>^ sorted = gcnew List<unsigned short>(glyphs);
+    sorted->Sort();
+
+    System::Text::StringBuilder^ key = gcnew System::Text::StringBuilder();
+
+    key->AppendFormat("{0:x}.{1:x}.{2}:", streamLength, hash, faceIndex);
+
+    for each (unsigned short glyph in sorted)
+    {
+        key->Append(glyph.ToString("x"));
+        key->Append(',');
+    }
+
+    return key->ToString();
+}
+
+
+Object^ FontInstallInfo::InstallSubset(FontStreamContext% context, String^ % newFamilyName, GlyphTypeface^ typeface, ICollection<unsigned short>^ glyphs)
+{
+    Debug::Assert(typeface != nullptr);
+    Debug::Assert(glyphs != nullptr && glyphs->Count > 0);
+
+    UpdateFromContext(context);
+
+    context.UpdateStreamLength();
+    int size = context.StreamLength;
+
+    if (size < SubsetMinimumStreamLength || size >= FontStreamContext::MaximumStreamLength)
+    {
+        return nullptr;
+    }
+
+    Stream^ stream = context.GetStream();
+
+    if (stream == nullptr)
+    {
+        return nullptr;
+    }
+
+    String^ key = GetSubsetKey(stream, size, typeface->FaceIndex, glyphs);
+
+    array<Byte>^ subset = dynamic_cast<array<Byte>^>(s_subsetCache[key]);
+
+    if (subset == nullptr)
+    {
+        // GlyphTypeface::ComputeSubset demands UnmanagedCode and read access to the font location
+        PermissionSet^ permissions = gcnew PermissionSet(PermissionState::None);
+
+        permissions->AddPermission(gcnew SecurityPermission(SecurityPermissionFlag::UnmanagedCode));
+
+        CodeAccessPermission^ fontReadPermission = typeface->CriticalFileReadPermission;
+
+        if (fontReadPermission != nullptr)
+        {
+            permissions->AddPermission(fontReadPermission);
+        }
+
+        permissions->Assert(); // BlessedAssert
+
+        try
+        {
+            subset = typeface->ComputeSubset(glyphs);
+        }
+        catch (FileFormatException^)
+        {
+            // subsetter can't handle this font; install it whole
+        }
+        catch (ArgumentException^)
+        {
+        }
+        finally
+        {
+            CodeAccessPermission::RevertAssert();
+        }
+
+        if (subset == nullptr || subset->Length == 0)
+        {
+            return nullptr;
+        }
+
+        if (subset->Length <= SubsetCacheBudget / 4)
+        {
+            while (s_subsetCacheBytes + subset->Length > SubsetCacheBudget && s_subsetCacheOrder->Count != 0)
+            {
+                Object^ oldest = s_subsetCacheOrder->Dequeue();
+
+                s_subsetCacheBytes -= safe_cast<array<Byte>^>(s_subsetCache[oldest])->Length;
+                s_subsetCache->Remove(oldest);
+            }
+
+            s_subsetCache[key] = subset;
+            s_subsetCacheOrder->Enqueue(key);
+            s_subsetCacheBytes += subset->Length;
+        }
+    }
+
+    // ReplaceFontName rewrites the name table in place; keep the cached copy pristine
+    array<Byte>^ data = safe_cast<array<Byte>^>(subset->Clone());
+
+    // The subset is a standalone font, even when taken from a collection
+    TrueTypeFont font(data, 0);
+
+    newFamilyName = font.ReplaceFontName();
+
+    DWORD nFonts = 0;
+
+    return CNativeMethods::AddFontMemResourceEx(data, data->Length, NULL, &nFonts);
+}
+
+
 void FontInstallInfo::Uninstall(Object^ installHandle)
 {
     Debug::Assert(installHandle != nullptr);
@@ -868,6 +1177,11 @@ FontInfo::FontInfo()
 {
 }
 
+void FontInfo::SetSystemInstall(FontInfo^ current)
+{
+    _systemInstall = (current != nullptr) ? current->_systemInstall : nullptr;
+}
+
 FontInfo::FontInfo(Uri^ systemUri)
 {
     Debug::Assert(systemUri != nullptr, "System font URI can't be null");
@@ -875,7 +1189,7 @@ FontInfo::FontInfo(Uri^ systemUri)
     _systemInstall = gcnew FontInstallInfo(systemUri);
 }
 
-bool FontInfo::UsePrivate(GlyphTypeface^ typeface)
+bool FontInfo::UsePrivate(GlyphTypeface^ typeface, ICollection<unsigned short>^ glyphs)
 {
     //
     // Prepare GDI to render text using GlyphTypeface. First see if GlyphTypeface is already
@@ -890,18 +1204,43 @@ bool FontInfo::UsePrivate(GlyphTypeface^ typeface)
     {
         FontInstallInfo^ install = gcnew FontInstallInfo(Microsoft::Internal::AlphaFlattener::Utility::GetFontUri(typeface));
 
+        // Glyphs of the same font installed so far, when growing a subset
+        Dictionary<unsigned short, bool>^ subsetGlyphs = nullptr;
+        int subsetInstalls = 0;
+
         if (_privateInstall != nullptr)
         {
             // We have a private font installed with this name. If requested typeface
             // matches this private font, use it, otherwise uninstall it.
             if (install->Equals(installContext, _privateInstall))
             {
-                return true;
-            }
-            else
-            {
-                UninstallPrivate();
+                if (_installedGlyphs == nullptr || glyphs == nullptr)
+                {
+                    return true;
+                }
+
+                bool missing = false;
+
+                for each (unsigned short glyph in glyphs)
+                {
+                    if (!_installedGlyphs->ContainsKey(glyph))
+                    {
+                        missing = true;
+                        break;
+                    }
+                }
+
+                if (!missing)
+                {
+                    return true;
+                }
+
+                // Installed subset lacks some of the glyphs; reinstall a larger subset
+                subsetGlyphs   = _installedGlyphs;
+                subsetInstalls = _subsetInstalls;
             }
+
+            UninstallPrivate();
         }
 
         Debug::Assert(_privateInstall == nullptr, "Private font should not be installed at this point");
@@ -912,8 +1251,35 @@ bool FontInfo::UsePrivate(GlyphTypeface^ typeface)
             return true;
         }
 
-        // Otherwise we need to install a new private font.
-        _privateInstallHandle = install->Install(installContext, _newFamilyName, typeface->FaceIndex);
+        // Otherwise we need to install a new private font. Install just the glyphs used so far
+        // when we can, so large (e.g. CJK) fonts aren't copied and spooled whole.
+        if (glyphs != nullptr && glyphs->Count > 0 && subsetInstalls < MaximumSubsetInstalls)
+        {
+            if (subsetGlyphs == nullptr)
+            {
+                subsetGlyphs = gcnew Dictionary<unsigned short, bool>();
+
+                subsetGlyphs[0] = true; // .notdef
+            }
+
+            for each (unsigned short glyph in glyphs)
+            {
+                subsetGlyphs[glyph] = true;
+            }
+
+            _privateInstallHandle = install->InstallSubset(installContext, _newFamilyName, typeface, subsetGlyphs->Keys);
+
+            if (_privateInstallHandle != nullptr)
+            {
+                _installedGlyphs = subsetGlyphs;
+                _subsetInstalls  = subsetInstalls + 1;
+            }
+        }
+
+        if (_privateInstallHandle == nullptr)
+        {
+            _privateInstallHandle = install->Install(installContext, _newFamilyName, typeface->FaceIndex);
+        }
 
         if (_privateInstallHandle == nullptr)
         {
@@ -942,5 +1308,7 @@ void FontInfo::UninstallPrivate()
         _privateInstall = nullptr;
         _privateInstallHandle = nullptr;
         _newFamilyName = nullptr;
+        _installedGlyphs = nullptr;
+        _subsetInstalls = 0;
     }
 }
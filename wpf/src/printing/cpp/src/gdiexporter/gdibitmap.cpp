@@ -1,3 +1,7 @@
+// Open addressing hash of the colors in ColorTable, 4x the palette size to keep probe chains short
+const int      PaletteHashSize  = 1024;             // power of 2
+const COLORREF PaletteHashEmpty = 0xFFFFFFFF;       // not a valid RGB() value
+
 ref class PaletteSorter
 {
 public:
@@ -6,13 +10,51 @@ public:
         Size      = 256;
     //  IndexUsed = 0;
         ColorTable = gcnew array<COLORREF>(Size);
+
+        HashColor = gcnew array<COLORREF>(PaletteHashSize);
+        HashIndex = gcnew array<Byte>(PaletteHashSize);
+
+        for (int i = 0; i < PaletteHashSize; i ++)
+        {
+            HashColor[i] = PaletteHashEmpty;
+        }
+
+        LastColor = PaletteHashEmpty;
     }
 
     bool AddColor(COLORREF color);
     
     int Find(COLORREF color)
     {
-        int slot = Search(0, IndexUsed - 1, color);
+        // Runs of identical pixels are the common case in rasterized content
+        if (IndexBuilt && (color == LastColor))
+        {
+            return LastIndex;
+        }
+
+        int slot;
+
+        if (IndexBuilt)
+        {
+            int h = HashSlot(color);
+
+            slot = IndexUsed;
+
+            while (HashColor[h] != PaletteHashEmpty)
+            {
+                if (HashColor[h] == color)
+                {
+                    slot = HashIndex[h];
+                    break;
+                }
+
+                h = (h + 1) & (PaletteHashSize - 1);
+            }
+        }
+        else
+        {
+            slot = Search(0, IndexUsed - 1, color);
+        }
 
         if (slot >= IndexUsed)
         {
@@ -20,17 +62,39 @@ public:
         }
         else
         {
+            if (IndexBuilt)
+            {
+                LastColor = color;
+                LastIndex = slot;
+            }
+
             return slot;
         }
     }
 
+    // Records each color's final position in the sorted ColorTable, so Find becomes a hash lookup.
+    // Call once all colors have been added.
+    void BuildIndex();
+
     bool ProcessScanline(array<BYTE>^ scan, int offset, int width, int pixelsize);
 
 protected:
     int  Search(int start, int end, COLORREF color);
 
+    static int HashSlot(COLORREF color)
+    {
+        return (int) ((color * 2654435761u) >> 22);  // top 10 bits, PaletteHashSize
+    }
+
     int      Size;
 
+    array<COLORREF> ^HashColor;     // PaletteHashEmpty or a color in ColorTable
+    array<Byte>     ^HashIndex;     // index of HashColor[i] in ColorTable, valid once IndexBuilt
+    bool             IndexBuilt;
+
+    COLORREF LastColor;
+    int      LastIndex;
+
 public:
     array<COLORREF> ^ColorTable;
     int      IndexUsed;
@@ -40,6 +104,27 @@ public:
 // Return false if palette is more than 256 colors
 bool PaletteSorter::AddColor(COLORREF color)
 {
+    Debug::Assert(!IndexBuilt);
+
+    if (color == LastColor)
+    {
+        return true;
+    }
+
+    // Colors already in the table only need the hash probe
+    int h = HashSlot(color);
+
+    while (HashColor[h] != PaletteHashEmpty)
+    {
+        if (HashColor[h] == color)
+        {
+            LastColor = color;
+            return true;
+        }
+
+        h = (h + 1) & (PaletteHashSize - 1);
+    }
+
     int slot = Search(0, IndexUsed - 1, color);
 
     if (slot >= Size)
@@ -59,13 +144,36 @@ bool PaletteSorter::AddColor(COLORREF color)
             ColorTable[slot] = color;
     
             IndexUsed ++;
+
+            HashColor[h] = color;
         }
 
+        LastColor = color;
+
         return true;
     }
 }
 
 
+void PaletteSorter::BuildIndex()
+{
+    for (int i = 0; i < IndexUsed; i ++)
+    {
+        int h = HashSlot(ColorTable[i]);
+
+        while (HashColor[h] != ColorTable[i])
+        {
+            h = (h + 1) & (PaletteHashSize - 1);
+        }
+
+        HashIndex[h] = (Byte) i;
+    }
+
+    IndexBuilt = true;
+    LastColor  = PaletteHashEmpty;
+}
+
+
 // Binary search using COLORREF
 int PaletteSorter::Search(int start, int end, COLORREF color)
 {
@@ -254,6 +362,8 @@ HRESULT CGDIBitmap::ColorReduction()
     Debug::Assert(m_pSorter != nullptr);
     Debug::Assert(m_pSorter->IndexUsed <= 256);
 
+    m_pSorter->BuildIndex();
+
     int bpp = 8;
     
     if (m_pSorter->IndexUsed <= 2)
@@ -684,11 +794,21 @@ HRESULT CGDIBitmap::Load(BitmapSource ^ pBitmap, array<Byte>^ buffer, PixelForma
 {
     Debug::Assert(pBitmap != nullptr);
 
+    return LoadBand(pBitmap, buffer, LoadFormat, 0, (int) pBitmap->PixelHeight);
+}
+
+
+HRESULT CGDIBitmap::LoadBand(BitmapSource ^ pBitmap, array<Byte>^ buffer, PixelFormat LoadFormat, int firstRow, int rowCount)
+{
+    Debug::Assert(pBitmap != nullptr);
+    Debug::Assert((firstRow >= 0) && (rowCount > 0) && (firstRow + rowCount <= pBitmap->PixelHeight));
+    Debug::Assert((buffer == nullptr) || ((firstRow == 0) && (rowCount == pBitmap->PixelHeight)));
+
     m_pBitmap     = pBitmap;
 
     // don't use ImageSource.Width or Height, since they're in measure units. we want pixels
     m_Width       = (int) pBitmap->PixelWidth;
-    m_Height      = (int) pBitmap->PixelHeight;
+    m_Height      = rowCount;
     m_PixelFormat = LoadFormat;
     m_Stride      = GetDIBStride(m_Width, m_PixelFormat.BitsPerPixel);
     m_Offset      = 0;
@@ -721,7 +841,7 @@ HRESULT CGDIBitmap::Load(BitmapSource ^ pBitmap, array<Byte>^ buffer, PixelForma
             source = converter;
         }
         
-        Int32Rect rect(0, 0, m_Width, 1); // Single scanline
+        Int32Rect rect(0, firstRow, m_Width, 1); // Single scanline
     
         // copy to top-down buffer
         for (int y = 0; y < m_Height; y ++)
@@ -25,7 +25,7 @@ GdiSafeHandle^ CGDIDevice::ConvertBrush(COLORREF colorRef)
         return m_blackBrush;
     }
                 
-    GdiSafeHandle^ brush = CacheMatch((interior_ptr<Byte>) & colorRef, sizeof(colorRef));
+    GdiSafeHandle^ brush = CacheMatch((interior_ptr<Byte>) & colorRef, sizeof(colorRef), OBJ_BRUSH);
 
     if (brush == nullptr)
     {
@@ -33,7 +33,7 @@ GdiSafeHandle^ CGDIDevice::ConvertBrush(COLORREF colorRef)
 
         if (brush != nullptr)
         {
-            CacheObject((interior_ptr<Byte>) & colorRef, sizeof(colorRef), brush);
+            CacheObject((interior_ptr<Byte>) & colorRef, sizeof(colorRef), OBJ_BRUSH, brush);
         }
         else
         {
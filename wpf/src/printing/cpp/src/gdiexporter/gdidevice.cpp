@@ -378,6 +378,71 @@ void CGDIDevice::ResetStates(void)
 }
 
 
+// SaveDC, remembering the cached DC state so that RestoreDCState can put it back
+BOOL CGDIDevice::SaveDCState(void)
+{
+    int errCode = CNativeMethods::SaveDC(m_hDC);    // ROBERTAN
+
+    if (errCode == 0)
+    {
+        return FALSE;
+    }
+
+    SavedDCState ^ saved = gcnew SavedDCState();
+
+    saved->m_font         = m_lastFont;
+    saved->m_pen          = m_lastPen;
+    saved->m_brush        = m_lastBrush;
+    saved->m_textColor    = m_lastTextColor;
+    saved->m_polyFillMode = m_lastPolyFillMode;
+    saved->m_textAlign    = m_lastTextAlign;
+    saved->m_miterLimit   = m_lastMiterLimit;
+
+    if (m_savedStates == nullptr)
+    {
+        m_savedStates = gcnew System::Collections::Stack();
+    }
+
+    m_savedStates->Push(saved);
+
+    return TRUE;
+}
+
+
+// RestoreDC(-1) for the last SaveDCState. The DC returns to the objects and modes it had
+// at that SaveDC, so the cached values are taken from the same snapshot; objects selected
+// since then no longer need to be selected again after every pop.
+BOOL CGDIDevice::RestoreDCState(void)
+{
+    BOOL restored = CNativeMethods::RestoreDC(m_hDC, -1);     // ROBERTAN
+
+    SavedDCState ^ saved = nullptr;
+
+    if ((m_savedStates != nullptr) && (m_savedStates->Count > 0))
+    {
+        saved = (SavedDCState ^) m_savedStates->Pop();
+    }
+
+    if (!restored || (saved == nullptr))
+    {
+        // DC state unknown
+        ResetStates();
+    }
+    else
+    {
+        m_lastFont         = saved->m_font;
+        m_lastPen          = saved->m_pen;
+        m_lastBrush        = saved->m_brush;
+        m_lastTextColor    = saved->m_textColor;
+        m_lastPolyFillMode = saved->m_polyFillMode;
+        m_lastTextAlign    = saved->m_textAlign;
+        m_lastMiterLimit   = saved->m_miterLimit;
+    }
+
+    return restored;
+}
+
+
 HRESULT CGDIDevice::HrStartPage(array<Byte>^ devmode)
 {
     if (devmode != nullptr)
@@ -409,6 +474,11 @@ HRESULT CGDIDevice::HrStartPage(array<Byte>^ devmode)
         }
 
         ResetStates();
+
+        if (m_savedStates != nullptr)
+        {
+            m_savedStates->Clear();
+        }
     }
 
     return hr;
@@ -456,23 +526,7 @@ HRESULT CGDIDevice::HrEndPage(void)
     m_lastBrush = nullptr;
     m_lastPen   = nullptr;
 
-    if (m_Cache != nullptr)
-    {
-        for (int i = 0; i < m_Cache->Length; i ++)
-        {
-            if (m_Cache[i] != nullptr)
-            {
-                GdiSafeHandle ^old = m_Cache[i]->Handle;
-
-                if(old != nullptr && !old->IsInvalid) 
-                {
-                    old->Close();
-                }
-
-                m_Cache[i] = nullptr;
-            }
-        }
-    }
+    CacheFlush();
 
     return hr;
 }
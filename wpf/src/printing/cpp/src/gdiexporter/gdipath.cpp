@@ -1,6 +1,69 @@
 #define PT_TYPEMASK    (PT_MOVETO | PT_LINETO | PT_BEZIERTO) 
 #define PT_INVALID    ~(PT_TYPEMASK | PT_CLOSEFIGURE)
 
+/**************************************************************************\
+*
+* Class Description:
+*   Per-thread scratch point/type buffers for GdiGeometryConverter.
+*
+*   Large vector drawings convert path after path, each needing arrays
+*   sized to the geometry's point count, many of them large object heap
+*   allocations. A CGDIPath returns its buffers here when deleted, and the
+*   next conversion on the thread reuses them if they're big enough. Paths
+*   alive at the same time (stroke falling back to fill) simply allocate.
+*
+\**************************************************************************/
+ref class GdiPathBuffers abstract sealed
+{
+public:
+    static array<PointI>^ AcquirePoints(int capacity)
+    {
+        array<PointI>^ points = s_points;
+
+        if (points != nullptr && points->Length >= capacity)
+        {
+            s_points = nullptr;
+            return points;
+        }
+
+        return gcnew array<PointI>(capacity);
+    }
+
+    static array<Byte>^ AcquireTypes(int capacity)
+    {
+        array<Byte>^ types = s_types;
+
+        if (types != nullptr && types->Length >= capacity)
+        {
+            s_types = nullptr;
+            return types;
+        }
+
+        return gcnew array<Byte>(capacity);
+    }
+
+    // Keeps the larger of the returned and currently held buffers.
+    static void Release(array<PointI>^ points, array<Byte>^ types)
+    {
+        if (points != nullptr && (s_points == nullptr || s_points->Length < points->Length))
+        {
+            s_points = points;
+        }
+
+        if (types != nullptr && (s_types == nullptr || s_types->Length < types->Length))
+        {
+            s_types = types;
+        }
+    }
+
+private:
+    [ThreadStatic]
+    static array<PointI>^ s_points;
+
+    [ThreadStatic]
+    static array<Byte>^   s_types;
+};
+
 /**************************************************************************\
 *
 * Class Description:
@@ -50,8 +113,8 @@ private:
         //_forceEmpty = false;
 
         // gdi
-        _points = gcnew array<PointI>(estimatedPointCount);
-        _types = gcnew array<Byte>(estimatedPointCount);
+        _points = GdiPathBuffers::AcquirePoints(estimatedPointCount);
+        _types = GdiPathBuffers::AcquireTypes(estimatedPointCount);
 
         //_pointCount = 0;
         //_figureCount = 0;
@@ -699,6 +762,18 @@ CGDIPath::CGDIPath(
 }
 
 
+CGDIPath::~CGDIPath()
+{
+    // Point data isn't referenced after the path is done with; let the next path reuse it
+    GdiPathBuffers::Release(m_Points, m_Types);
+
+    m_Points    = nullptr;
+    m_Types     = nullptr;
+    m_NumPoints = 0;
+    m_IsValid   = false;
+}
+
+
 void CGDIPath::ProcessPolygon(int count, bool ForFill, int figureCount)
 {
     // construct a polyPolygon
@@ -1154,34 +1229,12 @@ double CGDIPath::MaxCos(void)
     array<PointI>^ pPoints = m_Points;
     array<Byte> ^  pTypes  = m_Types;
 
-    // Keep track of location of all PT_MOVETO and PT_CLOSEFIGUREs.
-    // We'll use this to track current figure start/close points, used to
-    // properly calculate neighboring points within closed figures.
-    System::Collections::Generic::List<int>^ figureStartClose = gcnew System::Collections::Generic::List<int>();
+    // Track current figure start/close points, used to properly calculate neighboring
+    // points within closed figures. The next PT_CLOSEFIGURE and its PT_MOVETO are found by
+    // scanning ahead of i, so the path is walked twice at most without allocating.
+    int scanIndex  = 0;     // next point to scan for PT_CLOSEFIGURE
+    int scanMoveTo = -1;    // last PT_MOVETO seen by the scan
 
-    {
-        int lastMoveTo = -1;
-        for (int i = 0; i < nCount; i++)
-        {
-            if ((pTypes[i] & PT_TYPEMASK) == PT_MOVETO)
-            {
-                // start of figure
-                lastMoveTo = i;
-            }
-            else if (pTypes[i] & PT_CLOSEFIGURE)
-            {
-                // close of figure.
-                // figure is from this point and last PT_MOVETO inclusive.
-                Debug::Assert(lastMoveTo != -1);
-
-                figureStartClose->Add(lastMoveTo);
-                figureStartClose->Add(i);
-            }
-        }
-    }
-
-    // current figureStartClose index, indicating current figure start and close point
-    int nextFigureStartCloseIndex = 0;
     int figureStartPoint = -1;
     int figureClosePoint = -1;
 
@@ -1191,12 +1244,29 @@ double CGDIPath::MaxCos(void)
         // find neighbor points. Update if we've reached new figure (i > figure's close point)
         if (i > figureClosePoint)
         {
-            if ((nextFigureStartCloseIndex+1) < figureStartClose->Count)
+            while (scanIndex < nCount)
             {
-                figureStartPoint = figureStartClose[nextFigureStartCloseIndex];
-                figureClosePoint = figureStartClose[nextFigureStartCloseIndex+1];
+                int type = pTypes[scanIndex];
+
+                if ((type & PT_TYPEMASK) == PT_MOVETO)
+                {
+                    // start of figure
+                    scanMoveTo = scanIndex;
+                }
+                else if (type & PT_CLOSEFIGURE)
+                {
+                    // close of figure.
+                    // figure is from this point and last PT_MOVETO inclusive.
+                    Debug::Assert(scanMoveTo != -1);
+
+                    figureStartPoint = scanMoveTo;
+                    figureClosePoint = scanIndex;
+
+                    scanIndex++;
+                    break;
+                }
 
-                nextFigureStartCloseIndex += 2;
+                scanIndex++;
             }
         }
 
@@ -1283,24 +1353,24 @@ double CGDIPath::MaxCos(void)
 *    topleft and bottomright to ensure that it includes the point pt. 
 \**************************************************************************/
 
-inline void AdjustBounds(PointI^ pt, PointI^ topleft, PointI^ bottomright)
+inline void AdjustBounds(PointI pt, PointI% topleft, PointI% bottomright)
 {
-    if (pt->x < topleft->x)
+    if (pt.x < topleft.x)
     {
-        topleft->x = pt->x;
+        topleft.x = pt.x;
     }
-    else if (pt->x > bottomright->x)
+    else if (pt.x > bottomright.x)
     {
-        bottomright->x = pt->x;
+        bottomright.x = pt.x;
     }
 
-    if (pt->y < topleft->y)
+    if (pt.y < topleft.y)
     {
-        topleft->y = pt->y;
+        topleft.y = pt.y;
     }
-    else if (pt->y > bottomright->y)
+    else if (pt.y > bottomright.y)
     {
-        bottomright->y = pt->y;
+        bottomright.y = pt.y;
     }
 }
 
@@ -1362,10 +1432,17 @@ void CPolyPolygon::GetBounds(void)
 
     Debug::Assert(nTotal >= 1);
 
+    // Accumulate in locals; m_topleft/m_bottomright are fields of a managed object
+    PointI topleft     = m_topleft;
+    PointI bottomright = m_bottomright;
+
     for (int i = 1; i < nTotal; i++)
     {
-        AdjustBounds(m_rgptVertex[m_offsetP + i], m_topleft, m_bottomright);
+        AdjustBounds(m_rgptVertex[m_offsetP + i], topleft, bottomright);
     }
+
+    m_topleft     = topleft;
+    m_bottomright = bottomright;
 }
 
 
@@ -1402,7 +1479,7 @@ void CPolyPolygon::Divide(
             num = m_cPolygons - n * part;
         }
 
-        pPolygons[n]->Set(m_rgptVertex, m_offsetP + offsetP, m_rgcPoly, n * part, num);
+        pPolygons[n]->Set(m_rgptVertex, m_offsetP + offsetP, m_rgcPoly, m_offsetC + n * part, num);
         pPolygons[n]->GetBounds();
 
         if (n != (cGroup - 1))
@@ -1442,6 +1519,9 @@ CPolyPolygon::DisJoint(
 }
     
 
+const int c_LARGEPOLYPOLYGON = 32;
+const int c_GROUPS           = 8;
+
 /**************************************************************************\
 *
 * Function Description:
@@ -1461,11 +1541,39 @@ CPolyPolygon::DisJoint(
     IN INT cGroup                     // number of CPolyPolygon 
     )
 {
+    Debug::Assert(cGroup <= c_GROUPS);
+
+    // Sweep over groups ordered by left edge; a group can only touch the following
+    // groups whose left edge starts before its right edge.
+    int order[c_GROUPS];
+
     for (INT i = 0; i < cGroup; i ++)
     {
+        int j = i;
+
+        while (j > 0 && pPolygons[order[j - 1]]->m_topleft.x > pPolygons[i]->m_topleft.x)
+        {
+            order[j] = order[j - 1];
+            j --;
+        }
+
+        order[j] = i;
+    }
+
+    for (INT i = 0; i < cGroup; i ++)
+    {
+        CPolyPolygon ^ poly = pPolygons[order[i]];
+
         for (INT j = i + 1; j < cGroup; j ++)
         {
-            if (! pPolygons[i]->DisJoint(pPolygons[j]))
+            CPolyPolygon ^ other = pPolygons[order[j]];
+
+            if (other->m_topleft.x >= poly->m_bottomright.x)
+            {
+                break;  // this and all later groups start right of poly
+            }
+
+            if (! poly->DisJoint(other))
             {
                 return false;
             }
@@ -1490,9 +1598,6 @@ CPolyPolygon::DisJoint(
 *
 \**************************************************************************/
 
-const int c_LARGEPOLYPOLYGON = 32;
-const int c_GROUPS           = 8;
-
 HRESULT
 CPolyPolygon::Draw(
     CGDIDevice ^ dc          // device context to draw on
@@ -339,7 +339,7 @@ GdiSafeHandle^ CGDIDevice::ConvertPen(
         lp.style         = style;
         lp.width         = width;
 
-        GdiSafeHandle ^ pen = CacheMatch((interior_ptr<Byte>) & lp, sizeof(lp));
+        GdiSafeHandle ^ pen = CacheMatch((interior_ptr<Byte>) & lp, sizeof(lp), OBJ_PEN);
 
         if (pen == nullptr)
         {
@@ -352,7 +352,7 @@ GdiSafeHandle^ CGDIDevice::ConvertPen(
                 // So the cache cannot distinguish between LOGPENS that create pens differing only in dash styles
                 if((lp.style & PS_USERSTYLE) != PS_USERSTYLE)
                 {
-                    CacheObject((interior_ptr<Byte>) & lp, sizeof(lp), pen);
+                    CacheObject((interior_ptr<Byte>) & lp, sizeof(lp), OBJ_PEN, pen);
                 }
             }
             else
@@ -24,6 +24,8 @@ int CGDIRenderTarget::StartDocument(String ^ printerName, String^ jobName, Strin
     }
     // filename can be NULL, which corresponds to DOCINFO.lpszOutput being NULL
 
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXStartDocBegin);
+
     if (s_oldPrivateFonts->Count != 0)
     {
         System::Threading::Monitor::Enter(s_lockObject);
@@ -86,6 +88,8 @@ int CGDIRenderTarget::StartDocument(String ^ printerName, String^ jobName, Strin
         hr = ErrorCode((jobIdentifier = CNativeMethods::StartDocW(m_hDC, DocInfo)) > 0);
     }
 
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXStartDocEnd, jobIdentifier);
+
     ThrowOnFailure(hr);
 
     return jobIdentifier;
@@ -116,6 +120,8 @@ void CGDIRenderTarget::EndDocument()
         return;
     }
 
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXEndDocBegin);
+
     HRESULT hr = HrEndDoc();
 
     if (HasDC)
@@ -124,6 +130,23 @@ void CGDIRenderTarget::EndDocument()
         m_hDC = nullptr;
     }
 
+    // Release rasterized brushes kept for this job
+    m_rasterizedBrushCache = nullptr;
+    m_rasterizedBrushLru   = nullptr;
+    m_rasterizedBrushBytes = 0;
+
+    // Release loaded bitmaps kept for this job
+    m_loadedBitmapCache = nullptr;
+    m_loadedBitmapLru   = nullptr;
+    m_loadedBitmapBytes = 0;
+
+    // Release passthrough payloads kept for this job
+    m_passThroughCache = nullptr;
+    m_passThroughLru   = nullptr;
+    m_passThroughBytes = 0;
+
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXEndDocEnd);
+
     ThrowOnFailure(hr);
 }
 
@@ -288,9 +311,14 @@ void CGDIRenderTarget::StartPage(array<Byte> ^devmode, int rasterizationDPI)
     }
 
     Debug::Assert(!m_startPage, "EndPage already called.");
+
+    // StartPageEnd to EndPageBegin spans the GDI conversion of the page
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXStartPageBegin);
     
     HRESULT hr = HrStartPage(devmode);
 
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXStartPageEnd, rasterizationDPI);
+
     ThrowOnFailure(hr);
 
     m_nWidth           = CNativeMethods::GetDeviceCaps(m_hDC, HORZRES);
@@ -315,9 +343,13 @@ void CGDIRenderTarget::EndPage()
     PopTransform();
 
     m_startPage = false;
+
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXEndPageBegin);
     
     HRESULT hr = HrEndPage();
 
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXEndPageEnd);
+
     ThrowOnFailure(hr);
 }
 
@@ -373,11 +405,8 @@ void CGDIRenderTarget::PopClip()
 
         if (m_clipLevel != 0)
         {
-            int errCode = CNativeMethods::RestoreDC(m_hDC, -1);     // ROBERTAN
-            Debug::Assert(errCode != 0, "RestoreDC failed.");
-
-            ResetStates();    // Values in DC will be returned to before SaveDC states
-                              // Reset them to unset value until we have a stack to track them exactly
+            BOOL restored = RestoreDCState();   // Cached DC values return to their SaveDC state
+            Debug::Assert(restored, "RestoreDC failed.");
         }
         else
         {
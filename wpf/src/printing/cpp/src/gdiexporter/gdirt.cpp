@@ -36,54 +36,351 @@ void GenerateGradientBandTriangles(
     int vertexOffset
     );
 
-GdiSafeHandle^ CGDIDevice::CacheMatch(const interior_ptr<Byte> pData, int size)
+// Helper function for CGDIRenderTarget::RasterizeBrush and BandRasterizer.
+HRESULT RasterizeBrushBand(
+    CGDIBitmap         % bmpdata,
+    Int32Rect            renderBounds,
+    Int32Rect            bounds,
+    Rect                 geometryBounds,
+    Brush              ^ pFillBrush,
+    bool                 vertical,
+    bool                 horizontal,
+    double               ScaleX,
+    double               ScaleY,
+    Matrix               worldTransform
+    );
+
+// Never let the cache hold more than this fraction of the process GDI handle quota; other
+// print jobs and the application itself share the same quota.
+const int GdiQuotaCacheShare           = 8;
+const int DefaultGdiProcessHandleQuota = 10000;
+
+const int CacheBucketCount             = 256;  // power of 2
+
+// Memory budget, in bytes, of the per job RasterizeBrush cache
+const int RasterizedBrushCacheBudget   = 32 * 1024 * 1024;
+
+// Memory budget, in bytes, of the per job DrawBitmap loaded bitmap cache
+const int LoadedBitmapCacheBudget      = 32 * 1024 * 1024;
+
+// Memory budget, in bytes, of the per job JPEG/PNG passthrough cache
+const int PassThroughCacheBudget       = 16 * 1024 * 1024;
+
+// Index into s_CacheRequested/m_CacheCount for an OBJ_xxx type
+static int CacheTypeIndex(int type)
+{
+    switch (type)
+    {
+    case OBJ_PEN:
+        return 1;
+
+    case OBJ_FONT:
+        return 2;
+
+    default:
+        return 0;
+    }
+}
+
+// FNV-1a over the raw key bytes
+static int CacheHash(const interior_ptr<Byte> pData, int size)
+{
+    unsigned hash = 2166136261u;
+
+    for (int i = 0; i < size; i ++)
+    {
+        hash = (hash ^ pData[i]) * 16777619;
+    }
+
+    return (int) hash;
+}
+
+void CGDIDevice::SetCacheCapacity(int type, int capacity)
+{
+    if (capacity < 0)
+    {
+        throw gcnew ArgumentOutOfRangeException("capacity");
+    }
+
+    System::Threading::Monitor::Enter(s_lockObject);
+
+    __try
+    {
+        s_CacheRequested[CacheTypeIndex(type)] = capacity;
+
+        // Recomputed against the GDI handle quota by the next GetCacheCapacity
+        s_CacheCapacity = nullptr;
+    }
+    __finally
+    {
+        System::Threading::Monitor::Exit(s_lockObject);
+    }
+}
+
+/// <SecurityNote>
+/// Critical - asserts registry permissions to read the GDI handle quota from LocalMachine.
+/// </SecurityNote>
+array<int>^ CGDIDevice::GetCacheCapacity()
+{
+    array<int>^ result = s_CacheCapacity;
+
+    if (result != nullptr)
+    {
+        return result;
+    }
+
+    int quota = DefaultGdiProcessHandleQuota;
+
+    RegistryPermission^ permission = gcnew RegistryPermission(
+        RegistryPermissionAccess::Read,
+        "HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows NT\\CurrentVersion\\Windows");
+
+    permission->Assert(); // Blessed assert
+
+    try
+    {
+        Object^ value = Microsoft::Win32::Registry::GetValue(
+            "HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows NT\\CurrentVersion\\Windows",
+            "GDIProcessHandleQuota",
+            nullptr);
+
+        if ((value != nullptr) && dynamic_cast<Int32^>(value) && (safe_cast<Int32>(value) > 0))
+        {
+            quota = safe_cast<Int32>(value);
+        }
+    }
+    // Caller may not have registry read permissions
+    catch (SecurityException^)
+    {
+    }
+    // Registry Key may be in the middle of deletion
+    catch (IOException^)
+    {
+    }
+    finally
+    {
+        RegistryPermission::RevertAssert();
+    }
+
+    System::Threading::Monitor::Enter(s_lockObject);
+
+    __try
+    {
+        result = gcnew array<int>(s_CacheRequested->Length);
+
+        int total = 0;
+
+        for (int i = 0; i < result->Length; i ++)
+        {
+            result[i] = s_CacheRequested[i];
+            total    += result[i];
+        }
+
+        // Scale all types down proportionally when their sum exceeds our share of the quota
+        int limit = quota / GdiQuotaCacheShare;
+
+        if (total > limit)
+        {
+            for (int i = 0; i < result->Length; i ++)
+            {
+                result[i] = (int) ((Int64) result[i] * limit / total);
+            }
+        }
+
+        s_CacheCapacity = result;
+    }
+    __finally
+    {
+        System::Threading::Monitor::Exit(s_lockObject);
+    }
+
+    return result;
+}
+
+GdiSafeHandle^ CGDIDevice::CacheMatch(const interior_ptr<Byte> pData, int size, int type)
 {
     if (m_Cache == nullptr)
     {
         return nullptr;
     }
 
-    for (int i = 0; i < m_Cache->Length; i ++)
+    int hash = CacheHash(pData, size);
+
+    for (CachedGDIObject^ entry = m_Cache[hash & (m_Cache->Length - 1)]; entry != nullptr; entry = entry->m_nextInBucket)
     {
-        if (m_Cache[i] != nullptr)
-        {
-            GdiSafeHandle^ result = m_Cache[i]->Match(pData, size);
+        GdiSafeHandle^ result = entry->Match(pData, size, hash);
 
-            if (result != nullptr)
+        if ((result != nullptr) && (entry->Type == type))
+        {
+            // Move to the most recently used end of the LRU list
+            if (entry != m_CacheNewest)
             {
-                return result;
+                entry->m_newer->m_older = entry->m_older;
+
+                if (entry->m_older != nullptr)
+                {
+                    entry->m_older->m_newer = entry->m_newer;
+                }
+                else
+                {
+                    m_CacheOldest = entry->m_newer;
+                }
+
+                entry->m_newer         = nullptr;
+                entry->m_older         = m_CacheNewest;
+                m_CacheNewest->m_newer = entry;
+                m_CacheNewest          = entry;
             }
+
+            m_CacheHits ++;
+
+            return result;
         }
     }
 
+    m_CacheMisses ++;
+
     return nullptr;
 }
 
 
-void CGDIDevice::CacheObject(interior_ptr<Byte> pData, int size, GdiSafeHandle^ handle)
+// Removes entry from its hash bucket and the LRU list, without closing its handle
+void CGDIDevice::CacheUnlink(CachedGDIObject ^ entry)
+{
+    int bucket = entry->Hash & (m_Cache->Length - 1);
+
+    if (m_Cache[bucket] == entry)
+    {
+        m_Cache[bucket] = entry->m_nextInBucket;
+    }
+    else
+    {
+        CachedGDIObject^ prev = m_Cache[bucket];
+
+        while (prev->m_nextInBucket != entry)
+        {
+            prev = prev->m_nextInBucket;
+        }
+
+        prev->m_nextInBucket = entry->m_nextInBucket;
+    }
+
+    if (entry->m_newer != nullptr)
+    {
+        entry->m_newer->m_older = entry->m_older;
+    }
+    else
+    {
+        m_CacheNewest = entry->m_older;
+    }
+
+    if (entry->m_older != nullptr)
+    {
+        entry->m_older->m_newer = entry->m_newer;
+    }
+    else
+    {
+        m_CacheOldest = entry->m_newer;
+    }
+
+    entry->m_nextInBucket = nullptr;
+    entry->m_newer        = nullptr;
+    entry->m_older        = nullptr;
+
+    m_CacheCount[CacheTypeIndex(entry->Type)] --;
+}
+
+
+void CGDIDevice::CacheObject(interior_ptr<Byte> pData, int size, int type, GdiSafeHandle^ handle)
+{
+    if (m_Cache != nullptr)
+    {
+        int index    = CacheTypeIndex(type);
+        int capacity = m_CacheCapacity[index];
+
+        if (capacity == 0)
+        {
+            // Caching disabled for this type; caller still owns the handle through the SafeHandle
+            return;
+        }
+
+        // Evict least recently used objects of the same type
+        CachedGDIObject^ victim = m_CacheOldest;
+
+        while ((m_CacheCount[index] >= capacity) && (victim != nullptr))
+        {
+            CachedGDIObject^ next = victim->m_newer;
+
+            if (victim->Type == type)
+            {
+                GdiSafeHandle ^old = victim->Handle;
+
+                if ((old != m_lastFont) && (old != m_lastBrush) && (old != m_lastPen))
+                {
+                    // Release corresponding GDI object ASAP if it's not needed to reduce active GDI object count
+                    CacheUnlink(victim);
+                    old->Close();
+                    m_CacheEvictions ++;
+                }
+            }
+
+            victim = next;
+        }
+
+        int hash   = CacheHash(pData, size);
+        int bucket = hash & (m_Cache->Length - 1);
+
+        CachedGDIObject^ entry = gcnew CachedGDIObject(pData, size, hash, type, handle);
+
+        entry->m_nextInBucket = m_Cache[bucket];
+        m_Cache[bucket]       = entry;
+
+        entry->m_older = m_CacheNewest;
+
+        if (m_CacheNewest != nullptr)
+        {
+            m_CacheNewest->m_newer = entry;
+        }
+        else
+        {
+            m_CacheOldest = entry;
+        }
+
+        m_CacheNewest = entry;
+        m_CacheCount[index] ++;
+    }
+}
+
+
+void CGDIDevice::CacheFlush()
 {
     if (m_Cache != nullptr)
     {
-        // Find an empty slot
-        while (m_Cache[m_CacheFirst] != nullptr)
+        for (CachedGDIObject^ entry = m_CacheOldest; entry != nullptr; entry = entry->m_newer)
         {
-            GdiSafeHandle ^old = m_Cache[m_CacheFirst]->Handle;
+            GdiSafeHandle ^old = entry->Handle;
 
-            if ((old != m_lastFont) && (old != m_lastBrush) && (old != m_lastPen))
+            if (old != nullptr && !old->IsInvalid)
             {
-                // Release corresponding GDI object ASAP if it's not needed to reduce active GDI object count
-            
                 old->Close();
-                m_Cache[m_CacheFirst] = nullptr;
-                break;
             }
 
-            // Try next one
-            m_CacheFirst = (m_CacheFirst + 1) % m_Cache->Length;
+            entry->m_nextInBucket = nullptr;
+            entry->m_older        = nullptr;
+        }
+
+        for (int i = 0; i < m_Cache->Length; i ++)
+        {
+            m_Cache[i] = nullptr;
         }
 
-        m_Cache[m_CacheFirst] = gcnew CachedGDIObject(pData, size, handle);
-        m_CacheFirst = (m_CacheFirst + 1) % m_Cache->Length;
+        m_CacheNewest = nullptr;
+        m_CacheOldest = nullptr;
+
+        for (int i = 0; i < m_CacheCount->Length; i ++)
+        {
+            m_CacheCount[i] = 0;
+        }
     }
 }
 
@@ -149,9 +446,15 @@ HRESULT CGDIRenderTarget::Initialize()
         // Page dimensions filled in StartPage.
         m_nWidth = m_nHeight = 0;
 
-        // Caching 32 GDI objects
-        m_Cache      = gcnew array<CachedGDIObject^>(32);
-        m_CacheFirst = 0;
+        // Hashed GDI object cache, capacity per object type bounded by the GDI handle quota
+        m_Cache          = gcnew array<CachedGDIObject^>(CacheBucketCount);
+        m_CacheNewest    = nullptr;
+        m_CacheOldest    = nullptr;
+        m_CacheCount     = gcnew array<int>(3);
+        m_CacheCapacity  = GetCacheCapacity();
+        m_CacheHits      = 0;
+        m_CacheMisses    = 0;
+        m_CacheEvictions = 0;
     }
 
     m_state = gcnew System::Collections::Stack();
@@ -162,6 +465,18 @@ HRESULT CGDIRenderTarget::Initialize()
 
     m_cachedUnstyledFontCharsets = gcnew System::Collections::Hashtable();
 
+    m_rasterizedBrushCache = gcnew System::Collections::Hashtable();
+    m_rasterizedBrushLru   = gcnew LinkedList<RasterizedBrushKey^>();
+    m_rasterizedBrushBytes = 0;
+
+    m_loadedBitmapCache = gcnew System::Collections::Hashtable();
+    m_loadedBitmapLru   = gcnew LinkedList<LoadedBitmapKey^>();
+    m_loadedBitmapBytes = 0;
+
+    m_passThroughCache = gcnew System::Collections::Hashtable();
+    m_passThroughLru   = gcnew LinkedList<BitmapSource^>();
+    m_passThroughBytes = 0;
+
     return hr;
 }
 
@@ -244,102 +559,161 @@ HRESULT CGDIRenderTarget::DrawBitmap_PassThrough(
 
     HRESULT hr = E_NOTIMPL;
 
-    bool bJPEG = false;
-    bool bPNG  = false;
+    if (!IsTranslateOrScale(m_transform) || (GetRotation(m_transform) == MatrixRotateByOther))
+    {
+        return hr;
+    }
 
-    BitmapCodecInfo ^ codec = nullptr;
+    bool bJPEG = (GetCaps() & CAP_JPGPassthrough) != 0;
+    bool bPNG  = (GetCaps() & CAP_PNGPassthrough) != 0;
 
-    if (IsTranslateOrScale(m_transform) && (GetRotation(m_transform) != MatrixRotateByOther))
+    if (!bJPEG && !bPNG)
     {
-        bJPEG = (GetCaps() & CAP_JPGPassthrough) != 0;
-        bPNG  = (GetCaps() & CAP_PNGPassthrough) != 0;
+        return hr;
+    }
 
-        if (bJPEG || bPNG)
-        {
-            codec = GetBitmapCodec(pIBitmap);
-            if (codec != nullptr)
-            {
-                String ^ mime ="";
-                (gcnew RegistryPermission(PermissionState::Unrestricted))->Assert(); //BlessedAssert commen
-                try
-                {
-                    mime = codec->MimeTypes;
-                }
-                __finally
-                {
-                    RegistryPermission::RevertAssert();
-                }
+    // Codec detection, encoding and the driver's verdict only depend on the image for this job
+    PassThroughEntry^ entry = nullptr;
 
+    bool cacheable = (m_passThroughCache != nullptr) && pIBitmap->IsFrozen;
 
-                if (bJPEG && (mime->IndexOf("image/jpeg", StringComparison::OrdinalIgnoreCase) != -1))
-                {
-                    hr   = S_OK;
-                    bPNG = false;
-                }
-                else if (bPNG && (mime->IndexOf("image/png", StringComparison::OrdinalIgnoreCase) != -1))
-                {
-                    hr    = S_OK;
-                    bJPEG = false;
-                }
-            }
+    if (cacheable)
+    {
+        entry = dynamic_cast<PassThroughEntry^>(m_passThroughCache[pIBitmap]);
+
+        if (entry != nullptr)
+        {
+            m_passThroughLru->Remove(entry->node);
+            m_passThroughLru->AddFirst(entry->node);
         }
     }
 
-    if (SUCCEEDED(hr))
+    if (entry == nullptr)
     {
-        hr = E_NOTIMPL;
+        entry = gcnew PassThroughEntry();
+
+        entry->compression = BI_RGB;
 
-        array<Byte>^ raw = GetRawBitmap(pIBitmap, codec);
+        BitmapCodecInfo ^ codec = GetBitmapCodec(pIBitmap);
 
-        if (raw != nullptr)
+        if (codec != nullptr)
         {
-            unsigned long result = 0;
+            String ^ mime ="";
+            (gcnew RegistryPermission(PermissionState::Unrestricted))->Assert(); //BlessedAssert commen
+            try
+            {
+                mime = codec->MimeTypes;
+            }
+            __finally
+            {
+                RegistryPermission::RevertAssert();
+            }
 
-            int nDataSize = raw->Length;
+            if (bJPEG && (mime->IndexOf("image/jpeg", StringComparison::OrdinalIgnoreCase) != -1))
+            {
+                bPNG = false;
+            }
+            else if (bPNG && (mime->IndexOf("image/png", StringComparison::OrdinalIgnoreCase) != -1))
+            {
+                bJPEG = false;
+            }
+            else
+            {
+                codec = nullptr;
+            }
+        }
 
-            pin_ptr<Byte> rawPin = &raw[0];
+        if (codec != nullptr)
+        {
+            array<Byte>^ raw = GetRawBitmap(pIBitmap, codec);
 
-            // Call escape to determine if this particular image is supported
-            if ((CNativeMethods::ExtEscape(
-                      m_hDC,
-                      bJPEG ? CHECKJPEGFORMAT : CHECKPNGFORMAT,
-                      nDataSize,
-                      (void*)rawPin,
-                      sizeof(result),
-                      &result) > 0) && (result > 0))
+            if ((raw != nullptr) && (raw->Length != 0))
             {
-                BITMAPINFO bmi;
-
-                memset(&bmi, 0, sizeof(bmi));
-
-                bmi.bmiHeader.biSize        = sizeof(BITMAPINFOHEADER);
-                bmi.bmiHeader.biWidth       = nImageWidth;
-                bmi.bmiHeader.biHeight      = - nImageHeight; // top-down image
-                bmi.bmiHeader.biPlanes      = 1;
-                bmi.bmiHeader.biBitCount    = 0;
-                bmi.bmiHeader.biCompression = bJPEG ? BI_JPEG : BI_PNG;
-                bmi.bmiHeader.biSizeImage   = nDataSize;
-
-                hr = StretchDIBits(
-                        rcDstBounds.X,
-                        rcDstBounds.Y,
-                        rcDstBounds.Width,
-                        rcDstBounds.Height,
-                        0,
-                        0,
-                        nImageWidth,
-                        nImageHeight,
-                        & raw[0],
-                        & bmi
-                        );
+                unsigned long result = 0;
+
+                pin_ptr<Byte> rawPin = &raw[0];
+
+                // Call escape to determine if this particular image is supported
+                if ((CNativeMethods::ExtEscape(
+                          m_hDC,
+                          bJPEG ? CHECKJPEGFORMAT : CHECKPNGFORMAT,
+                          raw->Length,
+                          (void*)rawPin,
+                          sizeof(result),
+                          &result) > 0) && (result > 0))
+                {
+                    entry->raw         = raw;
+                    entry->compression = bJPEG ? BI_JPEG : BI_PNG;
+                }
             }
         }
+
+        if (cacheable)
+        {
+            AddPassThroughEntry(pIBitmap, entry);
+        }
+    }
+
+    if (entry->compression != BI_RGB)
+    {
+        BITMAPINFO bmi;
+
+        memset(&bmi, 0, sizeof(bmi));
+
+        bmi.bmiHeader.biSize        = sizeof(BITMAPINFOHEADER);
+        bmi.bmiHeader.biWidth       = nImageWidth;
+        bmi.bmiHeader.biHeight      = - nImageHeight; // top-down image
+        bmi.bmiHeader.biPlanes      = 1;
+        bmi.bmiHeader.biBitCount    = 0;
+        bmi.bmiHeader.biCompression = entry->compression;
+        bmi.bmiHeader.biSizeImage   = entry->raw->Length;
+
+        hr = StretchDIBits(
+                rcDstBounds.X,
+                rcDstBounds.Y,
+                rcDstBounds.Width,
+                rcDstBounds.Height,
+                0,
+                0,
+                nImageWidth,
+                nImageHeight,
+                & entry->raw[0],
+                & bmi
+                );
     }
 
     return hr;
 }
 
 
+void CGDIRenderTarget::AddPassThroughEntry(BitmapSource ^ pIBitmap, PassThroughEntry ^ entry)
+{
+    // Negative verdicts keep no payload and cost nothing against the budget
+    int size = (entry->raw != nullptr) ? entry->raw->Length : 0;
+
+    // Don't let one huge image flush everything else
+    if (size > PassThroughCacheBudget / 4)
+    {
+        return;
+    }
+
+    while ((m_passThroughBytes + size > PassThroughCacheBudget) && (m_passThroughLru->Count != 0))
+    {
+        BitmapSource^ oldest = m_passThroughLru->Last->Value;
+
+        m_passThroughBytes -= safe_cast<PassThroughEntry^>(m_passThroughCache[oldest])->size;
+        m_passThroughCache->Remove(oldest);
+        m_passThroughLru->RemoveLast();
+    }
+
+    entry->size = size;
+    entry->node = m_passThroughLru->AddFirst(pIBitmap);
+
+    m_passThroughCache[pIBitmap] = entry;
+    m_passThroughBytes          += size;
+}
+
+
 PixelFormat GetLoadFormat(PixelFormat format)
 {
     if (format == PixelFormats::Indexed2)
@@ -471,15 +845,32 @@ HRESULT  CGDIRenderTarget::DrawBitmap(BitmapSource ^ pImage, array<Byte>^ buffer
             LoadFormat = GetLoadFormat(pImage->Format);
         }
 
-        hr = source.Load(pImage, buffer, LoadFormat);
+        // we can handle flipping now; this produces better quality than avalon rasterization
+        bool flipHoriz = m_transform.M11 < 0;
+        bool flipVert  = m_transform.M22 < 0;
+
+        Int64 loadSize = (Int64) GetDIBStride(pImage->PixelWidth, LoadFormat.BitsPerPixel) * pImage->PixelHeight;
 
-        if (SUCCEEDED(hr) && source.IsValid())
+        if ((buffer == nullptr) && (loadSize > s_bandMemoryBudget))
         {
-            // we can handle flipping now; this produces better quality than avalon rasterization
-            bool flipHoriz = m_transform.M11 < 0;
-            bool flipVert  = m_transform.M22 < 0;
+            // Decoding the whole image at once would exceed the band budget
+            hr = DrawBitmapBanded(pImage, LoadFormat, rcDstBounds, flipHoriz, flipVert);
+        }
+        else
+        {
+            if (buffer == nullptr)
+            {
+                hr = LoadBitmap(source, pImage, LoadFormat);
+            }
+            else
+            {
+                hr = source.Load(pImage, buffer, LoadFormat);
+            }
 
-            hr = source.StretchBlt(this, rcDstBounds, flipHoriz, flipVert);
+            if (SUCCEEDED(hr) && source.IsValid())
+            {
+                hr = source.StretchBlt(this, rcDstBounds, flipHoriz, flipVert);
+            }
         }
     }
 
@@ -529,6 +920,135 @@ HRESULT  CGDIRenderTarget::DrawBitmap(BitmapSource ^ pImage, array<Byte>^ buffer
 }
 
 
+HRESULT CGDIRenderTarget::LoadBitmap(CGDIBitmap % source, BitmapSource ^ pImage, PixelFormat LoadFormat)
+{
+    LoadedBitmapKey^ key = nullptr;
+
+    // Unfrozen sources may change between uses
+    if ((m_loadedBitmapCache != nullptr) && pImage->IsFrozen)
+    {
+        key = gcnew LoadedBitmapKey(pImage, LoadFormat);
+
+        LoadedBitmapEntry^ entry = dynamic_cast<LoadedBitmapEntry^>(m_loadedBitmapCache[key]);
+
+        if (entry != nullptr)
+        {
+            m_loadedBitmapLru->Remove(entry->node);
+            m_loadedBitmapLru->AddFirst(entry->node);
+
+            source = entry->bitmap;
+
+            return S_OK;
+        }
+    }
+
+    HRESULT hr = source.Load(pImage, nullptr, LoadFormat);
+
+    if (SUCCEEDED(hr) && (key != nullptr) && source.IsValid())
+    {
+        int size = source.GetBufferSize();
+
+        // Don't let one huge image flush everything else
+        if (size <= LoadedBitmapCacheBudget / 4)
+        {
+            while ((m_loadedBitmapBytes + size > LoadedBitmapCacheBudget) && (m_loadedBitmapLru->Count != 0))
+            {
+                LoadedBitmapKey^ oldest = m_loadedBitmapLru->Last->Value;
+
+                m_loadedBitmapBytes -= safe_cast<LoadedBitmapEntry^>(m_loadedBitmapCache[oldest])->size;
+                m_loadedBitmapCache->Remove(oldest);
+                m_loadedBitmapLru->RemoveLast();
+            }
+
+            LoadedBitmapEntry^ entry = gcnew LoadedBitmapEntry();
+
+            entry->bitmap = source;
+            entry->size   = size;
+            entry->node   = m_loadedBitmapLru->AddFirst(key);
+
+            m_loadedBitmapCache[key] = entry;
+            m_loadedBitmapBytes     += size;
+        }
+    }
+
+    return hr;
+}
+
+
+void CGDIRenderTarget::SetBandMemoryBudget(int bytes)
+{
+    if (bytes <= 0)
+    {
+        throw gcnew ArgumentOutOfRangeException("bytes");
+    }
+
+    s_bandMemoryBudget = bytes;
+}
+
+
+void CGDIRenderTarget::SetCollapseGradientBands(bool collapse)
+{
+    s_collapseGradientBands = collapse;
+}
+
+
+HRESULT CGDIRenderTarget::DrawBitmapBanded(
+    BitmapSource ^ pImage,
+    PixelFormat    LoadFormat,
+    Int32Rect      rcDstBounds,
+    bool           flipHoriz,
+    bool           flipVert
+    )
+{
+    HRESULT hr = S_OK;
+
+    int width  = pImage->PixelWidth;
+    int height = pImage->PixelHeight;
+    int stride = GetDIBStride(width, LoadFormat.BitsPerPixel);
+
+    int bandRows = Math::Max(1, s_bandMemoryBudget / stride);
+
+    for (int y = 0; SUCCEEDED(hr) && (y < height); y += bandRows)
+    {
+        int rows = Math::Min(bandRows, height - y);
+
+        // Map source rows [y, y + rows) to destination rows, rounding band edges the same
+        // way for neighboring bands so they tile without gaps or overlap.
+        int top    = (int) (((Int64) rcDstBounds.Height * y          + height / 2) / height);
+        int bottom = (int) (((Int64) rcDstBounds.Height * (y + rows) + height / 2) / height);
+
+        if (bottom == top)
+        {
+            continue;
+        }
+
+        Int32Rect destBand = rcDstBounds;
+
+        if (flipVert)
+        {
+            destBand.Y = rcDstBounds.Y + rcDstBounds.Height - bottom;
+        }
+        else
+        {
+            destBand.Y = rcDstBounds.Y + top;
+        }
+
+        destBand.Height = bottom - top;
+
+        CGDIBitmap band;
+
+        hr = band.LoadBand(pImage, nullptr, LoadFormat, y, rows);
+
+        if (SUCCEEDED(hr) && band.IsValid())
+        {
+            hr = band.StretchBlt(this, destBand, flipHoriz, flipVert);
+        }
+    }
+
+    return hr;
+}
+
+
 /**************************************************************************
 *
 * Function Description:
@@ -656,12 +1176,14 @@ void CGDIRenderTarget::PushClipProxy(GeometryProxy% geometry)
         }
         else
         {
-            int errCode = CNativeMethods::SaveDC(m_hDC);    // ROBERTAN
-            Debug::Assert(errCode != 0, "SaveDC failed");
+            BOOL saved = SaveDCState();
+            Debug::Assert(saved, "SaveDC failed");
             
             path->SelectClip(this, RGN_AND);
         }
 
+        delete path;
+
         m_clipLevel ++;
 
         m_state->Push(1);
@@ -1645,13 +2167,37 @@ HRESULT CGDIRenderTarget::FillLinearGradient(
         }
     }
 
-    // allocate vertex and triangle index arrays
-    array<CNativeMethods::TriVertex>^ vertices = gcnew array<CNativeMethods::TriVertex>(vertexCount);
-    array<unsigned long>^ indices = gcnew array<unsigned long>(indexCount);
+    // get vertex and triangle index arrays, only vertexCount/indexCount entries are passed to GDI
+    if (m_gradientVertices == nullptr || m_gradientVertices->Length < vertexCount)
+    {
+        m_gradientVertices = gcnew array<CNativeMethods::TriVertex>(vertexCount);
+    }
+
+    if (m_gradientIndices == nullptr || m_gradientIndices->Length < indexCount)
+    {
+        m_gradientIndices = gcnew array<unsigned long>(indexCount);
+    }
+
+    array<CNativeMethods::TriVertex>^ vertices = m_gradientVertices;
+    array<unsigned long>^ indices = m_gradientIndices;
 
     int vertexOffset = 0;
     int indexOffset = 0;
 
+    // Device pixels per x-space unit, measured across the gradient bands (the distance between
+    // device lines x = 0 and x = 1). Zero disables collapsing bands.
+    double bandPixelScale = 0;
+
+    if (s_collapseGradientBands)
+    {
+        double yLength = Hypotenuse(xToDeviceTransform.M21, xToDeviceTransform.M22);
+
+        if (yLength > 0)
+        {
+            bandPixelScale = Math::Abs(xToDeviceTransform.Determinant) / yLength;
+        }
+    }
+
 // Generate gradient vertices and triangle indices.
     if (padLeft)
     {
@@ -1687,6 +2233,8 @@ HRESULT CGDIRenderTarget::FillLinearGradient(
             flipOffsets = true;
         }
 
+        double emittedOffset = 0;   // x-space offset of the last stop given vertices in this group
+
         for (int stopIndex = 0; stopIndex < stops->Count; stopIndex++)
         {
             int realStopIndex = flipOffsets ? (stops->Count - stopIndex - 1) : stopIndex;
@@ -1702,6 +2250,29 @@ HRESULT CGDIRenderTarget::FillLinearGradient(
             // convert offset to x-space
             offset += groupIndex;
 
+            if (bandPixelScale > 0 && stopIndex > 0 && stopIndex < (stops->Count - 1))
+            {
+                // Drop this stop if the band it would be merged into, from the last kept stop to
+                // the next one, is narrower than a device pixel; any color difference stays
+                // within that pixel.
+                int nextStopIndex = flipOffsets ? (realStopIndex - 1) : (realStopIndex + 1);
+                double nextOffset = (double)stops->GetKey(nextStopIndex);
+
+                if (flipOffsets)
+                {
+                    nextOffset = 1.0 - nextOffset;
+                }
+
+                nextOffset += groupIndex;
+
+                if ((nextOffset - emittedOffset) * bandPixelScale < 1)
+                {
+                    continue;
+                }
+            }
+
+            emittedOffset = offset;
+
             // generate triangles between this and next stops (not applicable on last stop)
             if (stopIndex < (stops->Count - 1))
             {
@@ -1749,12 +2320,14 @@ HRESULT CGDIRenderTarget::FillLinearGradient(
 // Perform gradient fill.
     PushClipProxy(geometry);
 
+    Debug::Assert(vertexOffset <= vertexCount && indexOffset <= indexCount);
+
     HRESULT hr = ErrorCode(CNativeMethods::GradientFill(
         m_hDC,
         vertices,
-        vertexCount,
+        vertexOffset,
         indices,
-        triangleCount,
+        indexOffset / 3,
         GRADIENT_FILL_TRIANGLE
         ));
 
@@ -1822,6 +2395,181 @@ HRESULT CGDIRenderTarget::RasterizeBrush(
     double               ScaleX,
     double               ScaleY
     )
+{
+    RasterizedBrushKey^ key = nullptr;
+
+    if (m_rasterizedBrushCache != nullptr)
+    {
+        key = RasterizedBrushKey::Create(
+            pFillBrush,
+            renderBounds,
+            bounds,
+            geometryBounds,
+            vertical,
+            horizontal,
+            ScaleX,
+            ScaleY,
+            m_transform
+            );
+    }
+
+    if (key != nullptr)
+    {
+        RasterizedBrushEntry^ entry = dynamic_cast<RasterizedBrushEntry^>(m_rasterizedBrushCache[key]);
+
+        if (entry != nullptr)
+        {
+            m_rasterizedBrushLru->Remove(entry->node);
+            m_rasterizedBrushLru->AddFirst(entry->node);
+
+            bmpdata = entry->bitmap;
+
+            return S_OK;
+        }
+    }
+
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXRasterStart, renderBounds.Width, renderBounds.Height);
+
+    HRESULT hr = RasterizeBrushBand(
+        bmpdata,
+        renderBounds,
+        bounds,
+        geometryBounds,
+        pFillBrush,
+        vertical,
+        horizontal,
+        ScaleX,
+        ScaleY,
+        m_transform
+        );
+
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXRasterEnd, hr);
+
+    if (SUCCEEDED(hr) && (key != nullptr) && bmpdata.IsValid())
+    {
+        int size = bmpdata.GetBufferSize();
+
+        // Don't let one huge raster flush everything else
+        if (size <= RasterizedBrushCacheBudget / 4)
+        {
+            while ((m_rasterizedBrushBytes + size > RasterizedBrushCacheBudget) && (m_rasterizedBrushLru->Count != 0))
+            {
+                RasterizedBrushKey^ oldest = m_rasterizedBrushLru->Last->Value;
+
+                m_rasterizedBrushBytes -= safe_cast<RasterizedBrushEntry^>(m_rasterizedBrushCache[oldest])->size;
+                m_rasterizedBrushCache->Remove(oldest);
+                m_rasterizedBrushLru->RemoveLast();
+            }
+
+            RasterizedBrushEntry^ entry = gcnew RasterizedBrushEntry();
+
+            entry->bitmap = bmpdata;
+            entry->size   = size;
+            entry->node   = m_rasterizedBrushLru->AddFirst(key);
+
+            m_rasterizedBrushCache[key] = entry;
+            m_rasterizedBrushBytes     += size;
+        }
+    }
+
+    return hr;
+}
+
+CGDIRenderTarget::RasterizedBrushKey^ CGDIRenderTarget::RasterizedBrushKey::Create(
+    Brush^      brush,
+    Int32Rect   renderBounds,
+    Int32Rect   bounds,
+    Rect        geometryBounds,
+    bool        vertical,
+    bool        horizontal,
+    double      scaleX,
+    double      scaleY,
+    Matrix      transform
+    )
+{
+    Object^ content = brush;
+
+    // Visual content is live and can change between uses
+    if (brush->GetType() == VisualBrush::typeid)
+    {
+        return nullptr;
+    }
+
+    RasterizedBrushKey^ key = gcnew RasterizedBrushKey();
+
+    TileBrush^ tile = dynamic_cast<TileBrush^>(brush);
+
+    if (tile != nullptr)
+    {
+        // Brushes are typically recreated per page, while the image or drawing they paint is
+        // shared across pages; key on the content and the tile brush properties instead.
+        ImageBrush^   image   = dynamic_cast<ImageBrush^>(brush);
+        DrawingBrush^ drawing = dynamic_cast<DrawingBrush^>(brush);
+
+        Freezable^ tileContent = nullptr;
+
+        if (image != nullptr)
+        {
+            tileContent = image->ImageSource;
+        }
+        else if (drawing != nullptr)
+        {
+            tileContent = drawing->Drawing;
+        }
+
+        if (tileContent != nullptr && tileContent->IsFrozen)
+        {
+            content = tileContent;
+        }
+        else if (!brush->IsFrozen)
+        {
+            return nullptr;
+        }
+
+        key->m_viewport  = tile->Viewport;
+        key->m_viewbox   = tile->Viewbox;
+        key->m_tileFlags = ((int) tile->ViewportUnits)      |
+                           ((int) tile->ViewboxUnits << 2)  |
+                           ((int) tile->TileMode     << 4)  |
+                           ((int) tile->Stretch      << 8)  |
+                           ((int) tile->AlignmentX   << 12) |
+                           ((int) tile->AlignmentY   << 16);
+    }
+    else if (!brush->IsFrozen)
+    {
+        return nullptr;
+    }
+
+    key->m_content           = content;
+    key->m_opacity           = brush->Opacity;
+    key->m_brushTransform    = (brush->Transform != nullptr) ? brush->Transform->Value : Matrix::Identity;
+    key->m_relativeTransform = (brush->RelativeTransform != nullptr) ? brush->RelativeTransform->Value : Matrix::Identity;
+    key->m_renderBounds      = renderBounds;
+    key->m_bounds            = bounds;
+    key->m_geometryBounds    = geometryBounds;
+    key->m_vertical          = vertical;
+    key->m_horizontal        = horizontal;
+    key->m_scaleX            = scaleX;
+    key->m_scaleY            = scaleY;
+    key->m_transform         = transform;
+
+    return key;
+}
+
+// Thread independent part of RasterizeBrush: only touches its parameters, so it may run on
+// BandRasterizer's worker thread given a frozen brush.
+HRESULT RasterizeBrushBand(
+    CGDIBitmap         % bmpdata,
+    Int32Rect            renderBounds,
+    Int32Rect            bounds,
+    Rect                 geometryBounds,
+    Brush              ^ pFillBrush,
+    bool                 vertical,
+    bool                 horizontal,
+    double               ScaleX,
+    double               ScaleY,
+    Matrix               worldTransform
+    )
 {
     Debug::Assert(pFillBrush != nullptr);
     
@@ -1831,7 +2579,7 @@ HRESULT CGDIRenderTarget::RasterizeBrush(
     int bmpHeight = (int) Math::Round(renderBounds.Height / ScaleY);
 
     // axis-aligned linear brushes can be optimized in terms of rasterized bitmap
-    if (IsTranslateOrScale(m_transform))
+    if (IsTranslateOrScale(worldTransform))
     {
         if (horizontal)
         {
@@ -1851,7 +2599,7 @@ HRESULT CGDIRenderTarget::RasterizeBrush(
     // Edges are caused due to rounding of geometry bounds, which results in rasterization not completely
     // filling the rasterization bitmap. We use original geometry bounds to avoid rounding errors.
     //
-    Matrix transform = m_transform;
+    Matrix transform = worldTransform;
 
     Rect deviceBounds = geometryBounds;
     deviceBounds.Transform(transform);
@@ -1877,11 +2625,137 @@ HRESULT CGDIRenderTarget::RasterizeBrush(
             gcnew MatrixTransform(transform),
             PixelFormats::Pbgra32);
 
+    // Allow bmpdata to be consumed on a thread other than the one that rendered it
+    pBrushRaster->Freeze();
+
     hr = bmpdata.Load(pBrushRaster, nullptr, PixelFormats::Bgr24);
 
     return hr;
 }
 
+/// <Summary>
+///     Background STA thread which rasterizes brush bands ahead of the DC thread, so that
+///     RenderTargetBitmap work for band N+1 overlaps StretchDIBits of band N. GDI calls
+///     never leave the DC thread; only RasterizeBrushBand runs here.
+/// </Summary>
+ref class BandRasterizer
+{
+public:
+    ref class Request
+    {
+    public:
+        // Inputs
+        Int32Rect           renderBounds;
+        Int32Rect           bounds;
+        Rect                geometryBounds;
+        Brush             ^ brush;          // frozen
+        double              scaleX;
+        double              scaleY;
+        Matrix              transform;
+
+        // Outputs, valid once done is signaled
+        CGDIBitmap          bitmap;
+        HRESULT             hr;
+        Exception         ^ exception;
+        ManualResetEvent  ^ done;
+
+        Request()
+        {
+            done = gcnew ManualResetEvent(false);
+        }
+
+        // Waits for the worker and rethrows any exception it caught
+        HRESULT Wait()
+        {
+            done->WaitOne();
+            done->Close();
+
+            if (exception != nullptr)
+            {
+                throw exception;
+            }
+
+            return hr;
+        }
+    };
+
+    static Request^ Post(Request^ request)
+    {
+        System::Threading::Monitor::Enter(s_queue);
+
+        __try
+        {
+            if (s_thread == nullptr)
+            {
+                s_thread = gcnew Thread(gcnew ThreadStart(&BandRasterizer::Run));
+                s_thread->SetApartmentState(ApartmentState::STA);
+                s_thread->IsBackground = true;
+                s_thread->Name = "GDI exporter band rasterizer";
+                s_thread->Start();
+            }
+
+            s_queue->Enqueue(request);
+            System::Threading::Monitor::Pulse(s_queue);
+        }
+        __finally
+        {
+            System::Threading::Monitor::Exit(s_queue);
+        }
+
+        return request;
+    }
+
+private:
+    static void Run()
+    {
+        for (;;)
+        {
+            Request^ request = nullptr;
+
+            System::Threading::Monitor::Enter(s_queue);
+
+            __try
+            {
+                while (s_queue->Count == 0)
+                {
+                    System::Threading::Monitor::Wait(s_queue);
+                }
+
+                request = safe_cast<Request^>(s_queue->Dequeue());
+            }
+            __finally
+            {
+                System::Threading::Monitor::Exit(s_queue);
+            }
+
+            try
+            {
+                request->hr = RasterizeBrushBand(
+                    request->bitmap,
+                    request->renderBounds,
+                    request->bounds,
+                    request->geometryBounds,
+                    request->brush,
+                    false,
+                    false,
+                    request->scaleX,
+                    request->scaleY,
+                    request->transform
+                    );
+            }
+            catch (Exception^ e)
+            {
+                request->exception = e;
+            }
+
+            request->done->Set();
+        }
+    }
+
+    static System::Collections::Queue ^ s_queue = gcnew System::Collections::Queue();
+    static Thread                     ^ s_thread;
+};
+
 void ClipToBounds(Int32Rect % bounds, int width, int height)
 {
     if (bounds.X < 0)
@@ -1992,7 +2866,8 @@ HRESULT CGDIRenderTarget::RasterizeShape(
             int bmpHeight = (int) Math::Round(bandBounds.Height / ScaleY);
 
             // Divide whole area into bands if the whole is too big (1600x1200 pixels)
-            int pixelLimit = RasterizeBandPixelLimit;
+            // Each band holds a Pbgra32 raster and its Bgr24 copy
+            int pixelLimit = Math::Max(1, s_bandMemoryBudget / (4 + 3));
 
             pixelLimit = (pixelLimit + bmpWidth - 1) / bmpWidth;
 
@@ -2003,6 +2878,101 @@ HRESULT CGDIRenderTarget::RasterizeShape(
 
             bandBounds.Height = nBandHeight;
 
+            //
+            // With more than one band, rasterize the next band on BandRasterizer while the
+            // current one is sent to the DC. The worker needs a frozen brush; brushes that
+            // can't be frozen (e.g. VisualBrush over live content) stay on this thread.
+            //
+            Brush^ frozenBrush = nullptr;
+
+            if (nBands > 1)
+            {
+                if (pFillBrush->IsFrozen)
+                {
+                    frozenBrush = pFillBrush;
+                }
+                else if (pFillBrush->CanFreeze)
+                {
+                    frozenBrush = safe_cast<Brush^>(pFillBrush->GetAsFrozen());
+                }
+            }
+
+            if (frozenBrush != nullptr)
+            {
+                BandRasterizer::Request^ pending = nullptr;
+
+                if (bandBounds.Height > nRemain)
+                {
+                    bandBounds.Height = nRemain;
+                }
+
+                BandRasterizer::Request^ request = gcnew BandRasterizer::Request();
+
+                request->renderBounds   = bandBounds;
+                request->bounds         = bounds;
+                request->geometryBounds = geometryBounds;
+                request->brush          = frozenBrush;
+                request->scaleX         = ScaleX;
+                request->scaleY         = ScaleY;
+                request->transform      = m_transform;
+
+                pending = BandRasterizer::Post(request);
+
+                while (pending != nullptr)
+                {
+                    BandRasterizer::Request^ current = pending;
+
+                    pending = nullptr;
+
+                    Int32Rect currentBounds = current->renderBounds;
+
+                    hr = current->Wait();
+
+                    nRemain -= currentBounds.Height;
+
+                    // Queue the next band before blitting this one
+                    if (SUCCEEDED(hr) && nRemain)
+                    {
+                        bandBounds.Y += bandBounds.Height;
+
+                        if (bandBounds.Height > nRemain)
+                        {
+                            bandBounds.Height = nRemain;
+                        }
+
+                        BandRasterizer::Request^ next = gcnew BandRasterizer::Request();
+
+                        next->renderBounds   = bandBounds;
+                        next->bounds         = bounds;
+                        next->geometryBounds = geometryBounds;
+                        next->brush          = frozenBrush;
+                        next->scaleX         = ScaleX;
+                        next->scaleY         = ScaleY;
+                        next->transform      = m_transform;
+
+                        pending = BandRasterizer::Post(next);
+                    }
+
+                    if (SUCCEEDED(hr))
+                    {
+                        CGDIBitmap gdiBitmap(current->bitmap);
+
+                        if (gdiBitmap.IsValid())
+                        {
+                            // Perform StretchDIBits of bitmap
+                            hr = gdiBitmap.StretchBlt(this, currentBounds, false, false);
+                        }
+                    }
+
+                    // Don't leave the worker rendering a band nobody will consume after an error
+                    if (FAILED(hr) && (pending != nullptr))
+                    {
+                        pending->Wait();
+                        pending = nullptr;
+                    }
+                }
+            }
+
             while (SUCCEEDED(hr) && nRemain)
             {
                 if (bandBounds.Height > nRemain)
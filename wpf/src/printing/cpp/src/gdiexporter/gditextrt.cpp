@@ -169,7 +169,13 @@ HRESULT CGDIRenderTarget::RenderGlyphRun(
         // prevent the string from moving around. we end up duplicating the string through
         // the array conversion, but it's needed to call win32 api
         glyphCount = pGlyphRun->Characters->Count;
-        array<Char> ^ characters = gcnew array<Char>(glyphCount);
+
+        if (m_glyphCharacters == nullptr || m_glyphCharacters->Length < glyphCount)
+        {
+            m_glyphCharacters = gcnew array<Char>(glyphCount);
+        }
+
+        array<Char> ^ characters = m_glyphCharacters;
         pGlyphRun->Characters->CopyTo(characters, 0);
 
         text = & characters[0];
@@ -177,13 +183,26 @@ HRESULT CGDIRenderTarget::RenderGlyphRun(
     else
     {
         glyphCount = pGlyphRun->GlyphIndices->Count;
-        array<unsigned short> ^ glyphIndices = gcnew array<unsigned short>(glyphCount);
+
+        if (m_glyphIndices == nullptr || m_glyphIndices->Length < glyphCount)
+        {
+            m_glyphIndices = gcnew array<unsigned short>(glyphCount);
+        }
+
+        array<unsigned short> ^ glyphIndices = m_glyphIndices;
         pGlyphRun->GlyphIndices->CopyTo(glyphIndices, 0);
 
         text = & glyphIndices[0];
     }
 
-    array<int> ^ dx = gcnew array<int>(glyphCount);
+    // Every entry used below is written before ExtTextOut reads it, so stale
+    // values from a previous run never reach GDI.
+    if (m_glyphDx == nullptr || m_glyphDx->Length < glyphCount)
+    {
+        m_glyphDx = gcnew array<int>(glyphCount);
+    }
+
+    array<int> ^ dx = m_glyphDx;
 
     System::Collections::Generic::IList<Point> ^ glyphOffsets = pGlyphRun->GlyphOffsets;    // Avalon units
 
@@ -498,16 +517,21 @@ Hashtable^ BuildFontList(String ^ fontdir)
 {
     Hashtable^ installedFonts = gcnew Hashtable();
 
-    // Acquire permissions to read the one key we care about from the registry
-    RegistryPermission^ permission = gcnew RegistryPermission(
+    // Acquire permissions to read the one key we care about from the registry, and to
+    // register for change notifications on it
+    PermissionSet^ permission = gcnew PermissionSet(PermissionState::None);
+
+    permission->AddPermission(gcnew RegistryPermission(
         RegistryPermissionAccess::Read,
-        "HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows NT\\CurrentVersion\\Fonts");
+        "HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows NT\\CurrentVersion\\Fonts"));
+
+    permission->AddPermission(gcnew SecurityPermission(SecurityPermissionFlag::UnmanagedCode));
 
     permission->Assert(); // Blessed assert
 
     try
     {
-        RegistryKey^ key = Registry::LocalMachine->OpenSubKey("Software\\Microsoft\\Windows NT\\CurrentVersion\\Fonts");
+        RegistryKey^ key = CGDIDevice::WatchFontsKey();
 
         // Permission is needed whenever key is accessed, so we can't move the look out of try block
 
@@ -567,14 +591,49 @@ Hashtable^ BuildFontList(String ^ fontdir)
     }
     finally
     {
-        permission->RevertAssert();
+        CodeAccessPermission::RevertAssert();
     }
 
     return installedFonts;
 }
 
 
-String ^ CGDIDevice::CheckFont(GlyphTypeface^ typeface, String ^ fontname, [Out] Boolean% isPrivateFont)
+/// <SecurityNote>
+/// Critical - Opens registry key and registers for change notification; caller asserts the permissions.
+/// </SecurityNote>
+RegistryKey^ CGDIDevice::WatchFontsKey()
+{
+    if (s_fontsKey == nullptr)
+    {
+        s_fontsKey     = Registry::LocalMachine->OpenSubKey("Software\\Microsoft\\Windows NT\\CurrentVersion\\Fonts");
+        s_fontsChanged = gcnew System::Threading::AutoResetEvent(false);
+    }
+
+    if (s_fontsKey != nullptr)
+    {
+        //
+        // Notification is one-shot, re-arm it for every rebuild. It's also signaled if the
+        // registering thread exits, which only costs an extra rebuild.
+        //
+        LONG error = CNativeMethods::RegNotifyChangeKeyValue(
+            s_fontsKey->Handle,
+            FALSE,
+            REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET,
+            s_fontsChanged->SafeWaitHandle,
+            TRUE);
+
+        if (error != ERROR_SUCCESS)
+        {
+            // Can't watch; fall back to the old behavior of building the list once
+            s_fontsChanged->Reset();
+        }
+    }
+
+    return s_fontsKey;
+}
+
+
+String ^ CGDIDevice::CheckFont(GlyphTypeface^ typeface, ICollection<unsigned short>^ glyphs, String ^ fontname, [Out] Boolean% isPrivateFont)
 {
     isPrivateFont = false;
 
@@ -582,9 +641,10 @@ String ^ CGDIDevice::CheckFont(GlyphTypeface^ typeface, String ^ fontname, [Out]
     {
         __try
         {
-            if (s_InstalledFonts == nullptr)
+            if (s_InstalledFonts == nullptr || (s_fontsChanged != nullptr && s_fontsChanged->WaitOne(0)))
             {
-                // Build a list of installed Windows font
+                // Build a list of installed Windows font, first time or after fonts were installed
+                // or removed since the list was built.
 
                 String ^ fontdir = GetFontDir();
 
@@ -595,7 +655,29 @@ String ^ CGDIDevice::CheckFont(GlyphTypeface^ typeface, String ^ fontname, [Out]
                     return nullptr;
                 }
 
-                s_InstalledFonts = BuildFontList(fontdir);
+                Hashtable^ installedFonts = BuildFontList(fontdir);
+
+                if (s_InstalledFonts != nullptr)
+                {
+                    // Font files may have been replaced in place
+                    FontIdentityIndex::Clear();
+
+                    // Keep entries with a private font installed, so it's still uninstalled later
+                    for each (System::Collections::DictionaryEntry entry in s_InstalledFonts)
+                    {
+                        FontInfo^ oldInfo = safe_cast<FontInfo^>(entry.Value);
+
+                        if (oldInfo->HasPrivateInstall)
+                        {
+                            FontInfo^ newInfo = dynamic_cast<FontInfo^>(installedFonts[entry.Key]);
+
+                            oldInfo->SetSystemInstall(newInfo);
+                            installedFonts[entry.Key] = oldInfo;
+                        }
+                    }
+                }
+
+                s_InstalledFonts = installedFonts;
             }
 
             // Get FontInfo entry for this name. Entry may not exist if there's
@@ -609,7 +691,7 @@ String ^ CGDIDevice::CheckFont(GlyphTypeface^ typeface, String ^ fontname, [Out]
             }
 
             // Install private font to override any system font with same name, if any.
-            if (info->UsePrivate(typeface))
+            if (info->UsePrivate(typeface, glyphs))
             {
                 if (info->NewFamilyName != nullptr)
                 {
@@ -711,7 +793,7 @@ GdiSafeHandle^ CGDIRenderTarget::CreateFont(
         fullName = familyName;
     }
 
-    String ^ newName = CheckFont(typeface, fullName, isPrivateFont);
+    String ^ newName = CheckFont(typeface, pGlyphRun->GlyphIndices, fullName, isPrivateFont);
 
     if (newName == nullptr)
     {
@@ -811,7 +893,7 @@ GdiSafeHandle^ CGDIRenderTarget::CreateFont(
 // Creates or retrieves a cached font, and caches it if needed.
 GdiSafeHandle^ CGDIRenderTarget::CreateFontCached(interior_ptr<ENUMLOGFONTEXDV> logfontdv)
 {
-    GdiSafeHandle^ result = CacheMatch((interior_ptr<Byte>) logfontdv, sizeof(ENUMLOGFONTEXDV));
+    GdiSafeHandle^ result = CacheMatch((interior_ptr<Byte>) logfontdv, sizeof(ENUMLOGFONTEXDV), OBJ_FONT);
     GdiSafeHandle^ firstAttempt = nullptr;
 
     if (result != nullptr)
@@ -892,7 +974,7 @@ GdiSafeHandle^ CGDIRenderTarget::CreateFontCached(interior_ptr<ENUMLOGFONTEXDV>
     {
         Debug::Assert(!result->IsClosed, "CreateFontCached must never return a closed handle");
         Debug::Assert(!result->IsInvalid, "CreateFontCached must never return an invalide handle");
-        CacheObject((interior_ptr<Byte>)&originalLogfontDv, sizeof(ENUMLOGFONTEXDV), result);
+        CacheObject((interior_ptr<Byte>)&originalLogfontDv, sizeof(ENUMLOGFONTEXDV), OBJ_FONT, result);
     }
 
     Debug::Assert(result != nullptr, "CreateFontCached must never return null");
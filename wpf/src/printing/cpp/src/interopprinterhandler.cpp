@@ -539,12 +539,49 @@ ThunkGetPrinter(
         UInt32   bytesNeeded     = 0;
         UInt32   byteCount       = 0;
         Boolean  returnValue     = false;
+        UInt32   bufferHint      = 0;
 
-        returnValue = UnsafeNativeMethods::InvokeGetPrinter(handle,
-                                                          level,
-                                                          SafeMemoryHandle::Null,
-                                                          0,
-                                                          &bytesNeeded);
+        if (getPrinterBufferHints == nullptr)
+        {
+            getPrinterBufferHints = gcnew array<UInt32>(10);
+        }
+
+        if (level < (UInt32)getPrinterBufferHints->Length)
+        {
+            bufferHint = getPrinterBufferHints[level];
+        }
+
+        //
+        // Refresh and Commit get the same levels over and over, and
+        // the size rarely changes in between. Start with the size of
+        // the previous result and only probe when it no longer fits.
+        //
+        if (bufferHint &&
+            SafeMemoryHandle::TryCreate(bufferHint, win32HeapBuffer))
+        {
+            returnValue = UnsafeNativeMethods::InvokeGetPrinter(handle,
+                                                              level,
+                                                              win32HeapBuffer,
+                                                              bufferHint,
+                                                              &bytesNeeded);
+
+            if (returnValue)
+            {
+                //this method takes ownership win32HeapBuffer
+                return GetManagedPrinterInfoObject(level, win32HeapBuffer, 1);
+            }
+
+            delete win32HeapBuffer;
+            win32HeapBuffer = nullptr;
+        }
+        else
+        {
+            returnValue = UnsafeNativeMethods::InvokeGetPrinter(handle,
+                                                              level,
+                                                              SafeMemoryHandle::Null,
+                                                              0,
+                                                              &bytesNeeded);
+        }
 
 
         InternalPrintSystemException::ThrowIfLastErrorIsNot(ERROR_INSUFFICIENT_BUFFER);
@@ -561,6 +598,11 @@ ThunkGetPrinter(
 
                 if (returnValue)
                 {
+                    if (level < (UInt32)getPrinterBufferHints->Length)
+                    {
+                        getPrinterBufferHints[level] = byteCount;
+                    }
+
                     //this method takes ownership win32HeapBuffer
                     printerInfo = GetManagedPrinterInfoObject(level, win32HeapBuffer, 1);
                 }
@@ -1545,19 +1587,55 @@ ThunkEnumJobs(
         Boolean               returnValue     = false;
         SafeMemoryHandle^     win32HeapBuffer = nullptr;
 
-        returnValue = UnsafeNativeMethods::InvokeEnumJobs(handle,
-                                                        firstJob,
-                                                        numberOfJobs,
-                                                        level,
-                                                        SafeMemoryHandle::Null,
-                                                        0,
-                                                        &bytesNeeded,
-                                                        &jobCount);
-
-        if (!returnValue)
+        //
+        // Successive enumerations of the same queue tend to need about the
+        // same amount of memory. Try the size of the previous result first
+        // and only fall back to probing when the jobs no longer fit.
+        //
+        if (enumJobsBufferHint &&
+            SafeMemoryHandle::TryCreate(enumJobsBufferHint, win32HeapBuffer))
         {
+            returnValue = UnsafeNativeMethods::InvokeEnumJobs(handle,
+                                                            firstJob,
+                                                            numberOfJobs,
+                                                            level,
+                                                            win32HeapBuffer,
+                                                            enumJobsBufferHint,
+                                                            &bytesNeeded,
+                                                            &jobCount);
+            if (returnValue)
+            {
+                if (bytesNeeded)
+                {
+                    enumJobsBufferHint = bytesNeeded;
+                }
+
+                // This method takes ownership handle
+                return GetManagedJobInfoObject(level,
+                                               win32HeapBuffer,
+                                               jobCount);
+            }
+
+            delete win32HeapBuffer;
+            win32HeapBuffer = nullptr;
             InternalPrintSystemException::ThrowIfLastErrorIsNot(ERROR_INSUFFICIENT_BUFFER);
         }
+        else
+        {
+            returnValue = UnsafeNativeMethods::InvokeEnumJobs(handle,
+                                                            firstJob,
+                                                            numberOfJobs,
+                                                            level,
+                                                            SafeMemoryHandle::Null,
+                                                            0,
+                                                            &bytesNeeded,
+                                                            &jobCount);
+
+            if (!returnValue)
+            {
+                InternalPrintSystemException::ThrowIfLastErrorIsNot(ERROR_INSUFFICIENT_BUFFER);
+            }
+        }
 
         if (byteCount = bytesNeeded)
         {
@@ -1573,6 +1651,8 @@ ThunkEnumJobs(
                                                                 &jobCount);
                 if (returnValue)
                 {
+                    enumJobsBufferHint = byteCount;
+
                    // This method takes ownership handle
                     printerInfoArray = GetManagedJobInfoObject(level,
                                                                win32HeapBuffer,
@@ -1987,19 +2067,67 @@ ThunkEnumPrinters(
         UInt32                printerCount    = 0;
         Boolean               returnValue     = false;
         SafeMemoryHandle^     win32HeapBuffer = nullptr;
+        array<UInt32>^        bufferHints     = enumPrintersBufferHints;
+        UInt32                bufferHint      = 0;
 
-        returnValue = UnsafeNativeMethods::InvokeEnumPrinters(flags,
-                                                            serverName,
-                                                            level,
-                                                            SafeMemoryHandle::Null,
-                                                            0,
-                                                            &bytesNeeded,
-                                                            &printerCount);
+        if (bufferHints == nullptr)
+        {
+            bufferHints = gcnew array<UInt32>(10);
+            enumPrintersBufferHints = bufferHints;
+        }
 
-        if (!returnValue)
+        if (level < (UInt32)bufferHints->Length)
+        {
+            bufferHint = bufferHints[level];
+        }
+
+        //
+        // Enumerating the same server again usually needs about as much
+        // memory as last time. Try that size first and only probe for
+        // the size when the printers no longer fit.
+        //
+        if (bufferHint &&
+            SafeMemoryHandle::TryCreate(bufferHint, win32HeapBuffer))
         {
+            returnValue = UnsafeNativeMethods::InvokeEnumPrinters(flags,
+                                                                serverName,
+                                                                level,
+                                                                win32HeapBuffer,
+                                                                bufferHint,
+                                                                &bytesNeeded,
+                                                                &printerCount);
+            if (returnValue)
+            {
+                if (bytesNeeded)
+                {
+                    bufferHints[level] = bytesNeeded;
+                }
+
+                //This method takes ownership win32HeapBuffer
+                return GetManagedPrinterInfoObject(level,
+                                                   win32HeapBuffer,
+                                                   printerCount);
+            }
+
+            delete win32HeapBuffer;
+            win32HeapBuffer = nullptr;
             InternalPrintSystemException::ThrowIfLastErrorIsNot(ERROR_INSUFFICIENT_BUFFER);
         }
+        else
+        {
+            returnValue = UnsafeNativeMethods::InvokeEnumPrinters(flags,
+                                                                serverName,
+                                                                level,
+                                                                SafeMemoryHandle::Null,
+                                                                0,
+                                                                &bytesNeeded,
+                                                                &printerCount);
+
+            if (!returnValue)
+            {
+                InternalPrintSystemException::ThrowIfLastErrorIsNot(ERROR_INSUFFICIENT_BUFFER);
+            }
+        }
 
         if (byteCount = bytesNeeded)
         {
@@ -2015,6 +2143,11 @@ ThunkEnumPrinters(
 
                 if (returnValue)
                 {
+                    if (level < (UInt32)bufferHints->Length)
+                    {
+                        bufferHints[level] = byteCount;
+                    }
+
                     //This method takes ownership win32HeapBuffer
                     printerInfoArray = GetManagedPrinterInfoObject(level,
                                                                    win32HeapBuffer,
@@ -66,10 +66,10 @@ noValueDelegatesTable(nullptr),
 valueLinkedDelegatesTable(nullptr),
 noValueLinkedDelegatesTable(nullptr)
 {
-    valueDelegatesTable           = gcnew Hashtable;
-    noValueDelegatesTable         = gcnew Hashtable;
-    valueLinkedDelegatesTable     = gcnew Hashtable;
-    noValueLinkedDelegatesTable   = gcnew Hashtable;
+    valueDelegatesTable           = gcnew System::Collections::Generic::Dictionary<Type^, PrintSystemObject::CreateWithValue^>;
+    noValueDelegatesTable         = gcnew System::Collections::Generic::Dictionary<Type^, PrintSystemObject::CreateWithNoValue^>;
+    valueLinkedDelegatesTable     = gcnew System::Collections::Generic::Dictionary<Type^, PrintSystemObject::CreateWithValueLinked^>;
+    noValueLinkedDelegatesTable   = gcnew System::Collections::Generic::Dictionary<Type^, PrintSystemObject::CreateWithNoValueLinked^>;
 }
 
 ObjectsAttributesValuesFactory::
@@ -227,7 +227,7 @@ RegisterObjectAttributeNoValueCreationMethod(
 {
     try
     {
-        noValueDelegatesTable->Add(type->FullName,
+        noValueDelegatesTable->Add(type,
                                    delegate);
     }
     catch(ArgumentException^)
@@ -248,7 +248,7 @@ RegisterObjectAttributeNoValueLinkedCreationMethod(
 {
     try
     {
-        noValueLinkedDelegatesTable->Add(type->FullName,
+        noValueLinkedDelegatesTable->Add(type,
                                          delegate);
     }
     catch(ArgumentException^)
@@ -269,7 +269,7 @@ RegisterObjectAttributeValueCreationMethod(
 {
     try
     {
-        valueDelegatesTable->Add(type->FullName,
+        valueDelegatesTable->Add(type,
                                  delegate);
     }
     catch(ArgumentException^)
@@ -290,7 +290,7 @@ RegisterObjectAttributeValueLinkedCreationMethod(
 {
     try
     {
-        valueLinkedDelegatesTable->Add(type->FullName,
+        valueLinkedDelegatesTable->Add(type,
                                        delegate);
     }
     catch(ArgumentException^)
@@ -310,8 +310,9 @@ Create(
     String^ attributeName
     )
 {
-    PrintSystemObject::CreateWithNoValue^ attributeValueDelegate =
-    (PrintSystemObject::CreateWithNoValue^)noValueDelegatesTable[type->FullName];
+    PrintSystemObject::CreateWithNoValue^ attributeValueDelegate = nullptr;
+
+    noValueDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attributeName);
 }
@@ -324,8 +325,9 @@ Create(
     Object^ attributeValue
     )
 {
-   PrintSystemObject::CreateWithValue^ attributeValueDelegate =
-    (PrintSystemObject::CreateWithValue^)valueDelegatesTable[type->FullName];
+    PrintSystemObject::CreateWithValue^ attributeValueDelegate = nullptr;
+
+    valueDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attributeName,attributeValue);
 }
@@ -338,8 +340,9 @@ Create(
     MulticastDelegate^  delegate
     )
 {
-   PrintSystemObject::CreateWithNoValueLinked^ attributeValueDelegate =
-    (PrintSystemObject::CreateWithNoValueLinked^)noValueLinkedDelegatesTable[type->FullName];
+    PrintSystemObject::CreateWithNoValueLinked^ attributeValueDelegate = nullptr;
+
+    noValueLinkedDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attributeName,delegate);
 }
@@ -353,8 +356,9 @@ Create(
     MulticastDelegate^  delegate
     )
 {
-    PrintSystemObject::CreateWithValueLinked^ attributeValueDelegate =
-    (PrintSystemObject::CreateWithValueLinked^)valueLinkedDelegatesTable[type->FullName];
+    PrintSystemObject::CreateWithValueLinked^ attributeValueDelegate = nullptr;
+
+    valueLinkedDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attributeName,attributeValue,delegate);
 }
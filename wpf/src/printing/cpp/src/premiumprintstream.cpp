@@ -171,6 +171,10 @@ InitializePrintStream(
     //
     accessVerifier = gcnew PrintSystemDispatcherObject();
 
+    writeQueue        = gcnew System::Collections::Queue();
+    writeWorkerActive = false;
+    maxPendingWrites  = defaultMaxPendingWrites;
+
     if (printQueue->InPartialTrust)
     {
         (gcnew PrintingPermission(PrintingPermissionLevel::DefaultPrinting))->Assert();
@@ -362,16 +366,150 @@ BeginWrite(
                                                           userCallBack,
                                                           stateObject);
 
-        Thread^ asyncWriteThread = gcnew Thread(gcnew ThreadStart(writeAsyncResult,
-                                                                &WritePrinterAsyncResult::AsyncWrite));
+        Boolean startWorker = false;
+
+        System::Threading::Monitor::Enter(writeQueue);
+
+        try
+        {
+            //
+            // Backpressure: don't let a fast producer queue up an unbounded amount of
+            // data in front of the spooler. A completion callback issuing the next
+            // BeginWrite runs on the worker itself and must not wait for it.
+            //
+            while (writeQueue->Count >= maxPendingWrites &&
+                   writeWorkerThread != Thread::CurrentThread)
+            {
+                System::Threading::Monitor::Wait(writeQueue);
+            }
+
+            writeQueue->Enqueue(writeAsyncResult);
 
-        asyncWriteThread->Start();
+            if (!writeWorkerActive)
+            {
+                writeWorkerActive = true;
+                startWorker       = true;
+            }
+        }
+        __finally
+        {
+            System::Threading::Monitor::Exit(writeQueue);
+        }
 
+        if (startWorker)
+        {
+            ThreadPool::QueueUserWorkItem(gcnew WaitCallback(this, &PrintQueueStream::DrainWriteQueue));
+        }
     }
 
     return writeAsyncResult;
 }
 
+void
+PrintQueueStream::
+DrainWriteQueue(
+    Object^ state
+    )
+{
+    for (;;)
+    {
+        WritePrinterAsyncResult^ writeAsyncResult = nullptr;
+
+        System::Threading::Monitor::Enter(writeQueue);
+
+        try
+        {
+            if (writeQueue->Count == 0)
+            {
+                writeWorkerThread = nullptr;
+                writeWorkerActive = false;
+                System::Threading::Monitor::PulseAll(writeQueue);
+                break;
+            }
+
+            //
+            // The request stays at the head of the queue while it is written so that
+            // Count reflects the writes in flight for backpressure and WaitForPendingWrites.
+            //
+            writeAsyncResult  = safe_cast<WritePrinterAsyncResult^>(writeQueue->Peek());
+            writeWorkerThread = Thread::CurrentThread;
+        }
+        __finally
+        {
+            System::Threading::Monitor::Exit(writeQueue);
+        }
+
+        writeAsyncResult->AsyncWrite();
+
+        System::Threading::Monitor::Enter(writeQueue);
+
+        try
+        {
+            writeQueue->Dequeue();
+            System::Threading::Monitor::PulseAll(writeQueue);
+        }
+        __finally
+        {
+            System::Threading::Monitor::Exit(writeQueue);
+        }
+    }
+}
+
+void
+PrintQueueStream::
+WaitForPendingWrites(
+    void
+    )
+{
+    System::Threading::Monitor::Enter(writeQueue);
+
+    try
+    {
+        while (writeWorkerActive &&
+               writeWorkerThread != Thread::CurrentThread)
+        {
+            System::Threading::Monitor::Wait(writeQueue);
+        }
+    }
+    __finally
+    {
+        System::Threading::Monitor::Exit(writeQueue);
+    }
+}
+
+Int32
+PrintQueueStream::MaxPendingWrites::
+get(
+    void
+    )
+{
+    return maxPendingWrites;
+}
+
+void
+PrintQueueStream::MaxPendingWrites::
+set(
+    Int32   value
+    )
+{
+    if (value < 1)
+    {
+        throw gcnew ArgumentOutOfRangeException("value");
+    }
+
+    System::Threading::Monitor::Enter(writeQueue);
+
+    try
+    {
+        maxPendingWrites = value;
+        System::Threading::Monitor::PulseAll(writeQueue);
+    }
+    __finally
+    {
+        System::Threading::Monitor::Exit(writeQueue);
+    }
+}
+
 void
 PrintQueueStream::
 EndWrite(
@@ -390,6 +528,14 @@ EndWrite(
     else
     {
         asyncResult->AsyncWaitHandle->WaitOne();
+
+        WritePrinterAsyncResult^ writeAsyncResult = dynamic_cast<WritePrinterAsyncResult^>(asyncResult);
+
+        if (writeAsyncResult != nullptr &&
+            writeAsyncResult->WriteException != nullptr)
+        {
+            throw writeAsyncResult->WriteException;
+        }
     }
 }
 
@@ -430,6 +576,11 @@ AbortOrCancel(
 {
     if (!this->streamClosed)
     {
+        //
+        // Let queued BeginWrite requests reach the spool file before the job is committed
+        //
+        WaitForPendingWrites();
+
         System::Threading::Monitor::Enter(accessVerifier);
 
         try
@@ -611,6 +762,8 @@ PrintQueueStream::
 Flush(
     )
 {
+    WaitForPendingWrites();
+
     if (!streamAborted)
     {
         printerThunkHandler->SpoolStream->Flush();
@@ -830,6 +983,15 @@ set(
     isCompleted = writeCompleted;
 }
 
+Exception^
+WritePrinterAsyncResult::WriteException::
+get(
+    void
+    )
+{
+    return writeException;
+}
+
 AsyncCallback^
 WritePrinterAsyncResult::AsyncCallBack::
 get(
@@ -845,9 +1007,19 @@ AsyncWrite(
     void
     )
 {
-    printStream->Write(this->dataArray,
-                       this->dataOffset,
-                       this->numberOfBytes);
+    try
+    {
+        printStream->Write(this->dataArray,
+                           this->dataOffset,
+                           this->numberOfBytes);
+    }
+    catch (Exception^ e)
+    {
+        //
+        // Surface the failure from EndWrite instead of tearing down the thread pool worker
+        //
+        writeException = e;
+    }
 
     this->IsCompleted = true;
 
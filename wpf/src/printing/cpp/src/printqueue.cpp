@@ -1124,6 +1124,12 @@ InternalDispose(
                 {
                     if (disposing)
                     {
+                        if (changeWatcher)
+                        {
+                            changeWatcher->Close();
+                            changeWatcher = nullptr;
+                        }
+
                         if (printerThunkHandler)
                         {
                             delete printerThunkHandler;
@@ -2042,13 +2048,8 @@ get(
         {
             if (userDevMode != nullptr)
             {
-                if (printTicketManager == nullptr)
-                {
-                    printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
-                }
-
                 PropertiesCollection->GetProperty("UserPrintTicket")->IsInternallyInitialized = true;
-                PropertiesCollection->GetProperty("UserPrintTicket")->Value = printTicketManager->ConvertDevModeToPrintTicket(userDevMode);
+                PropertiesCollection->GetProperty("UserPrintTicket")->Value = ConvertDevModeToPrintTicket(userDevMode);
                 delete userDevMode;
                 userDevMode = nullptr;
             }
@@ -2083,12 +2084,7 @@ set(
         //
         if(!PropertiesCollection->GetProperty("UserPrintTicket")->IsInternallyInitialized)
         {
-            if (printTicketManager == nullptr)
-            {
-                printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
-            }
-
-            array<Byte>^ devMode = printTicketManager->ConvertPrintTicketToDevMode(userPrintTicket, BaseDevModeType::UserDefault);
+            array<Byte>^ devMode = ConvertPrintTicketToDevMode(userPrintTicket, BaseDevModeType::UserDefault);
             get_InternalPropertiesCollection("UserDevMode")->GetProperty("UserDevMode")->Value = devMode;
         }
         //
@@ -2120,13 +2116,8 @@ get(
         {
             if (defaultDevMode != nullptr)
             {
-                if (printTicketManager == nullptr)
-                {
-                    printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
-                }
-
                 PropertiesCollection->GetProperty("DefaultPrintTicket")->IsInternallyInitialized = true;
-                PropertiesCollection->GetProperty("DefaultPrintTicket")->Value = printTicketManager->ConvertDevModeToPrintTicket(defaultDevMode);
+                PropertiesCollection->GetProperty("DefaultPrintTicket")->Value = ConvertDevModeToPrintTicket(defaultDevMode);
                 delete defaultDevMode;
                 defaultDevMode = nullptr;
             }
@@ -2163,12 +2154,7 @@ set(
 
         if(!PropertiesCollection->GetProperty("DefaultPrintTicket")->IsInternallyInitialized)
         {
-            if (printTicketManager == nullptr)
-            {
-                printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
-            }
-
-            array<Byte>^ devMode = printTicketManager->ConvertPrintTicketToDevMode(defaultPrintTicket, BaseDevModeType::PrinterDefault);
+            array<Byte>^ devMode = ConvertPrintTicketToDevMode(defaultPrintTicket, BaseDevModeType::PrinterDefault);
             get_InternalPropertiesCollection("DefaultDevMode")->GetProperty("DefaultDevMode")->Value = devMode;
         }
         //
@@ -2178,6 +2164,126 @@ set(
     }
 }
 
+/*++
+    Function Name:
+        ConvertDevModeToPrintTicket
+
+    Description:
+        Converts a DEVMODE to a PrintTicket through the PrintTicket provider,
+        reusing the result of an earlier conversion of identical DEVMODE bytes
+
+    Parameters:
+        devMode     - DEVMODE bytes to convert
+
+    Return Value
+        A PrintTicket the caller owns
+--*/
+PrintTicket^
+PrintQueue::
+ConvertDevModeToPrintTicket(
+    array<Byte>^    devMode
+    )
+{
+    if (printTicketXmlByDevMode == nullptr)
+    {
+        printTicketXmlByDevMode = gcnew System::Collections::Generic::Dictionary<String^, array<Byte>^>();
+    }
+
+    String^      key = Convert::ToBase64String(devMode);
+    array<Byte>^ printTicketXml = nullptr;
+
+    if (!printTicketXmlByDevMode->TryGetValue(key, printTicketXml))
+    {
+        if (printTicketManager == nullptr)
+        {
+            printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
+        }
+
+        PrintTicket^ printTicket = printTicketManager->ConvertDevModeToPrintTicket(devMode);
+
+        if (printTicketXmlByDevMode->Count >= maxTicketConversionCacheEntries)
+        {
+            printTicketXmlByDevMode->Clear();
+        }
+
+        printTicketXmlByDevMode[key] = printTicket->GetXmlStream()->ToArray();
+
+        return printTicket;
+    }
+
+    //
+    // Hand out a fresh PrintTicket every time; callers are free to modify it
+    //
+    return gcnew PrintTicket(gcnew MemoryStream(printTicketXml, false));
+}
+
+/*++
+    Function Name:
+        ConvertPrintTicketToDevMode
+
+    Description:
+        Converts a PrintTicket to a DEVMODE through the PrintTicket provider,
+        reusing the result of an earlier conversion of an identical PrintTicket
+
+    Parameters:
+        printTicket - PrintTicket to convert
+        baseType    - DEVMODE the PrintTicket settings are applied on top of
+
+    Return Value
+        DEVMODE bytes the caller owns
+--*/
+array<Byte>^
+PrintQueue::
+ConvertPrintTicketToDevMode(
+    PrintTicket^        printTicket,
+    BaseDevModeType     baseType
+    )
+{
+    if (devModeByPrintTicketXml == nullptr)
+    {
+        devModeByPrintTicketXml = gcnew System::Collections::Generic::Dictionary<String^, array<Byte>^>();
+    }
+
+    String^      key = baseType.ToString() + ":" + Convert::ToBase64String(printTicket->GetXmlStream()->ToArray());
+    array<Byte>^ devMode = nullptr;
+
+    if (!devModeByPrintTicketXml->TryGetValue(key, devMode))
+    {
+        if (printTicketManager == nullptr)
+        {
+            printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
+        }
+
+        devMode = printTicketManager->ConvertPrintTicketToDevMode(printTicket, baseType);
+
+        if (devModeByPrintTicketXml->Count >= maxTicketConversionCacheEntries)
+        {
+            devModeByPrintTicketXml->Clear();
+        }
+
+        devModeByPrintTicketXml[key] = devMode;
+    }
+
+    return safe_cast<array<Byte>^>(devMode->Clone());
+}
+
+void
+PrintQueue::
+ClearTicketConversionCache(
+    void
+    )
+{
+    if (printTicketXmlByDevMode != nullptr)
+    {
+        printTicketXmlByDevMode->Clear();
+    }
+
+    if (devModeByPrintTicketXml != nullptr)
+    {
+        devModeByPrintTicketXml->Clear();
+    }
+}
+
 PrintJobSettings^
 PrintQueue::CurrentJobSettings::
 get(
@@ -2192,6 +2298,33 @@ get(
     return _currentJobSettings;
 }
 
+Int32
+PrintQueue::XpsFontSubsettingPageCount::
+get(
+    void
+    )
+{
+    VerifyAccess();
+
+    return xpsFontSubsettingPageCount ? xpsFontSubsettingPageCount : defaultXpsFontSubsettingPageCount;
+}
+
+void
+PrintQueue::XpsFontSubsettingPageCount::
+set(
+    Int32 pageCount
+    )
+{
+    VerifyAccess();
+
+    if (pageCount < 1)
+    {
+        throw gcnew ArgumentOutOfRangeException("value");
+    }
+
+    xpsFontSubsettingPageCount = pageCount;
+}
+
 PrintDriver^
 PrintQueue::QueueDriver::
 get(
@@ -2214,6 +2347,15 @@ set(
 
     if(queueDriver != newDriver)
     {
+        //
+        // Conversions done against the old driver do not hold for the new one
+        //
+        if (queueDriver != nullptr &&
+            (newDriver == nullptr || !String::Equals(queueDriver->Name, newDriver->Name)))
+        {
+            ClearTicketConversionCache();
+        }
+
         queueDriver = newDriver;
         //
         // Set the value for downlevel thunking
@@ -3182,7 +3324,14 @@ get_InternalPropertiesCollection(
     String^ attributeName
     )
 {
-    return (PrintPropertyDictionary^)collectionsTable[attributeName];
+    Boolean isThunked = false;
+
+    if (!thunkedAttributeNames->TryGetValue(attributeName, isThunked))
+    {
+        return nullptr;
+    }
+
+    return isThunked ? thunkPropertiesCollection : PropertiesCollection;
 }
 
 /*++
@@ -3398,6 +3547,15 @@ Refresh(
 {
     VerifyAccess();
 
+    if (changeWatcher != nullptr)
+    {
+        //
+        // The spooler tells us what changed; only fetch that
+        //
+        ApplySpoolerChanges();
+        return;
+    }
+
     GetDataThunkObject^ dataThunkObject = nullptr;
 
     try
@@ -3430,138 +3588,400 @@ Refresh(
 
 /*++
     Function Name:
-        GetAllPropertiesFilter
+        RefreshPropertiesFilter
 
     Description:
-        The method populates a String Array of all
-        possible properties of the PrintQueue object.
+        The properties refreshed by Refresh. This is the filter
+        the queue was created with, plus the properties that were
+        fetched later on because they were read.
 
     Parameters:
         None
 
     Return Value
-        String[]:   All the properties supported by
-                    the PrintQueue
+        array<String^>^: The names of the properties
 --*/
 array<String^>^
-PrintQueue::
-GetAllPropertiesFilter(
+PrintQueue::RefreshPropertiesFilter::
+get(
     void
     )
 {
-    //
-    // Properties = Base Class Properties + Inherited Class Properties
-    //
-    array<String^>^ allPropertiesFilter = gcnew array<String^>(PrintSystemObject::BaseAttributeNames()->Length +
-                                                PrintQueue::primaryAttributeNames->Length);
+    return refreshPropertiesFilter;
+}
 
-    //
-    // First Add the Base Class Properties
-    //
-    for(Int32 numOfAttributes = 0;
-        numOfAttributes < PrintSystemObject::BaseAttributeNames()->Length;
-        numOfAttributes++)
-    {
-        allPropertiesFilter[numOfAttributes] = PrintSystemObject::BaseAttributeNames()[numOfAttributes];
-    }
+/*++
+    Function Name:
+        CanRefreshFromEnumeration
 
-    //
-    // Then Add the Inherited Class Properties
-    //
-    for(Int32 numOfAttributes = 0;
-        numOfAttributes < PrintQueue::primaryAttributeNames->Length;
-        numOfAttributes++)
-    {
-        String^ upLevelAttribute = nullptr;
+    Description:
+        Tells PrintServer::RefreshPrintQueues if this queue can
+        be refreshed from the data of a single enumeration of the
+        queues on its server.
 
-        if(String^ downLevelAttribute = (String^)(upLevelToDownLevelMapping
-                                        [upLevelAttribute = PrintQueue::primaryAttributeNames[numOfAttributes]]))
-        {
-            allPropertiesFilter[PrintSystemObject::BaseAttributeNames()->Length + numOfAttributes] = downLevelAttribute;
-        }
-        else
-        {
-            allPropertiesFilter[PrintSystemObject::BaseAttributeNames()->Length + numOfAttributes] = upLevelAttribute;
-        }
-    }
+    Parameters:
+        None
 
-    return allPropertiesFilter;
+    Return Value
+        Boolean: true if the queue can be refreshed that way
+--*/
+Boolean
+PrintQueue::CanRefreshFromEnumeration::
+get(
+    void
+    )
+{
+    return !IsDisposed        &&
+           !isBrowsable       &&
+           changeWatcher == nullptr;
 }
 
+/*++
+    Function Name:
+        EndRefreshFromEnumeration
+
+    Description:
+        Called once the properties of the queue were refreshed
+        from an enumeration. Does the part of Refresh that does
+        not come from the spooler data.
+
+    Parameters:
+        None
+
+    Return Value
+        None
+--*/
+void
+PrintQueue::
+EndRefreshFromEnumeration(
+    void
+    )
+{
+    //
+    // Making sure that the Full Name reflects the current name
+    //
+    fullQueueName = PrepareNameForDownLevelConnectivity(hostingPrintServer->Name,Name);
+}
 
 /*++
     Function Name:
-        GetAllPropertiesFilter
+        StartChangeNotifications
 
     Description:
-        The method populates a String Array of all
-        properties requested by a given filter. The
-        difference between the input and the returned,
-        is that I have to account for the downlevel
-        named properties used to thunk to the unmanaged
-        code.
+        Registers for spooler change notifications on this
+        queue and refreshes it once, so later Refresh calls
+        and SpoolerPropertiesChanged only deal with changes.
 
     Parameters:
-        String[]:   The proeprties asked for by the consumer
-                    through an input filter
+        None
 
     Return Value
-        String[]:   The properties both managed and unmanaged
-                    matching such input filter.
+        None
 --*/
-array<String^>^
+void
 PrintQueue::
-GetAllPropertiesFilter(
-    array<String^>^ propertiesFilter
+StartChangeNotifications(
+    void
     )
 {
-    if (propertiesFilter != nullptr)
-    {
-        array<String^>^ allPropertiesFilter = gcnew array<String^>(propertiesFilter->Length);
+    VerifyAccess();
 
-        for(Int32 numOfProperties = 0;
-            numOfProperties < propertiesFilter->Length;
-            numOfProperties++)
+    if (changeWatcher == nullptr)
+    {
+        try
         {
-            String^ upLevelAttribute = nullptr;
+            if (isBrowsable)
+            {
+                ActivateBrowsableQueue();
+                isBrowsable = false;
+            }
 
-            if(String^ downLevelAttribute = (String^)(upLevelToDownLevelMapping
-                                            [upLevelAttribute = propertiesFilter[numOfProperties]]))
+            PrintQueueChangeWatcher^ watcher = gcnew PrintQueueChangeWatcher(this,
+                                                                             printerThunkHandler,
+                                                                             accessVerifier->Dispatcher);
+
+            //
+            // Watching starts before this refresh so no change is missed
+            //
+            try
             {
-                allPropertiesFilter[numOfProperties] = downLevelAttribute;
+                Refresh();
             }
-            else
+            catch (...)
             {
-                allPropertiesFilter[numOfProperties] = upLevelAttribute;
+                watcher->Close();
+                throw;
             }
-        }
 
-        return allPropertiesFilter;
-    }
-    else
-    {
-        return GetAllPropertiesFilter();
+            changeWatcher = watcher;
+        }
+        catch (InternalPrintSystemException^ internalException)
+        {
+            throw CreatePrintQueueException(internalException->HResult, "PrintSystemException.PrintQueue.Refresh");
+        }
     }
-
-
 }
 
-
 /*++
     Function Name:
-        GetAlteredPropertiesFilter
+        StopChangeNotifications
 
     Description:
-        When properties are commited, those that only
-        changed from their initial values are committed.
-        It is the responsibility of this method to figure
-        out those properties that changed
+        Unregisters spooler change notifications. Refresh
+        goes back to fetching all refreshed properties.
 
     Parameters:
         None
 
     Return Value
-        String[]:   The properties that changed from their
+        None
+--*/
+void
+PrintQueue::
+StopChangeNotifications(
+    void
+    )
+{
+    VerifyAccess();
+
+    if (changeWatcher != nullptr)
+    {
+        changeWatcher->Close();
+        changeWatcher = nullptr;
+    }
+}
+
+/*++
+    Function Name:
+        ApplySpoolerChanges
+
+    Description:
+        Refreshes the properties the change watcher reported
+        as changed, limited to those in the refresh filter,
+        and raises SpoolerPropertiesChanged with their names.
+
+    Parameters:
+        None
+
+    Return Value
+        None
+--*/
+void
+PrintQueue::
+ApplySpoolerChanges(
+    void
+    )
+{
+    if (changeWatcher == nullptr || IsDisposed)
+    {
+        return;
+    }
+
+    bool            fullRefresh = false;
+    array<String^>^ changed     = changeWatcher->TakeChanges(fullRefresh);
+
+    array<String^>^ propertiesFilter = refreshPropertiesFilter;
+
+    if (!fullRefresh)
+    {
+        System::Collections::Generic::List<String^>^ filter = gcnew System::Collections::Generic::List<String^>(changed->Length);
+
+        for each (String^ propertyName in changed)
+        {
+            if (Array::IndexOf(refreshPropertiesFilter, propertyName) >= 0)
+            {
+                filter->Add(propertyName);
+            }
+        }
+
+        propertiesFilter = filter->ToArray();
+    }
+
+    if (propertiesFilter->Length == 0)
+    {
+        return;
+    }
+
+    GetDataThunkObject^ dataThunkObject = nullptr;
+
+    try
+    {
+        dataThunkObject = gcnew GetDataThunkObject(this->GetType());
+
+        dataThunkObject->PopulatePrintSystemObject(printerThunkHandler,
+                                                    this,
+                                                    propertiesFilter);
+
+        fullQueueName = PrepareNameForDownLevelConnectivity(hostingPrintServer->Name,Name);
+    }
+    catch (InternalPrintSystemException^ internalException)
+    {
+        throw CreatePrintQueueException(internalException->HResult, "PrintSystemException.PrintQueue.Refresh");
+    }
+    __finally
+    {
+        delete dataThunkObject;
+    }
+
+    //
+    // Report the names callers know, e.g. QueueStatus rather than Status
+    //
+    StringCollection^ propertiesNames = gcnew StringCollection();
+
+    for each (String^ propertyName in propertiesFilter)
+    {
+        Int32 mapping = Array::IndexOf(downLevelAttributeName, propertyName);
+
+        propertiesNames->Add((mapping >= 0) ? upLevelAttributeName[mapping] : propertyName);
+    }
+
+    OnPropertiesChanged(this, gcnew PrintSystemObjectPropertiesChangedEventArgs(propertiesNames));
+}
+
+void
+PrintQueue::
+OnPropertiesChanged(
+    PrintSystemObject^                            sender,
+    PrintSystemObjectPropertiesChangedEventArgs^  e
+    )
+{
+    SpoolerPropertiesChanged(sender, e);
+}
+
+/*++
+    Function Name:
+        GetAllPropertiesFilter
+
+    Description:
+        The method populates a String Array of all
+        possible properties of the PrintQueue object.
+
+    Parameters:
+        None
+
+    Return Value
+        String[]:   All the properties supported by
+                    the PrintQueue
+--*/
+array<String^>^
+PrintQueue::
+GetAllPropertiesFilter(
+    void
+    )
+{
+    //
+    // Properties = Base Class Properties + Inherited Class Properties
+    //
+    array<String^>^ allPropertiesFilter = gcnew array<String^>(PrintSystemObject::BaseAttributeNames()->Length +
+                                                PrintQueue::primaryAttributeNames->Length);
+
+    //
+    // First Add the Base Class Properties
+    //
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintSystemObject::BaseAttributeNames()->Length;
+        numOfAttributes++)
+    {
+        allPropertiesFilter[numOfAttributes] = PrintSystemObject::BaseAttributeNames()[numOfAttributes];
+    }
+
+    //
+    // Then Add the Inherited Class Properties
+    //
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintQueue::primaryAttributeNames->Length;
+        numOfAttributes++)
+    {
+        String^ upLevelAttribute = nullptr;
+
+        if(String^ downLevelAttribute = (String^)(upLevelToDownLevelMapping
+                                        [upLevelAttribute = PrintQueue::primaryAttributeNames[numOfAttributes]]))
+        {
+            allPropertiesFilter[PrintSystemObject::BaseAttributeNames()->Length + numOfAttributes] = downLevelAttribute;
+        }
+        else
+        {
+            allPropertiesFilter[PrintSystemObject::BaseAttributeNames()->Length + numOfAttributes] = upLevelAttribute;
+        }
+    }
+
+    return allPropertiesFilter;
+}
+
+
+/*++
+    Function Name:
+        GetAllPropertiesFilter
+
+    Description:
+        The method populates a String Array of all
+        properties requested by a given filter. The
+        difference between the input and the returned,
+        is that I have to account for the downlevel
+        named properties used to thunk to the unmanaged
+        code.
+
+    Parameters:
+        String[]:   The proeprties asked for by the consumer
+                    through an input filter
+
+    Return Value
+        String[]:   The properties both managed and unmanaged
+                    matching such input filter.
+--*/
+array<String^>^
+PrintQueue::
+GetAllPropertiesFilter(
+    array<String^>^ propertiesFilter
+    )
+{
+    if (propertiesFilter != nullptr)
+    {
+        array<String^>^ allPropertiesFilter = gcnew array<String^>(propertiesFilter->Length);
+
+        for(Int32 numOfProperties = 0;
+            numOfProperties < propertiesFilter->Length;
+            numOfProperties++)
+        {
+            String^ upLevelAttribute = nullptr;
+
+            if(String^ downLevelAttribute = (String^)(upLevelToDownLevelMapping
+                                            [upLevelAttribute = propertiesFilter[numOfProperties]]))
+            {
+                allPropertiesFilter[numOfProperties] = downLevelAttribute;
+            }
+            else
+            {
+                allPropertiesFilter[numOfProperties] = upLevelAttribute;
+            }
+        }
+
+        return allPropertiesFilter;
+    }
+    else
+    {
+        return GetAllPropertiesFilter();
+    }
+
+
+}
+
+
+/*++
+    Function Name:
+        GetAlteredPropertiesFilter
+
+    Description:
+        When properties are commited, those that only
+        changed from their initial values are committed.
+        It is the responsibility of this method to figure
+        out those properties that changed
+
+    Parameters:
+        None
+
+    Return Value
+        String[]:   The properties that changed from their
                     initial state
 
 --*/
@@ -3594,12 +4014,7 @@ GetAlteredPropertiesFilter(
         {
             PropertiesCollection->GetProperty("UserPrintTicket")->IsDirty = true;
 
-            if (printTicketManager == nullptr)
-            {
-                printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
-            }
-
-            array<Byte>^ devMode = printTicketManager->ConvertPrintTicketToDevMode(userPrintTicket, BaseDevModeType::UserDefault);
+            array<Byte>^ devMode = ConvertPrintTicketToDevMode(userPrintTicket, BaseDevModeType::UserDefault);
             get_InternalPropertiesCollection("UserDevMode")->GetProperty("UserDevMode")->Value = devMode;
         }
     }
@@ -3611,12 +4026,7 @@ GetAlteredPropertiesFilter(
         {
             PropertiesCollection->GetProperty("DefaultPrintTicket")->IsDirty = true;
 
-            if (printTicketManager == nullptr)
-            {
-                printTicketManager = gcnew PrintTicketManager(fullQueueName,clientPrintSchemaVersion);
-            }
-
-            array<Byte>^ devMode = printTicketManager->ConvertPrintTicketToDevMode(defaultPrintTicket, BaseDevModeType::PrinterDefault);
+            array<Byte>^ devMode = ConvertPrintTicketToDevMode(defaultPrintTicket, BaseDevModeType::PrinterDefault);
             get_InternalPropertiesCollection("DefaultDevMode")->GetProperty("DefaultDevMode")->Value = devMode;
         }
     }
@@ -3741,6 +4151,36 @@ RegisterAttributesNamesTypes(
         attributeNameTypes->Add(PrintQueue::secondaryAttributeNames[numOfAttributes],
                                 PrintQueue::secondaryAttributeTypes[numOfAttributes]);
     }
+
+    //
+    // Link every attribute name to the collection holding it, once for
+    // all instances rather than in every InitializeInternalCollections
+    //
+    System::Collections::Generic::
+    Dictionary<String^, Boolean>^   attributeCollections = gcnew System::Collections::Generic::Dictionary<String^, Boolean>();
+
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintSystemObject::BaseAttributeNames()->Length;
+        numOfAttributes++)
+    {
+        attributeCollections->Add(PrintSystemObject::BaseAttributeNames()[numOfAttributes], false);
+    }
+
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintQueue::primaryAttributeNames->Length;
+        numOfAttributes++)
+    {
+        attributeCollections->Add(PrintQueue::primaryAttributeNames[numOfAttributes], false);
+    }
+
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintQueue::secondaryAttributeNames->Length;
+        numOfAttributes++)
+    {
+        attributeCollections->Add(PrintQueue::secondaryAttributeNames[numOfAttributes], true);
+    }
+
+    thunkedAttributeNames = attributeCollections;
 }
 
 
@@ -3965,23 +4405,12 @@ InitializeInternalCollections(
 
     accessVerifier = gcnew PrintSystemDispatcherObject();
 
-    collectionsTable          = gcnew Hashtable();
     thunkPropertiesCollection = gcnew PrintPropertyDictionary();
     //
     // Initialize the PrintTickets held by the PrintQueue
     //
     InitializePrintTickets();
 
-    //
-    // Add the attributes from the base class to the appropriate collection
-    //
-    for(Int32 numOfBaseAttributes=0;
-        numOfBaseAttributes < PrintSystemObject::BaseAttributeNames()->Length;
-        numOfBaseAttributes++)
-    {
-        collectionsTable->Add(PrintSystemObject::BaseAttributeNames()[numOfBaseAttributes],PropertiesCollection);
-    }
-
     //
     // Override the set_Name property in the base class
     //
@@ -4007,10 +4436,6 @@ InitializeInternalCollections(
                                                       propertiesDelegates[numOfPrimaryAttributes]);
 
         PrintSystemObject::PropertiesCollection->Add(printSystemAttributeValue);
-        //
-        // The following links an attribute name to a collection
-        //
-        collectionsTable->Add(PrintQueue::primaryAttributeNames[numOfPrimaryAttributes],PropertiesCollection);
     }
 
     //
@@ -4028,10 +4453,6 @@ InitializeInternalCollections(
                                                       propertiesDelegates[numOfPrimaryAttributes + numOfSecondaryAttributes]);
 
         thunkPropertiesCollection->Add(printSystemAttributeValue);
-        //
-        // The following links an attribute name to a collection
-        //
-        collectionsTable->Add(PrintQueue::secondaryAttributeNames[numOfSecondaryAttributes],thunkPropertiesCollection);
     }
 }
 
@@ -4602,10 +5023,11 @@ CreateSerializationManager(
         //
         // Quearies to ISV's has identified four pages as the optimal page batch size
         // This sacrifices best case savings of font subsetting vs.
-        // memory foot print of accumlating page data to discover font subsets
+        // memory foot print of accumlating page data to discover font subsets.
+        // Callers streaming very long jobs can lower it down to a single page.
         //
         xpsSerializationManager->SetFontSubsettingPolicy(FontSubsetterCommitPolicies::CommitPerPage );
-        xpsSerializationManager->SetFontSubsettingCountPolicy(4);
+        xpsSerializationManager->SetFontSubsettingCountPolicy(XpsFontSubsettingPageCount);
         serializationManager = xpsSerializationManager;
 
         if(serializationManager != nullptr)
@@ -4753,10 +5175,11 @@ CreateAsyncSerializationManager(
         //
         // Quearies to ISV's has identified four pages as the optimal page batch size
         // This sacrifices best case savings of font subsetting vs.
-        // memory foot print of accumlating page data to discover font subsets
+        // memory foot print of accumlating page data to discover font subsets.
+        // Callers streaming very long jobs can lower it down to a single page.
         //
         xpsSerializationManagerAsync->SetFontSubsettingPolicy(FontSubsetterCommitPolicies::CommitPerPage );
-        xpsSerializationManagerAsync->SetFontSubsettingCountPolicy(4);
+        xpsSerializationManagerAsync->SetFontSubsettingCountPolicy(XpsFontSubsettingPageCount);
 
         serializationManager = xpsSerializationManagerAsync;
 
@@ -6030,3 +6453,442 @@ VerifyAccess(
 }
 
 
+
+/*--------------------------------------------------------------------------------------*/
+/*                        PrintQueueChangeWatcher Implementation                        */
+/*--------------------------------------------------------------------------------------*/
+
+/*++
+    Function Name:
+        PrintQueueChangeWatcher
+
+    Description:
+        Registers for PRINTER_NOTIFY_TYPE field notifications on
+        the print queue and adds the watcher to a wait thread.
+
+    Parameters:
+        PrintQueue:             Queue that gets refreshed on changes
+        PrinterThunkHandler:    Open printer handle of the queue
+        Dispatcher:             Dispatcher of the queue's owning thread
+
+    Return Value
+        None
+--*/
+PrintQueueChangeWatcher::
+PrintQueueChangeWatcher(
+    PrintQueue^                                             printQueue,
+    MS::Internal::PrintWin32Thunk::PrinterThunkHandler^     printerHandler,
+    System::Windows::Threading::Dispatcher^                 dispatcher
+    ) :
+queue(printQueue),
+queueDispatcher(dispatcher),
+changeHandle(IntPtr(INVALID_HANDLE_VALUE)),
+syncRoot(gcnew Object()),
+changedProperties(gcnew System::Collections::Generic::Dictionary<String^, bool>())
+{
+    //
+    // Ask for every field we map to a property
+    //
+    WORD fields[] =
+    {
+        PRINTER_NOTIFY_FIELD_SERVER_NAME,
+        PRINTER_NOTIFY_FIELD_PRINTER_NAME,
+        PRINTER_NOTIFY_FIELD_SHARE_NAME,
+        PRINTER_NOTIFY_FIELD_PORT_NAME,
+        PRINTER_NOTIFY_FIELD_DRIVER_NAME,
+        PRINTER_NOTIFY_FIELD_COMMENT,
+        PRINTER_NOTIFY_FIELD_LOCATION,
+        PRINTER_NOTIFY_FIELD_DEVMODE,
+        PRINTER_NOTIFY_FIELD_SEPFILE,
+        PRINTER_NOTIFY_FIELD_PRINT_PROCESSOR,
+        PRINTER_NOTIFY_FIELD_ATTRIBUTES,
+        PRINTER_NOTIFY_FIELD_PRIORITY,
+        PRINTER_NOTIFY_FIELD_DEFAULT_PRIORITY,
+        PRINTER_NOTIFY_FIELD_START_TIME,
+        PRINTER_NOTIFY_FIELD_UNTIL_TIME,
+        PRINTER_NOTIFY_FIELD_STATUS,
+        PRINTER_NOTIFY_FIELD_CJOBS,
+        PRINTER_NOTIFY_FIELD_AVERAGE_PPM
+    };
+
+    PRINTER_NOTIFY_OPTIONS_TYPE notifyType;
+
+    notifyType.Type      = PRINTER_NOTIFY_TYPE;
+    notifyType.Reserved0 = 0;
+    notifyType.Reserved1 = 0;
+    notifyType.Reserved2 = 0;
+    notifyType.Count     = sizeof(fields) / sizeof(fields[0]);
+    notifyType.pFields   = fields;
+
+    PRINTER_NOTIFY_OPTIONS notifyOptions;
+
+    notifyOptions.Version = 2;
+    notifyOptions.Flags   = 0;
+    notifyOptions.Count   = 1;
+    notifyOptions.pTypes  = &notifyType;
+
+    bool addedRef = false;
+
+    printerHandler->DangerousAddRef(addedRef);
+
+    try
+    {
+        changeHandle = UnsafeNativeMethods::InvokeFindFirstPrinterChangeNotification(printerHandler->DangerousGetHandle(),
+                                                                                     0,
+                                                                                     0,
+                                                                                     IntPtr(&notifyOptions));
+        if (changeHandle == IntPtr(INVALID_HANDLE_VALUE))
+        {
+            InternalPrintSystemException::ThrowLastError();
+        }
+    }
+    catch (...)
+    {
+        if (addedRef)
+        {
+            printerHandler->DangerousRelease();
+        }
+
+        throw;
+    }
+
+    printerThunkHandler = printerHandler;
+    waitHandle          = gcnew ChangeWaitHandle(changeHandle);
+
+    Monitor::Enter(groupsLock);
+
+    try
+    {
+        for each (WaitGroup^ group in groups)
+        {
+            if (group->watchers->Count < MaximumWatchersPerThread)
+            {
+                waitGroup = group;
+                break;
+            }
+        }
+
+        if (waitGroup == nullptr)
+        {
+            waitGroup = gcnew WaitGroup();
+            groups->Add(waitGroup);
+
+            Thread^ thread = gcnew Thread(gcnew ParameterizedThreadStart(&PrintQueueChangeWatcher::WaitGroupThread));
+
+            thread->IsBackground = true;
+            thread->Name         = "PrintQueue change notifications";
+            thread->Start(waitGroup);
+        }
+
+        waitGroup->watchers->Add(this);
+        waitGroup->wake->Set();
+    }
+    __finally
+    {
+        Monitor::Exit(groupsLock);
+    }
+}
+
+void
+PrintQueueChangeWatcher::
+Close(
+    void
+    )
+{
+    Monitor::Enter(syncRoot);
+
+    try
+    {
+        if (isClosed)
+        {
+            return;
+        }
+
+        isClosed = true;
+    }
+    __finally
+    {
+        Monitor::Exit(syncRoot);
+    }
+
+    Monitor::Enter(groupsLock);
+
+    try
+    {
+        waitGroup->watchers->Remove(this);
+        waitGroup->closing->Add(this);
+        waitGroup->wake->Set();
+    }
+    __finally
+    {
+        Monitor::Exit(groupsLock);
+    }
+}
+
+array<String^>^
+PrintQueueChangeWatcher::
+TakeChanges(
+    bool%   fullRefresh
+    )
+{
+    Monitor::Enter(syncRoot);
+
+    try
+    {
+        array<String^>^ changed = gcnew array<String^>(changedProperties->Count);
+
+        changedProperties->Keys->CopyTo(changed, 0);
+        changedProperties->Clear();
+
+        fullRefresh = changesLost;
+        changesLost = false;
+        applyPosted = false;
+
+        return changed;
+    }
+    __finally
+    {
+        Monitor::Exit(syncRoot);
+    }
+}
+
+void
+PrintQueueChangeWatcher::
+AddChangedField(
+    unsigned short  field
+    )
+{
+    if (field < fieldProperties->Length && fieldProperties[field] != nullptr)
+    {
+        for each (String^ propertyName in fieldProperties[field])
+        {
+            changedProperties[propertyName] = true;
+        }
+    }
+}
+
+/*++
+    Function Name:
+        OnSignaled
+
+    Description:
+        Reads the PRINTER_NOTIFY_INFO for the signaled change
+        handle, records the changed properties and posts a
+        refresh to the queue's thread if none is pending.
+
+    Parameters:
+        None
+
+    Return Value
+        None
+--*/
+void
+PrintQueueChangeWatcher::
+OnSignaled(
+    void
+    )
+{
+    DWORD   change     = 0;
+    IntPtr  notifyInfo = IntPtr::Zero;
+    bool    succeeded  = UnsafeNativeMethods::InvokeFindNextPrinterChangeNotification(changeHandle,
+                                                                                     &change,
+                                                                                     IntPtr::Zero,
+                                                                                     &notifyInfo);
+    bool    post       = false;
+
+    Monitor::Enter(syncRoot);
+
+    try
+    {
+        PRINTER_NOTIFY_INFO* info = reinterpret_cast<PRINTER_NOTIFY_INFO*>(notifyInfo.ToPointer());
+
+        if (!succeeded || info == NULL || (info->Flags & PRINTER_NOTIFY_INFO_DISCARDED))
+        {
+            //
+            // We don't know what changed
+            //
+            changesLost = true;
+        }
+        else
+        {
+            for (DWORD index = 0; index < info->Count; index++)
+            {
+                if (info->aData[index].Type == PRINTER_NOTIFY_TYPE)
+                {
+                    AddChangedField(info->aData[index].Field);
+                }
+            }
+        }
+
+        if ((changesLost || changedProperties->Count > 0) && !applyPosted && !isClosed)
+        {
+            applyPosted = true;
+            post        = true;
+        }
+    }
+    __finally
+    {
+        Monitor::Exit(syncRoot);
+    }
+
+    if (notifyInfo != IntPtr::Zero)
+    {
+        PRINTER_NOTIFY_INFO* info = reinterpret_cast<PRINTER_NOTIFY_INFO*>(notifyInfo.ToPointer());
+
+        if (info->Flags & PRINTER_NOTIFY_INFO_DISCARDED)
+        {
+            //
+            // Reset the discarded state; everything is refreshed anyway
+            //
+            PRINTER_NOTIFY_OPTIONS refreshOptions;
+
+            refreshOptions.Version = 2;
+            refreshOptions.Flags   = PRINTER_NOTIFY_OPTIONS_REFRESH;
+            refreshOptions.Count   = 0;
+            refreshOptions.pTypes  = NULL;
+
+            IntPtr refreshInfo = IntPtr::Zero;
+
+            if (UnsafeNativeMethods::InvokeFindNextPrinterChangeNotification(changeHandle,
+                                                                            &change,
+                                                                            IntPtr(&refreshOptions),
+                                                                            &refreshInfo) &&
+                refreshInfo != IntPtr::Zero)
+            {
+                UnsafeNativeMethods::InvokeFreePrinterNotifyInfo(refreshInfo);
+            }
+        }
+
+        UnsafeNativeMethods::InvokeFreePrinterNotifyInfo(notifyInfo);
+    }
+
+    if (post && queueDispatcher != nullptr)
+    {
+        queueDispatcher->BeginInvoke(System::Windows::Threading::DispatcherPriority::Background,
+                                     gcnew Action(this, &PrintQueueChangeWatcher::ApplyOnQueueThread));
+    }
+}
+
+void
+PrintQueueChangeWatcher::
+ApplyOnQueueThread(
+    void
+    )
+{
+    try
+    {
+        queue->ApplySpoolerChanges();
+    }
+    catch (PrintQueueException^)
+    {
+        //
+        // Nobody to report to on the dispatcher; the next Refresh fetches everything
+        //
+        Monitor::Enter(syncRoot);
+        changesLost = true;
+        Monitor::Exit(syncRoot);
+    }
+}
+
+void
+PrintQueueChangeWatcher::
+ReleaseHandle(
+    void
+    )
+{
+    UnsafeNativeMethods::InvokeFindClosePrinterChangeNotification(changeHandle);
+    changeHandle = IntPtr(INVALID_HANDLE_VALUE);
+
+    printerThunkHandler->DangerousRelease();
+    printerThunkHandler = nullptr;
+}
+
+/*++
+    Function Name:
+        WaitGroupThread
+
+    Description:
+        Waits on the change handles of a group of watchers and
+        dispatches signaled ones. Change handles of closed
+        watchers are released here, once they're no longer
+        waited on. The thread exits when its group empties.
+
+    Parameters:
+        Object:     The WaitGroup
+
+    Return Value
+        None
+--*/
+void
+PrintQueueChangeWatcher::
+WaitGroupThread(
+    Object^ groupObject
+    )
+{
+    WaitGroup^                          group       = safe_cast<WaitGroup^>(groupObject);
+    array<PrintQueueChangeWatcher^>^    watchers    = nullptr;
+    array<WaitHandle^>^                 waitHandles = nullptr;
+
+    for (;;)
+    {
+        if (watchers == nullptr)
+        {
+            array<PrintQueueChangeWatcher^>^ closing = nullptr;
+
+            Monitor::Enter(groupsLock);
+
+            try
+            {
+                closing = group->closing->ToArray();
+                group->closing->Clear();
+
+                watchers = group->watchers->ToArray();
+
+                if (watchers->Length == 0)
+                {
+                    groups->Remove(group);
+                }
+            }
+            __finally
+            {
+                Monitor::Exit(groupsLock);
+            }
+
+            for each (PrintQueueChangeWatcher^ watcher in closing)
+            {
+                watcher->ReleaseHandle();
+            }
+
+            if (watchers->Length == 0)
+            {
+                return;
+            }
+
+            waitHandles    = gcnew array<WaitHandle^>(watchers->Length + 1);
+            waitHandles[0] = group->wake;
+
+            for (Int32 index = 0; index < watchers->Length; index++)
+            {
+                waitHandles[index + 1] = watchers[index]->waitHandle;
+            }
+        }
+
+        Int32 signaled = WaitHandle::WaitAny(waitHandles);
+
+        if (signaled == 0)
+        {
+            watchers = nullptr;     // group changed
+        }
+        else
+        {
+            try
+            {
+                watchers[signaled - 1]->OnSignaled();
+            }
+            catch (InvalidOperationException^)
+            {
+                // Dispatcher shut down; nobody is left to refresh
+            }
+        }
+    }
+}
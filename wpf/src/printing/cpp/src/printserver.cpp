@@ -70,6 +70,10 @@ using namespace System::Printing;
 #include <SetDataThunkObject.hpp>
 #endif
 
+#ifndef  __ENUMDATATHUNKOBJECT_HPP__
+#include <EnumDataThunkObject.hpp>
+#endif
+
 
 using namespace MS::Internal;
 using namespace MS::Internal::PrintWin32Thunk::DirectInteropForPrintQueue;
@@ -1067,6 +1071,128 @@ GetPrintQueues(
 
 /*++
 
+Routine Name:
+
+    RefreshPrintQueues
+
+Routine Description:
+
+    Refreshes the given PrintQueue objects from one enumeration of the
+    queues on this server, instead of a GetPrinter call per queue. The
+    enumeration only covers the levels needed by the union of the refresh
+    filters of the queues. Queues that can't be refreshed this way, or
+    that are not found in the enumeration, are refreshed individually.
+
+Arguments:
+
+    printQueues - the queues to be refreshed
+
+Return Value:
+
+    None
+
+--*/
+void
+PrintServer::
+RefreshPrintQueues(
+    System::Collections::Generic::IEnumerable<PrintQueue^>^  printQueues
+    )
+{
+    VerifyAccess();
+
+    if (printQueues == nullptr)
+    {
+        throw gcnew ArgumentNullException("printQueues");
+    }
+
+    System::Collections::Generic::
+    Dictionary<String^, PrintQueue^>^   printQueuesByName   = gcnew System::Collections::Generic::
+                                                              Dictionary<String^, PrintQueue^>(StringComparer::OrdinalIgnoreCase);
+    System::Collections::Generic::
+    List<PrintQueue^>^                  refreshedQueues     = gcnew System::Collections::Generic::List<PrintQueue^>();
+    System::Collections::Generic::
+    List<PrintQueue^>^                  individualQueues    = gcnew System::Collections::Generic::List<PrintQueue^>();
+    System::Collections::Generic::
+    List<String^>^                      propertyFilter      = gcnew System::Collections::Generic::List<String^>();
+
+    propertyFilter->Add("Name");
+
+    for each (PrintQueue^ printQueue in printQueues)
+    {
+        if (printQueue == nullptr)
+        {
+            continue;
+        }
+
+        if (!printQueue->CanRefreshFromEnumeration ||
+            String::Compare(printQueue->HostingPrintServer->Name, Name, StringComparison::OrdinalIgnoreCase) != 0 ||
+            printQueuesByName->ContainsKey(printQueue->Name))
+        {
+            individualQueues->Add(printQueue);
+            continue;
+        }
+
+        printQueuesByName->Add(printQueue->Name, printQueue);
+        refreshedQueues->Add(printQueue);
+
+        for each (String^ propertyName in printQueue->RefreshPropertiesFilter)
+        {
+            if (!propertyFilter->Contains(propertyName))
+            {
+                propertyFilter->Add(propertyName);
+            }
+        }
+    }
+
+    if (printQueuesByName->Count > 0)
+    {
+        EnumDataThunkObject^ enumDataThunkObject = nullptr;
+
+        try
+        {
+            array<EnumeratedPrintQueueTypes>^ enumerationFlag = {EnumeratedPrintQueueTypes::Local,
+                                                                 EnumeratedPrintQueueTypes::Connections};
+
+            enumDataThunkObject = gcnew EnumDataThunkObject(System::Printing::PrintQueue::typeid);
+
+            enumDataThunkObject->RefreshPrintSystemValuesPerPrintQueues(this,
+                                                                        enumerationFlag,
+                                                                        printQueuesByName,
+                                                                        propertyFilter->ToArray());
+        }
+        catch (InternalPrintSystemException^ internalException)
+        {
+            throw CreatePrintServerException(internalException->HResult, "PrintSystemException.PrintQueues.Enumerate");
+        }
+        __finally
+        {
+            delete enumDataThunkObject;
+        }
+
+        //
+        // Whatever is left in the table was not enumerated
+        //
+        for each (PrintQueue^ printQueue in refreshedQueues)
+        {
+            if (printQueuesByName->ContainsKey(printQueue->Name))
+            {
+                individualQueues->Add(printQueue);
+            }
+            else
+            {
+                printQueue->EndRefreshFromEnumeration();
+            }
+        }
+    }
+
+    for each (PrintQueue^ printQueue in individualQueues)
+    {
+        printQueue->Refresh();
+    }
+}
+
+/*++
+
 Routine Name:
 
     Commit
@@ -52,10 +52,10 @@ noValueDelegatesTable(nullptr),
 valueLinkedDelegatesTable(nullptr),
 noValueLinkedDelegatesTable(nullptr)
 {
-    if(!((valueDelegatesTable           = gcnew Hashtable) &&
-         (noValueDelegatesTable         = gcnew Hashtable) &&
-         (valueLinkedDelegatesTable     = gcnew Hashtable) &&
-         (noValueLinkedDelegatesTable   = gcnew Hashtable)))
+    if(!((valueDelegatesTable           = gcnew System::Collections::Generic::Dictionary<Type^, PrintProperty::CreateWithValue^>) &&
+         (noValueDelegatesTable         = gcnew System::Collections::Generic::Dictionary<Type^, PrintProperty::CreateWithNoValue^>) &&
+         (valueLinkedDelegatesTable     = gcnew System::Collections::Generic::Dictionary<Type^, PrintProperty::CreateWithValueLinked^>) &&
+         (noValueLinkedDelegatesTable   = gcnew System::Collections::Generic::Dictionary<Type^, PrintProperty::CreateWithNoValueLinked^>)))
     {
     }
 }
@@ -154,7 +154,7 @@ RegisterValueCreationDelegate(
 {
     try
     {
-        valueDelegatesTable->Add(type->FullName,
+        valueDelegatesTable->Add(type,
                                  delegate);
     }
     catch(ArgumentException^)
@@ -175,7 +175,7 @@ RegisterNoValueCreationDelegate(
 {
     try
     {
-        noValueDelegatesTable->Add(type->FullName,
+        noValueDelegatesTable->Add(type,
                                    delegate);
     }
     catch(ArgumentException^)
@@ -196,7 +196,7 @@ RegisterValueLinkedCreationDelegate(
 {
     try
     {
-        valueLinkedDelegatesTable->Add(type->FullName,
+        valueLinkedDelegatesTable->Add(type,
                                        delegate);
     }
     catch(ArgumentException^)
@@ -217,7 +217,7 @@ RegisterNoValueLinkedCreationDelegate(
 {
     try
     {
-        noValueLinkedDelegatesTable->Add(type->FullName,
+        noValueLinkedDelegatesTable->Add(type,
                                          delegate);
     }
     catch(ArgumentException^)
@@ -235,7 +235,7 @@ UnRegisterValueCreationDelegate(
     Type^   type
     )
 {
-    valueDelegatesTable->Remove(type->FullName);
+    valueDelegatesTable->Remove(type);
 }
 
 void
@@ -244,7 +244,7 @@ UnRegisterNoValueCreationDelegate(
     Type^   type
     )
 {
-    noValueDelegatesTable->Remove(type->FullName);
+    noValueDelegatesTable->Remove(type);
 }
 
 void
@@ -253,7 +253,7 @@ UnRegisterValueLinkedCreationDelegate(
     Type^   type
     )
 {
-    valueLinkedDelegatesTable->Remove(type->FullName);
+    valueLinkedDelegatesTable->Remove(type);
 }
 
 void
@@ -262,7 +262,7 @@ UnRegisterNoValueLinkedCreationDelegate(
     Type^   type
     )
 {
-    noValueLinkedDelegatesTable->Remove(type->FullName);
+    noValueLinkedDelegatesTable->Remove(type);
 }
 
 PrintProperty^
@@ -272,8 +272,9 @@ Create(
     String^ attribName
     )
 {
-    PrintProperty::CreateWithNoValue^ attributeValueDelegate =
-    (PrintProperty::CreateWithNoValue^)noValueDelegatesTable[type->FullName];
+    PrintProperty::CreateWithNoValue^ attributeValueDelegate = nullptr;
+
+    noValueDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attribName);
 }
@@ -286,8 +287,9 @@ Create(
     Object^ attribValue
     )
 {
-    PrintProperty::CreateWithValue^ attributeValueDelegate =
-    (PrintProperty::CreateWithValue^)valueDelegatesTable[type->FullName];
+    PrintProperty::CreateWithValue^ attributeValueDelegate = nullptr;
+
+    valueDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attribName,attribValue);
 }
@@ -300,8 +302,9 @@ Create(
     MulticastDelegate^      delegate
     )
 {
-    PrintProperty::CreateWithNoValueLinked^ attributeValueDelegate =
-    (PrintProperty::CreateWithNoValueLinked^)noValueLinkedDelegatesTable[type->FullName];
+    PrintProperty::CreateWithNoValueLinked^ attributeValueDelegate = nullptr;
+
+    noValueLinkedDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attribName,delegate);
 }
@@ -315,8 +318,9 @@ Create(
     MulticastDelegate^  delegate
     )
 {
-    PrintProperty::CreateWithValueLinked^ attributeValueDelegate =
-    (PrintProperty::CreateWithValueLinked^)valueLinkedDelegatesTable[type->FullName];
+    PrintProperty::CreateWithValueLinked^ attributeValueDelegate = nullptr;
+
+    valueLinkedDelegatesTable->TryGetValue(type, attributeValueDelegate);
 
     return attributeValueDelegate->Invoke(attribName,attribValue,delegate);
 }
@@ -1219,6 +1219,36 @@ RegisterAttributesNamesTypes(
         attributeNameTypes->Add(PrintSystemJobInfo::secondaryAttributeNames[numOfAttributes],
                                 PrintSystemJobInfo::secondaryAttributeTypes[numOfAttributes]);
     }
+
+    //
+    // Link every attribute name to the collection holding it, once for
+    // all instances rather than in every InitializeInternalCollections
+    //
+    System::Collections::Generic::
+    Dictionary<String^, Boolean>^   attributeCollections = gcnew System::Collections::Generic::Dictionary<String^, Boolean>();
+
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintSystemObject::BaseAttributeNames()->Length;
+        numOfAttributes++)
+    {
+        attributeCollections->Add(PrintSystemObject::BaseAttributeNames()[numOfAttributes], false);
+    }
+
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintSystemJobInfo::primaryAttributeNames->Length;
+        numOfAttributes++)
+    {
+        attributeCollections->Add(PrintSystemJobInfo::primaryAttributeNames[numOfAttributes], false);
+    }
+
+    for(Int32 numOfAttributes = 0;
+        numOfAttributes < PrintSystemJobInfo::secondaryAttributeNames->Length;
+        numOfAttributes++)
+    {
+        attributeCollections->Add(PrintSystemJobInfo::secondaryAttributeNames[numOfAttributes], true);
+    }
+
+    thunkedAttributeNames = attributeCollections;
 }
 
 array<String^>^
@@ -1303,19 +1333,8 @@ InitializeInternalCollections(
     void
     )
 {
-    collectionsTable          = gcnew Hashtable();
     thunkPropertiesCollection = gcnew PrintPropertyDictionary();
 
-    //
-    // Add the attributes from the base class to the appropriate collection
-    //
-    for(Int32 numOfBaseAttributes=0;
-        numOfBaseAttributes < PrintSystemObject::BaseAttributeNames()->Length;
-        numOfBaseAttributes++)
-    {
-        collectionsTable->Add(PrintSystemObject::BaseAttributeNames()[numOfBaseAttributes],PropertiesCollection);
-    }
-
     //
     // Override the set_Name property in the base class
     //
@@ -1341,10 +1360,6 @@ InitializeInternalCollections(
                                                       propertiesDelegates[numOfPrimaryAttributes]);
 
         PrintSystemObject::PropertiesCollection->Add(printSystemAttributeValue);
-        //
-        // The following links an attribute name to a collection
-        //
-        collectionsTable->Add(PrintSystemJobInfo::primaryAttributeNames[numOfPrimaryAttributes],PropertiesCollection);
     }
 
     //
@@ -1362,10 +1377,6 @@ InitializeInternalCollections(
                                                       propertiesDelegates[numOfPrimaryAttributes + numOfSecondaryAttributes]);
 
         thunkPropertiesCollection->Add(printSystemAttributeValue);
-        //
-        // The following links an attribute name to a collection
-        //
-        collectionsTable->Add(PrintSystemJobInfo::secondaryAttributeNames[numOfSecondaryAttributes],thunkPropertiesCollection);
     }
 
 }
@@ -1431,7 +1442,14 @@ get_InternalPropertiesCollection(
     String^ attributeName
     )
 {
-    return (PrintPropertyDictionary^)collectionsTable[attributeName];
+    Boolean isThunked = false;
+
+    if (!thunkedAttributeNames->TryGetValue(attributeName, isThunked))
+    {
+        return nullptr;
+    }
+
+    return isThunked ? thunkPropertiesCollection : PropertiesCollection;
 }
 
 void
@@ -1546,28 +1564,15 @@ PrintJobInfoCollection::
 PrintJobInfoCollection(
     PrintQueue^     printQueue,
     array<String^>^ propertyFilter
-) : hostingPrintQueue(printQueue)
+) : hostingPrintQueue(printQueue),
+    jobPropertiesFilter(propertyFilter),
+    nextJobIndex(0),
+    isEnumerationComplete(false)
 {
-    jobInfoCollection = gcnew System::Collections::Generic::Queue<PrintSystemJobInfo^>();
-
-    EnumDataThunkObject^ enumDataThunkObject = nullptr;
+    jobInfoCollection      = gcnew System::Collections::Generic::List<PrintSystemJobInfo^>();
+    addedJobInfoCollection = gcnew System::Collections::Generic::List<PrintSystemJobInfo^>();
 
     accessVerifier = gcnew PrintSystemDispatcherObject();
-
-    try
-    {
-        enumDataThunkObject = gcnew EnumDataThunkObject(System::Printing::PrintSystemJobInfo::typeid);
-
-        enumDataThunkObject->GetPrintSystemValuesPerPrintJobs(printQueue,
-                                                              jobInfoCollection,
-                                                              propertyFilter,
-                                                              0,
-                                                              printQueue->NumberOfJobs);
-    }
-    __finally
-    {
-        delete enumDataThunkObject;
-    }
 }
 
 
@@ -1577,7 +1582,9 @@ PrintJobInfoCollection::
 {
     VerifyAccess();
 
-    jobInfoCollection = nullptr;
+    jobInfoCollection      = nullptr;
+    addedJobInfoCollection = nullptr;
+    isEnumerationComplete  = true;
 }
 
 void
@@ -1587,7 +1594,7 @@ Add(
     )
 {
     VerifyAccess();
-    jobInfoCollection->Enqueue(jobInfo);
+    addedJobInfoCollection->Add(jobInfo);
 }
 
 System::
@@ -1601,7 +1608,7 @@ GetEnumerator(
 {
     VerifyAccess();
 
-    return jobInfoCollection->GetEnumerator();
+    return gcnew PrintJobInfoCollectionEnumerator(this);
 }
 
 
@@ -1615,7 +1622,119 @@ GetNonGenericEnumerator(
 {
     VerifyAccess();
 
-    return jobInfoCollection->GetEnumerator();
+    return gcnew PrintJobInfoCollectionEnumerator(this);
+}
+
+/*++
+
+Routine Name:
+
+    TryGetJob
+
+Routine Description:
+
+    Returns the job at the given position in the collection, enumerating
+    further pages of jobs from the spooler until the position is reached.
+    Jobs enumerated from the queue come first, followed by the jobs that
+    were added to the collection.
+
+Arguments:
+
+    index   - position of the job in the collection
+    jobInfo - receives the job
+
+Return Value:
+
+    false if the collection has fewer jobs than index + 1
+
+--*/
+Boolean
+PrintJobInfoCollection::
+TryGetJob(
+    Int32                   index,
+    PrintSystemJobInfo^%    jobInfo
+    )
+{
+    VerifyAccess();
+
+    jobInfo = nullptr;
+
+    if (jobInfoCollection == nullptr)
+    {
+        return false;
+    }
+
+    while (index >= jobInfoCollection->Count &&
+           !isEnumerationComplete)
+    {
+        EnumerateNextPage();
+    }
+
+    if (index < jobInfoCollection->Count)
+    {
+        jobInfo = jobInfoCollection[index];
+    }
+    else if (index - jobInfoCollection->Count < addedJobInfoCollection->Count)
+    {
+        jobInfo = addedJobInfoCollection[index - jobInfoCollection->Count];
+    }
+
+    return jobInfo != nullptr;
+}
+
+/*++
+
+Routine Name:
+
+    EnumerateNextPage
+
+Routine Description:
+
+    Enumerates the next jobsPerPage jobs on the hosting queue and appends
+    them to the collection. A short page means the end of the queue was reached.
+
+Arguments:
+
+    None
+
+Return Value:
+
+    None
+
+--*/
+void
+PrintJobInfoCollection::
+EnumerateNextPage(
+    void
+    )
+{
+    System::Collections::Generic::
+    Queue<PrintSystemJobInfo^>^ pageCollection      = gcnew System::Collections::Generic::Queue<PrintSystemJobInfo^>();
+    EnumDataThunkObject^        enumDataThunkObject = nullptr;
+
+    try
+    {
+        enumDataThunkObject = gcnew EnumDataThunkObject(System::Printing::PrintSystemJobInfo::typeid);
+
+        enumDataThunkObject->GetPrintSystemValuesPerPrintJobs(hostingPrintQueue,
+                                                              pageCollection,
+                                                              jobPropertiesFilter,
+                                                              nextJobIndex,
+                                                              jobsPerPage);
+    }
+    __finally
+    {
+        delete enumDataThunkObject;
+    }
+
+    nextJobIndex += jobsPerPage;
+
+    if (pageCollection->Count < static_cast<Int32>(jobsPerPage))
+    {
+        isEnumerationComplete = true;
+    }
+
+    jobInfoCollection->AddRange(pageCollection);
 }
 
 void
@@ -1632,3 +1751,75 @@ VerifyAccess(
     accessVerifier->VerifyThreadLocality();
 
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+PrintJobInfoCollectionEnumerator::
+PrintJobInfoCollectionEnumerator(
+    PrintJobInfoCollection^ collection
+    ) : jobInfoCollection(collection),
+        index(-1),
+        currentJobInfo(nullptr)
+{
+}
+
+PrintJobInfoCollectionEnumerator::
+~PrintJobInfoCollectionEnumerator(
+    void
+    )
+{
+    currentJobInfo = nullptr;
+}
+
+Boolean
+PrintJobInfoCollectionEnumerator::
+MoveNext(
+    void
+    )
+{
+    PrintSystemJobInfo^ jobInfo = nullptr;
+
+    if (jobInfoCollection->TryGetJob(index + 1, jobInfo))
+    {
+        index++;
+        currentJobInfo = jobInfo;
+
+        return true;
+    }
+
+    currentJobInfo = nullptr;
+
+    return false;
+}
+
+void
+PrintJobInfoCollectionEnumerator::
+Reset(
+    void
+    )
+{
+    index          = -1;
+    currentJobInfo = nullptr;
+}
+
+PrintSystemJobInfo^
+PrintJobInfoCollectionEnumerator::Current::
+get(
+    void
+    )
+{
+    if (currentJobInfo == nullptr)
+    {
+        throw gcnew InvalidOperationException();
+    }
+
+    return currentJobInfo;
+}
+
+Object^
+PrintJobInfoCollectionEnumerator::NonGenericCurrent::
+get(
+    void
+    )
+{
+    return Current;
+}
@@ -54,6 +54,7 @@ using namespace System::Threading;
 using namespace System::Windows::Xps;
 using namespace System::Windows::Xps::Packaging;
 using namespace MS::Internal::Security;
+using namespace MS::Utility;
 
 #include <XPSDocumentWriter.hpp>
 
@@ -1708,6 +1709,14 @@ ForwardProgressChangedEvent(
 
     _writingProgressSequences[(Int32)args->WritingLevel] = (Int32)_writingProgressSequences[(Int32)args->WritingLevel] + 1;
 
+    // Time between consecutive page events is the serialization time of a page
+    if (args->WritingLevel == XpsWritingProgressChangeLevel::FixedPageWritingProgress)
+    {
+        EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS,
+                                   EventTrace::Event::WClientDRXSavePageEnd,
+                                   forwardArgs->Number);
+    }
+
     WritingProgressChanged(this,
                            forwardArgs);
 }
@@ -2382,8 +2391,16 @@ CreateXPSDocument(
     permission->Assert();
     try
     {
+        //
+        // Open the package for streaming production: parts are written out to the
+        // MXDW file as they are serialized instead of being held until the package
+        // is closed, so memory and temp storage don't grow with the document
+        //
         _mxdwPackage = Package::Open(documentName,
-                                     FileMode::Create);
+                                     FileMode::Create,
+                                     FileAccess::Write,
+                                     FileShare::None,
+                                     true);
         if( app != nullptr && app->StartupUri != nullptr )
         {
             XpsDocument::SaveWithUI(IntPtr::Zero, app->StartupUri, gcnew Uri(documentName));
@@ -3091,8 +3108,16 @@ CreateXPSDocument(
     permission->Assert();
     try
     {
+        //
+        // Open the package for streaming production: parts are written out to the
+        // MXDW file as they are serialized instead of being held until the package
+        // is closed, so memory and temp storage don't grow with the document
+        //
         _mxdwPackage = Package::Open(documentName,
-                                     FileMode::Create);
+                                     FileMode::Create,
+                                     FileAccess::Write,
+                                     FileShare::None,
+                                     true);
         if( app != nullptr && app->StartupUri != nullptr )
         {
             XpsDocument::SaveWithUI(IntPtr::Zero, app->StartupUri, gcnew Uri(documentName));
@@ -15,6 +15,7 @@ using namespace System;
 using namespace System::IO;
 using namespace System::Printing;
 using namespace MS::Internal::PrintWin32Thunk;
+using namespace MS::Utility;
 
 XpsPrintJobStream::
 XpsPrintJobStream(
@@ -26,12 +27,27 @@ XpsPrintJobStream(
     inner((IXpsPrintJobStream*)printJobStream),
     hCompletedEvent(hCompletedEvent),
     canRead(canRead),
-    canWrite(canWrite)
+    canWrite(canWrite),
+    fillBuffer(nullptr),
+    fillCount(0),
+    pendingBuffer(nullptr),
+    pendingCount(0),
+    writeInFlight(false),
+    writeException(nullptr),
+    writeLock(gcnew Object())
 {
     if(NULL == inner)
     {
         throw gcnew ArgumentNullException("printJobStream");
     }
+
+    Int32 bufferSize = writeBufferSize;
+
+    if(canWrite && bufferSize > 0)
+    {
+        fillBuffer = gcnew array<Byte>(bufferSize);
+        pendingBuffer = gcnew array<Byte>(bufferSize);
+    }
 }
 
 XpsPrintJobStream::
@@ -40,7 +56,19 @@ XpsPrintJobStream::
 {
     if(inner != NULL)
     {
-        inner->Close();
+        try
+        {
+            //
+            // Get everything buffered to the spooler before closing, so that
+            // a failed write surfaces here rather than being lost
+            //
+            Flush();
+        }
+        finally
+        {
+            inner->Close();
+        }
+
         DWORD timeout = GetCommitTimeoutMilliseconds();
         if(WaitForJobCompletion(timeout))
         {
@@ -133,6 +161,17 @@ Flush (
     void
 ) 
 {
+    if(fillBuffer == nullptr)
+    {
+        return;
+    }
+
+    if(fillCount > 0)
+    {
+        QueueFillBuffer();
+    }
+
+    WaitForPendingWrite();
 }
 
 Int32
@@ -191,6 +230,143 @@ Write (
         throw gcnew ArgumentNullException("count");
     }
     
+    if(fillBuffer == nullptr)
+    {
+        WriteToInner(buffer, offset, count);
+        position += count;
+        return;
+    }
+
+    Int32 copied = 0;
+
+    while(copied < count)
+    {
+        Int32 chunk = Math::Min(count - copied, fillBuffer->Length - fillCount);
+
+        Buffer::BlockCopy(buffer, offset + copied, fillBuffer, fillCount, chunk);
+
+        fillCount += chunk;
+        copied += chunk;
+
+        if(fillCount == fillBuffer->Length)
+        {
+            QueueFillBuffer();
+        }
+    }
+
+    position += count;
+}
+
+void
+XpsPrintJobStream::
+QueueFillBuffer (
+    void
+)
+{
+    //
+    // Only one buffer is in flight at a time; waiting for it here also
+    // reports its failure to the caller writing the data that follows
+    //
+    WaitForPendingWrite();
+
+    array<Byte>^ filled = fillBuffer;
+
+    fillBuffer = pendingBuffer;
+    pendingBuffer = filled;
+    pendingCount = fillCount;
+    fillCount = 0;
+
+    System::Threading::Monitor::Enter(writeLock);
+    try
+    {
+        writeInFlight = true;
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(writeLock);
+    }
+
+    System::Threading::ThreadPool::QueueUserWorkItem(gcnew System::Threading::WaitCallback(this, &XpsPrintJobStream::WritePendingBuffer));
+}
+
+void
+XpsPrintJobStream::
+WaitForPendingWrite (
+    void
+)
+{
+    Exception^ exception = nullptr;
+
+    System::Threading::Monitor::Enter(writeLock);
+    try
+    {
+        while(writeInFlight)
+        {
+            System::Threading::Monitor::Wait(writeLock);
+        }
+
+        exception = writeException;
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(writeLock);
+    }
+
+    if(exception != nullptr)
+    {
+        throw exception;
+    }
+}
+
+void
+XpsPrintJobStream::
+WritePendingBuffer (
+    Object^ state
+)
+{
+    Exception^ exception = nullptr;
+
+    try
+    {
+        WriteToInner(pendingBuffer, 0, pendingCount);
+    }
+    catch(Exception^ e)
+    {
+        exception = e;
+    }
+
+    System::Threading::Monitor::Enter(writeLock);
+    try
+    {
+        if(exception != nullptr && writeException == nullptr)
+        {
+            writeException = exception;
+        }
+
+        writeInFlight = false;
+        System::Threading::Monitor::PulseAll(writeLock);
+    }
+    finally
+    {
+        System::Threading::Monitor::Exit(writeLock);
+    }
+}
+
+void
+XpsPrintJobStream::
+WriteToInner (
+    array<Byte> ^ buffer,
+    Int32 offset,
+    Int32 count
+)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXSaveXpsBegin, count);
+
     pin_ptr<byte> pinnedBuffer = &buffer[offset];
     
     ULONG totalBytesWritten = 0;    
@@ -201,7 +377,15 @@ Write (
         ULONG bytesToWrite = uCount - totalBytesWritten;
         ULONG bytesWritten = 0;
 
-        inner->Write(pinnedBuffer, bytesToWrite, &bytesWritten);        
+        InternalPrintSystemException::ThrowIfNotCOMSuccess(inner->Write(pinnedBuffer, bytesToWrite, &bytesWritten));
+
+        //
+        // A write that succeeds without making progress would loop forever
+        //
+        if(bytesWritten == 0)
+        {
+            InternalPrintSystemException::ThrowIfNotCOMSuccess(STG_E_MEDIUMFULL);
+        }
         
         assert(bytesWritten <= bytesToWrite);
 
@@ -210,7 +394,30 @@ Write (
         totalBytesWritten = nextTotalBytesWritten;
     }
 
-    position += totalBytesWritten;
+    EventTrace::EasyTraceEvent(EventTrace::Keyword::KeywordXPS, EventTrace::Event::WClientDRXSaveXpsEnd);
+}
+
+Int32
+XpsPrintJobStream::WriteBufferSize::
+get(
+    void
+)
+{
+    return writeBufferSize;
+}
+
+void
+XpsPrintJobStream::WriteBufferSize::
+set(
+    Int32 value
+)
+{
+    if(value < 0)
+    {
+        throw gcnew ArgumentOutOfRangeException("value");
+    }
+
+    writeBufferSize = value;
 }
 
 Int64